@@ -31,6 +31,10 @@
 #include "../include/perfdata.h"
 #include "../include/workers.h"
 
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
 /*#define DEBUG_CHECKS*/
 /*#define DEBUG_HOST_CHECKS 1*/
 
@@ -62,6 +66,68 @@ int reap_check_results(void)
 
 
 
+/******************************************************************/
+/******************* COMPILED CHECK COMMANDS **********************/
+/******************************************************************/
+
+/*
+ * Check commands are compiled into macro templates the first time
+ * an object is checked and reused for every check after that. The
+ * templates are indexed by object id and recompiled whenever the
+ * check command changes.
+ */
+static command_template **host_check_templates;
+static command_template **service_check_templates;
+
+static command_template *get_check_template(command_template ***ary, unsigned int num, unsigned int id, command *cmd_ptr, char *cmd)
+{
+	command_template *tpl;
+
+	if (*ary == NULL && !(*ary = calloc(num, sizeof(command_template *))))
+		return NULL;
+
+	tpl = (*ary)[id];
+	if (tpl && command_template_matches(tpl, cmd_ptr, cmd))
+		return tpl;
+
+	free_command_template(tpl);
+	(*ary)[id] = tpl = compile_command_template(cmd_ptr, cmd);
+	return tpl;
+}
+
+void invalidate_host_check_template(host *hst)
+{
+	if (host_check_templates && hst) {
+		free_command_template(host_check_templates[hst->id]);
+		host_check_templates[hst->id] = NULL;
+	}
+}
+
+void invalidate_service_check_template(service *svc)
+{
+	if (service_check_templates && svc) {
+		free_command_template(service_check_templates[svc->id]);
+		service_check_templates[svc->id] = NULL;
+	}
+}
+
+void free_check_templates(void)
+{
+	unsigned int i;
+
+	if (host_check_templates) {
+		for (i = 0; i < num_objects.hosts; i++)
+			free_command_template(host_check_templates[i]);
+		my_free(host_check_templates);
+	}
+	if (service_check_templates) {
+		for (i = 0; i < num_objects.services; i++)
+			free_command_template(service_check_templates[i]);
+		my_free(service_check_templates);
+	}
+}
+
+
 /******************************************************************/
 /****************** SERVICE MONITORING FUNCTIONS ******************/
 /******************************************************************/
@@ -165,6 +231,7 @@ int run_async_service_check(service *svc, int check_options, double latency, int
 {
 	nagios_macros mac;
 	char *raw_command = NULL;
+	command_template *tpl = NULL;
 	char *processed_command = NULL;
 	struct timeval start_time, end_time;
 	host *temp_host = NULL;
@@ -244,21 +311,28 @@ int run_async_service_check(service *svc, int check_options, double latency, int
 	grab_host_macros_r(&mac, temp_host);
 	grab_service_macros_r(&mac, svc);
 
-	/* get the raw command line */
-	get_raw_command_line_r(&mac, svc->check_command_ptr, svc->check_command, &raw_command, macro_options);
-	if (raw_command == NULL) {
-		clear_volatile_macros_r(&mac);
-		log_debug_info(DEBUGL_CHECKS, 0, "Raw check command for service '%s' on host '%s' was NULL - aborting.\n", svc->description, svc->host_name);
-		if (preferred_time) {
-			*preferred_time += (svc->check_interval * interval_length);
-		}
-		svc->latency = old_latency;
-		return ERROR;
+	/* expand the compiled check command */
+	tpl = get_check_template(&service_check_templates, num_objects.services, svc->id, svc->check_command_ptr, svc->check_command);
+	if (tpl != NULL) {
+		expand_command_template_r(&mac, tpl, &processed_command, macro_options);
 	}
+	else {
+		/* get the raw command line */
+		get_raw_command_line_r(&mac, svc->check_command_ptr, svc->check_command, &raw_command, macro_options);
+		if (raw_command == NULL) {
+			clear_volatile_macros_r(&mac);
+			log_debug_info(DEBUGL_CHECKS, 0, "Raw check command for service '%s' on host '%s' was NULL - aborting.\n", svc->description, svc->host_name);
+			if (preferred_time) {
+				*preferred_time += (svc->check_interval * interval_length);
+			}
+			svc->latency = old_latency;
+			return ERROR;
+		}
 
-	/* process any macros contained in the argument */
-	process_macros_r(&mac, raw_command, &processed_command, macro_options);
-	my_free(raw_command);
+		/* process any macros contained in the argument */
+		process_macros_r(&mac, raw_command, &processed_command, macro_options);
+		my_free(raw_command);
+	}
 	if (processed_command == NULL) {
 		clear_volatile_macros_r(&mac);
 		log_debug_info(DEBUGL_CHECKS, 0, "Processed check command for service '%s' on host '%s' was NULL - aborting.\n", svc->description, svc->host_name);
@@ -272,14 +346,13 @@ int run_async_service_check(service *svc, int check_options, double latency, int
 	/* get the command start time */
 	gettimeofday(&start_time, NULL);
 
-	cr = calloc(1, sizeof(*cr));
+	cr = alloc_check_result();
 	if (!cr) {
 		clear_volatile_macros_r(&mac);
 		svc->latency = old_latency;
 		my_free(processed_command);
 		return ERROR;
 	}
-	init_check_result(cr);
 
 	/* save check info */
 	cr->object_check_type = SERVICE_CHECK;
@@ -305,8 +378,7 @@ int run_async_service_check(service *svc, int check_options, double latency, int
 	if (neb_result == NEBERROR_CALLBACKOVERRIDE) {
 		clear_volatile_macros_r(&mac);
 		svc->latency = old_latency;
-		free_check_result(cr);
-		my_free(cr);
+		release_check_result(cr);
 		my_free(processed_command);
 		return OK;
 	}
@@ -781,25 +853,93 @@ static inline void host_fresh_check(host *hst, check_result *cr, time_t current_
 /******************************************************************************
  ******* Logic chunks for setting some of the initial flags, etc.
  *****************************************************************************/
+/*
+ * Stores a copy of src in *dst, which is plugin output (or the like)
+ * that belongs to a host or service. The buffers are sized in powers
+ * of two and reused for as long as the output fits, so an object whose
+ * output stays about the same length doesn't go through malloc() and
+ * free() on every check.
+ */
+static void set_object_output(char **dst, const char *src)
+{
+	size_t len, size;
+
+	if (src == NULL) {
+		my_free(*dst);
+		return;
+	}
+
+	len = strlen(src) + 1;
+#ifdef __GLIBC__
+	if (*dst == NULL || malloc_usable_size(*dst) < len)
+#else
+	if (*dst == NULL || strlen(*dst) + 1 < len)
+#endif
+	{
+		for (size = 64; size < len; size <<= 1)
+			;
+		my_free(*dst);
+		if ((*dst = malloc(size)) == NULL) {
+			return;
+		}
+	}
+
+	memcpy(*dst, src, len);
+}
+
+/* split check output into short and long output and perf data, unless
+ * that's already been done for us by one of the check result threads */
+static inline void get_check_output(check_result *cr, char **short_output, char **long_output, char **perf_data)
+{
+	static arena *output_arena = NULL;
+	char *short_text = NULL, *long_text = NULL, *perf_text = NULL;
+
+	if (cr->output_parsed == TRUE) {
+		set_object_output(short_output, cr->short_output);
+		set_object_output(long_output, cr->long_output);
+		set_object_output(perf_data, cr->perf_data);
+		return;
+	}
+
+	/* the parsed output is only needed until it's been copied, so it
+	 * goes in an arena that's emptied again right away */
+	if (output_arena == NULL) {
+		output_arena = arena_create(4096);
+	}
+	parse_check_output_arena(output_arena, cr->output, &short_text, &long_text, &perf_text, TRUE, FALSE);
+
+	set_object_output(short_output, short_text);
+	set_object_output(long_output, long_text);
+	set_object_output(perf_data, perf_text);
+
+	if (output_arena != NULL) {
+		arena_reset(output_arena);
+	}
+	else {
+		my_free(short_text);
+		my_free(long_text);
+		my_free(perf_text);
+	}
+}
+/*****************************************************************************/
 static inline void service_initial_handling(service *svc, check_result *cr, char **old_plugin_output)
 {
 	char * temp_ptr = NULL;
 
-	/* save old plugin output */
-	if (svc->plugin_output) {
-		* old_plugin_output = (char *)strdup(svc->plugin_output);
+	/* stalking compares the old plugin output with the new one, so
+	 * that needs to keep it. The caller frees it once it's done. For
+	 * everyone else the old buffer is reused for the new output */
+	if (svc->stalking_options & ~OPT_NOTIFICATIONS) {
+		* old_plugin_output = svc->plugin_output;
+		svc->plugin_output = NULL;
 	}
 
-	my_free(svc->plugin_output);
-	my_free(svc->long_plugin_output);
-	my_free(svc->perf_data);
-
 	/* parse check output to get: (1) short output, (2) long output, (3) perf data */
-	parse_check_output(cr->output, &svc->plugin_output, &svc->long_plugin_output, &svc->perf_data, TRUE, FALSE);
+	get_check_output(cr, &svc->plugin_output, &svc->long_plugin_output, &svc->perf_data);
 
 	/* make sure the plugin output isn't null */
 	if (svc->plugin_output == NULL) {
-		svc->plugin_output = (char *)strdup("(No output returned from plugin)");
+		set_object_output(&svc->plugin_output, "(No output returned from plugin)");
 	}
 	/* otherwise replace the semicolons with colons */
 	else {
@@ -828,21 +968,20 @@ static inline void host_initial_handling(host *hst, check_result *cr, char **old
 {
 	char * temp_ptr = NULL;
 
-	/* save old plugin output */
-	if (hst->plugin_output) {
-		* old_plugin_output = (char *)strdup(hst->plugin_output);
+	/* stalking compares the old plugin output with the new one, so
+	 * that needs to keep it. The caller frees it once it's done. For
+	 * everyone else the old buffer is reused for the new output */
+	if (hst->stalking_options & ~OPT_NOTIFICATIONS) {
+		* old_plugin_output = hst->plugin_output;
+		hst->plugin_output = NULL;
 	}
 
-	my_free(hst->plugin_output);
-	my_free(hst->long_plugin_output);
-	my_free(hst->perf_data);
-
 	/* parse check output to get: (1) short output, (2) long output, (3) perf data */
-	parse_check_output(cr->output, &hst->plugin_output, &hst->long_plugin_output, &hst->perf_data, TRUE, FALSE);
+	get_check_output(cr, &hst->plugin_output, &hst->long_plugin_output, &hst->perf_data);
 
 	/* make sure the plugin output isn't null */
 	if (hst->plugin_output == NULL) {
-		hst->plugin_output = (char *)strdup("(No output returned from host check)");
+		set_object_output(&hst->plugin_output, "(No output returned from host check)");
 	}
 	/* otherwise replace the semicolons with colons */
 	else {
@@ -1033,11 +1172,15 @@ static inline void initialize_last_service_state_change_times(service * svc, hos
 	if (svc->last_hard_state_change == (time_t)0) {
 		svc->last_hard_state_change = svc->last_check;
 	}
-	if (hst->last_state_change == (time_t)0) {
-		hst->last_state_change = svc->last_check;
-	}
-	if (hst->last_hard_state_change == (time_t)0) {
-		hst->last_hard_state_change = svc->last_check;
+	if (hst->last_state_change == (time_t)0 || hst->last_hard_state_change == (time_t)0) {
+		if (hst->last_state_change == (time_t)0) {
+			hst->last_state_change = svc->last_check;
+		}
+		if (hst->last_hard_state_change == (time_t)0) {
+			hst->last_hard_state_change = svc->last_check;
+		}
+		/* the host's status changed along with the service's */
+		update_host_status(hst, FALSE);
 	}
 }
 /*****************************************************************************/
@@ -1203,6 +1346,8 @@ int handle_async_service_check_result(service *svc, check_result *cr)
 	int log_event                  = FALSE;
 	int check_host                 = FALSE;
 	int update_host_stats          = FALSE;
+	int old_is_flapping            = FALSE;
+	double old_percent_state_change = 0.0;
 
 	char * old_plugin_output       = NULL;
 
@@ -1333,6 +1478,7 @@ int handle_async_service_check_result(service *svc, check_result *cr)
 
 					hst->has_been_checked = TRUE;
 					hst->last_check = svc->last_check;
+					update_host_freshness(hst);
 				}
 
 				/* possibly re-send host notifications... */
@@ -1467,6 +1613,7 @@ int handle_async_service_check_result(service *svc, check_result *cr)
 	if (svc->current_state != svc->last_state || (svc->current_state == STATE_OK && svc->state_type == SOFT_STATE)) {
 
 		log_debug_info(DEBUGL_CHECKS, 2, "Service experienced a state change\n");
+		nagios_trace_event(TRACE_STATE_CHANGE, TRACE_SERVICE, svc->id, TRACE_STATES(svc->last_state, svc->current_state, svc->state_type));
 
 		state_change = TRUE;
 	}
@@ -1530,7 +1677,13 @@ int handle_async_service_check_result(service *svc, check_result *cr)
 	record_last_service_state_ended(svc);
 
 	check_for_service_flapping(svc, TRUE, TRUE);
+
+	/* the host's flap state can change here without a host check */
+	old_percent_state_change = hst->percent_state_change;
+	old_is_flapping = hst->is_flapping;
 	check_for_host_flapping(hst, TRUE, FALSE, TRUE);
+	if(hst->percent_state_change != old_percent_state_change || hst->is_flapping != old_is_flapping)
+		update_host_status(hst, FALSE);
 
 	/* service with active checks disabled do not get rescheduled */
 	if (svc->checks_enabled == FALSE) {
@@ -2006,8 +2159,8 @@ int check_service_dependencies(service *svc, int dependency_type)
 void check_for_orphaned_services(void)
 {
 	service *temp_service = NULL;
+	check_result *cr = NULL;
 	time_t current_time = 0L;
-	time_t expected_time = 0L;
 
 
 	log_debug_info(DEBUGL_FUNCTIONS, 0, "check_for_orphaned_services()\n");
@@ -2015,45 +2168,270 @@ void check_for_orphaned_services(void)
 	/* get the current time */
 	time(&current_time);
 
-	/* check all services... */
-	for(temp_service = service_list; temp_service != NULL; temp_service = temp_service->next) {
+	/* only the checks whose results are overdue come back here */
+	while ((cr = wproc_next_orphaned_check(SERVICE_CHECK, current_time)) != NULL) {
+
+		temp_service = find_service(cr->host_name, cr->service_description);
 
-		/* skip services that are not currently executing */
-		if (temp_service->is_executing == FALSE) {
+		/* skip services that are gone or no longer executing */
+		if (temp_service == NULL || temp_service->is_executing == FALSE) {
 			continue;
 		}
 
-		/* determine the time at which the check results should have come in (allow 10 minutes slack time) */
-		expected_time = (time_t)(temp_service->next_check + temp_service->latency + service_check_timeout + check_reaper_interval + 600);
+		/* log a warning */
+		logit(NSLOG_RUNTIME_WARNING, TRUE, "Warning: The check of service '%s' on host '%s' looks like it was orphaned (results never came back; last_check=%lu; next_check=%lu).  I'm scheduling an immediate check of the service...\n", temp_service->description, temp_service->host_name, temp_service->last_check, temp_service->next_check);
 
-		/* this service was supposed to have executed a while ago, but for some reason the results haven't come back in... */
-		if (expected_time < current_time) {
+		log_debug_info(DEBUGL_CHECKS, 1, "Service '%s' on host '%s' was orphaned, so we're scheduling an immediate check...\n", temp_service->description, temp_service->host_name);
+		log_debug_info(DEBUGL_CHECKS, 1, "  next_check=%lu (%s); last_check=%lu (%s);\n",
+					   temp_service->next_check, ctime(&temp_service->next_check),
+					   temp_service->last_check, ctime(&temp_service->last_check));
 
-			/* log a warning */
-			logit(NSLOG_RUNTIME_WARNING, TRUE, "Warning: The check of service '%s' on host '%s' looks like it was orphaned (results never came back; last_check=%lu; next_check=%lu).  I'm scheduling an immediate check of the service...\n", temp_service->description, temp_service->host_name, temp_service->last_check, temp_service->next_check);
+		reschedule_lost_service_check(temp_service);
+	}
 
-			log_debug_info(DEBUGL_CHECKS, 1, "Service '%s' on host '%s' was orphaned, so we're scheduling an immediate check...\n", temp_service->description, temp_service->host_name);
-			log_debug_info(DEBUGL_CHECKS, 1, "  next_check=%lu (%s); last_check=%lu (%s);\n",
-						   temp_service->next_check, ctime(&temp_service->next_check),
-						   temp_service->last_check, ctime(&temp_service->last_check));
+	return;
+}
 
-			/* decrement the number of running service checks */
-			if (currently_running_service_checks > 0) {
-				currently_running_service_checks--;
-			}
 
-			/* disable the executing flag */
-			temp_service->is_executing = FALSE;
 
-			/* schedule an immediate check of the service */
-			schedule_service_check(temp_service, current_time, CHECK_OPTION_ORPHAN_CHECK);
+/* clears the executing flag of a service whose check won't come back, and checks it again right away */
+void reschedule_lost_service_check(service *svc)
+{
+	if (svc->is_executing == FALSE) {
+		return;
+	}
+
+	/* decrement the number of running service checks */
+	if (currently_running_service_checks > 0) {
+		currently_running_service_checks--;
+	}
+
+	/* disable the executing flag */
+	svc->is_executing = FALSE;
+
+	/* schedule an immediate check of the service */
+	schedule_service_check(svc, time(NULL), CHECK_OPTION_ORPHAN_CHECK);
+}
+
+
+
+static time_t host_freshness_expiration(host *, int *);
+static time_t service_freshness_expiration(service *, int *);
+
+/*
+ * Freshness deadline index
+ *
+ * Rather than asking every host and service whether its results have
+ * gone stale each time the freshness checks run, we keep a heap of the
+ * ones subject to freshness checking, keyed on the time their results
+ * go stale. The deadline is recalculated whenever the core updates an
+ * object's status, which covers check results, the active and passive
+ * check toggles and interval changes, so the freshness checks only look
+ * at objects whose deadline has actually passed. Anything that changes
+ * what goes into a deadline without updating the object's status must
+ * call update_host_freshness() or update_service_freshness() itself.
+ * The index is built on first use and thrown away along with the
+ * objects on reload.
+ */
+
+struct freshness_entry {
+	prqueue_pri_t deadline;
+	unsigned int pos; /* position in the heap, 0 if not queued */
+	void *object;
+};
+
+struct freshness_index {
+	prqueue_t *pq;
+	struct freshness_entry *entries;
+	unsigned int num_entries;
+};
+
+static struct freshness_index host_freshness, service_freshness;
+
+static int fi_cmp_pri(prqueue_pri_t next, prqueue_pri_t cur)
+{
+	return next > cur;
+}
+
+static prqueue_pri_t fi_get_pri(void *a)
+{
+	return ((struct freshness_entry *)a)->deadline;
+}
+
+static void fi_set_pri(void *a, prqueue_pri_t pri)
+{
+	((struct freshness_entry *)a)->deadline = pri;
+}
+
+static unsigned int fi_get_pos(void *a)
+{
+	return ((struct freshness_entry *)a)->pos;
+}
+
+static void fi_set_pos(void *a, unsigned int pos)
+{
+	((struct freshness_entry *)a)->pos = pos;
+}
+
+static int freshness_index_init(struct freshness_index *fi, unsigned int num_entries)
+{
+	fi->entries = calloc(num_entries ? num_entries : 1, sizeof(struct freshness_entry));
+	fi->pq = prqueue_init(num_entries ? num_entries : 1, fi_cmp_pri, fi_get_pri, fi_set_pri, fi_get_pos, fi_set_pos);
+	if (fi->entries == NULL || fi->pq == NULL) {
+		my_free(fi->entries);
+		if (fi->pq != NULL) {
+			prqueue_free(fi->pq);
+		}
+		fi->pq = NULL;
+		return ERROR;
+	}
+	fi->num_entries = num_entries;
+
+	return OK;
+}
+
+/* (re)queues an object with the given deadline, or dequeues it */
+static void freshness_index_set(struct freshness_index *fi, unsigned int id, void *object, int queue, time_t deadline)
+{
+	struct freshness_entry *entry;
+
+	if (fi->pq == NULL || id >= fi->num_entries) {
+		return;
+	}
+	entry = &fi->entries[id];
+
+	if (queue == FALSE) {
+		if (entry->pos) {
+			prqueue_remove(fi->pq, entry);
+			entry->pos = 0;
 		}
+		return;
+	}
+
+	if (deadline < 0) {
+		deadline = 0;
+	}
+	if (entry->pos) {
+		prqueue_change_priority(fi->pq, (prqueue_pri_t)deadline, entry);
+		return;
+	}
 
+	entry->object = object;
+	entry->deadline = (prqueue_pri_t)deadline;
+	if (prqueue_insert(fi->pq, entry) != 0) {
+		entry->pos = 0;
 	}
+}
 
-	return;
+/* takes the next object whose deadline has passed off the index */
+static void *freshness_index_pop(struct freshness_index *fi, time_t current_time)
+{
+	struct freshness_entry *entry = prqueue_peek(fi->pq);
+
+	if (entry == NULL || entry->deadline >= (prqueue_pri_t)current_time) {
+		return NULL;
+	}
+
+	prqueue_pop(fi->pq);
+	entry->pos = 0;
+	return entry->object;
+}
+
+/* updates the freshness deadline of a host */
+void update_host_freshness(host *hst)
+{
+	int threshold = 0;
+	int queue = hst->check_freshness == TRUE
+		&& (hst->checks_enabled == TRUE || hst->accept_passive_checks == TRUE)
+		&& hst->is_being_freshened == FALSE;
+
+	freshness_index_set(&host_freshness, hst->id, hst, queue, queue ? host_freshness_expiration(hst, &threshold) : 0);
+}
+
+/* updates the freshness deadline of a service */
+void update_service_freshness(service *svc)
+{
+	int threshold = 0;
+	int queue = svc->check_freshness == TRUE
+		&& (svc->checks_enabled == TRUE || svc->accept_passive_checks == TRUE)
+		&& svc->is_being_freshened == FALSE
+		/* don't check freshness of services without regular check intervals if we're using auto-freshness threshold */
+		&& (svc->check_interval != 0 || svc->freshness_threshold != 0);
+
+	freshness_index_set(&service_freshness, svc->id, svc, queue, queue ? service_freshness_expiration(svc, &threshold) : 0);
 }
 
+/* returns when the index has an object's results going stale, or 0 if it isn't queued */
+static time_t freshness_index_get(struct freshness_index *fi, unsigned int id)
+{
+	if (fi->pq == NULL || id >= fi->num_entries || !fi->entries[id].pos) {
+		return (time_t)0;
+	}
+
+	return (time_t)fi->entries[id].deadline;
+}
+
+time_t get_host_freshness_deadline(host *hst)
+{
+	return freshness_index_get(&host_freshness, hst->id);
+}
+
+time_t get_service_freshness_deadline(service *svc)
+{
+	return freshness_index_get(&service_freshness, svc->id);
+}
+
+/* builds the host index on first use */
+static int build_host_freshness_index(void)
+{
+	unsigned int i;
+
+	if (host_freshness.pq != NULL) {
+		return OK;
+	}
+	if (freshness_index_init(&host_freshness, num_objects.hosts) == ERROR) {
+		return ERROR;
+	}
+
+	for (i = 0; i < num_objects.hosts; i++) {
+		update_host_freshness(host_ary[i]);
+	}
+
+	return OK;
+}
+
+/* builds the service index on first use */
+static int build_service_freshness_index(void)
+{
+	unsigned int i;
+
+	if (service_freshness.pq != NULL) {
+		return OK;
+	}
+	if (freshness_index_init(&service_freshness, num_objects.services) == ERROR) {
+		return ERROR;
+	}
+
+	for (i = 0; i < num_objects.services; i++) {
+		update_service_freshness(service_ary[i]);
+	}
+
+	return OK;
+}
+
+void free_freshness_index(void)
+{
+	if (host_freshness.pq != NULL) {
+		prqueue_free(host_freshness.pq);
+	}
+	if (service_freshness.pq != NULL) {
+		prqueue_free(service_freshness.pq);
+	}
+	my_free(host_freshness.entries);
+	my_free(service_freshness.entries);
+	memset(&host_freshness, 0, sizeof(host_freshness));
+	memset(&service_freshness, 0, sizeof(service_freshness));
+}
 
 
 /* check freshness of service results */
@@ -2075,37 +2453,28 @@ void check_service_result_freshness(void)
 	/* get the current time */
 	time(&current_time);
 
-	/* check all services... */
-	for(temp_service = service_list; temp_service != NULL; temp_service = temp_service->next) {
+	if (build_service_freshness_index() == ERROR) {
+		logit(NSLOG_RUNTIME_ERROR, TRUE, "Error: Failed to set up the service freshness index, so service freshness can't be checked.\n");
+		return;
+	}
 
-		/* skip services we shouldn't be checking for freshness */
-		if (temp_service->check_freshness == FALSE) {
-			continue;
-		}
+	/* check the services whose results may have gone stale... */
+	while ((temp_service = freshness_index_pop(&service_freshness, current_time)) != NULL) {
 
-		/* skip services that are currently executing (problems here will be caught by orphaned service check) */
+		/* skip services that are currently executing (problems here will be caught by orphaned service check).
+		 * They're put back in the index when their results come in */
 		if (temp_service->is_executing == TRUE) {
 			continue;
 		}
 
-		/* skip services that have both active and passive checks disabled */
-		if (temp_service->checks_enabled == FALSE && temp_service->accept_passive_checks == FALSE) {
-			continue;
-		}
-
 		/* skip services that are already being freshened */
 		if (temp_service->is_being_freshened == TRUE) {
 			continue;
 		}
 
-		/* see if the time is right... */
+		/* see if the time is right, and look again next time around if it isn't */
 		if (check_time_against_period(current_time, temp_service->check_period_ptr) == ERROR) {
-			continue;
-		}
-
-		/* EXCEPTION */
-		/* don't check freshness of services without regular check intervals if we're using auto-freshness threshold */
-		if ((temp_service->check_interval == 0) && (temp_service->freshness_threshold == 0)) {
+			freshness_index_set(&service_freshness, temp_service->id, temp_service, TRUE, current_time + service_freshness_check_interval);
 			continue;
 		}
 
@@ -2119,6 +2488,10 @@ void check_service_result_freshness(void)
 			schedule_service_check(temp_service, current_time, CHECK_OPTION_FORCE_EXECUTION | CHECK_OPTION_FRESHNESS_CHECK);
 		}
 
+		/* the deadline moved on without our noticing */
+		else {
+			update_service_freshness(temp_service);
+		}
 	}
 
 	return;
@@ -2126,21 +2499,11 @@ void check_service_result_freshness(void)
 
 
 
-/* tests whether or not a service's check results are fresh */
-int is_service_result_fresh(service *temp_service, time_t current_time, int log_this)
+/* works out when the results of a service's last check go stale */
+static time_t service_freshness_expiration(service *temp_service, int *threshold)
 {
-	int freshness_threshold = 0;
 	time_t expiration_time = 0L;
-	int days = 0;
-	int hours = 0;
-	int minutes = 0;
-	int seconds = 0;
-	int tdays = 0;
-	int thours = 0;
-	int tminutes = 0;
-	int tseconds = 0;
-
-	log_debug_info(DEBUGL_CHECKS, 2, "Checking freshness of service '%s' on host '%s'...\n", temp_service->description, temp_service->host_name);
+	int freshness_threshold = 0;
 
 	/* use user-supplied freshness threshold or auto-calculate a freshness threshold to use? */
 	if (temp_service->freshness_threshold == 0) {
@@ -2155,8 +2518,6 @@ int is_service_result_fresh(service *temp_service, time_t current_time, int log_
 		freshness_threshold = temp_service->freshness_threshold;
 	}
 
-	log_debug_info(DEBUGL_CHECKS, 2, "Freshness thresholds: service=%d, use=%d\n", temp_service->freshness_threshold, freshness_threshold);
-
 	/* calculate expiration time */
 	/*
 	 * CHANGED 11/10/05 EG -
@@ -2215,6 +2576,32 @@ int is_service_result_fresh(service *temp_service, time_t current_time, int log_
 
 		expiration_time = event_start + freshness_threshold;
 	}
+
+	*threshold = freshness_threshold;
+	return expiration_time;
+}
+
+
+/* tests whether or not a service's check results are fresh */
+int is_service_result_fresh(service *temp_service, time_t current_time, int log_this)
+{
+	int freshness_threshold = 0;
+	time_t expiration_time = 0L;
+	int days = 0;
+	int hours = 0;
+	int minutes = 0;
+	int seconds = 0;
+	int tdays = 0;
+	int thours = 0;
+	int tminutes = 0;
+	int tseconds = 0;
+
+	log_debug_info(DEBUGL_CHECKS, 2, "Checking freshness of service '%s' on host '%s'...\n", temp_service->description, temp_service->host_name);
+
+	expiration_time = service_freshness_expiration(temp_service, &freshness_threshold);
+
+	log_debug_info(DEBUGL_CHECKS, 2, "Freshness thresholds: service=%d, use=%d\n", temp_service->freshness_threshold, freshness_threshold);
+
 	log_debug_info(DEBUGL_CHECKS, 2, "HBC: %d, PS: %lu, ES: %lu, LC: %lu, CT: %lu, ET: %lu\n", temp_service->has_been_checked, (unsigned long)program_start, (unsigned long)event_start, (unsigned long)temp_service->last_check, (unsigned long)current_time, (unsigned long)expiration_time);
 
 	/* the results for the last check of this service are stale */
@@ -2391,6 +2778,7 @@ int handle_async_host_check_result(host *hst, check_result *cr)
 	if (hst->current_state != hst->last_state || (hst->current_state == HOST_UP && hst->state_type == SOFT_STATE)) {
 
 		log_debug_info(DEBUGL_CHECKS, 2, "Host experienced a state change\n");
+		nagios_trace_event(TRACE_STATE_CHANGE, TRACE_HOST, hst->id, TRACE_STATES(hst->last_state, hst->current_state, hst->state_type));
 
 		state_change = TRUE;
 	}
@@ -2752,8 +3140,8 @@ int check_host_dependencies(host *hst, int dependency_type)
 void check_for_orphaned_hosts(void)
 {
 	host *temp_host = NULL;
+	check_result *cr = NULL;
 	time_t current_time = 0L;
-	time_t expected_time = 0L;
 
 
 	log_debug_info(DEBUGL_FUNCTIONS, 0, "check_for_orphaned_hosts()\n");
@@ -2761,46 +3149,53 @@ void check_for_orphaned_hosts(void)
 	/* get the current time */
 	time(&current_time);
 
-	/* check all hosts... */
-	for(temp_host = host_list; temp_host != NULL; temp_host = temp_host->next) {
+	/* only the checks whose results are overdue come back here */
+	while ((cr = wproc_next_orphaned_check(HOST_CHECK, current_time)) != NULL) {
 
-		/* skip hosts that don't have a set check interval (on-demand checks are missed by the orphan logic) */
-		if (temp_host->next_check == (time_t)0L) {
+		temp_host = find_host(cr->host_name);
+
+		/* skip hosts that are gone or no longer executing */
+		if (temp_host == NULL || temp_host->is_executing == FALSE) {
 			continue;
 		}
 
-		/* skip hosts that are not currently executing */
-		if (temp_host->is_executing == FALSE) {
+		/* skip hosts that don't have a set check interval (on-demand checks are missed by the orphan logic) */
+		if (temp_host->next_check == (time_t)0L) {
 			continue;
 		}
 
-		/* determine the time at which the check results should have come in (allow 10 minutes slack time) */
-		expected_time = (time_t)(temp_host->next_check + temp_host->latency + host_check_timeout + check_reaper_interval + 600);
+		/* log a warning */
+		logit(NSLOG_RUNTIME_WARNING, TRUE, 
+			"Warning: The check of host '%s' looks like it was orphaned (results never came back).  I'm scheduling an immediate check of the host...\n", 
+			temp_host->name);
 
-		/* this host was supposed to have executed a while ago, but for some reason the results haven't come back in... */
-		if (expected_time < current_time) {
+		log_debug_info(DEBUGL_CHECKS, 1, 
+			"Host '%s' was orphaned, so we're scheduling an immediate check...\n", 
+			temp_host->name);
 
-			/* log a warning */
-			logit(NSLOG_RUNTIME_WARNING, TRUE, 
-				"Warning: The check of host '%s' looks like it was orphaned (results never came back).  I'm scheduling an immediate check of the host...\n", 
-				temp_host->name);
+		reschedule_lost_host_check(temp_host);
+	}
+}
 
-			log_debug_info(DEBUGL_CHECKS, 1, 
-				"Host '%s' was orphaned, so we're scheduling an immediate check...\n", 
-				temp_host->name);
 
-			/* decrement the number of running host checks */
-			if (currently_running_host_checks > 0) {
-				currently_running_host_checks--;
-			}
 
-			/* disable the executing flag */
-			temp_host->is_executing = FALSE;
+/* clears the executing flag of a host whose check won't come back, and checks it again right away */
+void reschedule_lost_host_check(host *hst)
+{
+	if (hst->is_executing == FALSE) {
+		return;
+	}
 
-			/* schedule an immediate check of the host */
-			schedule_host_check(temp_host, current_time, CHECK_OPTION_ORPHAN_CHECK);
-		}
+	/* decrement the number of running host checks */
+	if (currently_running_host_checks > 0) {
+		currently_running_host_checks--;
 	}
+
+	/* disable the executing flag */
+	hst->is_executing = FALSE;
+
+	/* schedule an immediate check of the host */
+	schedule_host_check(hst, time(NULL), CHECK_OPTION_ORPHAN_CHECK);
 }
 
 
@@ -2823,20 +3218,16 @@ void check_host_result_freshness(void)
 	/* get the current time */
 	time(&current_time);
 
-	/* check all hosts... */
-	for(temp_host = host_list; temp_host != NULL; temp_host = temp_host->next) {
-
-		/* skip hosts we shouldn't be checking for freshness */
-		if (temp_host->check_freshness == FALSE) {
-			continue;
-		}
+	if (build_host_freshness_index() == ERROR) {
+		logit(NSLOG_RUNTIME_ERROR, TRUE, "Error: Failed to set up the host freshness index, so host freshness can't be checked.\n");
+		return;
+	}
 
-		/* skip hosts that have both active and passive checks disabled */
-		if (temp_host->checks_enabled == FALSE && temp_host->accept_passive_checks == FALSE) {
-			continue;
-		}
+	/* check the hosts whose results may have gone stale... */
+	while ((temp_host = freshness_index_pop(&host_freshness, current_time)) != NULL) {
 
-		/* skip hosts that are currently executing (problems here will be caught by orphaned host check) */
+		/* skip hosts that are currently executing (problems here will be caught by orphaned host check).
+		 * They're put back in the index when their results come in */
 		if (temp_host->is_executing == TRUE) {
 			continue;
 		}
@@ -2846,8 +3237,9 @@ void check_host_result_freshness(void)
 			continue;
 		}
 
-		/* see if the time is right... */
+		/* see if the time is right, and look again next time around if it isn't */
 		if (check_time_against_period(current_time, temp_host->check_period_ptr) == ERROR) {
+			freshness_index_set(&host_freshness, temp_host->id, temp_host, TRUE, current_time + host_freshness_check_interval);
 			continue;
 		}
 
@@ -2860,28 +3252,23 @@ void check_host_result_freshness(void)
 			/* schedule an immediate forced check of the host */
 			schedule_host_check(temp_host, current_time, CHECK_OPTION_FORCE_EXECUTION | CHECK_OPTION_FRESHNESS_CHECK);
 		}
+
+		/* the deadline moved on without our noticing */
+		else {
+			update_host_freshness(temp_host);
+		}
 	}
 }
 
 
 
-/* checks to see if a hosts's check results are fresh */
-int is_host_result_fresh(host *temp_host, time_t current_time, int log_this)
+/* works out when the results of a host's last check go stale */
+static time_t host_freshness_expiration(host *temp_host, int *threshold)
 {
 	time_t expiration_time = 0L;
 	int freshness_threshold = 0;
-	int days = 0;
-	int hours = 0;
-	int minutes = 0;
-	int seconds = 0;
-	int tdays = 0;
-	int thours = 0;
-	int tminutes = 0;
-	int tseconds = 0;
 	double interval = 0;
 
-	log_debug_info(DEBUGL_CHECKS, 2, "Checking freshness of host '%s'...\n", temp_host->name);
-
 	/* use user-supplied freshness threshold or auto-calculate a freshness threshold to use? */
 	if (temp_host->freshness_threshold == 0) {
 
@@ -2898,8 +3285,6 @@ int is_host_result_fresh(host *temp_host, time_t current_time, int log_this)
 		freshness_threshold = temp_host->freshness_threshold;
 	}
 
-	log_debug_info(DEBUGL_CHECKS, 2, "Freshness thresholds: host=%d, use=%d\n", temp_host->freshness_threshold, freshness_threshold);
-
 	/* calculate expiration time */
 	/*
 	 * CHANGED 11/10/05 EG:
@@ -2949,6 +3334,31 @@ int is_host_result_fresh(host *temp_host, time_t current_time, int log_this)
 		expiration_time = event_start + freshness_threshold;
 	}
 
+	*threshold = freshness_threshold;
+	return expiration_time;
+}
+
+
+/* checks to see if a hosts's check results are fresh */
+int is_host_result_fresh(host *temp_host, time_t current_time, int log_this)
+{
+	time_t expiration_time = 0L;
+	int freshness_threshold = 0;
+	int days = 0;
+	int hours = 0;
+	int minutes = 0;
+	int seconds = 0;
+	int tdays = 0;
+	int thours = 0;
+	int tminutes = 0;
+	int tseconds = 0;
+
+	log_debug_info(DEBUGL_CHECKS, 2, "Checking freshness of host '%s'...\n", temp_host->name);
+
+	expiration_time = host_freshness_expiration(temp_host, &freshness_threshold);
+
+	log_debug_info(DEBUGL_CHECKS, 2, "Freshness thresholds: host=%d, use=%d\n", temp_host->freshness_threshold, freshness_threshold);
+
 	log_debug_info(DEBUGL_CHECKS, 2, 
 		"HBC: %d, PS: %lu, ES: %lu, LC: %lu, CT: %lu, ET: %lu\n", 
 		temp_host->has_been_checked, 
@@ -3099,6 +3509,7 @@ int run_async_host_check(host *hst, int check_options, double latency, int sched
 {
 	nagios_macros mac;
 	char *raw_command = NULL;
+	command_template *tpl = NULL;
 	char *processed_command = NULL;
 	struct timeval start_time, end_time;
 	double old_latency = 0.0;
@@ -3186,17 +3597,24 @@ int run_async_host_check(host *hst, int check_options, double latency, int sched
 	memset(&mac, 0, sizeof(mac));
 	grab_host_macros_r(&mac, hst);
 
-	/* get the raw command line */
-	get_raw_command_line_r(&mac, hst->check_command_ptr, hst->check_command, &raw_command, macro_options);
-	if (raw_command == NULL) {
-		clear_volatile_macros_r(&mac);
-		log_debug_info(DEBUGL_CHECKS, 0, "Raw check command for host '%s' was NULL - aborting.\n", hst->name);
-		return ERROR;
+	/* expand the compiled check command */
+	tpl = get_check_template(&host_check_templates, num_objects.hosts, hst->id, hst->check_command_ptr, hst->check_command);
+	if (tpl != NULL) {
+		expand_command_template_r(&mac, tpl, &processed_command, macro_options);
 	}
+	else {
+		/* get the raw command line */
+		get_raw_command_line_r(&mac, hst->check_command_ptr, hst->check_command, &raw_command, macro_options);
+		if (raw_command == NULL) {
+			clear_volatile_macros_r(&mac);
+			log_debug_info(DEBUGL_CHECKS, 0, "Raw check command for host '%s' was NULL - aborting.\n", hst->name);
+			return ERROR;
+		}
 
-	/* process any macros contained in the argument */
-	process_macros_r(&mac, raw_command, &processed_command, macro_options);
-	my_free(raw_command);
+		/* process any macros contained in the argument */
+		process_macros_r(&mac, raw_command, &processed_command, macro_options);
+		my_free(raw_command);
+	}
 	if (processed_command == NULL) {
 		clear_volatile_macros_r(&mac);
 		log_debug_info(DEBUGL_CHECKS, 0, "Processed check command for host '%s' was NULL - aborting.\n", hst->name);
@@ -3206,14 +3624,13 @@ int run_async_host_check(host *hst, int check_options, double latency, int sched
 	/* get the command start time */
 	gettimeofday(&start_time, NULL);
 
-	cr = calloc(1, sizeof(*cr));
+	cr = alloc_check_result();
 	if (!cr) {
 		log_debug_info(DEBUGL_CHECKS, 0, "Failed to allocate checkresult struct\n");
 		clear_volatile_macros_r(&mac);
 		clear_host_macros_r(&mac);
 		return ERROR;
 	}
-	init_check_result(cr);
 
 	/* save check info */
 	cr->object_check_type = HOST_CHECK;
@@ -3239,8 +3656,7 @@ int run_async_host_check(host *hst, int check_options, double latency, int sched
 	if (neb_result == NEBERROR_CALLBACKOVERRIDE) {
 		clear_volatile_macros_r(&mac);
 		hst->latency = old_latency;
-		free_check_result(cr);
-		my_free(cr);
+		release_check_result(cr);
 		my_free(processed_command);
 		return OK;
 	}
@@ -3404,17 +3820,75 @@ inline int determine_host_reachability(host *hst)
 /****************** HOST STATE HANDLER FUNCTIONS ******************/
 /******************************************************************/
 
+/* a string pieced together from plugin output, in a buffer known to be big enough */
+struct output_text {
+	char *buf;
+	size_t len;
+};
+
+static inline void output_text_cat(struct output_text *t, const char *str)
+{
+	size_t len = strlen(str);
+
+	memcpy(t->buf + t->len, str, len + 1);
+	t->len += len;
+}
+
+/* escape_newlines() for strings that live in an arena */
+static char *arena_escape_newlines(arena *a, const char *raw)
+{
+	size_t x, y;
+	char *ret;
+
+	for (x = 0, y = 0; raw[x]; x++) {
+		if (raw[x] == '\\' || raw[x] == '\n')
+			y++;
+	}
+	if (!(ret = arena_alloc(a, x + y + 1)))
+		return NULL;
 
+	for (x = 0, y = 0; raw[x]; x++) {
+		if (raw[x] == '\\') {
+			ret[y++] = '\\';
+			ret[y++] = '\\';
+		}
+		else if (raw[x] == '\n') {
+			ret[y++] = '\\';
+			ret[y++] = 'n';
+		}
+		else {
+			ret[y++] = raw[x];
+		}
+	}
+	ret[y] = '\0';
+
+	return ret;
+}
 
-/* Parses raw plugin output and returns: short and long output, perf data. */
+
+/*
+ * Parses raw plugin output and returns: short and long output, perf data.
+ * This keeps no static state, so it's safe to call from the check
+ * result threads as long as each thread has its own buf.
+ */
 int parse_check_output(char *buf, char **short_output, char **long_output, char **perf_data, int escape_newlines_please, int newlines_are_escaped)
+{
+	return parse_check_output_arena(NULL, buf, short_output, long_output, perf_data, escape_newlines_please, newlines_are_escaped);
+}
+
+
+/*
+ * Same as parse_check_output(), but if an arena is given, the results
+ * are allocated from it and must not be free()'d.
+ */
+int parse_check_output_arena(arena *a, char *buf, char **short_output, char **long_output, char **perf_data, int escape_newlines_please, int newlines_are_escaped)
 {
 	int current_line = 0;
 	int eof = FALSE;
 	int in_perf_data = FALSE;
-	const int dbuf_chunk = 1024;
-	dbuf long_text;
-	dbuf perf_text;
+	struct output_text long_text;
+	struct output_text perf_text;
+	size_t len;
 	char *ptr = NULL;
 	int x = 0;
 	int y = 0;
@@ -3438,9 +3912,27 @@ int parse_check_output(char *buf, char **short_output, char **long_output, char
 		return OK;
 	}
 
-	/* Initialize dynamic buffers (1KB chunk size). */
-	dbuf_init(&long_text, dbuf_chunk);
-	dbuf_init(&perf_text, dbuf_chunk);
+	/* Neither the long output nor the perf data can be longer than the
+	 * input, since every separator we add replaces one we removed, so
+	 * one buffer each of that size is all we ever need. */
+	len = strlen(buf) + 1;
+	long_text.len = perf_text.len = 0;
+	if (a) {
+		long_text.buf = arena_alloc(a, len);
+		perf_text.buf = arena_alloc(a, len);
+	}
+	else {
+		long_text.buf = malloc(len);
+		perf_text.buf = malloc(len);
+	}
+	if (!long_text.buf || !perf_text.buf) {
+		if (!a) {
+			my_free(long_text.buf);
+			my_free(perf_text.buf);
+		}
+		return ERROR;
+	}
+	*long_text.buf = *perf_text.buf = '\0';
 
 	/* We should never need to worry about unescaping here again. We assume a
 	 * common internal plugin output format that is newline delimited. */
@@ -3481,72 +3973,72 @@ int parse_check_output(char *buf, char **short_output, char **long_output, char
 		/* The first line contains short plugin output and optional perf data. */
 		if (current_line == 1) {
 
-			/* Get the short plugin output. If buf[0] is '|', strtok() will
-			 * return buf+1 or NULL if buf[1] is '\0'. We use my_strtok_with_free()
-			 * instead which returns a pointer to '\0' in this case. */
-			ptr =  my_strtok_with_free(buf, "|", FALSE);
-			if (ptr != NULL) {
+			/* Get the short plugin output. If buf[0] is '|', the short
+			 * output is empty. The separator is put back once we're done
+			 * so the caller's buffer keeps its perf data. */
+			if (*buf) {
+				ptr = strchr(buf, '|');
+				if (ptr != NULL) {
+					*ptr = '\0';
+				}
 
 				if (short_output) {
 
 					/* Remove leading and trailing whitespace. */
-					strip(ptr);
-					*short_output = strdup(ptr);
+					*short_output = a ? arena_strdup(a, buf) : strdup(buf);
+					if (*short_output) {
+						strip(*short_output);
+					}
 				}
 
 				/* Get the optional perf data. */
-				ptr = my_strtok_with_free(NULL, "\n", FALSE);
 				if (ptr != NULL) {
-					dbuf_strcat(&perf_text, ptr);
+					if (ptr[1]) {
+						output_text_cat(&perf_text, ptr + 1);
+					}
+					*ptr = '|';
 				}
-
-				/* free anything we've allocated */
-				my_strtok_with_free(NULL, NULL, TRUE);
 			}
 		}
 
 		/* Additional lines contain long plugin output and optional perf data.
 		 * Once we've hit perf data, the rest of the output is perf data. */
 		else if (in_perf_data) {
-			if (perf_text.buf && *perf_text.buf) {
-				dbuf_strcat(&perf_text, " ");
+			if (perf_text.len) {
+				output_text_cat(&perf_text, " ");
 			}
-			dbuf_strcat(&perf_text, buf);
+			output_text_cat(&perf_text, buf);
 		}
 
 		/* Look for the perf data separator. */
 		else if (strchr(buf, '|')) {
 			in_perf_data = TRUE;
 
-			ptr = my_strtok_with_free(buf, "|", FALSE);
-			if (ptr != NULL) {
+			ptr = strchr(buf, '|');
+			*ptr = '\0';
 
-				/* Get the remaining long plugin output. */
-				if (current_line > 2) {
-					dbuf_strcat(&long_text, "\n");
-				}
-				dbuf_strcat(&long_text, ptr);
+			/* Get the remaining long plugin output. */
+			if (current_line > 2) {
+				output_text_cat(&long_text, "\n");
+			}
+			output_text_cat(&long_text, buf);
 
-				/* Get the perf data. */
-				ptr = my_strtok_with_free(NULL, "\n", FALSE);
-				if (ptr != NULL) {
-					if (perf_text.buf && *perf_text.buf) {
-						dbuf_strcat(&perf_text, " ");
-					}
-					dbuf_strcat(&perf_text, ptr);
+			/* Get the perf data. */
+			if (ptr[1]) {
+				if (perf_text.len) {
+					output_text_cat(&perf_text, " ");
 				}
-
-				/* free anything we've allocated */
-				my_strtok_with_free(NULL, NULL, TRUE);
+				output_text_cat(&perf_text, ptr + 1);
 			}
+			*ptr = '|';
 		}
 
 		/* Otherwise it's still just long output. */
 		else {
 			if (current_line > 2) {
-				dbuf_strcat(&long_text, "\n");
+				output_text_cat(&long_text, "\n");
 			}
-			dbuf_strcat(&long_text, buf);
+			output_text_cat(&long_text, buf);
 		}
 
 		/* Point buf to the start of the next line. *(buf+x+1) will be a valid
@@ -3559,28 +4051,30 @@ int parse_check_output(char *buf, char **short_output, char **long_output, char
 	}
 
 	/* Save long output. */
-	if (long_output && long_text.buf && *long_text.buf) {
+	if (long_output && *long_text.buf) {
 
 		/* Escape newlines (and backslashes) in long output if requested. */
 		if (escape_newlines_please) {
-			*long_output = escape_newlines(long_text.buf);
+			*long_output = a ? arena_escape_newlines(a, long_text.buf) : escape_newlines(long_text.buf);
 		}
 		else {
-			*long_output = strdup(long_text.buf);
+			*long_output = a ? long_text.buf : strdup(long_text.buf);
 		}
 	}
 
 	/* Save perf data. */
-	if (perf_data && perf_text.buf && *perf_text.buf) {
+	if (perf_data && *perf_text.buf) {
 
 		/* Remove leading and trailing whitespace. */
 		strip(perf_text.buf); 
-		*perf_data = strdup(perf_text.buf);
+		*perf_data = a ? perf_text.buf : strdup(perf_text.buf);
 	}
 
-	/* free dynamic buffers */
-	dbuf_free(&long_text);
-	dbuf_free(&perf_text);
+	/* arena buffers go away with the arena */
+	if (!a) {
+		my_free(long_text.buf);
+		my_free(perf_text.buf);
+	}
 
 	return OK;
 }
@@ -30,6 +30,7 @@
 #include "../include/broker.h"
 #include "../include/nagios.h"
 #include "../include/workers.h"
+#include "extcmd-phash.h"
 
 
 extern int sigrestart;
@@ -48,6 +49,31 @@ static struct {
 	iocache *ioc;
 } command_worker = { "command file", "command file worker", 0, 0, NULL };
 
+/*
+ * Commands read from the worker in one go are processed as a batch.
+ * They share a single timestamp, and since senders tend to submit
+ * results for all services on a host at once, we remember the last
+ * host we looked up.
+ */
+static struct {
+	int active;
+	struct timeval now;
+	host *last_host;
+} cmd_batch;
+
+/*
+ * Splits command arguments in place, like my_strtok() does on its own
+ * copy. The separators it overwrites are remembered so the arguments
+ * can be restored for logging and the event broker afterwards.
+ */
+#define CMD_ARGS_MAX_TOKENS 8
+struct cmd_args {
+	char *next;
+	char *cut[CMD_ARGS_MAX_TOKENS];
+	char cut_char[CMD_ARGS_MAX_TOKENS];
+	int num_cut;
+};
+
 
 /******************************************************************/
 /************* EXTERNAL COMMAND WORKER CONTROLLERS ****************/
@@ -142,7 +168,7 @@ int shutdown_command_file_worker(void) {
 
 
 static int command_input_handler(int sd, int events, void *discard) {
-	int ret, cmd_ret;
+	int ret;
 	char *buf;
 	unsigned long size;
 
@@ -157,18 +183,13 @@ static int command_input_handler(int sd, int events, void *discard) {
 		launch_command_file_worker();
 		return 0;
 		}
-	while ((buf = iocache_use_delim(command_worker.ioc, "\n", 1, &size))) {
-		if (buf[0] == '[') {
-			/* raw external command */
-			buf[size] = 0;
-			log_debug_info(DEBUGL_COMMANDS, 1, "Read raw external command '%s'\n", buf);
-			}
 
-		if ((cmd_ret = process_external_command1(buf)) != CMD_ERROR_OK) {
-			logit(NSLOG_EXTERNAL_COMMAND | NSLOG_RUNTIME_WARNING, TRUE, "External command %s returned error %s\n", buf, cmd_error_strerror(cmd_ret));
-			}
+	/* hand all complete commands over at once and keep any partial one */
+	size = iocache_available(command_worker.ioc);
+	if (!size || !(buf = iocache_use_size(command_worker.ioc, size)))
+		return 0;
+	iocache_unuse_size(command_worker.ioc, size - process_external_command_batch(buf, size));
 
-		}
 	return 0;
 	}
 
@@ -326,8 +347,14 @@ static host *find_host_by_name_or_address(const char *name)
 {
 	host *h;
 
-	if ((h = find_host(name)) || !name)
+	if (name && cmd_batch.last_host && !strcmp(cmd_batch.last_host->name, name))
+		return cmd_batch.last_host;
+
+	if ((h = find_host(name)) || !name) {
+		if (cmd_batch.active)
+			cmd_batch.last_host = h;
 		return h;
+	}
 
 	for (h = host_list; h; h = h->next)
 		if (!strcmp(h->address, name))
@@ -336,6 +363,98 @@ static host *find_host_by_name_or_address(const char *name)
 	return NULL;
 }
 
+/* gets the current time, which stays the same throughout a batch */
+static void get_command_time(struct timeval *tv) {
+
+	if(cmd_batch.active == TRUE)
+		*tv = cmd_batch.now;
+	else
+		gettimeofday(tv, NULL);
+	}
+
+static void cmd_args_init(struct cmd_args *ca, char *args) {
+
+	ca->next = args;
+	ca->num_cut = 0;
+	}
+
+/* returns the next token up to delim, or NULL if there's nothing left */
+static char *cmd_args_next(struct cmd_args *ca, int delim) {
+	char *token = ca->next;
+	char *p;
+
+	if(token == NULL || token[0] == '\x0')
+		return NULL;
+
+	if((p = strchr(token, delim)) == NULL) {
+		ca->next = token + strlen(token);
+		return token;
+		}
+
+	/* out of room to remember separators, so the rest is the last token */
+	if(ca->num_cut == CMD_ARGS_MAX_TOKENS) {
+		ca->next = token + strlen(token);
+		return token;
+		}
+
+	ca->cut[ca->num_cut] = p;
+	ca->cut_char[ca->num_cut++] = *p;
+	*p = '\x0';
+	ca->next = p + 1;
+
+	return token;
+	}
+
+/* puts back the separators cmd_args_next() overwrote */
+static void cmd_args_restore(struct cmd_args *ca) {
+
+	while(ca->num_cut > 0) {
+		ca->num_cut--;
+		*ca->cut[ca->num_cut] = ca->cut_char[ca->num_cut];
+		}
+	}
+
+/*
+ * processes the complete, newline-terminated commands at the start of
+ * buf and returns how many bytes they took up. buf is left as it was,
+ * apart from whitespace stripped from the end of each command.
+ */
+unsigned long process_external_command_batch(char *buf, unsigned long size) {
+	char *line = buf;
+	char *eol = NULL;
+	int cmd_ret = CMD_ERROR_OK;
+
+	log_debug_info(DEBUGL_FUNCTIONS, 0, "process_external_command_batch()\n");
+
+	if(buf == NULL)
+		return 0;
+
+	cmd_batch.active = TRUE;
+	cmd_batch.last_host = NULL;
+	gettimeofday(&cmd_batch.now, NULL);
+
+	while((eol = memchr(line, '\n', size - (line - buf))) != NULL) {
+		*eol = '\x0';
+
+		if(line[0] == '[') {
+			/* raw external command */
+			log_debug_info(DEBUGL_COMMANDS, 1, "Read raw external command '%s'\n", line);
+			}
+
+		if((cmd_ret = process_external_command1(line)) != CMD_ERROR_OK) {
+			logit(NSLOG_EXTERNAL_COMMAND | NSLOG_RUNTIME_WARNING, TRUE, "External command %s returned error %s\n", line, cmd_error_strerror(cmd_ret));
+			}
+
+		*eol = '\n';
+		line = eol + 1;
+		}
+
+	cmd_batch.active = FALSE;
+	cmd_batch.last_host = NULL;
+
+	return line - buf;
+	}
+
 /* processes all external commands in a (regular) file */
 int process_external_commands_from_file(char *fname, int delete_file) {
 	mmapfile *thefile = NULL;
@@ -385,6 +504,9 @@ int process_external_command1(char *cmd) {
 	char *temp_buffer = NULL;
 	char *command_id = NULL;
 	char *args = NULL;
+	char *semicolon = NULL;
+	char *newline = NULL;
+	struct extcmd_key *key = NULL;
 	time_t entry_time = 0L;
 	int command_type = CMD_NONE;
 	char *temp_ptr = NULL;
@@ -400,513 +522,56 @@ int process_external_command1(char *cmd) {
 
 	log_debug_info(DEBUGL_EXTERNALCOMMANDS, 2, "Raw command entry: %s\n", cmd);
 
+	/*
+	 * The command is split in place rather than copied. The separators
+	 * we overwrite are put back before returning, so the caller gets
+	 * its buffer back the way it was after strip().
+	 */
+
 	/* get the command entry time */
-	if((temp_ptr = my_strtok_with_free(cmd, "[", FALSE)) == NULL)
+	if((temp_ptr = strchr(cmd, '[')) == NULL)
 		return CMD_ERROR_MALFORMED_COMMAND;
-	if((temp_ptr = my_strtok_with_free(NULL, "]", FALSE)) == NULL) {
-		temp_ptr = my_strtok_with_free(NULL, NULL, TRUE);
+	entry_time = (time_t)strtoul(temp_ptr + 1, NULL, 10);
+	if((temp_ptr = strchr(temp_ptr + 1, ']')) == NULL || *(++temp_ptr) == '\x0')
 		return CMD_ERROR_MALFORMED_COMMAND;
-		}
-	entry_time = (time_t)strtoul(temp_ptr, NULL, 10);
 
-	/* get the command identifier */
-	if((temp_ptr = my_strtok_with_free(NULL, ";", FALSE)) == NULL) {
-		temp_ptr = my_strtok_with_free(NULL, NULL, TRUE);
-		return CMD_ERROR_MALFORMED_COMMAND;
-		}
-	else if((command_id = (char *)strdup(temp_ptr + 1)) == NULL) {
-		temp_ptr = my_strtok_with_free(NULL, NULL, TRUE);
-		return CMD_ERROR_INTERNAL_ERROR;
-		}
+	/* get the command identifier, skipping the space after the entry time */
+	command_id = temp_ptr + 1;
 
 	/* get the command arguments */
-	if((temp_ptr = my_strtok_with_free(NULL, "\n", FALSE)) == NULL)
-		args = (char *)strdup("");
-	else
-		args = (char *)strdup(temp_ptr);
-
-	temp_ptr = my_strtok_with_free(NULL, NULL, TRUE);
-	if(args == NULL) {
-		my_free(command_id);
-		return CMD_ERROR_INTERNAL_ERROR;
+	if((semicolon = strchr(temp_ptr, ';')) == NULL)
+		args = command_id + strlen(command_id);
+	else {
+		*semicolon = '\x0';
+		args = semicolon + 1;
+		if((newline = strchr(args, '\n')) != NULL)
+			*newline = '\x0';
 		}
 
 	/* decide what type of command this is... */
+	if((key = extcmd_get_key(command_id, strlen(command_id))) != NULL)
+		command_type = key->code;
 
-	/**************************/
-	/**** PROCESS COMMANDS ****/
-	/**************************/
-
-	if(!strcasecmp(command_id, "ENTER_STANDBY_MODE") || !strcasecmp(command_id, "DISABLE_NOTIFICATIONS"))
-		command_type = CMD_DISABLE_NOTIFICATIONS;
-	else if(!strcasecmp(command_id, "ENTER_ACTIVE_MODE") || !strcasecmp(command_id, "ENABLE_NOTIFICATIONS"))
-		command_type = CMD_ENABLE_NOTIFICATIONS;
-
-	else if(!strcasecmp(command_id, "SHUTDOWN_PROGRAM") || !strcasecmp(command_id, "SHUTDOWN_PROCESS"))
-		command_type = CMD_SHUTDOWN_PROCESS;
-	else if(!strcasecmp(command_id, "RESTART_PROGRAM") || !strcasecmp(command_id, "RESTART_PROCESS"))
-		command_type = CMD_RESTART_PROCESS;
-
-	else if(!strcasecmp(command_id, "SAVE_STATE_INFORMATION"))
-		command_type = CMD_SAVE_STATE_INFORMATION;
-	else if(!strcasecmp(command_id, "READ_STATE_INFORMATION"))
-		command_type = CMD_READ_STATE_INFORMATION;
-
-	else if(!strcasecmp(command_id, "ENABLE_EVENT_HANDLERS"))
-		command_type = CMD_ENABLE_EVENT_HANDLERS;
-	else if(!strcasecmp(command_id, "DISABLE_EVENT_HANDLERS"))
-		command_type = CMD_DISABLE_EVENT_HANDLERS;
-
-	else if(!strcasecmp(command_id, "ENABLE_PERFORMANCE_DATA"))
-		command_type = CMD_ENABLE_PERFORMANCE_DATA;
-	else if(!strcasecmp(command_id, "DISABLE_PERFORMANCE_DATA"))
-		command_type = CMD_DISABLE_PERFORMANCE_DATA;
-
-	else if(!strcasecmp(command_id, "START_EXECUTING_HOST_CHECKS"))
-		command_type = CMD_START_EXECUTING_HOST_CHECKS;
-	else if(!strcasecmp(command_id, "STOP_EXECUTING_HOST_CHECKS"))
-		command_type = CMD_STOP_EXECUTING_HOST_CHECKS;
-
-	else if(!strcasecmp(command_id, "START_EXECUTING_SVC_CHECKS"))
-		command_type = CMD_START_EXECUTING_SVC_CHECKS;
-	else if(!strcasecmp(command_id, "STOP_EXECUTING_SVC_CHECKS"))
-		command_type = CMD_STOP_EXECUTING_SVC_CHECKS;
-
-	else if(!strcasecmp(command_id, "START_ACCEPTING_PASSIVE_HOST_CHECKS"))
-		command_type = CMD_START_ACCEPTING_PASSIVE_HOST_CHECKS;
-	else if(!strcasecmp(command_id, "STOP_ACCEPTING_PASSIVE_HOST_CHECKS"))
-		command_type = CMD_STOP_ACCEPTING_PASSIVE_HOST_CHECKS;
-
-	else if(!strcasecmp(command_id, "START_ACCEPTING_PASSIVE_SVC_CHECKS"))
-		command_type = CMD_START_ACCEPTING_PASSIVE_SVC_CHECKS;
-	else if(!strcasecmp(command_id, "STOP_ACCEPTING_PASSIVE_SVC_CHECKS"))
-		command_type = CMD_STOP_ACCEPTING_PASSIVE_SVC_CHECKS;
-
-	else if(!strcasecmp(command_id, "START_OBSESSING_OVER_HOST_CHECKS"))
-		command_type = CMD_START_OBSESSING_OVER_HOST_CHECKS;
-	else if(!strcasecmp(command_id, "STOP_OBSESSING_OVER_HOST_CHECKS"))
-		command_type = CMD_STOP_OBSESSING_OVER_HOST_CHECKS;
-
-	else if(!strcasecmp(command_id, "START_OBSESSING_OVER_SVC_CHECKS"))
-		command_type = CMD_START_OBSESSING_OVER_SVC_CHECKS;
-	else if(!strcasecmp(command_id, "STOP_OBSESSING_OVER_SVC_CHECKS"))
-		command_type = CMD_STOP_OBSESSING_OVER_SVC_CHECKS;
-
-	else if(!strcasecmp(command_id, "ENABLE_FLAP_DETECTION"))
-		command_type = CMD_ENABLE_FLAP_DETECTION;
-	else if(!strcasecmp(command_id, "DISABLE_FLAP_DETECTION"))
-		command_type = CMD_DISABLE_FLAP_DETECTION;
-
-	else if(!strcasecmp(command_id, "CHANGE_GLOBAL_HOST_EVENT_HANDLER"))
-		command_type = CMD_CHANGE_GLOBAL_HOST_EVENT_HANDLER;
-	else if(!strcasecmp(command_id, "CHANGE_GLOBAL_SVC_EVENT_HANDLER"))
-		command_type = CMD_CHANGE_GLOBAL_SVC_EVENT_HANDLER;
-
-	else if(!strcasecmp(command_id, "ENABLE_SERVICE_FRESHNESS_CHECKS"))
-		command_type = CMD_ENABLE_SERVICE_FRESHNESS_CHECKS;
-	else if(!strcasecmp(command_id, "DISABLE_SERVICE_FRESHNESS_CHECKS"))
-		command_type = CMD_DISABLE_SERVICE_FRESHNESS_CHECKS;
-
-	else if(!strcasecmp(command_id, "ENABLE_HOST_FRESHNESS_CHECKS"))
-		command_type = CMD_ENABLE_HOST_FRESHNESS_CHECKS;
-	else if(!strcasecmp(command_id, "DISABLE_HOST_FRESHNESS_CHECKS"))
-		command_type = CMD_DISABLE_HOST_FRESHNESS_CHECKS;
-
-
-	/*******************************/
-	/**** HOST-RELATED COMMANDS ****/
-	/*******************************/
-
-	else if(!strcasecmp(command_id, "ADD_HOST_COMMENT"))
-		command_type = CMD_ADD_HOST_COMMENT;
-	else if(!strcasecmp(command_id, "DEL_HOST_COMMENT"))
-		command_type = CMD_DEL_HOST_COMMENT;
-	else if(!strcasecmp(command_id, "DEL_ALL_HOST_COMMENTS"))
-		command_type = CMD_DEL_ALL_HOST_COMMENTS;
-
-	else if(!strcasecmp(command_id, "DELAY_HOST_NOTIFICATION"))
-		command_type = CMD_DELAY_HOST_NOTIFICATION;
-
-	else if(!strcasecmp(command_id, "ENABLE_HOST_NOTIFICATIONS"))
-		command_type = CMD_ENABLE_HOST_NOTIFICATIONS;
-	else if(!strcasecmp(command_id, "DISABLE_HOST_NOTIFICATIONS"))
-		command_type = CMD_DISABLE_HOST_NOTIFICATIONS;
-
-	else if(!strcasecmp(command_id, "ENABLE_ALL_NOTIFICATIONS_BEYOND_HOST"))
-		command_type = CMD_ENABLE_ALL_NOTIFICATIONS_BEYOND_HOST;
-	else if(!strcasecmp(command_id, "DISABLE_ALL_NOTIFICATIONS_BEYOND_HOST"))
-		command_type = CMD_DISABLE_ALL_NOTIFICATIONS_BEYOND_HOST;
-
-	else if(!strcasecmp(command_id, "ENABLE_HOST_AND_CHILD_NOTIFICATIONS"))
-		command_type = CMD_ENABLE_HOST_AND_CHILD_NOTIFICATIONS;
-	else if(!strcasecmp(command_id, "DISABLE_HOST_AND_CHILD_NOTIFICATIONS"))
-		command_type = CMD_DISABLE_HOST_AND_CHILD_NOTIFICATIONS;
-
-	else if(!strcasecmp(command_id, "ENABLE_HOST_SVC_NOTIFICATIONS"))
-		command_type = CMD_ENABLE_HOST_SVC_NOTIFICATIONS;
-	else if(!strcasecmp(command_id, "DISABLE_HOST_SVC_NOTIFICATIONS"))
-		command_type = CMD_DISABLE_HOST_SVC_NOTIFICATIONS;
-
-	else if(!strcasecmp(command_id, "ENABLE_HOST_SVC_CHECKS"))
-		command_type = CMD_ENABLE_HOST_SVC_CHECKS;
-	else if(!strcasecmp(command_id, "DISABLE_HOST_SVC_CHECKS"))
-		command_type = CMD_DISABLE_HOST_SVC_CHECKS;
-
-	else if(!strcasecmp(command_id, "ENABLE_PASSIVE_HOST_CHECKS"))
-		command_type = CMD_ENABLE_PASSIVE_HOST_CHECKS;
-	else if(!strcasecmp(command_id, "DISABLE_PASSIVE_HOST_CHECKS"))
-		command_type = CMD_DISABLE_PASSIVE_HOST_CHECKS;
-
-	else if(!strcasecmp(command_id, "SCHEDULE_HOST_SVC_CHECKS"))
-		command_type = CMD_SCHEDULE_HOST_SVC_CHECKS;
-	else if(!strcasecmp(command_id, "SCHEDULE_FORCED_HOST_SVC_CHECKS"))
-		command_type = CMD_SCHEDULE_FORCED_HOST_SVC_CHECKS;
-
-	else if(!strcasecmp(command_id, "ACKNOWLEDGE_HOST_PROBLEM"))
-		command_type = CMD_ACKNOWLEDGE_HOST_PROBLEM;
-	else if(!strcasecmp(command_id, "REMOVE_HOST_ACKNOWLEDGEMENT"))
-		command_type = CMD_REMOVE_HOST_ACKNOWLEDGEMENT;
-
-	else if(!strcasecmp(command_id, "ENABLE_HOST_EVENT_HANDLER"))
-		command_type = CMD_ENABLE_HOST_EVENT_HANDLER;
-	else if(!strcasecmp(command_id, "DISABLE_HOST_EVENT_HANDLER"))
-		command_type = CMD_DISABLE_HOST_EVENT_HANDLER;
-
-	else if(!strcasecmp(command_id, "ENABLE_HOST_CHECK"))
-		command_type = CMD_ENABLE_HOST_CHECK;
-	else if(!strcasecmp(command_id, "DISABLE_HOST_CHECK"))
-		command_type = CMD_DISABLE_HOST_CHECK;
-
-	else if(!strcasecmp(command_id, "SCHEDULE_HOST_CHECK"))
-		command_type = CMD_SCHEDULE_HOST_CHECK;
-	else if(!strcasecmp(command_id, "SCHEDULE_FORCED_HOST_CHECK"))
-		command_type = CMD_SCHEDULE_FORCED_HOST_CHECK;
-
-	else if(!strcasecmp(command_id, "SCHEDULE_HOST_DOWNTIME"))
-		command_type = CMD_SCHEDULE_HOST_DOWNTIME;
-	else if(!strcasecmp(command_id, "SCHEDULE_HOST_SVC_DOWNTIME"))
-		command_type = CMD_SCHEDULE_HOST_SVC_DOWNTIME;
-	else if(!strcasecmp(command_id, "DEL_HOST_DOWNTIME"))
-		command_type = CMD_DEL_HOST_DOWNTIME;
-	else if(!strcasecmp(command_id, "DEL_DOWNTIME_BY_HOST_NAME"))
-		command_type = CMD_DEL_DOWNTIME_BY_HOST_NAME;
-	else if(!strcasecmp(command_id, "DEL_DOWNTIME_BY_HOSTGROUP_NAME"))
-		command_type = CMD_DEL_DOWNTIME_BY_HOSTGROUP_NAME;
-	else if(!strcasecmp(command_id, "DEL_DOWNTIME_BY_START_TIME_COMMENT"))
-		command_type = CMD_DEL_DOWNTIME_BY_START_TIME_COMMENT;
-
-	else if(!strcasecmp(command_id, "ENABLE_HOST_FLAP_DETECTION"))
-		command_type = CMD_ENABLE_HOST_FLAP_DETECTION;
-	else if(!strcasecmp(command_id, "DISABLE_HOST_FLAP_DETECTION"))
-		command_type = CMD_DISABLE_HOST_FLAP_DETECTION;
-
-	else if(!strcasecmp(command_id, "START_OBSESSING_OVER_HOST"))
-		command_type = CMD_START_OBSESSING_OVER_HOST;
-	else if(!strcasecmp(command_id, "STOP_OBSESSING_OVER_HOST"))
-		command_type = CMD_STOP_OBSESSING_OVER_HOST;
-
-	else if(!strcasecmp(command_id, "CHANGE_HOST_EVENT_HANDLER"))
-		command_type = CMD_CHANGE_HOST_EVENT_HANDLER;
-
-	else if(!strcasecmp(command_id, "CHANGE_HOST_EVENT_HANDLER_TIMEPERIOD"))
-		command_type = CMD_CHANGE_HOST_EVENT_HANDLER_TIMEPERIOD;
-
-	else if(!strcasecmp(command_id, "CHANGE_HOST_CHECK_COMMAND"))
-		command_type = CMD_CHANGE_HOST_CHECK_COMMAND;
-
-	else if(!strcasecmp(command_id, "CHANGE_NORMAL_HOST_CHECK_INTERVAL"))
-		command_type = CMD_CHANGE_NORMAL_HOST_CHECK_INTERVAL;
-	else if(!strcasecmp(command_id, "CHANGE_RETRY_HOST_CHECK_INTERVAL"))
-		command_type = CMD_CHANGE_RETRY_HOST_CHECK_INTERVAL;
-
-	else if(!strcasecmp(command_id, "CHANGE_MAX_HOST_CHECK_ATTEMPTS"))
-		command_type = CMD_CHANGE_MAX_HOST_CHECK_ATTEMPTS;
-
-	else if(!strcasecmp(command_id, "SCHEDULE_AND_PROPAGATE_TRIGGERED_HOST_DOWNTIME"))
-		command_type = CMD_SCHEDULE_AND_PROPAGATE_TRIGGERED_HOST_DOWNTIME;
-
-	else if(!strcasecmp(command_id, "SCHEDULE_AND_PROPAGATE_HOST_DOWNTIME"))
-		command_type = CMD_SCHEDULE_AND_PROPAGATE_HOST_DOWNTIME;
-
-	else if(!strcasecmp(command_id, "SET_HOST_NOTIFICATION_NUMBER"))
-		command_type = CMD_SET_HOST_NOTIFICATION_NUMBER;
-
-	else if(!strcasecmp(command_id, "CHANGE_HOST_CHECK_TIMEPERIOD"))
-		command_type = CMD_CHANGE_HOST_CHECK_TIMEPERIOD;
-
-	else if(!strcasecmp(command_id, "CHANGE_CUSTOM_HOST_VAR"))
-		command_type = CMD_CHANGE_CUSTOM_HOST_VAR;
-
-	else if(!strcasecmp(command_id, "SEND_CUSTOM_HOST_NOTIFICATION"))
-		command_type = CMD_SEND_CUSTOM_HOST_NOTIFICATION;
-
-	else if(!strcasecmp(command_id, "CHANGE_HOST_NOTIFICATION_TIMEPERIOD"))
-		command_type = CMD_CHANGE_HOST_NOTIFICATION_TIMEPERIOD;
-
-	else if(!strcasecmp(command_id, "CHANGE_HOST_MODATTR"))
-		command_type = CMD_CHANGE_HOST_MODATTR;
-
-	else if (!strcasecmp(command_id,"CLEAR_HOST_FLAPPING_STATE"))
-		command_type = CMD_CLEAR_HOST_FLAPPING_STATE;
-
-	/************************************/
-	/**** HOSTGROUP-RELATED COMMANDS ****/
-	/************************************/
-
-	else if(!strcasecmp(command_id, "ENABLE_HOSTGROUP_HOST_NOTIFICATIONS"))
-		command_type = CMD_ENABLE_HOSTGROUP_HOST_NOTIFICATIONS;
-	else if(!strcasecmp(command_id, "DISABLE_HOSTGROUP_HOST_NOTIFICATIONS"))
-		command_type = CMD_DISABLE_HOSTGROUP_HOST_NOTIFICATIONS;
-
-	else if(!strcasecmp(command_id, "ENABLE_HOSTGROUP_SVC_NOTIFICATIONS"))
-		command_type = CMD_ENABLE_HOSTGROUP_SVC_NOTIFICATIONS;
-	else if(!strcasecmp(command_id, "DISABLE_HOSTGROUP_SVC_NOTIFICATIONS"))
-		command_type = CMD_DISABLE_HOSTGROUP_SVC_NOTIFICATIONS;
-
-	else if(!strcasecmp(command_id, "ENABLE_HOSTGROUP_HOST_CHECKS"))
-		command_type = CMD_ENABLE_HOSTGROUP_HOST_CHECKS;
-	else if(!strcasecmp(command_id, "DISABLE_HOSTGROUP_HOST_CHECKS"))
-		command_type = CMD_DISABLE_HOSTGROUP_HOST_CHECKS;
-
-	else if(!strcasecmp(command_id, "ENABLE_HOSTGROUP_PASSIVE_HOST_CHECKS"))
-		command_type = CMD_ENABLE_HOSTGROUP_PASSIVE_HOST_CHECKS;
-	else if(!strcasecmp(command_id, "DISABLE_HOSTGROUP_PASSIVE_HOST_CHECKS"))
-		command_type = CMD_DISABLE_HOSTGROUP_PASSIVE_HOST_CHECKS;
-
-	else if(!strcasecmp(command_id, "ENABLE_HOSTGROUP_SVC_CHECKS"))
-		command_type = CMD_ENABLE_HOSTGROUP_SVC_CHECKS;
-	else if(!strcasecmp(command_id, "DISABLE_HOSTGROUP_SVC_CHECKS"))
-		command_type = CMD_DISABLE_HOSTGROUP_SVC_CHECKS;
-
-	else if(!strcasecmp(command_id, "ENABLE_HOSTGROUP_PASSIVE_SVC_CHECKS"))
-		command_type = CMD_ENABLE_HOSTGROUP_PASSIVE_SVC_CHECKS;
-	else if(!strcasecmp(command_id, "DISABLE_HOSTGROUP_PASSIVE_SVC_CHECKS"))
-		command_type = CMD_DISABLE_HOSTGROUP_PASSIVE_SVC_CHECKS;
-
-	else if(!strcasecmp(command_id, "SCHEDULE_HOSTGROUP_HOST_DOWNTIME"))
-		command_type = CMD_SCHEDULE_HOSTGROUP_HOST_DOWNTIME;
-	else if(!strcasecmp(command_id, "SCHEDULE_HOSTGROUP_SVC_DOWNTIME"))
-		command_type = CMD_SCHEDULE_HOSTGROUP_SVC_DOWNTIME;
-
-
-	/**********************************/
-	/**** SERVICE-RELATED COMMANDS ****/
-	/**********************************/
-
-	else if(!strcasecmp(command_id, "ADD_SVC_COMMENT"))
-		command_type = CMD_ADD_SVC_COMMENT;
-	else if(!strcasecmp(command_id, "DEL_SVC_COMMENT"))
-		command_type = CMD_DEL_SVC_COMMENT;
-	else if(!strcasecmp(command_id, "DEL_ALL_SVC_COMMENTS"))
-		command_type = CMD_DEL_ALL_SVC_COMMENTS;
-
-	else if(!strcasecmp(command_id, "SCHEDULE_SVC_CHECK"))
-		command_type = CMD_SCHEDULE_SVC_CHECK;
-	else if(!strcasecmp(command_id, "SCHEDULE_FORCED_SVC_CHECK"))
-		command_type = CMD_SCHEDULE_FORCED_SVC_CHECK;
-
-	else if(!strcasecmp(command_id, "ENABLE_SVC_CHECK"))
-		command_type = CMD_ENABLE_SVC_CHECK;
-	else if(!strcasecmp(command_id, "DISABLE_SVC_CHECK"))
-		command_type = CMD_DISABLE_SVC_CHECK;
-
-	else if(!strcasecmp(command_id, "ENABLE_PASSIVE_SVC_CHECKS"))
-		command_type = CMD_ENABLE_PASSIVE_SVC_CHECKS;
-	else if(!strcasecmp(command_id, "DISABLE_PASSIVE_SVC_CHECKS"))
-		command_type = CMD_DISABLE_PASSIVE_SVC_CHECKS;
-
-	else if(!strcasecmp(command_id, "DELAY_SVC_NOTIFICATION"))
-		command_type = CMD_DELAY_SVC_NOTIFICATION;
-	else if(!strcasecmp(command_id, "ENABLE_SVC_NOTIFICATIONS"))
-		command_type = CMD_ENABLE_SVC_NOTIFICATIONS;
-	else if(!strcasecmp(command_id, "DISABLE_SVC_NOTIFICATIONS"))
-		command_type = CMD_DISABLE_SVC_NOTIFICATIONS;
-
-	else if(!strcasecmp(command_id, "PROCESS_SERVICE_CHECK_RESULT"))
-		command_type = CMD_PROCESS_SERVICE_CHECK_RESULT;
-	else if(!strcasecmp(command_id, "PROCESS_HOST_CHECK_RESULT"))
-		command_type = CMD_PROCESS_HOST_CHECK_RESULT;
-
-	else if(!strcasecmp(command_id, "ENABLE_SVC_EVENT_HANDLER"))
-		command_type = CMD_ENABLE_SVC_EVENT_HANDLER;
-	else if(!strcasecmp(command_id, "DISABLE_SVC_EVENT_HANDLER"))
-		command_type = CMD_DISABLE_SVC_EVENT_HANDLER;
-
-	else if(!strcasecmp(command_id, "ENABLE_SVC_FLAP_DETECTION"))
-		command_type = CMD_ENABLE_SVC_FLAP_DETECTION;
-	else if(!strcasecmp(command_id, "DISABLE_SVC_FLAP_DETECTION"))
-		command_type = CMD_DISABLE_SVC_FLAP_DETECTION;
-
-	else if(!strcasecmp(command_id, "SCHEDULE_SVC_DOWNTIME"))
-		command_type = CMD_SCHEDULE_SVC_DOWNTIME;
-	else if(!strcasecmp(command_id, "DEL_SVC_DOWNTIME"))
-		command_type = CMD_DEL_SVC_DOWNTIME;
-
-	else if(!strcasecmp(command_id, "ACKNOWLEDGE_SVC_PROBLEM"))
-		command_type = CMD_ACKNOWLEDGE_SVC_PROBLEM;
-	else if(!strcasecmp(command_id, "REMOVE_SVC_ACKNOWLEDGEMENT"))
-		command_type = CMD_REMOVE_SVC_ACKNOWLEDGEMENT;
-
-	else if(!strcasecmp(command_id, "START_OBSESSING_OVER_SVC"))
-		command_type = CMD_START_OBSESSING_OVER_SVC;
-	else if(!strcasecmp(command_id, "STOP_OBSESSING_OVER_SVC"))
-		command_type = CMD_STOP_OBSESSING_OVER_SVC;
-
-	else if(!strcasecmp(command_id, "CHANGE_SVC_EVENT_HANDLER"))
-		command_type = CMD_CHANGE_SVC_EVENT_HANDLER;
-
-	else if(!strcasecmp(command_id, "CHANGE_SVC_EVENT_HANDLER_TIMEPERIOD"))
-		command_type = CMD_CHANGE_SVC_EVENT_HANDLER_TIMEPERIOD;
-
-	else if(!strcasecmp(command_id, "CHANGE_SVC_CHECK_COMMAND"))
-		command_type = CMD_CHANGE_SVC_CHECK_COMMAND;
-
-	else if(!strcasecmp(command_id, "CHANGE_NORMAL_SVC_CHECK_INTERVAL"))
-		command_type = CMD_CHANGE_NORMAL_SVC_CHECK_INTERVAL;
-	else if(!strcasecmp(command_id, "CHANGE_RETRY_SVC_CHECK_INTERVAL"))
-		command_type = CMD_CHANGE_RETRY_SVC_CHECK_INTERVAL;
-
-	else if(!strcasecmp(command_id, "CHANGE_MAX_SVC_CHECK_ATTEMPTS"))
-		command_type = CMD_CHANGE_MAX_SVC_CHECK_ATTEMPTS;
-
-	else if(!strcasecmp(command_id, "SET_SVC_NOTIFICATION_NUMBER"))
-		command_type = CMD_SET_SVC_NOTIFICATION_NUMBER;
-
-	else if(!strcasecmp(command_id, "CHANGE_SVC_CHECK_TIMEPERIOD"))
-		command_type = CMD_CHANGE_SVC_CHECK_TIMEPERIOD;
-
-	else if(!strcasecmp(command_id, "CHANGE_CUSTOM_SVC_VAR"))
-		command_type = CMD_CHANGE_CUSTOM_SVC_VAR;
-
-	else if(!strcasecmp(command_id, "CHANGE_CUSTOM_CONTACT_VAR"))
-		command_type = CMD_CHANGE_CUSTOM_CONTACT_VAR;
-
-	else if(!strcasecmp(command_id, "SEND_CUSTOM_SVC_NOTIFICATION"))
-		command_type = CMD_SEND_CUSTOM_SVC_NOTIFICATION;
-
-	else if(!strcasecmp(command_id, "CHANGE_SVC_NOTIFICATION_TIMEPERIOD"))
-		command_type = CMD_CHANGE_SVC_NOTIFICATION_TIMEPERIOD;
-
-	else if(!strcasecmp(command_id, "CHANGE_SVC_MODATTR"))
-		command_type = CMD_CHANGE_SVC_MODATTR;
-
-	else if (!strcasecmp(command_id,"CLEAR_SVC_FLAPPING_STATE"))
-		command_type = CMD_CLEAR_SVC_FLAPPING_STATE;
-
-	/***************************************/
-	/**** SERVICEGROUP-RELATED COMMANDS ****/
-	/***************************************/
-
-	else if(!strcasecmp(command_id, "ENABLE_SERVICEGROUP_HOST_NOTIFICATIONS"))
-		command_type = CMD_ENABLE_SERVICEGROUP_HOST_NOTIFICATIONS;
-	else if(!strcasecmp(command_id, "DISABLE_SERVICEGROUP_HOST_NOTIFICATIONS"))
-		command_type = CMD_DISABLE_SERVICEGROUP_HOST_NOTIFICATIONS;
-
-	else if(!strcasecmp(command_id, "ENABLE_SERVICEGROUP_SVC_NOTIFICATIONS"))
-		command_type = CMD_ENABLE_SERVICEGROUP_SVC_NOTIFICATIONS;
-	else if(!strcasecmp(command_id, "DISABLE_SERVICEGROUP_SVC_NOTIFICATIONS"))
-		command_type = CMD_DISABLE_SERVICEGROUP_SVC_NOTIFICATIONS;
-
-	else if(!strcasecmp(command_id, "ENABLE_SERVICEGROUP_HOST_CHECKS"))
-		command_type = CMD_ENABLE_SERVICEGROUP_HOST_CHECKS;
-	else if(!strcasecmp(command_id, "DISABLE_SERVICEGROUP_HOST_CHECKS"))
-		command_type = CMD_DISABLE_SERVICEGROUP_HOST_CHECKS;
-
-	else if(!strcasecmp(command_id, "ENABLE_SERVICEGROUP_PASSIVE_HOST_CHECKS"))
-		command_type = CMD_ENABLE_SERVICEGROUP_PASSIVE_HOST_CHECKS;
-	else if(!strcasecmp(command_id, "DISABLE_SERVICEGROUP_PASSIVE_HOST_CHECKS"))
-		command_type = CMD_DISABLE_SERVICEGROUP_PASSIVE_HOST_CHECKS;
-
-	else if(!strcasecmp(command_id, "ENABLE_SERVICEGROUP_SVC_CHECKS"))
-		command_type = CMD_ENABLE_SERVICEGROUP_SVC_CHECKS;
-	else if(!strcasecmp(command_id, "DISABLE_SERVICEGROUP_SVC_CHECKS"))
-		command_type = CMD_DISABLE_SERVICEGROUP_SVC_CHECKS;
-
-	else if(!strcasecmp(command_id, "ENABLE_SERVICEGROUP_PASSIVE_SVC_CHECKS"))
-		command_type = CMD_ENABLE_SERVICEGROUP_PASSIVE_SVC_CHECKS;
-	else if(!strcasecmp(command_id, "DISABLE_SERVICEGROUP_PASSIVE_SVC_CHECKS"))
-		command_type = CMD_DISABLE_SERVICEGROUP_PASSIVE_SVC_CHECKS;
-
-	else if(!strcasecmp(command_id, "SCHEDULE_SERVICEGROUP_HOST_DOWNTIME"))
-		command_type = CMD_SCHEDULE_SERVICEGROUP_HOST_DOWNTIME;
-	else if(!strcasecmp(command_id, "SCHEDULE_SERVICEGROUP_SVC_DOWNTIME"))
-		command_type = CMD_SCHEDULE_SERVICEGROUP_SVC_DOWNTIME;
-
-
-	/**********************************/
-	/**** CONTACT-RELATED COMMANDS ****/
-	/**********************************/
-
-	else if(!strcasecmp(command_id, "ENABLE_CONTACT_HOST_NOTIFICATIONS"))
-		command_type = CMD_ENABLE_CONTACT_HOST_NOTIFICATIONS;
-	else if(!strcasecmp(command_id, "DISABLE_CONTACT_HOST_NOTIFICATIONS"))
-		command_type = CMD_DISABLE_CONTACT_HOST_NOTIFICATIONS;
-
-	else if(!strcasecmp(command_id, "ENABLE_CONTACT_SVC_NOTIFICATIONS"))
-		command_type = CMD_ENABLE_CONTACT_SVC_NOTIFICATIONS;
-	else if(!strcasecmp(command_id, "DISABLE_CONTACT_SVC_NOTIFICATIONS"))
-		command_type = CMD_DISABLE_CONTACT_SVC_NOTIFICATIONS;
-
-	else if(!strcasecmp(command_id, "CHANGE_CONTACT_HOST_NOTIFICATION_TIMEPERIOD"))
-		command_type = CMD_CHANGE_CONTACT_HOST_NOTIFICATION_TIMEPERIOD;
-
-	else if(!strcasecmp(command_id, "CHANGE_CONTACT_SVC_NOTIFICATION_TIMEPERIOD"))
-		command_type = CMD_CHANGE_CONTACT_SVC_NOTIFICATION_TIMEPERIOD;
-
-	else if(!strcasecmp(command_id, "CHANGE_CONTACT_MODATTR"))
-		command_type = CMD_CHANGE_CONTACT_MODATTR;
-	else if(!strcasecmp(command_id, "CHANGE_CONTACT_MODHATTR"))
-		command_type = CMD_CHANGE_CONTACT_MODHATTR;
-	else if(!strcasecmp(command_id, "CHANGE_CONTACT_MODSATTR"))
-		command_type = CMD_CHANGE_CONTACT_MODSATTR;
-
-	/***************************************/
-	/**** CONTACTGROUP-RELATED COMMANDS ****/
-	/***************************************/
-
-	else if(!strcasecmp(command_id, "ENABLE_CONTACTGROUP_HOST_NOTIFICATIONS"))
-		command_type = CMD_ENABLE_CONTACTGROUP_HOST_NOTIFICATIONS;
-	else if(!strcasecmp(command_id, "DISABLE_CONTACTGROUP_HOST_NOTIFICATIONS"))
-		command_type = CMD_DISABLE_CONTACTGROUP_HOST_NOTIFICATIONS;
-
-	else if(!strcasecmp(command_id, "ENABLE_CONTACTGROUP_SVC_NOTIFICATIONS"))
-		command_type = CMD_ENABLE_CONTACTGROUP_SVC_NOTIFICATIONS;
-	else if(!strcasecmp(command_id, "DISABLE_CONTACTGROUP_SVC_NOTIFICATIONS"))
-		command_type = CMD_DISABLE_CONTACTGROUP_SVC_NOTIFICATIONS;
-
-
-	/**************************/
-	/****** MISC COMMANDS *****/
-	/**************************/
-
-	else if(!strcasecmp(command_id, "PROCESS_FILE"))
-		command_type = CMD_PROCESS_FILE;
-
-
-
-	/****************************/
-	/****** CUSTOM COMMANDS *****/
-	/****************************/
-
+	/**** CUSTOM COMMANDS ****/
 	else if(command_id[0] == '_')
 		command_type = CMD_CUSTOM_COMMAND;
 
-
-
 	/**** UNKNOWN COMMAND ****/
 	else {
 		/* log the bad external command */
 		logit(NSLOG_EXTERNAL_COMMAND | NSLOG_RUNTIME_WARNING, TRUE, "Warning: Unrecognized external command -> %s;%s\n", command_id, args);
 
-		/* free memory */
-		my_free(command_id);
-		my_free(args);
+		/* restore the command */
+		if(semicolon)
+			*semicolon = ';';
+		if(newline)
+			*newline = '\n';
 
 		return CMD_ERROR_UNKNOWN_COMMAND;
 		}
 
 	/* update statistics for external commands */
-	update_check_stats(EXTERNAL_COMMAND_STATS, time(NULL));
+	update_check_stats(EXTERNAL_COMMAND_STATS, cmd_batch.active ? cmd_batch.now.tv_sec : time(NULL));
 
 	/* log the external command */
 	asprintf(&temp_buffer, "EXTERNAL COMMAND: %s;%s\n", command_id, args);
@@ -938,9 +603,11 @@ int process_external_command1(char *cmd) {
 	broker_external_command(NEBTYPE_EXTERNALCOMMAND_END, NEBFLAG_NONE, NEBATTR_NONE, command_type, entry_time, command_id, args, NULL);
 #endif
 
-	/* free memory */
-	my_free(command_id);
-	my_free(args);
+	/* restore the command */
+	if(semicolon)
+		*semicolon = ';';
+	if(newline)
+		*newline = '\n';
 
 	return external_command_ret;
 	}
@@ -2160,10 +1827,14 @@ int cmd_delay_notification(int cmd, char *args) {
 	delay_time = strtoul(temp_ptr, NULL, 10);
 
 	/* delay the next notification... */
-	if(cmd == CMD_DELAY_SVC_NOTIFICATION)
+	if(cmd == CMD_DELAY_SVC_NOTIFICATION) {
 		temp_service->next_notification = delay_time;
-	else
+		update_service_status(temp_service, FALSE);
+		}
+	else {
 		temp_host->next_notification = delay_time;
+		update_host_status(temp_host, FALSE);
+		}
 
 	if ((author = my_strtok(NULL, ";")) != NULL) {
 		if ((comment = my_strtok(NULL, ";")) != NULL) {
@@ -2317,35 +1988,31 @@ int cmd_signal_process(int cmd, char *args) {
 
 /* processes results of an external service check */
 int cmd_process_service_check_result(int cmd, time_t check_time, char *args) {
+	struct cmd_args ca;
 	char *temp_ptr = NULL;
 	char *host_name = NULL;
 	char *svc_description = NULL;
 	int return_code = 0;
 	char *output = NULL;
-	int result = 0;
+	int result = ERROR;
+
+	cmd_args_init(&ca, args);
 
 	/* get the host name */
-	if((temp_ptr = my_strtok(args, ";")) == NULL)
-		return ERROR;
-	host_name = (char *)strdup(temp_ptr);
+	if((host_name = cmd_args_next(&ca, ';')) == NULL)
+		goto out;
 
 	/* get the service description */
-	if((temp_ptr = my_strtok(NULL, ";")) == NULL) {
-		my_free(host_name);
-		return ERROR;
-		}
-	svc_description = (char *)strdup(temp_ptr);
+	if((svc_description = cmd_args_next(&ca, ';')) == NULL)
+		goto out;
 
 	/* get the service check return code */
-	if((temp_ptr = my_strtok(NULL, ";")) == NULL) {
-		my_free(host_name);
-		my_free(svc_description);
-		return ERROR;
-		}
+	if((temp_ptr = cmd_args_next(&ca, ';')) == NULL)
+		goto out;
 	return_code = atoi(temp_ptr);
 
 	/* get the plugin output (may be empty) */
-	temp_ptr = my_strtok(NULL, "\n");
+	temp_ptr = cmd_args_next(&ca, '\n');
 	/* Interpolate backslash and newline escape sequences to the literal
 	 * characters they represent. This converts to the format we use internally
 	 * so we don't have to worry about different representations later. */
@@ -2355,10 +2022,11 @@ int cmd_process_service_check_result(int cmd, time_t check_time, char *args) {
 	result = process_passive_service_check(check_time, host_name, svc_description, return_code, output);
 
 	/* free memory */
-	my_free(host_name);
-	my_free(svc_description);
 	my_free(output);
 
+out:
+	cmd_args_restore(&ca);
+
 	return result;
 	}
 
@@ -2428,7 +2096,7 @@ int process_passive_service_check(time_t check_time, char *host_name, char *svc_
 		cr.return_code = STATE_UNKNOWN;
 
 	/* calculate latency */
-	gettimeofday(&tv, NULL);
+	get_command_time(&tv);
 	cr.latency = (double)((double)(tv.tv_sec - check_time) + (double)(tv.tv_usec / 1000.0) / 1000.0);
 	if(cr.latency < 0.0)
 		cr.latency = 0.0;
@@ -2440,26 +2108,26 @@ int process_passive_service_check(time_t check_time, char *host_name, char *svc_
 
 /* process passive host check result */
 int cmd_process_host_check_result(int cmd, time_t check_time, char *args) {
+	struct cmd_args ca;
 	char *temp_ptr = NULL;
 	char *host_name = NULL;
 	int return_code = 0;
 	char *output = NULL;
-	int result = 0;
+	int result = ERROR;
+
+	cmd_args_init(&ca, args);
 
 	/* get the host name */
-	if((temp_ptr = my_strtok(args, ";")) == NULL)
-		return ERROR;
-	host_name = (char *)strdup(temp_ptr);
+	if((host_name = cmd_args_next(&ca, ';')) == NULL)
+		goto out;
 
 	/* get the host check return code */
-	if((temp_ptr = my_strtok(NULL, ";")) == NULL) {
-		my_free(host_name);
-		return ERROR;
-		}
+	if((temp_ptr = cmd_args_next(&ca, ';')) == NULL)
+		goto out;
 	return_code = atoi(temp_ptr);
 
 	/* get the plugin output (may be empty) */
-	temp_ptr = my_strtok(NULL, "\n");
+	temp_ptr = cmd_args_next(&ca, '\n');
 	/* Interpolate backslash and newline escape sequences to the literal
 	 * characters they represent. This converts to the format we use internally
 	 * so we don't have to worry about different representations later. */
@@ -2469,9 +2137,11 @@ int cmd_process_host_check_result(int cmd, time_t check_time, char *args) {
 	result = process_passive_host_check(check_time, host_name, return_code, output);
 
 	/* free memory */
-	my_free(host_name);
 	my_free(output);
 
+out:
+	cmd_args_restore(&ca);
+
 	return result;
 	}
 
@@ -2520,7 +2190,7 @@ int process_passive_host_check(time_t check_time, char *host_name, int return_co
 	cr.return_code = return_code;
 
 	/* calculate latency */
-	gettimeofday(&tv, NULL);
+	get_command_time(&tv);
 	cr.latency = (double)((double)(tv.tv_sec - check_time) + (double)(tv.tv_usec / 1000.0) / 1000.0);
 	if(cr.latency < 0.0)
 		cr.latency = 0.0;
@@ -3513,6 +3183,7 @@ int cmd_change_object_char_var(int cmd, char *args) {
 
 		case CMD_CHANGE_HOST_CHECK_COMMAND:
 
+			invalidate_host_check_template(temp_host);
 			my_free(temp_host->check_command);
 			temp_host->check_command = temp_ptr;
 			temp_host->check_command_ptr = temp_command;
@@ -3553,6 +3224,7 @@ int cmd_change_object_char_var(int cmd, char *args) {
 
 		case CMD_CHANGE_SVC_CHECK_COMMAND:
 
+			invalidate_service_check_template(temp_service);
 			my_free(temp_service->check_command);
 			temp_service->check_command = temp_ptr;
 			temp_service->check_command_ptr = temp_command;
@@ -3730,7 +3402,6 @@ int cmd_change_object_custom_var(int cmd, char *args) {
 				my_free(name2);
 				return ERROR;
 				}
-			temp_customvariablesmember = temp_host->custom_variables;
 			break;
 		case CMD_CHANGE_CUSTOM_SVC_VAR:
 			if((temp_service = find_service(name1, name2)) == NULL) {
@@ -3738,7 +3409,6 @@ int cmd_change_object_custom_var(int cmd, char *args) {
 				my_free(name2);
 				return ERROR;
 				}
-			temp_customvariablesmember = temp_service->custom_variables;
 			break;
 		case CMD_CHANGE_CUSTOM_CONTACT_VAR:
 			if((temp_contact = find_contact(name1)) == NULL) {
@@ -3746,7 +3416,6 @@ int cmd_change_object_custom_var(int cmd, char *args) {
 				my_free(name2);
 				return ERROR;
 				}
-			temp_customvariablesmember = temp_contact->custom_variables;
 			break;
 		default:
 			break;
@@ -3783,21 +3452,30 @@ int cmd_change_object_custom_var(int cmd, char *args) {
 		varname[x] = toupper(varname[x]);
 
 	/* find the proper variable */
-	for(; temp_customvariablesmember != NULL; temp_customvariablesmember = temp_customvariablesmember->next) {
-
-		/* we found the variable, so update the value */
-		if(!strcmp(varname, temp_customvariablesmember->variable_name)) {
+	switch(cmd) {
+		case CMD_CHANGE_CUSTOM_HOST_VAR:
+			temp_customvariablesmember = find_host_custom_variable(temp_host, varname);
+			break;
+		case CMD_CHANGE_CUSTOM_SVC_VAR:
+			temp_customvariablesmember = find_service_custom_variable(temp_service, varname);
+			break;
+		case CMD_CHANGE_CUSTOM_CONTACT_VAR:
+			temp_customvariablesmember = find_contact_custom_variable(temp_contact, varname);
+			break;
+		default:
+			break;
+		}
 
-			/* update the value */
-			if(temp_customvariablesmember->variable_value)
-				my_free(temp_customvariablesmember->variable_value);
-			temp_customvariablesmember->variable_value = (char *)strdup(varvalue);
+	/* we found the variable, so update the value */
+	if(temp_customvariablesmember != NULL) {
 
-			/* mark the variable value as having been changed */
-			temp_customvariablesmember->has_been_modified = TRUE;
+		/* update the value */
+		if(temp_customvariablesmember->variable_value)
+			my_free(temp_customvariablesmember->variable_value);
+		temp_customvariablesmember->variable_value = (char *)strdup(varvalue);
 
-			break;
-			}
+		/* mark the variable value as having been changed */
+		temp_customvariablesmember->has_been_modified = TRUE;
 		}
 
 	/* free memory */
@@ -5413,6 +5091,8 @@ void clear_host_flapping_state(host *hst) {
 
 	/* clear the recovery notification flag */
 	hst->check_flapping_recovery_notification = FALSE;
+
+	update_host_status(hst, FALSE);
 }
 
 /* clears the flapping state for a specific service */
@@ -5470,4 +5150,6 @@ void clear_service_flapping_state(service *svc) {
 
 	/* clear the recovery notification flag */
 	svc->check_flapping_recovery_notification = FALSE;
+
+	update_service_status(svc, FALSE);
 }
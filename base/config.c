@@ -25,9 +25,11 @@
 #include "../include/objects.h"
 #include "../include/macros.h"
 #include "../include/nagios.h"
+#include "../include/sretention.h"
 #include "../include/broker.h"
 #include "../include/nebmods.h"
 #include "../include/nebmodules.h"
+#include "mainconf-phash.h"
 
 
 /*** helpers ****/
@@ -92,6 +94,8 @@ int read_main_config_file(char *main_config_file) {
 	char *value = NULL;
 	char *error_message = NULL;
 	char *temp_ptr = NULL;
+	struct mainconf_key *key;
+	int directive;
 	mmapfile *thefile = NULL;
 	int current_line = 0;
 	int error = FALSE;
@@ -161,10 +165,12 @@ int read_main_config_file(char *main_config_file) {
 		temp_ptr = my_strtok_with_free(NULL, "\n", TRUE);
 		strip(variable);
 		strip(value);
+		key = mainconf_get_key(variable, strlen(variable));
+		directive = key ? key->code : -1;
 
 		/* process the variable/value */
 
-		if(!strcmp(variable, "resource_file")) {
+		if(directive == MAINCONF_resource_file) {
 
 			/* save the macro */
 			my_free(mac->x[MACRO_RESOURCEFILE]);
@@ -176,7 +182,7 @@ int read_main_config_file(char *main_config_file) {
 				}
 			}
 
-		else if(!strcmp(variable, "website_url")) {
+		else if(directive == MAINCONF_website_url) {
 			int lth;
 			my_free(website_url);
 			website_url = strdup(value);
@@ -185,15 +191,100 @@ int read_main_config_file(char *main_config_file) {
 				website_url[lth-1] = '\0';
 			}
 
-		else if(!strcmp(variable, "loadctl_options"))
+		else if(directive == MAINCONF_loadctl_options)
 			error = set_loadctl_options(value, strlen(value)) != OK;
-		else if(!strcmp(variable, "check_workers"))
+		else if(directive == MAINCONF_check_workers)
 			num_check_workers = atoi(value);
-		else if(!strcmp(variable, "query_socket")) {
+		else if(directive == MAINCONF_event_queue_type) {
+			if(!strcmp(value, "heap"))
+				event_queue_type = SQUEUE_TYPE_HEAP;
+			else if(!strcmp(value, "wheel"))
+				event_queue_type = SQUEUE_TYPE_WHEEL;
+			else {
+				asprintf(&error_message, "Illegal value for event_queue_type");
+				error = TRUE;
+				break;
+				}
+			}
+		else if(directive == MAINCONF_event_batch_size) {
+			event_batch_size = atoi(value);
+			if(event_batch_size < 1) {
+				asprintf(&error_message, "Illegal value for event_batch_size");
+				error = TRUE;
+				break;
+				}
+			}
+		else if(directive == MAINCONF_object_config_threads) {
+			object_config_threads = atoi(value);
+			if(object_config_threads < 0) {
+				asprintf(&error_message, "Illegal value for object_config_threads");
+				error = TRUE;
+				break;
+				}
+			}
+		else if(directive == MAINCONF_check_result_threads) {
+			check_result_threads = atoi(value);
+			if(check_result_threads < 0) {
+				asprintf(&error_message, "Illegal value for check_result_threads");
+				error = TRUE;
+				break;
+				}
+			}
+		else if(directive == MAINCONF_worker_use_posix_spawn)
+			worker_use_posix_spawn = (atoi(value) > 0) ? TRUE : FALSE;
+		else if(directive == MAINCONF_worker_shm_ring_size) {
+			worker_shm_ring_size = strtoul(value, NULL, 0);
+			if(worker_shm_ring_size > (1UL << 30)) {
+				asprintf(&error_message, "Illegal value for worker_shm_ring_size");
+				error = TRUE;
+				break;
+				}
+			}
+		else if(directive == MAINCONF_use_log_thread)
+			use_log_thread = (atoi(value) > 0) ? TRUE : FALSE;
+		else if(directive == MAINCONF_log_thread_buffer_size) {
+			log_thread_buffer_size = strtoul(value, NULL, 0);
+			if(log_thread_buffer_size < 65536 || log_thread_buffer_size > (1UL << 30)) {
+				asprintf(&error_message, "Illegal value for log_thread_buffer_size");
+				error = TRUE;
+				break;
+				}
+			}
+		else if(directive == MAINCONF_log_overflow_policy) {
+			if(!strcmp(value, "block"))
+				log_overflow_policy = LOG_OVERFLOW_BLOCK;
+			else if(!strcmp(value, "drop"))
+				log_overflow_policy = LOG_OVERFLOW_DROP;
+			else {
+				asprintf(&error_message, "Illegal value for log_overflow_policy");
+				error = TRUE;
+				break;
+				}
+			}
+		else if(directive == MAINCONF_log_fsync_policy) {
+			if(!strcmp(value, "never"))
+				log_fsync_interval = LOG_FSYNC_NEVER;
+			else if(!strcmp(value, "batch"))
+				log_fsync_interval = LOG_FSYNC_BATCH;
+			else if((log_fsync_interval = atoi(value)) <= 0) {
+				asprintf(&error_message, "Illegal value for log_fsync_policy");
+				error = TRUE;
+				break;
+				}
+			}
+		else if(directive == MAINCONF_trace_buffer_size) {
+			trace_buffer_size = strtoul(value, NULL, 0);
+			if(trace_buffer_size > (1U << 24)) {
+				asprintf(&error_message, "Illegal value for trace_buffer_size");
+				error = TRUE;
+				break;
+				}
+			}
+		else if(directive == MAINCONF_query_socket) {
 			my_free(qh_socket_path);
 			qh_socket_path = nspath_absolute(value, config_file_dir);
 		}
-		else if(!strcmp(variable, "log_file")) {
+		else if(directive == MAINCONF_log_file) {
 
 			if(strlen(value) > MAX_FILENAME_LENGTH - 1) {
 				asprintf(&error_message, "Log file is too long");
@@ -206,13 +297,13 @@ int read_main_config_file(char *main_config_file) {
 			/* make sure the configured logfile takes effect */
 			close_log_file();
 			}
-		else if(!strcmp(variable, "debug_level"))
+		else if(directive == MAINCONF_debug_level)
 			debug_level = atoi(value);
 
-		else if(!strcmp(variable, "debug_verbosity"))
+		else if(directive == MAINCONF_debug_verbosity)
 			debug_verbosity = atoi(value);
 
-		else if(!strcmp(variable, "debug_file")) {
+		else if(directive == MAINCONF_debug_file) {
 
 			if(strlen(value) > MAX_FILENAME_LENGTH - 1) {
 				asprintf(&error_message, "Debug log file is too long");
@@ -224,10 +315,10 @@ int read_main_config_file(char *main_config_file) {
 			debug_file = nspath_absolute(value, config_file_dir);
 			}
 
-		else if(!strcmp(variable, "max_debug_file_size"))
+		else if(directive == MAINCONF_max_debug_file_size)
 			max_debug_file_size = strtoul(value, NULL, 0);
 
-		else if(!strcmp(variable, "command_file")) {
+		else if(directive == MAINCONF_command_file) {
 
 			if(strlen(value) > MAX_FILENAME_LENGTH - 1) {
 				asprintf(&error_message, "Command file is too long");
@@ -242,17 +333,17 @@ int read_main_config_file(char *main_config_file) {
 			mac->x[MACRO_COMMANDFILE] = command_file;
 			}
 
-		else if(!strcmp(variable, "temp_file")) {
+		else if(directive == MAINCONF_temp_file) {
 			my_free(temp_file);
 			temp_file = strdup(value);
 			}
 
-		else if(!strcmp(variable, "temp_path")) {
+		else if(directive == MAINCONF_temp_path) {
 			my_free(temp_path);
 			temp_path = nspath_absolute(value, config_file_dir);
 			}
 
-		else if(!strcmp(variable, "check_result_path")) {
+		else if(directive == MAINCONF_check_result_path) {
 
 			if(strlen(value) > MAX_FILENAME_LENGTH - 1) {
 				asprintf(&error_message, "Check result path is too long");
@@ -275,10 +366,10 @@ int read_main_config_file(char *main_config_file) {
 
 			}
 
-		else if(!strcmp(variable, "max_check_result_file_age"))
+		else if(directive == MAINCONF_max_check_result_file_age)
 			max_check_result_file_age = strtoul(value, NULL, 0);
 
-		else if(!strcmp(variable, "lock_file")) {
+		else if(directive == MAINCONF_lock_file) {
 
 			if(strlen(value) > MAX_FILENAME_LENGTH - 1) {
 				asprintf(&error_message, "Lock file is too long");
@@ -290,51 +381,51 @@ int read_main_config_file(char *main_config_file) {
 			lock_file = nspath_absolute(value, config_file_dir);
 			}
 
-		else if(!strcmp(variable, "global_host_event_handler")) {
+		else if(directive == MAINCONF_global_host_event_handler) {
 			my_free(global_host_event_handler);
 			global_host_event_handler = (char *)strdup(value);
 			}
 
-		else if(!strcmp(variable, "global_service_event_handler")) {
+		else if(directive == MAINCONF_global_service_event_handler) {
 			my_free(global_service_event_handler);
 			global_service_event_handler = (char *)strdup(value);
 			}
 
-		else if(!strcmp(variable, "ocsp_command")) {
+		else if(directive == MAINCONF_ocsp_command) {
 			my_free(ocsp_command);
 			ocsp_command = (char *)strdup(value);
 			}
 
-		else if(!strcmp(variable, "ochp_command")) {
+		else if(directive == MAINCONF_ochp_command) {
 			my_free(ochp_command);
 			ochp_command = (char *)strdup(value);
 			}
 
-		else if(!strcmp(variable, "nagios_user")) {
+		else if(directive == MAINCONF_nagios_user) {
 			my_free(nagios_user);
 			nagios_user = (char *)strdup(value);
 			}
 
-		else if(!strcmp(variable, "nagios_group")) {
+		else if(directive == MAINCONF_nagios_group) {
 			my_free(nagios_group);
 			nagios_group = (char *)strdup(value);
 			}
 
-		else if(!strcmp(variable, "admin_email")) {
+		else if(directive == MAINCONF_admin_email) {
 
 			/* save the macro */
 			my_free(mac->x[MACRO_ADMINEMAIL]);
 			mac->x[MACRO_ADMINEMAIL] = (char *)strdup(value);
 			}
 
-		else if(!strcmp(variable, "admin_pager")) {
+		else if(directive == MAINCONF_admin_pager) {
 
 			/* save the macro */
 			my_free(mac->x[MACRO_ADMINPAGER]);
 			mac->x[MACRO_ADMINPAGER] = (char *)strdup(value);
 			}
 
-		else if(!strcmp(variable, "use_syslog")) {
+		else if(directive == MAINCONF_use_syslog) {
 
 			if(strlen(value) != 1 || value[0] < '0' || value[0] > '1') {
 				asprintf(&error_message, "Illegal value for use_syslog");
@@ -345,7 +436,7 @@ int read_main_config_file(char *main_config_file) {
 			use_syslog = (atoi(value) > 0) ? TRUE : FALSE;
 			}
 
-		else if(!strcmp(variable, "log_notifications")) {
+		else if(directive == MAINCONF_log_notifications) {
 
 			if(strlen(value) != 1 || value[0] < '0' || value[0] > '1') {
 				asprintf(&error_message, "Illegal value for log_notifications");
@@ -356,7 +447,7 @@ int read_main_config_file(char *main_config_file) {
 			log_notifications = (atoi(value) > 0) ? TRUE : FALSE;
 			}
 
-		else if(!strcmp(variable, "log_service_retries")) {
+		else if(directive == MAINCONF_log_service_retries) {
 
 			if(strlen(value) != 1 || value[0] < '0' || value[0] > '1') {
 				asprintf(&error_message, "Illegal value for log_service_retries");
@@ -367,7 +458,7 @@ int read_main_config_file(char *main_config_file) {
 			log_service_retries = (atoi(value) > 0) ? TRUE : FALSE;
 			}
 
-		else if(!strcmp(variable, "log_host_retries")) {
+		else if(directive == MAINCONF_log_host_retries) {
 
 			if(strlen(value) != 1 || value[0] < '0' || value[0] > '1') {
 				asprintf(&error_message, "Illegal value for log_host_retries");
@@ -378,7 +469,7 @@ int read_main_config_file(char *main_config_file) {
 			log_host_retries = (atoi(value) > 0) ? TRUE : FALSE;
 			}
 
-		else if(!strcmp(variable, "log_event_handlers")) {
+		else if(directive == MAINCONF_log_event_handlers) {
 
 			if(strlen(value) != 1 || value[0] < '0' || value[0] > '1') {
 				asprintf(&error_message, "Illegal value for log_event_handlers");
@@ -389,7 +480,7 @@ int read_main_config_file(char *main_config_file) {
 			log_event_handlers = (atoi(value) > 0) ? TRUE : FALSE;
 			}
 
-		else if(!strcmp(variable, "log_external_commands")) {
+		else if(directive == MAINCONF_log_external_commands) {
 
 			if(strlen(value) != 1 || value[0] < '0' || value[0] > '1') {
 				asprintf(&error_message, "Illegal value for log_external_commands");
@@ -400,7 +491,7 @@ int read_main_config_file(char *main_config_file) {
 			log_external_commands = (atoi(value) > 0) ? TRUE : FALSE;
 			}
 
-		else if(!strcmp(variable, "log_passive_checks")) {
+		else if(directive == MAINCONF_log_passive_checks) {
 
 			if(strlen(value) != 1 || value[0] < '0' || value[0] > '1') {
 				asprintf(&error_message, "Illegal value for log_passive_checks");
@@ -411,7 +502,7 @@ int read_main_config_file(char *main_config_file) {
 			log_passive_checks = (atoi(value) > 0) ? TRUE : FALSE;
 			}
 
-		else if(!strcmp(variable, "log_initial_states")) {
+		else if(directive == MAINCONF_log_initial_states) {
 
 			if(strlen(value) != 1 || value[0] < '0' || value[0] > '1') {
 				asprintf(&error_message, "Illegal value for log_initial_states");
@@ -422,7 +513,7 @@ int read_main_config_file(char *main_config_file) {
 			log_initial_states = (atoi(value) > 0) ? TRUE : FALSE;
 			}
 
-		else if(!strcmp(variable, "log_current_states")) {
+		else if(directive == MAINCONF_log_current_states) {
 
 			if(strlen(value) != 1 || value[0] < '0' || value[0] > '1') {
 				asprintf(&error_message, "Illegal value for log_current_states");
@@ -433,7 +524,7 @@ int read_main_config_file(char *main_config_file) {
 			log_current_states = (atoi(value) > 0) ? TRUE : FALSE;
 			}
 
-		else if(!strcmp(variable, "retain_state_information")) {
+		else if(directive == MAINCONF_retain_state_information) {
 
 			if(strlen(value) != 1 || value[0] < '0' || value[0] > '1') {
 				asprintf(&error_message, "Illegal value for retain_state_information");
@@ -444,7 +535,7 @@ int read_main_config_file(char *main_config_file) {
 			retain_state_information = (atoi(value) > 0) ? TRUE : FALSE;
 			}
 
-		else if(!strcmp(variable, "retention_update_interval")) {
+		else if(directive == MAINCONF_retention_update_interval) {
 
 			retention_update_interval = atoi(value);
 			if(retention_update_interval < 0) {
@@ -454,7 +545,43 @@ int read_main_config_file(char *main_config_file) {
 				}
 			}
 
-		else if(!strcmp(variable, "use_retained_program_state")) {
+		else if(directive == MAINCONF_retention_save_mode) {
+			if(!strcmp(value, "foreground"))
+				retention_save_mode = RETENTION_SAVE_FOREGROUND;
+			else if(!strcmp(value, "background"))
+				retention_save_mode = RETENTION_SAVE_BACKGROUND;
+			else {
+				asprintf(&error_message, "Illegal value for retention_save_mode");
+				error = TRUE;
+				break;
+				}
+			}
+
+		else if(directive == MAINCONF_retention_journal) {
+
+			if(strlen(value) != 1 || value[0] < '0' || value[0] > '1') {
+				asprintf(&error_message, "Illegal value for retention_journal");
+				error = TRUE;
+				break;
+				}
+
+			retention_journal = (atoi(value) > 0) ? TRUE : FALSE;
+			}
+
+		else if(directive == MAINCONF_retention_journal_sync_interval) {
+
+			retention_journal_sync_interval = atoi(value);
+			if(retention_journal_sync_interval < 0) {
+				asprintf(&error_message, "Illegal value for retention_journal_sync_interval");
+				error = TRUE;
+				break;
+				}
+			}
+
+		else if(directive == MAINCONF_retention_journal_max_size)
+			retention_journal_max_size = strtoul(value, NULL, 0);
+
+		else if(directive == MAINCONF_use_retained_program_state) {
 
 			if(strlen(value) != 1 || value[0] < '0' || value[0] > '1') {
 				asprintf(&error_message, "Illegal value for use_retained_program_state");
@@ -465,7 +592,7 @@ int read_main_config_file(char *main_config_file) {
 			use_retained_program_state = (atoi(value) > 0) ? TRUE : FALSE;
 			}
 
-		else if(!strcmp(variable, "use_retained_scheduling_info")) {
+		else if(directive == MAINCONF_use_retained_scheduling_info) {
 
 			if(strlen(value) != 1 || value[0] < '0' || value[0] > '1') {
 				asprintf(&error_message, "Illegal value for use_retained_scheduling_info");
@@ -476,7 +603,7 @@ int read_main_config_file(char *main_config_file) {
 			use_retained_scheduling_info = (atoi(value) > 0) ? TRUE : FALSE;
 			}
 
-		else if(!strcmp(variable, "retention_scheduling_horizon")) {
+		else if(directive == MAINCONF_retention_scheduling_horizon) {
 
 			retention_scheduling_horizon = atoi(value);
 
@@ -487,28 +614,28 @@ int read_main_config_file(char *main_config_file) {
 				}
 			}
 
-		else if(!strcmp(variable, "additional_freshness_latency"))
+		else if(directive == MAINCONF_additional_freshness_latency)
 			additional_freshness_latency = atoi(value);
 
-		else if(!strcmp(variable, "retained_host_attribute_mask"))
+		else if(directive == MAINCONF_retained_host_attribute_mask)
 			retained_host_attribute_mask = strtoul(value, NULL, 0);
 
-		else if(!strcmp(variable, "retained_service_attribute_mask"))
+		else if(directive == MAINCONF_retained_service_attribute_mask)
 			retained_service_attribute_mask = strtoul(value, NULL, 0);
 
-		else if(!strcmp(variable, "retained_process_host_attribute_mask"))
+		else if(directive == MAINCONF_retained_process_host_attribute_mask)
 			retained_process_host_attribute_mask = strtoul(value, NULL, 0);
 
-		else if(!strcmp(variable, "retained_process_service_attribute_mask"))
+		else if(directive == MAINCONF_retained_process_service_attribute_mask)
 			retained_process_service_attribute_mask = strtoul(value, NULL, 0);
 
-		else if(!strcmp(variable, "retained_contact_host_attribute_mask"))
+		else if(directive == MAINCONF_retained_contact_host_attribute_mask)
 			retained_contact_host_attribute_mask = strtoul(value, NULL, 0);
 
-		else if(!strcmp(variable, "retained_contact_service_attribute_mask"))
+		else if(directive == MAINCONF_retained_contact_service_attribute_mask)
 			retained_contact_service_attribute_mask = strtoul(value, NULL, 0);
 
-		else if(!strcmp(variable, "obsess_over_services")) {
+		else if(directive == MAINCONF_obsess_over_services) {
 
 			if(strlen(value) != 1 || value[0] < '0' || value[0] > '1') {
 				asprintf(&error_message, "Illegal value for obsess_over_services");
@@ -519,7 +646,7 @@ int read_main_config_file(char *main_config_file) {
 			obsess_over_services = (atoi(value) > 0) ? TRUE : FALSE;
 			}
 
-		else if(!strcmp(variable, "obsess_over_hosts")) {
+		else if(directive == MAINCONF_obsess_over_hosts) {
 
 			if(strlen(value) != 1 || value[0] < '0' || value[0] > '1') {
 				asprintf(&error_message, "Illegal value for obsess_over_hosts");
@@ -530,7 +657,7 @@ int read_main_config_file(char *main_config_file) {
 			obsess_over_hosts = (atoi(value) > 0) ? TRUE : FALSE;
 			}
 
-		else if(!strcmp(variable, "translate_passive_host_checks")) {
+		else if(directive == MAINCONF_translate_passive_host_checks) {
 
 			if(strlen(value) != 1 || value[0] < '0' || value[0] > '1') {
 				asprintf(&error_message, "Illegal value for translate_passive_host_checks");
@@ -541,10 +668,10 @@ int read_main_config_file(char *main_config_file) {
 			translate_passive_host_checks = (atoi(value) > 0) ? TRUE : FALSE;
 			}
 
-		else if(!strcmp(variable, "passive_host_checks_are_soft"))
+		else if(directive == MAINCONF_passive_host_checks_are_soft)
 			passive_host_checks_are_soft = (atoi(value) > 0) ? TRUE : FALSE;
 
-		else if(!strcmp(variable, "service_check_timeout")) {
+		else if(directive == MAINCONF_service_check_timeout) {
 
 			service_check_timeout = atoi(value);
 
@@ -556,7 +683,7 @@ int read_main_config_file(char *main_config_file) {
 			}
 
 
-		else if(!strcmp(variable,"service_check_timeout_state")){
+		else if(directive == MAINCONF_service_check_timeout_state){
 
 			if(!strcmp(value,"o"))
 				service_check_timeout_state=STATE_OK;
@@ -573,7 +700,7 @@ int read_main_config_file(char *main_config_file) {
 					}
 				}
 
-		else if(!strcmp(variable, "host_check_timeout")) {
+		else if(directive == MAINCONF_host_check_timeout) {
 
 			host_check_timeout = atoi(value);
 
@@ -584,7 +711,7 @@ int read_main_config_file(char *main_config_file) {
 				}
 			}
 
-		else if(!strcmp(variable, "event_handler_timeout")) {
+		else if(directive == MAINCONF_event_handler_timeout) {
 
 			event_handler_timeout = atoi(value);
 
@@ -595,7 +722,7 @@ int read_main_config_file(char *main_config_file) {
 				}
 			}
 
-		else if(!strcmp(variable, "notification_timeout")) {
+		else if(directive == MAINCONF_notification_timeout) {
 
 			notification_timeout = atoi(value);
 
@@ -606,7 +733,7 @@ int read_main_config_file(char *main_config_file) {
 				}
 			}
 
-		else if(!strcmp(variable, "ocsp_timeout")) {
+		else if(directive == MAINCONF_ocsp_timeout) {
 
 			ocsp_timeout = atoi(value);
 
@@ -617,7 +744,7 @@ int read_main_config_file(char *main_config_file) {
 				}
 			}
 
-		else if(!strcmp(variable, "ochp_timeout")) {
+		else if(directive == MAINCONF_ochp_timeout) {
 
 			ochp_timeout = atoi(value);
 
@@ -628,7 +755,7 @@ int read_main_config_file(char *main_config_file) {
 				}
 			}
 
-		else if(!strcmp(variable, "use_agressive_host_checking") || !strcmp(variable, "use_aggressive_host_checking")) {
+		else if(directive == MAINCONF_use_agressive_host_checking || directive == MAINCONF_use_aggressive_host_checking) {
 
 			if(strlen(value) != 1 || value[0] < '0' || value[0] > '1') {
 				asprintf(&error_message, "Illegal value for use_aggressive_host_checking");
@@ -639,19 +766,19 @@ int read_main_config_file(char *main_config_file) {
 			use_aggressive_host_checking = (atoi(value) > 0) ? TRUE : FALSE;
 			}
 
-		else if(!strcmp(variable, "cached_host_check_horizon"))
+		else if(directive == MAINCONF_cached_host_check_horizon)
 			cached_host_check_horizon = strtoul(value, NULL, 0);
 
-		else if(!strcmp(variable, "enable_predictive_host_dependency_checks"))
+		else if(directive == MAINCONF_enable_predictive_host_dependency_checks)
 			enable_predictive_host_dependency_checks = (atoi(value) > 0) ? TRUE : FALSE;
 
-		else if(!strcmp(variable, "cached_service_check_horizon"))
+		else if(directive == MAINCONF_cached_service_check_horizon)
 			cached_service_check_horizon = strtoul(value, NULL, 0);
 
-		else if(!strcmp(variable, "enable_predictive_service_dependency_checks"))
+		else if(directive == MAINCONF_enable_predictive_service_dependency_checks)
 			enable_predictive_service_dependency_checks = (atoi(value) > 0) ? TRUE : FALSE;
 
-		else if(!strcmp(variable, "soft_state_dependencies")) {
+		else if(directive == MAINCONF_soft_state_dependencies) {
 			if(strlen(value) != 1 || value[0] < '0' || value[0] > '1') {
 				asprintf(&error_message, "Illegal value for soft_state_dependencies");
 				error = TRUE;
@@ -661,7 +788,7 @@ int read_main_config_file(char *main_config_file) {
 			soft_state_dependencies = (atoi(value) > 0) ? TRUE : FALSE;
 			}
 
-		else if(!strcmp(variable, "log_rotation_method")) {
+		else if(directive == MAINCONF_log_rotation_method) {
 			if(!strcmp(value, "n"))
 				log_rotation_method = LOG_ROTATION_NONE;
 			else if(!strcmp(value, "h"))
@@ -679,7 +806,7 @@ int read_main_config_file(char *main_config_file) {
 				}
 			}
 
-		else if(!strcmp(variable, "log_archive_path")) {
+		else if(directive == MAINCONF_log_archive_path) {
 
 			if(strlen(value) > MAX_FILENAME_LENGTH - 1) {
 				asprintf(&error_message, "Log archive path too long");
@@ -691,25 +818,25 @@ int read_main_config_file(char *main_config_file) {
 			log_archive_path = nspath_absolute(value, config_file_dir);
 			}
 
-		else if(!strcmp(variable, "enable_event_handlers"))
+		else if(directive == MAINCONF_enable_event_handlers)
 			enable_event_handlers = (atoi(value) > 0) ? TRUE : FALSE;
 
-		else if(!strcmp(variable, "enable_notifications"))
+		else if(directive == MAINCONF_enable_notifications)
 			enable_notifications = (atoi(value) > 0) ? TRUE : FALSE;
 
-		else if(!strcmp(variable, "execute_service_checks"))
+		else if(directive == MAINCONF_execute_service_checks)
 			execute_service_checks = (atoi(value) > 0) ? TRUE : FALSE;
 
-		else if(!strcmp(variable, "accept_passive_service_checks"))
+		else if(directive == MAINCONF_accept_passive_service_checks)
 			accept_passive_service_checks = (atoi(value) > 0) ? TRUE : FALSE;
 
-		else if(!strcmp(variable, "execute_host_checks"))
+		else if(directive == MAINCONF_execute_host_checks)
 			execute_host_checks = (atoi(value) > 0) ? TRUE : FALSE;
 
-		else if(!strcmp(variable, "accept_passive_host_checks"))
+		else if(directive == MAINCONF_accept_passive_host_checks)
 			accept_passive_host_checks = (atoi(value) > 0) ? TRUE : FALSE;
 
-		else if(!strcmp(variable, "service_inter_check_delay_method")) {
+		else if(directive == MAINCONF_service_inter_check_delay_method) {
 			if(!strcmp(value, "n"))
 				service_inter_check_delay_method = ICD_NONE;
 			else if(!strcmp(value, "d"))
@@ -727,7 +854,7 @@ int read_main_config_file(char *main_config_file) {
 				}
 			}
 
-		else if(!strcmp(variable, "max_service_check_spread")) {
+		else if(directive == MAINCONF_max_service_check_spread) {
 			strip(value);
 			max_service_check_spread = atoi(value);
 			if(max_service_check_spread < 1) {
@@ -737,7 +864,7 @@ int read_main_config_file(char *main_config_file) {
 				}
 			}
 
-		else if(!strcmp(variable, "host_inter_check_delay_method")) {
+		else if(directive == MAINCONF_host_inter_check_delay_method) {
 
 			if(!strcmp(value, "n"))
 				host_inter_check_delay_method = ICD_NONE;
@@ -756,7 +883,7 @@ int read_main_config_file(char *main_config_file) {
 				}
 			}
 
-		else if(!strcmp(variable, "max_host_check_spread")) {
+		else if(directive == MAINCONF_max_host_check_spread) {
 
 			max_host_check_spread = atoi(value);
 			if(max_host_check_spread < 1) {
@@ -766,7 +893,7 @@ int read_main_config_file(char *main_config_file) {
 				}
 			}
 
-		else if(!strcmp(variable, "service_interleave_factor")) {
+		else if(directive == MAINCONF_service_interleave_factor) {
 			if(!strcmp(value, "s"))
 				service_interleave_factor_method = ILF_SMART;
 			else {
@@ -777,7 +904,7 @@ int read_main_config_file(char *main_config_file) {
 				}
 			}
 
-		else if(!strcmp(variable, "max_concurrent_checks")) {
+		else if(directive == MAINCONF_max_concurrent_checks) {
 
 			max_parallel_service_checks = atoi(value);
 			if(max_parallel_service_checks < 0) {
@@ -787,7 +914,7 @@ int read_main_config_file(char *main_config_file) {
 				}
 			}
 
-		else if(!strcmp(variable, "check_result_reaper_frequency") || !strcmp(variable, "service_reaper_frequency")) {
+		else if(directive == MAINCONF_check_result_reaper_frequency || directive == MAINCONF_service_reaper_frequency) {
 
 			check_reaper_interval = atoi(value);
 			if(check_reaper_interval < 1) {
@@ -797,7 +924,7 @@ int read_main_config_file(char *main_config_file) {
 				}
 			}
 
-		else if(!strcmp(variable, "max_check_result_reaper_time")) {
+		else if(directive == MAINCONF_max_check_result_reaper_time) {
 
 			max_check_reaper_time = atoi(value);
 			if(max_check_reaper_time < 1) {
@@ -807,11 +934,11 @@ int read_main_config_file(char *main_config_file) {
 				}
 			}
 
-		else if(!strcmp(variable, "sleep_time")) {
+		else if(directive == MAINCONF_sleep_time) {
 			obsoleted_warning(variable, NULL);
 			}
 
-		else if(!strcmp(variable, "interval_length")) {
+		else if(directive == MAINCONF_interval_length) {
 
 			interval_length = atoi(value);
 			if(interval_length < 1) {
@@ -821,7 +948,7 @@ int read_main_config_file(char *main_config_file) {
 				}
 			}
 
-		else if(!strcmp(variable, "check_external_commands")) {
+		else if(directive == MAINCONF_check_external_commands) {
 
 			if(strlen(value) != 1 || value[0] < '0' || value[0] > '1') {
 				asprintf(&error_message, "Illegal value for check_external_commands");
@@ -833,11 +960,11 @@ int read_main_config_file(char *main_config_file) {
 			}
 
 		/* @todo Remove before Nagios 4.3 */
-		else if(!strcmp(variable, "command_check_interval")) {
+		else if(directive == MAINCONF_command_check_interval) {
 			obsoleted_warning(variable, "Commands are always handled on arrival");
 			}
 
-		else if(!strcmp(variable, "check_for_orphaned_services")) {
+		else if(directive == MAINCONF_check_for_orphaned_services) {
 
 			if(strlen(value) != 1 || value[0] < '0' || value[0] > '1') {
 				asprintf(&error_message, "Illegal value for check_for_orphaned_services");
@@ -848,7 +975,7 @@ int read_main_config_file(char *main_config_file) {
 			check_orphaned_services = (atoi(value) > 0) ? TRUE : FALSE;
 			}
 
-		else if(!strcmp(variable, "check_for_orphaned_hosts")) {
+		else if(directive == MAINCONF_check_for_orphaned_hosts) {
 
 			if(strlen(value) != 1 || value[0] < '0' || value[0] > '1') {
 				asprintf(&error_message, "Illegal value for check_for_orphaned_hosts");
@@ -859,7 +986,7 @@ int read_main_config_file(char *main_config_file) {
 			check_orphaned_hosts = (atoi(value) > 0) ? TRUE : FALSE;
 			}
 
-		else if(!strcmp(variable, "check_service_freshness")) {
+		else if(directive == MAINCONF_check_service_freshness) {
 
 			if(strlen(value) != 1 || value[0] < '0' || value[0] > '1') {
 				asprintf(&error_message, "Illegal value for check_service_freshness");
@@ -870,7 +997,7 @@ int read_main_config_file(char *main_config_file) {
 			check_service_freshness = (atoi(value) > 0) ? TRUE : FALSE;
 			}
 
-		else if(!strcmp(variable, "check_host_freshness")) {
+		else if(directive == MAINCONF_check_host_freshness) {
 
 			if(strlen(value) != 1 || value[0] < '0' || value[0] > '1') {
 				asprintf(&error_message, "Illegal value for check_host_freshness");
@@ -881,7 +1008,7 @@ int read_main_config_file(char *main_config_file) {
 			check_host_freshness = (atoi(value) > 0) ? TRUE : FALSE;
 			}
 
-		else if(!strcmp(variable, "service_freshness_check_interval") || !strcmp(variable, "freshness_check_interval")) {
+		else if(directive == MAINCONF_service_freshness_check_interval || directive == MAINCONF_freshness_check_interval) {
 
 			service_freshness_check_interval = atoi(value);
 			if(service_freshness_check_interval <= 0) {
@@ -891,7 +1018,7 @@ int read_main_config_file(char *main_config_file) {
 				}
 			}
 
-		else if(!strcmp(variable, "host_freshness_check_interval")) {
+		else if(directive == MAINCONF_host_freshness_check_interval) {
 
 			host_freshness_check_interval = atoi(value);
 			if(host_freshness_check_interval <= 0) {
@@ -900,7 +1027,7 @@ int read_main_config_file(char *main_config_file) {
 				break;
 				}
 			}
-		else if(!strcmp(variable, "auto_reschedule_checks")) {
+		else if(directive == MAINCONF_auto_reschedule_checks) {
 
 			if(strlen(value) != 1 || value[0] < '0' || value[0] > '1') {
 				asprintf(&error_message, "Illegal value for auto_reschedule_checks");
@@ -911,7 +1038,7 @@ int read_main_config_file(char *main_config_file) {
 			auto_reschedule_checks = (atoi(value) > 0) ? TRUE : FALSE;
 			}
 
-		else if(!strcmp(variable, "auto_rescheduling_interval")) {
+		else if(directive == MAINCONF_auto_rescheduling_interval) {
 
 			auto_rescheduling_interval = atoi(value);
 			if(auto_rescheduling_interval <= 0) {
@@ -921,7 +1048,7 @@ int read_main_config_file(char *main_config_file) {
 				}
 			}
 
-		else if(!strcmp(variable, "auto_rescheduling_window")) {
+		else if(directive == MAINCONF_auto_rescheduling_window) {
 
 			auto_rescheduling_window = atoi(value);
 			if(auto_rescheduling_window <= 0) {
@@ -931,7 +1058,7 @@ int read_main_config_file(char *main_config_file) {
 				}
 			}
 			
-		else if(!strcmp(variable, "status_update_interval")) {
+		else if(directive == MAINCONF_status_update_interval) {
 
 			status_update_interval = atoi(value);
 			if(status_update_interval < 1) {
@@ -941,7 +1068,7 @@ int read_main_config_file(char *main_config_file) {
 				}
 			}
 
-		else if(!strcmp(variable, "time_change_threshold")) {
+		else if(directive == MAINCONF_time_change_threshold) {
 
 			time_change_threshold = atoi(value);
 
@@ -952,16 +1079,16 @@ int read_main_config_file(char *main_config_file) {
 				}
 			}
 
-		else if(!strcmp(variable, "process_performance_data"))
+		else if(directive == MAINCONF_process_performance_data)
 			process_performance_data = (atoi(value) > 0) ? TRUE : FALSE;
 
-		else if(!strcmp(variable, "enable_flap_detection"))
+		else if(directive == MAINCONF_enable_flap_detection)
 			enable_flap_detection = (atoi(value) > 0) ? TRUE : FALSE;
 
-		else if(!strcmp(variable, "enable_failure_prediction"))
+		else if(directive == MAINCONF_enable_failure_prediction)
 			obsoleted_warning(variable, NULL);
 
-		else if(!strcmp(variable, "low_service_flap_threshold")) {
+		else if(directive == MAINCONF_low_service_flap_threshold) {
 
 			low_service_flap_threshold = strtod(value, NULL);
 			if(low_service_flap_threshold <= 0.0 || low_service_flap_threshold >= 100.0) {
@@ -971,7 +1098,7 @@ int read_main_config_file(char *main_config_file) {
 				}
 			}
 
-		else if(!strcmp(variable, "high_service_flap_threshold")) {
+		else if(directive == MAINCONF_high_service_flap_threshold) {
 
 			high_service_flap_threshold = strtod(value, NULL);
 			if(high_service_flap_threshold <= 0.0 ||  high_service_flap_threshold > 100.0) {
@@ -981,7 +1108,7 @@ int read_main_config_file(char *main_config_file) {
 				}
 			}
 
-		else if(!strcmp(variable, "low_host_flap_threshold")) {
+		else if(directive == MAINCONF_low_host_flap_threshold) {
 
 			low_host_flap_threshold = strtod(value, NULL);
 			if(low_host_flap_threshold <= 0.0 || low_host_flap_threshold >= 100.0) {
@@ -991,7 +1118,7 @@ int read_main_config_file(char *main_config_file) {
 				}
 			}
 
-		else if(!strcmp(variable, "high_host_flap_threshold")) {
+		else if(directive == MAINCONF_high_host_flap_threshold) {
 
 			high_host_flap_threshold = strtod(value, NULL);
 			if(high_host_flap_threshold <= 0.0 || high_host_flap_threshold > 100.0) {
@@ -1001,7 +1128,7 @@ int read_main_config_file(char *main_config_file) {
 				}
 			}
 
-		else if(!strcmp(variable, "date_format")) {
+		else if(directive == MAINCONF_date_format) {
 
 			if(!strcmp(value, "euro"))
 				date_format = DATE_FORMAT_EURO;
@@ -1013,12 +1140,12 @@ int read_main_config_file(char *main_config_file) {
 				date_format = DATE_FORMAT_US;
 			}
 
-		else if(!strcmp(variable, "use_timezone")) {
+		else if(directive == MAINCONF_use_timezone) {
 			my_free(use_timezone);
 			use_timezone = (char *)strdup(value);
 			}
 
-		else if(!strcmp(variable, "event_broker_options")) {
+		else if(directive == MAINCONF_event_broker_options) {
 
 			if(!strcmp(value, "-1"))
 				event_broker_options = BROKER_EVERYTHING;
@@ -1026,14 +1153,14 @@ int read_main_config_file(char *main_config_file) {
 				event_broker_options = strtoul(value, NULL, 0);
 			}
 
-		else if(!strcmp(variable, "illegal_object_name_chars"))
+		else if(directive == MAINCONF_illegal_object_name_chars)
 			illegal_object_chars = (char *)strdup(value);
 
-		else if(!strcmp(variable, "illegal_macro_output_chars"))
+		else if(directive == MAINCONF_illegal_macro_output_chars)
 			illegal_output_chars = (char *)strdup(value);
 
 
-		else if(!strcmp(variable, "broker_module")) {
+		else if(directive == MAINCONF_broker_module) {
 			modptr = strtok(value, " \n");
 			argptr = strtok(NULL, "\n");
 #ifdef USE_EVENT_BROKER
@@ -1048,13 +1175,13 @@ int read_main_config_file(char *main_config_file) {
 #endif
 			}
 
-		else if(!strcmp(variable, "use_regexp_matching"))
+		else if(directive == MAINCONF_use_regexp_matching)
 			use_regexp_matches = (atoi(value) > 0) ? TRUE : FALSE;
 
-		else if(!strcmp(variable, "use_true_regexp_matching"))
+		else if(directive == MAINCONF_use_true_regexp_matching)
 			use_true_regexp_matching = (atoi(value) > 0) ? TRUE : FALSE;
 
-		else if(!strcmp(variable, "daemon_dumps_core")) {
+		else if(directive == MAINCONF_daemon_dumps_core) {
 
 			if(strlen(value) != 1 || value[0] < '0' || value[0] > '1') {
 				asprintf(&error_message, "Illegal value for daemon_dumps_core");
@@ -1065,7 +1192,7 @@ int read_main_config_file(char *main_config_file) {
 			daemon_dumps_core = (atoi(value) > 0) ? TRUE : FALSE;
 			}
 
-		else if(!strcmp(variable, "use_large_installation_tweaks")) {
+		else if(directive == MAINCONF_use_large_installation_tweaks) {
 
 			if(strlen(value) != 1 || value[0] < '0' || value[0] > '1') {
 				asprintf(&error_message, "Illegal value for use_large_installation_tweaks ");
@@ -1076,59 +1203,72 @@ int read_main_config_file(char *main_config_file) {
 			use_large_installation_tweaks = (atoi(value) > 0) ? TRUE : FALSE;
 			}
 
-		else if(!strcmp(variable, "enable_environment_macros"))
+		else if(directive == MAINCONF_enable_environment_macros)
 			enable_environment_macros = (atoi(value) > 0) ? TRUE : FALSE;
 
-		else if(!strcmp(variable, "free_child_process_memory"))
+		else if(directive == MAINCONF_environment_macros) {
+
+			if(set_environment_macro_filter(value) == ERROR) {
+				asprintf(&error_message, "Illegal value for environment_macros");
+				error = TRUE;
+				break;
+				}
+			}
+
+		else if(directive == MAINCONF_free_child_process_memory)
 			free_child_process_memory = (atoi(value) > 0) ? TRUE : FALSE;
 
-		else if(!strcmp(variable, "child_processes_fork_twice"))
+		else if(directive == MAINCONF_child_processes_fork_twice)
 			child_processes_fork_twice = (atoi(value) > 0) ? TRUE : FALSE;
 
 		/*** embedded perl variables are deprecated now ***/
-		else if(!strcmp(variable, "enable_embedded_perl"))
+		else if(directive == MAINCONF_enable_embedded_perl)
 			obsoleted_warning(variable, NULL);
-		else if(!strcmp(variable, "use_embedded_perl_implicitly"))
+		else if(directive == MAINCONF_use_embedded_perl_implicitly)
 			obsoleted_warning(variable, NULL);
-		else if(!strcmp(variable, "auth_file"))
+		else if(directive == MAINCONF_auth_file)
 			obsoleted_warning(variable, NULL);
-		else if(!strcmp(variable, "p1_file"))
+		else if(directive == MAINCONF_p1_file)
 			obsoleted_warning(variable, NULL);
 
 		/*** as is external_command_buffer_slots */
-		else if(!strcmp(variable, "external_command_buffer_slots"))
+		else if(directive == MAINCONF_external_command_buffer_slots)
 			obsoleted_warning(variable, "All commands are always processed upon arrival");
 
-		else if(!strcmp(variable, "check_for_updates"))
+		else if(directive == MAINCONF_check_for_updates)
 			check_for_updates = (atoi(value) > 0) ? TRUE : FALSE;
 
-		else if(!strcmp(variable, "bare_update_check"))
+		else if(directive == MAINCONF_bare_update_check)
 			bare_update_check = (atoi(value) > 0) ? TRUE : FALSE;
 
 		/* BEGIN status data variables */
-		else if(!strcmp(variable, "status_file"))
+		else if(directive == MAINCONF_status_file)
 			status_file = nspath_absolute(value, config_file_dir);
+		else if(directive == MAINCONF_status_binary_file) {
+			my_free(status_binary_file);
+			status_binary_file = nspath_absolute(value, config_file_dir);
+			}
 		else if(strstr(input, "state_retention_file=") == input)
 			retention_file = nspath_absolute(value, config_file_dir);
 		/* END status data variables */
 
 		/*** BEGIN perfdata variables ***/
-		else if(!strcmp(variable, "perfdata_timeout")) {
+		else if(directive == MAINCONF_perfdata_timeout) {
 			perfdata_timeout = atoi(value);
 			}
-		else if(!strcmp(variable, "host_perfdata_command"))
+		else if(directive == MAINCONF_host_perfdata_command)
 			host_perfdata_command = (char *)strdup(value);
-		else if(!strcmp(variable, "service_perfdata_command"))
+		else if(directive == MAINCONF_service_perfdata_command)
 			service_perfdata_command = (char *)strdup(value);
-		else if(!strcmp(variable, "host_perfdata_file_template"))
+		else if(directive == MAINCONF_host_perfdata_file_template)
 			host_perfdata_file_template = (char *)strdup(value);
-		else if(!strcmp(variable, "service_perfdata_file_template"))
+		else if(directive == MAINCONF_service_perfdata_file_template)
 			service_perfdata_file_template = (char *)strdup(value);
-		else if(!strcmp(variable, "host_perfdata_file"))
+		else if(directive == MAINCONF_host_perfdata_file)
 			host_perfdata_file = nspath_absolute(value, config_file_dir);
-		else if(!strcmp(variable, "service_perfdata_file"))
+		else if(directive == MAINCONF_service_perfdata_file)
 			service_perfdata_file = nspath_absolute(value, config_file_dir);
-		else if(!strcmp(variable, "host_perfdata_file_mode")) {
+		else if(directive == MAINCONF_host_perfdata_file_mode) {
 			host_perfdata_file_pipe = FALSE;
 			if(strstr(value, "p") != NULL)
 				host_perfdata_file_pipe = TRUE;
@@ -1137,7 +1277,7 @@ int read_main_config_file(char *main_config_file) {
 			else
 				host_perfdata_file_append = TRUE;
 			}
-		else if(!strcmp(variable, "service_perfdata_file_mode")) {
+		else if(directive == MAINCONF_service_perfdata_file_mode) {
 			service_perfdata_file_pipe = FALSE;
 			if(strstr(value, "p") != NULL)
 				service_perfdata_file_pipe = TRUE;
@@ -1146,17 +1286,17 @@ int read_main_config_file(char *main_config_file) {
 			else
 				service_perfdata_file_append = TRUE;
 			}
-		else if(!strcmp(variable, "host_perfdata_file_processing_interval"))
+		else if(directive == MAINCONF_host_perfdata_file_processing_interval)
 			host_perfdata_file_processing_interval = strtoul(value, NULL, 0);
-		else if(!strcmp(variable, "service_perfdata_file_processing_interval"))
+		else if(directive == MAINCONF_service_perfdata_file_processing_interval)
 			service_perfdata_file_processing_interval = strtoul(value, NULL, 0);
-		else if(!strcmp(variable, "host_perfdata_file_processing_command"))
+		else if(directive == MAINCONF_host_perfdata_file_processing_command)
 			host_perfdata_file_processing_command = (char *)strdup(value);
-		else if(!strcmp(variable, "service_perfdata_file_processing_command"))
+		else if(directive == MAINCONF_service_perfdata_file_processing_command)
 			service_perfdata_file_processing_command = (char *)strdup(value);
-		else if(!strcmp(variable,"host_perfdata_process_empty_results"))
+		else if(directive == MAINCONF_host_perfdata_process_empty_results)
 			host_perfdata_process_empty_results = (atoi(value) > 0) ? TRUE : FALSE;
-		else if(!strcmp(variable,"service_perfdata_process_empty_results"))
+		else if(directive == MAINCONF_service_perfdata_process_empty_results)
 			service_perfdata_process_empty_results = (atoi(value) > 0) ? TRUE : FALSE;
 		/*** END perfdata variables */
 
@@ -1172,17 +1312,27 @@ int read_main_config_file(char *main_config_file) {
 			my_free(object_precache_file);
 			object_precache_file = nspath_absolute(value, config_file_dir);
 		}
-		else if(!strcmp(variable, "allow_empty_hostgroup_assignment")) {
+		else if(directive == MAINCONF_binary_object_precache) {
+
+			if(strlen(value) != 1 || value[0] < '0' || value[0] > '1') {
+				asprintf(&error_message, "Illegal value for binary_object_precache");
+				error = TRUE;
+				break;
+				}
+
+			binary_object_precache = (atoi(value) > 0) ? TRUE : FALSE;
+			}
+		else if(directive == MAINCONF_allow_empty_hostgroup_assignment) {
 			allow_empty_hostgroup_assignment = (atoi(value) > 0) ? TRUE : FALSE;
 			}
 		/* skip external data directives */
 		else if(strstr(input, "x") == input)
 			continue;
 
-		else if(!strcmp(variable,"host_down_disable_service_checks")) {
+		else if(directive == MAINCONF_host_down_disable_service_checks) {
 			host_down_disable_service_checks = strtoul(value, NULL, 0);
 		}
-		else if(!strcmp(variable,"service_skip_check_dependency_status")) {
+		else if(directive == MAINCONF_service_skip_check_dependency_status) {
 			service_skip_check_dependency_status = atoi(value);
 			if(service_skip_check_dependency_status < -1 || service_skip_check_dependency_status > 3) {
 				asprintf(&error_message, "Illegal value for service_skip_check_dependency_status");
@@ -1190,7 +1340,7 @@ int read_main_config_file(char *main_config_file) {
 				break;
 			}
 		}
-		else if(!strcmp(variable,"service_skip_check_parent_status")) {
+		else if(directive == MAINCONF_service_skip_check_parent_status) {
 			service_skip_check_parent_status = atoi(value);
 			if(service_skip_check_parent_status < -1 || service_skip_check_parent_status > 3) {
 				asprintf(&error_message, "Illegal value for service_skip_check_parent_status");
@@ -1198,7 +1348,7 @@ int read_main_config_file(char *main_config_file) {
 				break;
 			}
 		}
-		else if(!strcmp(variable,"service_skip_check_host_down_status")) {
+		else if(directive == MAINCONF_service_skip_check_host_down_status) {
 			service_skip_check_host_down_status = atoi(value);
 			if(service_skip_check_host_down_status < -1 || service_skip_check_host_down_status > 3) {
 				asprintf(&error_message, "Illegal value for service_skip_check_host_down_status");
@@ -1206,7 +1356,7 @@ int read_main_config_file(char *main_config_file) {
 				break;
 			}
 		}
-		else if(!strcmp(variable,"host_skip_check_dependency_status")) {
+		else if(directive == MAINCONF_host_skip_check_dependency_status) {
 			host_skip_check_dependency_status = atoi(value);
 			if(host_skip_check_dependency_status < -1 || host_skip_check_dependency_status > 3) {
 				asprintf(&error_message, "Illegal value for host_skip_check_dependency_status");
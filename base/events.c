@@ -54,6 +54,7 @@ int dump_event_stats(int sd)
 		if (i == 16)
 			i = 97;
 		}
+	nsock_printf(sd, "SQUEUE_TYPE=%s;", squeue_type_name(squeue_type(nagios_squeue)));
 	nsock_printf_nul(sd, "SQUEUE_ENTRIES=%u", squeue_size(nagios_squeue));
 
 	return OK;
@@ -760,7 +761,11 @@ int init_event_queue(void)
 		size = 4096;
 	}
 
-	nagios_squeue = squeue_create(size);
+	nagios_squeue = squeue_create_type(size, event_queue_type);
+	if (nagios_squeue == NULL) {
+		logit(NSLOG_RUNTIME_ERROR, TRUE, "Error: Failed to create the %s event queue\n", squeue_type_name(event_queue_type));
+		return ERROR;
+	}
 	return 0;
 }
 
@@ -1066,6 +1071,7 @@ int event_execution_loop(void) {
 	time_t current_time = 0L;
 	time_t last_status_update = 0L;
 	int poll_time_ms;
+	int batched;
 
 	log_debug_info(DEBUGL_FUNCTIONS, 0, "event_execution_loop() start\n");
 
@@ -1122,6 +1128,9 @@ int event_execution_loop(void) {
 
 		last_event = temp_event;
 
+		/* get journaled changes to the kernel before we sit in poll() */
+		sync_retention_journal();
+
 		gettimeofday(&now, NULL);
 		poll_time_ms = tv_delta_msec(&now, event_runtime);
 		if (poll_time_ms < 0)
@@ -1140,6 +1149,9 @@ int event_execution_loop(void) {
 
 		log_debug_info(DEBUGL_IPC, 2, "## %d descriptors had input\n", inputs);
 
+		/* send new trace records to anyone streaming them */
+		qh_trace_flush();
+
 		/*
 		 * if the event we peaked was removed from the queue from
 		 * one of the I/O operations, we must take care not to
@@ -1156,27 +1168,52 @@ int event_execution_loop(void) {
 		if (tv_delta_msec(&now, event_runtime) > 5)
 			continue;
 
-		/* move on if we shouldn't run this event */
-		if(should_run_event(temp_event) == FALSE)
-			continue;
-
-		/* handle the event */
-		handle_timed_event(temp_event);
-
 		/*
-		 * we must remove the entry we've peeked, or
-		 * we'll keep getting the same one over and over.
-		 * This also maintains sync with broker modules.
+		 * handle every event that was due when we got here, up to
+		 * event_batch_size of them, before we poll for input again
 		 */
-		remove_event(nagios_squeue, temp_event);
+		for (batched = 0;;) {
 
-		/* reschedule the event if necessary */
-		if(temp_event->recurring == TRUE)
-			reschedule_event(nagios_squeue, temp_event);
+			/*
+			 * stop batching if we shouldn't run this event. It may
+			 * still be at the head of the queue (e.g. when no worker
+			 * can take it), and peeking it again right away would
+			 * only keep us from polling for input.
+			 */
+			if(should_run_event(temp_event) == FALSE)
+				break;
 
-		/* else free memory associated with the event */
-		else
-			my_free(temp_event);
+			/* handle the event */
+			handle_timed_event(temp_event);
+
+			/*
+			 * we must remove the entry we've peeked, or
+			 * we'll keep getting the same one over and over.
+			 * This also maintains sync with broker modules.
+			 */
+			remove_event(nagios_squeue, temp_event);
+
+			/* reschedule the event if necessary */
+			if(temp_event->recurring == TRUE)
+				reschedule_event(nagios_squeue, temp_event);
+
+			/* else free memory associated with the event */
+			else
+				my_free(temp_event);
+
+			if(++batched >= event_batch_size || sigshutdown == TRUE || sigrestart == TRUE)
+				break;
+
+			current_event = temp_event = (timed_event *)squeue_peek(nagios_squeue);
+			if(!temp_event)
+				break;
+			event_runtime = squeue_event_runtime(temp_event->sq_event);
+			if(tv_delta_msec(&now, event_runtime) > 5)
+				break;
+			}
+
+		if(batched > 1)
+			log_debug_info(DEBUGL_EVENTS, 1, "Handled a batch of %d events\n", batched);
 	}
 
 	log_debug_info(DEBUGL_FUNCTIONS, 0, "event_execution_loop() end\n");
@@ -1212,6 +1249,10 @@ int handle_timed_event(timed_event *event) {
 	if (latency < 0.0) /* events may run up to 0.005 seconds early */
 		latency = 0.0;
 
+	nagios_trace_event(TRACE_EVENT_DISPATCH, event->event_type, (uint64_t)(latency * 1000000),
+	                   event->event_type == EVENT_SERVICE_CHECK ? ((service *)event->event_data)->id :
+	                   event->event_type == EVENT_HOST_CHECK ? ((host *)event->event_data)->id : 0);
+
 	/* how should we handle the event? */
 	switch(event->event_type) {
 
@@ -1388,23 +1429,62 @@ int handle_timed_event(timed_event *event) {
 
 
 
-/* The squeue internal event type, declared again here so we can manipulate the
- * scheduling queue without a malloc/free for each add/remove.
- * @todo: Refactor this to not depend so heavily on the event queue
- * implementation, doing so efficiently may require a different scheduling queue
- * data structure. */
-struct squeue_event {
-	unsigned int pos;
-	prqueue_pri_t pri;
-	struct timeval when;
-	void *data;
+/* state shared with the squeue walker in adjust_check_scheduling() */
+struct check_window {
+	time_t first_window_time;
+	int total_checks;
+	struct squeue_event **events;
 	};
 
+static int collect_check_events(squeue_event *sq_event, void *arg) {
+	struct check_window *window = (struct check_window *)arg;
+	timed_event *temp_event = squeue_event_data(sq_event);
+
+	/* We need a timed_event and event data. */
+	if (!temp_event || !temp_event->event_data)
+		return 0;
+
+	/* Skip events before our current window. */
+	if (temp_event->run_time < window->first_window_time)
+		return 0;
+
+	switch (temp_event->event_type) {
+		case EVENT_HOST_CHECK:
+			/* Leave forced checks. */
+			if (((host *)temp_event->event_data)->check_options & CHECK_OPTION_FORCE_EXECUTION)
+				return 0;
+			break;
+
+		case EVENT_SERVICE_CHECK:
+			/* Leave forced checks. */
+			if (((service *)temp_event->event_data)->check_options & CHECK_OPTION_FORCE_EXECUTION)
+				return 0;
+			break;
+
+		default:
+			return 0;
+		}
+
+	window->events[window->total_checks++] = sq_event;
+	return 0;
+	}
+
+static int compare_event_runtimes(const void *a, const void *b) {
+	const struct timeval *ta = squeue_event_runtime(*(squeue_event **)a);
+	const struct timeval *tb = squeue_event_runtime(*(squeue_event **)b);
+
+	if (ta->tv_sec != tb->tv_sec)
+		return ta->tv_sec < tb->tv_sec ? -1 : 1;
+	if (ta->tv_usec != tb->tv_usec)
+		return ta->tv_usec < tb->tv_usec ? -1 : 1;
+	return 0;
+	}
+
 /*
  * Adjusts scheduling of active, non-forced host and service checks.
  */
 void adjust_check_scheduling(void) {
-	prqueue_t *temp_prqueue; /* squeue_t is a typedef of prqueue_t. */
+	struct check_window window;
 	struct squeue_event *sq_event;
 	struct squeue_event **events_to_reschedule;
 
@@ -1434,104 +1514,49 @@ void adjust_check_scheduling(void) {
 	last_window_time = first_window_time + auto_rescheduling_window;
 
 	/* Nothing to do if the first event is after the reschedule window. */
-	sq_event = prqueue_peek(nagios_squeue);
-	temp_event = sq_event ? sq_event->data : NULL;
+	temp_event = squeue_peek(nagios_squeue);
 	if (!temp_event || temp_event->run_time > last_window_time)
 		return;
 
 
-	/* Get a sorted array of all check events to reschedule. First we need a
-	 * duplicate of nagios_squeue so we can get the events in-order without
-	 * having to remove them from the original queue. We will use
-	 * prqueue_change_priority() to move the check events in the original queue.
-	 * @note: This is horribly dependent on implementation details of squeue
-	 * and prqueue, but we don't have much choice to avoid a free/malloc of each
-	 * squeue_event from the head to last_window_time, or avoid paying the full
-	 * O(n lg n) penalty twice to drain and rebuild the queue. */
-	temp_prqueue = malloc(sizeof(*temp_prqueue));
-	if (!temp_prqueue) {
-		logit(NSLOG_RUNTIME_ERROR, TRUE, "Failed to allocate queue needed to adjust check scheduling.\n");
-		return;
-		}
-	*temp_prqueue = *nagios_squeue;
-
-	/* We need a separate copy of the underlying queue array. */
-	temp_prqueue->d = malloc(temp_prqueue->size * sizeof(void*));
-	if (!temp_prqueue->d) {
-		logit(NSLOG_RUNTIME_ERROR, TRUE, "Failed to allocate queue data needed to adjust check scheduling.\n");
-		free(temp_prqueue);
-		return;
-		}
-	memcpy(temp_prqueue->d, nagios_squeue->d, temp_prqueue->size * sizeof(void*));
-	temp_prqueue->avail = temp_prqueue->size;
-
-	/* Now allocate space for a sorted array of check events. We shouldn't need
-	 * space for all events, but we can't really calculate how many we'll need
-	 * without looking at all events. */
-	events_to_reschedule = malloc((temp_prqueue->size - 1) * sizeof(void*));
+	/* Get a sorted array of all check events to reschedule. The queue
+	 * hands us every event up to last_window_time without having to
+	 * remove them, so we collect the check events and sort them by run
+	 * time ourselves. We will use squeue_change_priority_tv() to move the
+	 * check events in the queue later on. We shouldn't need space for all
+	 * events, but we can't really calculate how many we'll need without
+	 * looking at all events. */
+	events_to_reschedule = malloc(squeue_size(nagios_squeue) * sizeof(void*));
 	if (!events_to_reschedule) {
 		logit(NSLOG_RUNTIME_ERROR, TRUE, "Failed to allocate memory needed to adjust check scheduling.\n");
-		prqueue_free(temp_prqueue); /* prqueue_free() to keep the events. */
 		return;
 		}
 
 	/* Now we get the events to reschedule and collect some scheduling info. */
-	while ((sq_event = prqueue_pop(temp_prqueue))) {
-
-		/* We need a timed_event and event data. */
-		temp_event = sq_event->data;
-		if (!temp_event || !temp_event->event_data)
-			continue;
-
-		/* Skip events before our current window. */
-		if (temp_event->run_time < first_window_time)
-			continue;
-		/* We're done once past the end of the window. */
-		if (temp_event->run_time > last_window_time)
-			break;
-
-		switch (temp_event->event_type) {
-			case EVENT_HOST_CHECK:
-				temp_host = temp_event->event_data;
-				/* Leave forced checks. */
-				if (temp_host->check_options & CHECK_OPTION_FORCE_EXECUTION)
-					continue;
-				break;
-
-			case EVENT_SERVICE_CHECK:
-				temp_service = temp_event->event_data;
-				/* Leave forced checks. */
-				if (temp_service->check_options & CHECK_OPTION_FORCE_EXECUTION)
-					continue;
-				break;
+	window.first_window_time = first_window_time;
+	window.total_checks = 0;
+	window.events = events_to_reschedule;
+	squeue_foreach_until(nagios_squeue, last_window_time, collect_check_events, &window);
+	total_checks = window.total_checks;
+	qsort(events_to_reschedule, total_checks, sizeof(void*), compare_event_runtimes);
 
-			default:
-				continue;
-			}
+	for (i = 0; i < total_checks; ++i) {
+		const struct timeval *when = squeue_event_runtime(events_to_reschedule[i]);
 
 		/* Reschedule if the last check overlap into this one. */
-		if (last_check_tv.tv_sec > 0 && tv_delta_msec(&last_check_tv, &sq_event->when) < INTER_CHECK_RESCHEDULE_THRESHOLD * 1000) {
-/*			log_debug_info(DEBUGL_SCHEDULING, 2, "Rescheduling event %d: %.3fs delay.\n", total_checks, tv_delta_f(&last_check_tv, &sq_event->when));
+		if (last_check_tv.tv_sec > 0 && tv_delta_msec(&last_check_tv, when) < INTER_CHECK_RESCHEDULE_THRESHOLD * 1000) {
+/*			log_debug_info(DEBUGL_SCHEDULING, 2, "Rescheduling event %d: %.3fs delay.\n", i, tv_delta_f(&last_check_tv, when));
 */			adjust_scheduling = TRUE;
+			break;
 			}
 
-		last_check_tv = sq_event->when;
-		events_to_reschedule[total_checks++] = sq_event;
-		}
-
-	/* Removing squeue_events from temp_prqueue invalidates the positions of
-	 * those events in nagios_squeue, so we need to fix that up before we
-	 * return or change their priorities. Start at i=1 since i=0 is unused. */
-	for (i = 1; i < (int)nagios_squeue->size; ++i) {
-		if ((sq_event = nagios_squeue->d[i]))
-			sq_event->pos = i;
+		last_check_tv = *when;
 		}
 
 	/* No checks to reschedule, nothing to do... */
 	if (total_checks < 2 || !adjust_scheduling) {
 		log_debug_info(DEBUGL_SCHEDULING, 0, "No events need to be rescheduled (%d checks in %ds window).\n", total_checks, auto_rescheduling_window);
 
-		prqueue_free(temp_prqueue);
 		free(events_to_reschedule);
 		return;
 		}
@@ -1550,7 +1575,7 @@ void adjust_check_scheduling(void) {
 		/* All events_to_reschedule are valid squeue_events with data pointers
 		 * to timed_events for non-forced host or service checks. */
 		sq_event = events_to_reschedule[i];
-		temp_event = sq_event->data;
+		temp_event = squeue_event_data(sq_event);
 
 		/* Calculate and apply a new queue 'when' time. */
 		new_run_time.tv_sec = first_window_time + (time_t)floor(new_run_time_offset);
@@ -1599,7 +1624,6 @@ void adjust_check_scheduling(void) {
 
 	log_debug_info(DEBUGL_FUNCTIONS, 0, "adjust_check_scheduling() end\n");
 
-	prqueue_free(temp_prqueue);
 	free(events_to_reschedule);
 	return;
 	}
@@ -1613,7 +1637,7 @@ static void adjust_squeue_for_time_change(squeue_t **q, int delta) {
 	 * but it should be pretty rare that we have to adjust times
 	 * so we go with the well-tested codepath.
 	 */
-	sq_new = squeue_create(squeue_size(*q));
+	sq_new = squeue_create_type(squeue_size(*q), squeue_type(*q));
 	while ((event = squeue_pop(*q))) {
 		if (event->compensate_for_time_change == TRUE) {
 			if (event->timing_func) {
@@ -1677,6 +1701,13 @@ void compensate_for_system_time_change(unsigned long last_time, unsigned long cu
 
 	adjust_squeue_for_time_change(&nagios_squeue, delta);
 
+	/* timeperiods compiled before the change may be off, so compile them again */
+	invalidate_timeperiod_cache();
+
+	/* adjust program timestamps first, as freshness deadlines depend on them */
+	adjust_timestamp_for_time_change(last_time, current_time, time_difference, &program_start);
+	adjust_timestamp_for_time_change(last_time, current_time, time_difference, &event_start);
+
 	/* adjust service timestamps */
 	for(temp_service = service_list; temp_service != NULL; temp_service = temp_service->next) {
 
@@ -1710,10 +1741,6 @@ void compensate_for_system_time_change(unsigned long last_time, unsigned long cu
 		update_host_status(temp_host, FALSE);
 		}
 
-	/* adjust program timestamps */
-	adjust_timestamp_for_time_change(last_time, current_time, time_difference, &program_start);
-	adjust_timestamp_for_time_change(last_time, current_time, time_difference, &event_start);
-
 	/* update the status data */
 	update_program_status(FALSE);
 
@@ -0,0 +1,699 @@
+/* C code generated from extcmd.gperf in gperf's output format */
+/* Command-line: gperf --ignore-case -t -H extcmd_key_phash -N extcmd_get_key extcmd.gperf  */
+/* Computed positions: -k'1,8,15,19,26' */
+
+#line 1 "extcmd.gperf"
+/*
+ * External command names and the CMD_* ids from common.h they map to.
+ * Several ids have more than one name. Names are case-insensitive.
+ */
+#line 7 "extcmd.gperf"
+struct extcmd_key {
+	const char *name;
+	int code;
+};
+
+#define TOTAL_KEYWORDS 165
+#define MIN_WORD_LENGTH 12
+#define MAX_WORD_LENGTH 46
+#define MIN_HASH_VALUE 143
+#define MAX_HASH_VALUE 1279
+/* maximum key range = 1137, duplicates = 0 */
+
+#ifdef __GNUC__
+__inline
+#else
+#ifdef __cplusplus
+inline
+#endif
+#endif
+static unsigned int
+extcmd_key_phash (register const char *str, register size_t len)
+{
+  static unsigned short asso_values[] =
+    {
+      1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280,
+      1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280,
+      1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280,
+      1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280,
+      1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280,
+      1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280,
+      1280, 1280, 1280, 1280, 1280,   39,  289,  108,  147,   70,
+       123,  122,  308,    5, 1280,   45,  197,  318,  119,   79,
+       228, 1280,  231,    5,  323,  327,  278,  302,   52,  162,
+      1280, 1280, 1280, 1280, 1280,  128, 1280,   39,  289,  108,
+       147,   70,  123,  122,  308,    5, 1280,   45,  197,  318,
+       119,   79,  228, 1280,  231,    5,  323,  327,  278,  302,
+        52,  162, 1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280,
+      1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280,
+      1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280,
+      1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280,
+      1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280,
+      1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280,
+      1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280,
+      1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280,
+      1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280,
+      1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280,
+      1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280,
+      1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280,
+      1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280, 1280,
+      1280, 1280, 1280, 1280, 1280, 1280
+    };
+  register unsigned int hval = len;
+
+  switch (hval)
+    {
+      default:
+        hval += asso_values[(unsigned char)str[25]];
+      /*FALLTHROUGH*/
+      case 25:
+      case 24:
+      case 23:
+      case 22:
+      case 21:
+      case 20:
+      case 19:
+        hval += asso_values[(unsigned char)str[18]];
+      /*FALLTHROUGH*/
+      case 18:
+      case 17:
+      case 16:
+      case 15:
+        hval += asso_values[(unsigned char)str[14]];
+      /*FALLTHROUGH*/
+      case 14:
+      case 13:
+      case 12:
+        hval += asso_values[(unsigned char)str[7]];
+      /*FALLTHROUGH*/
+        hval += asso_values[(unsigned char)str[0]];
+        break;
+    }
+  return hval;
+}
+
+#ifndef GPERF_DOWNCASE
+#define GPERF_DOWNCASE 1
+static unsigned char gperf_downcase[256] =
+  {
+      0,   1,   2,   3,   4,   5,   6,   7,   8,   9,  10,  11,  12,  13,  14,
+     15,  16,  17,  18,  19,  20,  21,  22,  23,  24,  25,  26,  27,  28,  29,
+     30,  31,  32,  33,  34,  35,  36,  37,  38,  39,  40,  41,  42,  43,  44,
+     45,  46,  47,  48,  49,  50,  51,  52,  53,  54,  55,  56,  57,  58,  59,
+     60,  61,  62,  63,  64,  97,  98,  99, 100, 101, 102, 103, 104, 105, 106,
+    107, 108, 109, 110, 111, 112, 113, 114, 115, 116, 117, 118, 119, 120, 121,
+    122,  91,  92,  93,  94,  95,  96,  97,  98,  99, 100, 101, 102, 103, 104,
+    105, 106, 107, 108, 109, 110, 111, 112, 113, 114, 115, 116, 117, 118, 119,
+    120, 121, 122, 123, 124, 125, 126, 127, 128, 129, 130, 131, 132, 133, 134,
+    135, 136, 137, 138, 139, 140, 141, 142, 143, 144, 145, 146, 147, 148, 149,
+    150, 151, 152, 153, 154, 155, 156, 157, 158, 159, 160, 161, 162, 163, 164,
+    165, 166, 167, 168, 169, 170, 171, 172, 173, 174, 175, 176, 177, 178, 179,
+    180, 181, 182, 183, 184, 185, 186, 187, 188, 189, 190, 191, 192, 193, 194,
+    195, 196, 197, 198, 199, 200, 201, 202, 203, 204, 205, 206, 207, 208, 209,
+    210, 211, 212, 213, 214, 215, 216, 217, 218, 219, 220, 221, 222, 223, 224,
+    225, 226, 227, 228, 229, 230, 231, 232, 233, 234, 235, 236, 237, 238, 239,
+    240, 241, 242, 243, 244, 245, 246, 247, 248, 249, 250, 251, 252, 253, 254,
+    255
+  };
+#endif
+
+#ifndef GPERF_CASE_STRCMP
+#define GPERF_CASE_STRCMP 1
+static int
+gperf_case_strcmp (register const char *s1, register const char *s2)
+{
+  for (;;)
+    {
+      unsigned char c1 = gperf_downcase[(unsigned char)*s1++];
+      unsigned char c2 = gperf_downcase[(unsigned char)*s2++];
+      if (c1 != 0 && c1 == c2)
+        continue;
+      return (int)c1 - (int)c2;
+    }
+}
+#endif
+
+struct extcmd_key *
+extcmd_get_key (register const char *str, register size_t len)
+{
+  static struct extcmd_key wordlist[] =
+    {
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""},
+#line 121 "extcmd.gperf"
+      {"ENABLE_SVC_NOTIFICATIONS", CMD_ENABLE_SVC_NOTIFICATIONS},
+      {""},
+#line 17 "extcmd.gperf"
+      {"SHUTDOWN_PROCESS", CMD_SHUTDOWN_PROCESS},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+#line 147 "extcmd.gperf"
+      {"CHANGE_SVC_MODATTR", CMD_CHANGE_SVC_MODATTR},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+#line 16 "extcmd.gperf"
+      {"SHUTDOWN_PROGRAM", CMD_SHUTDOWN_PROCESS},
+#line 129 "extcmd.gperf"
+      {"SCHEDULE_SVC_DOWNTIME", CMD_SCHEDULE_SVC_DOWNTIME},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""},
+#line 146 "extcmd.gperf"
+      {"CHANGE_SVC_NOTIFICATION_TIMEPERIOD", CMD_CHANGE_SVC_NOTIFICATION_TIMEPERIOD},
+      {""}, {""},
+#line 116 "extcmd.gperf"
+      {"ENABLE_SVC_CHECK", CMD_ENABLE_SVC_CHECK},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""},
+#line 62 "extcmd.gperf"
+      {"SCHEDULE_HOST_SVC_CHECKS", CMD_SCHEDULE_HOST_SVC_CHECKS},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""},
+#line 70 "extcmd.gperf"
+      {"SCHEDULE_HOST_CHECK", CMD_SCHEDULE_HOST_CHECK},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+#line 26 "extcmd.gperf"
+      {"START_EXECUTING_HOST_CHECKS", CMD_START_EXECUTING_HOST_CHECKS},
+#line 125 "extcmd.gperf"
+      {"ENABLE_SVC_EVENT_HANDLER", CMD_ENABLE_SVC_EVENT_HANDLER},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""},
+#line 22 "extcmd.gperf"
+      {"ENABLE_EVENT_HANDLERS", CMD_ENABLE_EVENT_HANDLERS},
+      {""}, {""}, {""},
+#line 14 "extcmd.gperf"
+      {"ENTER_ACTIVE_MODE", CMD_ENABLE_NOTIFICATIONS},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""},
+#line 31 "extcmd.gperf"
+      {"STOP_ACCEPTING_PASSIVE_HOST_CHECKS", CMD_STOP_ACCEPTING_PASSIVE_HOST_CHECKS},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""},
+#line 49 "extcmd.gperf"
+      {"DELAY_HOST_NOTIFICATION", CMD_DELAY_HOST_NOTIFICATION},
+      {""},
+#line 135 "extcmd.gperf"
+      {"CHANGE_SVC_EVENT_HANDLER", CMD_CHANGE_SVC_EVENT_HANDLER},
+      {""}, {""},
+#line 71 "extcmd.gperf"
+      {"SCHEDULE_FORCED_HOST_CHECK", CMD_SCHEDULE_FORCED_HOST_CHECK},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""},
+#line 28 "extcmd.gperf"
+      {"START_EXECUTING_SVC_CHECKS", CMD_START_EXECUTING_SVC_CHECKS},
+#line 131 "extcmd.gperf"
+      {"ACKNOWLEDGE_SVC_PROBLEM", CMD_ACKNOWLEDGE_SVC_PROBLEM},
+      {""}, {""}, {""},
+#line 73 "extcmd.gperf"
+      {"SCHEDULE_HOST_SVC_DOWNTIME", CMD_SCHEDULE_HOST_SVC_DOWNTIME},
+#line 137 "extcmd.gperf"
+      {"CHANGE_SVC_CHECK_COMMAND", CMD_CHANGE_SVC_CHECK_COMMAND},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""},
+#line 142 "extcmd.gperf"
+      {"CHANGE_SVC_CHECK_TIMEPERIOD", CMD_CHANGE_SVC_CHECK_TIMEPERIOD},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""},
+#line 42 "extcmd.gperf"
+      {"ENABLE_SERVICE_FRESHNESS_CHECKS", CMD_ENABLE_SERVICE_FRESHNESS_CHECKS},
+      {""}, {""}, {""}, {""}, {""}, {""},
+#line 30 "extcmd.gperf"
+      {"START_ACCEPTING_PASSIVE_HOST_CHECKS", CMD_START_ACCEPTING_PASSIVE_HOST_CHECKS},
+#line 115 "extcmd.gperf"
+      {"SCHEDULE_FORCED_SVC_CHECK", CMD_SCHEDULE_FORCED_SVC_CHECK},
+#line 29 "extcmd.gperf"
+      {"STOP_EXECUTING_SVC_CHECKS", CMD_STOP_EXECUTING_SVC_CHECKS},
+      {""}, {""}, {""}, {""}, {""},
+#line 117 "extcmd.gperf"
+      {"DISABLE_SVC_CHECK", CMD_DISABLE_SVC_CHECK},
+      {""}, {""}, {""},
+#line 63 "extcmd.gperf"
+      {"SCHEDULE_FORCED_HOST_SVC_CHECKS", CMD_SCHEDULE_FORCED_HOST_SVC_CHECKS},
+#line 15 "extcmd.gperf"
+      {"ENABLE_NOTIFICATIONS", CMD_ENABLE_NOTIFICATIONS},
+#line 176 "extcmd.gperf"
+      {"PROCESS_FILE", CMD_PROCESS_FILE},
+#line 64 "extcmd.gperf"
+      {"ACKNOWLEDGE_HOST_PROBLEM", CMD_ACKNOWLEDGE_HOST_PROBLEM},
+      {""}, {""},
+#line 171 "extcmd.gperf"
+      {"CHANGE_CONTACT_MODSATTR", CMD_CHANGE_CONTACT_MODSATTR},
+      {""}, {""},
+#line 41 "extcmd.gperf"
+      {"CHANGE_GLOBAL_SVC_EVENT_HANDLER", CMD_CHANGE_GLOBAL_SVC_EVENT_HANDLER},
+      {""}, {""}, {""},
+#line 19 "extcmd.gperf"
+      {"RESTART_PROCESS", CMD_RESTART_PROCESS},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""},
+#line 33 "extcmd.gperf"
+      {"STOP_ACCEPTING_PASSIVE_SVC_CHECKS", CMD_STOP_ACCEPTING_PASSIVE_SVC_CHECKS},
+#line 144 "extcmd.gperf"
+      {"CHANGE_CUSTOM_CONTACT_VAR", CMD_CHANGE_CUSTOM_CONTACT_VAR},
+      {""},
+#line 51 "extcmd.gperf"
+      {"DISABLE_HOST_NOTIFICATIONS", CMD_DISABLE_HOST_NOTIFICATIONS},
+      {""},
+#line 134 "extcmd.gperf"
+      {"STOP_OBSESSING_OVER_SVC", CMD_STOP_OBSESSING_OVER_SVC},
+#line 81 "extcmd.gperf"
+      {"STOP_OBSESSING_OVER_HOST", CMD_STOP_OBSESSING_OVER_HOST},
+      {""}, {""}, {""}, {""}, {""},
+#line 100 "extcmd.gperf"
+      {"DISABLE_HOSTGROUP_SVC_NOTIFICATIONS", CMD_DISABLE_HOSTGROUP_SVC_NOTIFICATIONS},
+      {""},
+#line 114 "extcmd.gperf"
+      {"SCHEDULE_SVC_CHECK", CMD_SCHEDULE_SVC_CHECK},
+      {""}, {""}, {""},
+#line 169 "extcmd.gperf"
+      {"CHANGE_CONTACT_MODATTR", CMD_CHANGE_CONTACT_MODATTR},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""},
+#line 141 "extcmd.gperf"
+      {"SET_SVC_NOTIFICATION_NUMBER", CMD_SET_SVC_NOTIFICATION_NUMBER},
+      {""}, {""}, {""}, {""},
+#line 61 "extcmd.gperf"
+      {"DISABLE_PASSIVE_HOST_CHECKS", CMD_DISABLE_PASSIVE_HOST_CHECKS},
+      {""},
+#line 162 "extcmd.gperf"
+      {"SCHEDULE_SERVICEGROUP_SVC_DOWNTIME", CMD_SCHEDULE_SERVICEGROUP_SVC_DOWNTIME},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""},
+#line 93 "extcmd.gperf"
+      {"SEND_CUSTOM_HOST_NOTIFICATION", CMD_SEND_CUSTOM_HOST_NOTIFICATION},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""},
+#line 75 "extcmd.gperf"
+      {"DEL_DOWNTIME_BY_HOST_NAME", CMD_DEL_DOWNTIME_BY_HOST_NAME},
+      {""}, {""}, {""}, {""}, {""}, {""},
+#line 68 "extcmd.gperf"
+      {"ENABLE_HOST_CHECK", CMD_ENABLE_HOST_CHECK},
+      {""}, {""},
+#line 20 "extcmd.gperf"
+      {"SAVE_STATE_INFORMATION", CMD_SAVE_STATE_INFORMATION},
+#line 89 "extcmd.gperf"
+      {"SCHEDULE_AND_PROPAGATE_HOST_DOWNTIME", CMD_SCHEDULE_AND_PROPAGATE_HOST_DOWNTIME},
+      {""}, {""}, {""}, {""},
+#line 145 "extcmd.gperf"
+      {"SEND_CUSTOM_SVC_NOTIFICATION", CMD_SEND_CUSTOM_SVC_NOTIFICATION},
+      {""}, {""}, {""},
+#line 52 "extcmd.gperf"
+      {"ENABLE_ALL_NOTIFICATIONS_BEYOND_HOST", CMD_ENABLE_ALL_NOTIFICATIONS_BEYOND_HOST},
+#line 88 "extcmd.gperf"
+      {"SCHEDULE_AND_PROPAGATE_TRIGGERED_HOST_DOWNTIME", CMD_SCHEDULE_AND_PROPAGATE_TRIGGERED_HOST_DOWNTIME},
+      {""}, {""}, {""},
+#line 13 "extcmd.gperf"
+      {"DISABLE_NOTIFICATIONS", CMD_DISABLE_NOTIFICATIONS},
+#line 119 "extcmd.gperf"
+      {"DISABLE_PASSIVE_SVC_CHECKS", CMD_DISABLE_PASSIVE_SVC_CHECKS},
+      {""}, {""}, {""},
+#line 24 "extcmd.gperf"
+      {"ENABLE_PERFORMANCE_DATA", CMD_ENABLE_PERFORMANCE_DATA},
+      {""}, {""},
+#line 138 "extcmd.gperf"
+      {"CHANGE_NORMAL_SVC_CHECK_INTERVAL", CMD_CHANGE_NORMAL_SVC_CHECK_INTERVAL},
+#line 74 "extcmd.gperf"
+      {"DEL_HOST_DOWNTIME", CMD_DEL_HOST_DOWNTIME},
+      {""},
+#line 48 "extcmd.gperf"
+      {"DEL_ALL_HOST_COMMENTS", CMD_DEL_ALL_HOST_COMMENTS},
+#line 106 "extcmd.gperf"
+      {"DISABLE_HOSTGROUP_SVC_CHECKS", CMD_DISABLE_HOSTGROUP_SVC_CHECKS},
+      {""},
+#line 46 "extcmd.gperf"
+      {"ADD_HOST_COMMENT", CMD_ADD_HOST_COMMENT},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""},
+#line 111 "extcmd.gperf"
+      {"ADD_SVC_COMMENT", CMD_ADD_SVC_COMMENT},
+      {""}, {""},
+#line 35 "extcmd.gperf"
+      {"STOP_OBSESSING_OVER_HOST_CHECKS", CMD_STOP_OBSESSING_OVER_HOST_CHECKS},
+      {""},
+#line 133 "extcmd.gperf"
+      {"START_OBSESSING_OVER_SVC", CMD_START_OBSESSING_OVER_SVC},
+#line 80 "extcmd.gperf"
+      {"START_OBSESSING_OVER_HOST", CMD_START_OBSESSING_OVER_HOST},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+#line 143 "extcmd.gperf"
+      {"CHANGE_CUSTOM_SVC_VAR", CMD_CHANGE_CUSTOM_SVC_VAR},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+#line 128 "extcmd.gperf"
+      {"DISABLE_SVC_FLAP_DETECTION", CMD_DISABLE_SVC_FLAP_DETECTION},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""},
+#line 151 "extcmd.gperf"
+      {"ENABLE_SERVICEGROUP_SVC_NOTIFICATIONS", CMD_ENABLE_SERVICEGROUP_SVC_NOTIFICATIONS},
+#line 38 "extcmd.gperf"
+      {"ENABLE_FLAP_DETECTION", CMD_ENABLE_FLAP_DETECTION},
+      {""}, {""},
+#line 109 "extcmd.gperf"
+      {"SCHEDULE_HOSTGROUP_HOST_DOWNTIME", CMD_SCHEDULE_HOSTGROUP_HOST_DOWNTIME},
+      {""}, {""}, {""}, {""}, {""}, {""},
+#line 32 "extcmd.gperf"
+      {"START_ACCEPTING_PASSIVE_SVC_CHECKS", CMD_START_ACCEPTING_PASSIVE_SVC_CHECKS},
+      {""}, {""}, {""}, {""},
+#line 27 "extcmd.gperf"
+      {"STOP_EXECUTING_HOST_CHECKS", CMD_STOP_EXECUTING_HOST_CHECKS},
+      {""}, {""}, {""}, {""},
+#line 96 "extcmd.gperf"
+      {"CLEAR_HOST_FLAPPING_STATE", CMD_CLEAR_HOST_FLAPPING_STATE},
+      {""},
+#line 153 "extcmd.gperf"
+      {"ENABLE_SERVICEGROUP_HOST_CHECKS", CMD_ENABLE_SERVICEGROUP_HOST_CHECKS},
+      {""}, {""},
+#line 72 "extcmd.gperf"
+      {"SCHEDULE_HOST_DOWNTIME", CMD_SCHEDULE_HOST_DOWNTIME},
+      {""}, {""},
+#line 54 "extcmd.gperf"
+      {"ENABLE_HOST_AND_CHILD_NOTIFICATIONS", CMD_ENABLE_HOST_AND_CHILD_NOTIFICATIONS},
+#line 77 "extcmd.gperf"
+      {"DEL_DOWNTIME_BY_START_TIME_COMMENT", CMD_DEL_DOWNTIME_BY_START_TIME_COMMENT},
+      {""}, {""},
+#line 165 "extcmd.gperf"
+      {"ENABLE_CONTACT_SVC_NOTIFICATIONS", CMD_ENABLE_CONTACT_SVC_NOTIFICATIONS},
+#line 43 "extcmd.gperf"
+      {"DISABLE_SERVICE_FRESHNESS_CHECKS", CMD_DISABLE_SERVICE_FRESHNESS_CHECKS},
+      {""}, {""},
+#line 58 "extcmd.gperf"
+      {"ENABLE_HOST_SVC_CHECKS", CMD_ENABLE_HOST_SVC_CHECKS},
+#line 118 "extcmd.gperf"
+      {"ENABLE_PASSIVE_SVC_CHECKS", CMD_ENABLE_PASSIVE_SVC_CHECKS},
+      {""}, {""},
+#line 149 "extcmd.gperf"
+      {"ENABLE_SERVICEGROUP_HOST_NOTIFICATIONS", CMD_ENABLE_SERVICEGROUP_HOST_NOTIFICATIONS},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+#line 76 "extcmd.gperf"
+      {"DEL_DOWNTIME_BY_HOSTGROUP_NAME", CMD_DEL_DOWNTIME_BY_HOSTGROUP_NAME},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""},
+#line 69 "extcmd.gperf"
+      {"DISABLE_HOST_CHECK", CMD_DISABLE_HOST_CHECK},
+      {""}, {""}, {""},
+#line 47 "extcmd.gperf"
+      {"DEL_HOST_COMMENT", CMD_DEL_HOST_COMMENT},
+      {""}, {""}, {""},
+#line 130 "extcmd.gperf"
+      {"DEL_SVC_DOWNTIME", CMD_DEL_SVC_DOWNTIME},
+      {""}, {""}, {""},
+#line 112 "extcmd.gperf"
+      {"DEL_SVC_COMMENT", CMD_DEL_SVC_COMMENT},
+      {""}, {""}, {""}, {""}, {""},
+#line 84 "extcmd.gperf"
+      {"CHANGE_HOST_CHECK_COMMAND", CMD_CHANGE_HOST_CHECK_COMMAND},
+#line 161 "extcmd.gperf"
+      {"SCHEDULE_SERVICEGROUP_HOST_DOWNTIME", CMD_SCHEDULE_SERVICEGROUP_HOST_DOWNTIME},
+      {""},
+#line 168 "extcmd.gperf"
+      {"CHANGE_CONTACT_SVC_NOTIFICATION_TIMEPERIOD", CMD_CHANGE_CONTACT_SVC_NOTIFICATION_TIMEPERIOD},
+      {""}, {""},
+#line 36 "extcmd.gperf"
+      {"START_OBSESSING_OVER_SVC_CHECKS", CMD_START_OBSESSING_OVER_SVC_CHECKS},
+      {""}, {""}, {""},
+#line 136 "extcmd.gperf"
+      {"CHANGE_SVC_EVENT_HANDLER_TIMEPERIOD", CMD_CHANGE_SVC_EVENT_HANDLER_TIMEPERIOD},
+      {""}, {""},
+#line 78 "extcmd.gperf"
+      {"ENABLE_HOST_FLAP_DETECTION", CMD_ENABLE_HOST_FLAP_DETECTION},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""},
+#line 174 "extcmd.gperf"
+      {"ENABLE_CONTACTGROUP_SVC_NOTIFICATIONS", CMD_ENABLE_CONTACTGROUP_SVC_NOTIFICATIONS},
+      {""},
+#line 34 "extcmd.gperf"
+      {"START_OBSESSING_OVER_HOST_CHECKS", CMD_START_OBSESSING_OVER_HOST_CHECKS},
+      {""}, {""}, {""}, {""},
+#line 127 "extcmd.gperf"
+      {"ENABLE_SVC_FLAP_DETECTION", CMD_ENABLE_SVC_FLAP_DETECTION},
+      {""}, {""},
+#line 44 "extcmd.gperf"
+      {"ENABLE_HOST_FRESHNESS_CHECKS", CMD_ENABLE_HOST_FRESHNESS_CHECKS},
+#line 90 "extcmd.gperf"
+      {"SET_HOST_NOTIFICATION_NUMBER", CMD_SET_HOST_NOTIFICATION_NUMBER},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""},
+#line 163 "extcmd.gperf"
+      {"ENABLE_CONTACT_HOST_NOTIFICATIONS", CMD_ENABLE_CONTACT_HOST_NOTIFICATIONS},
+      {""}, {""}, {""}, {""}, {""}, {""},
+#line 92 "extcmd.gperf"
+      {"CHANGE_CUSTOM_HOST_VAR", CMD_CHANGE_CUSTOM_HOST_VAR},
+#line 170 "extcmd.gperf"
+      {"CHANGE_CONTACT_MODHATTR", CMD_CHANGE_CONTACT_MODHATTR},
+      {""},
+#line 86 "extcmd.gperf"
+      {"CHANGE_RETRY_HOST_CHECK_INTERVAL", CMD_CHANGE_RETRY_HOST_CHECK_INTERVAL},
+#line 126 "extcmd.gperf"
+      {"DISABLE_SVC_EVENT_HANDLER", CMD_DISABLE_SVC_EVENT_HANDLER},
+      {""}, {""}, {""}, {""}, {""}, {""},
+#line 172 "extcmd.gperf"
+      {"ENABLE_CONTACTGROUP_HOST_NOTIFICATIONS", CMD_ENABLE_CONTACTGROUP_HOST_NOTIFICATIONS},
+      {""},
+#line 25 "extcmd.gperf"
+      {"DISABLE_PERFORMANCE_DATA", CMD_DISABLE_PERFORMANCE_DATA},
+      {""}, {""},
+#line 39 "extcmd.gperf"
+      {"DISABLE_FLAP_DETECTION", CMD_DISABLE_FLAP_DETECTION},
+      {""},
+#line 18 "extcmd.gperf"
+      {"RESTART_PROGRAM", CMD_RESTART_PROCESS},
+      {""},
+#line 21 "extcmd.gperf"
+      {"READ_STATE_INFORMATION", CMD_READ_STATE_INFORMATION},
+      {""}, {""}, {""}, {""}, {""}, {""},
+#line 85 "extcmd.gperf"
+      {"CHANGE_NORMAL_HOST_CHECK_INTERVAL", CMD_CHANGE_NORMAL_HOST_CHECK_INTERVAL},
+      {""}, {""}, {""}, {""}, {""},
+#line 37 "extcmd.gperf"
+      {"STOP_OBSESSING_OVER_SVC_CHECKS", CMD_STOP_OBSESSING_OVER_SVC_CHECKS},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""},
+#line 167 "extcmd.gperf"
+      {"CHANGE_CONTACT_HOST_NOTIFICATION_TIMEPERIOD", CMD_CHANGE_CONTACT_HOST_NOTIFICATION_TIMEPERIOD},
+#line 160 "extcmd.gperf"
+      {"DISABLE_SERVICEGROUP_PASSIVE_SVC_CHECKS", CMD_DISABLE_SERVICEGROUP_PASSIVE_SVC_CHECKS},
+#line 156 "extcmd.gperf"
+      {"DISABLE_SERVICEGROUP_PASSIVE_HOST_CHECKS", CMD_DISABLE_SERVICEGROUP_PASSIVE_HOST_CHECKS},
+      {""}, {""}, {""}, {""}, {""}, {""},
+#line 45 "extcmd.gperf"
+      {"DISABLE_HOST_FRESHNESS_CHECKS", CMD_DISABLE_HOST_FRESHNESS_CHECKS},
+#line 79 "extcmd.gperf"
+      {"DISABLE_HOST_FLAP_DETECTION", CMD_DISABLE_HOST_FLAP_DETECTION},
+      {""}, {""}, {""},
+#line 12 "extcmd.gperf"
+      {"ENTER_STANDBY_MODE", CMD_DISABLE_NOTIFICATIONS},
+      {""},
+#line 122 "extcmd.gperf"
+      {"DISABLE_SVC_NOTIFICATIONS", CMD_DISABLE_SVC_NOTIFICATIONS},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""},
+#line 159 "extcmd.gperf"
+      {"ENABLE_SERVICEGROUP_PASSIVE_SVC_CHECKS", CMD_ENABLE_SERVICEGROUP_PASSIVE_SVC_CHECKS},
+#line 155 "extcmd.gperf"
+      {"ENABLE_SERVICEGROUP_PASSIVE_HOST_CHECKS", CMD_ENABLE_SERVICEGROUP_PASSIVE_HOST_CHECKS},
+      {""},
+#line 166 "extcmd.gperf"
+      {"DISABLE_CONTACT_SVC_NOTIFICATIONS", CMD_DISABLE_CONTACT_SVC_NOTIFICATIONS},
+      {""},
+#line 108 "extcmd.gperf"
+      {"DISABLE_HOSTGROUP_PASSIVE_SVC_CHECKS", CMD_DISABLE_HOSTGROUP_PASSIVE_SVC_CHECKS},
+#line 104 "extcmd.gperf"
+      {"DISABLE_HOSTGROUP_PASSIVE_HOST_CHECKS", CMD_DISABLE_HOSTGROUP_PASSIVE_HOST_CHECKS},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""},
+#line 164 "extcmd.gperf"
+      {"DISABLE_CONTACT_HOST_NOTIFICATIONS", CMD_DISABLE_CONTACT_HOST_NOTIFICATIONS},
+#line 102 "extcmd.gperf"
+      {"DISABLE_HOSTGROUP_HOST_CHECKS", CMD_DISABLE_HOSTGROUP_HOST_CHECKS},
+      {""},
+#line 157 "extcmd.gperf"
+      {"ENABLE_SERVICEGROUP_SVC_CHECKS", CMD_ENABLE_SERVICEGROUP_SVC_CHECKS},
+      {""}, {""},
+#line 148 "extcmd.gperf"
+      {"CLEAR_SVC_FLAPPING_STATE", CMD_CLEAR_SVC_FLAPPING_STATE},
+#line 110 "extcmd.gperf"
+      {"SCHEDULE_HOSTGROUP_SVC_DOWNTIME", CMD_SCHEDULE_HOSTGROUP_SVC_DOWNTIME},
+      {""}, {""}, {""}, {""}, {""}, {""},
+#line 132 "extcmd.gperf"
+      {"REMOVE_SVC_ACKNOWLEDGEMENT", CMD_REMOVE_SVC_ACKNOWLEDGEMENT},
+      {""}, {""}, {""}, {""}, {""},
+#line 60 "extcmd.gperf"
+      {"ENABLE_PASSIVE_HOST_CHECKS", CMD_ENABLE_PASSIVE_HOST_CHECKS},
+#line 66 "extcmd.gperf"
+      {"ENABLE_HOST_EVENT_HANDLER", CMD_ENABLE_HOST_EVENT_HANDLER},
+      {""}, {""},
+#line 107 "extcmd.gperf"
+      {"ENABLE_HOSTGROUP_PASSIVE_SVC_CHECKS", CMD_ENABLE_HOSTGROUP_PASSIVE_SVC_CHECKS},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""},
+#line 23 "extcmd.gperf"
+      {"DISABLE_EVENT_HANDLERS", CMD_DISABLE_EVENT_HANDLERS},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+#line 158 "extcmd.gperf"
+      {"DISABLE_SERVICEGROUP_SVC_CHECKS", CMD_DISABLE_SERVICEGROUP_SVC_CHECKS},
+      {""},
+#line 95 "extcmd.gperf"
+      {"CHANGE_HOST_MODATTR", CMD_CHANGE_HOST_MODATTR},
+      {""}, {""}, {""},
+#line 124 "extcmd.gperf"
+      {"PROCESS_HOST_CHECK_RESULT", CMD_PROCESS_HOST_CHECK_RESULT},
+      {""},
+#line 82 "extcmd.gperf"
+      {"CHANGE_HOST_EVENT_HANDLER", CMD_CHANGE_HOST_EVENT_HANDLER},
+      {""}, {""}, {""}, {""},
+#line 97 "extcmd.gperf"
+      {"ENABLE_HOSTGROUP_HOST_NOTIFICATIONS", CMD_ENABLE_HOSTGROUP_HOST_NOTIFICATIONS},
+      {""}, {""}, {""}, {""},
+#line 152 "extcmd.gperf"
+      {"DISABLE_SERVICEGROUP_SVC_NOTIFICATIONS", CMD_DISABLE_SERVICEGROUP_SVC_NOTIFICATIONS},
+      {""}, {""},
+#line 154 "extcmd.gperf"
+      {"DISABLE_SERVICEGROUP_HOST_CHECKS", CMD_DISABLE_SERVICEGROUP_HOST_CHECKS},
+      {""},
+#line 50 "extcmd.gperf"
+      {"ENABLE_HOST_NOTIFICATIONS", CMD_ENABLE_HOST_NOTIFICATIONS},
+      {""}, {""}, {""}, {""},
+#line 150 "extcmd.gperf"
+      {"DISABLE_SERVICEGROUP_HOST_NOTIFICATIONS", CMD_DISABLE_SERVICEGROUP_HOST_NOTIFICATIONS},
+      {""}, {""},
+#line 91 "extcmd.gperf"
+      {"CHANGE_HOST_CHECK_TIMEPERIOD", CMD_CHANGE_HOST_CHECK_TIMEPERIOD},
+#line 56 "extcmd.gperf"
+      {"ENABLE_HOST_SVC_NOTIFICATIONS", CMD_ENABLE_HOST_SVC_NOTIFICATIONS},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""},
+#line 123 "extcmd.gperf"
+      {"PROCESS_SERVICE_CHECK_RESULT", CMD_PROCESS_SERVICE_CHECK_RESULT},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""},
+#line 53 "extcmd.gperf"
+      {"DISABLE_ALL_NOTIFICATIONS_BEYOND_HOST", CMD_DISABLE_ALL_NOTIFICATIONS_BEYOND_HOST},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""},
+#line 59 "extcmd.gperf"
+      {"DISABLE_HOST_SVC_CHECKS", CMD_DISABLE_HOST_SVC_CHECKS},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+#line 120 "extcmd.gperf"
+      {"DELAY_SVC_NOTIFICATION", CMD_DELAY_SVC_NOTIFICATION},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""},
+#line 87 "extcmd.gperf"
+      {"CHANGE_MAX_HOST_CHECK_ATTEMPTS", CMD_CHANGE_MAX_HOST_CHECK_ATTEMPTS},
+#line 101 "extcmd.gperf"
+      {"ENABLE_HOSTGROUP_HOST_CHECKS", CMD_ENABLE_HOSTGROUP_HOST_CHECKS},
+      {""}, {""}, {""}, {""}, {""}, {""},
+#line 65 "extcmd.gperf"
+      {"REMOVE_HOST_ACKNOWLEDGEMENT", CMD_REMOVE_HOST_ACKNOWLEDGEMENT},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+#line 113 "extcmd.gperf"
+      {"DEL_ALL_SVC_COMMENTS", CMD_DEL_ALL_SVC_COMMENTS},
+      {""},
+#line 67 "extcmd.gperf"
+      {"DISABLE_HOST_EVENT_HANDLER", CMD_DISABLE_HOST_EVENT_HANDLER},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""},
+#line 83 "extcmd.gperf"
+      {"CHANGE_HOST_EVENT_HANDLER_TIMEPERIOD", CMD_CHANGE_HOST_EVENT_HANDLER_TIMEPERIOD},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""},
+#line 57 "extcmd.gperf"
+      {"DISABLE_HOST_SVC_NOTIFICATIONS", CMD_DISABLE_HOST_SVC_NOTIFICATIONS},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""},
+#line 40 "extcmd.gperf"
+      {"CHANGE_GLOBAL_HOST_EVENT_HANDLER", CMD_CHANGE_GLOBAL_HOST_EVENT_HANDLER},
+      {""}, {""},
+#line 140 "extcmd.gperf"
+      {"CHANGE_MAX_SVC_CHECK_ATTEMPTS", CMD_CHANGE_MAX_SVC_CHECK_ATTEMPTS},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""},
+#line 98 "extcmd.gperf"
+      {"DISABLE_HOSTGROUP_HOST_NOTIFICATIONS", CMD_DISABLE_HOSTGROUP_HOST_NOTIFICATIONS},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""},
+#line 105 "extcmd.gperf"
+      {"ENABLE_HOSTGROUP_SVC_CHECKS", CMD_ENABLE_HOSTGROUP_SVC_CHECKS},
+      {""}, {""}, {""}, {""}, {""},
+#line 55 "extcmd.gperf"
+      {"DISABLE_HOST_AND_CHILD_NOTIFICATIONS", CMD_DISABLE_HOST_AND_CHILD_NOTIFICATIONS},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""},
+#line 175 "extcmd.gperf"
+      {"DISABLE_CONTACTGROUP_SVC_NOTIFICATIONS", CMD_DISABLE_CONTACTGROUP_SVC_NOTIFICATIONS},
+      {""}, {""}, {""}, {""}, {""},
+#line 103 "extcmd.gperf"
+      {"ENABLE_HOSTGROUP_PASSIVE_HOST_CHECKS", CMD_ENABLE_HOSTGROUP_PASSIVE_HOST_CHECKS},
+      {""}, {""}, {""},
+#line 173 "extcmd.gperf"
+      {"DISABLE_CONTACTGROUP_HOST_NOTIFICATIONS", CMD_DISABLE_CONTACTGROUP_HOST_NOTIFICATIONS},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""},
+#line 99 "extcmd.gperf"
+      {"ENABLE_HOSTGROUP_SVC_NOTIFICATIONS", CMD_ENABLE_HOSTGROUP_SVC_NOTIFICATIONS},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+#line 94 "extcmd.gperf"
+      {"CHANGE_HOST_NOTIFICATION_TIMEPERIOD", CMD_CHANGE_HOST_NOTIFICATION_TIMEPERIOD},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""},
+#line 139 "extcmd.gperf"
+      {"CHANGE_RETRY_SVC_CHECK_INTERVAL", CMD_CHANGE_RETRY_SVC_CHECK_INTERVAL}
+    };
+
+  if (len <= MAX_WORD_LENGTH && len >= MIN_WORD_LENGTH)
+    {
+      register unsigned int key = extcmd_key_phash (str, len);
+
+      if (key <= MAX_HASH_VALUE)
+        {
+          register const char *s = wordlist[key].name;
+
+          if ((((unsigned char)*str ^ (unsigned char)*s) & ~32) == 0 && !gperf_case_strcmp (str, s))
+            return &wordlist[key];
+        }
+    }
+  return 0;
+}
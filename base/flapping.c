@@ -482,6 +482,7 @@ void clear_host_flap(host *hst, double percent_change, double high_threshold, do
 /* enables flap detection on a program wide basis */
 void enable_flap_detection_routines(void) {
 	unsigned int i;
+	int is_flapping;
 	unsigned long attr = MODATTR_FLAP_DETECTION_ENABLED;
 
 	log_debug_info(DEBUGL_FUNCTIONS, 0, "enable_flap_detection_routines()\n");
@@ -506,10 +507,18 @@ void enable_flap_detection_routines(void) {
 	update_program_status(FALSE);
 
 	/* check for flapping */
-	for(i = 0; i < num_objects.hosts; i++)
+	for(i = 0; i < num_objects.hosts; i++) {
+		is_flapping = host_ary[i]->is_flapping;
 		check_for_host_flapping(host_ary[i], FALSE, FALSE, TRUE);
-	for(i = 0; i < num_objects.services; i++)
+		if(host_ary[i]->is_flapping != is_flapping)
+			update_host_status(host_ary[i], FALSE);
+		}
+	for(i = 0; i < num_objects.services; i++) {
+		is_flapping = service_ary[i]->is_flapping;
 		check_for_service_flapping(service_ary[i], FALSE, TRUE);
+		if(service_ary[i]->is_flapping != is_flapping)
+			update_service_status(service_ary[i], FALSE);
+		}
 
 	}
 
@@ -27,11 +27,20 @@
 #include "../include/nagios.h"
 #include "../include/broker.h"
 #include <fcntl.h>
+#include <pthread.h>
 
 
 static FILE *debug_file_fp;
 static FILE *log_fp;
 
+static int log_thread_active(void);
+static int queue_log_record(int what, time_t timestamp, const char *msg);
+
+/* what a queued log record is for */
+#define LOGREC_FILE    1
+#define LOGREC_SYSLOG  2
+#define LOGREC_ROTATE  4
+
 /******************************************************************/
 /************************ LOGGING FUNCTIONS ***********************/
 /******************************************************************/
@@ -110,42 +119,52 @@ static void write_to_all_logs_with_timestamp(char *buffer, unsigned long data_ty
 	}
 
 
-static FILE *open_log_file(void)
+/* opens the main log file for appending, making sure it's a plain file */
+static int open_log_fd(void)
 {
 	int fh;
 	struct stat st;
 
-	if(log_fp) /* keep it open unless we rotate */
-		return log_fp;
-
 	if ((fh = open(log_file, O_RDWR|O_APPEND|O_CREAT|O_NOFOLLOW, S_IRUSR|S_IWUSR|S_IRGRP|S_IROTH)) == -1) {
 		if (daemon_mode == FALSE)
 			printf("Warning: Cannot open log file '%s' for writing\n", log_file);
-		return NULL;
+		return -1;
 	}
-	log_fp = fdopen(fh, "a+");
-	if(log_fp == NULL) {
-		if (daemon_mode == FALSE)
-			printf("Warning: Cannot open log file '%s' for writing\n", log_file);
-		return NULL;
-		}
 
 	if ((fstat(fh, &st)) == -1) {
-		log_fp = NULL;
 		close(fh);
 		if (daemon_mode == FALSE)
 			printf("Warning: Cannot fstat log file '%s'\n", log_file);
-		return NULL;
+		return -1;
 	}
 	if (st.st_nlink != 1 || (st.st_mode & S_IFMT) != S_IFREG) {
-		log_fp = NULL;
 		close(fh);
 		if (daemon_mode == FALSE)
 			printf("Warning: log file '%s' has an invalid mode\n", log_file);
-		return NULL;
+		return -1;
 	}
 
-	(void)fcntl(fileno(log_fp), F_SETFD, FD_CLOEXEC);
+	(void)fcntl(fh, F_SETFD, FD_CLOEXEC);
+	return fh;
+}
+
+static FILE *open_log_file(void)
+{
+	int fh;
+
+	if(log_fp) /* keep it open unless we rotate */
+		return log_fp;
+
+	if ((fh = open_log_fd()) == -1)
+		return NULL;
+	log_fp = fdopen(fh, "a+");
+	if(log_fp == NULL) {
+		close(fh);
+		if (daemon_mode == FALSE)
+			printf("Warning: Cannot open log file '%s' for writing\n", log_file);
+		return NULL;
+		}
+
 	return log_fp;
 }
 
@@ -168,6 +187,8 @@ int fix_log_file_owner(uid_t uid, gid_t gid)
 
 int close_log_file(void)
 {
+	stop_log_thread();
+
 	if(!log_fp)
 		return 0;
 
@@ -193,9 +214,11 @@ int write_to_log(char *buffer, unsigned long data_type, time_t *timestamp) {
 	if(!(data_type & logging_options))
 		return OK;
 
-	fp = open_log_file();
-	if (fp == NULL)
+	if(log_thread_active())
+		fp = NULL;
+	else if((fp = open_log_file()) == NULL)
 		return ERROR;
+
 	/* what timestamp should we use? */
 	if(timestamp == NULL)
 		time(&log_time);
@@ -206,8 +229,12 @@ int write_to_log(char *buffer, unsigned long data_type, time_t *timestamp) {
 	strip(buffer);
 
 	/* write the buffer to the log file */
-	fprintf(fp, "[%llu] %s\n", (unsigned long long)log_time, buffer);
-	fflush(fp);
+	if(fp == NULL)
+		queue_log_record(LOGREC_FILE, log_time, buffer);
+	else {
+		fprintf(fp, "[%llu] %s\n", (unsigned long long)log_time, buffer);
+		fflush(fp);
+		}
 
 #ifdef USE_EVENT_BROKER
 	/* send data to the event broker */
@@ -237,7 +264,10 @@ int write_to_syslog(char *buffer, unsigned long data_type) {
 		return OK;
 
 	/* write the buffer to the syslog facility */
-	syslog(LOG_USER | LOG_INFO, "%s", buffer);
+	if(log_thread_active())
+		queue_log_record(LOGREC_SYSLOG, 0, buffer);
+	else
+		syslog(LOG_USER | LOG_INFO, "%s", buffer);
 
 	return OK;
 	}
@@ -401,10 +431,6 @@ int rotate_log_file(time_t rotation_time) {
 
 	t = localtime_r(&rotation_time, &tm_s);
 
-	stat_result = stat(log_file, &log_file_stat);
-
-	close_log_file();
-
 	/* get the archived filename to use */
 	asprintf(&log_archive, "%s%snagios-%02d-%02d-%d-%02d.log", log_archive_path, (log_archive_path[strlen(log_archive_path) - 1] == '/') ? "" : "/", t->tm_mon + 1, t->tm_mday, t->tm_year + 1900, t->tm_hour);
 
@@ -415,18 +441,31 @@ int rotate_log_file(time_t rotation_time) {
 	archive_stat_result = stat(log_archive, &archive_stat);
 	if((0 == archive_stat_result) || 
 			((-1 == archive_stat_result) && (ENOENT != errno))) {
+		my_free(log_archive);
 		return OK;
 	}
 
-	/* rotate the log file */
-	rename_result = my_rename(log_file, log_archive);
-	log_fp = open_log_file();
-	if (log_fp == NULL)
-		return ERROR;
+	/* the log thread rotates once it has written what's queued before this */
+	if(log_thread_active())
+		queue_log_record(LOGREC_ROTATE, rotation_time, log_archive);
 
-	if(rename_result) {
-		my_free(log_archive);
-		return ERROR;
+	else {
+		stat_result = stat(log_file, &log_file_stat);
+
+		close_log_file();
+
+		/* rotate the log file */
+		rename_result = my_rename(log_file, log_archive);
+		log_fp = open_log_file();
+		if (log_fp == NULL) {
+			my_free(log_archive);
+			return ERROR;
+			}
+
+		if(rename_result) {
+			my_free(log_archive);
+			return ERROR;
+			}
 		}
 
 	/* record the log rotation after it has been done... */
@@ -468,6 +507,393 @@ int write_log_file_info(time_t *timestamp) {
 	}
 
 
+/******************************************************************/
+/*************************** LOG THREAD ***************************/
+/******************************************************************/
+
+/*
+ * With use_log_thread set, write_to_log() and write_to_syslog() queue
+ * their messages in a lock-free ring rather than writing them, and a
+ * thread writes everything that's piled up since it last woke up with
+ * a single write(). Rotations go through the ring too, so whatever was
+ * logged before a rotation ends up in the archive and whatever was
+ * logged after it in the new file. NEB modules still get the log data
+ * from the thread that logged it.
+ */
+struct log_record {
+	time_t timestamp;
+	int what;
+	char msg[]; /* the archive path for rotations */
+	};
+
+#define LOG_BATCH_SIZE (64 * 1024)
+
+static struct {
+	mpscring *ring;
+	pthread_t thread;
+	pid_t pid;                 /* the process that owns the thread */
+	int running;
+	volatile int stopping;
+	volatile int sleeping;
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	int fd;
+	char *batch;
+	size_t batch_size;
+	size_t batch_len;
+	int dirty;                 /* written since the last fsync */
+	time_t last_fsync;
+	/* updated by the threads that log */
+	unsigned long queued;
+	unsigned long dropped;
+	unsigned long blocked;
+	unsigned long truncated;
+	unsigned long max_used;
+	/* updated by the log thread */
+	unsigned long written;
+	unsigned long batches;
+	unsigned long long bytes;
+	unsigned long fsyncs;
+	unsigned long rotations;
+	unsigned long write_errors;
+	unsigned long dropped_reported;
+	} log_thread = { .fd = -1 };
+
+
+/* should this thread queue its messages for the log thread? */
+static int log_thread_active(void) {
+
+	if(log_thread.running == FALSE)
+		return FALSE;
+
+	/* forked children have the ring, but nobody to empty it */
+	if(log_thread.pid != getpid())
+		return FALSE;
+
+	/* the log thread logs its own errors directly */
+	return !pthread_equal(pthread_self(), log_thread.thread);
+	}
+
+
+static void wake_log_thread(void) {
+
+	/* pairs with the barrier in log_thread_main() before it sleeps */
+	__sync_synchronize();
+	if(log_thread.sleeping) {
+		pthread_mutex_lock(&log_thread.lock);
+		pthread_cond_signal(&log_thread.cond);
+		pthread_mutex_unlock(&log_thread.lock);
+		}
+	}
+
+
+static int queue_log_record(int what, time_t timestamp, const char *msg) {
+	struct log_record *rec;
+	size_t len = strlen(msg);
+	unsigned long used;
+	int waited = FALSE;
+
+	/* a single message may take up at most a quarter of the ring */
+	if(sizeof(*rec) + len + 1 > mpscring_size(log_thread.ring) / 4) {
+		len = mpscring_size(log_thread.ring) / 4 - sizeof(*rec) - 1;
+		__sync_fetch_and_add(&log_thread.truncated, 1);
+		}
+
+	while((rec = mpscring_reserve(log_thread.ring, sizeof(*rec) + len + 1)) == NULL) {
+
+		/* rotations are never dropped, or the wrong messages get archived */
+		if(log_overflow_policy == LOG_OVERFLOW_DROP && what != LOGREC_ROTATE) {
+			__sync_fetch_and_add(&log_thread.dropped, 1);
+			return ERROR;
+			}
+
+		if(waited == FALSE) {
+			__sync_fetch_and_add(&log_thread.blocked, 1);
+			waited = TRUE;
+			}
+		wake_log_thread();
+		usleep(1000);
+		}
+
+	rec->timestamp = timestamp;
+	rec->what = what;
+	memcpy(rec->msg, msg, len);
+	rec->msg[len] = 0;
+	mpscring_commit(log_thread.ring, rec);
+
+	__sync_fetch_and_add(&log_thread.queued, 1);
+	if((used = mpscring_used(log_thread.ring)) > log_thread.max_used)
+		log_thread.max_used = used;
+
+	wake_log_thread();
+
+	return OK;
+	}
+
+
+/* writes out the current batch in one go */
+static void flush_log_batch(void) {
+	size_t done = 0;
+	ssize_t ret;
+
+	if(log_thread.batch_len == 0)
+		return;
+
+	/* try to get the log file back if a rotation failed to reopen it */
+	if(log_thread.fd < 0 && (log_thread.fd = open_log_fd()) < 0) {
+		log_thread.write_errors++;
+		log_thread.batch_len = 0;
+		return;
+		}
+
+	while(done < log_thread.batch_len) {
+		ret = write(log_thread.fd, log_thread.batch + done, log_thread.batch_len - done);
+		if(ret < 0) {
+			if(errno == EINTR)
+				continue;
+			log_thread.write_errors++;
+			break;
+			}
+		done += ret;
+		}
+
+	log_thread.bytes += done;
+	log_thread.batches++;
+	log_thread.batch_len = 0;
+	log_thread.dirty = TRUE;
+	}
+
+
+static void add_to_log_batch(time_t timestamp, const char *msg) {
+	size_t len = strlen(msg) + 32;
+	char *buf;
+
+	if(log_thread.batch_len + len > log_thread.batch_size)
+		flush_log_batch();
+
+	/* make room for lines longer than the batch buffer */
+	if(len > log_thread.batch_size) {
+		if((buf = realloc(log_thread.batch, len)) == NULL) {
+			log_thread.write_errors++;
+			return;
+			}
+		log_thread.batch = buf;
+		log_thread.batch_size = len;
+		}
+
+	log_thread.batch_len += sprintf(log_thread.batch + log_thread.batch_len, "[%llu] %s\n", (unsigned long long)timestamp, msg);
+	log_thread.written++;
+	}
+
+
+static void sync_log_file(int force) {
+	time_t now;
+
+	if(log_fsync_interval == LOG_FSYNC_NEVER || log_thread.dirty == FALSE || log_thread.fd < 0)
+		return;
+
+	time(&now);
+	if(force == FALSE && log_fsync_interval > 0 && now - log_thread.last_fsync < log_fsync_interval)
+		return;
+
+	fdatasync(log_thread.fd);
+	log_thread.fsyncs++;
+	log_thread.last_fsync = now;
+	log_thread.dirty = FALSE;
+	}
+
+
+/* renames the log file to its archive name and opens a new one */
+static void rotate_log_thread_file(const char *log_archive) {
+	struct stat log_file_stat;
+	int stat_result;
+
+	flush_log_batch();
+	sync_log_file(TRUE);
+
+	stat_result = stat(log_file, &log_file_stat);
+	if(log_thread.fd >= 0)
+		close(log_thread.fd);
+
+	my_rename(log_file, (char *)log_archive);
+	log_thread.fd = open_log_fd();
+
+	if(stat_result == 0 && log_thread.fd >= 0) {
+		fchmod(log_thread.fd, log_file_stat.st_mode);
+		fchown(log_thread.fd, log_file_stat.st_uid, log_file_stat.st_gid);
+		}
+
+	log_thread.rotations++;
+	}
+
+
+static void *log_thread_main(void *arg) {
+	struct log_record *rec;
+	struct timespec ts;
+	unsigned long dropped;
+	int handled;
+
+	for(;;) {
+		/* group everything that's queued into one write */
+		for(handled = 0; (rec = mpscring_peek(log_thread.ring, NULL)) != NULL; handled++) {
+			if(rec->what == LOGREC_FILE)
+				add_to_log_batch(rec->timestamp, rec->msg);
+			else if(rec->what == LOGREC_SYSLOG)
+				syslog(LOG_USER | LOG_INFO, "%s", rec->msg);
+			else if(rec->what == LOGREC_ROTATE)
+				rotate_log_thread_file(rec->msg);
+			mpscring_consume(log_thread.ring);
+			}
+
+		/* let the log know it's missing something */
+		dropped = __sync_fetch_and_add(&log_thread.dropped, 0);
+		if(dropped != log_thread.dropped_reported) {
+			char msg[128];
+			snprintf(msg, sizeof(msg), "Warning: Log buffer overflowed. %lu messages were dropped.", dropped - log_thread.dropped_reported);
+			add_to_log_batch(time(NULL), msg);
+			log_thread.dropped_reported = dropped;
+			}
+
+		flush_log_batch();
+		sync_log_file(FALSE);
+
+		if(handled)
+			continue;
+
+		pthread_mutex_lock(&log_thread.lock);
+		if(log_thread.stopping) {
+			pthread_mutex_unlock(&log_thread.lock);
+			break;
+			}
+		log_thread.sleeping = TRUE;
+		__sync_synchronize();
+		if(mpscring_peek(log_thread.ring, NULL) == NULL) {
+			/* wake up now and then to honor the fsync interval */
+			clock_gettime(CLOCK_REALTIME, &ts);
+			ts.tv_sec++;
+			pthread_cond_timedwait(&log_thread.cond, &log_thread.lock, &ts);
+			}
+		log_thread.sleeping = FALSE;
+		pthread_mutex_unlock(&log_thread.lock);
+		}
+
+	sync_log_file(TRUE);
+
+	return NULL;
+	}
+
+
+/*
+ * The thread is started once we're done forking off workers, and
+ * messages logged before that are written the usual way.
+ */
+int start_log_thread(void) {
+
+	if(use_log_thread == FALSE || log_thread.running == TRUE)
+		return OK;
+
+	/* don't log anything if we're not actually running... */
+	if(verify_config || test_scheduling == TRUE)
+		return OK;
+
+	memset(&log_thread, 0, sizeof(log_thread));
+	log_thread.fd = -1;
+
+	log_thread.batch_size = LOG_BATCH_SIZE;
+	if((log_thread.ring = mpscring_create(log_thread_buffer_size)) == NULL || (log_thread.batch = malloc(log_thread.batch_size)) == NULL) {
+		logit(NSLOG_RUNTIME_ERROR, TRUE, "Error: Failed to allocate log thread buffers. Logging from the main thread.\n");
+		goto fail;
+		}
+
+	/* the thread gets a descriptor of its own */
+	close_log_file();
+	if((log_thread.fd = open_log_fd()) < 0) {
+		logit(NSLOG_RUNTIME_ERROR, TRUE, "Error: Failed to open log file '%s' for the log thread. Logging from the main thread.\n", log_file);
+		goto fail;
+		}
+
+	pthread_mutex_init(&log_thread.lock, NULL);
+	pthread_cond_init(&log_thread.cond, NULL);
+	log_thread.pid = getpid();
+	time(&log_thread.last_fsync);
+
+	if(pthread_create(&log_thread.thread, NULL, log_thread_main, NULL)) {
+		logit(NSLOG_RUNTIME_ERROR, TRUE, "Error: Failed to start log thread: %s. Logging from the main thread.\n", strerror(errno));
+		pthread_mutex_destroy(&log_thread.lock);
+		pthread_cond_destroy(&log_thread.cond);
+		goto fail;
+		}
+	log_thread.running = TRUE;
+
+	logit(NSLOG_INFO_MESSAGE, FALSE, "Logging through a log thread with a %lu byte buffer\n", mpscring_size(log_thread.ring));
+
+	return OK;
+
+fail:
+	if(log_thread.fd >= 0)
+		close(log_thread.fd);
+	mpscring_destroy(log_thread.ring);
+	my_free(log_thread.batch);
+	memset(&log_thread, 0, sizeof(log_thread));
+	log_thread.fd = -1;
+	return ERROR;
+	}
+
+
+void stop_log_thread(void) {
+
+	if(log_thread.running == FALSE)
+		return;
+	log_thread.running = FALSE;
+
+	/* a forked child has the memory, but not the thread */
+	if(log_thread.pid == getpid()) {
+		pthread_mutex_lock(&log_thread.lock);
+		log_thread.stopping = TRUE;
+		pthread_cond_signal(&log_thread.cond);
+		pthread_mutex_unlock(&log_thread.lock);
+		pthread_join(log_thread.thread, NULL);
+		pthread_mutex_destroy(&log_thread.lock);
+		pthread_cond_destroy(&log_thread.cond);
+		}
+
+	if(log_thread.fd >= 0)
+		close(log_thread.fd);
+	log_thread.fd = -1;
+	mpscring_destroy(log_thread.ring);
+	log_thread.ring = NULL;
+	my_free(log_thread.batch);
+	}
+
+
+/* prints log thread statistics to a query handler socket */
+int dump_log_thread_stats(int sd) {
+	char fsync_policy[16];
+
+	if(log_fsync_interval == LOG_FSYNC_NEVER)
+		strcpy(fsync_policy, "never");
+	else if(log_fsync_interval == LOG_FSYNC_BATCH)
+		strcpy(fsync_policy, "batch");
+	else
+		snprintf(fsync_policy, sizeof(fsync_policy), "%d", log_fsync_interval);
+
+	nsock_printf(sd, "running=%d;buffer_size=%lu;buffer_used=%lu;buffer_max_used=%lu;",
+	             log_thread.running,
+	             log_thread.ring ? mpscring_size(log_thread.ring) : 0,
+	             log_thread.ring ? mpscring_used(log_thread.ring) : 0,
+	             log_thread.max_used);
+	nsock_printf(sd, "overflow_policy=%s;fsync_policy=%s;",
+	             log_overflow_policy == LOG_OVERFLOW_DROP ? "drop" : "block", fsync_policy);
+	nsock_printf(sd, "queued=%lu;dropped=%lu;blocked=%lu;truncated=%lu;",
+	             log_thread.queued, log_thread.dropped, log_thread.blocked, log_thread.truncated);
+	nsock_printf_nul(sd, "written=%lu;batches=%lu;bytes=%llu;fsyncs=%lu;rotations=%lu;write_errors=%lu",
+	                 log_thread.written, log_thread.batches, log_thread.bytes,
+	                 log_thread.fsyncs, log_thread.rotations, log_thread.write_errors);
+
+	return OK;
+	}
+
+
 /* opens the debug log for writing */
 int open_debug_log(void)
 {
@@ -0,0 +1,747 @@
+/* C code generated from mainconf.gperf in gperf's output format */
+/* Command-line: gperf -t -H mainconf_key_phash -N mainconf_get_key mainconf.gperf  */
+/* Computed positions: -k'3,7,16' */
+
+#line 1 "mainconf.gperf"
+enum {
+	MAINCONF_resource_file,
+	MAINCONF_website_url,
+	MAINCONF_loadctl_options,
+	MAINCONF_check_workers,
+	MAINCONF_event_queue_type,
+	MAINCONF_event_batch_size,
+	MAINCONF_object_config_threads,
+	MAINCONF_check_result_threads,
+	MAINCONF_worker_use_posix_spawn,
+	MAINCONF_worker_shm_ring_size,
+	MAINCONF_use_log_thread,
+	MAINCONF_log_thread_buffer_size,
+	MAINCONF_log_overflow_policy,
+	MAINCONF_log_fsync_policy,
+	MAINCONF_trace_buffer_size,
+	MAINCONF_query_socket,
+	MAINCONF_log_file,
+	MAINCONF_debug_level,
+	MAINCONF_debug_verbosity,
+	MAINCONF_debug_file,
+	MAINCONF_max_debug_file_size,
+	MAINCONF_command_file,
+	MAINCONF_temp_file,
+	MAINCONF_temp_path,
+	MAINCONF_check_result_path,
+	MAINCONF_max_check_result_file_age,
+	MAINCONF_lock_file,
+	MAINCONF_global_host_event_handler,
+	MAINCONF_global_service_event_handler,
+	MAINCONF_ocsp_command,
+	MAINCONF_ochp_command,
+	MAINCONF_nagios_user,
+	MAINCONF_nagios_group,
+	MAINCONF_admin_email,
+	MAINCONF_admin_pager,
+	MAINCONF_use_syslog,
+	MAINCONF_log_notifications,
+	MAINCONF_log_service_retries,
+	MAINCONF_log_host_retries,
+	MAINCONF_log_event_handlers,
+	MAINCONF_log_external_commands,
+	MAINCONF_log_passive_checks,
+	MAINCONF_log_initial_states,
+	MAINCONF_log_current_states,
+	MAINCONF_retain_state_information,
+	MAINCONF_retention_update_interval,
+	MAINCONF_retention_save_mode,
+	MAINCONF_retention_journal,
+	MAINCONF_retention_journal_sync_interval,
+	MAINCONF_retention_journal_max_size,
+	MAINCONF_use_retained_program_state,
+	MAINCONF_use_retained_scheduling_info,
+	MAINCONF_retention_scheduling_horizon,
+	MAINCONF_additional_freshness_latency,
+	MAINCONF_retained_host_attribute_mask,
+	MAINCONF_retained_service_attribute_mask,
+	MAINCONF_retained_process_host_attribute_mask,
+	MAINCONF_retained_process_service_attribute_mask,
+	MAINCONF_retained_contact_host_attribute_mask,
+	MAINCONF_retained_contact_service_attribute_mask,
+	MAINCONF_obsess_over_services,
+	MAINCONF_obsess_over_hosts,
+	MAINCONF_translate_passive_host_checks,
+	MAINCONF_passive_host_checks_are_soft,
+	MAINCONF_service_check_timeout,
+	MAINCONF_service_check_timeout_state,
+	MAINCONF_host_check_timeout,
+	MAINCONF_event_handler_timeout,
+	MAINCONF_notification_timeout,
+	MAINCONF_ocsp_timeout,
+	MAINCONF_ochp_timeout,
+	MAINCONF_use_agressive_host_checking,
+	MAINCONF_use_aggressive_host_checking,
+	MAINCONF_cached_host_check_horizon,
+	MAINCONF_enable_predictive_host_dependency_checks,
+	MAINCONF_cached_service_check_horizon,
+	MAINCONF_enable_predictive_service_dependency_checks,
+	MAINCONF_soft_state_dependencies,
+	MAINCONF_log_rotation_method,
+	MAINCONF_log_archive_path,
+	MAINCONF_enable_event_handlers,
+	MAINCONF_enable_notifications,
+	MAINCONF_execute_service_checks,
+	MAINCONF_accept_passive_service_checks,
+	MAINCONF_execute_host_checks,
+	MAINCONF_accept_passive_host_checks,
+	MAINCONF_service_inter_check_delay_method,
+	MAINCONF_max_service_check_spread,
+	MAINCONF_host_inter_check_delay_method,
+	MAINCONF_max_host_check_spread,
+	MAINCONF_service_interleave_factor,
+	MAINCONF_max_concurrent_checks,
+	MAINCONF_check_result_reaper_frequency,
+	MAINCONF_service_reaper_frequency,
+	MAINCONF_max_check_result_reaper_time,
+	MAINCONF_sleep_time,
+	MAINCONF_interval_length,
+	MAINCONF_check_external_commands,
+	MAINCONF_command_check_interval,
+	MAINCONF_check_for_orphaned_services,
+	MAINCONF_check_for_orphaned_hosts,
+	MAINCONF_check_service_freshness,
+	MAINCONF_check_host_freshness,
+	MAINCONF_service_freshness_check_interval,
+	MAINCONF_freshness_check_interval,
+	MAINCONF_host_freshness_check_interval,
+	MAINCONF_auto_reschedule_checks,
+	MAINCONF_auto_rescheduling_interval,
+	MAINCONF_auto_rescheduling_window,
+	MAINCONF_status_update_interval,
+	MAINCONF_time_change_threshold,
+	MAINCONF_process_performance_data,
+	MAINCONF_enable_flap_detection,
+	MAINCONF_enable_failure_prediction,
+	MAINCONF_low_service_flap_threshold,
+	MAINCONF_high_service_flap_threshold,
+	MAINCONF_low_host_flap_threshold,
+	MAINCONF_high_host_flap_threshold,
+	MAINCONF_date_format,
+	MAINCONF_use_timezone,
+	MAINCONF_event_broker_options,
+	MAINCONF_illegal_object_name_chars,
+	MAINCONF_illegal_macro_output_chars,
+	MAINCONF_broker_module,
+	MAINCONF_use_regexp_matching,
+	MAINCONF_use_true_regexp_matching,
+	MAINCONF_daemon_dumps_core,
+	MAINCONF_use_large_installation_tweaks,
+	MAINCONF_enable_environment_macros,
+	MAINCONF_environment_macros,
+	MAINCONF_free_child_process_memory,
+	MAINCONF_child_processes_fork_twice,
+	MAINCONF_enable_embedded_perl,
+	MAINCONF_use_embedded_perl_implicitly,
+	MAINCONF_auth_file,
+	MAINCONF_p1_file,
+	MAINCONF_external_command_buffer_slots,
+	MAINCONF_check_for_updates,
+	MAINCONF_bare_update_check,
+	MAINCONF_status_file,
+	MAINCONF_status_binary_file,
+	MAINCONF_perfdata_timeout,
+	MAINCONF_host_perfdata_command,
+	MAINCONF_service_perfdata_command,
+	MAINCONF_host_perfdata_file_template,
+	MAINCONF_service_perfdata_file_template,
+	MAINCONF_host_perfdata_file,
+	MAINCONF_service_perfdata_file,
+	MAINCONF_host_perfdata_file_mode,
+	MAINCONF_service_perfdata_file_mode,
+	MAINCONF_host_perfdata_file_processing_interval,
+	MAINCONF_service_perfdata_file_processing_interval,
+	MAINCONF_host_perfdata_file_processing_command,
+	MAINCONF_service_perfdata_file_processing_command,
+	MAINCONF_host_perfdata_process_empty_results,
+	MAINCONF_service_perfdata_process_empty_results,
+	MAINCONF_binary_object_precache,
+	MAINCONF_allow_empty_hostgroup_assignment,
+	MAINCONF_host_down_disable_service_checks,
+	MAINCONF_service_skip_check_dependency_status,
+	MAINCONF_service_skip_check_parent_status,
+	MAINCONF_service_skip_check_host_down_status,
+	MAINCONF_host_skip_check_dependency_status,
+};
+#include <string.h> /* for strcmp() */
+#line 169 "mainconf.gperf"
+struct mainconf_key {
+	const char *name;
+	int code;
+};
+
+#define TOTAL_KEYWORDS 163
+#define MIN_WORD_LENGTH 7
+#define MAX_WORD_LENGTH 43
+#define MIN_HASH_VALUE 31
+#define MAX_HASH_VALUE 801
+/* maximum key range = 771, duplicates = 0 */
+
+#ifdef __GNUC__
+__inline
+#else
+#ifdef __cplusplus
+inline
+#endif
+#endif
+static unsigned int
+mainconf_key_phash (register const char *str, register size_t len)
+{
+  static unsigned short asso_values[] =
+    {
+      802, 802, 802, 802, 802, 802, 802, 802, 802, 802,
+      802, 802, 802, 802, 802, 802, 802, 802, 802, 802,
+      802, 802, 802, 802, 802, 802, 802, 802, 802, 802,
+      802, 802, 802, 802, 802, 802, 802, 802, 802, 802,
+      802, 802, 802, 802, 802, 802, 802, 802, 802, 802,
+      802, 802, 802, 802, 802, 802, 802, 802, 802, 802,
+      802, 802, 802, 802, 802, 802, 802, 802, 802, 802,
+      802, 802, 802, 802, 802, 802, 802, 802, 802, 802,
+      802, 802, 802, 802, 802, 802, 802, 802, 802, 802,
+      802, 802, 802, 802, 802, 218, 802,   1,  18,  29,
+       87,  24, 231, 111, 164, 238, 105,  62,  15,  23,
+      103, 289, 216, 278, 310, 312,  30, 202, 251, 186,
+       58, 172, 100, 802, 802, 802, 802, 802, 802, 802,
+      802, 802, 802, 802, 802, 802, 802, 802, 802, 802,
+      802, 802, 802, 802, 802, 802, 802, 802, 802, 802,
+      802, 802, 802, 802, 802, 802, 802, 802, 802, 802,
+      802, 802, 802, 802, 802, 802, 802, 802, 802, 802,
+      802, 802, 802, 802, 802, 802, 802, 802, 802, 802,
+      802, 802, 802, 802, 802, 802, 802, 802, 802, 802,
+      802, 802, 802, 802, 802, 802, 802, 802, 802, 802,
+      802, 802, 802, 802, 802, 802, 802, 802, 802, 802,
+      802, 802, 802, 802, 802, 802, 802, 802, 802, 802,
+      802, 802, 802, 802, 802, 802, 802, 802, 802, 802,
+      802, 802, 802, 802, 802, 802, 802, 802, 802, 802,
+      802, 802, 802, 802, 802, 802, 802, 802, 802, 802,
+      802, 802, 802, 802, 802, 802
+    };
+  register unsigned int hval = len;
+
+  switch (hval)
+    {
+      default:
+        hval += asso_values[(unsigned char)str[15]];
+      /*FALLTHROUGH*/
+      case 15:
+      case 14:
+      case 13:
+      case 12:
+      case 11:
+      case 10:
+      case 9:
+      case 8:
+      case 7:
+        hval += asso_values[(unsigned char)str[6]];
+      /*FALLTHROUGH*/
+        hval += asso_values[(unsigned char)str[2]];
+        break;
+    }
+  return hval;
+}
+
+struct mainconf_key *
+mainconf_get_key (register const char *str, register size_t len)
+{
+  static struct mainconf_key wordlist[] =
+    {
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""},
+#line 176 "mainconf.gperf"
+      {"loadctl_options", MAINCONF_loadctl_options},
+      {""},
+#line 197 "mainconf.gperf"
+      {"temp_path", MAINCONF_temp_path},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""},
+#line 191 "mainconf.gperf"
+      {"debug_level", MAINCONF_debug_level},
+      {""},
+#line 270 "mainconf.gperf"
+      {"interval_length", MAINCONF_interval_length},
+      {""}, {""}, {""}, {""}, {""}, {""},
+#line 175 "mainconf.gperf"
+      {"website_url", MAINCONF_website_url},
+      {""}, {""}, {""}, {""},
+#line 207 "mainconf.gperf"
+      {"admin_email", MAINCONF_admin_email},
+#line 293 "mainconf.gperf"
+      {"use_timezone", MAINCONF_use_timezone},
+      {""}, {""}, {""}, {""},
+#line 269 "mainconf.gperf"
+      {"sleep_time", MAINCONF_sleep_time},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""},
+#line 179 "mainconf.gperf"
+      {"event_batch_size", MAINCONF_event_batch_size},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+#line 258 "mainconf.gperf"
+      {"execute_host_checks", MAINCONF_execute_host_checks},
+#line 294 "mainconf.gperf"
+      {"event_broker_options", MAINCONF_event_broker_options},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""},
+#line 271 "mainconf.gperf"
+      {"check_external_commands", MAINCONF_check_external_commands},
+#line 331 "mainconf.gperf"
+      {"allow_empty_hostgroup_assignment", MAINCONF_allow_empty_hostgroup_assignment},
+#line 242 "mainconf.gperf"
+      {"notification_timeout", MAINCONF_notification_timeout},
+      {""}, {""}, {""}, {""}, {""}, {""},
+#line 229 "mainconf.gperf"
+      {"retained_service_attribute_mask", MAINCONF_retained_service_attribute_mask},
+      {""}, {""},
+#line 228 "mainconf.gperf"
+      {"retained_host_attribute_mask", MAINCONF_retained_host_attribute_mask},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""},
+#line 232 "mainconf.gperf"
+      {"retained_contact_host_attribute_mask", MAINCONF_retained_contact_host_attribute_mask},
+      {""},
+#line 195 "mainconf.gperf"
+      {"command_file", MAINCONF_command_file},
+#line 233 "mainconf.gperf"
+      {"retained_contact_service_attribute_mask", MAINCONF_retained_contact_service_attribute_mask},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""},
+#line 190 "mainconf.gperf"
+      {"log_file", MAINCONF_log_file},
+      {""},
+#line 188 "mainconf.gperf"
+      {"trace_buffer_size", MAINCONF_trace_buffer_size},
+#line 199 "mainconf.gperf"
+      {"max_check_result_file_age", MAINCONF_max_check_result_file_age},
+      {""}, {""},
+#line 268 "mainconf.gperf"
+      {"max_check_result_reaper_time", MAINCONF_max_check_result_reaper_time},
+      {""}, {""}, {""}, {""}, {""}, {""},
+#line 310 "mainconf.gperf"
+      {"external_command_buffer_slots", MAINCONF_external_command_buffer_slots},
+      {""},
+#line 184 "mainconf.gperf"
+      {"use_log_thread", MAINCONF_use_log_thread},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+#line 295 "mainconf.gperf"
+      {"illegal_object_name_chars", MAINCONF_illegal_object_name_chars},
+      {""}, {""}, {""}, {""},
+#line 289 "mainconf.gperf"
+      {"high_service_flap_threshold", MAINCONF_high_service_flap_threshold},
+      {""}, {""}, {""}, {""}, {""},
+#line 186 "mainconf.gperf"
+      {"log_overflow_policy", MAINCONF_log_overflow_policy},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""},
+#line 213 "mainconf.gperf"
+      {"log_event_handlers", MAINCONF_log_event_handlers},
+      {""}, {""}, {""},
+#line 282 "mainconf.gperf"
+      {"auto_rescheduling_window", MAINCONF_auto_rescheduling_window},
+      {""},
+#line 281 "mainconf.gperf"
+      {"auto_rescheduling_interval", MAINCONF_auto_rescheduling_interval},
+      {""},
+#line 214 "mainconf.gperf"
+      {"log_external_commands", MAINCONF_log_external_commands},
+      {""}, {""}, {""}, {""},
+#line 252 "mainconf.gperf"
+      {"log_rotation_method", MAINCONF_log_rotation_method},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""},
+#line 265 "mainconf.gperf"
+      {"max_concurrent_checks", MAINCONF_max_concurrent_checks},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""},
+#line 177 "mainconf.gperf"
+      {"check_workers", MAINCONF_check_workers},
+      {""}, {""}, {""}, {""}, {""}, {""},
+#line 313 "mainconf.gperf"
+      {"status_file", MAINCONF_status_file},
+      {""},
+#line 284 "mainconf.gperf"
+      {"time_change_threshold", MAINCONF_time_change_threshold},
+      {""}, {""},
+#line 272 "mainconf.gperf"
+      {"command_check_interval", MAINCONF_command_check_interval},
+      {""},
+#line 304 "mainconf.gperf"
+      {"free_child_process_memory", MAINCONF_free_child_process_memory},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+#line 225 "mainconf.gperf"
+      {"use_retained_scheduling_info", MAINCONF_use_retained_scheduling_info},
+      {""}, {""},
+#line 309 "mainconf.gperf"
+      {"p1_file", MAINCONF_p1_file},
+#line 208 "mainconf.gperf"
+      {"admin_pager", MAINCONF_admin_pager},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""},
+#line 296 "mainconf.gperf"
+      {"illegal_macro_output_chars", MAINCONF_illegal_macro_output_chars},
+#line 193 "mainconf.gperf"
+      {"debug_file", MAINCONF_debug_file},
+      {""},
+#line 210 "mainconf.gperf"
+      {"log_notifications", MAINCONF_log_notifications},
+      {""}, {""},
+#line 286 "mainconf.gperf"
+      {"enable_flap_detection", MAINCONF_enable_flap_detection},
+      {""}, {""}, {""},
+#line 302 "mainconf.gperf"
+      {"enable_environment_macros", MAINCONF_enable_environment_macros},
+#line 255 "mainconf.gperf"
+      {"enable_notifications", MAINCONF_enable_notifications},
+#line 196 "mainconf.gperf"
+      {"temp_file", MAINCONF_temp_file},
+      {""}, {""}, {""}, {""}, {""},
+#line 200 "mainconf.gperf"
+      {"lock_file", MAINCONF_lock_file},
+#line 308 "mainconf.gperf"
+      {"auth_file", MAINCONF_auth_file},
+      {""}, {""}, {""}, {""},
+#line 236 "mainconf.gperf"
+      {"translate_passive_host_checks", MAINCONF_translate_passive_host_checks},
+      {""},
+#line 192 "mainconf.gperf"
+      {"debug_verbosity", MAINCONF_debug_verbosity},
+      {""},
+#line 221 "mainconf.gperf"
+      {"retention_journal", MAINCONF_retention_journal},
+      {""},
+#line 256 "mainconf.gperf"
+      {"execute_service_checks", MAINCONF_execute_service_checks},
+      {""},
+#line 278 "mainconf.gperf"
+      {"freshness_check_interval", MAINCONF_freshness_check_interval},
+      {""}, {""}, {""},
+#line 280 "mainconf.gperf"
+      {"auto_reschedule_checks", MAINCONF_auto_reschedule_checks},
+#line 223 "mainconf.gperf"
+      {"retention_journal_max_size", MAINCONF_retention_journal_max_size},
+#line 311 "mainconf.gperf"
+      {"check_for_updates", MAINCONF_check_for_updates},
+      {""}, {""}, {""},
+#line 222 "mainconf.gperf"
+      {"retention_journal_sync_interval", MAINCONF_retention_journal_sync_interval},
+#line 247 "mainconf.gperf"
+      {"cached_host_check_horizon", MAINCONF_cached_host_check_horizon},
+      {""}, {""},
+#line 249 "mainconf.gperf"
+      {"cached_service_check_horizon", MAINCONF_cached_service_check_horizon},
+      {""}, {""}, {""}, {""}, {""},
+#line 220 "mainconf.gperf"
+      {"retention_save_mode", MAINCONF_retention_save_mode},
+      {""}, {""}, {""}, {""}, {""}, {""},
+#line 219 "mainconf.gperf"
+      {"retention_update_interval", MAINCONF_retention_update_interval},
+#line 298 "mainconf.gperf"
+      {"use_regexp_matching", MAINCONF_use_regexp_matching},
+      {""},
+#line 253 "mainconf.gperf"
+      {"log_archive_path", MAINCONF_log_archive_path},
+      {""}, {""}, {""}, {""}, {""}, {""},
+#line 246 "mainconf.gperf"
+      {"use_aggressive_host_checking", MAINCONF_use_aggressive_host_checking},
+      {""}, {""},
+#line 292 "mainconf.gperf"
+      {"date_format", MAINCONF_date_format},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""},
+#line 205 "mainconf.gperf"
+      {"nagios_user", MAINCONF_nagios_user},
+#line 206 "mainconf.gperf"
+      {"nagios_group", MAINCONF_nagios_group},
+#line 178 "mainconf.gperf"
+      {"event_queue_type", MAINCONF_event_queue_type},
+#line 254 "mainconf.gperf"
+      {"enable_event_handlers", MAINCONF_enable_event_handlers},
+#line 283 "mainconf.gperf"
+      {"status_update_interval", MAINCONF_status_update_interval},
+      {""},
+#line 209 "mainconf.gperf"
+      {"use_syslog", MAINCONF_use_syslog},
+      {""},
+#line 189 "mainconf.gperf"
+      {"query_socket", MAINCONF_query_socket},
+      {""}, {""}, {""}, {""}, {""},
+#line 174 "mainconf.gperf"
+      {"resource_file", MAINCONF_resource_file},
+      {""},
+#line 321 "mainconf.gperf"
+      {"service_perfdata_file", MAINCONF_service_perfdata_file},
+      {""}, {""},
+#line 317 "mainconf.gperf"
+      {"service_perfdata_command", MAINCONF_service_perfdata_command},
+#line 264 "mainconf.gperf"
+      {"service_interleave_factor", MAINCONF_service_interleave_factor},
+#line 323 "mainconf.gperf"
+      {"service_perfdata_file_mode", MAINCONF_service_perfdata_file_mode},
+      {""}, {""},
+#line 266 "mainconf.gperf"
+      {"check_result_reaper_frequency", MAINCONF_check_result_reaper_frequency},
+#line 319 "mainconf.gperf"
+      {"service_perfdata_file_template", MAINCONF_service_perfdata_file_template},
+      {""}, {""}, {""},
+#line 224 "mainconf.gperf"
+      {"use_retained_program_state", MAINCONF_use_retained_program_state},
+      {""}, {""},
+#line 276 "mainconf.gperf"
+      {"check_host_freshness", MAINCONF_check_host_freshness},
+#line 329 "mainconf.gperf"
+      {"service_perfdata_process_empty_results", MAINCONF_service_perfdata_process_empty_results},
+      {""},
+#line 327 "mainconf.gperf"
+      {"service_perfdata_file_processing_command", MAINCONF_service_perfdata_file_processing_command},
+#line 325 "mainconf.gperf"
+      {"service_perfdata_file_processing_interval", MAINCONF_service_perfdata_file_processing_interval},
+      {""},
+#line 301 "mainconf.gperf"
+      {"use_large_installation_tweaks", MAINCONF_use_large_installation_tweaks},
+      {""},
+#line 307 "mainconf.gperf"
+      {"use_embedded_perl_implicitly", MAINCONF_use_embedded_perl_implicitly},
+#line 198 "mainconf.gperf"
+      {"check_result_path", MAINCONF_check_result_path},
+#line 274 "mainconf.gperf"
+      {"check_for_orphaned_hosts", MAINCONF_check_for_orphaned_hosts},
+      {""}, {""},
+#line 273 "mainconf.gperf"
+      {"check_for_orphaned_services", MAINCONF_check_for_orphaned_services},
+#line 315 "mainconf.gperf"
+      {"perfdata_timeout", MAINCONF_perfdata_timeout},
+#line 251 "mainconf.gperf"
+      {"soft_state_dependencies", MAINCONF_soft_state_dependencies},
+#line 237 "mainconf.gperf"
+      {"passive_host_checks_are_soft", MAINCONF_passive_host_checks_are_soft},
+      {""},
+#line 334 "mainconf.gperf"
+      {"service_skip_check_parent_status", MAINCONF_service_skip_check_parent_status},
+      {""}, {""},
+#line 335 "mainconf.gperf"
+      {"service_skip_check_host_down_status", MAINCONF_service_skip_check_host_down_status},
+#line 333 "mainconf.gperf"
+      {"service_skip_check_dependency_status", MAINCONF_service_skip_check_dependency_status},
+      {""}, {""},
+#line 216 "mainconf.gperf"
+      {"log_initial_states", MAINCONF_log_initial_states},
+      {""}, {""}, {""}, {""},
+#line 230 "mainconf.gperf"
+      {"retained_process_host_attribute_mask", MAINCONF_retained_process_host_attribute_mask},
+      {""}, {""},
+#line 231 "mainconf.gperf"
+      {"retained_process_service_attribute_mask", MAINCONF_retained_process_service_attribute_mask},
+      {""},
+#line 194 "mainconf.gperf"
+      {"max_debug_file_size", MAINCONF_max_debug_file_size},
+      {""}, {""}, {""}, {""}, {""}, {""},
+#line 244 "mainconf.gperf"
+      {"ochp_timeout", MAINCONF_ochp_timeout},
+      {""}, {""}, {""}, {""}, {""}, {""},
+#line 261 "mainconf.gperf"
+      {"max_service_check_spread", MAINCONF_max_service_check_spread},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""},
+#line 259 "mainconf.gperf"
+      {"accept_passive_host_checks", MAINCONF_accept_passive_host_checks},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""},
+#line 241 "mainconf.gperf"
+      {"event_handler_timeout", MAINCONF_event_handler_timeout},
+      {""}, {""}, {""}, {""}, {""}, {""},
+#line 291 "mainconf.gperf"
+      {"high_host_flap_threshold", MAINCONF_high_host_flap_threshold},
+      {""}, {""},
+#line 306 "mainconf.gperf"
+      {"enable_embedded_perl", MAINCONF_enable_embedded_perl},
+      {""}, {""},
+#line 287 "mainconf.gperf"
+      {"enable_failure_prediction", MAINCONF_enable_failure_prediction},
+      {""}, {""}, {""}, {""},
+#line 204 "mainconf.gperf"
+      {"ochp_command", MAINCONF_ochp_command},
+      {""},
+#line 185 "mainconf.gperf"
+      {"log_thread_buffer_size", MAINCONF_log_thread_buffer_size},
+#line 299 "mainconf.gperf"
+      {"use_true_regexp_matching", MAINCONF_use_true_regexp_matching},
+#line 217 "mainconf.gperf"
+      {"log_current_states", MAINCONF_log_current_states},
+#line 215 "mainconf.gperf"
+      {"log_passive_checks", MAINCONF_log_passive_checks},
+#line 187 "mainconf.gperf"
+      {"log_fsync_policy", MAINCONF_log_fsync_policy},
+      {""}, {""}, {""},
+#line 314 "mainconf.gperf"
+      {"status_binary_file", MAINCONF_status_binary_file},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""},
+#line 226 "mainconf.gperf"
+      {"retention_scheduling_horizon", MAINCONF_retention_scheduling_horizon},
+      {""}, {""}, {""}, {""},
+#line 218 "mainconf.gperf"
+      {"retain_state_information", MAINCONF_retain_state_information},
+      {""}, {""},
+#line 262 "mainconf.gperf"
+      {"host_inter_check_delay_method", MAINCONF_host_inter_check_delay_method},
+      {""},
+#line 180 "mainconf.gperf"
+      {"object_config_threads", MAINCONF_object_config_threads},
+      {""},
+#line 248 "mainconf.gperf"
+      {"enable_predictive_host_dependency_checks", MAINCONF_enable_predictive_host_dependency_checks},
+      {""}, {""},
+#line 250 "mainconf.gperf"
+      {"enable_predictive_service_dependency_checks", MAINCONF_enable_predictive_service_dependency_checks},
+      {""}, {""}, {""}, {""}, {""}, {""},
+#line 297 "mainconf.gperf"
+      {"broker_module", MAINCONF_broker_module},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""},
+#line 260 "mainconf.gperf"
+      {"service_inter_check_delay_method", MAINCONF_service_inter_check_delay_method},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""},
+#line 202 "mainconf.gperf"
+      {"global_service_event_handler", MAINCONF_global_service_event_handler},
+      {""}, {""},
+#line 243 "mainconf.gperf"
+      {"ocsp_timeout", MAINCONF_ocsp_timeout},
+      {""}, {""}, {""}, {""}, {""},
+#line 227 "mainconf.gperf"
+      {"additional_freshness_latency", MAINCONF_additional_freshness_latency},
+#line 300 "mainconf.gperf"
+      {"daemon_dumps_core", MAINCONF_daemon_dumps_core},
+      {""}, {""},
+#line 312 "mainconf.gperf"
+      {"bare_update_check", MAINCONF_bare_update_check},
+      {""}, {""}, {""}, {""},
+#line 235 "mainconf.gperf"
+      {"obsess_over_hosts", MAINCONF_obsess_over_hosts},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""},
+#line 257 "mainconf.gperf"
+      {"accept_passive_service_checks", MAINCONF_accept_passive_service_checks},
+#line 267 "mainconf.gperf"
+      {"service_reaper_frequency", MAINCONF_service_reaper_frequency},
+      {""}, {""},
+#line 320 "mainconf.gperf"
+      {"host_perfdata_file", MAINCONF_host_perfdata_file},
+#line 238 "mainconf.gperf"
+      {"service_check_timeout", MAINCONF_service_check_timeout},
+      {""}, {""}, {""},
+#line 322 "mainconf.gperf"
+      {"host_perfdata_file_mode", MAINCONF_host_perfdata_file_mode},
+      {""},
+#line 239 "mainconf.gperf"
+      {"service_check_timeout_state", MAINCONF_service_check_timeout_state},
+      {""},
+#line 318 "mainconf.gperf"
+      {"host_perfdata_file_template", MAINCONF_host_perfdata_file_template},
+      {""}, {""}, {""}, {""}, {""}, {""},
+#line 182 "mainconf.gperf"
+      {"worker_use_posix_spawn", MAINCONF_worker_use_posix_spawn},
+      {""}, {""},
+#line 326 "mainconf.gperf"
+      {"host_perfdata_file_processing_command", MAINCONF_host_perfdata_file_processing_command},
+#line 324 "mainconf.gperf"
+      {"host_perfdata_file_processing_interval", MAINCONF_host_perfdata_file_processing_interval},
+#line 203 "mainconf.gperf"
+      {"ocsp_command", MAINCONF_ocsp_command},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""},
+#line 336 "mainconf.gperf"
+      {"host_skip_check_dependency_status", MAINCONF_host_skip_check_dependency_status},
+#line 285 "mainconf.gperf"
+      {"process_performance_data", MAINCONF_process_performance_data},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+#line 201 "mainconf.gperf"
+      {"global_host_event_handler", MAINCONF_global_host_event_handler},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""},
+#line 316 "mainconf.gperf"
+      {"host_perfdata_command", MAINCONF_host_perfdata_command},
+      {""},
+#line 332 "mainconf.gperf"
+      {"host_down_disable_service_checks", MAINCONF_host_down_disable_service_checks},
+      {""},
+#line 245 "mainconf.gperf"
+      {"use_agressive_host_checking", MAINCONF_use_agressive_host_checking},
+      {""}, {""},
+#line 330 "mainconf.gperf"
+      {"binary_object_precache", MAINCONF_binary_object_precache},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""},
+#line 181 "mainconf.gperf"
+      {"check_result_threads", MAINCONF_check_result_threads},
+      {""}, {""}, {""}, {""},
+#line 275 "mainconf.gperf"
+      {"check_service_freshness", MAINCONF_check_service_freshness},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+#line 277 "mainconf.gperf"
+      {"service_freshness_check_interval", MAINCONF_service_freshness_check_interval},
+      {""},
+#line 279 "mainconf.gperf"
+      {"host_freshness_check_interval", MAINCONF_host_freshness_check_interval},
+#line 328 "mainconf.gperf"
+      {"host_perfdata_process_empty_results", MAINCONF_host_perfdata_process_empty_results},
+#line 303 "mainconf.gperf"
+      {"environment_macros", MAINCONF_environment_macros},
+      {""}, {""},
+#line 290 "mainconf.gperf"
+      {"low_host_flap_threshold", MAINCONF_low_host_flap_threshold},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""},
+#line 305 "mainconf.gperf"
+      {"child_processes_fork_twice", MAINCONF_child_processes_fork_twice},
+      {""}, {""}, {""}, {""},
+#line 263 "mainconf.gperf"
+      {"max_host_check_spread", MAINCONF_max_host_check_spread},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""},
+#line 288 "mainconf.gperf"
+      {"low_service_flap_threshold", MAINCONF_low_service_flap_threshold},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""},
+#line 211 "mainconf.gperf"
+      {"log_service_retries", MAINCONF_log_service_retries},
+#line 212 "mainconf.gperf"
+      {"log_host_retries", MAINCONF_log_host_retries},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""},
+#line 183 "mainconf.gperf"
+      {"worker_shm_ring_size", MAINCONF_worker_shm_ring_size},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+#line 240 "mainconf.gperf"
+      {"host_check_timeout", MAINCONF_host_check_timeout},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""},
+#line 234 "mainconf.gperf"
+      {"obsess_over_services", MAINCONF_obsess_over_services}
+    };
+
+  if (len <= MAX_WORD_LENGTH && len >= MIN_WORD_LENGTH)
+    {
+      register unsigned int key = mainconf_key_phash (str, len);
+
+      if (key <= MAX_HASH_VALUE)
+        {
+          register const char *s = wordlist[key].name;
+
+          if (*str == *s && !strcmp (str + 1, s + 1))
+            return &wordlist[key];
+        }
+    }
+  return 0;
+}
@@ -46,6 +46,7 @@
 #include "../include/nebmods.h"
 #include "../include/nebmodules.h"
 #include "../include/workers.h"
+#include "../xdata/xodbinary.h"
 
 /*#define DEBUG_MEMORY 1*/
 #ifdef DEBUG_MEMORY
@@ -147,7 +148,8 @@ static int test_path_access(const char *program, int mode)
 
 static int nagios_core_worker(const char *path)
 {
-	int sd, ret;
+	int sd, ret, fds[4], nfds, nrecv = 0;
+	unsigned int len;
 	char response[128];
 
 	is_worker = 1;
@@ -161,24 +163,77 @@ static int nagios_core_worker(const char *path)
 		return 1;
 	}
 
-	ret = nsock_printf_nul(sd, "@wproc register name=Core Worker %ld;pid=%ld", (long)getpid(), (long)getpid());
+	ret = nsock_printf_nul(sd, "@wproc register name=Core Worker %ld;pid=%ld;frames=%d;shm=1;base_env=1",
+	                       (long)getpid(), (long)getpid(), WPROC_FRAME_VERSION);
 	if (ret < 0) {
 		printf("Failed to register as worker.\n");
 		return 1;
 	}
 
-	ret = read(sd, response, 3);
-	if (ret != 3) {
+	/*
+	 * Jobs may follow hot on the heels of the response, so we
+	 * mustn't read past its nul byte. The descriptors for our
+	 * shared memory rings come along with it, if we get any.
+	 */
+	for (len = 0; len < sizeof(response) - 1; len++) {
+		nfds = 4 - nrecv;
+		ret = shmring_recv_fds(sd, response + len, 1, fds + nrecv, &nfds);
+		nrecv += nfds;
+		if (ret != 1 || !response[len])
+			break;
+	}
+	response[len] = 0;
+	if (ret != 1) {
 		printf("Failed to read response from wproc manager\n");
 		return 1;
 	}
-	if (memcmp(response, "OK", 3)) {
-		read(sd, response + 3, sizeof(response) - 4);
-		response[sizeof(response) - 2] = 0;
+	if (strcmp(response, "OK") && strncmp(response, "OK frames=", 10)) {
 		printf("Failed to register with wproc manager: %s\n", response);
 		return 1;
 	}
 
+	/* older masters just say "OK" and get key/value vectors */
+	if (!strncmp(response, "OK frames=", 10))
+		worker_set_frame_version(atoi(response + 10));
+
+	/*
+	 * The master puts jobs in the ring as soon as it has replied,
+	 * so if we can't use the rings we can't work at all.
+	 */
+	if (strstr(response, ";shm=")) {
+		shmring *jobs = NULL, *results = NULL;
+
+		if (nrecv == 4) {
+			jobs = shmring_attach(fds[0], fds[1]);
+			results = shmring_attach(fds[2], fds[3]);
+		}
+		if (!jobs || !results) {
+			printf("Failed to map shared memory rings: %s\n", strerror(errno));
+			return 1;
+		}
+		worker_set_rings(jobs, results);
+	}
+	else {
+		while (nrecv)
+			close(fds[--nrecv]);
+	}
+
+	/* the macros that are the same for all jobs come right after */
+	if (strstr(response, ";base_env=1")) {
+		unsigned long size;
+		char *frame = worker_read_frame(sd, &size);
+
+		if (!frame || worker_set_env_frame(frame, size) < 0) {
+			printf("Failed to read environment from wproc manager\n");
+			free(frame);
+			return 1;
+		}
+		free(frame);
+	}
+
+	if (worker_use_posix_spawn && runcmd_use_spawn(1) < 0)
+		printf("posix_spawn() is unavailable; plugins will be forked\n");
+
 	enter_worker(sd, start_cmd);
 	free_worker_memory(WPROC_FORCE);
 	free_memory(get_global_macros());
@@ -246,6 +301,7 @@ int main(int argc, char **argv) {
 			{"use-precached-objects", no_argument, 0, 'u'},
 			{"enable-timing-point", no_argument, 0, 'T'},
 			{"worker", required_argument, 0, 'W'},
+			{"worker-posix-spawn", no_argument, 0, 'S'},
 			{0, 0, 0, 0}
 		};
 #define getopt(argc, argv, o) getopt_long(argc, argv, o, long_options, &option_index)
@@ -301,6 +357,9 @@ int main(int argc, char **argv) {
 			case 'W':
 				worker_socket = optarg;
 				break;
+			case 'S':
+				worker_use_posix_spawn = TRUE;
+				break;
 
 			case 'x':
 				printf("Warning: -x is deprecated and will be removed\n");
@@ -371,6 +430,7 @@ int main(int argc, char **argv) {
 		printf("  -u, --use-precached-objects  Use precached object config file\n");
 		printf("  -d, --daemon                 Starts Nagios in daemon mode, instead of as a foreground process\n");
 		printf("  -W, --worker /path/to/socket Act as a worker for an already running daemon\n");
+		printf("      --worker-posix-spawn     Make the worker start plugins with posix_spawn()\n");
 		printf("\n");
 		printf("Visit the Nagios website at https://www.nagios.org/ for bug fixes, new\n");
 		printf("releases, online documentation, FAQs, information on subscribing to\n");
@@ -528,7 +588,10 @@ int main(int argc, char **argv) {
 			}
 
 		if(precache_objects) {
-			result = fcache_objects(object_precache_file);
+			if(binary_object_precache == TRUE)
+				result = xodbinary_write_precache(object_precache_file);
+			else
+				result = fcache_objects(object_precache_file);
 			timing_point("Done precaching objects\n");
 			if(result == OK) {
 				printf("Object precache file created:\n%s\n", object_precache_file);
@@ -814,6 +877,16 @@ int main(int argc, char **argv) {
 			check_for_nagios_updates(FALSE, TRUE);
 			timing_point("Update check concluded\n");
 
+			/* flatten the contacts each object notifies */
+			if(init_contact_fanout() == ERROR)
+				logit(NSLOG_RUNTIME_ERROR, TRUE, "Error: Failed to build the contact lists for notifications.\n");
+			timing_point("Contact fanout lists built\n");
+
+			/* index custom variables for macros and external commands */
+			if(init_custom_variable_index() == ERROR)
+				logit(NSLOG_RUNTIME_ERROR, TRUE, "Error: Failed to index custom variables.\n");
+			timing_point("Custom variables indexed\n");
+
 			/* update all status data (with retained information) */
 			update_all_status_data();
 			timing_point("Status data updated\n");
@@ -830,6 +903,20 @@ int main(int argc, char **argv) {
 			launch_command_file_worker();
 			timing_point("Command file worker launched\n");
 
+			/* we're done forking, so log writes can go to a thread */
+			start_log_thread();
+			timing_point("Log thread started\n");
+
+			/* start journaling changes to retained state */
+			open_retention_journal();
+			timing_point("Retention journal opened\n");
+
+			/* the trace ring outlives restarts, so it's only created once */
+			if(trace_buffer_size > 0 && nagios_trace == NULL) {
+				if((nagios_trace = tracering_create(trace_buffer_size)) == NULL)
+					logit(NSLOG_RUNTIME_WARNING, TRUE, "Warning: Failed to create a trace ring of %u records\n", trace_buffer_size);
+				}
+
 #ifdef USE_EVENT_BROKER
 			/* send program data to broker */
 			broker_program_state(NEBTYPE_PROCESS_EVENTLOOPSTART, NEBFLAG_NONE, NEBATTR_NONE, NULL);
@@ -872,6 +959,7 @@ int main(int argc, char **argv) {
 
 			/* save service and host state information */
 			save_state_information(FALSE);
+			close_retention_journal();
 			cleanup_retention_data();
 
 			/* clean up performance data */
@@ -933,6 +1021,8 @@ int main(int argc, char **argv) {
 		my_free(config_file);
 		my_free(config_file_dir);
 		my_free(nagios_binary_path);
+		tracering_destroy(nagios_trace);
+		nagios_trace = NULL;
 		}
 
 	return OK;
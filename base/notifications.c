@@ -78,6 +78,7 @@ int service_notification(service *svc, int type, char *not_author, char *not_dat
 	int result = OK;
 	int contacts_notified = 0;
 	int increment_notification_number = FALSE;
+	time_t old_next_notification;
 	nagios_macros mac;
 	int neb_result;
 
@@ -88,6 +89,7 @@ int service_notification(service *svc, int type, char *not_author, char *not_dat
 	gettimeofday(&start_time, NULL);
 
 	log_debug_info(DEBUGL_NOTIFICATIONS, 0, "** Service Notification Attempt ** Host: '%s', Service: '%s', Type: %s, Options: %d, Current State: %d, Last Notification: %s", svc->host_name, svc->description, notification_reason_name(type), options, svc->current_state, ctime(&svc->last_notification));
+	nagios_trace_event(TRACE_NOTIFICATION, TRACE_SERVICE, svc->id, type);
 
 	/* if we couldn't find the host, return an error */
 	if((temp_host = svc->host_ptr) == NULL) {
@@ -96,6 +98,7 @@ int service_notification(service *svc, int type, char *not_author, char *not_dat
 		}
 
 	/* check the viability of sending out a service notification */
+	old_next_notification = svc->next_notification;
 	if(check_service_notification_viability(svc, type, options) == ERROR) {
 		log_debug_info(DEBUGL_NOTIFICATIONS, 0, "Notification viability test failed.  No notification will be sent out.\n");
 		/* Set next_notification time if we're in a downtime and
@@ -106,6 +109,8 @@ int service_notification(service *svc, int type, char *not_author, char *not_dat
 				if (temp_host->scheduled_downtime_depth > 0 || svc->scheduled_downtime_depth > 0)
 					svc->next_notification = current_time;
 				}
+		if(svc->next_notification != old_next_notification)
+			update_service_status(svc, FALSE);
 		return ERROR;
 		}
 
@@ -134,6 +139,7 @@ int service_notification(service *svc, int type, char *not_author, char *not_dat
 		log_debug_info(DEBUGL_CHECKS, 0, "Service notification to %s;%s (id=%u) was blocked by a module\n",
 		               svc->host_name, svc->description, svc->id);
 		free_notification_list();
+		update_service_status(svc, FALSE);
 		return neb_result == NEBERROR_CALLBACKOVERRIDE ? OK : ERROR;
 		}
 #endif
@@ -923,13 +929,40 @@ int should_service_notification_be_escalated(service *svc) {
 	}
 
 
+/* makes sure the contact fanout lists exist, in case they weren't built at startup */
+static int have_contact_fanout(void) {
+
+	if(host_contact_fanout != NULL)
+		return TRUE;
+
+	if(init_contact_fanout() == ERROR) {
+		logit(NSLOG_RUNTIME_ERROR, TRUE, "Error: Failed to build the contact lists for notifications.\n");
+		return FALSE;
+		}
+
+	return TRUE;
+	}
+
+
+/* adds the contacts in a fanout list that can be notified about a service */
+static void add_service_fanout_to_notification_list(nagios_macros *mac, service *svc, struct contact_fanout *fanout, int type, int options) {
+	contact *temp_contact = NULL;
+	unsigned int i;
+
+	for(i = 0; i < fanout->count; i++) {
+		temp_contact = fanout->contacts[i];
+		/* check now if the contact can be notified */
+		if(check_contact_service_notification_viability(temp_contact, svc, type, options) == OK)
+			add_notification(mac, temp_contact);
+		else
+			log_debug_info(DEBUGL_NOTIFICATIONS, 2, "Not adding contact '%s'\n", temp_contact->name);
+		}
+	}
+
+
 /* given a service, create a list of contacts to be notified, removing duplicates, checking contact notification viability */
 int create_notification_list_from_service(nagios_macros *mac, service *svc, int options, int *escalated, int type) {
 	serviceescalation *temp_se = NULL;
-	contactsmember *temp_contactsmember = NULL;
-	contact *temp_contact = NULL;
-	contactgroupsmember *temp_contactgroupsmember = NULL;
-	contactgroup *temp_contactgroup = NULL;
 	int escalate_notification = FALSE;
 
 
@@ -947,6 +980,9 @@ int create_notification_list_from_service(nagios_macros *mac, service *svc, int
 	/* set the escalation macro */
 	mac->x[MACRO_NOTIFICATIONISESCALATED] = strdup(escalate_notification ? "1" : "0");
 
+	if(have_contact_fanout() == FALSE)
+		return ERROR;
+
 	if(options & NOTIFICATION_OPTION_BROADCAST)
 		log_debug_info(DEBUGL_NOTIFICATIONS, 1, "This notification will be BROADCAST to all (escalated and normal) contacts...\n");
 
@@ -964,36 +1000,8 @@ int create_notification_list_from_service(nagios_macros *mac, service *svc, int
 			if(is_valid_escalation_for_service_notification(svc, temp_se, options) == FALSE)
 				continue;
 
-			log_debug_info(DEBUGL_NOTIFICATIONS, 2, "Adding individual contacts from service escalation(s) to notification list.\n");
-
-			/* add all individual contacts for this escalation entry */
-			for(temp_contactsmember = temp_se->contacts; temp_contactsmember != NULL; temp_contactsmember = temp_contactsmember->next) {
-				if((temp_contact = temp_contactsmember->contact_ptr) == NULL)
-					continue;
-				/* check now if the contact can be notified */
-				if (check_contact_service_notification_viability(temp_contact, svc, type, options) == OK)
-					add_notification(mac, temp_contact);
-				else
-					log_debug_info(DEBUGL_NOTIFICATIONS, 2, "Not adding contact '%s'\n",temp_contact->name);
-				}
-
-			log_debug_info(DEBUGL_NOTIFICATIONS, 2, "Adding members of contact groups from service escalation(s) to notification list.\n");
-
-			/* add all contacts that belong to contactgroups for this escalation */
-			for(temp_contactgroupsmember = temp_se->contact_groups; temp_contactgroupsmember != NULL; temp_contactgroupsmember = temp_contactgroupsmember->next) {
-				log_debug_info(DEBUGL_NOTIFICATIONS, 2, "Adding members of contact group '%s' for service escalation to notification list.\n", temp_contactgroupsmember->group_name);
-				if((temp_contactgroup = temp_contactgroupsmember->group_ptr) == NULL)
-					continue;
-				for(temp_contactsmember = temp_contactgroup->members; temp_contactsmember != NULL; temp_contactsmember = temp_contactsmember->next) {
-					if((temp_contact = temp_contactsmember->contact_ptr) == NULL)
-						continue;
-					/* check now if the contact can be notified */
-					if (check_contact_service_notification_viability(temp_contact, svc, type, options) == OK)
-						add_notification(mac, temp_contact);
-					else
-						log_debug_info(DEBUGL_NOTIFICATIONS, 2, "Not adding contact '%s'\n",temp_contact->name);
-					}
-				}
+			/* add all individual contacts and contactgroup members for this escalation entry */
+			add_service_fanout_to_notification_list(mac, svc, &serviceescalation_contact_fanout[temp_se->id], type, options);
 			}
 		}
 
@@ -1002,32 +1010,8 @@ int create_notification_list_from_service(nagios_macros *mac, service *svc, int
 
 		log_debug_info(DEBUGL_NOTIFICATIONS, 1, "Adding normal contacts for service to notification list.\n");
 
-		/* add all individual contacts for this service */
-		for(temp_contactsmember = svc->contacts; temp_contactsmember != NULL; temp_contactsmember = temp_contactsmember->next) {
-			if((temp_contact = temp_contactsmember->contact_ptr) == NULL)
-				continue;
-			/* check now if the contact can be notified */
-                        if (check_contact_service_notification_viability(temp_contact, svc, type, options) == OK)
-                                add_notification(mac, temp_contact);
-                        else
-                                log_debug_info(DEBUGL_NOTIFICATIONS, 2, "Not adding contact '%s'\n",temp_contact->name);
-			}
-
-		/* add all contacts that belong to contactgroups for this service */
-		for(temp_contactgroupsmember = svc->contact_groups; temp_contactgroupsmember != NULL; temp_contactgroupsmember = temp_contactgroupsmember->next) {
-			log_debug_info(DEBUGL_NOTIFICATIONS, 2, "Adding members of contact group '%s' for service to notification list.\n", temp_contactgroupsmember->group_name);
-			if((temp_contactgroup = temp_contactgroupsmember->group_ptr) == NULL)
-				continue;
-			for(temp_contactsmember = temp_contactgroup->members; temp_contactsmember != NULL; temp_contactsmember = temp_contactsmember->next) {
-				if((temp_contact = temp_contactsmember->contact_ptr) == NULL)
-					continue;
-	                        /* check now if the contact can be notified */
-	                        if (check_contact_service_notification_viability(temp_contact, svc, type, options) == OK)
-                                	add_notification(mac, temp_contact);
-	                        else
-	                                log_debug_info(DEBUGL_NOTIFICATIONS, 2, "Not adding contact '%s'\n",temp_contact->name);
-				}
-			}
+		/* add all individual contacts and contactgroup members for this service */
+		add_service_fanout_to_notification_list(mac, svc, &service_contact_fanout[svc->id], type, options);
 		}
 
 	return OK;
@@ -1053,6 +1037,7 @@ int host_notification(host *hst, int type, char *not_author, char *not_data, int
 	int result = OK;
 	int contacts_notified = 0;
 	int increment_notification_number = FALSE;
+	time_t old_next_notification;
 	nagios_macros mac;
 	int neb_result;
 
@@ -1061,11 +1046,15 @@ int host_notification(host *hst, int type, char *not_author, char *not_data, int
 	gettimeofday(&start_time, NULL);
 
 	log_debug_info(DEBUGL_NOTIFICATIONS, 0, "** Host Notification Attempt ** Host: '%s', Type: %s, Options: %d, Current State: %d, Last Notification: %s", hst->name, notification_reason_name(type), options, hst->current_state, ctime(&hst->last_notification));
+	nagios_trace_event(TRACE_NOTIFICATION, TRACE_HOST, hst->id, type);
 
 
 	/* check viability of sending out a host notification */
+	old_next_notification = hst->next_notification;
 	if(check_host_notification_viability(hst, type, options) == ERROR) {
 		log_debug_info(DEBUGL_NOTIFICATIONS, 0, "Notification viability test failed.  No notification will be sent out.\n");
+		if(hst->next_notification != old_next_notification)
+			update_host_status(hst, FALSE);
 		return ERROR;
 		}
 
@@ -1093,6 +1082,7 @@ int host_notification(host *hst, int type, char *not_author, char *not_data, int
 	if(neb_result == NEBERROR_CALLBACKCANCEL || neb_result == NEBERROR_CALLBACKOVERRIDE) {
 		log_debug_info(DEBUGL_NOTIFICATIONS, 0, "Host notification to %s (id=%u) was blocked by a module.\n", hst->name, hst->id);
 		free_notification_list();
+		update_host_status(hst, FALSE);
 		return neb_result == NEBERROR_CALLBACKOVERRIDE ? OK : ERROR;
 		}
 #endif
@@ -1824,13 +1814,25 @@ int should_host_notification_be_escalated(host *hst) {
 	}
 
 
+/* adds the contacts in a fanout list that can be notified about a host */
+static void add_host_fanout_to_notification_list(nagios_macros *mac, host *hst, struct contact_fanout *fanout, int type, int options) {
+	contact *temp_contact = NULL;
+	unsigned int i;
+
+	for(i = 0; i < fanout->count; i++) {
+		temp_contact = fanout->contacts[i];
+		/* check now if the contact can be notified */
+		if(check_contact_host_notification_viability(temp_contact, hst, type, options) == OK)
+			add_notification(mac, temp_contact);
+		else
+			log_debug_info(DEBUGL_NOTIFICATIONS, 2, "Not adding contact '%s'\n", temp_contact->name);
+		}
+	}
+
+
 /* given a host, create a list of contacts to be notified, removing duplicates, checking contact notification viability */
 int create_notification_list_from_host(nagios_macros *mac, host *hst, int options, int *escalated, int type) {
 	hostescalation *temp_he = NULL;
-	contactsmember *temp_contactsmember = NULL;
-	contact *temp_contact = NULL;
-	contactgroupsmember *temp_contactgroupsmember = NULL;
-	contactgroup *temp_contactgroup = NULL;
 	int escalate_notification = FALSE;
 
 	log_debug_info(DEBUGL_FUNCTIONS, 0, "create_notification_list_from_host()\n");
@@ -1847,6 +1849,9 @@ int create_notification_list_from_host(nagios_macros *mac, host *hst, int option
 	/* set the escalation macro */
 	mac->x[MACRO_NOTIFICATIONISESCALATED] = strdup(escalate_notification ? "1" : "0");
 
+	if(have_contact_fanout() == FALSE)
+		return ERROR;
+
 	if(options & NOTIFICATION_OPTION_BROADCAST)
 		log_debug_info(DEBUGL_NOTIFICATIONS, 1, "This notification will be BROADCAST to all (escalated and normal) contacts...\n");
 
@@ -1864,36 +1869,8 @@ int create_notification_list_from_host(nagios_macros *mac, host *hst, int option
 			if(is_valid_escalation_for_host_notification(hst, temp_he, options) == FALSE)
 				continue;
 
-			log_debug_info(DEBUGL_NOTIFICATIONS, 2, "Adding individual contacts from host escalation(s) to notification list.\n");
-
-			/* add all individual contacts for this escalation */
-			for(temp_contactsmember = temp_he->contacts; temp_contactsmember != NULL; temp_contactsmember = temp_contactsmember->next) {
-				if((temp_contact = temp_contactsmember->contact_ptr) == NULL)
-					continue;
-				/* check now if the contact can be notified */
-				if (check_contact_host_notification_viability(temp_contact, hst, type, options) == OK)
-					add_notification(mac, temp_contact);
-				else
-					log_debug_info(DEBUGL_NOTIFICATIONS, 2, "Not adding contact '%s'\n", temp_contact->name);
-				}
-
-			log_debug_info(DEBUGL_NOTIFICATIONS, 2, "Adding members of contact groups from host escalation(s) to notification list.\n");
-
-			/* add all contacts that belong to contactgroups for this escalation */
-			for(temp_contactgroupsmember = temp_he->contact_groups; temp_contactgroupsmember != NULL; temp_contactgroupsmember = temp_contactgroupsmember->next) {
-				log_debug_info(DEBUGL_NOTIFICATIONS, 2, "Adding members of contact group '%s' for host escalation to notification list.\n", temp_contactgroupsmember->group_name);
-				if((temp_contactgroup = temp_contactgroupsmember->group_ptr) == NULL)
-					continue;
-				for(temp_contactsmember = temp_contactgroup->members; temp_contactsmember != NULL; temp_contactsmember = temp_contactsmember->next) {
-					if((temp_contact = temp_contactsmember->contact_ptr) == NULL)
-						continue;
-	                                /* check now if the contact can be notified */
-	                                if (check_contact_host_notification_viability(temp_contact, hst, type, options) == OK)
-	                                        add_notification(mac, temp_contact);
-	                                else
-	                                        log_debug_info(DEBUGL_NOTIFICATIONS, 2, "Not adding contact '%s'\n", temp_contact->name);
-					}
-				}
+			/* add all individual contacts and contactgroup members for this escalation */
+			add_host_fanout_to_notification_list(mac, hst, &hostescalation_contact_fanout[temp_he->id], type, options);
 			}
 		}
 
@@ -1902,37 +1879,8 @@ int create_notification_list_from_host(nagios_macros *mac, host *hst, int option
 
 		log_debug_info(DEBUGL_NOTIFICATIONS, 1, "Adding normal contacts for host to notification list.\n");
 
-		log_debug_info(DEBUGL_NOTIFICATIONS, 2, "Adding individual contacts for host to notification list.\n");
-
-		/* add all individual contacts for this host */
-		for(temp_contactsmember = hst->contacts; temp_contactsmember != NULL; temp_contactsmember = temp_contactsmember->next) {
-			if((temp_contact = temp_contactsmember->contact_ptr) == NULL)
-				continue;
-                        /* check now if the contact can be notified */
-                        if (check_contact_host_notification_viability(temp_contact, hst, type, options) == OK)
-                                add_notification(mac, temp_contact);
-                        else
-                                log_debug_info(DEBUGL_NOTIFICATIONS, 2, "Not adding contact '%s'\n", temp_contact->name);
-			}
-
-		log_debug_info(DEBUGL_NOTIFICATIONS, 2, "Adding members of contact groups for host to notification list.\n");
-
-		/* add all contacts that belong to contactgroups for this host */
-		for(temp_contactgroupsmember = hst->contact_groups; temp_contactgroupsmember != NULL; temp_contactgroupsmember = temp_contactgroupsmember->next) {
-			log_debug_info(DEBUGL_NOTIFICATIONS, 2, "Adding members of contact group '%s' for host to notification list.\n", temp_contactgroupsmember->group_name);
-
-			if((temp_contactgroup = temp_contactgroupsmember->group_ptr) == NULL)
-				continue;
-			for(temp_contactsmember = temp_contactgroup->members; temp_contactsmember != NULL; temp_contactsmember = temp_contactsmember->next) {
-				if((temp_contact = temp_contactsmember->contact_ptr) == NULL)
-					continue;
-	                        /* check now if the contact can be notified */
-	                        if (check_contact_host_notification_viability(temp_contact, hst, type, options) == OK)
-	                                add_notification(mac, temp_contact);
-	                        else
-	                                log_debug_info(DEBUGL_NOTIFICATIONS, 2, "Not adding contact '%s'\n", temp_contact->name);
-				}
-			}
+		/* add all individual contacts and contactgroup members for this host */
+		add_host_fanout_to_notification_list(mac, hst, &host_contact_fanout[hst->id], type, options);
 		}
 
 	return OK;
@@ -2090,10 +2038,34 @@ notification * find_notification(contact *cntct) {
 
 
 
+/*
+ * $NOTIFICATIONRECIPIENTS$ as add_notification() is building it for the
+ * current notification list, so contacts can be appended without
+ * looking for the end of the string every time. The string belongs to
+ * mac; we only keep track of it, and start over with every new list.
+ */
+static struct {
+	nagios_macros *mac;
+	char *buf;
+	size_t len;
+	size_t size;
+	} recipients;
+
+/* starts keeping track of the recipients macro in mac, as it is now */
+static void start_recipients(nagios_macros *mac) {
+
+	recipients.mac = mac;
+	recipients.buf = mac->x[MACRO_NOTIFICATIONRECIPIENTS];
+	recipients.len = recipients.buf ? strlen(recipients.buf) : 0;
+	recipients.size = recipients.buf ? recipients.len + 1 : 0;
+	}
+
 /* add a new notification to the list in memory */
 int add_notification(nagios_macros *mac, contact *cntct) {
 	notification *new_notification = NULL;
-	notification *temp_notification = NULL;
+	char *buf = NULL;
+	size_t name_len = 0;
+	int result = 0;
 
 	log_debug_info(DEBUGL_FUNCTIONS, 0, "add_notification() start\n");
 
@@ -2102,8 +2074,15 @@ int add_notification(nagios_macros *mac, contact *cntct) {
 
 	log_debug_info(DEBUGL_NOTIFICATIONS, 2, "Adding contact '%s' to notification list.\n", cntct->name);
 
+	/* an empty list means a new one, so forget who was on the last one */
+	if(notification_list == NULL) {
+		new_contact_marks();
+		start_recipients(mac);
+		}
+
 	/* don't add anything if this contact is already on the notification list */
-	if((temp_notification = find_notification(cntct)) != NULL)
+	result = mark_contact(cntct);
+	if(result == FALSE || (result == ERROR && find_notification(cntct) != NULL))
 		return OK;
 
 	/* allocate memory for a new contact in the notification list */
@@ -2118,14 +2097,26 @@ int add_notification(nagios_macros *mac, contact *cntct) {
 	notification_list = new_notification;
 
 	/* add contact to notification recipients macro */
-	if(mac->x[MACRO_NOTIFICATIONRECIPIENTS] == NULL)
-		mac->x[MACRO_NOTIFICATIONRECIPIENTS] = (char *)strdup(cntct->name);
-	else {
-		if((mac->x[MACRO_NOTIFICATIONRECIPIENTS] = (char *)realloc(mac->x[MACRO_NOTIFICATIONRECIPIENTS], strlen(mac->x[MACRO_NOTIFICATIONRECIPIENTS]) + strlen(cntct->name) + 2))) {
-			strcat(mac->x[MACRO_NOTIFICATIONRECIPIENTS], ",");
-			strcat(mac->x[MACRO_NOTIFICATIONRECIPIENTS], cntct->name);
-			}
-		}
+	name_len = strlen(cntct->name);
+	if(recipients.mac != mac || recipients.buf != mac->x[MACRO_NOTIFICATIONRECIPIENTS]) {
+		/* the macro was replaced since we last added to it */
+		start_recipients(mac);
+		}
+
+	if(recipients.len + name_len + 2 > recipients.size) {
+		size_t size = recipients.size ? recipients.size * 2 : 64;
+		while(size < recipients.len + name_len + 2)
+			size *= 2;
+		if((buf = realloc(recipients.buf, size)) == NULL)
+			return OK;
+		recipients.buf = mac->x[MACRO_NOTIFICATIONRECIPIENTS] = buf;
+		recipients.size = size;
+		}
+
+	if(recipients.len)
+		recipients.buf[recipients.len++] = ',';
+	memcpy(recipients.buf + recipients.len, cntct->name, name_len + 1);
+	recipients.len += name_len;
 
 	return OK;
 	}
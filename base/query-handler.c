@@ -1,5 +1,6 @@
 #include "include/config.h"
 #include "include/nagios.h"
+#include "include/sretention.h"
 #include "lib/libnagios.h"
 #include "lib/nsock.h"
 #include <unistd.h>
@@ -348,8 +349,276 @@ int qh_register_handler(const char *name, const char *description, unsigned int
 	return 0;
 }
 
+/*
+ * Clients following the trace ring with "@trace stream". Records that
+ * didn't fit in the socket buffer are kept here until the next flush.
+ */
+#define TRACE_STREAM_RECS 128
+struct trace_stream {
+	int sd;
+	uint64_t pos;
+	unsigned int off, len;
+	struct tracering_rec recs[TRACE_STREAM_RECS];
+	struct trace_stream *next;
+};
+static struct trace_stream *trace_streams;
+
+static void trace_stream_close(struct trace_stream *ts)
+{
+	struct trace_stream *prev = NULL, *cur;
+
+	for (cur = trace_streams; cur != NULL; prev = cur, cur = cur->next) {
+		if (cur != ts) {
+			continue;
+		}
+		if (prev != NULL) {
+			prev->next = ts->next;
+		} else {
+			trace_streams = ts->next;
+		}
+		break;
+	}
+
+	iobroker_close(nagios_iobs, ts->sd);
+	free(ts);
+	qh_running--;
+}
+
+/* sends what we can without blocking. returns -1 if the client is gone */
+static int trace_stream_send(struct trace_stream *ts)
+{
+	ssize_t wrote;
+	unsigned int n;
+
+	for (;;) {
+		if (ts->off == ts->len) {
+			if (nagios_trace == NULL) {
+				return 0;
+			}
+			n = tracering_read(nagios_trace, &ts->pos, ts->recs, TRACE_STREAM_RECS);
+			if (n == 0) {
+				return 0;
+			}
+			ts->off = 0;
+			ts->len = n * sizeof(struct tracering_rec);
+		}
+
+		wrote = send(ts->sd, (char *)ts->recs + ts->off, ts->len - ts->off, MSG_DONTWAIT | MSG_NOSIGNAL);
+		if (wrote < 0) {
+			if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+				return 0;
+			}
+			return -1;
+		}
+		ts->off += wrote;
+	}
+}
+
+/* streaming clients have nothing to say, so input means they're leaving */
+static int trace_stream_input(int sd, int events, void *arg)
+{
+	struct trace_stream *ts = (struct trace_stream *)arg;
+	char buf[256];
+	ssize_t result;
+
+	result = read(sd, buf, sizeof(buf));
+	if (result == 0 || (result < 0 && errno != EAGAIN && errno != EINTR)) {
+		trace_stream_close(ts);
+	}
+
+	return 0;
+}
+
+void qh_trace_flush(void)
+{
+	struct trace_stream *ts, *next;
+
+	for (ts = trace_streams; ts != NULL; ts = next) {
+		next = ts->next;
+		if (trace_stream_send(ts) < 0) {
+			trace_stream_close(ts);
+		}
+	}
+}
+
+static int trace_send_all(int sd, const void *buf, size_t len)
+{
+	const char *p = (const char *)buf;
+	ssize_t wrote;
+
+	while (len > 0) {
+		wrote = send(sd, p, len, MSG_NOSIGNAL);
+		if (wrote < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return -1;
+		}
+		p += wrote;
+		len -= wrote;
+	}
+
+	return 0;
+}
+
+/* writes the header and everything still in the ring */
+static int trace_dump(int sd)
+{
+	struct tracering_header hdr;
+	struct tracering_rec recs[256];
+	struct timeval tv = { 5, 0 };
+	uint64_t pos;
+	unsigned int n;
+
+	/* the dump is done in one go, but a stuck client mustn't stall us */
+	fcntl(sd, F_SETFL, fcntl(sd, F_GETFL) & ~O_NONBLOCK);
+	setsockopt(sd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+
+	pos = tracering_oldest(nagios_trace);
+	tracering_header(nagios_trace, &hdr, pos);
+	if (trace_send_all(sd, &hdr, sizeof(hdr)) < 0) {
+		return QH_CLOSE;
+	}
+
+	while ((n = tracering_read(nagios_trace, &pos, recs, ARRAY_SIZE(recs))) > 0) {
+		if (trace_send_all(sd, recs, n * sizeof(recs[0])) < 0) {
+			break;
+		}
+	}
+
+	return QH_CLOSE;
+}
+
+static int trace_stream_start(int sd)
+{
+	struct trace_stream *ts;
+	struct tracering_header hdr;
+
+	ts = calloc(1, sizeof(*ts));
+	if (ts == NULL) {
+		return 500;
+	}
+
+	ts->sd = sd;
+	ts->pos = tracering_count(nagios_trace);
+	tracering_header(nagios_trace, &hdr, ts->pos);
+	if (trace_send_all(sd, &hdr, sizeof(hdr)) < 0) {
+		free(ts);
+		return QH_CLOSE;
+	}
+
+	iobroker_unregister(nagios_iobs, sd);
+	if (iobroker_register(nagios_iobs, sd, ts, trace_stream_input) < 0) {
+		logit(NSLOG_RUNTIME_ERROR, TRUE, "qh: Failed to register trace stream socket %d with I/O broker\n", sd);
+		free(ts);
+		close(sd);
+		qh_running--;
+		return QH_TAKEOVER;
+	}
+
+	ts->next = trace_streams;
+	trace_streams = ts;
+
+	return QH_TAKEOVER;
+}
+
+static int qh_trace(int sd, char *buf, unsigned int len)
+{
+	struct trace_stream *ts;
+	unsigned int size;
+
+	if (buf == NULL || !strcmp(buf, "help")) {
+
+		nsock_printf_nul(sd,
+			"Query handler for the binary trace ring.\n"
+			"Available commands:\n"
+			"  status            Print the trace ring size, record count and streams\n"
+			"  start [<records>] Start tracing, or resize the trace ring\n"
+			"  stop              Stop tracing and free the trace ring\n"
+			"  dump              Send everything in the trace ring and close\n"
+			"  stream            Send new records as they're added. Use '@trace stream'\n"
+			"Dumps and streams are binary. Decode them with contrib/nagiostrace.\n"
+		);
+
+		return 0;
+	}
+
+	if (!strcmp(buf, "status")) {
+
+		unsigned int streams = 0;
+
+		for (ts = trace_streams; ts != NULL; ts = ts->next) {
+			streams++;
+		}
+
+		nsock_printf_nul(sd, "enabled=%d;size=%u;count=%llu;oldest=%llu;streams=%u;",
+			nagios_trace != NULL,
+			nagios_trace ? tracering_size(nagios_trace) : 0,
+			nagios_trace ? (unsigned long long)tracering_count(nagios_trace) : 0ULL,
+			nagios_trace ? (unsigned long long)tracering_oldest(nagios_trace) : 0ULL,
+			streams);
+
+		return 0;
+	}
+
+	if (!strncmp(buf, "start", 5) && (buf[5] == 0 || buf[5] == ' ')) {
+
+		size = buf[5] ? (unsigned int)strtoul(buf + 6, NULL, 10) : 0;
+		if (size == 0) {
+			size = trace_buffer_size ? trace_buffer_size : 65536;
+		}
+		if (size > (1 << 24)) {
+			return 400;
+		}
+
+		if (nagios_trace != NULL && tracering_size(nagios_trace) >= size) {
+			return 200;
+		}
+
+		tracering_destroy(nagios_trace);
+		nagios_trace = tracering_create(size);
+		if (nagios_trace == NULL) {
+			return 500;
+		}
+
+		/* record numbers start over in the new ring */
+		for (ts = trace_streams; ts != NULL; ts = ts->next) {
+			ts->pos = 0;
+		}
+
+		return 200;
+	}
+
+	if (!strcmp(buf, "stop")) {
+
+		tracering_destroy(nagios_trace);
+		nagios_trace = NULL;
+		return 200;
+	}
+
+	if (nagios_trace == NULL) {
+		return 409;
+	}
+
+	if (!strcmp(buf, "dump")) {
+
+		return trace_dump(sd);
+	}
+
+	if (!strcmp(buf, "stream")) {
+
+		return trace_stream_start(sd);
+	}
+
+	return 404;
+}
+
 void qh_deinit(const char *path)
 {
+	while (trace_streams) {
+		trace_stream_close(trace_streams);
+	}
+
 	while (qhandlers) {
 		qh_deregister_handler(qhandlers->name);
 	}
@@ -413,6 +682,10 @@ static int qh_core(int sd, char *buf, unsigned int len)
 			"                    The options are the same parameters and format as\n"
 			"                    returned above.\n"
 			"  squeuestats       scheduling queue statistics\n"
+			"  statusstats       status data dump statistics (dirty objects\n"
+			"                    re-rendered and clean objects reused)\n"
+			"  logstats          log thread buffer, overflow and write statistics\n"
+			"  retentionstats    retention data save mode, durations and file size\n"
 		);
 
 		return 0;
@@ -451,6 +724,21 @@ static int qh_core(int sd, char *buf, unsigned int len)
 
 			return dump_event_stats(sd);
 		}
+
+		else if (!strcmp(buf, "statusstats")) {
+
+			return dump_status_data_stats(sd);
+		}
+
+		else if (!strcmp(buf, "logstats")) {
+
+			return dump_log_thread_stats(sd);
+		}
+
+		else if (!strcmp(buf, "retentionstats")) {
+
+			return dump_retention_stats(sd);
+		}
 	}
 
 	/* space != NULL: */
@@ -538,5 +826,10 @@ int qh_init(const char *path)
 		logit(NSLOG_INFO_MESSAGE, FALSE, "qh: help for the query handler registered\n");
 	}
 
+	result = qh_register_handler("trace", "Binary trace ring dumps and streams", 0, qh_trace);
+	if (result == OK) {
+		logit(NSLOG_INFO_MESSAGE, FALSE, "qh: trace query handler registered\n");
+	}
+
 	return 0;
 }
@@ -29,6 +29,8 @@
 #include "../include/nagios.h"
 #include "../include/sretention.h"
 #include "../include/broker.h"
+#include "../include/comments.h"
+#include "../include/downtime.h"
 #include "../xdata/xrddefault.h"		/* default routines */
 
 
@@ -51,9 +53,174 @@ int cleanup_retention_data(void) {
 
 
 
+/*
+ * In background mode, retention data is saved by a fork()ed child,
+ * which gets a copy-on-write snapshot of everything we'd otherwise
+ * have to copy. The event loop is only held up for the fork() itself.
+ * The child reports back over a pipe once the temp file has been
+ * renamed into place.
+ */
+struct retention_save_result {
+	int result;
+	double duration;            /* seconds spent writing the file */
+	unsigned long long size;    /* size of the file written */
+	};
+
+static struct {
+	pid_t pid;                  /* child saving in the background, if any */
+	int fd;                     /* our end of its result pipe */
+	int autosave;
+	unsigned long saves;
+	unsigned long failures;
+	unsigned long skipped;      /* saves requested while one was running */
+	time_t last_save;
+	double last_pause;          /* seconds the event loop was held up */
+	double last_duration;       /* seconds spent writing the file */
+	unsigned long long last_size;
+	off_t journal_offset;       /* how much of the journal the save covers */
+	} retention_save;
+
+
+static unsigned long long retention_file_size(void) {
+	struct stat st;
+
+	if(retention_file == NULL || stat(retention_file, &st) < 0)
+		return 0;
+
+	return (unsigned long long)st.st_size;
+	}
+
+
+static void finish_state_information_save(struct retention_save_result *res, int autosave) {
+
+	retention_save.last_save = time(NULL);
+	retention_save.last_duration = res->duration;
+	if(res->result == OK) {
+		retention_save.saves++;
+		retention_save.last_size = res->size;
+		xrddefault_compact_journal(retention_save.journal_offset);
+		}
+	else
+		retention_save.failures++;
+
+#ifdef USE_EVENT_BROKER
+	/* send data to event broker */
+	broker_retention_data(NEBTYPE_RETENTIONDATA_ENDSAVE, NEBFLAG_NONE, NEBATTR_NONE, NULL);
+#endif
+
+	if(res->result == OK && autosave == TRUE)
+		logit(NSLOG_PROCESS_INFO, FALSE, "Auto-save of retention data completed successfully.\n");
+	}
+
+
+/* the child saving retention data is done, one way or another */
+static int background_save_done(int sd, int events, void *arg) {
+	struct retention_save_result res;
+
+	if(read(sd, &res, sizeof(res)) != sizeof(res)) {
+		logit(NSLOG_RUNTIME_ERROR, TRUE, "Error: Background save of retention data (pid %d) died before it finished\n", (int)retention_save.pid);
+		memset(&res, 0, sizeof(res));
+		res.result = ERROR;
+		}
+
+	iobroker_close(nagios_iobs, sd);
+
+	/* it may already have been reaped along with some dead worker */
+	waitpid(retention_save.pid, NULL, 0);
+	retention_save.pid = 0;
+
+	finish_state_information_save(&res, retention_save.autosave);
+
+	return 0;
+	}
+
+
+static int save_state_information_in_background(int autosave) {
+	struct retention_save_result res;
+	struct timeval start, end;
+	int pfd[2];
+	pid_t pid;
+
+	if(retention_save.pid) {
+		log_debug_info(DEBUGL_RETENTIONDATA, 0, "Retention data is already being saved by pid %d. Skipping this save.\n", (int)retention_save.pid);
+		retention_save.skipped++;
+		return OK;
+		}
+
+	if(pipe(pfd) < 0) {
+		logit(NSLOG_RUNTIME_ERROR, TRUE, "Error: Failed to create pipe for background retention save: %s\n", strerror(errno));
+		return ERROR;
+		}
+
+	gettimeofday(&start, NULL);
+	retention_save.journal_offset = xrddefault_checkpoint_journal();
+	pid = fork();
+	if(pid < 0) {
+		logit(NSLOG_RUNTIME_ERROR, TRUE, "Error: Failed to fork() for background retention save: %s\n", strerror(errno));
+		close(pfd[0]);
+		close(pfd[1]);
+		return ERROR;
+		}
+
+	if(pid == 0) {
+		/*
+		 * we're the snapshot now. signals meant for the core must
+		 * neither run its handlers here nor leave a half-written
+		 * temp file behind, so we finish the save regardless
+		 */
+		signal(SIGTERM, SIG_IGN);
+		signal(SIGHUP, SIG_IGN);
+		close(pfd[0]);
+
+		memset(&res, 0, sizeof(res));
+		res.result = xrddefault_save_state_information();
+		gettimeofday(&end, NULL);
+		res.duration = tv_delta_f(&start, &end);
+		if(res.result == OK)
+			res.size = retention_file_size();
+
+		if(write(pfd[1], &res, sizeof(res)) != sizeof(res))
+			_exit(1);
+		_exit(0);
+		}
+
+	close(pfd[1]);
+	fcntl(pfd[0], F_SETFD, FD_CLOEXEC);
+	retention_save.pid = pid;
+	retention_save.fd = pfd[0];
+	retention_save.autosave = autosave;
+	if(iobroker_register(nagios_iobs, pfd[0], NULL, background_save_done) < 0) {
+		/* we'll just have to wait for it, then */
+		background_save_done(pfd[0], 0, NULL);
+		return OK;
+		}
+
+	gettimeofday(&end, NULL);
+	retention_save.last_pause = tv_delta_f(&start, &end);
+
+	log_debug_info(DEBUGL_RETENTIONDATA, 1, "Saving retention data in the background with pid %d\n", (int)pid);
+
+	return OK;
+	}
+
+
+/* waits for a background save to finish, so it can't overwrite a later one */
+void wait_for_state_information_save(void) {
+
+	if(!retention_save.pid)
+		return;
+
+	log_debug_info(DEBUGL_RETENTIONDATA, 1, "Waiting for background save of retention data by pid %d\n", (int)retention_save.pid);
+
+	/* the pipe is blocking, so this returns when the child is done */
+	background_save_done(retention_save.fd, 0, NULL);
+	}
+
+
 /* save all host and service state information */
 int save_state_information(int autosave) {
-	int result = OK;
+	struct retention_save_result res;
+	struct timeval start, end;
 
 	if(retain_state_information == FALSE)
 		return OK;
@@ -63,18 +230,40 @@ int save_state_information(int autosave) {
 	broker_retention_data(NEBTYPE_RETENTIONDATA_STARTSAVE, NEBFLAG_NONE, NEBATTR_NONE, NULL);
 #endif
 
-	result = xrddefault_save_state_information();
+	/* the final save before a restart or shutdown must be on disk before we go on */
+	if(retention_save_mode == RETENTION_SAVE_BACKGROUND && sigshutdown == FALSE && sigrestart == FALSE)
+		return save_state_information_in_background(autosave);
 
-#ifdef USE_EVENT_BROKER
-	/* send data to event broker */
-	broker_retention_data(NEBTYPE_RETENTIONDATA_ENDSAVE, NEBFLAG_NONE, NEBATTR_NONE, NULL);
-#endif
+	wait_for_state_information_save();
 
-	if(result == ERROR)
-		return ERROR;
+	gettimeofday(&start, NULL);
+	retention_save.journal_offset = xrddefault_checkpoint_journal();
+	memset(&res, 0, sizeof(res));
+	res.result = xrddefault_save_state_information();
+	gettimeofday(&end, NULL);
+	res.duration = retention_save.last_pause = tv_delta_f(&start, &end);
+	if(res.result == OK)
+		res.size = retention_file_size();
 
-	if(autosave == TRUE)
-		logit(NSLOG_PROCESS_INFO, FALSE, "Auto-save of retention data completed successfully.\n");
+	finish_state_information_save(&res, autosave);
+
+	return res.result == OK ? OK : ERROR;
+	}
+
+
+int dump_retention_stats(int sd) {
+	struct xrddefault_journal_stats js;
+
+	xrddefault_get_journal_stats(&js);
+	nsock_printf_nul(sd, "mode=%s;running=%d;saves=%lu;failures=%lu;skipped=%lu;"
+	                 "last_save=%llu;last_pause=%.3f;last_duration=%.3f;last_size=%llu;"
+	                 "journal=%d;journal_size=%lu;journal_seq=%lu;journal_records=%lu;"
+	                 "journal_batches=%lu;journal_syncs=%lu;journal_compactions=%lu",
+	                 retention_save_mode == RETENTION_SAVE_BACKGROUND ? "background" : "foreground",
+	                 retention_save.pid != 0, retention_save.saves, retention_save.failures,
+	                 retention_save.skipped, (unsigned long long)retention_save.last_save,
+	                 retention_save.last_pause, retention_save.last_duration, retention_save.last_size,
+	                 js.enabled, js.size, js.seq, js.records, js.batches, js.syncs, js.compactions);
 
 	return OK;
 	}
@@ -88,6 +277,9 @@ int read_initial_state_information(void) {
 	if(retain_state_information == FALSE)
 		return OK;
 
+	/* don't read a file that's about to be replaced */
+	wait_for_state_information_save();
+
 #ifdef USE_EVENT_BROKER
 	/* send data to event broker */
 	broker_retention_data(NEBTYPE_RETENTIONDATA_STARTLOAD, NEBFLAG_NONE, NEBATTR_NONE, NULL);
@@ -105,3 +297,67 @@ int read_initial_state_information(void) {
 
 	return OK;
 	}
+
+
+
+/*
+ * The retention journal. Changes to retained state are appended to it
+ * as they happen, and each save cuts it back to what the save didn't
+ * cover, so a crash loses far less than a retention_update_interval.
+ */
+int open_retention_journal(void) {
+
+	if(retain_state_information == FALSE)
+		return OK;
+
+	return xrddefault_open_journal();
+	}
+
+
+int close_retention_journal(void) {
+	return xrddefault_close_journal();
+	}
+
+
+int sync_retention_journal(void) {
+
+	xrddefault_sync_journal();
+
+	/* don't let the journal grow without bounds between saves */
+	if(retention_journal_max_size > 0 && retention_save.pid == 0 && xrddefault_journal_size() > retention_journal_max_size) {
+		log_debug_info(DEBUGL_RETENTIONDATA, 1, "Retention journal is over %lu bytes. Saving retention data.\n", retention_journal_max_size);
+		save_state_information(TRUE);
+		}
+
+	return OK;
+	}
+
+
+void journal_program_state(void) {
+	xrddefault_journal_program();
+	}
+
+
+void journal_host_state(host *hst) {
+	xrddefault_journal_host(hst);
+	}
+
+
+void journal_service_state(service *svc) {
+	xrddefault_journal_service(svc);
+	}
+
+
+void journal_contact_state(contact *cntct) {
+	xrddefault_journal_contact(cntct);
+	}
+
+
+void journal_comment(nagios_comment *temp_comment, int deleted) {
+	xrddefault_journal_comment(temp_comment, deleted);
+	}
+
+
+void journal_downtime(scheduled_downtime *temp_downtime, int deleted) {
+	xrddefault_journal_downtime(temp_downtime, deleted);
+	}
@@ -90,6 +90,7 @@ int notification_timeout;
 
 
 char *object_precache_file;
+int binary_object_precache;
 
 char *global_host_event_handler;
 char *global_service_event_handler;
@@ -139,6 +140,10 @@ int soft_state_dependencies;
 
 int retain_state_information;
 int retention_update_interval;
+int retention_save_mode;
+int retention_journal;
+int retention_journal_sync_interval;
+unsigned long retention_journal_max_size;
 int use_retained_program_state;
 int use_retained_scheduling_info;
 int retention_scheduling_horizon;
@@ -245,6 +250,18 @@ unsigned long   max_debug_file_size;
 
 iobroker_set *nagios_iobs = NULL;
 squeue_t *nagios_squeue = NULL; /* our scheduling queue */
+int event_queue_type;
+int event_batch_size;
+int check_result_threads;
+int object_config_threads;
+int worker_use_posix_spawn;
+unsigned long worker_shm_ring_size;
+int use_log_thread;
+unsigned long log_thread_buffer_size;
+int log_overflow_policy;
+int log_fsync_interval;
+unsigned int trace_buffer_size;
+tracering *nagios_trace = NULL;
 
 sched_info scheduling_info;
 
@@ -273,6 +290,7 @@ void init_main_cfg_vars(int first_time) {
 	debug_file = NULL;
 
 	object_precache_file = (char *)strdup(DEFAULT_PRECACHED_OBJECT_FILE);
+	binary_object_precache = DEFAULT_BINARY_OBJECT_PRECACHE;
 
 	nagios_user = NULL;
 	nagios_group = NULL;
@@ -328,6 +346,10 @@ void init_main_cfg_vars(int first_time) {
 
 	retain_state_information = FALSE;
 	retention_update_interval = DEFAULT_RETENTION_UPDATE_INTERVAL;
+	retention_save_mode = DEFAULT_RETENTION_SAVE_MODE;
+	retention_journal = FALSE;
+	retention_journal_sync_interval = DEFAULT_RETENTION_JOURNAL_SYNC_INTERVAL;
+	retention_journal_max_size = DEFAULT_RETENTION_JOURNAL_MAX_SIZE;
 	use_retained_program_state = TRUE;
 	use_retained_scheduling_info = FALSE;
 	retention_scheduling_horizon = DEFAULT_RETENTION_SCHEDULING_HORIZON;
@@ -369,6 +391,18 @@ void init_main_cfg_vars(int first_time) {
 
 	time_change_threshold = DEFAULT_TIME_CHANGE_THRESHOLD;
 
+	event_queue_type = DEFAULT_EVENT_QUEUE_TYPE;
+	event_batch_size = DEFAULT_EVENT_BATCH_SIZE;
+	check_result_threads = DEFAULT_CHECK_RESULT_THREADS;
+	object_config_threads = DEFAULT_OBJECT_CONFIG_THREADS;
+	worker_use_posix_spawn = DEFAULT_WORKER_USE_POSIX_SPAWN;
+	worker_shm_ring_size = DEFAULT_WORKER_SHM_RING_SIZE;
+	use_log_thread = DEFAULT_USE_LOG_THREAD;
+	log_thread_buffer_size = DEFAULT_LOG_THREAD_BUFFER_SIZE;
+	log_overflow_policy = DEFAULT_LOG_OVERFLOW_POLICY;
+	log_fsync_interval = DEFAULT_LOG_FSYNC_INTERVAL;
+	trace_buffer_size = DEFAULT_TRACE_BUFFER_SIZE;
+
 	low_service_flap_threshold = DEFAULT_LOW_SERVICE_FLAP_THRESHOLD;
 	high_service_flap_threshold = DEFAULT_HIGH_SERVICE_FLAP_THRESHOLD;
 	low_host_flap_threshold = DEFAULT_LOW_HOST_FLAP_THRESHOLD;
@@ -1156,8 +1190,314 @@ static timerange* _get_matching_timerange(time_t test_time, timeperiod *tperiod)
 	return tperiod->days[test_time_wday];
 }
 
+/*
+ * Compiled timeperiods
+ *
+ * Working out whether a time is inside a timeperiod means walking its
+ * exceptions, dateranges and exclusions and doing a handful of mktime()
+ * calls, which adds up when it's done for every check we reschedule and
+ * every notification we consider. Instead, each timeperiod is compiled
+ * into a sorted list of the intervals it's valid in, from the start of
+ * today and TIMEPERIOD_CACHE_DAYS days forward. Lookups inside that
+ * window are a binary search. Lookups outside of it use the code above,
+ * and the list is rebuilt once the window runs out.
+ */
+#define TIMEPERIOD_CACHE_DAYS 14
+
+struct tp_interval {
+	time_t start;
+	time_t end; /* first second that's no longer valid */
+	};
+
+struct tp_intervals {
+	unsigned int num;
+	unsigned int alloc;
+	struct tp_interval *iv;
+	};
+
+struct timeperiod_cache {
+	unsigned int generation;
+	time_t start;
+	time_t end;
+	struct tp_intervals list;
+	};
+
+static struct timeperiod_cache *tp_cache = NULL;
+static unsigned int tp_cache_len = 0;
+static unsigned int tp_cache_generation = 1;
+
+static int tp_intervals_add(struct tp_intervals *l, time_t start, time_t end) {
+	struct tp_interval *iv;
+
+	if(start >= end)
+		return OK;
+
+	if(l->num == l->alloc) {
+		unsigned int alloc = l->alloc ? l->alloc * 2 : 32;
+		if((iv = realloc(l->iv, alloc * sizeof(*iv))) == NULL)
+			return ERROR;
+		l->iv = iv;
+		l->alloc = alloc;
+		}
+	l->iv[l->num].start = start;
+	l->iv[l->num].end = end;
+	l->num++;
+
+	return OK;
+	}
+
+static int tp_interval_cmp(const void *a_, const void *b_) {
+	const struct tp_interval *a = a_, *b = b_;
+
+	if(a->start < b->start)
+		return -1;
+	return a->start > b->start;
+	}
+
+/* sorts the intervals and merges the ones that overlap or touch */
+static void tp_intervals_normalize(struct tp_intervals *l) {
+	unsigned int i, n = 0;
+
+	if(l->num < 2)
+		return;
+
+	qsort(l->iv, l->num, sizeof(*l->iv), tp_interval_cmp);
+	for(i = 1; i < l->num; i++) {
+		if(l->iv[i].start <= l->iv[n].end) {
+			if(l->iv[i].end > l->iv[n].end)
+				l->iv[n].end = l->iv[i].end;
+			}
+		else
+			l->iv[++n] = l->iv[i];
+		}
+	l->num = n + 1;
+	}
+
+/* removes everything in 'ex' from 'l'. Both must be normalized */
+static int tp_intervals_subtract(struct tp_intervals *l, struct tp_intervals *ex) {
+	struct tp_intervals out = { 0, 0, NULL };
+	unsigned int i, x = 0;
+
+	for(i = 0; i < l->num; i++) {
+		time_t start = l->iv[i].start, end = l->iv[i].end;
+
+		while(x < ex->num && ex->iv[x].end <= start)
+			x++;
+		for(; x < ex->num && ex->iv[x].start < end; x++) {
+			if(tp_intervals_add(&out, start, ex->iv[x].start) == ERROR) {
+				my_free(out.iv);
+				return ERROR;
+				}
+			if(ex->iv[x].end >= end) {
+				start = end;
+				break;
+				}
+			start = ex->iv[x].end;
+			}
+		if(tp_intervals_add(&out, start, end) == ERROR) {
+			my_free(out.iv);
+			return ERROR;
+			}
+		}
+
+	my_free(l->iv);
+	*l = out;
+	return OK;
+	}
+
+/* the first second of the local day 'when' falls on */
+static time_t tp_day_start(time_t when, int days) {
+	struct tm *t, tm_s;
+
+	t = localtime_r(&when, &tm_s);
+	t->tm_mday += days;
+	t->tm_sec = 0;
+	t->tm_min = 0;
+	t->tm_hour = 0;
+	t->tm_isdst = -1;
+	return mktime(t);
+	}
+
+/*
+ * Adds the part of [start, end) that check_time_against_period() would
+ * find inside the timeperiod's own ranges, ignoring exclusions. 'start'
+ * and 'end' must be within the same local day and the same DST regime,
+ * since that's what the ranges are measured from.
+ */
+static int tp_compile_segment(struct tp_intervals *l, timeperiod *tperiod, time_t start, time_t end) {
+	timerange *temp_timerange = NULL;
+	struct tm *t, tm_s;
+	time_t midnight = (time_t)0L;
+
+	/* calculate midnight the same way check_time_against_period() does */
+	t = localtime_r(&start, &tm_s);
+	t->tm_sec = 0;
+	t->tm_min = 0;
+	t->tm_hour = 0;
+	midnight = mktime(t);
+
+	for(temp_timerange = _get_matching_timerange(start, tperiod); temp_timerange != NULL; temp_timerange = temp_timerange->next) {
+		time_t range_start = (time_t)(midnight + temp_timerange->range_start);
+		time_t range_end = (time_t)(midnight + temp_timerange->range_end + 1);
+
+		if(range_start < start)
+			range_start = start;
+		if(range_end > end)
+			range_end = end;
+		if(tp_intervals_add(l, range_start, range_end) == ERROR)
+			return ERROR;
+		}
+
+	return OK;
+	}
+
+static int tp_compile(struct tp_intervals *l, timeperiod *tperiod, time_t start, time_t end, int depth) {
+	timeperiodexclusion *temp_timeperiodexclusion = NULL;
+	time_t day, next_day;
+
+	/* circular exclusions are caught by the config verification */
+	if(depth > 16)
+		return ERROR;
+
+	for(day = start; day < end; day = next_day) {
+		struct tm tm_s;
+		time_t last_second;
+		int dst_start, dst_end;
+
+		next_day = tp_day_start(day, 1);
+		if(next_day <= day)
+			return ERROR;
+
+		last_second = next_day - 1;
+		dst_start = localtime_r(&day, &tm_s)->tm_isdst;
+		dst_end = localtime_r(&last_second, &tm_s)->tm_isdst;
+		if(dst_start == dst_end) {
+			if(tp_compile_segment(l, tperiod, day, next_day) == ERROR)
+				return ERROR;
+			}
+		else {
+			/* midnight moves when DST changes, so split the day where it happens */
+			time_t lo = day, hi = next_day - 1;
+			while(hi - lo > 1) {
+				time_t mid = lo + (hi - lo) / 2;
+				if(localtime_r(&mid, &tm_s)->tm_isdst == dst_start)
+					lo = mid;
+				else
+					hi = mid;
+				}
+			if(tp_compile_segment(l, tperiod, day, hi) == ERROR || tp_compile_segment(l, tperiod, hi, next_day) == ERROR)
+				return ERROR;
+			}
+		}
+	tp_intervals_normalize(l);
+
+	for(temp_timeperiodexclusion = tperiod->exclusions; temp_timeperiodexclusion != NULL; temp_timeperiodexclusion = temp_timeperiodexclusion->next) {
+		struct tp_intervals ex = { 0, 0, NULL };
+		int result;
+
+		if(temp_timeperiodexclusion->timeperiod_ptr == NULL)
+			continue;
+		result = tp_compile(&ex, temp_timeperiodexclusion->timeperiod_ptr, start, end, depth + 1);
+		if(result == OK)
+			result = tp_intervals_subtract(l, &ex);
+		my_free(ex.iv);
+		if(result == ERROR)
+			return ERROR;
+		}
+
+	return OK;
+	}
+
+/* returns the compiled form of a timeperiod if it covers 'when', (re)building it if need be */
+static struct timeperiod_cache *get_timeperiod_cache(timeperiod *tperiod, time_t when) {
+	struct timeperiod_cache *tc;
+	time_t current_time = time(NULL);
+
+	if(tperiod->id < tp_cache_len) {
+		tc = &tp_cache[tperiod->id];
+		if(tc->generation == tp_cache_generation && when >= tc->start && when < tc->end)
+			return tc;
+		}
+
+	/* far-off times aren't worth a rebuild */
+	if(when < current_time - 86400 || when >= current_time + (TIMEPERIOD_CACHE_DAYS - 1) * 86400)
+		return NULL;
+
+	if(tperiod->id >= tp_cache_len) {
+		unsigned int len = num_objects.timeperiods > tperiod->id ? num_objects.timeperiods : tperiod->id + 1;
+		if((tc = realloc(tp_cache, len * sizeof(*tc))) == NULL)
+			return NULL;
+		memset(tc + tp_cache_len, 0, (len - tp_cache_len) * sizeof(*tc));
+		tp_cache = tc;
+		tp_cache_len = len;
+		}
+
+	tc = &tp_cache[tperiod->id];
+	tc->generation = 0;
+	tc->list.num = 0;
+	tc->start = tp_day_start(when < current_time ? when : current_time, 0);
+	tc->end = tp_day_start(tc->start, TIMEPERIOD_CACHE_DAYS);
+	if(tc->end <= tc->start || tp_compile(&tc->list, tperiod, tc->start, tc->end, 0) == ERROR)
+		return NULL;
+	tc->generation = tp_cache_generation;
+
+	log_debug_info(DEBUGL_EVENTS, 2, "Compiled timeperiod '%s' into %u intervals\n", tperiod->name, tc->list.num);
+
+	return tc;
+	}
+
+/* the first interval that ends after 'when', or NULL if there's none */
+static struct tp_interval *timeperiod_cache_find(struct timeperiod_cache *tc, time_t when) {
+	unsigned int lo = 0, hi = tc->list.num;
+
+	while(lo < hi) {
+		unsigned int mid = lo + (hi - lo) / 2;
+		if(tc->list.iv[mid].end <= when)
+			lo = mid + 1;
+		else
+			hi = mid;
+		}
+
+	return lo < tc->list.num ? &tc->list.iv[lo] : NULL;
+	}
+
+/* forget all compiled timeperiods, fe. after a system time change */
+void invalidate_timeperiod_cache(void) {
+	tp_cache_generation++;
+	}
+
+void free_timeperiod_cache(void) {
+	unsigned int i;
+
+	for(i = 0; i < tp_cache_len; i++)
+		my_free(tp_cache[i].list.iv);
+	my_free(tp_cache);
+	tp_cache_len = 0;
+	tp_cache_generation++;
+	}
+
+
 /* see if the specified time falls into a valid time range in the given time period */
 int check_time_against_period(time_t test_time, timeperiod *tperiod) {
+	struct timeperiod_cache *tc = NULL;
+	struct tp_interval *iv = NULL;
+
+	log_debug_info(DEBUGL_FUNCTIONS, 0, "check_time_against_period()\n");
+
+	/* if no period was specified, assume the time is good */
+	if(tperiod == NULL)
+		return OK;
+
+	if((tc = get_timeperiod_cache(tperiod, test_time)) != NULL) {
+		iv = timeperiod_cache_find(tc, test_time);
+		return (iv != NULL && iv->start <= test_time) ? OK : ERROR;
+		}
+
+	return _check_time_against_period(test_time, tperiod);
+	}
+
+/* Separate this out from public check_time_against_period for testing */
+int _check_time_against_period(time_t test_time, timeperiod *tperiod) {
 	timerange *temp_timerange = NULL;
 	timeperiodexclusion *temp_timeperiodexclusion = NULL;
 	struct tm *t, tm_s;
@@ -1165,7 +1505,9 @@ int check_time_against_period(time_t test_time, timeperiod *tperiod) {
 	time_t day_range_start = (time_t)0L;
 	time_t day_range_end = (time_t)0L;
 
-	log_debug_info(DEBUGL_FUNCTIONS, 0, "check_time_against_period()\n");
+	/* if no period was specified, assume the time is good */
+	if(tperiod == NULL)
+		return OK;
 
 	t = localtime_r((time_t *)&test_time, &tm_s);
 
@@ -1174,12 +1516,8 @@ int check_time_against_period(time_t test_time, timeperiod *tperiod) {
 	t->tm_hour = 0;
 	midnight = mktime(t);
 
-	/* if no period was specified, assume the time is good */
-	if(tperiod == NULL)
-		return OK;
-
 	for(temp_timeperiodexclusion = tperiod->exclusions; temp_timeperiodexclusion != NULL; temp_timeperiodexclusion = temp_timeperiodexclusion->next) {
-		if(check_time_against_period(test_time, temp_timeperiodexclusion->timeperiod_ptr) == OK) {
+		if(_check_time_against_period(test_time, temp_timeperiodexclusion->timeperiod_ptr) == OK) {
 			return ERROR;
 			}
 		}
@@ -1366,6 +1704,8 @@ void _get_next_valid_time(time_t pref_time, time_t *valid_time, timeperiod *tper
 /* given a preferred time, get the next valid time within a time period */
 void get_next_valid_time(time_t pref_time, time_t *valid_time, timeperiod *tperiod) {
 	time_t current_time = (time_t)0L;
+	struct timeperiod_cache *tc = NULL;
+	struct tp_interval *iv = NULL;
 
 	log_debug_info(DEBUGL_FUNCTIONS, 0, "get_next_valid_time()\n");
 
@@ -1374,6 +1714,19 @@ void get_next_valid_time(time_t pref_time, time_t *valid_time, timeperiod *tperi
 
 	pref_time = (pref_time < current_time) ? current_time : pref_time;
 
+	if(tperiod != NULL && (tc = get_timeperiod_cache(tperiod, pref_time)) != NULL) {
+		if((iv = timeperiod_cache_find(tc, pref_time)) != NULL) {
+			*valid_time = (iv->start > pref_time) ? iv->start : pref_time;
+			return;
+			}
+
+		/* nothing valid in the cached window, so look beyond it */
+		_get_next_valid_time(tc->end, valid_time, tperiod);
+		if(*valid_time == tc->end && _check_time_against_period(tc->end, tperiod) == ERROR)
+			*valid_time = pref_time;
+		return;
+		}
+
 	_get_next_valid_time(pref_time, valid_time, tperiod);
 	}
 
@@ -1385,10 +1738,23 @@ time_t reschedule_within_timeperiod(time_t starting_valid_time, timeperiod* chec
 
 	/* First, find the next time that is outside the timeperiod */
 	time_t ending_valid_time;
-	_get_next_invalid_time(starting_valid_time, &ending_valid_time, check_period_ptr);
+	struct timeperiod_cache *tc = NULL;
+	struct tp_interval *iv = NULL;
+
+	if(check_period_ptr != NULL && (tc = get_timeperiod_cache(check_period_ptr, starting_valid_time)) != NULL) {
+		iv = timeperiod_cache_find(tc, starting_valid_time);
+		/* not valid now or valid for as far as we know, so there's no limit */
+		if(iv == NULL || iv->start > starting_valid_time || iv->end >= tc->end)
+			ending_valid_time = starting_valid_time;
+		else
+			ending_valid_time = iv->end - 1;
+		}
+	else {
+		_get_next_invalid_time(starting_valid_time, &ending_valid_time, check_period_ptr);
 
-	/* _get_next_invalid_time returns the first invalid minute. The maximum allowable should be a minute earlier */
-	ending_valid_time -= 60;
+		/* _get_next_invalid_time returns the first invalid minute. The maximum allowable should be a minute earlier */
+		ending_valid_time -= 60;
+		}
 
 	/* Determine whether the next invalid time or the outside of the check_window is closer */
 	time_t max_nudge = ending_valid_time - starting_valid_time;
@@ -2579,6 +2945,10 @@ int init_check_result(check_result *info)
 	info->output              = NULL;
 	info->source              = NULL;
 	info->engine              = NULL;
+	info->output_parsed       = FALSE;
+	info->short_output        = NULL;
+	info->long_output         = NULL;
+	info->perf_data           = NULL;
 
 	return OK;
 }
@@ -2595,11 +2965,76 @@ int free_check_result(check_result *info)
 	my_free(info->host_name);
 	my_free(info->service_description);
 	my_free(info->output);
+	my_free(info->short_output);
+	my_free(info->long_output);
+	my_free(info->perf_data);
 
 	return OK;
 }
 
 
+/*
+ * Active checks allocate a check_result each and free it again once the
+ * result is in, so the ones we're done with go on a freelist instead of
+ * back to malloc(). The freelist never holds more than the most checks
+ * we've had running at once.
+ * They can't come from the per-batch output arenas: a check result is
+ * allocated when its check starts and lives until a worker reports back,
+ * which can be many batches later, and results are freed in whatever
+ * order their checks finish.
+ */
+union check_result_slot {
+	check_result cr;
+	union check_result_slot *next;
+};
+static union check_result_slot *check_result_freelist;
+
+/* gets a zeroed and initialized check result */
+check_result *alloc_check_result(void)
+{
+	union check_result_slot *slot = check_result_freelist;
+
+	if (slot) {
+		check_result_freelist = slot->next;
+	}
+	else if (!(slot = malloc(sizeof(*slot)))) {
+		return NULL;
+	}
+
+	memset(slot, 0, sizeof(*slot));
+	init_check_result(&slot->cr);
+	return &slot->cr;
+}
+
+
+/* frees memory associated with a check result and recycles the result itself */
+void release_check_result(check_result *cr)
+{
+	union check_result_slot *slot = (union check_result_slot *)cr;
+
+	if (cr == NULL) {
+		return;
+	}
+
+	free_check_result(cr);
+	slot->next = check_result_freelist;
+	check_result_freelist = slot;
+}
+
+
+/* frees check results that are waiting to be recycled */
+void free_check_result_freelist(void)
+{
+	union check_result_slot *slot, *next;
+
+	for (slot = check_result_freelist; slot; slot = next) {
+		next = slot->next;
+		free(slot);
+	}
+	check_result_freelist = NULL;
+}
+
+
 /******************************************************************/
 /************************ STRING FUNCTIONS ************************/
 /******************************************************************/
@@ -3522,7 +3957,10 @@ void free_memory(nagios_macros *mac) {
 	int i;
 
 	/* free all allocated memory for the object definitions */
+	free_check_templates();
 	free_object_data();
+	set_environment_macro_filter(NULL);
+	free_timeperiod_cache();
 	free_comment_data();
 
 	/* free event queue data */
@@ -3536,6 +3974,12 @@ void free_memory(nagios_macros *mac) {
 	/* free any notification list that may have been overlooked */
 	free_notification_list();
 
+	/* free recycled check results */
+	free_check_result_freelist();
+
+	/* free the freshness deadline index */
+	free_freshness_index();
+
 	/* free obsessive compulsive commands */
 	my_free(ocsp_command);
 	my_free(ochp_command);
@@ -3582,6 +4026,7 @@ void free_memory(nagios_macros *mac) {
 	my_free(log_archive_path);
 	my_free(website_url);
 	my_free(status_file);
+	my_free(status_binary_file);
 	my_free(retention_file);
 
 	for (i = 0; i < MAX_USER_MACROS; i++) {
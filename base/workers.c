@@ -9,6 +9,8 @@
  */
 #include "../include/config.h"
 #include <string.h>
+#include <pthread.h>
+#include <sched.h>
 #include "../include/nagios.h"
 #include "../include/workers.h"
 
@@ -24,6 +26,10 @@ struct wproc_job {
 	char *command;
 	void *arg;
 	struct wproc_worker *wp;
+	time_t deadline; /**< when a check job is considered orphaned */
+	unsigned int deadline_pos; /**< slot in the check deadline queue */
+	int deadline_queue; /**< which check deadline queue we're in */
+	int overdue; /**< check job was handed out as orphaned */
 };
 
 struct wproc_list;
@@ -39,6 +45,13 @@ struct wproc_worker {
 	iocache *ioc;  /**< iocache for reading from worker */
 	fanout_table *jobs; /**< array of jobs */
 	struct wproc_list *wp_list;
+	unsigned int spawns; /**< jobs reporting time_to_spawn */
+	double spawn_time; /**< total time spent starting jobs */
+	double spawn_time_max; /**< slowest job start */
+	int frames; /**< framing version we talk, 0 for key/value vectors */
+	shmring *jobs_ring; /**< shared memory ring we put jobs in */
+	shmring *results_ring; /**< shared memory ring the worker puts results in */
+	int base_env; /**< the worker has the constant macros in its environment */
 };
 
 struct wproc_list {
@@ -66,7 +79,6 @@ typedef struct wproc_object_job {
 unsigned int wproc_num_workers_online = 0, wproc_num_workers_desired = 0;
 unsigned int wproc_num_workers_spawned = 0;
 
-extern struct kvvec * macros_to_kvv(nagios_macros *);
 
 #define tv2float(tv) ((float)((tv)->tv_sec) + ((float)(tv)->tv_usec) / 1000000.0)
 
@@ -293,6 +305,106 @@ static struct wproc_worker *get_worker(const char *cmd)
 	return wp_list->wps[wp_list->idx++ % wp_list->len];
 }
 
+/*
+ * Running checks, ordered by the time their results are due, so
+ * the orphan sweeps only ever look at the jobs that are late.
+ * pq[0] holds host checks and pq[1] service checks.
+ */
+static struct {
+	prqueue_t *pq[2];
+	unsigned int overdue;
+} check_deadlines;
+
+static int cd_cmp_pri(prqueue_pri_t next, prqueue_pri_t cur)
+{
+	return next > cur;
+}
+
+static prqueue_pri_t cd_get_pri(void *a)
+{
+	return ((struct wproc_job *)a)->deadline;
+}
+
+static void cd_set_pri(void *a, prqueue_pri_t pri)
+{
+	((struct wproc_job *)a)->deadline = pri;
+}
+
+static unsigned int cd_get_pos(void *a)
+{
+	return ((struct wproc_job *)a)->deadline_pos;
+}
+
+static void cd_set_pos(void *a, unsigned int pos)
+{
+	((struct wproc_job *)a)->deadline_pos = pos;
+}
+
+static void add_check_deadline(struct wproc_job *job)
+{
+	check_result *cr = (check_result *)job->arg;
+	prqueue_t **pq;
+
+	job->deadline_queue = cr->service_description != NULL;
+	pq = &check_deadlines.pq[job->deadline_queue];
+
+	if (*pq == NULL) {
+		*pq = prqueue_init(1024, cd_cmp_pri, cd_get_pri, cd_set_pri, cd_get_pos, cd_set_pos);
+		if (*pq == NULL) {
+			return;
+		}
+	}
+
+	/* allow 10 minutes slack time on top of the timeout */
+	job->deadline = time(NULL) + job->timeout + check_reaper_interval + 600;
+	if (prqueue_insert(*pq, job) != 0) {
+		job->deadline_pos = 0;
+	}
+}
+
+/* the check result may already be gone, so mustn't look at job->arg */
+static void remove_check_deadline(struct wproc_job *job)
+{
+	prqueue_t *pq = check_deadlines.pq[job->deadline_queue];
+
+	if (job->overdue) {
+		check_deadlines.overdue--;
+		job->overdue = 0;
+	}
+	if (job->deadline_pos != 0 && pq != NULL) {
+		prqueue_remove(pq, job);
+		job->deadline_pos = 0;
+	}
+}
+
+/*
+ * hands out the check result of the next running host or service
+ * check whose deadline passed before 'now', or NULL if there is none.
+ * The job stays around so its result can still be handled if it
+ * turns up late.
+ */
+check_result *wproc_next_orphaned_check(int object_check_type, time_t now)
+{
+	prqueue_t *pq = check_deadlines.pq[object_check_type == SERVICE_CHECK];
+	struct wproc_job *job;
+
+	if (pq == NULL || (job = prqueue_peek(pq)) == NULL || job->deadline >= now) {
+		return NULL;
+	}
+
+	prqueue_pop(pq);
+	job->deadline_pos = 0;
+	job->overdue = 1;
+	check_deadlines.overdue++;
+
+	return (check_result *)job->arg;
+}
+
+static unsigned int checks_in_flight(int idx)
+{
+	return check_deadlines.pq[idx] ? prqueue_size(check_deadlines.pq[idx]) : 0;
+}
+
 static struct wproc_job *create_job(int type, void *arg, time_t timeout, const char *cmd)
 {
 	struct wproc_job *job   = NULL;
@@ -380,8 +492,8 @@ static void destroy_job(struct wproc_job *job)
 
 	switch (job->type) {
 	case WPJOB_CHECK:
-		free_check_result(job->arg);
-		free(job->arg);
+		remove_check_deadline(job);
+		release_check_result(job->arg);
 		break;
 
 	case WPJOB_NOTIFY:
@@ -475,6 +587,11 @@ static int wproc_destroy(struct wproc_worker *wp, int flags)
 	}
 
 	iobroker_close(nagios_iobs, wp->sd);
+	if (wp->results_ring) {
+		iobroker_unregister(nagios_iobs, shmring_eventfd(wp->results_ring));
+		shmring_destroy(wp->results_ring);
+	}
+	shmring_destroy(wp->jobs_ring);
 
 	/* reap our possibly lost children */
 	while (waitpid(-1, &i, WNOHANG) > 0)
@@ -544,12 +661,15 @@ static void remove_worker(struct wproc_worker *worker)
 }
 
 
+static void stop_check_result_threads(void);
 /*
  * This gets called from both parent and worker process, so
  * we must take care not to blindly shut down everything here
  */
 void free_worker_memory(int flags)
 {
+	stop_check_result_threads();
+
 	if (workers.wps) {
 		unsigned int i;
 
@@ -572,6 +692,19 @@ void free_worker_memory(int flags)
 
 	/* Don't leave pointers to freed memory. */
 	specialized_workers = NULL;
+
+	/* the jobs are gone, so nothing can be running */
+	if (flags & WPROC_FORCE) {
+		unsigned int i;
+
+		for (i = 0; i < 2; i++) {
+			if (check_deadlines.pq[i] != NULL) {
+				prqueue_free(check_deadlines.pq[i]);
+				check_deadlines.pq[i] = NULL;
+			}
+		}
+		check_deadlines.overdue = 0;
+	}
 }
 
 static int str2timeval(char *str, struct timeval *tv)
@@ -594,7 +727,61 @@ static int str2timeval(char *str, struct timeval *tv)
 	return 0;
 }
 
-static int handle_worker_check(wproc_result *wpres, struct wproc_worker *wp, struct wproc_job *job)
+/*
+ * Check result threads.
+ *
+ * With check_result_threads set, messages read from the workers are
+ * copied into a ring of slots and handed to a small pool of threads
+ * which do the parsing: splitting the message into key/value pairs,
+ * decoding the result variables and, for checks, splitting the plugin
+ * output into short and long output and perf data. The main thread
+ * picks the digested results off the tail of the ring in the order
+ * they were read and does the rest (job lookup, state changes,
+ * notifications and so on) just as if it had parsed them itself.
+ *
+ * The threads only ever touch their own slot. The lock is only taken
+ * to publish and claim slots; finished slots are picked up by the
+ * main thread without locking. Threads tell the main thread there
+ * are results ready through a pipe registered with the iobroker.
+ */
+#define WPRES_RING_SIZE 1024 /* must be a power of two */
+#define WPRES_RING_MASK (WPRES_RING_SIZE - 1)
+
+struct wpres_slot {
+	struct wproc_worker *wp;
+	char *buf;                 /**< private copy of the worker message */
+	unsigned long size;
+	unsigned long bufsize;
+	struct kvvec *kvv;
+	wproc_result wpres;
+	int framed;                /**< is buf a frame rather than a kvvec? */
+	int parsed;                /**< did buf2kvvec_prealloc() succeed? */
+	struct key_value *bad_key; /**< first unrecognized result variable */
+	int output_parsed;         /**< are the fields below set? */
+	arena *arena;              /**< the fields below live here */
+	char *output;
+	char *short_output;
+	char *long_output;
+	char *perf_data;
+	volatile int done;         /**< set by the thread when it's digested */
+};
+
+static struct {
+	unsigned int nthreads;
+	pid_t pid;                 /**< the process running the threads */
+	pthread_t *threads;
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	int stopping;
+	struct wpres_slot *ring;
+	unsigned int head;         /**< next slot to fill (main thread) */
+	unsigned int claim;        /**< next slot to digest (under lock) */
+	unsigned int tail;         /**< next slot to apply (main thread) */
+	int wakeup[2];             /**< threads -> main thread */
+	volatile int wakeup_pending;
+} wpres_pool;
+
+static int handle_worker_check(wproc_result *wpres, struct wproc_worker *wp, struct wproc_job *job, struct wpres_slot *slot)
 {
 	int result = ERROR;
 	check_result *cr = (check_result *)job->arg;
@@ -611,8 +798,21 @@ static int handle_worker_check(wproc_result *wpres, struct wproc_worker *wp, str
 		cr->return_code = STATE_UNKNOWN;
 	}
 
-	if (wpres->outstd && *wpres->outstd) {
-		cr->output = strdup(wpres->outstd);
+	/*
+	 * The output is borrowed rather than copied, either from the slot's
+	 * arena or from the worker's buffer. Both outlive the call to
+	 * process_check_result() below, but mustn't be free()'d.
+	 */
+	if (slot && slot->output_parsed) {
+		/* one of the check result threads did the hard work */
+		cr->output = slot->output;
+		cr->short_output = slot->short_output;
+		cr->long_output = slot->long_output;
+		cr->perf_data = slot->perf_data;
+		cr->output_parsed = TRUE;
+	}
+	else if (wpres->outstd && *wpres->outstd) {
+		cr->output = wpres->outstd;
 	}
 	else if (wpres->outerr) {
 		asprintf(&cr->output, "(No output on stdout) stderr: %s", wpres->outerr);
@@ -627,6 +827,10 @@ static int handle_worker_check(wproc_result *wpres, struct wproc_worker *wp, str
 	cr->source        = wp->name;
 
 	process_check_result(cr);
+	if (cr->output_parsed || cr->output == wpres->outstd) {
+		cr->output = NULL;
+		cr->short_output = cr->long_output = cr->perf_data = NULL;
+	}
 	free_check_result(cr);
 
 	return result;
@@ -635,9 +839,11 @@ static int handle_worker_check(wproc_result *wpres, struct wproc_worker *wp, str
 /*
  * parses a worker result. We do no strdup()'s here, so when
  * kvv is destroyed, all references to strings will become
- * invalid
+ * invalid. When bad_key is set, we're running in one of the
+ * check result threads and mustn't log, so the first variable
+ * we don't know about is stashed there for the main thread.
  */
-static int parse_worker_result(wproc_result *wpres, struct kvvec *kvv)
+static int parse_worker_result(wproc_result *wpres, struct kvvec *kvv, struct key_value **bad_key)
 {
 	int i;
 
@@ -648,6 +854,11 @@ static int parse_worker_result(wproc_result *wpres, struct kvvec *kvv)
 		value = kvv->kv[i].value;
 
 		k = wpres_get_key(key, kvv->kv[i].key_len);
+		if (!k && bad_key) {
+			if (!*bad_key)
+				*bad_key = &kvv->kv[i];
+			continue;
+		}
 		if (!k) {
 			logit(NSLOG_RUNTIME_WARNING, TRUE, "wproc: Unrecognized result variable: (i=%d) %s=%s\n", i, key, value);
 			continue;
@@ -694,8 +905,16 @@ static int parse_worker_result(wproc_result *wpres, struct kvvec *kvv)
 		case WPRES_runtime:
 			/* ignored */
 			break;
+		case WPRES_time_to_spawn:
+			wpres->time_to_spawn = strtod(value, NULL);
+			break;
 
 		default:
+			if (bad_key) {
+				if (!*bad_key)
+					*bad_key = &kvv->kv[i];
+				break;
+			}
 			logit(NSLOG_RUNTIME_WARNING, TRUE, "wproc: Recognized but unhandled result variable: %s=%s\n", key, value);
 			break;
 		}
@@ -703,24 +922,675 @@ static int parse_worker_result(wproc_result *wpres, struct kvvec *kvv)
 	return 0;
 }
 
+/*
+ * decodes a result frame. As with parse_worker_result(), the
+ * strings point into buf, so no logging in here either.
+ */
+static int parse_worker_frame(wproc_result *wpres, char *buf, unsigned long size)
+{
+	struct wproc_frame_result res;
+	char *data, *strv[4];
+	uint32_t lens[4];
+
+	if (!(data = worker_frame_body(buf, size, &res, sizeof(res)))) {
+		return -1;
+	}
+	lens[0] = res.command_len;
+	lens[1] = res.outstd_len;
+	lens[2] = res.outerr_len;
+	lens[3] = res.error_msg_len;
+	if (worker_frame_strings(buf, size, data, strv, lens, 4) < 0) {
+		return -1;
+	}
+
+	wpres->job_id = res.job_id;
+	wpres->type = res.type;
+	wpres->timeout = res.timeout;
+	wpres->command = strv[0];
+	wpres->wait_status = res.wait_status;
+	wpres->error_code = res.error_code;
+	wpres->start.tv_sec = res.start_sec;
+	wpres->start.tv_usec = res.start_usec;
+	wpres->stop.tv_sec = res.stop_sec;
+	wpres->stop.tv_usec = res.stop_usec;
+	wpres->runtime.tv_sec = (time_t)res.runtime;
+	wpres->runtime.tv_usec = (res.runtime - wpres->runtime.tv_sec) * 1000000;
+	wpres->time_to_spawn = res.time_to_spawn;
+	if (res.flags & WPROC_RESULT_OUTPUT) {
+		wpres->outstd = strv[1];
+		wpres->outerr = strv[2];
+		wpres->exited_ok = !res.error_code;
+	}
+	if (res.flags & WPROC_RESULT_ERROR_MSG) {
+		wpres->error_msg = strv[3];
+		wpres->exited_ok = FALSE;
+	}
+
+	return 0;
+}
+
 static int wproc_run_job(struct wproc_job *job, nagios_macros *mac);
 static void fo_reassign_wproc_job(void *job_)
 {
 	struct wproc_job *job = (struct wproc_job *)job_;
-	job->wp = get_worker(job->command);
-	if (job->wp != NULL) {
-		job->id = get_job_id(job->wp);
-		/* macros aren't used right now anyways */
-		wproc_run_job(job, NULL);
+	struct wproc_worker *wp;
+	check_result *cr = NULL;
+	service *svc = NULL;
+	host *hst = NULL;
+
+	/* a failed dispatch frees the check result, so find its object first */
+	if (job->type == WPJOB_CHECK && (cr = (check_result *)job->arg) != NULL) {
+		if (cr->service_description != NULL) {
+			svc = find_service(cr->host_name, cr->service_description);
+		} else {
+			hst = find_host(cr->host_name);
+		}
+	}
+
+	job->wp = wp = get_worker(job->command);
+	if (wp != NULL) {
+		job->id = get_job_id(wp);
+		if (fanout_add(wp->jobs, job->id, job) < 0) {
+			logit(NSLOG_RUNTIME_WARNING, TRUE, "wproc: Error: can't add job to %s in fo_reassign_wproc_job\n", wp->name);
+			job->wp = NULL;
+			destroy_job(job);
+		}
+		/* macros aren't used right now anyways. On failure, the job is destroyed */
+		else if (wproc_run_job(job, NULL) == OK) {
+			return;
+		}
 	} else {
 		logit(NSLOG_RUNTIME_WARNING, TRUE, "wproc: Error: can't get_worker() in fo_reassign_wproc_job\n");
+		destroy_job(job);
+	}
+
+	/* nobody is running the check now, so its object has to be checked again */
+	if (svc != NULL) {
+		logit(NSLOG_RUNTIME_WARNING, TRUE, "wproc: Check of service '%s' on host '%s' was lost with its worker, scheduling it again\n", svc->description, svc->host_name);
+		reschedule_lost_service_check(svc);
+	} else if (hst != NULL) {
+		logit(NSLOG_RUNTIME_WARNING, TRUE, "wproc: Check of host '%s' was lost with its worker, scheduling it again\n", hst->name);
+		reschedule_lost_host_check(hst);
 	}
 }
 
-static int handle_worker_result(int sd, int events, void *arg)
+/*
+ * handles a parsed worker result. slot is set when the result was
+ * digested by one of the check result threads. Returns -1 if the
+ * worker seems confused and we should stop reading from it for now.
+ */
+static int handle_worker_message(struct wproc_worker *wp, wproc_result *wpres, struct wpres_slot *slot)
 {
 	wproc_object_job *oj = NULL;
-	char *buf, *error_reason = NULL;
+	struct wproc_job *job;
+	char *error_reason = NULL;
+
+	job = get_job(wp, wpres->job_id);
+	if (!job) {
+		logit(NSLOG_RUNTIME_WARNING, TRUE, "wproc: Job with id '%d' doesn't exist on %s.\n",
+			  wpres->job_id, wp->name);
+		return 0;
+	}
+	if (wpres->type != job->type) {
+		logit(NSLOG_RUNTIME_WARNING, TRUE, "wproc: %s claims job %d is type %d, but we think it's type %d\n",
+			  wp->name, job->id, wpres->type, job->type);
+		return -1;
+	}
+	oj = (wproc_object_job *)job->arg;
+
+	nagios_trace_event(TRACE_WORKER_RESULT, job->type, job->id, wp->pid);
+
+	wp->spawns++;
+	wp->spawn_time += wpres->time_to_spawn;
+	if (wpres->time_to_spawn > wp->spawn_time_max)
+		wp->spawn_time_max = wpres->time_to_spawn;
+
+	/*
+	 * ETIME ("Timer expired") doesn't really happen
+	 * on any modern systems, so we reuse it to mean
+	 * "program timed out"
+	 */
+	if (wpres->error_code == ETIME) {
+		wpres->early_timeout = TRUE;
+	}
+	if (wpres->early_timeout) {
+		asprintf(&error_reason, "timed out after %.2fs", tv_delta_f(&wpres->start, &wpres->stop));
+	}
+	else if (WIFSIGNALED(wpres->wait_status)) {
+		asprintf(&error_reason, "died by signal %d%s after %.2f seconds",
+		         WTERMSIG(wpres->wait_status),
+		         WCOREDUMP(wpres->wait_status) ? " (core dumped)" : "",
+		         tv_delta_f(&wpres->start, &wpres->stop));
+	}
+	else if (job->type != WPJOB_CHECK && WEXITSTATUS(wpres->wait_status) != 0) {
+		asprintf(&error_reason, "is a non-check helper but exited with return code %d",
+		         WEXITSTATUS(wpres->wait_status));
+	}
+	if (error_reason) {
+		logit(NSLOG_RUNTIME_ERROR, TRUE, "wproc: %s job %d from worker %s %s",
+		      wpjob_type_name(job->type), job->id, wp->name, error_reason);
+#ifdef DEBUG
+		/* The log below could leak sensitive information, such as 
+			passwords, so only enable it if you really need it */
+		logit(NSLOG_RUNTIME_ERROR, TRUE, "wproc:   command: %s\n", job->command);
+#endif
+		if (job->type != WPJOB_CHECK && oj) {
+			logit(NSLOG_RUNTIME_ERROR, TRUE, "wproc:   host=%s; service=%s; contact=%s\n",
+			      oj->host_name ? oj->host_name : "(none)",
+			      oj->service_description ? oj->service_description : "(none)",
+			      oj->contact_name ? oj->contact_name : "(none)");
+		} else if (oj) {
+			struct check_result *cr = (struct check_result *)job->arg;
+			logit(NSLOG_RUNTIME_ERROR, TRUE, "wproc:   host=%s; service=%s;\n",
+			      cr->host_name, cr->service_description);
+		}
+		logit(NSLOG_RUNTIME_ERROR, TRUE, "wproc:   early_timeout=%d; exited_ok=%d; wait_status=%d; error_code=%d;\n",
+		      wpres->early_timeout, wpres->exited_ok, wpres->wait_status, wpres->error_code);
+		wproc_logdump_buffer(NSLOG_RUNTIME_ERROR, TRUE, "wproc:   stderr", wpres->outerr);
+		wproc_logdump_buffer(NSLOG_RUNTIME_ERROR, TRUE, "wproc:   stdout", wpres->outstd);
+	}
+	my_free(error_reason);
+
+	switch (job->type) {
+	case WPJOB_CHECK:
+		handle_worker_check(wpres, wp, job, slot);
+		break;
+	case WPJOB_NOTIFY:
+		if (wpres->early_timeout) {
+			if (oj->service_description) {
+				logit(NSLOG_RUNTIME_WARNING, TRUE, "Warning: Notifying contact '%s' of service '%s' on host '%s' by command '%s' timed out after %.2f seconds\n",
+					  oj->contact_name, oj->service_description,
+					  oj->host_name, job->command,
+					  tv2float(&wpres->runtime));
+			} else {
+				logit(NSLOG_RUNTIME_WARNING, TRUE, "Warning: Notifying contact '%s' of host '%s' by command '%s' timed out after %.2f seconds\n",
+					  oj->contact_name, oj->host_name,
+					  job->command, tv2float(&wpres->runtime));
+			}
+		}
+		break;
+	case WPJOB_OCSP:
+		if (wpres->early_timeout) {
+			logit(NSLOG_RUNTIME_WARNING, TRUE, "Warning: OCSP command '%s' for service '%s' on host '%s' timed out after %.2f seconds\n",
+				  job->command, oj->service_description, oj->host_name,
+				  tv2float(&wpres->runtime));
+		}
+		break;
+	case WPJOB_OCHP:
+		if (wpres->early_timeout) {
+			logit(NSLOG_RUNTIME_WARNING, TRUE, "Warning: OCHP command '%s' for host '%s' timed out after %.2f seconds\n",
+				  job->command, oj->host_name, tv2float(&wpres->runtime));
+		}
+		break;
+	case WPJOB_GLOBAL_SVC_EVTHANDLER:
+		if (wpres->early_timeout) {
+			logit(NSLOG_EVENT_HANDLER | NSLOG_RUNTIME_WARNING, TRUE,
+				  "Warning: Global service event handler command '%s' timed out after %.2f seconds\n",
+				  job->command, tv2float(&wpres->runtime));
+		}
+		break;
+	case WPJOB_SVC_EVTHANDLER:
+		if (wpres->early_timeout) {
+			logit(NSLOG_EVENT_HANDLER | NSLOG_RUNTIME_WARNING, TRUE,
+				  "Warning: Service event handler command '%s' timed out after %.2f seconds\n",
+				  job->command, tv2float(&wpres->runtime));
+		}
+		break;
+	case WPJOB_GLOBAL_HOST_EVTHANDLER:
+		if (wpres->early_timeout) {
+			logit(NSLOG_EVENT_HANDLER | NSLOG_RUNTIME_WARNING, TRUE,
+				  "Warning: Global host event handler command '%s' timed out after %.2f seconds\n",
+				  job->command, tv2float(&wpres->runtime));
+		}
+		break;
+	case WPJOB_HOST_EVTHANDLER:
+		if (wpres->early_timeout) {
+			logit(NSLOG_EVENT_HANDLER | NSLOG_RUNTIME_WARNING, TRUE,
+				  "Warning: Host event handler command '%s' timed out after %.2f seconds\n",
+				  job->command, tv2float(&wpres->runtime));
+		}
+		break;
+
+	case WPJOB_CALLBACK:
+		run_job_callback(job, wpres, 0);
+		break;
+
+	case WPJOB_HOST_PERFDATA:
+	case WPJOB_SVC_PERFDATA:
+		/* these require nothing special */
+		break;
+
+	default:
+		logit(NSLOG_RUNTIME_WARNING, TRUE, "Worker %ld: Unknown jobtype: %d\n", (long)wp->pid, job->type);
+		break;
+	}
+	destroy_job(job);
+
+	return 0;
+}
+
+/* runs in the check result threads, so mustn't touch global state */
+static void digest_worker_message(struct wpres_slot *slot)
+{
+	wproc_result *wpres = &slot->wpres;
+
+	memset(wpres, 0, sizeof(*wpres));
+	wpres->job_id = -1;
+	wpres->type = -1;
+	slot->bad_key = NULL;
+	slot->output_parsed = FALSE;
+
+	if (slot->framed) {
+		slot->parsed = parse_worker_frame(wpres, slot->buf, slot->size) == 0;
+		if (!slot->parsed) {
+			return;
+		}
+	}
+	else {
+		slot->parsed = buf2kvvec_prealloc(slot->kvv, slot->buf, slot->size, '=', '\0', KVVEC_ASSIGN) > 0;
+		if (!slot->parsed) {
+			return;
+		}
+
+		wpres->response = slot->kvv;
+		parse_worker_result(wpres, slot->kvv, &slot->bad_key);
+	}
+
+	if (wpres->type != WPJOB_CHECK) {
+		return;
+	}
+
+	if (!slot->arena && !(slot->arena = arena_create(1024))) {
+		return;
+	}
+
+	if (wpres->outstd && *wpres->outstd) {
+		slot->output = arena_strdup(slot->arena, wpres->outstd);
+	}
+	else if (wpres->outerr) {
+		static const char prefix[] = "(No output on stdout) stderr: ";
+		size_t len = strlen(wpres->outerr);
+		if ((slot->output = arena_alloc(slot->arena, sizeof(prefix) + len))) {
+			memcpy(slot->output, prefix, sizeof(prefix) - 1);
+			memcpy(slot->output + sizeof(prefix) - 1, wpres->outerr, len + 1);
+		}
+	}
+
+	parse_check_output_arena(slot->arena, slot->output, &slot->short_output, &slot->long_output, &slot->perf_data, TRUE, FALSE);
+	slot->output_parsed = TRUE;
+}
+
+static void *check_result_thread(void *arg)
+{
+	struct wpres_slot *slot;
+
+	for (;;) {
+		pthread_mutex_lock(&wpres_pool.lock);
+		while (!wpres_pool.stopping && wpres_pool.claim == wpres_pool.head) {
+			pthread_cond_wait(&wpres_pool.cond, &wpres_pool.lock);
+		}
+		if (wpres_pool.stopping) {
+			pthread_mutex_unlock(&wpres_pool.lock);
+			break;
+		}
+		slot = &wpres_pool.ring[wpres_pool.claim++ & WPRES_RING_MASK];
+		pthread_mutex_unlock(&wpres_pool.lock);
+
+		digest_worker_message(slot);
+
+		__sync_synchronize();
+		slot->done = TRUE;
+
+		/* only the first finisher since the main thread last looked
+		 * needs to wake it up */
+		if (!__sync_lock_test_and_set(&wpres_pool.wakeup_pending, 1)) {
+			if (write(wpres_pool.wakeup[1], "", 1) < 0) {
+				/* pipe is full, so the main thread will wake up anyway */
+			}
+		}
+	}
+
+	return NULL;
+}
+
+/* hands digested results to the rest of Nagios, in the order they arrived */
+static void apply_worker_results(void)
+{
+	struct wpres_slot *slot;
+	int confused;
+
+	while (wpres_pool.tail != wpres_pool.head) {
+		slot = &wpres_pool.ring[wpres_pool.tail & WPRES_RING_MASK];
+		if (!slot->done) {
+			break;
+		}
+		__sync_synchronize();
+
+		confused = 0;
+		if (!slot->parsed && slot->framed) {
+			logit(NSLOG_RUNTIME_ERROR, TRUE, "wproc: Failed to parse result frame with len %lu from %s\n",
+				  slot->size, slot->wp->name);
+		}
+		else if (!slot->parsed) {
+			logit(NSLOG_RUNTIME_ERROR, TRUE,
+				  "wproc: Failed to parse key/value vector from worker response with len %lu. First kv=%s",
+				  slot->size, slot->buf);
+		}
+		else {
+			if (slot->bad_key) {
+				logit(NSLOG_RUNTIME_WARNING, TRUE, "wproc: Unrecognized result variable: (i=%d) %s=%s\n",
+					  (int)(slot->bad_key - slot->kvv->kv), slot->bad_key->key, slot->bad_key->value);
+			}
+			confused = handle_worker_message(slot->wp, &slot->wpres, slot) < 0;
+		}
+
+		if (slot->arena) {
+			arena_reset(slot->arena);
+		}
+		slot->output = slot->short_output = NULL;
+		slot->long_output = slot->perf_data = NULL;
+		slot->done = FALSE;
+		wpres_pool.tail++;
+
+		/*
+		 * the worker seems confused, so stop here like the inline
+		 * path stops reading from it, and have the event loop come
+		 * back for the rest once it has polled everything else
+		 */
+		if (confused) {
+			if (wpres_pool.tail != wpres_pool.head && !__sync_lock_test_and_set(&wpres_pool.wakeup_pending, 1)) {
+				if (write(wpres_pool.wakeup[1], "", 1) < 0) {
+					/* pipe is full, so we'll be woken up anyway */
+				}
+			}
+			break;
+		}
+	}
+}
+
+/* waits until every queued result has been handled */
+static void flush_worker_results(void)
+{
+	while (wpres_pool.tail != wpres_pool.head) {
+		apply_worker_results();
+		if (wpres_pool.tail != wpres_pool.head) {
+			sched_yield();
+		}
+	}
+}
+
+static int handle_check_result_wakeup(int sd, int events, void *arg)
+{
+	char buf[64];
+
+	while (read(sd, buf, sizeof(buf)) > 0)
+		;
+	wpres_pool.wakeup_pending = 0;
+	__sync_synchronize();
+
+	apply_worker_results();
+
+	return 0;
+}
+
+/* copies a message from a worker's iocache into the ring */
+static void queue_worker_message(struct wproc_worker *wp, char *buf, unsigned long size)
+{
+	struct wpres_slot *slot;
+
+	/* the ring is full, so wait for the oldest result to be digested */
+	while (wpres_pool.head - wpres_pool.tail >= WPRES_RING_SIZE) {
+		apply_worker_results();
+		if (wpres_pool.head - wpres_pool.tail >= WPRES_RING_SIZE) {
+			sched_yield();
+		}
+	}
+
+	slot = &wpres_pool.ring[wpres_pool.head & WPRES_RING_MASK];
+	if (slot->bufsize < size + 1) {
+		char *nbuf = realloc(slot->buf, size + 1);
+		if (!nbuf) {
+			logit(NSLOG_RUNTIME_ERROR, TRUE, "wproc: Failed to allocate %lu bytes for result from %s\n",
+				  size + 1, wp->name);
+			return;
+		}
+		slot->buf = nbuf;
+		slot->bufsize = size + 1;
+	}
+	memcpy(slot->buf, buf, size);
+	slot->buf[size] = 0;
+	slot->size = size;
+	slot->wp = wp;
+	slot->framed = wp->frames > 0;
+
+	pthread_mutex_lock(&wpres_pool.lock);
+	wpres_pool.head++;
+	pthread_cond_signal(&wpres_pool.cond);
+	pthread_mutex_unlock(&wpres_pool.lock);
+}
+
+static void stop_check_result_threads(void)
+{
+	unsigned int i;
+
+	if (!wpres_pool.nthreads) {
+		return;
+	}
+
+	/* a forked child has the memory, but not the threads */
+	if (wpres_pool.pid == getpid()) {
+		pthread_mutex_lock(&wpres_pool.lock);
+		wpres_pool.stopping = TRUE;
+		pthread_cond_broadcast(&wpres_pool.cond);
+		pthread_mutex_unlock(&wpres_pool.lock);
+		for (i = 0; i < wpres_pool.nthreads; i++) {
+			pthread_join(wpres_pool.threads[i], NULL);
+		}
+		iobroker_close(nagios_iobs, wpres_pool.wakeup[0]);
+	}
+	else {
+		close(wpres_pool.wakeup[0]);
+	}
+	close(wpres_pool.wakeup[1]);
+
+	/* results that weren't handled are dropped along with their jobs */
+	for (i = 0; i < WPRES_RING_SIZE; i++) {
+		struct wpres_slot *slot = &wpres_pool.ring[i];
+		my_free(slot->buf);
+		arena_destroy(slot->arena);
+		kvvec_destroy(slot->kvv, 0);
+	}
+	my_free(wpres_pool.ring);
+	my_free(wpres_pool.threads);
+	memset(&wpres_pool, 0, sizeof(wpres_pool));
+}
+
+/*
+ * Threads are started when the first result comes in rather than
+ * at startup, so we're done forking off workers by then.
+ */
+static int start_check_result_threads(unsigned int nthreads)
+{
+	unsigned int i;
+
+	memset(&wpres_pool, 0, sizeof(wpres_pool));
+	wpres_pool.wakeup[0] = wpres_pool.wakeup[1] = -1;
+
+	wpres_pool.ring = calloc(WPRES_RING_SIZE, sizeof(struct wpres_slot));
+	wpres_pool.threads = calloc(nthreads, sizeof(pthread_t));
+	if (!wpres_pool.ring || !wpres_pool.threads) {
+		goto fail;
+	}
+	for (i = 0; i < WPRES_RING_SIZE; i++) {
+		if (!(wpres_pool.ring[i].kvv = kvvec_create(16)))
+			goto fail;
+	}
+
+	if (pipe(wpres_pool.wakeup) < 0) {
+		wpres_pool.wakeup[0] = wpres_pool.wakeup[1] = -1;
+		goto fail;
+	}
+	for (i = 0; i < 2; i++) {
+		fcntl(wpres_pool.wakeup[i], F_SETFL, O_NONBLOCK);
+		fcntl(wpres_pool.wakeup[i], F_SETFD, FD_CLOEXEC);
+	}
+	if (iobroker_register(nagios_iobs, wpres_pool.wakeup[0], NULL, handle_check_result_wakeup) < 0) {
+		goto fail;
+	}
+
+	pthread_mutex_init(&wpres_pool.lock, NULL);
+	pthread_cond_init(&wpres_pool.cond, NULL);
+	wpres_pool.pid = getpid();
+
+	for (i = 0; i < nthreads; i++) {
+		if (pthread_create(&wpres_pool.threads[i], NULL, check_result_thread, NULL)) {
+			break;
+		}
+	}
+	wpres_pool.nthreads = i;
+	if (!i) {
+		iobroker_unregister(nagios_iobs, wpres_pool.wakeup[0]);
+		goto fail;
+	}
+	if (i < nthreads) {
+		logit(NSLOG_RUNTIME_WARNING, TRUE, "wproc: Only started %u of %u check result threads: %s\n",
+			  i, nthreads, strerror(errno));
+	}
+
+	logit(NSLOG_INFO_MESSAGE, FALSE, "wproc: Started %u check result threads\n", i);
+	return OK;
+
+fail:
+	logit(NSLOG_RUNTIME_ERROR, TRUE, "wproc: Failed to start check result threads: %s. Parsing results in the main thread.\n",
+		  strerror(errno));
+	if (wpres_pool.ring) {
+		for (i = 0; i < WPRES_RING_SIZE; i++) {
+			if (wpres_pool.ring[i].kvv)
+				kvvec_destroy(wpres_pool.ring[i].kvv, 0);
+		}
+	}
+	if (wpres_pool.wakeup[0] >= 0) {
+		close(wpres_pool.wakeup[0]);
+		close(wpres_pool.wakeup[1]);
+	}
+	my_free(wpres_pool.ring);
+	my_free(wpres_pool.threads);
+	memset(&wpres_pool, 0, sizeof(wpres_pool));
+	return ERROR;
+}
+
+/*
+ * handles one frame from a worker, be it from its socket or its
+ * result ring. Returns -1 if the worker seems confused.
+ */
+static int handle_worker_frame(struct wproc_worker *wp, char *buf, unsigned long size)
+{
+	struct wproc_frame_hdr hdr;
+	wproc_result wpres;
+
+	if (size < sizeof(hdr)) {
+		logit(NSLOG_RUNTIME_ERROR, TRUE, "wproc: Runt frame with len %lu from %s\n", size, wp->name);
+		return 0;
+	}
+	memcpy(&hdr, buf, sizeof(hdr));
+	if (hdr.version != WPROC_FRAME_VERSION || hdr.size != size) {
+		logit(NSLOG_RUNTIME_ERROR, TRUE, "wproc: Malformed frame with len %lu from %s\n", size, wp->name);
+		return 0;
+	}
+
+	if (hdr.type == WPROC_FRAME_LOG) {
+		struct wproc_frame_log log;
+		char *data, *msg;
+
+		if ((data = worker_frame_body(buf, size, &log, sizeof(log))) &&
+		    !worker_frame_strings(buf, size, data, &msg, &log.msg_len, 1)) {
+			logit(NSLOG_INFO_MESSAGE, TRUE, "wproc: %s: %s\n", wp->name, msg);
+		}
+		return 0;
+	}
+	if (hdr.type != WPROC_FRAME_RESULT) {
+		logit(NSLOG_RUNTIME_WARNING, TRUE, "wproc: Ignoring frame of unknown type %u from %s\n",
+			  hdr.type, wp->name);
+		return 0;
+	}
+
+	if (wpres_pool.nthreads) {
+		queue_worker_message(wp, buf, size);
+		return 0;
+	}
+
+	memset(&wpres, 0, sizeof(wpres));
+	if (parse_worker_frame(&wpres, buf, size) < 0) {
+		logit(NSLOG_RUNTIME_ERROR, TRUE, "wproc: Failed to parse result frame with len %lu from %s\n",
+			  size, wp->name);
+		return 0;
+	}
+
+	return handle_worker_message(wp, &wpres, NULL);
+}
+
+/* the framed counterpart of the kvvec loop in handle_worker_result() */
+static void read_worker_frames(struct wproc_worker *wp)
+{
+	char *buf;
+	unsigned long size;
+
+	while ((buf = worker_ioc2frame(wp->ioc, &size))) {
+		if (handle_worker_frame(wp, buf, size) < 0)
+			return;
+	}
+
+	if (size) {
+		/*
+		 * We can't find the start of the next frame, so hang up.
+		 * The worker is then removed and its jobs reassigned when
+		 * we next read from it.
+		 */
+		logit(NSLOG_RUNTIME_ERROR, TRUE, "wproc: Garbled frame with size %lu from %s. Disconnecting it.\n",
+			  size, wp->name);
+		shutdown(wp->sd, SHUT_RDWR);
+	}
+}
+
+static void check_result_threads_init(void)
+{
+	if (check_result_threads > 0 && !wpres_pool.nthreads) {
+		if (start_check_result_threads(check_result_threads) != OK) {
+			check_result_threads = 0;
+		}
+	}
+}
+
+/*
+ * Results in the ring are handled in place, unless the check result
+ * threads are busy with them. Since the ring keeps records apart, a
+ * bad frame is just skipped, and we never stop early, as the worker
+ * only rings the doorbell when it finds the ring empty.
+ */
+static int handle_worker_ring(int fd, int events, void *arg)
+{
+	struct wproc_worker *wp = (struct wproc_worker *)arg;
+	char *buf;
+	unsigned long size;
+
+	check_result_threads_init();
+
+	shmring_ack(wp->results_ring);
+	while ((buf = shmring_peek(wp->results_ring, &size))) {
+		handle_worker_frame(wp, buf, size);
+		shmring_consume(wp->results_ring);
+	}
+
+	if (wpres_pool.nthreads) {
+		apply_worker_results();
+	}
+
+	return 0;
+}
+
+static int handle_worker_result(int sd, int events, void *arg)
+{
+	char *buf;
 	unsigned long size;
 	int ret;
 	static struct kvvec kvv = KVVEC_INITIALIZER;
@@ -746,14 +1616,25 @@ static int handle_worker_result(int sd, int events, void *arg)
 			 */
 			logit(NSLOG_RUNTIME_ERROR, TRUE, "wproc: All our workers are dead, we can't do anything!");
 		}
+		/* results still in the pipeline refer to this worker's jobs */
+		if (wp->results_ring) {
+			handle_worker_ring(shmring_eventfd(wp->results_ring), 0, wp);
+		}
+		flush_worker_results();
 		remove_worker(wp);
 		fanout_destroy(wp->jobs, fo_reassign_wproc_job);
 		wp->jobs = NULL;
 		wproc_destroy(wp, WPROC_FORCE);
 		return 0;
 	}
-	while ((buf = worker_ioc2msg(wp->ioc, &size, 0))) {
-		struct wproc_job *job;
+
+	check_result_threads_init();
+
+	if (wp->frames) {
+		read_worker_frames(wp);
+	}
+
+	while (!wp->frames && (buf = worker_ioc2msg(wp->ioc, &size, 0))) {
 		wproc_result wpres;
 
 		/* log messages are handled first */
@@ -762,6 +1643,12 @@ static int handle_worker_result(int sd, int events, void *arg)
 			continue;
 		}
 
+		/* let the check result threads do the parsing */
+		if (wpres_pool.nthreads) {
+			queue_worker_message(wp, buf, size);
+			continue;
+		}
+
 		/* for everything else we need to actually parse */
 		if (buf2kvvec_prealloc(&kvv, buf, size, '=', '\0', KVVEC_ASSIGN) <= 0) {
 			logit(NSLOG_RUNTIME_ERROR, TRUE,
@@ -774,141 +1661,15 @@ static int handle_worker_result(int sd, int events, void *arg)
 		wpres.job_id = -1;
 		wpres.type = -1;
 		wpres.response = &kvv;
-		parse_worker_result(&wpres, &kvv);
+		parse_worker_result(&wpres, &kvv, NULL);
 
-		job = get_job(wp, wpres.job_id);
-		if (!job) {
-			logit(NSLOG_RUNTIME_WARNING, TRUE, "wproc: Job with id '%d' doesn't exist on %s.\n",
-				  wpres.job_id, wp->name);
-			continue;
-		}
-		if (wpres.type != job->type) {
-			logit(NSLOG_RUNTIME_WARNING, TRUE, "wproc: %s claims job %d is type %d, but we think it's type %d\n",
-				  wp->name, job->id, wpres.type, job->type);
-			break;
-		}
-		oj = (wproc_object_job *)job->arg;
-
-		/*
-		 * ETIME ("Timer expired") doesn't really happen
-		 * on any modern systems, so we reuse it to mean
-		 * "program timed out"
-		 */
-		if (wpres.error_code == ETIME) {
-			wpres.early_timeout = TRUE;
-		}
-		if (wpres.early_timeout) {
-			asprintf(&error_reason, "timed out after %.2fs", tv_delta_f(&wpres.start, &wpres.stop));
-		}
-		else if (WIFSIGNALED(wpres.wait_status)) {
-			asprintf(&error_reason, "died by signal %d%s after %.2f seconds",
-			         WTERMSIG(wpres.wait_status),
-			         WCOREDUMP(wpres.wait_status) ? " (core dumped)" : "",
-			         tv_delta_f(&wpres.start, &wpres.stop));
-		}
-		else if (job->type != WPJOB_CHECK && WEXITSTATUS(wpres.wait_status) != 0) {
-			asprintf(&error_reason, "is a non-check helper but exited with return code %d",
-			         WEXITSTATUS(wpres.wait_status));
-		}
-		if (error_reason) {
-			logit(NSLOG_RUNTIME_ERROR, TRUE, "wproc: %s job %d from worker %s %s",
-			      wpjob_type_name(job->type), job->id, wp->name, error_reason);
-#ifdef DEBUG
-			/* The log below could leak sensitive information, such as 
-				passwords, so only enable it if you really need it */
-			logit(NSLOG_RUNTIME_ERROR, TRUE, "wproc:   command: %s\n", job->command);
-#endif
-			if (job->type != WPJOB_CHECK && oj) {
-				logit(NSLOG_RUNTIME_ERROR, TRUE, "wproc:   host=%s; service=%s; contact=%s\n",
-				      oj->host_name ? oj->host_name : "(none)",
-				      oj->service_description ? oj->service_description : "(none)",
-				      oj->contact_name ? oj->contact_name : "(none)");
-			} else if (oj) {
-				struct check_result *cr = (struct check_result *)job->arg;
-				logit(NSLOG_RUNTIME_ERROR, TRUE, "wproc:   host=%s; service=%s;\n",
-				      cr->host_name, cr->service_description);
-			}
-			logit(NSLOG_RUNTIME_ERROR, TRUE, "wproc:   early_timeout=%d; exited_ok=%d; wait_status=%d; error_code=%d;\n",
-			      wpres.early_timeout, wpres.exited_ok, wpres.wait_status, wpres.error_code);
-			wproc_logdump_buffer(NSLOG_RUNTIME_ERROR, TRUE, "wproc:   stderr", wpres.outerr);
-			wproc_logdump_buffer(NSLOG_RUNTIME_ERROR, TRUE, "wproc:   stdout", wpres.outstd);
-		}
-		my_free(error_reason);
-
-		switch (job->type) {
-		case WPJOB_CHECK:
-			ret = handle_worker_check(&wpres, wp, job);
-			break;
-		case WPJOB_NOTIFY:
-			if (wpres.early_timeout) {
-				if (oj->service_description) {
-					logit(NSLOG_RUNTIME_WARNING, TRUE, "Warning: Notifying contact '%s' of service '%s' on host '%s' by command '%s' timed out after %.2f seconds\n",
-						  oj->contact_name, oj->service_description,
-						  oj->host_name, job->command,
-						  tv2float(&wpres.runtime));
-				} else {
-					logit(NSLOG_RUNTIME_WARNING, TRUE, "Warning: Notifying contact '%s' of host '%s' by command '%s' timed out after %.2f seconds\n",
-						  oj->contact_name, oj->host_name,
-						  job->command, tv2float(&wpres.runtime));
-				}
-			}
-			break;
-		case WPJOB_OCSP:
-			if (wpres.early_timeout) {
-				logit(NSLOG_RUNTIME_WARNING, TRUE, "Warning: OCSP command '%s' for service '%s' on host '%s' timed out after %.2f seconds\n",
-					  job->command, oj->service_description, oj->host_name,
-					  tv2float(&wpres.runtime));
-			}
-			break;
-		case WPJOB_OCHP:
-			if (wpres.early_timeout) {
-				logit(NSLOG_RUNTIME_WARNING, TRUE, "Warning: OCHP command '%s' for host '%s' timed out after %.2f seconds\n",
-					  job->command, oj->host_name, tv2float(&wpres.runtime));
-			}
-			break;
-		case WPJOB_GLOBAL_SVC_EVTHANDLER:
-			if (wpres.early_timeout) {
-				logit(NSLOG_EVENT_HANDLER | NSLOG_RUNTIME_WARNING, TRUE,
-					  "Warning: Global service event handler command '%s' timed out after %.2f seconds\n",
-					  job->command, tv2float(&wpres.runtime));
-			}
-			break;
-		case WPJOB_SVC_EVTHANDLER:
-			if (wpres.early_timeout) {
-				logit(NSLOG_EVENT_HANDLER | NSLOG_RUNTIME_WARNING, TRUE,
-					  "Warning: Service event handler command '%s' timed out after %.2f seconds\n",
-					  job->command, tv2float(&wpres.runtime));
-			}
-			break;
-		case WPJOB_GLOBAL_HOST_EVTHANDLER:
-			if (wpres.early_timeout) {
-				logit(NSLOG_EVENT_HANDLER | NSLOG_RUNTIME_WARNING, TRUE,
-					  "Warning: Global host event handler command '%s' timed out after %.2f seconds\n",
-					  job->command, tv2float(&wpres.runtime));
-			}
-			break;
-		case WPJOB_HOST_EVTHANDLER:
-			if (wpres.early_timeout) {
-				logit(NSLOG_EVENT_HANDLER | NSLOG_RUNTIME_WARNING, TRUE,
-					  "Warning: Host event handler command '%s' timed out after %.2f seconds\n",
-					  job->command, tv2float(&wpres.runtime));
-			}
-			break;
-
-		case WPJOB_CALLBACK:
-			run_job_callback(job, &wpres, 0);
-			break;
-
-		case WPJOB_HOST_PERFDATA:
-		case WPJOB_SVC_PERFDATA:
-			/* these require nothing special */
+		if (handle_worker_message(wp, &wpres, NULL) < 0)
 			break;
+	}
 
-		default:
-			logit(NSLOG_RUNTIME_WARNING, TRUE, "Worker %ld: Unknown jobtype: %d\n", (long)wp->pid, job->type);
-			break;
-		}
-		destroy_job(job);
+	/* pick up whatever the threads have finished meanwhile */
+	if (wpres_pool.nthreads) {
+		apply_worker_results();
 	}
 
 	return 0;
@@ -927,11 +1688,33 @@ int workers_alive(void)
 	return alive;
 }
 
+/*
+ * Creates the shared memory rings for a worker. If we can't, we
+ * just talk to it over its socket.
+ */
+static void setup_worker_rings(struct wproc_worker *wp)
+{
+	wp->jobs_ring = shmring_create(worker_shm_ring_size);
+	wp->results_ring = shmring_create(worker_shm_ring_size);
+	if (wp->jobs_ring && wp->results_ring &&
+	    iobroker_register(nagios_iobs, shmring_eventfd(wp->results_ring), wp, handle_worker_ring) == 0)
+	{
+		return;
+	}
+
+	logit(NSLOG_RUNTIME_WARNING, TRUE, "wproc: Failed to set up shared memory rings for %s: %s. Using its socket.\n",
+		  wp->name ? wp->name : "worker", strerror(errno));
+	shmring_destroy(wp->jobs_ring);
+	shmring_destroy(wp->results_ring);
+	wp->jobs_ring = wp->results_ring = NULL;
+}
+
 /* a service for registering workers */
 static int register_worker(int sd, char *buf, unsigned int len)
 {
-	int i, is_global = 1;
-	struct kvvec *info;
+	int i, is_global = 1, want_shm = 0, want_env = 0;
+	struct kvvec *info, *env_kvvp;
+	struct kvvec_buf *env_kvvb = NULL;
 	struct wproc_worker *worker;
 
 	logit(NSLOG_INFO_MESSAGE, TRUE, "wproc: Registry request: %s\n", buf);
@@ -964,6 +1747,19 @@ static int register_worker(int sd, char *buf, unsigned int len)
 		else if (!strcmp(kv->key, "max_jobs")) {
 			worker->max_jobs = atoi(kv->value);
 		}
+		else if (!strcmp(kv->key, "shm")) {
+			want_shm = atoi(kv->value) > 0;
+		}
+		else if (!strcmp(kv->key, "base_env")) {
+			want_env = atoi(kv->value) > 0;
+		}
+		else if (!strcmp(kv->key, "frames")) {
+			worker->frames = atoi(kv->value);
+			if (worker->frames > WPROC_FRAME_VERSION)
+				worker->frames = WPROC_FRAME_VERSION;
+			if (worker->frames < 0)
+				worker->frames = 0;
+		}
 		else if (!strcmp(kv->key, "plugin")) {
 			struct wproc_list *command_handlers;
 			is_global = 0;
@@ -1002,7 +1798,43 @@ static int register_worker(int sd, char *buf, unsigned int len)
 	}
 	wproc_num_workers_online++;
 	kvvec_destroy(info, 0);
-	nsock_printf_nul(sd, "OK");
+	if (want_shm && worker->frames && worker_shm_ring_size) {
+		setup_worker_rings(worker);
+	}
+	/*
+	 * The constant macros go in the worker's own environment once,
+	 * right after the reply, rather than with every job
+	 */
+	if (want_env && worker->frames && (env_kvvp = env_macros_to_kvv(get_global_macros(), ENV_MACROS_CONSTANT))) {
+		env_kvvb = kvvec2buf(env_kvvp, '=', '\n', 0);
+		kvvec_destroy(env_kvvp, KVVEC_FREE_KEYS);
+	}
+	if (worker->jobs_ring) {
+		char reply[80];
+		int fds[4];
+
+		fds[0] = shmring_memfd(worker->jobs_ring);
+		fds[1] = shmring_eventfd(worker->jobs_ring);
+		fds[2] = shmring_memfd(worker->results_ring);
+		fds[3] = shmring_eventfd(worker->results_ring);
+		snprintf(reply, sizeof(reply), "OK frames=%d;shm=%lu%s", worker->frames, shmring_size(worker->jobs_ring), env_kvvb ? ";base_env=1" : "");
+		shmring_send_fds(sd, reply, strlen(reply) + 1, fds, 4);
+	}
+	else if (worker->frames)
+		nsock_printf_nul(sd, "OK frames=%d%s", worker->frames, env_kvvb ? ";base_env=1" : "");
+	else
+		nsock_printf_nul(sd, "OK");
+	if (env_kvvb) {
+		struct wproc_frame_env body;
+		struct iovec strv[1];
+
+		strv[0].iov_base = env_kvvb->buf;
+		strv[0].iov_len = body.env_len = env_kvvb->buflen;
+		if (worker_send_frame(sd, WPROC_FRAME_ENV, &body, sizeof(body), strv, 1) > 0)
+			worker->base_env = 1;
+		free(env_kvvb->buf);
+		free(env_kvvb);
+	}
 
 	/* signal query handler to release its iocache for this one */
 	return QH_TAKEOVER;
@@ -1016,9 +1848,12 @@ static int wproc_query_handler(int sd, char *buf, unsigned int len)
 		nsock_printf_nul(sd, "Control worker processes.\n"
 			"Valid commands:\n"
 			"  wpstats              Print general job information\n"
+			"  wpjobs               Print the number of checks in flight\n"
 			"  register <options>   Register a new worker\n"
-			"                       <options> can be name, pid, max_jobs and/or plugin.\n"
-			"                       There can be many plugin args.");
+			"                       <options> can be name, pid, max_jobs, frames, base_env and/or plugin.\n"
+			"                       There can be many plugin args. frames=<version>\n"
+			"                       asks for binary framing rather than key/value vectors.\n"
+			"                       base_env=1 asks for the constant macros once, up front.");
 		return 0;
 	}
 
@@ -1035,21 +1870,34 @@ static int wproc_query_handler(int sd, char *buf, unsigned int len)
 
 		for (i = 0; i < workers.len; i++) {
 			struct wproc_worker *wp = workers.wps[i];
-			nsock_printf(sd, "name=%s;pid=%ld;jobs_running=%u;jobs_started=%u\n",
+			nsock_printf(sd, "name=%s;pid=%ld;jobs_running=%u;jobs_started=%u;"
+					"spawn_latency_avg=%.6f;spawn_latency_max=%.6f;shm=%lu\n",
 					wp->name, (long)wp->pid,
-					wp->jobs_running, wp->jobs_started);
+					wp->jobs_running, wp->jobs_started,
+					wp->spawns ? wp->spawn_time / wp->spawns : 0.0,
+					wp->spawn_time_max,
+					wp->jobs_ring ? shmring_size(wp->jobs_ring) : 0);
 		}
 		return 0;
 	}
+	if (!strcmp(buf, "wpjobs")) {
+		nsock_printf(sd, "jobs_running=%u;host_checks=%u;service_checks=%u;overdue=%u\n",
+				loadctl.jobs_running, checks_in_flight(0), checks_in_flight(1),
+				check_deadlines.overdue);
+		return 0;
+	}
 
 	return 400;
 }
 
 static int spawn_core_worker(void)
 {
-	char *argvec[] = {nagios_binary_path, "--worker", qh_socket_path ? qh_socket_path : DEFAULT_QUERY_SOCKET, NULL};
+	char *argvec[] = {nagios_binary_path, "--worker", qh_socket_path ? qh_socket_path : DEFAULT_QUERY_SOCKET, NULL, NULL};
 	int ret;
 
+	if (worker_use_posix_spawn == TRUE)
+		argvec[3] = "--worker-posix-spawn";
+
 	if ((ret = spawn_helper(argvec)) < 0)
 		logit(NSLOG_RUNTIME_ERROR, TRUE, "wproc: Failed to launch core worker: %s\n", strerror(errno));
 	else
@@ -1130,6 +1978,9 @@ static int wproc_run_job(struct wproc_job *job, nagios_macros *mac)
 {
 	static struct kvvec kvv    = KVVEC_INITIALIZER;
 	struct kvvec_buf *kvvb     = NULL;
+	char *buf                  = NULL;
+	char *ring_buf             = NULL;
+	unsigned long bufsize      = 0;
 	struct kvvec *env_kvvp     = NULL;
 	struct kvvec_buf *env_kvvb = NULL;
 	struct wproc_worker *wp    = NULL;
@@ -1151,20 +2002,10 @@ static int wproc_run_job(struct wproc_job *job, nagios_macros *mac)
 
 	wp = job->wp;
 
-	/* job_id, type, command and timeout */
-	if (!kvvec_init(&kvv, 4)) {
-		return ERROR;
-	}
-
-	kvvec_addkv(&kvv, "job_id", (char *)mkstr("%d", job->id));
-	kvvec_addkv(&kvv, "type", (char *)mkstr("%d", job->type));
-	kvvec_addkv(&kvv, "command", job->command);
-	kvvec_addkv(&kvv, "timeout", (char *)mkstr("%u", job->timeout));
-
-	/* Add the macro environment variables */
+	/* Add the macro environment variables, less what the worker has */
 	if (mac != NULL) {
 
-		env_kvvp = macros_to_kvv(mac);
+		env_kvvp = env_macros_to_kvv(mac, wp->base_env ? ENV_MACROS_VOLATILE : ENV_MACROS_ALL);
 
 		if (env_kvvp != NULL) {
 
@@ -1172,25 +2013,75 @@ static int wproc_run_job(struct wproc_job *job, nagios_macros *mac)
 
 			if (env_kvvb == NULL) {
 				kvvec_destroy(env_kvvp, KVVEC_FREE_KEYS);
-			}
-			else {
-				/* no reason to call strlen("env") 
-				  when we know it's 3 characters */
-				kvvec_addkv_wlen(&kvv, "env", 3, env_kvvb->buf, env_kvvb->buflen);
+				env_kvvp = NULL;
 			}
 		}
 	}
 
-	kvvb = build_kvvec_buf(&kvv);
+	if (wp->frames) {
+		struct wproc_frame_job body;
+		struct iovec strv[2];
+
+		body.job_id = job->id;
+		body.type = job->type;
+		body.timeout = job->timeout;
+		strv[0].iov_base = job->command;
+		strv[0].iov_len = body.command_len = strlen(job->command);
+		strv[1].iov_base = env_kvvb ? env_kvvb->buf : NULL;
+		strv[1].iov_len = body.env_len = env_kvvb ? env_kvvb->buflen : 0;
+
+		/* straight into the worker's ring if there's room, or down the socket */
+		bufsize = worker_frame_size(sizeof(body), strv, 2);
+		if (wp->jobs_ring && (ring_buf = shmring_reserve(wp->jobs_ring, bufsize))) {
+			worker_write_frame(ring_buf, bufsize, WPROC_FRAME_JOB, &body, sizeof(body), strv, 2);
+			shmring_commit(wp->jobs_ring);
+			wp->jobs_running++;
+			wp->jobs_started++;
+			loadctl.jobs_running++;
+			goto out;
+		}
+		buf = worker_build_frame(WPROC_FRAME_JOB, &body, sizeof(body), strv, 2, &bufsize);
+	}
+	else {
+		/* job_id, type, command, timeout and env */
+		if (!kvvec_init(&kvv, 5)) {
+			result = ERROR;
+			goto out;
+		}
 
-	/* ret = write(wp->sd, kvvb->buf, kvvb->bufsize); */
-	ret = nwrite(wp->sd, kvvb->buf, kvvb->bufsize, &written);
+		kvvec_addkv(&kvv, "job_id", (char *)mkstr("%d", job->id));
+		kvvec_addkv(&kvv, "type", (char *)mkstr("%d", job->type));
+		kvvec_addkv(&kvv, "command", job->command);
+		kvvec_addkv(&kvv, "timeout", (char *)mkstr("%u", job->timeout));
+		if (env_kvvb != NULL) {
+			/* no reason to call strlen("env") 
+			  when we know it's 3 characters */
+			kvvec_addkv_wlen(&kvv, "env", 3, env_kvvb->buf, env_kvvb->buflen);
+		}
 
-	if (ret != (int) kvvb->bufsize) {
+		if ((kvvb = build_kvvec_buf(&kvv)) != NULL) {
+			/* bufsize, not buflen, as it gets us the delimiter */
+			buf = kvvb->buf;
+			bufsize = kvvb->bufsize;
+			free(kvvb);
+		}
+	}
+
+	if (buf == NULL) {
+		logit(NSLOG_RUNTIME_ERROR, TRUE, "wproc: Failed to build job message for '%s'\n", wp->name);
+		destroy_job(job);
+		result = ERROR;
+		goto out;
+	}
+
+	/* ret = write(wp->sd, buf, bufsize); */
+	ret = nwrite(wp->sd, buf, bufsize, &written);
+
+	if (ret != (int) bufsize) {
 
 		logit(NSLOG_RUNTIME_ERROR, TRUE, 
 			"wproc: '%s' seems to be choked. ret = %d; bufsize = %lu: written = %lu; errno = %d (%s)\n",
-			wp->name, ret, kvvb->bufsize, (long unsigned int) written, errno, strerror(errno));
+			wp->name, ret, bufsize, (long unsigned int) written, errno, strerror(errno));
 		destroy_job(job);
 		result = ERROR;
 
@@ -1200,6 +2091,7 @@ static int wproc_run_job(struct wproc_job *job, nagios_macros *mac)
 		loadctl.jobs_running++;
 	}
 
+out:
 	if (env_kvvp != NULL) {
 		kvvec_destroy(env_kvvp, KVVEC_FREE_KEYS);
 	}
@@ -1209,8 +2101,7 @@ static int wproc_run_job(struct wproc_job *job, nagios_macros *mac)
 		free(env_kvvb);
 	}
 
-	free(kvvb->buf);
-	free(kvvb);
+	free(buf);
 
 	return result;
 }
@@ -1281,6 +2172,11 @@ int wproc_run_check(check_result *cr, char *cmd, nagios_macros *mac)
 		timeout = host_check_timeout;
 
 	job = create_job(WPJOB_CHECK, cr, timeout, cmd);
+	if (job != NULL) {
+		add_check_deadline(job);
+		nagios_trace_event(TRACE_CHECK_SUBMIT, cr->service_description ? TRACE_SERVICE : TRACE_HOST,
+		                   job->id, job->wp ? job->wp->pid : 0);
+	}
 	return wproc_run_job(job, mac);
 }
 
@@ -61,17 +61,18 @@ enum {
 	WPRES_ru_nsignals,
 	WPRES_ru_nvcsw,
 	WPRES_ru_nivcsw,
+	WPRES_time_to_spawn,
 };
 #include <string.h> /* for strcmp() */
-#line 35 "wpres.gperf"
+#line 36 "wpres.gperf"
 struct wpres_key {
 	const char *name;
 	int code;
 };
 
-#define TOTAL_KEYWORDS 29
+#define TOTAL_KEYWORDS 30
 #define MIN_WORD_LENGTH 4
-#define MAX_WORD_LENGTH 11
+#define MAX_WORD_LENGTH 13
 #define MIN_HASH_VALUE 4
 #define MAX_HASH_VALUE 64
 /* maximum key range = 61, duplicates = 0 */
@@ -138,63 +139,65 @@ wpres_get_key (register const char *str, register size_t len)
 {
   static struct wpres_key wordlist[] =
     {
-#line 41 "wpres.gperf"
+#line 42 "wpres.gperf"
       {"type", WPRES_type},
-#line 45 "wpres.gperf"
+#line 46 "wpres.gperf"
       {"start", WPRES_start},
-#line 48 "wpres.gperf"
+#line 49 "wpres.gperf"
       {"outerr", WPRES_outerr},
-#line 52 "wpres.gperf"
-      {"runtime", WPRES_runtime},
 #line 53 "wpres.gperf"
+      {"runtime", WPRES_runtime},
+#line 54 "wpres.gperf"
       {"ru_utime", WPRES_ru_utime},
-#line 46 "wpres.gperf"
+#line 47 "wpres.gperf"
       {"stop", WPRES_stop},
-#line 62 "wpres.gperf"
+#line 63 "wpres.gperf"
       {"ru_inblock", WPRES_ru_inblock},
-#line 47 "wpres.gperf"
+#line 48 "wpres.gperf"
       {"outstd", WPRES_outstd},
-#line 68 "wpres.gperf"
+#line 69 "wpres.gperf"
       {"ru_nivcsw", WPRES_ru_nivcsw},
-#line 54 "wpres.gperf"
+#line 55 "wpres.gperf"
       {"ru_stime", WPRES_ru_stime},
-#line 65 "wpres.gperf"
-      {"ru_msgrcv", WPRES_ru_msgrcv},
 #line 66 "wpres.gperf"
+      {"ru_msgrcv", WPRES_ru_msgrcv},
+#line 67 "wpres.gperf"
       {"ru_nsignals", WPRES_ru_nsignals},
-#line 58 "wpres.gperf"
+#line 59 "wpres.gperf"
       {"ru_isrss", WPRES_ru_isrss},
-#line 64 "wpres.gperf"
+#line 65 "wpres.gperf"
       {"ru_msgsnd", WPRES_ru_msgsnd},
-#line 40 "wpres.gperf"
+#line 41 "wpres.gperf"
       {"job_id", WPRES_job_id},
-#line 57 "wpres.gperf"
+#line 58 "wpres.gperf"
       {"ru_idrss", WPRES_ru_idrss},
-#line 49 "wpres.gperf"
+#line 50 "wpres.gperf"
       {"exited_ok", WPRES_exited_ok},
-#line 44 "wpres.gperf"
+#line 45 "wpres.gperf"
       {"wait_status", WPRES_wait_status},
-#line 43 "wpres.gperf"
+#line 44 "wpres.gperf"
       {"timeout", WPRES_timeout},
-#line 56 "wpres.gperf"
+#line 57 "wpres.gperf"
       {"ru_ixrss", WPRES_ru_ixrss},
-#line 50 "wpres.gperf"
+#line 51 "wpres.gperf"
       {"error_msg", WPRES_error_msg},
-#line 63 "wpres.gperf"
+#line 64 "wpres.gperf"
       {"ru_oublock", WPRES_ru_oublock},
-#line 51 "wpres.gperf"
+#line 52 "wpres.gperf"
       {"error_code", WPRES_error_code},
-#line 55 "wpres.gperf"
+#line 56 "wpres.gperf"
       {"ru_maxrss", WPRES_ru_maxrss},
-#line 61 "wpres.gperf"
+#line 62 "wpres.gperf"
       {"ru_nswap", WPRES_ru_nswap},
-#line 59 "wpres.gperf"
+#line 60 "wpres.gperf"
       {"ru_minflt", WPRES_ru_minflt},
-#line 42 "wpres.gperf"
+#line 43 "wpres.gperf"
       {"command", WPRES_command},
-#line 67 "wpres.gperf"
+#line 68 "wpres.gperf"
       {"ru_nvcsw", WPRES_ru_nvcsw},
-#line 60 "wpres.gperf"
+#line 70 "wpres.gperf"
+      {"time_to_spawn", WPRES_time_to_spawn},
+#line 61 "wpres.gperf"
       {"ru_majflt", WPRES_ru_majflt}
     };
 
@@ -292,9 +295,12 @@ wpres_get_key (register const char *str, register size_t len)
               case 39:
                 resword = &wordlist[27];
                 goto compare;
-              case 60:
+              case 44:
                 resword = &wordlist[28];
                 goto compare;
+              case 60:
+                resword = &wordlist[29];
+                goto compare;
             }
           return 0;
         compare:
@@ -2001,7 +2001,7 @@ void show_performance_data(void) {
 	time(&current_time);
 
 	/* check all services */
-	for(temp_servicestatus = servicestatus_list; temp_servicestatus != NULL; temp_servicestatus = temp_servicestatus->next) {
+	for(temp_servicestatus = get_servicestatus_list(); temp_servicestatus != NULL; temp_servicestatus = temp_servicestatus->next) {
 
 		/* find the service */
 		temp_service = find_service(temp_servicestatus->host_name, temp_servicestatus->description);
@@ -2084,7 +2084,7 @@ void show_performance_data(void) {
 		}
 
 	/* check all hosts */
-	for(temp_hoststatus = hoststatus_list; temp_hoststatus != NULL; temp_hoststatus = temp_hoststatus->next) {
+	for(temp_hoststatus = get_hoststatus_list(); temp_hoststatus != NULL; temp_hoststatus = temp_hoststatus->next) {
 
 		/* find the host */
 		temp_host = find_host(temp_hoststatus->host_name);
@@ -2933,7 +2933,7 @@ int sort_data(int s_type, int s_option) {
 		return ERROR;
 
 	/* sort all service status entries */
-	for(temp_svcstatus = servicestatus_list; temp_svcstatus != NULL; temp_svcstatus = temp_svcstatus->next) {
+	for(temp_svcstatus = get_servicestatus_list(); temp_svcstatus != NULL; temp_svcstatus = temp_svcstatus->next) {
 
 		/* allocate memory for a new sort structure */
 		new_sortdata = (sortdata *)malloc(sizeof(sortdata));
@@ -2970,7 +2970,7 @@ int sort_data(int s_type, int s_option) {
 		}
 
 	/* sort all host status entries */
-	for(temp_hststatus = hoststatus_list; temp_hststatus != NULL; temp_hststatus = temp_hststatus->next) {
+	for(temp_hststatus = get_hoststatus_list(); temp_hststatus != NULL; temp_hststatus = temp_hststatus->next) {
 
 		/* allocate memory for a new sort structure */
 		new_sortdata = (sortdata *)malloc(sizeof(sortdata));
@@ -414,7 +414,7 @@ void find_hosts_causing_outages(void) {
 	host *temp_host;
 
 	/* check all hosts */
-	for(temp_hoststatus = hoststatus_list; temp_hoststatus != NULL; temp_hoststatus = temp_hoststatus->next) {
+	for(temp_hoststatus = get_hoststatus_list(); temp_hoststatus != NULL; temp_hoststatus = temp_hoststatus->next) {
 
 		/* check only hosts that are not up and not pending */
 		if(temp_hoststatus->status != SD_HOST_UP && temp_hoststatus->status != HOST_PENDING) {
@@ -863,7 +863,7 @@ void show_service_status_totals(void) {
 		regcomp(&preg_hostname, host_filter, REG_ICASE);
 
 	/* check the status of all services... */
-	for(temp_servicestatus = servicestatus_list; temp_servicestatus != NULL; temp_servicestatus = temp_servicestatus->next) {
+	for(temp_servicestatus = get_servicestatus_list(); temp_servicestatus != NULL; temp_servicestatus = temp_servicestatus->next) {
 
 		/* find the host and service... */
 		temp_host = find_host(temp_servicestatus->host_name);
@@ -1130,7 +1130,7 @@ void show_host_status_totals(void) {
 		regcomp(&preg_hostname, host_filter, REG_ICASE);
 
 	/* check the status of all hosts... */
-	for(temp_hoststatus = hoststatus_list; temp_hoststatus != NULL; temp_hoststatus = temp_hoststatus->next) {
+	for(temp_hoststatus = get_hoststatus_list(); temp_hoststatus != NULL; temp_hoststatus = temp_hoststatus->next) {
 
 		/* find the host... */
 		temp_host = find_host(temp_hoststatus->host_name);
@@ -1609,7 +1609,7 @@ void show_service_detail(void) {
 			}
 		else {
 			if(first_entry == TRUE)
-				temp_status = servicestatus_list;
+				temp_status = get_servicestatus_list();
 			else
 				temp_status = temp_status->next;
 			}
@@ -2030,7 +2030,7 @@ void show_service_detail(void) {
 	/* if user couldn't see anything, print out some helpful info... */
 	if(user_has_seen_something == FALSE) {
 
-		if(servicestatus_list != NULL) {
+		if(get_servicestatus_list() != NULL) {
 			printf("<P><div class='errorMessage'>It appears as though you do not have permission to view information for any of the services you requested...</div></P>\n");
 			printf("<P><div class='errorDescription'>If you believe this is an error, check the HTTP server authentication requirements for accessing this CGI<br>");
 			printf("and check the authorization options in your CGI configuration file.</div></P>\n");
@@ -2229,7 +2229,7 @@ void show_host_detail(void) {
 			}
 		else {
 			if(first_entry == TRUE)
-				temp_status = hoststatus_list;
+				temp_status = get_hoststatus_list();
 			else
 				temp_status = temp_status->next;
 			}
@@ -2480,7 +2480,7 @@ void show_host_detail(void) {
 	/* if user couldn't see anything, print out some helpful info... */
 	if(user_has_seen_something == FALSE) {
 
-		if(hoststatus_list != NULL) {
+		if(get_hoststatus_list() != NULL) {
 			printf("<P><div class='errorMessage'>It appears as though you do not have permission to view information for any of the hosts you requested...</div></P>\n");
 			printf("<P><div class='errorDescription'>If you believe this is an error, check the HTTP server authentication requirements for accessing this CGI<br>");
 			printf("and check the authorization options in your CGI configuration file.</div></P>\n");
@@ -3890,7 +3890,7 @@ void show_servicegroup_hostgroup_member_service_status_totals(char *hst_name, vo
 		temp_servicegroup = (servicegroup *)data;
 
 	/* check all services... */
-	for(temp_servicestatus = servicestatus_list; temp_servicestatus != NULL; temp_servicestatus = temp_servicestatus->next) {
+	for(temp_servicestatus = get_servicestatus_list(); temp_servicestatus != NULL; temp_servicestatus = temp_servicestatus->next) {
 
 		if(!strcmp(hst_name, temp_servicestatus->host_name)) {
 
@@ -4048,7 +4048,7 @@ void show_hostgroup_summaries(void) {
 
 		printf("<P><div align='center'>\n");
 
-		if(hoststatus_list != NULL) {
+		if(get_hoststatus_list() != NULL) {
 			printf("<div class='errorMessage'>It appears as though you do not have permission to view information for any of the hosts you requested...</div>\n");
 			printf("<div class='errorDescription'>If you believe this is an error, check the HTTP server authentication requirements for accessing this CGI<br>");
 			printf("and check the authorization options in your CGI configuration file.</div>\n");
@@ -4297,7 +4297,7 @@ void show_hostgroup_service_totals_summary(hostgroup *temp_hostgroup) {
 
 
 	/* check all services... */
-	for(temp_servicestatus = servicestatus_list; temp_servicestatus != NULL; temp_servicestatus = temp_servicestatus->next) {
+	for(temp_servicestatus = get_servicestatus_list(); temp_servicestatus != NULL; temp_servicestatus = temp_servicestatus->next) {
 
 		/* find the host this service is associated with */
 		temp_host = find_host(temp_servicestatus->host_name);
@@ -4607,7 +4607,7 @@ void show_hostgroup_grids(void) {
 
 		printf("<P><div align='center'>\n");
 
-		if(hoststatus_list != NULL) {
+		if(get_hoststatus_list() != NULL) {
 			printf("<div class='errorMessage'>It appears as though you do not have permission to view information for any of the hosts you requested...</div>\n");
 			printf("<div class='errorDescription'>If you believe this is an error, check the HTTP server authentication requirements for accessing this CGI<br>");
 			printf("and check the authorization options in your CGI configuration file.</div>\n");
@@ -4833,11 +4833,11 @@ int sort_services(int s_type, int s_option) {
 	if(s_type == SORT_NONE)
 		return ERROR;
 
-	if(servicestatus_list == NULL)
+	if(get_servicestatus_list() == NULL)
 		return ERROR;
 
 	/* sort all services status entries */
-	for(temp_svcstatus = servicestatus_list; temp_svcstatus != NULL; temp_svcstatus = temp_svcstatus->next) {
+	for(temp_svcstatus = get_servicestatus_list(); temp_svcstatus != NULL; temp_svcstatus = temp_svcstatus->next) {
 
 		/* allocate memory for a new sort structure */
 		new_servicesort = (servicesort *)malloc(sizeof(servicesort));
@@ -4993,11 +4993,11 @@ int sort_hosts(int s_type, int s_option) {
 	if(s_type == SORT_NONE)
 		return ERROR;
 
-	if(hoststatus_list == NULL)
+	if(get_hoststatus_list() == NULL)
 		return ERROR;
 
 	/* sort all hosts status entries */
-	for(temp_hststatus = hoststatus_list; temp_hststatus != NULL; temp_hststatus = temp_hststatus->next) {
+	for(temp_hststatus = get_hoststatus_list(); temp_hststatus != NULL; temp_hststatus = temp_hststatus->next) {
 
 		/* allocate memory for a new sort structure */
 		new_hostsort = (hostsort *)malloc(sizeof(hostsort));
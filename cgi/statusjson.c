@@ -4429,7 +4429,7 @@ json_object *json_status_performance(void) {
 	time(&current_time);
 
 	/* check all services */
-	for(temp_servicestatus = servicestatus_list; temp_servicestatus != NULL; 
+	for(temp_servicestatus = get_servicestatus_list(); temp_servicestatus != NULL; 
 			temp_servicestatus = temp_servicestatus->next) {
 
 		/* find the service */
@@ -4539,7 +4539,7 @@ json_object *json_status_performance(void) {
 		}
 
 	/* check all hosts */
-	for(temp_hoststatus = hoststatus_list; temp_hoststatus != NULL; 
+	for(temp_hoststatus = get_hoststatus_list(); temp_hoststatus != NULL; 
 			temp_hoststatus = temp_hoststatus->next) {
 
 		/* find the host */
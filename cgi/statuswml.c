@@ -1410,7 +1410,7 @@ void display_problems(void) {
 	printf("<table columns='2' align='LL'>\n");
 
 	/* check all hosts */
-	for(temp_hoststatus = hoststatus_list; temp_hoststatus != NULL; temp_hoststatus = temp_hoststatus->next) {
+	for(temp_hoststatus = get_hoststatus_list(); temp_hoststatus != NULL; temp_hoststatus = temp_hoststatus->next) {
 
 		temp_host = find_host(temp_hoststatus->host_name);
 		if(temp_host == NULL)
@@ -1457,7 +1457,7 @@ void display_problems(void) {
 	printf("<table columns='2' align='LL'>\n");
 
 	/* check all services */
-	for(temp_servicestatus = servicestatus_list; temp_servicestatus != NULL; temp_servicestatus = temp_servicestatus->next) {
+	for(temp_servicestatus = get_servicestatus_list(); temp_servicestatus != NULL; temp_servicestatus = temp_servicestatus->next) {
 
 		temp_service = find_service(temp_servicestatus->host_name, temp_servicestatus->description);
 		if(temp_service == NULL)
@@ -392,7 +392,7 @@ void analyze_status_data(void) {
 
 
 	/* check all services */
-	for(temp_servicestatus = servicestatus_list; temp_servicestatus != NULL; temp_servicestatus = temp_servicestatus->next) {
+	for(temp_servicestatus = get_servicestatus_list(); temp_servicestatus != NULL; temp_servicestatus = temp_servicestatus->next) {
 
 		/* see if user is authorized to view this service */
 		temp_service = find_service(temp_servicestatus->host_name, temp_servicestatus->description);
@@ -557,7 +557,7 @@ void analyze_status_data(void) {
 
 
 	/* check all hosts */
-	for(temp_hoststatus = hoststatus_list; temp_hoststatus != NULL; temp_hoststatus = temp_hoststatus->next) {
+	for(temp_hoststatus = get_hoststatus_list(); temp_hoststatus != NULL; temp_hoststatus = temp_hoststatus->next) {
 
 		/* see if user is authorized to view this host */
 		temp_host = find_host(temp_hoststatus->host_name);
@@ -732,7 +732,7 @@ void find_hosts_causing_outages(void) {
 		return;
 
 	/* check all hosts */
-	for(temp_hoststatus = hoststatus_list; temp_hoststatus != NULL; temp_hoststatus = temp_hoststatus->next) {
+	for(temp_hoststatus = get_hoststatus_list(); temp_hoststatus != NULL; temp_hoststatus = temp_hoststatus->next) {
 
 		/* check only hosts that are not up and not pending */
 		if(temp_hoststatus->status != SD_HOST_UP && temp_hoststatus->status != HOST_PENDING) {
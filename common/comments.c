@@ -29,6 +29,7 @@
 #ifdef NSCORE
 #include "../include/nagios.h"
 #include "../include/broker.h"
+#include "../include/sretention.h"
 #endif
 
 #ifdef NSCGI
@@ -158,6 +159,8 @@ int delete_comment(int type, unsigned long comment_id) {
 	broker_comment_data(NEBTYPE_COMMENT_DELETE, NEBFLAG_NONE, NEBATTR_NONE, type, this_comment->entry_type, this_comment->host_name, this_comment->service_description, this_comment->entry_time, this_comment->author, this_comment->comment_data, this_comment->persistent, this_comment->source, this_comment->expires, this_comment->expire_time, comment_id, NULL);
 #endif
 
+	journal_comment(this_comment, TRUE);
+
 	/* first remove from chained hash list */
 	hashslot = hashfunc(this_comment->host_name, NULL, COMMENT_HASHSLOTS);
 	last_hash = NULL;
@@ -494,6 +497,7 @@ int add_comment(int comment_type, int entry_type, char *host_name, char *svc_des
 	/* send data to event broker */
 	broker_comment_data(NEBTYPE_COMMENT_LOAD, NEBFLAG_NONE, NEBATTR_NONE, comment_type, entry_type, host_name, svc_description, entry_time, author, comment_data, persistent, source, expires, expire_time, comment_id, NULL);
 #endif
+	journal_comment(new_comment, FALSE);
 #endif
 
 	return OK;
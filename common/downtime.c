@@ -31,6 +31,7 @@
 #else
 #include "../include/nagios.h"
 #include "../include/broker.h"
+#include "../include/sretention.h"
 #endif
 
 
@@ -529,6 +530,9 @@ int register_downtime(int type, unsigned long downtime_id) {
 		}
 #endif
 
+	/* the downtime has its comment now, so it's complete */
+	journal_downtime(temp_downtime, FALSE);
+
 	return OK;
 	}
 
@@ -713,6 +717,7 @@ int handle_scheduled_downtime(scheduled_downtime *temp_downtime) {
 
 		/* set the in effect flag */
 		temp_downtime->is_in_effect = TRUE;
+		journal_downtime(temp_downtime, FALSE);
 
 		/* update the status data */
 		if(temp_downtime->type == HOST_DOWNTIME)
@@ -1086,6 +1091,7 @@ int delete_downtime(int type, unsigned long downtime_id) {
 		return ERROR;
 
 	downtime_remove(this_downtime);
+	journal_downtime(this_downtime, TRUE);
 
 	/* first remove the comment associated with this downtime */
 	if(this_downtime->type == HOST_DOWNTIME)
@@ -273,6 +273,381 @@ int process_macros(char *input_buffer, char **output_buffer, int options) {
 	return process_macros_r(&global_macros, input_buffer, output_buffer, options);
 	}
 
+
+/******************************************************************/
+/******************** COMPILED MACRO TEMPLATES ********************/
+/******************************************************************/
+
+/*
+ * A macro template is a string that's been split into literal text
+ * and macro references once, so expanding it over and over again
+ * doesn't have to scan for delimiters, strdup() the input or look
+ * macro names up by string each time. The output is identical to
+ * what process_macros_r() would produce for the same input.
+ */
+#define MTOK_LITERAL     0 /* plain text, or an escaped $ */
+#define MTOK_ARGV        1 /* $ARGn$ */
+#define MTOK_USER        2 /* $USERn$ */
+#define MTOK_HOSTADDRESS 3 /* $HOSTADDRESS$ */
+#define MTOK_MACROX      4 /* standard macro without arguments */
+#define MTOK_GENERIC     5 /* anything else, resolved by name */
+
+struct macro_token {
+	int type;
+	int code;          /* argv/user index or macro code */
+	int clean_options; /* for MTOK_MACROX */
+	int last;          /* unterminated macro at the very end */
+	size_t len;        /* strlen(str) */
+	char *str;         /* literal text or macro name */
+	};
+
+struct macro_template {
+	unsigned int num_tokens;
+	size_t size_hint;  /* size of the last expansion */
+	struct macro_token *tokens;
+	char *buf;         /* token strings point in here */
+	};
+
+struct command_template {
+	command *cmd_ptr;
+	char *cmd;
+	unsigned int num_args;
+	macro_template *command_line;
+	macro_template **args;
+	};
+
+struct macro_output {
+	char *buf;
+	size_t len, size;
+	};
+
+static int macro_output_add(struct macro_output *out, const char *str, size_t len) {
+	if(out->len + len >= out->size) {
+		size_t size = out->size ? out->size : 64;
+		char *buf;
+
+		while(out->len + len >= size)
+			size *= 2;
+		if((buf = realloc(out->buf, size)) == NULL)
+			return ERROR;
+		out->buf = buf;
+		out->size = size;
+		}
+
+	memcpy(out->buf + out->len, str, len);
+	out->len += len;
+	out->buf[out->len] = 0;
+
+	return OK;
+	}
+
+macro_template *compile_macro_template(const char *input) {
+	macro_template *tpl;
+	struct macro_token *tok;
+	const struct macro_key_code *mkey;
+	char *ptr, *part, *delim;
+	unsigned int max_tokens = 1;
+	int in_macro = FALSE, x;
+
+	if(input == NULL)
+		return NULL;
+
+	if((tpl = calloc(1, sizeof(*tpl))) == NULL)
+		return NULL;
+
+	for(ptr = (char *)input; (ptr = strchr(ptr, '$')); ptr++)
+		max_tokens++;
+
+	tpl->buf = strdup(input);
+	tpl->tokens = calloc(max_tokens, sizeof(struct macro_token));
+	if(tpl->buf == NULL || tpl->tokens == NULL) {
+		free_macro_template(tpl);
+		return NULL;
+		}
+
+	/* split the input exactly the way process_macros_r() does */
+	for(ptr = tpl->buf; ptr; in_macro = !in_macro) {
+		part = ptr;
+		if((delim = strchr(ptr, '$')) != NULL) {
+			*delim = 0;
+			ptr = delim + 1;
+			}
+		else {
+			ptr = NULL;
+			}
+
+		tok = &tpl->tokens[tpl->num_tokens];
+		tok->str = part;
+		tok->len = strlen(part);
+
+		if(in_macro == FALSE) {
+			if(!*part)
+				continue;
+			tok->type = MTOK_LITERAL;
+			}
+
+		/* an escaped $ is done by specifying two $$ next to each other */
+		else if(!*part) {
+			tok->type = MTOK_LITERAL;
+			tok->str = "$";
+			tok->len = 1;
+			}
+
+		else if(strstr(part, "ARG") == part) {
+			x = atoi(part + 3);
+			tok->type = (x <= 0 || x > MAX_COMMAND_ARGUMENTS) ? MTOK_GENERIC : MTOK_ARGV;
+			tok->code = x - 1;
+			}
+
+		else if(strstr(part, "USER") == part) {
+			x = atoi(part + 4);
+			tok->type = (x <= 0 || x > MAX_USER_MACROS) ? MTOK_GENERIC : MTOK_USER;
+			tok->code = x - 1;
+			}
+
+		else if(!strcmp(part, "HOSTADDRESS")) {
+			tok->type = MTOK_HOSTADDRESS;
+			}
+
+		else if(!strchr(part, ':') && (mkey = find_macro_key(part))) {
+			tok->type = MTOK_MACROX;
+			tok->code = mkey->code;
+			tok->clean_options = mkey->options;
+			}
+
+		else {
+			tok->type = MTOK_GENERIC;
+			}
+
+		tok->last = (ptr == NULL);
+		tpl->num_tokens++;
+		}
+
+	return tpl;
+	}
+
+void free_macro_template(macro_template *tpl) {
+	if(tpl == NULL)
+		return;
+
+	my_free(tpl->tokens);
+	my_free(tpl->buf);
+	my_free(tpl);
+	}
+
+int expand_macro_template_r(nagios_macros *mac, macro_template *tpl, char **output_buffer, int options) {
+	struct macro_output out = { NULL, 0, 0 };
+	struct macro_token *tok;
+	char *selected_macro, *original_macro, *cleaned_macro;
+	int free_macro, macro_options, result;
+	unsigned int i;
+
+	if(output_buffer == NULL)
+		return ERROR;
+
+	*output_buffer = NULL;
+
+	if(tpl == NULL) {
+		*output_buffer = strdup("");
+		return ERROR;
+		}
+
+	/* most templates expand to roughly the same size every time */
+	out.size = tpl->size_hint ? tpl->size_hint : 64;
+	if((out.buf = malloc(out.size)) == NULL)
+		return ERROR;
+	*out.buf = 0;
+
+	for(i = 0; i < tpl->num_tokens; i++) {
+		tok = &tpl->tokens[i];
+
+		if(tok->type == MTOK_LITERAL) {
+			macro_output_add(&out, tok->str, tok->len);
+			continue;
+			}
+
+		selected_macro = NULL;
+		free_macro = FALSE;
+		macro_options = 0;
+		result = OK;
+
+		switch(tok->type) {
+			case MTOK_ARGV:
+				selected_macro = mac->argv[tok->code];
+				break;
+			case MTOK_USER:
+				selected_macro = macro_user[tok->code];
+				break;
+			case MTOK_MACROX:
+				result = grab_macrox_value_r(mac, tok->code, NULL, NULL, &selected_macro, &free_macro);
+				macro_options = tok->clean_options;
+				break;
+			case MTOK_HOSTADDRESS:
+				if(mac->host_ptr) {
+					selected_macro = mac->host_ptr->address;
+					break;
+					}
+				/* fallthrough */
+			default:
+				result = grab_macro_value_r(mac, tok->str, &selected_macro, &macro_options, &free_macro);
+				break;
+			}
+
+		/* an error occurred - we couldn't parse the macro, so continue on */
+		if(result != OK) {
+			if(free_macro == TRUE)
+				my_free(selected_macro);
+
+			/* a non-macro, just some user-defined string between two $s */
+			macro_output_add(&out, "$", 1);
+			macro_output_add(&out, tok->str, tok->len);
+			if(!tok->last)
+				macro_output_add(&out, "$", 1);
+			}
+
+		if(selected_macro == NULL)
+			continue;
+
+		/* URL encode the macro if requested - this allocates new memory */
+		if(options & URL_ENCODE_MACRO_CHARS) {
+			original_macro = selected_macro;
+			selected_macro = get_url_encoded_string(selected_macro);
+			if(free_macro == TRUE)
+				my_free(original_macro);
+			free_macro = TRUE;
+			}
+
+		/* some macros should sometimes be cleaned */
+		if(macro_options & options & (STRIP_ILLEGAL_MACRO_CHARS | ESCAPE_MACRO_CHARS)) {
+			if(selected_macro != NULL && (cleaned_macro = clean_macro_chars(selected_macro, options)) != NULL) {
+				macro_output_add(&out, cleaned_macro, strlen(cleaned_macro));
+				if(*cleaned_macro)
+					my_free(cleaned_macro);
+				}
+			}
+		else if(selected_macro != NULL) {
+			macro_output_add(&out, selected_macro, strlen(selected_macro));
+			}
+
+		if(free_macro == TRUE)
+			my_free(selected_macro);
+		}
+
+	if(out.len + 1 > tpl->size_hint)
+		tpl->size_hint = out.len + 1;
+
+	*output_buffer = out.buf;
+
+	log_debug_info(DEBUGL_MACROS, 1, "  Expanded template: '%s'\n", *output_buffer);
+
+	return OK;
+	}
+
+/*
+ * Compile a command line along with the arguments from a
+ * "command!arg1!arg2" string. The arguments are split exactly
+ * the way get_raw_command_line_r() splits them.
+ */
+command_template *compile_command_template(command *cmd_ptr, char *cmd) {
+	command_template *tpl;
+	char temp_arg[MAX_COMMAND_BUFFER] = "";
+	int x, y, arg_index = 0;
+
+	if(cmd_ptr == NULL)
+		return NULL;
+
+	if((tpl = calloc(1, sizeof(*tpl))) == NULL)
+		return NULL;
+
+	tpl->cmd_ptr = cmd_ptr;
+	tpl->cmd = cmd;
+	tpl->command_line = compile_macro_template(cmd_ptr->command_line ? cmd_ptr->command_line : "");
+	tpl->args = calloc(MAX_COMMAND_ARGUMENTS, sizeof(macro_template *));
+	if(tpl->command_line == NULL || tpl->args == NULL) {
+		free_command_template(tpl);
+		return NULL;
+		}
+
+	if(cmd == NULL)
+		return tpl;
+
+	/* skip the command name */
+	for(arg_index = 0;; arg_index++) {
+		if(cmd[arg_index] == '!' || cmd[arg_index] == '\x0')
+			break;
+		}
+
+	for(x = 0; x < MAX_COMMAND_ARGUMENTS; x++) {
+
+		/* we reached the end of the arguments... */
+		if(cmd[arg_index] == '\x0')
+			break;
+
+		for(arg_index++, y = 0; y < (int)sizeof(temp_arg) - 1; arg_index++) {
+
+			/* handle escaped argument delimiters */
+			if(cmd[arg_index] == '\\' && cmd[arg_index + 1] == '!') {
+				arg_index++;
+				}
+			else if(cmd[arg_index] == '!' || cmd[arg_index] == '\x0') {
+				break;
+				}
+
+			temp_arg[y] = cmd[arg_index];
+			y++;
+			}
+		temp_arg[y] = '\x0';
+
+		if((tpl->args[x] = compile_macro_template(temp_arg)) == NULL) {
+			free_command_template(tpl);
+			return NULL;
+			}
+		tpl->num_args++;
+		}
+
+	return tpl;
+	}
+
+void free_command_template(command_template *tpl) {
+	unsigned int i;
+
+	if(tpl == NULL)
+		return;
+
+	if(tpl->args) {
+		for(i = 0; i < tpl->num_args; i++)
+			free_macro_template(tpl->args[i]);
+		my_free(tpl->args);
+		}
+	free_macro_template(tpl->command_line);
+	my_free(tpl);
+	}
+
+int command_template_matches(command_template *tpl, command *cmd_ptr, char *cmd) {
+	return tpl != NULL && tpl->cmd_ptr == cmd_ptr && tpl->cmd == cmd;
+	}
+
+/*
+ * The compiled equivalent of get_raw_command_line_r() followed
+ * by process_macros_r() on its result
+ */
+int expand_command_template_r(nagios_macros *mac, command_template *tpl, char **output_buffer, int options) {
+	unsigned int i;
+
+	clear_argv_macros_r(mac);
+
+	if(tpl == NULL || output_buffer == NULL)
+		return ERROR;
+
+	/* later arguments may refer to earlier ones */
+	for(i = 0; i < tpl->num_args; i++)
+		expand_macro_template_r(mac, tpl->args[i], &mac->argv[i], options);
+
+	log_debug_info(DEBUGL_COMMANDS | DEBUGL_CHECKS | DEBUGL_MACROS, 2, "Raw Command Input: %s\n", tpl->cmd_ptr->command_line);
+
+	return expand_macro_template_r(mac, tpl->command_line, output_buffer, options);
+	}
+
 /******************************************************************/
 /********************** MACRO GRAB FUNCTIONS **********************/
 /******************************************************************/
@@ -1304,6 +1679,15 @@ int grab_macrox_value(int macro_type, char *arg1, char *arg2, char **output, int
 	}
 
 
+/* the value of a custom variable found through the object's index */
+static int grab_custom_variable_value(customvariablesmember *var, char **output) {
+	if(var == NULL)
+		return ERROR;
+	if(var->variable_value)
+		*output = var->variable_value;
+	return OK;
+	}
+
 /* calculates the value of a custom macro */
 int grab_custom_macro_value_r(nagios_macros *mac, char *macro_name, char *arg1, char *arg2, char **output) {
 	host *temp_host = NULL;
@@ -1339,7 +1723,7 @@ int grab_custom_macro_value_r(nagios_macros *mac, char *macro_name, char *arg1,
 				return ERROR;
 
 			/* get the host macro value */
-			result = grab_custom_object_macro_r(mac, macro_name + 5, temp_host->custom_variables, output);
+			result = grab_custom_variable_value(find_host_custom_variable(temp_host, macro_name + 5), output);
 			}
 
 		/* a host macro with a hostgroup name and delimiter */
@@ -1385,7 +1769,7 @@ int grab_custom_macro_value_r(nagios_macros *mac, char *macro_name, char *arg1,
 				return ERROR;
 
 			/* get the service macro value */
-			result = grab_custom_object_macro_r(mac, macro_name + 8, temp_service->custom_variables, output);
+			result = grab_custom_variable_value(find_service_custom_variable(temp_service, macro_name + 8), output);
 			}
 
 		/* else and ondemand macro... */
@@ -1397,7 +1781,7 @@ int grab_custom_macro_value_r(nagios_macros *mac, char *macro_name, char *arg1,
 			if((temp_service = find_service((mac->host_ptr) ? mac->host_ptr->name : NULL, arg2))) {
 
 				/* get the service macro value */
-				result = grab_custom_object_macro_r(mac, macro_name + 8, temp_service->custom_variables, output);
+				result = grab_custom_variable_value(find_service_custom_variable(temp_service, macro_name + 8), output);
 				}
 
 			/* else we have a service macro with a servicegroup name and a delimiter... */
@@ -1452,7 +1836,7 @@ int grab_custom_macro_value_r(nagios_macros *mac, char *macro_name, char *arg1,
 				return ERROR;
 
 			/* get the contact macro value */
-			result = grab_custom_object_macro_r(mac, macro_name + 8, temp_contact->custom_variables, output);
+			result = grab_custom_variable_value(find_contact_custom_variable(temp_contact, macro_name + 8), output);
 			}
 
 		/* a contact macro with a contactgroup name and delimiter */
@@ -3113,6 +3497,122 @@ int clear_summary_macros(void) {
 
 #ifdef NSCORE
 
+/*
+ * The environment_macros whitelist. When it's set, only the macros
+ * it lists are exported to the environment of the commands we run.
+ */
+static struct {
+	int active;
+	unsigned int num_codes;
+	int codes[MACRO_X_COUNT];
+	unsigned int num_names;
+	char **names; /* sorted, for the ones that aren't standard macros */
+	} env_filter;
+
+static int env_name_cmp(const void *a, const void *b) {
+	return strcmp(*(char * const *)a, *(char * const *)b);
+	}
+
+/* is the macro (without MACRO_ENV_VAR_PREFIX) to be exported? */
+static int env_macro_wanted(const char *name) {
+	if(env_filter.active == FALSE)
+		return TRUE;
+	return bsearch(&name, env_filter.names, env_filter.num_names, sizeof(char *), env_name_cmp) != NULL;
+	}
+
+/* ARGn, CONTACTADDRESSn and custom variables aren't standard macros */
+static int is_env_macro_name(const char *name) {
+	int x;
+
+	if(*name == '_' && name[1])
+		return TRUE;
+	if(strstr(name, "ARG") == name) {
+		x = atoi(name + 3);
+		return x > 0 && x <= MAX_COMMAND_ARGUMENTS;
+		}
+	if(strstr(name, "CONTACTADDRESS") == name) {
+		x = atoi(name + 14);
+		return x >= 0 && x < MAX_CONTACT_ADDRESSES && name[14];
+		}
+	return find_macro_key(name) != NULL;
+	}
+
+/*
+ * Static macros that are the same for every command for as long as
+ * we're running, so they can be put in a worker's own environment
+ * once rather than sent along with every job. $EVENTSTARTTIME$ isn't
+ * known until after the workers are up, so it's not one of them.
+ */
+static int is_constant_env_macro(int code) {
+	switch(code) {
+		case MACRO_ADMINEMAIL:
+		case MACRO_ADMINPAGER:
+		case MACRO_MAINCONFIGFILE:
+		case MACRO_STATUSDATAFILE:
+		case MACRO_RETENTIONDATAFILE:
+		case MACRO_OBJECTCACHEFILE:
+		case MACRO_TEMPFILE:
+		case MACRO_LOGFILE:
+		case MACRO_RESOURCEFILE:
+		case MACRO_COMMANDFILE:
+		case MACRO_HOSTPERFDATAFILE:
+		case MACRO_SERVICEPERFDATAFILE:
+		case MACRO_PROCESSSTARTTIME:
+		case MACRO_TEMPPATH:
+			return TRUE;
+		}
+	return FALSE;
+	}
+
+/* sets the environment_macros whitelist. NULL or "" exports everything */
+int set_environment_macro_filter(const char *list) {
+	const struct macro_key_code *mkey;
+	char *buf, *name, *next;
+	char seen[MACRO_X_COUNT];
+	unsigned int i;
+	int result = OK;
+
+	for(i = 0; i < env_filter.num_names; i++)
+		my_free(env_filter.names[i]);
+	my_free(env_filter.names);
+	memset(&env_filter, 0, sizeof(env_filter));
+
+	if(list == NULL || *list == '\x0')
+		return OK;
+
+	if((buf = strdup(list)) == NULL)
+		return ERROR;
+
+	memset(seen, 0, sizeof(seen));
+	for(name = buf; name; name = next) {
+		if((next = strchr(name, ',')) != NULL)
+			*next++ = '\x0';
+		strip(name);
+		if(*name == '\x0')
+			continue;
+
+		if(is_env_macro_name(name) == FALSE) {
+			logit(NSLOG_CONFIG_ERROR, TRUE, "Error: '%s' in environment_macros is not a macro we can export\n", name);
+			result = ERROR;
+			continue;
+			}
+
+		if((mkey = find_macro_key(name)) && !seen[mkey->code]) {
+			seen[mkey->code] = 1;
+			env_filter.codes[env_filter.num_codes++] = mkey->code;
+			}
+
+		env_filter.names = realloc(env_filter.names, (env_filter.num_names + 1) * sizeof(char *));
+		env_filter.names[env_filter.num_names++] = strdup(name);
+		}
+	my_free(buf);
+
+	qsort(env_filter.names, env_filter.num_names, sizeof(char *), env_name_cmp);
+	env_filter.active = TRUE;
+
+	return result;
+	}
+
 /* sets or unsets all macro environment variables */
 int set_all_macro_environment_vars_r(nagios_macros *mac, int set) {
 	if(enable_environment_macros == FALSE)
@@ -3282,6 +3782,10 @@ int set_macro_environment_var(char *name, char *value, int set) {
 	if(name == NULL)
 		return ERROR;
 
+	/* nor set those we weren't asked to export */
+	if(set == TRUE && env_macro_wanted(name) == FALSE)
+		return OK;
+
 	/* create environment var name */
 	asprintf(&env_macro_name, "%s%s", MACRO_ENV_VAR_PREFIX, name);
 
@@ -3294,17 +3798,22 @@ int set_macro_environment_var(char *name, char *value, int set) {
 	return OK;
 	}
 
-static int add_macrox_environment_vars_r(nagios_macros *, struct kvvec *);
+static int add_macrox_environment_vars_r(nagios_macros *, struct kvvec *, int);
 static int add_argv_macro_environment_vars_r(nagios_macros *, struct kvvec *);
 static int add_custom_macro_environment_vars_r(nagios_macros *, struct kvvec *);
 static int add_contact_address_environment_vars_r(nagios_macros *,
 		struct kvvec *);
 
 struct kvvec * macros_to_kvv(nagios_macros *mac) {
+	return env_macros_to_kvv(mac, ENV_MACROS_ALL);
+	}
+
+/* the constant or the volatile macros, or both, as a kvvec */
+struct kvvec * env_macros_to_kvv(nagios_macros *mac, int which) {
 
 	struct kvvec *kvvp;
 
-	log_debug_info(DEBUGL_FUNCTIONS, 0, "macros_to_kvv()\n");
+	log_debug_info(DEBUGL_FUNCTIONS, 0, "env_macros_to_kvv()\n");
 
 	/* If we're not supposed to export macros as environment variables,
 		just return */
@@ -3312,27 +3821,36 @@ struct kvvec * macros_to_kvv(nagios_macros *mac) {
 
 	/* Create the kvvec to hold the macros */
 	if((kvvp = calloc(1, sizeof(struct kvvec))) == NULL) return NULL;
-	if(!kvvec_init(kvvp, MACRO_X_COUNT + MAX_COMMAND_ARGUMENTS + MAX_CONTACT_ADDRESSES + 4)) return NULL;
+	if(!kvvec_init(kvvp, env_filter.active ? env_filter.num_names + 1 : MACRO_X_COUNT + MAX_COMMAND_ARGUMENTS + MAX_CONTACT_ADDRESSES + 4)) return NULL;
 
-	add_macrox_environment_vars_r(mac, kvvp);
-	add_argv_macro_environment_vars_r(mac, kvvp);
-	add_custom_macro_environment_vars_r(mac, kvvp);
-	add_contact_address_environment_vars_r(mac, kvvp);
+	add_macrox_environment_vars_r(mac, kvvp, which);
+	if(which & ENV_MACROS_VOLATILE) {
+		add_argv_macro_environment_vars_r(mac, kvvp);
+		add_custom_macro_environment_vars_r(mac, kvvp);
+		add_contact_address_environment_vars_r(mac, kvvp);
+		}
 
 	return kvvp;
 	}
 
 /* adds macrox environment variables */
-static int add_macrox_environment_vars_r(nagios_macros *mac, struct kvvec *kvvp)
+static int add_macrox_environment_vars_r(nagios_macros *mac, struct kvvec *kvvp, int which)
 {
 	/*register*/ int x = 0;
+	unsigned int i, count;
 	int free_macro = FALSE;
 	char *envname;
 
 	log_debug_info(DEBUGL_FUNCTIONS, 1, "add_macrox_environment_vars_r()\n");
 
-	/* set each of the macrox environment variables */
-	for(x = 0; x < MACRO_X_COUNT; x++) {
+	/* set each of the macrox environment variables, or just the wanted ones */
+	count = env_filter.active ? env_filter.num_codes : MACRO_X_COUNT;
+	for(i = 0; i < count; i++) {
+
+		x = env_filter.active ? env_filter.codes[i] : (int)i;
+
+		if(!(which & (is_constant_env_macro(x) ? ENV_MACROS_CONSTANT : ENV_MACROS_VOLATILE)))
+			continue;
 
 		log_debug_info(DEBUGL_MACROS, 2, "Processing macro %d of %d\n", x,
 				MACRO_X_COUNT);
@@ -3390,6 +3908,10 @@ static int add_argv_macro_environment_vars_r(nagios_macros *mac,
 			values because when kvvec_destroy() is called, it is called with
 			KVVEC_FREE_KEYS */
 		asprintf(&macro_name, "%sARG%d", MACRO_ENV_VAR_PREFIX, x + 1);
+		if(env_macro_wanted(macro_name + sizeof(MACRO_ENV_VAR_PREFIX) - 1) == FALSE) {
+			my_free(macro_name);
+			continue;
+			}
 		kvvec_addkv(kvvp, macro_name, mac->argv[x]);
 		}
 
@@ -3427,6 +3949,8 @@ static int add_custom_macro_environment_vars_r(nagios_macros *mac,
 	for(temp_customvariablesmember = mac->custom_host_vars;
 			temp_customvariablesmember != NULL;
 			temp_customvariablesmember = temp_customvariablesmember->next) {
+		if(env_macro_wanted(temp_customvariablesmember->variable_name + sizeof(MACRO_ENV_VAR_PREFIX) - 1) == FALSE)
+			continue;
 		customvarvalue = 
 				clean_macro_chars(temp_customvariablesmember->variable_value,
 				STRIP_ILLEGAL_MACRO_CHARS | ESCAPE_MACRO_CHARS);
@@ -3459,6 +3983,8 @@ static int add_custom_macro_environment_vars_r(nagios_macros *mac,
 	for(temp_customvariablesmember = mac->custom_service_vars;
 			temp_customvariablesmember != NULL;
 			temp_customvariablesmember = temp_customvariablesmember->next) {
+		if(env_macro_wanted(temp_customvariablesmember->variable_name + sizeof(MACRO_ENV_VAR_PREFIX) - 1) == FALSE)
+			continue;
 		customvarvalue =
 				clean_macro_chars(temp_customvariablesmember->variable_value,
 				STRIP_ILLEGAL_MACRO_CHARS | ESCAPE_MACRO_CHARS);
@@ -3491,6 +4017,8 @@ static int add_custom_macro_environment_vars_r(nagios_macros *mac,
 	for(temp_customvariablesmember = mac->custom_contact_vars;
 			temp_customvariablesmember != NULL;
 			temp_customvariablesmember = temp_customvariablesmember->next) {
+		if(env_macro_wanted(temp_customvariablesmember->variable_name + sizeof(MACRO_ENV_VAR_PREFIX) - 1) == FALSE)
+			continue;
 		customvarvalue = 
 				clean_macro_chars(temp_customvariablesmember->variable_value,
 				STRIP_ILLEGAL_MACRO_CHARS | ESCAPE_MACRO_CHARS);
@@ -3521,20 +4049,32 @@ static int add_contact_address_environment_vars_r(nagios_macros *mac,
 	if(mac->contact_ptr == NULL)
 		return OK;
 
-	asprintf(&varname, "%sCONTACTNAME", MACRO_ENV_VAR_PREFIX);
-	kvvec_addkv(kvvp, varname, mac->contact_ptr->name);
-    asprintf(&varname, "%sCONTACTALIAS", MACRO_ENV_VAR_PREFIX);
-    kvvec_addkv(kvvp, varname, mac->contact_ptr->alias);
-    asprintf(&varname, "%sCONTACTEMAIL", MACRO_ENV_VAR_PREFIX);
-    kvvec_addkv(kvvp, varname, mac->contact_ptr->email);
-    asprintf(&varname, "%sCONTACTPAGER", MACRO_ENV_VAR_PREFIX);
-    kvvec_addkv(kvvp, varname, mac->contact_ptr->pager);
+	if(env_macro_wanted("CONTACTNAME")) {
+		asprintf(&varname, "%sCONTACTNAME", MACRO_ENV_VAR_PREFIX);
+		kvvec_addkv(kvvp, varname, mac->contact_ptr->name);
+		}
+	if(env_macro_wanted("CONTACTALIAS")) {
+		asprintf(&varname, "%sCONTACTALIAS", MACRO_ENV_VAR_PREFIX);
+		kvvec_addkv(kvvp, varname, mac->contact_ptr->alias);
+		}
+	if(env_macro_wanted("CONTACTEMAIL")) {
+		asprintf(&varname, "%sCONTACTEMAIL", MACRO_ENV_VAR_PREFIX);
+		kvvec_addkv(kvvp, varname, mac->contact_ptr->email);
+		}
+	if(env_macro_wanted("CONTACTPAGER")) {
+		asprintf(&varname, "%sCONTACTPAGER", MACRO_ENV_VAR_PREFIX);
+		kvvec_addkv(kvvp, varname, mac->contact_ptr->pager);
+		}
 
 	for(x = 0; x < MAX_CONTACT_ADDRESSES; x++) {
 		/* Allocate memory for each environment variable name, but not the 
 			values because when kvvec_destroy() is called, it is called with
 			KVVEC_FREE_KEYS */
 		asprintf(&varname, "%sCONTACTADDRESS%d", MACRO_ENV_VAR_PREFIX, x);
+		if(env_macro_wanted(varname + sizeof(MACRO_ENV_VAR_PREFIX) - 1) == FALSE) {
+			my_free(varname);
+			continue;
+			}
 		kvvec_addkv(kvvp, varname, mac->contact_ptr->address[x]);
 		}
 
@@ -62,6 +62,14 @@ hostescalation **hostescalation_ary = NULL;
 serviceescalation **serviceescalation_ary = NULL;
 hostdependency **hostdependency_ary = NULL;
 servicedependency **servicedependency_ary = NULL;
+#ifdef NSCORE
+struct contact_fanout *host_contact_fanout = NULL;
+struct contact_fanout *service_contact_fanout = NULL;
+struct contact_fanout *hostescalation_contact_fanout = NULL;
+struct contact_fanout *serviceescalation_contact_fanout = NULL;
+struct object_state_array host_state_ary;
+struct object_state_array service_state_ary;
+#endif
 
 #ifndef NSCGI
 int __nagios_object_structure_version = CURRENT_OBJECT_STRUCTURE_VERSION;
@@ -353,6 +361,19 @@ static int create_object_table(const char *name, unsigned int elems, unsigned in
 #define mktable(name, id) \
 	create_object_table(#name, ocount[id], sizeof(name *), (void **)&name##_ary)
 
+#ifdef NSCORE
+/* every object starts out dirty, as nothing has been written yet */
+static int create_object_state_array(const char *name, unsigned int elems, struct object_state_array *ary)
+{
+	if (create_object_table(name, elems, sizeof(unsigned char), (void **)&ary->flags) != OK)
+		return ERROR;
+	if (ary->flags)
+		memset(ary->flags, OBJSTATE_STATUS_DIRTY, elems);
+	ary->size = elems;
+	return OK;
+}
+#endif
+
 /* ocount is an array with NUM_OBJECT_TYPES members */
 int create_object_tables(unsigned int *ocount)
 {
@@ -396,6 +417,12 @@ int create_object_tables(unsigned int *ocount)
 		return ERROR;
 	if (mktable(servicedependency, SERVICEDEPENDENCY_SKIPLIST) != OK)
 		return ERROR;
+#ifdef NSCORE
+	if (create_object_state_array("host state", ocount[HOST_SKIPLIST], &host_state_ary) != OK)
+		return ERROR;
+	if (create_object_state_array("service state", ocount[SERVICE_SKIPLIST], &service_state_ary) != OK)
+		return ERROR;
+#endif
 
 	return OK;
 }
@@ -2719,6 +2746,12 @@ int free_object_data(void) {
 		my_free(this_host);
 		}
 
+#ifdef NSCORE
+	free_contact_fanout();
+	free_custom_variable_index();
+	free_object_state_arrays();
+#endif
+
 	/* reset pointers */
 	my_free(host_ary);
 
@@ -3565,3 +3598,459 @@ int fcache_objects(char *cache_file) {
 	return OK;
 	}
 #endif
+
+
+/******************************************************************/
+/************************* SHARED POOLS ***************************/
+/******************************************************************/
+
+/* a class of objects for fill_shared_pool() */
+struct pool_objects {
+	int type;
+	void **objs;
+	unsigned int count;
+	};
+
+/*
+ * gives every object in objs its share of one block of memory, stored
+ * in *pool. fill() is called for each object twice; first with dst
+ * NULL to count how many elements of size bytes it needs, and then
+ * with dst pointing at its share to fill it in. It returns the number
+ * of elements it uses either way, or ERROR.
+ */
+static int fill_shared_pool(void **pool, size_t size, const struct pool_objects *objs, unsigned int nobjs, int (*fill)(int type, void *obj, void *dst)) {
+	unsigned int pass, i, j;
+	size_t used = 0;
+	int count;
+
+	for(pass = 0; pass < 2; pass++) {
+		if(pass == 1) {
+			if(used == 0)
+				return OK;
+			if((*pool = calloc(used, size)) == NULL)
+				return ERROR;
+			}
+		used = 0;
+
+		for(i = 0; i < nobjs; i++) {
+			for(j = 0; j < objs[i].count; j++) {
+				if((count = fill(objs[i].type, objs[i].objs[j], pass ? (char *)*pool + used * size : NULL)) < 0)
+					return ERROR;
+				used += count;
+				}
+			}
+		}
+
+	return OK;
+	}
+
+
+
+#ifdef NSCORE
+/******************************************************************/
+/************************ CONTACT FANOUT **************************/
+/******************************************************************/
+
+static contact **fanout_pool = NULL;
+static unsigned int *contact_marks = NULL;
+static unsigned int contact_mark_epoch = 0;
+
+
+/* starts a new round of mark_contact() calls */
+void new_contact_marks(void) {
+	if(contact_marks == NULL) {
+		if(!num_objects.contacts || (contact_marks = calloc(num_objects.contacts, sizeof(unsigned int))) == NULL)
+			return;
+		contact_mark_epoch = 0;
+		}
+
+	if(++contact_mark_epoch == 0) {
+		memset(contact_marks, 0, num_objects.contacts * sizeof(unsigned int));
+		contact_mark_epoch = 1;
+		}
+	}
+
+
+/*
+ * marks a contact as seen in the current round. Returns TRUE if it
+ * hadn't been seen yet, FALSE if it had and ERROR if we have no marks
+ * to keep track with, in which case the caller has to find out itself.
+ */
+int mark_contact(contact *cntct) {
+	if(contact_marks == NULL || !contact_mark_epoch || cntct->id >= num_objects.contacts)
+		return ERROR;
+
+	if(contact_marks[cntct->id] == contact_mark_epoch)
+		return FALSE;
+	contact_marks[cntct->id] = contact_mark_epoch;
+
+	return TRUE;
+	}
+
+
+/*
+ * adds the contacts and contactgroup members not yet seen in this round
+ * to dst, or just counts them if dst is NULL
+ */
+static unsigned int fill_contact_fanout(contact **dst, contactsmember *contacts, contactgroupsmember *groups) {
+	contactsmember *temp_contactsmember = NULL;
+	contactgroupsmember *temp_contactgroupsmember = NULL;
+	unsigned int count = 0;
+
+	new_contact_marks();
+
+	for(temp_contactsmember = contacts; temp_contactsmember != NULL; temp_contactsmember = temp_contactsmember->next) {
+		if(temp_contactsmember->contact_ptr == NULL || mark_contact(temp_contactsmember->contact_ptr) != TRUE)
+			continue;
+		if(dst != NULL)
+			dst[count] = temp_contactsmember->contact_ptr;
+		count++;
+		}
+
+	for(temp_contactgroupsmember = groups; temp_contactgroupsmember != NULL; temp_contactgroupsmember = temp_contactgroupsmember->next) {
+		if(temp_contactgroupsmember->group_ptr == NULL)
+			continue;
+		for(temp_contactsmember = temp_contactgroupsmember->group_ptr->members; temp_contactsmember != NULL; temp_contactsmember = temp_contactsmember->next) {
+			if(temp_contactsmember->contact_ptr == NULL || mark_contact(temp_contactsmember->contact_ptr) != TRUE)
+				continue;
+			if(dst != NULL)
+				dst[count] = temp_contactsmember->contact_ptr;
+			count++;
+			}
+		}
+
+	return count;
+	}
+
+
+/* fills in the fanout of a host, service or escalation for fill_shared_pool() */
+static int fill_object_fanout(int type, void *obj, void *dst) {
+	struct contact_fanout *fo;
+	contactsmember *contacts;
+	contactgroupsmember *groups;
+
+	switch(type) {
+		case HOST_SKIPLIST:
+			fo = &host_contact_fanout[((host *)obj)->id];
+			contacts = ((host *)obj)->contacts;
+			groups = ((host *)obj)->contact_groups;
+			break;
+		case SERVICE_SKIPLIST:
+			fo = &service_contact_fanout[((service *)obj)->id];
+			contacts = ((service *)obj)->contacts;
+			groups = ((service *)obj)->contact_groups;
+			break;
+		case HOSTESCALATION_SKIPLIST:
+			fo = &hostescalation_contact_fanout[((hostescalation *)obj)->id];
+			contacts = ((hostescalation *)obj)->contacts;
+			groups = ((hostescalation *)obj)->contact_groups;
+			break;
+		case SERVICEESCALATION_SKIPLIST:
+			fo = &serviceescalation_contact_fanout[((serviceescalation *)obj)->id];
+			contacts = ((serviceescalation *)obj)->contacts;
+			groups = ((serviceescalation *)obj)->contact_groups;
+			break;
+		default:
+			return ERROR;
+		}
+
+	fo->contacts = dst;
+	fo->count = fill_contact_fanout(dst, contacts, groups);
+
+	return (int)fo->count;
+	}
+
+
+/*
+ * builds the contact fanout lists for all hosts, services and
+ * escalations. All the lists share one block of memory.
+ */
+int init_contact_fanout(void) {
+	struct pool_objects objs[] = {
+		{ HOST_SKIPLIST, (void **)host_ary, num_objects.hosts },
+		{ SERVICE_SKIPLIST, (void **)service_ary, num_objects.services },
+		{ HOSTESCALATION_SKIPLIST, (void **)hostescalation_ary, num_objects.hostescalations },
+		{ SERVICEESCALATION_SKIPLIST, (void **)serviceescalation_ary, num_objects.serviceescalations },
+		};
+
+	free_contact_fanout();
+
+	if((host_contact_fanout = calloc(num_objects.hosts + 1, sizeof(struct contact_fanout))) == NULL ||
+	   (service_contact_fanout = calloc(num_objects.services + 1, sizeof(struct contact_fanout))) == NULL ||
+	   (hostescalation_contact_fanout = calloc(num_objects.hostescalations + 1, sizeof(struct contact_fanout))) == NULL ||
+	   (serviceescalation_contact_fanout = calloc(num_objects.serviceescalations + 1, sizeof(struct contact_fanout))) == NULL) {
+		free_contact_fanout();
+		return ERROR;
+		}
+
+	new_contact_marks();
+	if(num_objects.contacts && contact_marks == NULL) {
+		free_contact_fanout();
+		return ERROR;
+		}
+
+	if(fill_shared_pool((void **)&fanout_pool, sizeof(contact *), objs, sizeof(objs) / sizeof(objs[0]), fill_object_fanout) == ERROR) {
+		free_contact_fanout();
+		return ERROR;
+		}
+
+	return OK;
+	}
+
+
+void free_contact_fanout(void) {
+	my_free(host_contact_fanout);
+	my_free(service_contact_fanout);
+	my_free(hostescalation_contact_fanout);
+	my_free(serviceescalation_contact_fanout);
+	my_free(fanout_pool);
+	my_free(contact_marks);
+	contact_mark_epoch = 0;
+	}
+
+
+
+/******************************************************************/
+/********************* OBJECT STATE ARRAYS ************************/
+/******************************************************************/
+
+/* flags a host's entry in the host state array */
+void set_host_state_flags(host *hst, unsigned char flags) {
+
+	if(hst->id < host_state_ary.size)
+		host_state_ary.flags[hst->id] |= flags;
+	}
+
+
+/* flags a service's entry in the service state array */
+void set_service_state_flags(service *svc, unsigned char flags) {
+
+	if(svc->id < service_state_ary.size)
+		service_state_ary.flags[svc->id] |= flags;
+	}
+
+
+void free_object_state_arrays(void) {
+	my_free(host_state_ary.flags);
+	my_free(service_state_ary.flags);
+	host_state_ary.size = 0;
+	service_state_ary.size = 0;
+	}
+#endif
+
+
+
+/******************************************************************/
+/******************** CUSTOM VARIABLE INDEX ***********************/
+/******************************************************************/
+
+/*
+ * Custom variable names are interned, so finding a variable on an
+ * object takes one hash lookup for the name and then a probe or two
+ * in the object's own open-addressed table, where names are compared
+ * by pointer. The tables point to the members of the objects'
+ * custom_variables lists, so values changed in place show up as is.
+ */
+#define CV_HOST    0
+#define CV_SERVICE 1
+#define CV_CONTACT 2
+
+struct custom_var_slot {
+	const char *name;
+	customvariablesmember *var;
+	};
+
+struct custom_var_table {
+	unsigned int mask; /* table size - 1 */
+	struct custom_var_slot *slots;
+	};
+
+static dkhash_table *custom_var_names = NULL;
+static struct custom_var_table *custom_var_tables[3] = { NULL, NULL, NULL };
+static struct custom_var_slot *custom_var_pool = NULL;
+
+
+static inline unsigned int custom_var_hash(const char *name, unsigned int mask) {
+	return (unsigned int)(((uint64_t)(uintptr_t)name * 0x9e3779b97f4a7c15ULL) >> 32) & mask;
+	}
+
+
+/* the table size for an object, or 0 if it has no custom variables */
+static unsigned int custom_var_table_size(customvariablesmember *vars) {
+	unsigned int count = 0, size = 2;
+
+	for(; vars != NULL; vars = vars->next)
+		count++;
+	if(count == 0)
+		return 0;
+
+	/* keep tables at most half full */
+	while(size < count * 2)
+		size *= 2;
+	return size;
+	}
+
+
+static const char *intern_custom_var_name(const char *name) {
+	char *interned;
+
+	if((interned = dkhash_get(custom_var_names, name, NULL)) != NULL)
+		return interned;
+	if((interned = strdup(name)) == NULL)
+		return NULL;
+	if(dkhash_insert(custom_var_names, interned, NULL, interned) != DKHASH_OK) {
+		free(interned);
+		return NULL;
+		}
+	return interned;
+	}
+
+
+static int fill_custom_var_table(struct custom_var_table *tbl, customvariablesmember *vars) {
+	unsigned int i;
+	const char *name;
+
+	for(; vars != NULL; vars = vars->next) {
+		if(vars->variable_name == NULL)
+			continue;
+		if((name = intern_custom_var_name(vars->variable_name)) == NULL)
+			return ERROR;
+
+		/* the list is newest first, and the first one wins */
+		for(i = custom_var_hash(name, tbl->mask); tbl->slots[i].name; i = (i + 1) & tbl->mask) {
+			if(tbl->slots[i].name == name)
+				break;
+			}
+		if(tbl->slots[i].name == NULL) {
+			tbl->slots[i].name = name;
+			tbl->slots[i].var = vars;
+			}
+		}
+
+	return OK;
+	}
+
+
+/* sizes and fills in the custom variable table of an object for fill_shared_pool() */
+static int fill_object_custom_vars(int type, void *obj, void *dst) {
+	struct custom_var_table *tbl;
+	customvariablesmember *vars;
+	unsigned int id, size;
+
+	switch(type) {
+		case CV_HOST:
+			id = ((host *)obj)->id;
+			vars = ((host *)obj)->custom_variables;
+			break;
+		case CV_SERVICE:
+			id = ((service *)obj)->id;
+			vars = ((service *)obj)->custom_variables;
+			break;
+		case CV_CONTACT:
+			id = ((contact *)obj)->id;
+			vars = ((contact *)obj)->custom_variables;
+			break;
+		default:
+			return ERROR;
+		}
+
+	if((size = custom_var_table_size(vars)) == 0 || dst == NULL)
+		return (int)size;
+
+	tbl = &custom_var_tables[type][id];
+	tbl->mask = size - 1;
+	tbl->slots = dst;
+	if(fill_custom_var_table(tbl, vars) == ERROR)
+		return ERROR;
+
+	return (int)size;
+	}
+
+
+/* builds the custom variable tables of all hosts, services and contacts */
+int init_custom_variable_index(void) {
+	struct pool_objects objs[] = {
+		{ CV_HOST, (void **)host_ary, num_objects.hosts },
+		{ CV_SERVICE, (void **)service_ary, num_objects.services },
+		{ CV_CONTACT, (void **)contact_ary, num_objects.contacts },
+		};
+
+	free_custom_variable_index();
+
+	if((custom_var_names = dkhash_create(1024)) == NULL ||
+	   (custom_var_tables[CV_HOST] = calloc(num_objects.hosts + 1, sizeof(struct custom_var_table))) == NULL ||
+	   (custom_var_tables[CV_SERVICE] = calloc(num_objects.services + 1, sizeof(struct custom_var_table))) == NULL ||
+	   (custom_var_tables[CV_CONTACT] = calloc(num_objects.contacts + 1, sizeof(struct custom_var_table))) == NULL) {
+		free_custom_variable_index();
+		return ERROR;
+		}
+
+	/* all tables share one block of memory */
+	if(fill_shared_pool((void **)&custom_var_pool, sizeof(struct custom_var_slot), objs, sizeof(objs) / sizeof(objs[0]), fill_object_custom_vars) == ERROR) {
+		free_custom_variable_index();
+		return ERROR;
+		}
+
+	return OK;
+	}
+
+
+static int free_custom_var_name(void *name) {
+	free(name);
+	return DKHASH_WALK_REMOVE;
+	}
+
+void free_custom_variable_index(void) {
+	int i;
+
+	if(custom_var_names) {
+		dkhash_walk_data(custom_var_names, free_custom_var_name);
+		dkhash_destroy(custom_var_names);
+		custom_var_names = NULL;
+		}
+	for(i = 0; i < 3; i++)
+		my_free(custom_var_tables[i]);
+	my_free(custom_var_pool);
+	}
+
+
+static customvariablesmember *find_custom_variable(int type, unsigned int id, customvariablesmember *vars, const char *name) {
+	struct custom_var_table *tbl;
+	const char *interned;
+	unsigned int i;
+
+	if(name == NULL)
+		return NULL;
+
+	/* no index (yet), so we do it the slow way */
+	if(custom_var_tables[type] == NULL) {
+		for(; vars != NULL; vars = vars->next) {
+			if(vars->variable_name && !strcmp(name, vars->variable_name))
+				return vars;
+			}
+		return NULL;
+		}
+
+	tbl = &custom_var_tables[type][id];
+	if(tbl->slots == NULL || (interned = dkhash_get(custom_var_names, name, NULL)) == NULL)
+		return NULL;
+
+	for(i = custom_var_hash(interned, tbl->mask); tbl->slots[i].name; i = (i + 1) & tbl->mask) {
+		if(tbl->slots[i].name == interned)
+			return tbl->slots[i].var;
+		}
+
+	return NULL;
+	}
+
+customvariablesmember *find_host_custom_variable(host *hst, const char *name) {
+	return hst ? find_custom_variable(CV_HOST, hst->id, hst->custom_variables, name) : NULL;
+	}
+
+customvariablesmember *find_service_custom_variable(service *svc, const char *name) {
+	return svc ? find_custom_variable(CV_SERVICE, svc->id, svc->custom_variables, name) : NULL;
+	}
+
+customvariablesmember *find_contact_custom_variable(contact *cntct, const char *name) {
+	return cntct ? find_custom_variable(CV_CONTACT, cntct->id, cntct->custom_variables, name) : NULL;
+	}
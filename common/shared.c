@@ -20,6 +20,7 @@ struct object_count num_objects;
 
 int process_performance_data;
 char *status_file;
+char *status_binary_file;
 
 int nagios_pid = 0;
 int daemon_mode = FALSE;
@@ -56,6 +57,7 @@ void init_shared_cfg_vars(int first_time) {
 
 	process_performance_data = DEFAULT_PROCESS_PERFORMANCE_DATA;
 	status_file = NULL;
+	status_binary_file = NULL;
 
 	check_external_commands = DEFAULT_CHECK_EXTERNAL_COMMANDS;
 
@@ -33,6 +33,7 @@
 #else
 #include "../include/nagios.h"
 #include "../include/broker.h"
+#include "../include/sretention.h"
 #endif
 
 
@@ -46,6 +47,8 @@ hoststatus      **hoststatus_hashlist = NULL;
 servicestatus   **servicestatus_hashlist = NULL;
 
 extern int      use_pending_states;
+
+static int      binary_status_data = FALSE;
 #endif
 
 
@@ -91,6 +94,10 @@ int cleanup_status_data(int delete_status_data) {
 /* updates program status info */
 int update_program_status(int aggregated_dump) {
 
+	/* journal changes to retained state */
+	if(aggregated_dump == FALSE)
+		journal_program_state();
+
 #ifdef USE_EVENT_BROKER
 	/* send data to event broker (non-aggregated dumps only) */
 	if(aggregated_dump == FALSE)
@@ -105,6 +112,16 @@ int update_program_status(int aggregated_dump) {
 /* updates host status info */
 int update_host_status(host *hst, int aggregated_dump) {
 
+	/* keep the freshness deadline in step with the object */
+	update_host_freshness(hst);
+
+	/* mark the host dirty; aggregated dumps write everything anyway */
+	if(aggregated_dump == FALSE) {
+		set_host_state_flags(hst, OBJSTATE_STATUS_DIRTY);
+		xsddefault_update_host_status(hst);
+		journal_host_state(hst);
+		}
+
 #ifdef USE_EVENT_BROKER
 	/* send data to event broker (non-aggregated dumps only) */
 	if(aggregated_dump == FALSE)
@@ -119,6 +136,16 @@ int update_host_status(host *hst, int aggregated_dump) {
 /* updates service status info */
 int update_service_status(service *svc, int aggregated_dump) {
 
+	/* keep the freshness deadline in step with the object */
+	update_service_freshness(svc);
+
+	/* mark the service dirty; aggregated dumps write everything anyway */
+	if(aggregated_dump == FALSE) {
+		set_service_state_flags(svc, OBJSTATE_STATUS_DIRTY);
+		xsddefault_update_service_status(svc);
+		journal_service_state(svc);
+		}
+
 #ifdef USE_EVENT_BROKER
 	/* send data to event broker (non-aggregated dumps only) */
 	if(aggregated_dump == FALSE)
@@ -130,9 +157,20 @@ int update_service_status(service *svc, int aggregated_dump) {
 
 
 
+/* prints status data statistics to a query handler socket */
+int dump_status_data_stats(int sd) {
+	return xsddefault_dump_stats(sd);
+	}
+
+
+
 /* updates contact status info */
 int update_contact_status(contact *cntct, int aggregated_dump) {
 
+	/* journal changes to retained state */
+	if(aggregated_dump == FALSE)
+		journal_contact_state(cntct);
+
 #ifdef USE_EVENT_BROKER
 	/* send data to event broker (non-aggregated dumps only) */
 	if(aggregated_dump == FALSE)
@@ -156,6 +194,13 @@ int update_contact_status(contact *cntct, int aggregated_dump) {
 
 /* reads in all status data */
 int read_status_data(const char *status_file_name, int options) {
+
+	/* the binary status file is much cheaper to read, if it's there */
+	if(status_binary_file && xsddefault_read_binary_status_data(status_binary_file, options) == OK) {
+		binary_status_data = TRUE;
+		return OK;
+		}
+
 	return xsddefault_read_status_data(status_file_name, options);
 	}
 
@@ -252,52 +297,55 @@ int add_servicestatus_to_hashlist(servicestatus *new_servicestatus) {
 /******************************************************************/
 
 
-/* adds a host status entry to the list in memory */
-int add_host_status(hoststatus *new_hoststatus) {
+/* massages host status a bit after it's been read */
+void adjust_host_status(hoststatus *new_hoststatus) {
 	char date_string[MAX_DATETIME_LENGTH];
 
+	switch(new_hoststatus->status) {
+		case 0:
+			new_hoststatus->status = SD_HOST_UP;
+			break;
+		case 1:
+			new_hoststatus->status = SD_HOST_DOWN;
+			break;
+		case 2:
+			new_hoststatus->status = SD_HOST_UNREACHABLE;
+			break;
+		default:
+			new_hoststatus->status = SD_HOST_UP;
+			break;
+		}
+	if(new_hoststatus->has_been_checked == FALSE) {
+		if(use_pending_states == TRUE)
+			new_hoststatus->status = HOST_PENDING;
+		my_free(new_hoststatus->plugin_output);
+		if(new_hoststatus->should_be_scheduled == TRUE) {
+			get_time_string(&new_hoststatus->next_check, date_string, sizeof(date_string), LONG_DATE_TIME);
+			asprintf(&new_hoststatus->plugin_output, "Host check scheduled for %s", date_string);
+			}
+		else {
+			/* passive-only hosts that have just been scheduled for a forced check */
+			if(new_hoststatus->checks_enabled == FALSE && new_hoststatus->next_check != (time_t)0L && (new_hoststatus->check_options & CHECK_OPTION_FORCE_EXECUTION)) {
+				get_time_string(&new_hoststatus->next_check, date_string, sizeof(date_string), LONG_DATE_TIME);
+				asprintf(&new_hoststatus->plugin_output, "Forced host check scheduled for %s", date_string);
+				}
+			/* passive-only hosts not scheduled to be checked */
+			else
+				new_hoststatus->plugin_output = (char *)strdup("Host is not scheduled to be checked...");
+			}
+		}
+	}
+
+
+/* adds a host status entry to the list in memory */
+int add_host_status(hoststatus *new_hoststatus) {
 	/* make sure we have what we need */
 	if(new_hoststatus == NULL)
 		return ERROR;
 	if(new_hoststatus->host_name == NULL)
 		return ERROR;
 
-	/* massage host status a bit */
-	if(new_hoststatus != NULL) {
-		switch(new_hoststatus->status) {
-			case 0:
-				new_hoststatus->status = SD_HOST_UP;
-				break;
-			case 1:
-				new_hoststatus->status = SD_HOST_DOWN;
-				break;
-			case 2:
-				new_hoststatus->status = SD_HOST_UNREACHABLE;
-				break;
-			default:
-				new_hoststatus->status = SD_HOST_UP;
-				break;
-			}
-		if(new_hoststatus->has_been_checked == FALSE) {
-			if(use_pending_states == TRUE)
-				new_hoststatus->status = HOST_PENDING;
-			my_free(new_hoststatus->plugin_output);
-			if(new_hoststatus->should_be_scheduled == TRUE) {
-				get_time_string(&new_hoststatus->next_check, date_string, sizeof(date_string), LONG_DATE_TIME);
-				asprintf(&new_hoststatus->plugin_output, "Host check scheduled for %s", date_string);
-				}
-			else {
-				/* passive-only hosts that have just been scheduled for a forced check */
-				if(new_hoststatus->checks_enabled == FALSE && new_hoststatus->next_check != (time_t)0L && (new_hoststatus->check_options & CHECK_OPTION_FORCE_EXECUTION)) {
-					get_time_string(&new_hoststatus->next_check, date_string, sizeof(date_string), LONG_DATE_TIME);
-					asprintf(&new_hoststatus->plugin_output, "Forced host check scheduled for %s", date_string);
-					}
-				/* passive-only hosts not scheduled to be checked */
-				else
-					new_hoststatus->plugin_output = (char *)strdup("Host is not scheduled to be checked...");
-				}
-			}
-		}
+	adjust_host_status(new_hoststatus);
 
 	new_hoststatus->next = NULL;
 	new_hoststatus->nexthash = NULL;
@@ -320,10 +368,51 @@ int add_host_status(hoststatus *new_hoststatus) {
 	}
 
 
-/* adds a service status entry to the list in memory */
-int add_service_status(servicestatus *new_svcstatus) {
+/* massages service status a bit after it's been read */
+void adjust_service_status(servicestatus *new_svcstatus) {
 	char date_string[MAX_DATETIME_LENGTH];
 
+	switch(new_svcstatus->status) {
+		case 0:
+			new_svcstatus->status = SERVICE_OK;
+			break;
+		case 1:
+			new_svcstatus->status = SERVICE_WARNING;
+			break;
+		case 2:
+			new_svcstatus->status = SERVICE_CRITICAL;
+			break;
+		case 3:
+			new_svcstatus->status = SERVICE_UNKNOWN;
+			break;
+		default:
+			new_svcstatus->status = SERVICE_OK;
+			break;
+		}
+	if(new_svcstatus->has_been_checked == FALSE) {
+		if(use_pending_states == TRUE)
+			new_svcstatus->status = SERVICE_PENDING;
+		my_free(new_svcstatus->plugin_output);
+		if(new_svcstatus->should_be_scheduled == TRUE) {
+			get_time_string(&new_svcstatus->next_check, date_string, sizeof(date_string), LONG_DATE_TIME);
+			asprintf(&new_svcstatus->plugin_output, "Service check scheduled for %s", date_string);
+			}
+		else {
+			/* passive-only services that have just been scheduled for a forced check */
+			if(new_svcstatus->checks_enabled == FALSE && new_svcstatus->next_check != (time_t)0L && (new_svcstatus->check_options & CHECK_OPTION_FORCE_EXECUTION)) {
+				get_time_string(&new_svcstatus->next_check, date_string, sizeof(date_string), LONG_DATE_TIME);
+				asprintf(&new_svcstatus->plugin_output, "Forced service check scheduled for %s", date_string);
+				}
+			/* passive-only services not scheduled to be checked */
+			else
+				new_svcstatus->plugin_output = (char *)strdup("Service is not scheduled to be checked...");
+			}
+		}
+	}
+
+
+/* adds a service status entry to the list in memory */
+int add_service_status(servicestatus *new_svcstatus) {
 	/* make sure we have what we need */
 	if(new_svcstatus == NULL)
 		return ERROR;
@@ -331,45 +420,7 @@ int add_service_status(servicestatus *new_svcstatus) {
 		return ERROR;
 
 
-	/* massage service status a bit */
-	if(new_svcstatus != NULL) {
-		switch(new_svcstatus->status) {
-			case 0:
-				new_svcstatus->status = SERVICE_OK;
-				break;
-			case 1:
-				new_svcstatus->status = SERVICE_WARNING;
-				break;
-			case 2:
-				new_svcstatus->status = SERVICE_CRITICAL;
-				break;
-			case 3:
-				new_svcstatus->status = SERVICE_UNKNOWN;
-				break;
-			default:
-				new_svcstatus->status = SERVICE_OK;
-				break;
-			}
-		if(new_svcstatus->has_been_checked == FALSE) {
-			if(use_pending_states == TRUE)
-				new_svcstatus->status = SERVICE_PENDING;
-			my_free(new_svcstatus->plugin_output);
-			if(new_svcstatus->should_be_scheduled == TRUE) {
-				get_time_string(&new_svcstatus->next_check, date_string, sizeof(date_string), LONG_DATE_TIME);
-				asprintf(&new_svcstatus->plugin_output, "Service check scheduled for %s", date_string);
-				}
-			else {
-				/* passive-only services that have just been scheduled for a forced check */
-				if(new_svcstatus->checks_enabled == FALSE && new_svcstatus->next_check != (time_t)0L && (new_svcstatus->check_options & CHECK_OPTION_FORCE_EXECUTION)) {
-					get_time_string(&new_svcstatus->next_check, date_string, sizeof(date_string), LONG_DATE_TIME);
-					asprintf(&new_svcstatus->plugin_output, "Forced service check scheduled for %s", date_string);
-					}
-				/* passive-only services not scheduled to be checked */
-				else
-					new_svcstatus->plugin_output = (char *)strdup("Service is not scheduled to be checked...");
-				}
-			}
-		}
+	adjust_service_status(new_svcstatus);
 
 	new_svcstatus->next = NULL;
 	new_svcstatus->nexthash = NULL;
@@ -407,6 +458,14 @@ void free_status_data(void) {
 	servicestatus *this_svcstatus = NULL;
 	servicestatus *next_svcstatus = NULL;
 
+	/* records read from the binary status file live in one block */
+	if(binary_status_data == TRUE) {
+		xsddefault_free_binary_status_data();
+		hoststatus_list = NULL;
+		servicestatus_list = NULL;
+		binary_status_data = FALSE;
+		}
+
 	/* free memory for the host status list */
 	for(this_hoststatus = hoststatus_list; this_hoststatus != NULL; this_hoststatus = next_hoststatus) {
 		next_hoststatus = this_hoststatus->next;
@@ -432,7 +491,9 @@ void free_status_data(void) {
 	my_free(hoststatus_hashlist);
 	my_free(servicestatus_hashlist);
 	hoststatus_list = NULL;
+	hoststatus_list_tail = NULL;
 	servicestatus_list = NULL;
+	servicestatus_list_tail = NULL;
 
 	return;
 	}
@@ -445,11 +506,48 @@ void free_status_data(void) {
 /******************************************************************/
 
 
+/* returns the host status list, decoding it first if need be */
+hoststatus *get_hoststatus_list(void) {
+
+	if(binary_status_data == TRUE && hoststatus_list == NULL)
+		hoststatus_list = xsddefault_binary_hoststatus_list();
+
+	return hoststatus_list;
+	}
+
+
+/* returns the service status list, decoding it first if need be */
+servicestatus *get_servicestatus_list(void) {
+
+	if(binary_status_data == TRUE && servicestatus_list == NULL)
+		servicestatus_list = xsddefault_binary_servicestatus_list();
+
+	return servicestatus_list;
+	}
+
+
 /* find a host status entry */
 hoststatus *find_hoststatus(char *host_name) {
 	hoststatus *temp_hoststatus = NULL;
 
-	if(host_name == NULL || hoststatus_hashlist == NULL)
+	if(host_name == NULL)
+		return NULL;
+
+	/*
+	 * binary status records are found through the host's id. If the
+	 * object config doesn't agree with the status file we fall back
+	 * to hashing every record by name.
+	 */
+	if(binary_status_data == TRUE) {
+		if((temp_hoststatus = xsddefault_binary_hoststatus(host_name)))
+			return temp_hoststatus;
+		if(hoststatus_hashlist == NULL) {
+			for(temp_hoststatus = get_hoststatus_list(); temp_hoststatus; temp_hoststatus = temp_hoststatus->next)
+				add_hoststatus_to_hashlist(temp_hoststatus);
+			}
+		}
+
+	if(hoststatus_hashlist == NULL)
 		return NULL;
 
 	for(temp_hoststatus = hoststatus_hashlist[hashfunc(host_name, NULL, HOSTSTATUS_HASHSLOTS)]; temp_hoststatus && compare_hashdata(temp_hoststatus->host_name, NULL, host_name, NULL) < 0; temp_hoststatus = temp_hoststatus->nexthash);
@@ -465,7 +563,19 @@ hoststatus *find_hoststatus(char *host_name) {
 servicestatus *find_servicestatus(char *host_name, char *svc_desc) {
 	servicestatus *temp_servicestatus = NULL;
 
-	if(host_name == NULL || svc_desc == NULL || servicestatus_hashlist == NULL)
+	if(host_name == NULL || svc_desc == NULL)
+		return NULL;
+
+	if(binary_status_data == TRUE) {
+		if((temp_servicestatus = xsddefault_binary_servicestatus(host_name, svc_desc)))
+			return temp_servicestatus;
+		if(servicestatus_hashlist == NULL) {
+			for(temp_servicestatus = get_servicestatus_list(); temp_servicestatus; temp_servicestatus = temp_servicestatus->next)
+				add_servicestatus_to_hashlist(temp_servicestatus);
+			}
+		}
+
+	if(servicestatus_hashlist == NULL)
 		return NULL;
 
 	for(temp_servicestatus = servicestatus_hashlist[hashfunc(host_name, svc_desc, SERVICESTATUS_HASHSLOTS)]; temp_servicestatus && compare_hashdata(temp_servicestatus->host_name, temp_servicestatus->description, host_name, svc_desc) < 0; temp_servicestatus = temp_servicestatus->nexthash);
@@ -492,7 +602,7 @@ int get_servicestatus_count(char *host_name, int type) {
 	if(host_name == NULL)
 		return 0;
 
-	for(temp_status = servicestatus_list; temp_status != NULL; temp_status = temp_status->next) {
+	for(temp_status = get_servicestatus_list(); temp_status != NULL; temp_status = temp_status->next) {
 		if(temp_status->status & type) {
 			if(!strcmp(host_name, temp_status->host_name))
 				count++;
@@ -0,0 +1,198 @@
+/*
+ * Decodes trace ring dumps and streams from the "trace" query handler:
+ *
+ *   printf '#trace dump\0' | nc -U /usr/local/nagios/var/rw/nagios.qh | nagiostrace
+ *
+ * Check submissions are matched with their worker results by worker
+ * pid and job id, so the round-trip time of each job is printed with
+ * its result.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../lib/tracering.h"
+#include "../include/trace.h"
+
+/* outstanding check submissions, by worker pid and job id */
+#define PENDING_JOBS 4096
+static struct {
+	uint64_t pid, job, ns;
+} pending[PENDING_JOBS];
+
+static const char *event_names[] = TRACE_EVENT_NAMES;
+static unsigned long long event_count[TRACE_NUM_EVENTS];
+static unsigned long long rtt_count;
+static double rtt_total, rtt_max;
+
+static void usage(char *progname)
+{
+	printf("Usage: %s [-s] [<tracefile>]\n", progname);
+	printf("  -s  only print a summary of the trace\n");
+	printf("Reads the trace from stdin if no file is given\n");
+}
+
+static const char *object_name(uint32_t type)
+{
+	return type == TRACE_HOST ? "host" : type == TRACE_SERVICE ? "service" : "unknown";
+}
+
+static unsigned int pending_slot(uint64_t pid, uint64_t job)
+{
+	return (unsigned int)((job * 31 + pid) % PENDING_JOBS);
+}
+
+/* returns the round-trip time of a job in milliseconds, or -1 if unknown */
+static double job_rtt(struct tracering_rec *rec)
+{
+	unsigned int slot = pending_slot(rec->arg2, rec->arg1);
+	double rtt;
+
+	if (!pending[slot].ns || pending[slot].pid != rec->arg2 || pending[slot].job != rec->arg1)
+		return -1;
+
+	rtt = (double)(rec->ns - pending[slot].ns) / 1000000.0;
+	pending[slot].ns = 0;
+	rtt_count++;
+	rtt_total += rtt;
+	if (rtt > rtt_max)
+		rtt_max = rtt;
+
+	return rtt;
+}
+
+static void print_record(struct tracering_header *hdr, struct tracering_rec *rec, int quiet)
+{
+	uint64_t real_ns = hdr->real_ns - (hdr->mono_ns - rec->ns);
+	time_t when = (time_t)(real_ns / 1000000000ULL);
+	unsigned int slot;
+	char tstamp[32];
+	double rtt;
+
+	event_count[rec->event < TRACE_NUM_EVENTS ? rec->event : 0]++;
+
+	/* track submissions and results even when we don't print them */
+	rtt = -1;
+	if (rec->event == TRACE_CHECK_SUBMIT) {
+		slot = pending_slot(rec->arg2, rec->arg1);
+		pending[slot].pid = rec->arg2;
+		pending[slot].job = rec->arg1;
+		pending[slot].ns = rec->ns;
+	}
+	else if (rec->event == TRACE_WORKER_RESULT) {
+		rtt = job_rtt(rec);
+	}
+
+	if (quiet)
+		return;
+
+	strftime(tstamp, sizeof(tstamp), "%Y-%m-%d %H:%M:%S", localtime(&when));
+	printf("%s.%06llu %-14s ", tstamp, (unsigned long long)(real_ns % 1000000000ULL) / 1000,
+	       event_names[rec->event < TRACE_NUM_EVENTS ? rec->event : 0]);
+
+	switch (rec->event) {
+	case TRACE_EVENT_DISPATCH:
+		printf("event_type=%u latency=%lluus object_id=%llu\n",
+		       rec->arg0, (unsigned long long)rec->arg1, (unsigned long long)rec->arg2);
+		break;
+	case TRACE_CHECK_SUBMIT:
+		printf("%s job=%llu worker=%llu\n", object_name(rec->arg0),
+		       (unsigned long long)rec->arg1, (unsigned long long)rec->arg2);
+		break;
+	case TRACE_WORKER_RESULT:
+		printf("job_type=%u job=%llu worker=%llu", rec->arg0,
+		       (unsigned long long)rec->arg1, (unsigned long long)rec->arg2);
+		if (rtt >= 0)
+			printf(" rtt=%.3fms", rtt);
+		putchar('\n');
+		break;
+	case TRACE_STATE_CHANGE:
+		printf("%s id=%llu state=%llu->%llu %s\n", object_name(rec->arg0),
+		       (unsigned long long)rec->arg1,
+		       (unsigned long long)(rec->arg2 >> 8) & 0xff,
+		       (unsigned long long)rec->arg2 & 0xff,
+		       (rec->arg2 >> 16) & 0xff ? "hard" : "soft");
+		break;
+	case TRACE_NOTIFICATION:
+		printf("%s id=%llu reason=%llu\n", object_name(rec->arg0),
+		       (unsigned long long)rec->arg1, (unsigned long long)rec->arg2);
+		break;
+	default:
+		printf("event=%u arg0=%u arg1=%llu arg2=%llu\n", rec->event, rec->arg0,
+		       (unsigned long long)rec->arg1, (unsigned long long)rec->arg2);
+		break;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	struct tracering_header hdr;
+	struct tracering_rec rec;
+	unsigned long long records = 0;
+	int i, summary = 0;
+	char *path = NULL;
+	FILE *fp = stdin;
+
+	for (i = 1; i < argc; i++) {
+		char *arg = argv[i];
+		if (!strcmp(arg, "-h") || !strcmp(arg, "--help")) {
+			usage(argv[0]);
+			return 0;
+		}
+		if (!strcmp(arg, "-s")) {
+			summary = 1;
+			continue;
+		}
+		if (*arg == '-' || path) {
+			usage(argv[0]);
+			return 1;
+		}
+		path = arg;
+	}
+
+	if (path && !(fp = fopen(path, "rb"))) {
+		perror(path);
+		return 1;
+	}
+
+	if (fread(&hdr, sizeof(hdr), 1, fp) != 1 || memcmp(hdr.magic, TRACERING_MAGIC, sizeof(hdr.magic))) {
+		fprintf(stderr, "%s: not a nagios trace\n", path ? path : "stdin");
+		return 1;
+	}
+	if (hdr.version != TRACERING_VERSION || hdr.rec_size != sizeof(rec)) {
+		fprintf(stderr, "%s: unsupported trace version %u (record size %u)\n",
+		        path ? path : "stdin", hdr.version, hdr.rec_size);
+		return 1;
+	}
+
+	if (!summary) {
+		printf("# nagios pid %u, %u record ring, starting at record %llu\n",
+		       hdr.pid, hdr.size, (unsigned long long)hdr.first);
+		fflush(stdout);
+	}
+
+	while (fread(&rec, sizeof(rec), 1, fp) == 1) {
+		print_record(&hdr, &rec, summary);
+		records++;
+		/* keep up when following a stream */
+		if (!summary && fp == stdin)
+			fflush(stdout);
+	}
+
+	if (summary) {
+		printf("records: %llu\n", records);
+		for (i = 1; i < TRACE_NUM_EVENTS; i++)
+			printf("%s: %llu\n", event_names[i], event_count[i]);
+		if (event_count[0])
+			printf("unknown: %llu\n", event_count[0]);
+		if (rtt_count)
+			printf("check rtt: %llu matched, avg %.3fms, max %.3fms\n",
+			       rtt_count, rtt_total / rtt_count, rtt_max);
+	}
+
+	if (fp != stdin)
+		fclose(fp);
+
+	return 0;
+}
@@ -18,6 +18,9 @@
 #define DEFAULT_MAX_PARALLEL_SERVICE_CHECKS 			0	/* maximum number of service checks we can have running at any given time (0=unlimited) */
 #define DEFAULT_RETENTION_UPDATE_INTERVAL			60	/* minutes between auto-save of retention data */
 #define DEFAULT_RETENTION_SCHEDULING_HORIZON    		900     /* max seconds between program restarts that we will preserve scheduling information */
+#define DEFAULT_RETENTION_SAVE_MODE				0	/* RETENTION_SAVE_FOREGROUND */
+#define DEFAULT_RETENTION_JOURNAL_SYNC_INTERVAL			1	/* seconds between syncs of the retention journal */
+#define DEFAULT_RETENTION_JOURNAL_MAX_SIZE			16777216	/* journal size (in bytes) that triggers a retention save */
 #define DEFAULT_STATUS_UPDATE_INTERVAL				60	/* seconds between aggregated status data updates */
 #define DEFAULT_FRESHNESS_CHECK_INTERVAL        		60      /* seconds between service result freshness checks */
 #define DEFAULT_AUTO_RESCHEDULING_INTERVAL      		30      /* seconds between host and service check rescheduling events */
@@ -73,6 +76,19 @@
 #define DEFAULT_ENABLE_PREDICTIVE_SERVICE_DEPENDENCY_CHECKS	1	/* should we use predictive service dependency checks? */
 
 #define DEFAULT_USE_LARGE_INSTALLATION_TWEAKS                   0       /* don't use tweaks for large Nagios installations */
+#define DEFAULT_BINARY_OBJECT_PRECACHE                          0       /* write the text object precache format */
+
+#define DEFAULT_EVENT_QUEUE_TYPE                                SQUEUE_TYPE_HEAP /* binary heap scheduling queue */
+#define DEFAULT_EVENT_BATCH_SIZE                                1       /* handle one due event per event loop iteration */
+#define DEFAULT_CHECK_RESULT_THREADS                            0       /* parse check results in the main thread */
+#define DEFAULT_OBJECT_CONFIG_THREADS                           1       /* read object config files one at a time */
+#define DEFAULT_WORKER_USE_POSIX_SPAWN                          0       /* workers fork() every command */
+#define DEFAULT_WORKER_SHM_RING_SIZE                            0       /* talk to workers over their sockets only */
+#define DEFAULT_USE_LOG_THREAD                                  0       /* write log messages from the event loop */
+#define DEFAULT_LOG_THREAD_BUFFER_SIZE                          1048576 /* bytes queued for the log thread */
+#define DEFAULT_LOG_OVERFLOW_POLICY                             0       /* LOG_OVERFLOW_BLOCK */
+#define DEFAULT_LOG_FSYNC_INTERVAL                              -1      /* LOG_FSYNC_NEVER */
+#define DEFAULT_TRACE_BUFFER_SIZE                               0       /* don't trace */
 
 #define DEFAULT_ADDITIONAL_FRESHNESS_LATENCY			15	/* seconds to be added to freshness thresholds when automatically calculated by Nagios */
 
@@ -35,6 +35,14 @@
 #define NSLOG_HOST_NOTIFICATION		524288
 #define NSLOG_SERVICE_NOTIFICATION	1048576
 
+/************** LOG THREAD OVERFLOW/FSYNC **************/
+
+#define LOG_OVERFLOW_BLOCK		0	/* wait for the log thread to catch up */
+#define LOG_OVERFLOW_DROP		1	/* drop messages (and count them) */
+
+#define LOG_FSYNC_NEVER			-1	/* leave it to the kernel */
+#define LOG_FSYNC_BATCH			0	/* after every batch of messages */
+
 /***************** DEBUGGING LEVELS *******************/
 
 #define DEBUGL_ALL                      -1
@@ -85,6 +93,9 @@ int open_debug_log(void);
 int close_debug_log(void);
 int close_log_file(void);
 int fix_log_file_owner(uid_t uid, gid_t gid);
+int start_log_thread(void);				/* hands log writes to a thread */
+void stop_log_thread(void);				/* writes what's queued and stops the thread */
+int dump_log_thread_stats(int sd);			/* prints log thread counters to a query handler socket */
 #endif /* !NSCGI */
 
 NAGIOS_END_DECL
@@ -36,6 +36,11 @@
 
 #define MACRO_ENV_VAR_PREFIX			"NAGIOS_"
 
+/* which macros env_macros_to_kvv() exports */
+#define ENV_MACROS_CONSTANT			1	/* the static ones, same for all commands */
+#define ENV_MACROS_VOLATILE			2	/* everything else */
+#define ENV_MACROS_ALL				(ENV_MACROS_CONSTANT | ENV_MACROS_VOLATILE)
+
 #define MAX_USER_MACROS				256	/* maximum number of $USERx$ macros */
 
 #define MACRO_X_COUNT				163	/* size of macro_x[] array */
@@ -251,6 +256,23 @@ int process_macros_r(nagios_macros *mac, char *, char **, int);
 /* cleans macros characters before insertion into output string */
 char *clean_macro_chars(char *, int);
 
+/*
+ * Compiled macro templates. A template is parsed once and can then
+ * be expanded any number of times with the same result as running
+ * process_macros_r() on the original string.
+ */
+typedef struct macro_template macro_template;
+macro_template *compile_macro_template(const char *);
+void free_macro_template(macro_template *);
+int expand_macro_template_r(nagios_macros *mac, macro_template *, char **, int);
+
+/* a command line with its "command!arg1!arg2" arguments */
+typedef struct command_template command_template;
+command_template *compile_command_template(command *, char *);
+void free_command_template(command_template *);
+int command_template_matches(command_template *, command *, char *);
+int expand_command_template_r(nagios_macros *mac, command_template *, char **, int);
+
 /*
  * These functions updates **macros with the values from
  * their respective object type.
@@ -343,6 +365,10 @@ int set_argv_macro_environment_vars_r(nagios_macros *mac, int);
 int set_custom_macro_environment_vars_r(nagios_macros *mac, int);
 int set_contact_address_environment_vars_r(nagios_macros *mac, int);
 
+/* restrict the exported macros to a comma-separated list of names */
+int set_environment_macro_filter(const char *);
+struct kvvec *env_macros_to_kvv(nagios_macros *mac, int);
+
 #endif
 
 NAGIOS_END_DECL
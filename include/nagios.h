@@ -30,6 +30,7 @@
 #include "locations.h"
 #include "objects.h"
 #include "macros.h"
+#include "trace.h"
 
 /*
  * global variables only used in the core. Reducing this list would be
@@ -43,6 +44,7 @@ extern char *temp_path;
 extern char *check_result_path;
 extern char *lock_file;
 extern char *object_precache_file;
+extern int binary_object_precache;
 
 extern unsigned int nofile_limit, nproc_limit, max_apps;
 
@@ -151,6 +153,10 @@ extern int retention_update_interval;
 extern int use_retained_program_state;
 extern int use_retained_scheduling_info;
 extern int retention_scheduling_horizon;
+extern int retention_save_mode;
+extern int retention_journal;
+extern int retention_journal_sync_interval;
+extern unsigned long retention_journal_max_size;
 extern char *retention_file;
 extern unsigned long retained_host_attribute_mask;
 extern unsigned long retained_service_attribute_mask;
@@ -213,6 +219,23 @@ extern unsigned long modified_host_process_attributes;
 extern unsigned long modified_service_process_attributes;
 
 extern squeue_t *nagios_squeue;
+extern int event_queue_type;
+extern int event_batch_size;
+extern int check_result_threads;
+extern int object_config_threads;
+extern int worker_use_posix_spawn;
+extern unsigned long worker_shm_ring_size;
+extern int use_log_thread;
+extern unsigned long log_thread_buffer_size;
+extern int log_overflow_policy;
+extern int log_fsync_interval;
+extern unsigned int trace_buffer_size;
+extern tracering *nagios_trace;
+
+/* records a trace point if tracing is enabled */
+#define nagios_trace_event(event, arg0, arg1, arg2) \
+	do { if(nagios_trace) tracering_add(nagios_trace, event, arg0, arg1, arg2); } while(0)
+
 extern iobroker_set *nagios_iobs;
 
 extern struct check_stats check_statistics[MAX_CHECK_STATS_TYPES];
@@ -467,6 +490,8 @@ extern int nerd_broadcast(unsigned int chan_id, void *buf, unsigned int len);
 /*** Query Handler functions, types and macros*/
 typedef int (*qh_handler)(int, char *, unsigned int);
 extern int dump_event_stats(int sd);
+extern int dump_status_data_stats(int sd);
+extern void qh_trace_flush(void);
 
 /* return codes for query_handlers() */
 #define QH_OK        0  /* keep listening */
@@ -519,7 +544,11 @@ int process_check_result(check_result *);
 int delete_check_result_file(const char *);
 int init_check_result(check_result *);
 int free_check_result(check_result *);                  	/* frees memory associated with a host/service check result */
+check_result *alloc_check_result(void);                 	/* gets a check result, recycled if possible */
+void release_check_result(check_result *);              	/* frees a check result from alloc_check_result() */
+void free_check_result_freelist(void);
 int parse_check_output(char *, char **, char **, char **, int, int);
+int parse_check_output_arena(arena *, char *, char **, char **, char **, int, int);
 int open_command_file(void);					/* creates the external command file as a named pipe (FIFO) and opens it for reading */
 int close_command_file(void);					/* closes and deletes the external command file (FIFO) */
 
@@ -530,10 +559,17 @@ int check_service_dependencies(service *, int);          	/* checks service depe
 int check_host_dependencies(host *, int);                	/* checks host dependencies */
 void check_for_orphaned_services(void);				/* checks for orphaned services */
 void check_for_orphaned_hosts(void);				/* checks for orphaned hosts */
+void reschedule_lost_service_check(service *);			/* checks a service again whose running check won't come back */
+void reschedule_lost_host_check(host *);			/* checks a host again whose running check won't come back */
 void check_service_result_freshness(void);              	/* checks the "freshness" of service check results */
 int is_service_result_fresh(service *, time_t, int);            /* determines if a service's check results are fresh */
 void check_host_result_freshness(void);                 	/* checks the "freshness" of host check results */
 int is_host_result_fresh(host *, time_t, int);                  /* determines if a host's check results are fresh */
+void update_host_freshness(host *);                      	/* recalculates when a host's results go stale */
+void update_service_freshness(service *);                	/* recalculates when a service's results go stale */
+time_t get_host_freshness_deadline(host *);			/* when the freshness index has a host going stale, 0 if never */
+time_t get_service_freshness_deadline(service *);		/* when the freshness index has a service going stale, 0 if never */
+void free_freshness_index(void);
 int my_system(char *, int, int *, double *, char **, int);         	/* executes a command via popen(), but also protects against timeouts */
 int my_system_r(nagios_macros *mac, char *, int, int *, double *, char **, int); /* thread-safe version of the above */
 
@@ -573,6 +609,12 @@ int run_async_service_check(service *, int, double, int, int, int *, time_t *);
 int handle_async_service_check_result(service *, check_result *);
 
 
+/**** Compiled Check Commands ****/
+void invalidate_host_check_template(host *);			/* forget a host's compiled check command */
+void invalidate_service_check_template(service *);		/* forget a service's compiled check command */
+void free_check_templates(void);
+
+
 /**** Event Handler Functions ****/
 int handle_host_state(host *);               			/* top level host state handler */
 
@@ -667,11 +709,14 @@ extern int get_raw_command_line_r(nagios_macros *mac, command *, char *, char **
 extern int get_raw_command_line(command *, char *, char **, int);
 
 int check_time_against_period(time_t, timeperiod *);	/* check to see if a specific time is covered by a time period */
+int _check_time_against_period(time_t, timeperiod *);	/* same thing, without the compiled timeperiods */
 int is_daterange_single_day(daterange *);
 time_t calculate_time_from_weekday_of_month(int, int, int, int);	/* calculates midnight time of specific (3rd, last, etc.) weekday of a particular month */
 time_t calculate_time_from_day_of_month(int, int, int);	/* calculates midnight time of specific (1st, last, etc.) day of a particular month */
 void get_next_valid_time(time_t, time_t *, timeperiod *);	/* get the next valid time in a time period */
 time_t reschedule_within_timeperiod(time_t, timeperiod*, time_t);
+void invalidate_timeperiod_cache(void);				/* forget compiled timeperiods */
+void free_timeperiod_cache(void);
 time_t get_next_log_rotation_time(void);	     	/* determine the next time to schedule a log rotation */
 int dbuf_init(dbuf *, int);
 int dbuf_free(dbuf *);
@@ -685,6 +730,7 @@ int query_update_api(void);                             /* checks to see if new
 int process_external_command1(char *);                  /* top-level external command processor */
 int process_external_command2(int, time_t, char *);	/* process an external command */
 int process_external_commands_from_file(char *, int);   /* process external commands in a file */
+unsigned long process_external_command_batch(char *, unsigned long); /* process a buffer of newline-terminated external commands */
 int process_host_command(int, time_t, char *);          /* process an external host command */
 int process_hostgroup_command(int, time_t, char *);     /* process an external hostgroup command */
 int process_service_command(int, time_t, char *);       /* process an external service command */
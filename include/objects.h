@@ -176,6 +176,10 @@ typedef struct check_result {
 	struct rusage rusage;   			/* resource usage by this check */
 	struct check_engine *engine;                    /* where did we get this check from? */
 	const void *source;				/* engine handles this */
+	int output_parsed;                              /* has output already been split into the fields below? */
+	char *short_output;                             /* pre-parsed short output */
+	char *long_output;                              /* pre-parsed long output */
+	char *perf_data;                                /* pre-parsed performance data */
 	} check_result;
 
 
@@ -741,6 +745,41 @@ extern struct hostdependency **hostdependency_ary;
 extern struct serviceescalation **serviceescalation_ary;
 extern struct servicedependency **servicedependency_ary;
 
+#ifdef NSCORE
+/*
+ * The contacts a host, service or escalation notifies, with its
+ * contactgroups expanded and duplicates removed. These are indexed
+ * by object id and built once the config is loaded.
+ */
+struct contact_fanout {
+	unsigned int count;
+	struct contact **contacts;
+	};
+
+extern struct contact_fanout *host_contact_fanout;
+extern struct contact_fanout *service_contact_fanout;
+extern struct contact_fanout *hostescalation_contact_fanout;
+extern struct contact_fanout *serviceescalation_contact_fanout;
+
+/*
+ * Host and service state the core mirrors into arrays indexed by
+ * object id, so scans over every host or service can walk a flat
+ * array and only touch the objects they need. The objects remain
+ * authoritative. The arrays are allocated along with the object
+ * tables and kept up to date by update_host_status() and
+ * update_service_status().
+ */
+#define OBJSTATE_STATUS_DIRTY	(1 << 0)	/* changed since it was last written to status.dat */
+
+struct object_state_array {
+	unsigned int size;
+	unsigned char *flags;
+	};
+
+extern struct object_state_array host_state_ary;
+extern struct object_state_array service_state_ary;
+#endif
+
 
 /********************* FUNCTIONS **********************/
 
@@ -799,6 +838,20 @@ int get_service_count(void);
 
 
 int create_object_tables(unsigned int *);
+#ifdef NSCORE
+int init_contact_fanout(void);
+void free_contact_fanout(void);
+void new_contact_marks(void);
+int mark_contact(struct contact *);
+void free_object_state_arrays(void);
+void set_host_state_flags(struct host *, unsigned char);
+void set_service_state_flags(struct service *, unsigned char);
+#endif
+int init_custom_variable_index(void);
+void free_custom_variable_index(void);
+struct customvariablesmember *find_host_custom_variable(struct host *, const char *);
+struct customvariablesmember *find_service_custom_variable(struct service *, const char *);
+struct customvariablesmember *find_contact_custom_variable(struct contact *, const char *);
 
 /**** Object Search Functions ****/
 struct timeperiod *find_timeperiod(const char *);
@@ -27,5 +27,27 @@ int initialize_retention_data(const char *);
 int cleanup_retention_data(void);
 int save_state_information(int);                 /* saves all host and state information */
 int read_initial_state_information(void);        /* reads in initial host and state information */
+void wait_for_state_information_save(void);      /* waits for a background save to finish */
+int dump_retention_stats(int sd);
+
+struct host;
+struct service;
+struct contact;
+struct nagios_comment;
+struct scheduled_downtime;
+
+int open_retention_journal(void);
+int close_retention_journal(void);
+int sync_retention_journal(void);                /* syncs the journal, and saves if it's grown too big */
+void journal_program_state(void);
+void journal_host_state(struct host *);
+void journal_service_state(struct service *);
+void journal_contact_state(struct contact *);
+void journal_comment(struct nagios_comment *, int);
+void journal_downtime(struct scheduled_downtime *, int);
+
+/* retention_save_mode values */
+#define RETENTION_SAVE_FOREGROUND 0
+#define RETENTION_SAVE_BACKGROUND 1
 
 NAGIOS_END_DECL
@@ -174,12 +174,16 @@ typedef struct servicestatus_struct {
 int read_status_data(const char *, int);                /* reads all status data */
 int add_host_status(hoststatus *);                      /* adds a host status entry to the list in memory */
 int add_service_status(servicestatus *);                /* adds a service status entry to the list in memory */
+void adjust_host_status(hoststatus *);                  /* massages host status after it's been read */
+void adjust_service_status(servicestatus *);            /* massages service status after it's been read */
 
 int add_hoststatus_to_hashlist(hoststatus *);
 int add_servicestatus_to_hashlist(servicestatus *);
 
 servicestatus *find_servicestatus(char *, char *);      /* finds status information for a specific service */
 hoststatus *find_hoststatus(char *);                    /* finds status information for a specific host */
+hoststatus *get_hoststatus_list(void);                  /* returns status information for all hosts */
+servicestatus *get_servicestatus_list(void);            /* returns status information for all services */
 int get_servicestatus_count(char *, int);		/* gets total number of services of a certain type for a specific host */
 
 void free_status_data(void);                            /* free all memory allocated to status data */
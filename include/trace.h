@@ -0,0 +1,30 @@
+#ifndef NAGIOS_TRACE_H_INCLUDED
+#define NAGIOS_TRACE_H_INCLUDED
+
+/*
+ * Trace points in the event loop, recorded in nagios_trace (see
+ * lib/tracering.h) when tracing is enabled. This header is shared
+ * with the offline decoder, so it mustn't depend on anything else.
+ */
+
+/* what's traced */
+#define TRACE_EVENT_DISPATCH    1   /* arg0: event type, arg1: latency in usecs, arg2: object id */
+#define TRACE_CHECK_SUBMIT      2   /* arg0: object type, arg1: job id, arg2: worker pid */
+#define TRACE_WORKER_RESULT     3   /* arg0: job type, arg1: job id, arg2: worker pid */
+#define TRACE_STATE_CHANGE      4   /* arg0: object type, arg1: object id, arg2: see TRACE_STATES() */
+#define TRACE_NOTIFICATION      5   /* arg0: object type, arg1: object id, arg2: notification reason */
+#define TRACE_NUM_EVENTS        6
+
+#define TRACE_EVENT_NAMES { \
+	"unknown", "event_dispatch", "check_submit", "worker_result", \
+	"state_change", "notification" }
+
+/* object types, for arg0 */
+#define TRACE_HOST      1
+#define TRACE_SERVICE   2
+
+/* packs a state change into a single argument */
+#define TRACE_STATES(last, current, type) \
+	((((uint64_t)(type) & 0xff) << 16) | (((uint64_t)(last) & 0xff) << 8) | ((uint64_t)(current) & 0xff))
+
+#endif
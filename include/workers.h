@@ -39,6 +39,7 @@ typedef struct wproc_result {
 	struct kvvec *response;
 	/* 5DEPR: rusage is deprecated for Nagios, will be removed in 5.0.0 */
 	struct rusage rusage;
+	double time_to_spawn; /* seconds the worker spent starting the job */
 } wproc_result;
 
 extern unsigned int wproc_num_workers_spawned;
@@ -52,6 +53,7 @@ extern int workers_alive(void);
 extern int get_desired_workers(int desired_workers);
 extern int init_workers(int desired_workers);
 extern int wproc_run_check(check_result *cr, char *cmd, nagios_macros *mac);
+extern check_result *wproc_next_orphaned_check(int object_check_type, time_t now);
 extern int wproc_notify(char *cname, char *hname, char *sdesc, char *cmd, nagios_macros *mac);
 extern int wproc_run(int job_type, char *cmd, int timeout, nagios_macros *mac);
 extern int wproc_run_service_job(int jtype, int timeout, service *svc, char *cmd, nagios_macros *mac);
@@ -0,0 +1,140 @@
+#include <stdlib.h>
+#include <string.h>
+#include "arena.h"
+
+#define ARENA_ALIGN(x) (((x) + 7) & ~(size_t)7)
+
+struct arena_chunk {
+	struct arena_chunk *next;
+	size_t size;
+	size_t used;
+	char data[];
+};
+
+struct arena {
+	struct arena_chunk *chunks; /* newest first */
+	size_t chunk_size;
+	unsigned int num_chunks;
+};
+
+static struct arena_chunk *arena_add_chunk(arena *a, size_t size)
+{
+	struct arena_chunk *c;
+
+	if (!(c = malloc(sizeof(*c) + size)))
+		return NULL;
+	c->size = size;
+	c->used = 0;
+	c->next = a->chunks;
+	a->chunks = c;
+	a->num_chunks++;
+
+	return c;
+}
+
+static void arena_free_chunks(arena *a)
+{
+	struct arena_chunk *c, *next;
+
+	for (c = a->chunks; c; c = next) {
+		next = c->next;
+		free(c);
+	}
+	a->chunks = NULL;
+	a->num_chunks = 0;
+}
+
+arena *arena_create(size_t chunk_size)
+{
+	arena *a;
+
+	if (!(a = calloc(1, sizeof(*a))))
+		return NULL;
+	a->chunk_size = chunk_size ? ARENA_ALIGN(chunk_size) : 4096;
+	if (!arena_add_chunk(a, a->chunk_size)) {
+		free(a);
+		return NULL;
+	}
+
+	return a;
+}
+
+void arena_destroy(arena *a)
+{
+	if (!a)
+		return;
+	arena_free_chunks(a);
+	free(a);
+}
+
+void *arena_alloc(arena *a, size_t size)
+{
+	struct arena_chunk *c = a->chunks;
+	void *ptr;
+
+	size = ARENA_ALIGN(size ? size : 1);
+	if (!c || c->size - c->used < size) {
+		/* big allocations get a chunk of their own */
+		if (!(c = arena_add_chunk(a, size > a->chunk_size ? size : a->chunk_size)))
+			return NULL;
+	}
+
+	ptr = c->data + c->used;
+	c->used += size;
+	return ptr;
+}
+
+char *arena_strndup(arena *a, const char *str, size_t len)
+{
+	char *ret;
+
+	len = strnlen(str, len);
+	if (!(ret = arena_alloc(a, len + 1)))
+		return NULL;
+	memcpy(ret, str, len);
+	ret[len] = 0;
+
+	return ret;
+}
+
+char *arena_strdup(arena *a, const char *str)
+{
+	if (!str)
+		return NULL;
+	return arena_strndup(a, str, strlen(str));
+}
+
+void arena_reset(arena *a)
+{
+	struct arena_chunk *c;
+	size_t total = 0;
+
+	if (a->num_chunks == 1) {
+		a->chunks->used = 0;
+		return;
+	}
+
+	/* make room for all of it in one chunk next time around */
+	for (c = a->chunks; c; c = c->next)
+		total += c->size;
+	arena_free_chunks(a);
+	if (total > a->chunk_size)
+		a->chunk_size = total;
+	arena_add_chunk(a, a->chunk_size);
+}
+
+size_t arena_used(arena *a)
+{
+	struct arena_chunk *c;
+	size_t used = 0;
+
+	for (c = a->chunks; c; c = c->next)
+		used += c->used;
+
+	return used;
+}
+
+unsigned int arena_chunks(arena *a)
+{
+	return a->num_chunks;
+}
@@ -0,0 +1,86 @@
+#ifndef LIBNAGIOS_ARENA_H_INCLUDED
+#define LIBNAGIOS_ARENA_H_INCLUDED
+#include <stddef.h>
+#include "lnag-utils.h"
+
+/**
+ * @file arena.h
+ * @brief Bump allocator for short-lived data
+ *
+ * An arena hands out memory from large chunks and never frees
+ * anything on its own. Everything allocated from it is released in
+ * one go with arena_reset(), which is meant to be called once a batch
+ * of work is done. If a batch needed more than one chunk, the next
+ * batch gets a single chunk big enough for all of it, so an arena
+ * that's reused for similar work soon stops calling malloc() at all.
+ *
+ * @{
+ */
+
+NAGIOS_BEGIN_DECL
+
+/** Primary (opaque) type for this api */
+typedef struct arena arena;
+
+/**
+ * Create an arena
+ * @param[in] chunk_size Size of the first chunk
+ * @return A new arena on success, NULL on errors
+ */
+extern arena *arena_create(size_t chunk_size);
+
+/**
+ * Destroy an arena and everything allocated from it
+ * @param[in] a The arena to destroy
+ */
+extern void arena_destroy(arena *a);
+
+/**
+ * Allocate memory from an arena. The memory is 8-byte aligned
+ * and not initialized.
+ * @param[in] a The arena to allocate from
+ * @param[in] size Number of bytes to allocate
+ * @return Pointer to the memory on success, NULL on errors
+ */
+extern void *arena_alloc(arena *a, size_t size);
+
+/**
+ * Copy a string into an arena
+ * @param[in] a The arena to allocate from
+ * @param[in] str The string to copy. May be NULL
+ * @return The copy, or NULL if str is NULL or we're out of memory
+ */
+extern char *arena_strdup(arena *a, const char *str);
+
+/**
+ * Copy at most len bytes of a string into an arena, nul-terminated
+ * @param[in] a The arena to allocate from
+ * @param[in] str The string to copy
+ * @param[in] len Max number of bytes to copy
+ * @return The copy on success, NULL on errors
+ */
+extern char *arena_strndup(arena *a, const char *str, size_t len);
+
+/**
+ * Release everything allocated from an arena
+ * @param[in] a The arena to reset
+ */
+extern void arena_reset(arena *a);
+
+/**
+ * Get the number of bytes handed out since the last reset
+ * @param[in] a The arena
+ * @return Bytes in use, alignment padding included
+ */
+extern size_t arena_used(arena *a);
+
+/**
+ * Get the number of chunks an arena holds
+ * @param[in] a The arena
+ * @return The number of chunks
+ */
+extern unsigned int arena_chunks(arena *a);
+
+NAGIOS_END_DECL
+/** @} */
+#endif
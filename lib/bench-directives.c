@@ -0,0 +1,287 @@
+/*
+ * Compares the per-line cost of identifying config directives the way
+ * the object and main config parsers used to, by running the variable
+ * through the strcmp() chain for its object type, with looking it up
+ * in the generated perfect hash and comparing integer codes instead.
+ *
+ * Both sides split the line into variable and value first, so the
+ * numbers are what each line costs up to the point where the parser
+ * knows which directive it's looking at. The chains below are in the
+ * order the parsers test them, and the lines are a mix of what host,
+ * service and main config definitions usually contain, including
+ * custom variables, which never match and so walk the entire chain.
+ *
+ * Usage: bench-directives [lines]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include "nsutils.h"
+
+#include "../xdata/xoddir-phash.h"
+/* both generated headers define the same gperf size macros */
+#undef TOTAL_KEYWORDS
+#undef MIN_WORD_LENGTH
+#undef MAX_WORD_LENGTH
+#undef MIN_HASH_VALUE
+#undef MAX_HASH_VALUE
+#include "../base/mainconf-phash.h"
+
+static const char *host_chain[] = {
+	"use", "name", "host_name", "display_name", "alias", "address", "parents",
+	"host_groups", "hostgroups", "contact_groups", "contacts", "notification_period",
+	"check_command", "check_period", "event_handler", "event_handler_period",
+	"failure_prediction_options", "notes", "notes_url", "action_url", "icon_image",
+	"icon_image_alt", "vrml_image", "gd2_image", "statusmap_image", "initial_state",
+	"check_interval", "normal_check_interval", "retry_interval", "retry_check_interval",
+	"importance", "hourly_value", "max_check_attempts", "checks_enabled",
+	"active_checks_enabled", "passive_checks_enabled", "event_handler_enabled",
+	"check_freshness", "freshness_threshold", "low_flap_threshold", "high_flap_threshold",
+	"flap_detection_enabled", "flap_detection_options", "notification_options",
+	"notifications_enabled", "notification_interval", "first_notification_delay",
+	"stalking_options", "process_perf_data", "failure_prediction_enabled", "2d_coords",
+	"3d_coords", "obsess_over_host", "obsess", "retain_status_information",
+	"retain_nonstatus_information", "register", NULL
+};
+
+static const char *service_chain[] = {
+	"use", "name", "host", "hosts", "host_name", "service_description", "description",
+	"display_name", "parents", "hostgroup", "hostgroups", "hostgroup_name",
+	"service_groups", "servicegroups", "check_command", "check_period", "event_handler",
+	"event_handler_period", "notification_period", "contact_groups", "contacts",
+	"failure_prediction_options", "notes", "notes_url", "action_url", "icon_image",
+	"icon_image_alt", "initial_state", "importance", "hourly_value", "max_check_attempts",
+	"check_interval", "normal_check_interval", "retry_interval", "retry_check_interval",
+	"active_checks_enabled", "passive_checks_enabled", "parallelize_check", "is_volatile",
+	"obsess_over_service", "obsess", "event_handler_enabled", "check_freshness",
+	"freshness_threshold", "low_flap_threshold", "high_flap_threshold",
+	"flap_detection_enabled", "flap_detection_options", "notification_options",
+	"notifications_enabled", "notification_interval", "first_notification_delay",
+	"stalking_options", "process_perf_data", "failure_prediction_enabled",
+	"retain_status_information", "retain_nonstatus_information", "register", NULL
+};
+
+/* the exact-match part of read_main_config_file() */
+static const char *mainconf_chain[] = {
+	"resource_file", "website_url", "loadctl_options", "check_workers", "event_queue_type",
+	"event_batch_size", "object_config_threads", "check_result_threads",
+	"worker_use_posix_spawn", "worker_shm_ring_size", "use_log_thread",
+	"log_thread_buffer_size", "log_overflow_policy", "log_fsync_policy", "trace_buffer_size",
+	"query_socket", "log_file", "debug_level", "debug_verbosity", "debug_file",
+	"max_debug_file_size", "command_file", "temp_file", "temp_path", "check_result_path",
+	"max_check_result_file_age", "lock_file", "global_host_event_handler",
+	"global_service_event_handler", "ocsp_command", "ochp_command", "nagios_user",
+	"nagios_group", "admin_email", "admin_pager", "use_syslog", "log_notifications",
+	"log_service_retries", "log_host_retries", "log_event_handlers", "log_external_commands",
+	"log_passive_checks", "log_initial_states", "log_current_states",
+	"retain_state_information", "retention_update_interval", "retention_save_mode",
+	"retention_journal", "retention_journal_sync_interval", "retention_journal_max_size",
+	"use_retained_program_state", "use_retained_scheduling_info",
+	"retention_scheduling_horizon", "additional_freshness_latency",
+	"retained_host_attribute_mask", "retained_service_attribute_mask",
+	"retained_process_host_attribute_mask", "retained_process_service_attribute_mask",
+	"retained_contact_host_attribute_mask", "retained_contact_service_attribute_mask",
+	"obsess_over_services", "obsess_over_hosts", "translate_passive_host_checks",
+	"passive_host_checks_are_soft", "service_check_timeout", "service_check_timeout_state",
+	"host_check_timeout", "event_handler_timeout", "notification_timeout", "ocsp_timeout",
+	"ochp_timeout", "use_agressive_host_checking", "use_aggressive_host_checking",
+	"cached_host_check_horizon", "enable_predictive_host_dependency_checks",
+	"cached_service_check_horizon", "enable_predictive_service_dependency_checks",
+	"soft_state_dependencies", "log_rotation_method", "log_archive_path",
+	"enable_event_handlers", "enable_notifications", "execute_service_checks",
+	"accept_passive_service_checks", "execute_host_checks", "accept_passive_host_checks",
+	"service_inter_check_delay_method", "max_service_check_spread",
+	"host_inter_check_delay_method", "max_host_check_spread", "service_interleave_factor",
+	"max_concurrent_checks", "check_result_reaper_frequency", "service_reaper_frequency",
+	"max_check_result_reaper_time", "sleep_time", "interval_length",
+	"check_external_commands", "command_check_interval", "check_for_orphaned_services",
+	"check_for_orphaned_hosts", "check_service_freshness", "check_host_freshness",
+	"service_freshness_check_interval", "freshness_check_interval",
+	"host_freshness_check_interval", "auto_reschedule_checks", "auto_rescheduling_interval",
+	"auto_rescheduling_window", "status_update_interval", "time_change_threshold",
+	"process_performance_data", "enable_flap_detection", "enable_failure_prediction",
+	"low_service_flap_threshold", "high_service_flap_threshold", "low_host_flap_threshold",
+	"high_host_flap_threshold", "date_format", "use_timezone", "event_broker_options",
+	"illegal_object_name_chars", "illegal_macro_output_chars", "broker_module",
+	"use_regexp_matching", "use_true_regexp_matching", "daemon_dumps_core",
+	"use_large_installation_tweaks", "enable_environment_macros", "environment_macros",
+	"free_child_process_memory", "child_processes_fork_twice", "enable_embedded_perl",
+	"use_embedded_perl_implicitly", "auth_file", "p1_file", "external_command_buffer_slots",
+	"check_for_updates", "bare_update_check", "status_file", "status_binary_file",
+	"perfdata_timeout", "host_perfdata_command", "service_perfdata_command",
+	"host_perfdata_file_template", "service_perfdata_file_template", "host_perfdata_file",
+	"service_perfdata_file", "host_perfdata_file_mode", "service_perfdata_file_mode",
+	"host_perfdata_file_processing_interval", "service_perfdata_file_processing_interval",
+	"host_perfdata_file_processing_command", "service_perfdata_file_processing_command",
+	"host_perfdata_process_empty_results", "service_perfdata_process_empty_results",
+	"binary_object_precache", "allow_empty_hostgroup_assignment",
+	"host_down_disable_service_checks", "service_skip_check_dependency_status",
+	"service_skip_check_parent_status", "service_skip_check_host_down_status",
+	"host_skip_check_dependency_status", NULL
+};
+
+static const char *host_lines[] = {
+	"host_name\tweb-042.dc1.example.com",
+	"alias\t\tWeb server 42",
+	"address\t\t10.1.4.42",
+	"use\t\tgeneric-linux-host",
+	"parents\t\tsw-dc1-r12",
+	"hostgroups\tweb-servers,dc1",
+	"contact_groups\tweb-admins",
+	"notes_url\thttps://wiki.example.com/hosts/web-042",
+	"_SNMP_COMMUNITY\tpublic",
+	"register\t1",
+};
+
+static const char *service_lines[] = {
+	"use\t\t\tgeneric-service",
+	"host_name\t\tweb-042.dc1.example.com",
+	"service_description\tHTTP response time",
+	"check_command\t\tcheck_http!-u /health -w 2 -c 5",
+	"servicegroups\t\thttp-checks",
+	"contact_groups\t\tweb-admins",
+	"max_check_attempts\t3",
+	"check_interval\t\t5",
+	"retry_interval\t\t1",
+	"notification_interval\t60",
+	"notes\t\t\tOwned by the web team",
+	"_RUNBOOK\t\thttps://wiki.example.com/runbooks/http",
+};
+
+static const char *mainconf_lines[] = {
+	"log_file=/usr/local/nagios/var/nagios.log",
+	"object_cache_file=/usr/local/nagios/var/objects.cache",
+	"status_file=/usr/local/nagios/var/status.dat",
+	"nagios_user=nagios",
+	"check_external_commands=1",
+	"command_file=/usr/local/nagios/var/rw/nagios.cmd",
+	"lock_file=/usr/local/nagios/var/nagios.lock",
+	"retention_update_interval=60",
+	"service_check_timeout=60",
+	"max_concurrent_checks=0",
+	"check_result_reaper_frequency=10",
+	"interval_length=60",
+	"enable_flap_detection=1",
+	"illegal_macro_output_chars=`~$&|'\"<>",
+	"use_large_installation_tweaks=0",
+	"host_perfdata_file_processing_interval=0",
+	"allow_empty_hostgroup_assignment=0",
+	"host_skip_check_dependency_status=-1",
+};
+
+#define NLINES(a) (sizeof(a) / sizeof(a[0]))
+
+typedef int (*lookup_fn)(const char *var, size_t len);
+
+static unsigned int num_lines = 5000000;
+static volatile int sink;
+
+static int xoddir_code(const char *var, size_t len)
+{
+	struct xoddir_key *key = xoddir_get_key(var, len);
+	return key ? key->code : -1;
+}
+
+static int mainconf_code(const char *var, size_t len)
+{
+	struct mainconf_key *key = mainconf_get_key(var, len);
+	return key ? key->code : -1;
+}
+
+/* splits a line in place the way the parsers do, returning the variable length */
+static size_t split_line(char *buf, char sep, char **value)
+{
+	size_t x;
+
+	for (x = 0; buf[x] && buf[x] != sep && (sep != ' ' || buf[x] != '\t'); x++)
+		;
+	*value = buf[x] ? buf + x + 1 : buf + x;
+	buf[x] = 0;
+	while (**value == ' ' || **value == '\t')
+		(*value)++;
+
+	return x;
+}
+
+/* the old way: walk the chain with strcmp() until something matches */
+static float bench_strcmp(const char **lines, unsigned int nlines, const char **chain, char sep)
+{
+	struct timeval start, stop;
+	unsigned int i, c;
+	char buf[256], *value;
+
+	gettimeofday(&start, NULL);
+	for (i = 0; i < num_lines; i++) {
+		strcpy(buf, lines[i % nlines]);
+		split_line(buf, sep, &value);
+		for (c = 0; chain[c] && strcmp(buf, chain[c]); c++)
+			;
+		sink = c;
+	}
+	gettimeofday(&stop, NULL);
+
+	return tv_delta_f(&start, &stop);
+}
+
+/* the new way: one hash lookup, then the same chain on integer codes */
+static float bench_phash(const char **lines, unsigned int nlines, const int *codes, lookup_fn lookup, char sep)
+{
+	struct timeval start, stop;
+	unsigned int i, c;
+	char buf[256], *value;
+	int code;
+
+	gettimeofday(&start, NULL);
+	for (i = 0; i < num_lines; i++) {
+		size_t len;
+		strcpy(buf, lines[i % nlines]);
+		len = split_line(buf, sep, &value);
+		code = lookup(buf, len);
+		for (c = 0; codes[c] != -2 && codes[c] != code; c++)
+			;
+		sink = c;
+	}
+	gettimeofday(&stop, NULL);
+
+	return tv_delta_f(&start, &stop);
+}
+
+static void bench_set(const char *name, const char **lines, unsigned int nlines, const char **chain, lookup_fn lookup, char sep)
+{
+	float before, after;
+	int codes[256];
+	unsigned int c;
+
+	for (c = 0; chain[c]; c++) {
+		if ((codes[c] = lookup(chain[c], strlen(chain[c]))) < 0) {
+			fprintf(stderr, "'%s' is missing from the %s hash\n", chain[c], name);
+			exit(EXIT_FAILURE);
+		}
+	}
+	codes[c] = -2;
+
+	before = bench_strcmp(lines, nlines, chain, sep);
+	after = bench_phash(lines, nlines, codes, lookup, sep);
+
+	printf("%-10s %10.1f %10.1f   (%.1fx)\n", name,
+	       before * 1e9 / num_lines, after * 1e9 / num_lines, before / after);
+}
+
+int main(int argc, char **argv)
+{
+	if (argc > 1)
+		num_lines = strtoul(argv[1], NULL, 0);
+	if (!num_lines) {
+		fprintf(stderr, "Usage: %s [lines]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	printf("%u lines per set, ns per line\n", num_lines);
+	printf("%-10s %10s %10s\n", "set", "strcmp", "phash");
+	bench_set("host", host_lines, NLINES(host_lines), host_chain, xoddir_code, ' ');
+	bench_set("service", service_lines, NLINES(service_lines), service_chain, xoddir_code, ' ');
+	bench_set("nagios.cfg", mainconf_lines, NLINES(mainconf_lines), mainconf_chain, mainconf_code, '=');
+
+	return EXIT_SUCCESS;
+}
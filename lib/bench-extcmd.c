@@ -0,0 +1,221 @@
+/*
+ * Compares the per-command cost of picking apart external commands the
+ * way process_external_command1() and the passive check result handlers
+ * used to, with the way they do it now.
+ *
+ * The old way copies the line, copies the command name and arguments
+ * out of that, walks the strcasecmp() chain to find the command, then
+ * copies the arguments once more to split them and duplicates the host
+ * and service names. The new way splits the line where it lies, looks
+ * the name up in the generated perfect hash and puts the separators
+ * back afterwards. The output is copied either way, so that part is
+ * left out. Most lines are passive service check results, which is
+ * what busy command pipes mostly carry.
+ *
+ * Usage: bench-extcmd [commands]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/time.h>
+#include "nsutils.h"
+
+#include "../include/common.h"
+#include "../base/extcmd-phash.h"
+
+/* the names in the order process_external_command1() used to test them */
+static const char *chain[] = {
+	"ENTER_STANDBY_MODE", "DISABLE_NOTIFICATIONS", "ENTER_ACTIVE_MODE",
+	"ENABLE_NOTIFICATIONS", "SHUTDOWN_PROGRAM", "SHUTDOWN_PROCESS",
+	"RESTART_PROGRAM", "RESTART_PROCESS", "SAVE_STATE_INFORMATION",
+	"READ_STATE_INFORMATION", "ENABLE_EVENT_HANDLERS", "DISABLE_EVENT_HANDLERS",
+	"ENABLE_PERFORMANCE_DATA", "DISABLE_PERFORMANCE_DATA",
+	"START_EXECUTING_HOST_CHECKS", "STOP_EXECUTING_HOST_CHECKS",
+	"START_EXECUTING_SVC_CHECKS", "STOP_EXECUTING_SVC_CHECKS",
+	"START_ACCEPTING_PASSIVE_HOST_CHECKS", "STOP_ACCEPTING_PASSIVE_HOST_CHECKS",
+	"START_ACCEPTING_PASSIVE_SVC_CHECKS", "STOP_ACCEPTING_PASSIVE_SVC_CHECKS",
+	"START_OBSESSING_OVER_HOST_CHECKS", "STOP_OBSESSING_OVER_HOST_CHECKS",
+	"START_OBSESSING_OVER_SVC_CHECKS", "STOP_OBSESSING_OVER_SVC_CHECKS",
+	"ENABLE_FLAP_DETECTION", "DISABLE_FLAP_DETECTION",
+	"CHANGE_GLOBAL_HOST_EVENT_HANDLER", "CHANGE_GLOBAL_SVC_EVENT_HANDLER",
+	"ENABLE_SERVICE_FRESHNESS_CHECKS", "DISABLE_SERVICE_FRESHNESS_CHECKS",
+	"ENABLE_HOST_FRESHNESS_CHECKS", "DISABLE_HOST_FRESHNESS_CHECKS",
+	"ADD_HOST_COMMENT", "DEL_HOST_COMMENT", "DEL_ALL_HOST_COMMENTS",
+	"DELAY_HOST_NOTIFICATION", "ENABLE_HOST_NOTIFICATIONS",
+	"DISABLE_HOST_NOTIFICATIONS", "ENABLE_ALL_NOTIFICATIONS_BEYOND_HOST",
+	"DISABLE_ALL_NOTIFICATIONS_BEYOND_HOST", "ENABLE_HOST_AND_CHILD_NOTIFICATIONS",
+	"DISABLE_HOST_AND_CHILD_NOTIFICATIONS", "ENABLE_HOST_SVC_NOTIFICATIONS",
+	"DISABLE_HOST_SVC_NOTIFICATIONS", "ENABLE_HOST_SVC_CHECKS",
+	"DISABLE_HOST_SVC_CHECKS", "ENABLE_PASSIVE_HOST_CHECKS",
+	"DISABLE_PASSIVE_HOST_CHECKS", "SCHEDULE_HOST_SVC_CHECKS",
+	"SCHEDULE_FORCED_HOST_SVC_CHECKS", "ACKNOWLEDGE_HOST_PROBLEM",
+	"REMOVE_HOST_ACKNOWLEDGEMENT", "ENABLE_HOST_EVENT_HANDLER",
+	"DISABLE_HOST_EVENT_HANDLER", "ENABLE_HOST_CHECK", "DISABLE_HOST_CHECK",
+	"SCHEDULE_HOST_CHECK", "SCHEDULE_FORCED_HOST_CHECK", "SCHEDULE_HOST_DOWNTIME",
+	"SCHEDULE_HOST_SVC_DOWNTIME", "DEL_HOST_DOWNTIME", "DEL_DOWNTIME_BY_HOST_NAME",
+	"DEL_DOWNTIME_BY_HOSTGROUP_NAME", "DEL_DOWNTIME_BY_START_TIME_COMMENT",
+	"ENABLE_HOST_FLAP_DETECTION", "DISABLE_HOST_FLAP_DETECTION",
+	"START_OBSESSING_OVER_HOST", "STOP_OBSESSING_OVER_HOST",
+	"CHANGE_HOST_EVENT_HANDLER", "CHANGE_HOST_EVENT_HANDLER_TIMEPERIOD",
+	"CHANGE_HOST_CHECK_COMMAND", "CHANGE_NORMAL_HOST_CHECK_INTERVAL",
+	"CHANGE_RETRY_HOST_CHECK_INTERVAL", "CHANGE_MAX_HOST_CHECK_ATTEMPTS",
+	"SCHEDULE_AND_PROPAGATE_TRIGGERED_HOST_DOWNTIME",
+	"SCHEDULE_AND_PROPAGATE_HOST_DOWNTIME", "SET_HOST_NOTIFICATION_NUMBER",
+	"CHANGE_HOST_CHECK_TIMEPERIOD", "CHANGE_CUSTOM_HOST_VAR",
+	"SEND_CUSTOM_HOST_NOTIFICATION", "CHANGE_HOST_NOTIFICATION_TIMEPERIOD",
+	"CHANGE_HOST_MODATTR", "CLEAR_HOST_FLAPPING_STATE",
+	"ENABLE_HOSTGROUP_HOST_NOTIFICATIONS", "DISABLE_HOSTGROUP_HOST_NOTIFICATIONS",
+	"ENABLE_HOSTGROUP_SVC_NOTIFICATIONS", "DISABLE_HOSTGROUP_SVC_NOTIFICATIONS",
+	"ENABLE_HOSTGROUP_HOST_CHECKS", "DISABLE_HOSTGROUP_HOST_CHECKS",
+	"ENABLE_HOSTGROUP_PASSIVE_HOST_CHECKS", "DISABLE_HOSTGROUP_PASSIVE_HOST_CHECKS",
+	"ENABLE_HOSTGROUP_SVC_CHECKS", "DISABLE_HOSTGROUP_SVC_CHECKS",
+	"ENABLE_HOSTGROUP_PASSIVE_SVC_CHECKS", "DISABLE_HOSTGROUP_PASSIVE_SVC_CHECKS",
+	"SCHEDULE_HOSTGROUP_HOST_DOWNTIME", "SCHEDULE_HOSTGROUP_SVC_DOWNTIME",
+	"ADD_SVC_COMMENT", "DEL_SVC_COMMENT", "DEL_ALL_SVC_COMMENTS",
+	"SCHEDULE_SVC_CHECK", "SCHEDULE_FORCED_SVC_CHECK", "ENABLE_SVC_CHECK",
+	"DISABLE_SVC_CHECK", "ENABLE_PASSIVE_SVC_CHECKS", "DISABLE_PASSIVE_SVC_CHECKS",
+	"DELAY_SVC_NOTIFICATION", "ENABLE_SVC_NOTIFICATIONS",
+	"DISABLE_SVC_NOTIFICATIONS", "PROCESS_SERVICE_CHECK_RESULT",
+	"PROCESS_HOST_CHECK_RESULT", "ENABLE_SVC_EVENT_HANDLER",
+	"DISABLE_SVC_EVENT_HANDLER", "ENABLE_SVC_FLAP_DETECTION",
+	"DISABLE_SVC_FLAP_DETECTION", "SCHEDULE_SVC_DOWNTIME", "DEL_SVC_DOWNTIME",
+	"ACKNOWLEDGE_SVC_PROBLEM", "REMOVE_SVC_ACKNOWLEDGEMENT",
+	"START_OBSESSING_OVER_SVC", "STOP_OBSESSING_OVER_SVC",
+	"CHANGE_SVC_EVENT_HANDLER", "CHANGE_SVC_EVENT_HANDLER_TIMEPERIOD",
+	"CHANGE_SVC_CHECK_COMMAND", "CHANGE_NORMAL_SVC_CHECK_INTERVAL",
+	"CHANGE_RETRY_SVC_CHECK_INTERVAL", "CHANGE_MAX_SVC_CHECK_ATTEMPTS",
+	"SET_SVC_NOTIFICATION_NUMBER", "CHANGE_SVC_CHECK_TIMEPERIOD",
+	"CHANGE_CUSTOM_SVC_VAR", "CHANGE_CUSTOM_CONTACT_VAR",
+	"SEND_CUSTOM_SVC_NOTIFICATION", "CHANGE_SVC_NOTIFICATION_TIMEPERIOD",
+	"CHANGE_SVC_MODATTR", "CLEAR_SVC_FLAPPING_STATE",
+	"ENABLE_SERVICEGROUP_HOST_NOTIFICATIONS",
+	"DISABLE_SERVICEGROUP_HOST_NOTIFICATIONS",
+	"ENABLE_SERVICEGROUP_SVC_NOTIFICATIONS",
+	"DISABLE_SERVICEGROUP_SVC_NOTIFICATIONS", "ENABLE_SERVICEGROUP_HOST_CHECKS",
+	"DISABLE_SERVICEGROUP_HOST_CHECKS", "ENABLE_SERVICEGROUP_PASSIVE_HOST_CHECKS",
+	"DISABLE_SERVICEGROUP_PASSIVE_HOST_CHECKS", "ENABLE_SERVICEGROUP_SVC_CHECKS",
+	"DISABLE_SERVICEGROUP_SVC_CHECKS", "ENABLE_SERVICEGROUP_PASSIVE_SVC_CHECKS",
+	"DISABLE_SERVICEGROUP_PASSIVE_SVC_CHECKS", "SCHEDULE_SERVICEGROUP_HOST_DOWNTIME",
+	"SCHEDULE_SERVICEGROUP_SVC_DOWNTIME", "ENABLE_CONTACT_HOST_NOTIFICATIONS",
+	"DISABLE_CONTACT_HOST_NOTIFICATIONS", "ENABLE_CONTACT_SVC_NOTIFICATIONS",
+	"DISABLE_CONTACT_SVC_NOTIFICATIONS",
+	"CHANGE_CONTACT_HOST_NOTIFICATION_TIMEPERIOD",
+	"CHANGE_CONTACT_SVC_NOTIFICATION_TIMEPERIOD", "CHANGE_CONTACT_MODATTR",
+	"CHANGE_CONTACT_MODHATTR", "CHANGE_CONTACT_MODSATTR",
+	"ENABLE_CONTACTGROUP_HOST_NOTIFICATIONS",
+	"DISABLE_CONTACTGROUP_HOST_NOTIFICATIONS",
+	"ENABLE_CONTACTGROUP_SVC_NOTIFICATIONS",
+	"DISABLE_CONTACTGROUP_SVC_NOTIFICATIONS", "PROCESS_FILE", NULL
+};
+
+static const char *cmd_lines[] = {
+	"[1700000000] PROCESS_SERVICE_CHECK_RESULT;web-042.dc1.example.com;HTTP;0;HTTP OK: 200 in 0.012s|time=0.012s",
+	"[1700000000] PROCESS_SERVICE_CHECK_RESULT;web-042.dc1.example.com;Disk /var;0;DISK OK - 42% used",
+	"[1700000000] PROCESS_SERVICE_CHECK_RESULT;web-042.dc1.example.com;Load;1;WARNING - load average: 4.1, 3.2, 2.9",
+	"[1700000000] PROCESS_SERVICE_CHECK_RESULT;db-007.dc2.example.com;Replication lag;0;OK - 0s behind",
+	"[1700000000] PROCESS_SERVICE_CHECK_RESULT;db-007.dc2.example.com;Connections;0;OK - 112 of 500",
+	"[1700000000] PROCESS_SERVICE_CHECK_RESULT;db-007.dc2.example.com;Swap;0;SWAP OK - 99% free",
+	"[1700000000] PROCESS_HOST_CHECK_RESULT;sw-dc1-r12;0;PING OK - rtt 0.3ms",
+	"[1700000000] ACKNOWLEDGE_SVC_PROBLEM;db-007.dc2.example.com;Swap;2;1;1;ops;Looking into it",
+	"[1700000000] SCHEDULE_FORCED_SVC_CHECK;web-042.dc1.example.com;HTTP;1700000060",
+	"[1700000000] PROCESS_SERVICE_CHECK_RESULT;web-043.dc1.example.com;HTTP;2;HTTP CRITICAL: connection refused",
+};
+
+#define NLINES(a) (sizeof(a) / sizeof(a[0]))
+
+static unsigned int num_cmds = 2000000;
+static volatile int sink;
+
+/* the old way, copying at every step */
+static float bench_copy(void)
+{
+	struct timeval start, stop;
+	unsigned int i, c;
+	char *line, *p, *id, *args, *copy, *host, *svc;
+
+	gettimeofday(&start, NULL);
+	for (i = 0; i < num_cmds; i++) {
+		line = strdup(cmd_lines[i % NLINES(cmd_lines)]);
+		p = strchr(line, ']');
+		*strchr(p, ';') = 0;
+		id = strdup(p + 2);
+		args = strdup(p + strlen(p) + 1);
+		for (c = 0; chain[c] && strcasecmp(id, chain[c]); c++)
+			;
+		copy = strdup(args);
+		p = strchr(copy, ';');
+		*p = 0;
+		host = strdup(copy);
+		svc = strdup(p + 1);
+		*strchr(svc, ';') = 0;
+		sink = c + host[0] + svc[0];
+		free(svc);
+		free(host);
+		free(copy);
+		free(args);
+		free(id);
+		free(line);
+	}
+	gettimeofday(&stop, NULL);
+
+	return tv_delta_f(&start, &stop);
+}
+
+/* the new way, splitting in place and putting the separators back */
+static float bench_inplace(void)
+{
+	struct timeval start, stop;
+	unsigned int i;
+	char buf[256], *p, *id, *semi, *s1, *s2;
+	struct extcmd_key *key;
+
+	gettimeofday(&start, NULL);
+	for (i = 0; i < num_cmds; i++) {
+		strcpy(buf, cmd_lines[i % NLINES(cmd_lines)]);
+		p = strchr(buf, ']');
+		id = p + 2;
+		semi = strchr(p, ';');
+		*semi = 0;
+		key = extcmd_get_key(id, semi - id);
+		s1 = strchr(semi + 1, ';');
+		*s1 = 0;
+		s2 = strchr(s1 + 1, ';');
+		*s2 = 0;
+		sink = (key ? key->code : -1) + semi[1] + s1[1];
+		*s2 = *s1 = *semi = ';';
+	}
+	gettimeofday(&stop, NULL);
+
+	return tv_delta_f(&start, &stop);
+}
+
+int main(int argc, char **argv)
+{
+	float before, after;
+	unsigned int c;
+
+	if (argc > 1)
+		num_cmds = strtoul(argv[1], NULL, 0);
+	if (!num_cmds) {
+		fprintf(stderr, "Usage: %s [commands]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	for (c = 0; chain[c]; c++) {
+		if (!extcmd_get_key(chain[c], strlen(chain[c]))) {
+			fprintf(stderr, "'%s' is missing from the command hash\n", chain[c]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	before = bench_copy();
+	after = bench_inplace();
+
+	printf("%u commands, ns per command\n", num_cmds);
+	printf("%10s %10s\n", "copy", "in-place");
+	printf("%10.1f %10.1f   (%.1fx)\n",
+	       before * 1e9 / num_cmds, after * 1e9 / num_cmds, before / after);
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,140 @@
+/*
+ * Compares the performance of the scheduling queue backends.
+ *
+ * The workload mimics what the Nagios core does with its event
+ * queue: a large number of recurring events spread out over the
+ * check interval, where the head of the queue is popped and then
+ * rescheduled one interval later, mixed with removal and re-adding
+ * of random events as happens when checks are rescheduled from
+ * the outside (external commands, retries, freshness checks).
+ *
+ * Usage: bench-squeue [events] [interval]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <time.h>
+#include "squeue.h"
+#include "nsutils.h"
+
+struct bench_event {
+	squeue_event *evt;
+};
+
+static struct bench_event *events;
+static unsigned int num_events = 1000000;
+static unsigned int interval = 300;
+
+static float bench_add(squeue_t *sq, time_t base)
+{
+	struct timeval start, stop;
+	unsigned int i;
+
+	gettimeofday(&start, NULL);
+	for (i = 0; i < num_events; i++) {
+		events[i].evt = squeue_add_usec(sq, base + (rand() % interval), rand() % 1000000, &events[i]);
+	}
+	gettimeofday(&stop, NULL);
+
+	return tv_delta_f(&start, &stop);
+}
+
+static float bench_reschedule(squeue_t *sq)
+{
+	struct timeval start, stop;
+	unsigned int i;
+
+	gettimeofday(&start, NULL);
+	for (i = 0; i < num_events; i++) {
+		struct bench_event *be;
+		struct timeval when;
+
+		be = squeue_peek(sq);
+		when = *squeue_event_runtime(be->evt);
+		squeue_pop(sq);
+		when.tv_sec += interval;
+		be->evt = squeue_add_tv(sq, &when, be);
+	}
+	gettimeofday(&stop, NULL);
+
+	return tv_delta_f(&start, &stop);
+}
+
+static float bench_remove_add(squeue_t *sq, time_t base)
+{
+	struct timeval start, stop;
+	unsigned int i;
+
+	gettimeofday(&start, NULL);
+	for (i = 0; i < num_events; i++) {
+		struct bench_event *be = &events[rand() % num_events];
+
+		squeue_remove(sq, be->evt);
+		be->evt = squeue_add_usec(sq, base + (rand() % interval), rand() % 1000000, be);
+	}
+	gettimeofday(&stop, NULL);
+
+	return tv_delta_f(&start, &stop);
+}
+
+static float bench_drain(squeue_t *sq)
+{
+	struct timeval start, stop;
+
+	gettimeofday(&start, NULL);
+	while (squeue_pop(sq))
+		;
+	gettimeofday(&stop, NULL);
+
+	return tv_delta_f(&start, &stop);
+}
+
+static void bench_type(int type)
+{
+	squeue_t *sq;
+	time_t base = time(NULL) + 60;
+	float add, resched, remove_add, drain;
+
+	srand(1);
+	sq = squeue_create_type(num_events, type);
+	if (!sq) {
+		fprintf(stderr, "Failed to create %s queue\n", squeue_type_name(type));
+		exit(EXIT_FAILURE);
+	}
+
+	add = bench_add(sq, base);
+	resched = bench_reschedule(sq);
+	remove_add = bench_remove_add(sq, base + interval);
+	drain = bench_drain(sq);
+	squeue_destroy(sq, 0);
+
+	printf("%-6s %10.3f %10.3f %10.3f %10.3f   (%.0f ns/op)\n",
+	       squeue_type_name(type), add, resched, remove_add, drain,
+	       (add + resched + remove_add + drain) * 1e9 / (num_events * 4.0));
+}
+
+int main(int argc, char **argv)
+{
+	if (argc > 1)
+		num_events = strtoul(argv[1], NULL, 0);
+	if (argc > 2)
+		interval = strtoul(argv[2], NULL, 0);
+	if (!num_events || !interval) {
+		fprintf(stderr, "Usage: %s [events] [interval]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	events = calloc(num_events, sizeof(*events));
+	if (!events) {
+		fprintf(stderr, "Failed to allocate %u events\n", num_events);
+		return EXIT_FAILURE;
+	}
+
+	printf("%u events over a %us interval, times in seconds\n", num_events, interval);
+	printf("%-6s %10s %10s %10s %10s\n", "type", "add", "resched", "remove+add", "drain");
+	bench_type(SQUEUE_TYPE_HEAP);
+	bench_type(SQUEUE_TYPE_WHEEL);
+
+	free(events);
+	return EXIT_SUCCESS;
+}
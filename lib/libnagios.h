@@ -17,6 +17,10 @@
 #include "runcmd.h"
 #include "bitmap.h"
 #include "dkhash.h"
+#include "arena.h"
+#include "shmring.h"
+#include "mpscring.h"
+#include "tracering.h"
 #include "worker.h"
 #include "skiplist.h"
 #include "nsock.h"
@@ -0,0 +1,147 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "mpscring.h"
+
+#define MPSCRING_ALIGN(x) (((x) + 7) & ~7UL)
+
+/* record states. Free space is always zeroed */
+#define REC_PENDING   0
+#define REC_COMMITTED 1
+#define REC_PADDING   2
+
+struct mpscring_rec {
+	uint32_t len;
+	uint32_t state;
+};
+
+struct mpscring {
+	unsigned long size;
+	unsigned long mask;
+	char *buf;
+	/* keep producers and the consumer off each other's cache lines */
+	char pad0[64];
+	unsigned long head;     /* reserved up to here (producers) */
+	char pad1[64];
+	unsigned long tail;     /* consumed up to here (consumer) */
+	unsigned long peeked;   /* end of the record last peeked at */
+};
+
+mpscring *mpscring_create(unsigned long size)
+{
+	mpscring *r;
+	unsigned long rsize = 64;
+
+	while (rsize < size)
+		rsize <<= 1;
+
+	if (!(r = calloc(1, sizeof(*r))))
+		return NULL;
+	if (!(r->buf = calloc(1, rsize))) {
+		free(r);
+		return NULL;
+	}
+	r->size = rsize;
+	r->mask = rsize - 1;
+
+	return r;
+}
+
+void mpscring_destroy(mpscring *r)
+{
+	if (!r)
+		return;
+	free(r->buf);
+	free(r);
+}
+
+void *mpscring_reserve(mpscring *r, unsigned long len)
+{
+	unsigned long head, tail, off, pad, need;
+	struct mpscring_rec *rec;
+
+	need = MPSCRING_ALIGN(sizeof(*rec) + len);
+	if (need > r->size || len > UINT32_MAX)
+		return NULL;
+
+	head = __atomic_load_n(&r->head, __ATOMIC_RELAXED);
+	do {
+		tail = __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE);
+		off = head & r->mask;
+		/* records don't wrap, so skip what's left at the end */
+		pad = r->size - off < need ? r->size - off : 0;
+		if (head + pad + need - tail > r->size)
+			return NULL;
+	} while (!__atomic_compare_exchange_n(&r->head, &head, head + pad + need, 1, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED));
+
+	if (pad) {
+		rec = (struct mpscring_rec *)(r->buf + off);
+		rec->len = pad - sizeof(*rec);
+		__atomic_store_n(&rec->state, REC_PADDING, __ATOMIC_RELEASE);
+		off = 0;
+	}
+
+	rec = (struct mpscring_rec *)(r->buf + off);
+	rec->len = len;
+	return rec + 1;
+}
+
+void mpscring_commit(mpscring *r, void *ptr)
+{
+	struct mpscring_rec *rec = (struct mpscring_rec *)ptr - 1;
+
+	__atomic_store_n(&rec->state, REC_COMMITTED, __ATOMIC_RELEASE);
+}
+
+/*
+ * Space handed back to producers must be zeroed, since a record
+ * that's being reserved reads as pending until its producer gets
+ * around to writing its header.
+ */
+static void release(mpscring *r, struct mpscring_rec *rec, unsigned long end)
+{
+	memset(rec, 0, end - r->tail);
+	__atomic_store_n(&r->tail, end, __ATOMIC_RELEASE);
+}
+
+void *mpscring_peek(mpscring *r, unsigned long *len)
+{
+	struct mpscring_rec *rec;
+	uint32_t state;
+
+	for (;;) {
+		if (r->tail == __atomic_load_n(&r->head, __ATOMIC_ACQUIRE))
+			return NULL;
+
+		rec = (struct mpscring_rec *)(r->buf + (r->tail & r->mask));
+		state = __atomic_load_n(&rec->state, __ATOMIC_ACQUIRE);
+		if (state == REC_PENDING)
+			return NULL;
+
+		r->peeked = r->tail + MPSCRING_ALIGN(sizeof(*rec) + rec->len);
+		if (state == REC_COMMITTED)
+			break;
+		release(r, rec, r->peeked);
+	}
+
+	if (len)
+		*len = rec->len;
+	return rec + 1;
+}
+
+void mpscring_consume(mpscring *r)
+{
+	if (r->peeked <= r->tail)
+		return;
+	release(r, (struct mpscring_rec *)(r->buf + (r->tail & r->mask)), r->peeked);
+}
+
+unsigned long mpscring_size(mpscring *r)
+{
+	return r->size;
+}
+
+unsigned long mpscring_used(mpscring *r)
+{
+	return __atomic_load_n(&r->head, __ATOMIC_RELAXED) - __atomic_load_n(&r->tail, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,91 @@
+#ifndef LIBNAGIOS_MPSCRING_H_INCLUDED
+#define LIBNAGIOS_MPSCRING_H_INCLUDED
+#include "lnag-utils.h"
+
+/**
+ * @file mpscring.h
+ * @brief Lock-free multi-producer, single-consumer ring buffer
+ *
+ * An mpscring is a ring of variable-sized records in ordinary memory,
+ * shared by the threads of one process. Any number of threads can
+ * reserve and commit records concurrently without taking a lock; a
+ * single consumer thread reads them back in the order they were
+ * reserved.
+ *
+ * A record that's reserved but not yet committed holds up the ones
+ * reserved after it, so producers should commit right away. Records
+ * are never split at the end of the ring and are 8-byte aligned.
+ *
+ * The ring doesn't block or wake anyone up. Producers get NULL from
+ * mpscring_reserve() when it's full, and it's up to the caller to
+ * decide whether to wait or to drop the record.
+ * @{
+ */
+
+NAGIOS_BEGIN_DECL
+
+/** Primary (opaque) type for this api */
+typedef struct mpscring mpscring;
+
+/**
+ * Create a ring
+ * @param[in] size Size of the ring. Rounded up to a power of 2
+ * @return A new ring on success, NULL on errors
+ */
+extern mpscring *mpscring_create(unsigned long size);
+
+/**
+ * Destroy a ring, along with any records still in it
+ * @param[in] r The ring to destroy
+ */
+extern void mpscring_destroy(mpscring *r);
+
+/**
+ * Reserve space for a record. Safe to call from any thread.
+ * @param[in] r The ring
+ * @param[in] len Length of the record
+ * @return Pointer to len bytes in the ring, or NULL if it's full
+ */
+extern void *mpscring_reserve(mpscring *r, unsigned long len);
+
+/**
+ * Publish a record to the consumer
+ * @param[in] r The ring
+ * @param[in] rec A record returned by mpscring_reserve()
+ */
+extern void mpscring_commit(mpscring *r, void *rec);
+
+/**
+ * Get the oldest record from the ring without removing it.
+ * Only the consumer may call this.
+ * @param[in] r The ring
+ * @param[out] len Length of the record
+ * @return The record, or NULL if the ring is empty or the oldest
+ *         record isn't committed yet
+ */
+extern void *mpscring_peek(mpscring *r, unsigned long *len);
+
+/**
+ * Remove the record last returned by mpscring_peek(), making room
+ * for producers. Only the consumer may call this.
+ * @param[in] r The ring
+ */
+extern void mpscring_consume(mpscring *r);
+
+/**
+ * Get the size of a ring
+ * @param[in] r The ring
+ * @return Size of the ring, in bytes
+ */
+extern unsigned long mpscring_size(mpscring *r);
+
+/**
+ * Get the number of bytes reserved and not yet consumed
+ * @param[in] r The ring
+ * @return Bytes in use, record headers and padding included
+ */
+extern unsigned long mpscring_used(mpscring *r);
+
+NAGIOS_END_DECL
+/** @} */
+#endif
@@ -23,8 +23,15 @@
 #include <sys/time.h>
 #include <sys/resource.h>
 #include <errno.h>
+#include <fcntl.h>
 #include "runcmd.h"
 
+#if defined(_POSIX_SPAWN) && _POSIX_SPAWN > 0
+# define RUNCMD_HAVE_SPAWN
+# include <spawn.h>
+extern char **environ;
+#endif
+
 
 /** macros **/
 #ifndef WEXITSTATUS
@@ -67,6 +74,9 @@ static int maxfd = 0;
 # endif /* _SC_OPEN_MAX */
 #endif /* OPEN_MAX */
 
+/* start children with posix_spawnp() rather than fork() */
+static int use_spawn = 0;
+
 
 const char *runcmd_strerror(int code)
 {
@@ -328,6 +338,117 @@ void runcmd_init(void)
 static int runcmd_setenv(const char *name, const char *value);
 int update_environment(char *name, char *value, int set);
 
+int runcmd_use_spawn(int enable)
+{
+#ifdef RUNCMD_HAVE_SPAWN
+	use_spawn = !!enable;
+	return 0;
+#else
+	return enable ? -1 : 0;
+#endif
+}
+
+#ifdef RUNCMD_HAVE_SPAWN
+/* is 'name=...' in env or among the first nvars assignments in argv? */
+static int runcmd_env_overridden(const char *var, char **env, char **argv, int nvars)
+{
+	size_t len = strcspn(var, "=");
+	int i;
+
+	for (; env && env[0] && env[1]; env += 2) {
+		if (!strncmp(env[0], var, len) && !env[0][len])
+			return 1;
+	}
+	for (i = 0; i < nvars; i++) {
+		if (!strncmp(argv[i], var, len) && argv[i][len] == '=')
+			return 1;
+	}
+	return 0;
+}
+
+/*
+ * Starts a command with posix_spawnp(). The child environment is
+ * our own, overridden by env and by any leading VAR=value words of
+ * a simple command, just like the fork() path sets it up.
+ * Returns the pid, or 0 if the caller should fall back to fork().
+ */
+static pid_t runcmd_spawn(char **argv, int argc, int is_simple, int *pfd, int *pfderr, char **env)
+{
+	posix_spawn_file_actions_t fa;
+	posix_spawnattr_t attr;
+	char **envp, *buf, *p;
+	size_t size = 0;
+	int nvars = 0, nenv = 0, i, n = 0;
+	pid_t pid = 0;
+
+	/* dup2() onto the same fd wouldn't clear close-on-exec */
+	if (pfd[1] == STDOUT_FILENO || pfderr[1] == STDERR_FILENO)
+		return 0;
+
+	if (is_simple) {
+		while (nvars < argc && strchr(argv[nvars], '='))
+			nvars++;
+		/* let the fork() path complain about this */
+		if (nvars == argc)
+			return 0;
+	}
+
+	for (i = 0; environ[i]; i++)
+		nenv++;
+	for (i = 0; env && env[i] && env[i + 1]; i += 2) {
+		nenv++;
+		size += strlen(env[i]) + strlen(env[i + 1]) + 2;
+	}
+	envp = malloc((nenv + nvars + 1) * sizeof(char *));
+	buf = p = malloc(size + 1);
+	if (!envp || !buf) {
+		free(envp);
+		free(buf);
+		return 0;
+	}
+
+	for (i = 0; environ[i]; i++) {
+		if (!runcmd_env_overridden(environ[i], env, argv, nvars))
+			envp[n++] = environ[i];
+	}
+	for (i = 0; env && env[i] && env[i + 1]; i += 2) {
+		if (runcmd_env_overridden(env[i], NULL, argv, nvars))
+			continue;
+		envp[n++] = p;
+		p += sprintf(p, "%s=%s", env[i], env[i + 1]) + 1;
+	}
+	for (i = 0; i < nvars; i++)
+		envp[n++] = argv[i];
+	envp[n] = NULL;
+
+	/* our end of the pipes (and those of other children) stay with us */
+	fcntl(pfd[0], F_SETFD, FD_CLOEXEC);
+	fcntl(pfd[1], F_SETFD, FD_CLOEXEC);
+	fcntl(pfderr[0], F_SETFD, FD_CLOEXEC);
+	fcntl(pfderr[1], F_SETFD, FD_CLOEXEC);
+
+	if (!posix_spawn_file_actions_init(&fa)) {
+		if (!posix_spawnattr_init(&attr)) {
+			/* children are their own process group leaders, as with fork() */
+			if (!posix_spawn_file_actions_adddup2(&fa, pfd[1], STDOUT_FILENO) &&
+			    !posix_spawn_file_actions_adddup2(&fa, pfderr[1], STDERR_FILENO) &&
+			    !posix_spawnattr_setpgroup(&attr, 0) &&
+			    !posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETPGROUP))
+			{
+				if (posix_spawnp(&pid, argv[nvars], &fa, &attr, argv + nvars, envp))
+					pid = 0;
+			}
+			posix_spawnattr_destroy(&attr);
+		}
+		posix_spawn_file_actions_destroy(&fa);
+	}
+
+	free(envp);
+	free(buf);
+	return pid;
+}
+#endif
+
 /* Start running a command */
 /* The definition declares nonnull arguments, so checking for these
    arguments as null results in a compiler warning. */
@@ -397,6 +518,11 @@ int runcmd_open(const char *cmd, int *pfd, int *pfderr, char **env,
 		iobreg(pfd[0], pfderr[0], iobregarg);
 	}
 
+#ifdef RUNCMD_HAVE_SPAWN
+	if (use_spawn && (pid = runcmd_spawn(argv, argc, !cmd2strv_errors, pfd, pfderr, env)) > 0)
+		goto spawned;
+#endif
+
 	pid = fork();
 	if (pid < 0) {
 		free(!cmd2strv_errors ? argv[0] : argv[2]);
@@ -492,6 +618,9 @@ child_error_exit:
 	}
 
 	/* parent picks up execution here */
+#ifdef RUNCMD_HAVE_SPAWN
+spawned:
+#endif
 	/*
 	 * close child's file descriptors in our address space and
 	 * release the memory we used that won't get passed to the
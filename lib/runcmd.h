@@ -103,6 +103,18 @@ extern int runcmd_close(int fd);
  */
 extern int runcmd_cmd2strv(const char *str, int *out_argc, char **out_argv);
 
+/**
+ * Make runcmd_open() start simple commands with posix_spawnp()
+ * rather than fork() + execvp(). posix_spawn() doesn't have to
+ * copy the caller's page tables, so this is a lot cheaper for
+ * processes with a large address space that start many commands.
+ * Commands that posix_spawnp() can't start are retried through
+ * fork(), so error output stays the same.
+ * @param[in] enable 1 to use posix_spawnp(), 0 to always fork()
+ * @return 0 on success, -1 if posix_spawn() isn't available
+ */
+extern int runcmd_use_spawn(int enable);
+
 /**
  * If you're using libnagios to execute a remote command, the 
  * static pid_t pids is not freed after runcmd_open
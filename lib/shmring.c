@@ -0,0 +1,360 @@
+#include <unistd.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include "shmring.h"
+
+#ifdef __linux__
+# include <sys/syscall.h>
+# include <sys/eventfd.h>
+# ifdef SYS_memfd_create
+#  define HAVE_SHMRING 1
+# endif
+#endif
+
+#define SHMRING_MAGIC 0x6e726e67 /* "nrng" */
+#define SHMRING_PAD   (1 << 0)   /* record is filler up to the end of the ring */
+#define SHMRING_ALIGN(x) (((x) + 7) & ~7UL)
+
+/*
+ * Lives at the start of the memfd. head is only written by the
+ * producer and tail only by the consumer, so they get a cacheline
+ * each to keep the two sides from fighting over it.
+ */
+struct shmring_hdr {
+	uint32_t magic;
+	uint32_t size;
+	char pad1[56];
+	unsigned long head;
+	char pad2[64 - sizeof(unsigned long)];
+	unsigned long tail;
+	char pad3[64 - sizeof(unsigned long)];
+};
+
+struct shmring_rec {
+	uint32_t len;
+	uint32_t flags;
+};
+
+struct shmring {
+	struct shmring_hdr *hdr;
+	char *data;
+	unsigned long size;
+	unsigned long mask;
+	int memfd;
+	int efd;
+	unsigned long reserved; /* producer: head after the reserved record */
+	unsigned long reserved_off; /* producer: where the reserved record starts */
+	unsigned long reserved_len;
+	unsigned long peeked; /* consumer: tail after the peeked record */
+};
+
+static unsigned long rec_size(unsigned long len)
+{
+	return sizeof(struct shmring_rec) + SHMRING_ALIGN(len);
+}
+
+static shmring *shmring_map(int memfd, int efd, unsigned long size)
+{
+	shmring *r;
+	void *mem;
+
+	if (!(r = calloc(1, sizeof(*r))))
+		return NULL;
+
+	mem = mmap(NULL, sizeof(struct shmring_hdr) + size, PROT_READ | PROT_WRITE, MAP_SHARED, memfd, 0);
+	if (mem == MAP_FAILED) {
+		free(r);
+		return NULL;
+	}
+
+	r->hdr = mem;
+	r->data = (char *)mem + sizeof(struct shmring_hdr);
+	r->size = size;
+	r->mask = size - 1;
+	r->memfd = memfd;
+	r->efd = efd;
+	return r;
+}
+
+#ifdef HAVE_SHMRING
+shmring *shmring_create(unsigned long size)
+{
+	shmring *r;
+	unsigned long real_size = 4096;
+	int memfd, efd;
+
+	while (real_size < size && real_size < (1UL << 30))
+		real_size <<= 1;
+
+	memfd = syscall(SYS_memfd_create, "nagios-shmring", 1 /* MFD_CLOEXEC */);
+	if (memfd < 0)
+		return NULL;
+	if (ftruncate(memfd, sizeof(struct shmring_hdr) + real_size) < 0) {
+		close(memfd);
+		return NULL;
+	}
+	efd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+	if (efd < 0) {
+		close(memfd);
+		return NULL;
+	}
+
+	if (!(r = shmring_map(memfd, efd, real_size))) {
+		close(memfd);
+		close(efd);
+		return NULL;
+	}
+	r->hdr->size = real_size;
+	r->hdr->magic = SHMRING_MAGIC;
+
+	return r;
+}
+#else
+shmring *shmring_create(unsigned long size)
+{
+	errno = ENOSYS;
+	return NULL;
+}
+#endif
+
+shmring *shmring_attach(int memfd, int efd)
+{
+	struct shmring_hdr hdr;
+	struct stat st;
+	shmring *r;
+
+	if (fstat(memfd, &st) < 0 || st.st_size < (off_t)sizeof(hdr))
+		goto fail;
+	if (pread(memfd, &hdr, sizeof(hdr), 0) != sizeof(hdr))
+		goto fail;
+	if (hdr.magic != SHMRING_MAGIC || !hdr.size || (hdr.size & (hdr.size - 1)) ||
+	    st.st_size < (off_t)(sizeof(hdr) + hdr.size))
+	{
+		errno = EINVAL;
+		goto fail;
+	}
+
+	if ((r = shmring_map(memfd, efd, hdr.size)))
+		return r;
+
+fail:
+	close(memfd);
+	close(efd);
+	return NULL;
+}
+
+void shmring_destroy(shmring *r)
+{
+	if (!r)
+		return;
+	munmap(r->hdr, sizeof(struct shmring_hdr) + r->size);
+	close(r->memfd);
+	close(r->efd);
+	free(r);
+}
+
+int shmring_memfd(shmring *r)
+{
+	return r->memfd;
+}
+
+int shmring_eventfd(shmring *r)
+{
+	return r->efd;
+}
+
+unsigned long shmring_size(shmring *r)
+{
+	return r->size;
+}
+
+void *shmring_reserve(shmring *r, unsigned long len)
+{
+	struct shmring_rec *rec;
+	unsigned long head, tail, need, off, to_end;
+
+	r->reserved_len = 0;
+	need = rec_size(len);
+	if (need > r->size)
+		return NULL;
+
+	head = r->hdr->head; /* only we write it */
+	tail = __atomic_load_n(&r->hdr->tail, __ATOMIC_ACQUIRE);
+	off = head & r->mask;
+	to_end = r->size - off;
+
+	if (need > to_end) {
+		/* records never wrap, so pad out to the end of the ring */
+		if (r->size - (head - tail) < to_end + need)
+			return NULL;
+		rec = (struct shmring_rec *)(r->data + off);
+		rec->len = to_end - sizeof(*rec);
+		rec->flags = SHMRING_PAD;
+		off = 0;
+		need += to_end;
+	}
+	else if (r->size - (head - tail) < need) {
+		return NULL;
+	}
+
+	r->reserved = head + need;
+	r->reserved_off = off;
+	r->reserved_len = len;
+	return r->data + off + sizeof(*rec);
+}
+
+int shmring_commit(shmring *r)
+{
+	struct shmring_rec *rec;
+	unsigned long head;
+	uint64_t one = 1;
+
+	if (!r->reserved_len)
+		return -1;
+
+	rec = (struct shmring_rec *)(r->data + r->reserved_off);
+	rec->len = r->reserved_len;
+	rec->flags = 0;
+	r->reserved_len = 0;
+
+	head = r->hdr->head;
+	__atomic_store_n(&r->hdr->head, r->reserved, __ATOMIC_SEQ_CST);
+
+	/*
+	 * If the consumer had caught up with us before this record, it
+	 * may be asleep (or about to be), so we must wake it up. If it
+	 * hadn't, it's still busy and will see this record before it
+	 * gives up. The seq_cst pairing with shmring_consume() makes
+	 * sure at least one of us notices the other.
+	 */
+	if (__atomic_load_n(&r->hdr->tail, __ATOMIC_SEQ_CST) == head) {
+		if (write(r->efd, &one, sizeof(one)) < 0) {
+			/* counter is saturated, so the consumer will wake anyway */
+		}
+	}
+
+	return 0;
+}
+
+void *shmring_peek(shmring *r, unsigned long *len)
+{
+	struct shmring_rec *rec;
+	unsigned long tail, head;
+
+	tail = r->hdr->tail; /* only we write it */
+	for (;;) {
+		head = __atomic_load_n(&r->hdr->head, __ATOMIC_SEQ_CST);
+		if (head == tail) {
+			r->peeked = tail;
+			return NULL;
+		}
+
+		rec = (struct shmring_rec *)(r->data + (tail & r->mask));
+		if (!(rec->flags & SHMRING_PAD))
+			break;
+		tail += sizeof(*rec) + rec->len;
+		__atomic_store_n(&r->hdr->tail, tail, __ATOMIC_SEQ_CST);
+	}
+
+	r->peeked = tail + rec_size(rec->len);
+	*len = rec->len;
+	return rec + 1;
+}
+
+void shmring_consume(shmring *r)
+{
+	if (r->peeked == r->hdr->tail)
+		return;
+	__atomic_store_n(&r->hdr->tail, r->peeked, __ATOMIC_SEQ_CST);
+}
+
+void shmring_ack(shmring *r)
+{
+	uint64_t discard;
+
+	if (read(r->efd, &discard, sizeof(discard)) < 0) {
+		/* nothing to ack, most likely */
+	}
+}
+
+int shmring_send_fds(int sd, const void *buf, unsigned long len, const int *fds, int nfds)
+{
+	struct msghdr msg;
+	struct iovec iov;
+	struct cmsghdr *cmsg;
+	char cbuf[CMSG_SPACE(sizeof(int) * 8)];
+
+	if (nfds < 0 || nfds > 8) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	memset(&msg, 0, sizeof(msg));
+	iov.iov_base = (void *)buf;
+	iov.iov_len = len;
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+	if (nfds) {
+		memset(cbuf, 0, sizeof(cbuf));
+		msg.msg_control = cbuf;
+		msg.msg_controllen = CMSG_SPACE(sizeof(int) * nfds);
+		cmsg = CMSG_FIRSTHDR(&msg);
+		cmsg->cmsg_level = SOL_SOCKET;
+		cmsg->cmsg_type = SCM_RIGHTS;
+		cmsg->cmsg_len = CMSG_LEN(sizeof(int) * nfds);
+		memcpy(CMSG_DATA(cmsg), fds, sizeof(int) * nfds);
+	}
+
+	return sendmsg(sd, &msg, 0);
+}
+
+int shmring_recv_fds(int sd, void *buf, unsigned long len, int *fds, int *nfds)
+{
+	struct msghdr msg;
+	struct iovec iov;
+	struct cmsghdr *cmsg;
+	char cbuf[CMSG_SPACE(sizeof(int) * 8)];
+	int ret, flags = 0, room = *nfds;
+
+#ifdef MSG_CMSG_CLOEXEC
+	flags = MSG_CMSG_CLOEXEC;
+#endif
+
+	*nfds = 0;
+	memset(&msg, 0, sizeof(msg));
+	iov.iov_base = buf;
+	iov.iov_len = len;
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+	msg.msg_control = cbuf;
+	msg.msg_controllen = sizeof(cbuf);
+
+	ret = recvmsg(sd, &msg, flags);
+	if (ret < 0)
+		return ret;
+
+	for (cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+		int i, n, *cfds;
+
+		if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS)
+			continue;
+		n = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+		cfds = (int *)CMSG_DATA(cmsg);
+		for (i = 0; i < n; i++) {
+			/* we can't leave descriptors we have no room for lying around */
+			if (*nfds < room)
+				fds[(*nfds)++] = cfds[i];
+			else
+				close(cfds[i]);
+		}
+	}
+
+	return ret;
+}
@@ -0,0 +1,141 @@
+#ifndef LIBNAGIOS_SHMRING_H_INCLUDED
+#define LIBNAGIOS_SHMRING_H_INCLUDED
+#include "lnag-utils.h"
+
+/**
+ * @file shmring.h
+ * @brief Single-producer, single-consumer shared memory ring buffer
+ *
+ * A shmring is a ring of variable-sized records in a memfd, paired
+ * with an eventfd the producer uses as a doorbell. Both are plain
+ * file descriptors, so they can be handed to another process over a
+ * unix socket and the eventfd can be watched with an iobroker set.
+ *
+ * Records are never split at the end of the ring, so the consumer
+ * always gets a contiguous (8-byte aligned) record it can use in
+ * place until it consumes it. The doorbell is only rung when the
+ * ring was empty as seen by the producer after publishing, so a
+ * consumer must keep reading records until shmring_peek() returns
+ * NULL after every wakeup.
+ *
+ * This only works on Linux. Elsewhere shmring_create() fails with
+ * ENOSYS.
+ * @{
+ */
+
+NAGIOS_BEGIN_DECL
+
+/** Primary (opaque) type for this api */
+typedef struct shmring shmring;
+
+/**
+ * Create a shared memory ring
+ * @param[in] size Size of the ring. Rounded up to a power of 2
+ * @return A new ring on success, NULL on errors
+ */
+extern shmring *shmring_create(unsigned long size);
+
+/**
+ * Map a ring some other process created. The ring takes
+ * ownership of both file descriptors.
+ * @param[in] memfd The memfd holding the ring
+ * @param[in] efd The eventfd used as doorbell
+ * @return The ring on success, NULL on errors
+ */
+extern shmring *shmring_attach(int memfd, int efd);
+
+/**
+ * Unmap a ring and close its file descriptors
+ * @param[in] r The ring to destroy
+ */
+extern void shmring_destroy(shmring *r);
+
+/**
+ * Get the memfd of a ring, to hand it to the other side
+ * @param[in] r The ring
+ * @return The memfd
+ */
+extern int shmring_memfd(shmring *r);
+
+/**
+ * Get the doorbell of a ring, to hand it to the other side or to
+ * register it with an iobroker set
+ * @param[in] r The ring
+ * @return The eventfd
+ */
+extern int shmring_eventfd(shmring *r);
+
+/**
+ * Get the size of a ring's data area
+ * @param[in] r The ring
+ * @return The size, in bytes
+ */
+extern unsigned long shmring_size(shmring *r);
+
+/**
+ * Reserve room for a record. Only the producer may call this.
+ * The record isn't visible to the consumer until it's committed,
+ * and reserving again before committing discards the reservation.
+ * @param[in] r The ring
+ * @param[in] len Size of the record
+ * @return Pointer to len bytes of ring memory, or NULL if the ring
+ * is too full to hold the record
+ */
+extern void *shmring_reserve(shmring *r, unsigned long len);
+
+/**
+ * Publish the reserved record and ring the doorbell if the consumer
+ * might have gone to sleep.
+ * @param[in] r The ring
+ * @return 0 on success, -1 if nothing was reserved
+ */
+extern int shmring_commit(shmring *r);
+
+/**
+ * Get the oldest record in the ring. Only the consumer may call this.
+ * @param[in] r The ring
+ * @param[out] len Out buffer for the size of the record
+ * @return The record, or NULL if the ring is empty
+ */
+extern void *shmring_peek(shmring *r, unsigned long *len);
+
+/**
+ * Release the record shmring_peek() returned back to the producer
+ * @param[in] r The ring
+ */
+extern void shmring_consume(shmring *r);
+
+/**
+ * Silence the doorbell. The consumer should call this when woken,
+ * before it starts reading records.
+ * @param[in] r The ring
+ */
+extern void shmring_ack(shmring *r);
+
+/**
+ * Send a message along with a set of file descriptors over a unix
+ * socket. The descriptors are attached to the first byte.
+ * @param[in] sd The socket
+ * @param[in] buf The message
+ * @param[in] len Length of the message
+ * @param[in] fds The file descriptors to send
+ * @param[in] nfds Number of file descriptors to send
+ * @return What sendmsg() returns
+ */
+extern int shmring_send_fds(int sd, const void *buf, unsigned long len, const int *fds, int nfds);
+
+/**
+ * Read from a unix socket, picking up any file descriptors sent
+ * along with the data. The descriptors are close-on-exec.
+ * @param[in] sd The socket
+ * @param[out] buf Where to put the data
+ * @param[in] len Size of buf
+ * @param[out] fds Where to put the file descriptors
+ * @param[in,out] nfds In: room in fds. Out: descriptors received
+ * @return What recvmsg() returns
+ */
+extern int shmring_recv_fds(int sd, void *buf, unsigned long len, int *fds, int *nfds);
+
+NAGIOS_END_DECL
+/** @} */
+#endif
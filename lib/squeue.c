@@ -11,6 +11,18 @@
  * add(), pop() and remove() are O(lg n), although remove() is
  * impossible unless caller maintains the pointer to the scheduled
  * event.
+ *
+ * Queues created with SQUEUE_TYPE_WHEEL instead keep their events in
+ * a hierarchical timing wheel. Each level has 64 slots and covers 64
+ * times the span of the level below it, with a tick of roughly 2ms at
+ * the lowest level. An event is stored at the lowest level where its
+ * tick differs from the wheel's current tick, so add() and remove()
+ * are O(1) list operations. Events that are due (their tick is the
+ * current one or earlier) are moved to a small prqueue so they still
+ * come out in exact microsecond order, which makes peek() O(1) and
+ * pop() O(lg k), where k is the number of events due in the same tick.
+ * Moving the wheel forward cascades the next non-empty slot down one
+ * or more levels, which is amortized O(1) per event.
  */
 
 #include <stdlib.h>
@@ -26,6 +38,8 @@ struct squeue_event {
 	prqueue_pri_t pri;
 	struct timeval when;
 	void *data;
+	struct squeue_event *next, **pprev; /* timing wheel slot linkage */
+	unsigned int slot;
 };
 
 /*
@@ -38,6 +52,31 @@ struct squeue_event {
  * comparisons.
  */
 #define SQ_BITS 21
+
+/*
+ * Timing wheel geometry. A tick is the priority shifted down by
+ * SQ_TICK_SHIFT bits, which gives us 1024 ticks per second. With
+ * 64 slots per level, 9 levels covers every tick a priority can
+ * produce, so we never need an overflow list.
+ */
+#define SQ_TICK_SHIFT 11
+#define SQ_WHEEL_BITS 6
+#define SQ_WHEEL_SLOTS (1 << SQ_WHEEL_BITS)
+#define SQ_WHEEL_LEVELS 9
+
+struct sq_wheel {
+	unsigned long long cur;   /* current tick */
+	unsigned int count;       /* number of events in the slots */
+	unsigned long long occupied[SQ_WHEEL_LEVELS]; /* non-empty slots, per level */
+	squeue_event *slot[SQ_WHEEL_LEVELS * SQ_WHEEL_SLOTS];
+};
+
+struct squeue {
+	int type;
+	prqueue_t *pq; /* the heap, or the wheel's queue of due events */
+	struct sq_wheel *wheel;
+};
+
 static prqueue_pri_t evt_compute_pri(struct timeval *tv)
 {
 	prqueue_pri_t ret;
@@ -80,6 +119,109 @@ static void sq_set_pos(void *a, unsigned int pos)
 	((squeue_event *)a)->pos = pos;
 }
 
+static inline unsigned long long sq_tick(prqueue_pri_t pri)
+{
+	return pri >> SQ_TICK_SHIFT;
+}
+
+static inline unsigned int sq_lowest_bit(unsigned long long x)
+{
+#ifdef __GNUC__
+	return __builtin_ctzll(x);
+#else
+	unsigned int i = 0;
+	while (!(x & 1)) {
+		x >>= 1;
+		i++;
+	}
+	return i;
+#endif
+}
+
+/*
+ * Puts an event where it belongs in a timing wheel queue; in the
+ * slot list of the lowest level where its tick differs from the
+ * current one, or in the due queue if its tick has already come.
+ */
+static int wheel_insert(squeue_t *q, squeue_event *evt)
+{
+	struct sq_wheel *w = q->wheel;
+	unsigned long long tick, diff;
+	unsigned int level = 0, idx;
+
+	tick = sq_tick(evt->pri);
+	if (tick <= w->cur) {
+		evt->pprev = NULL;
+		return prqueue_insert(q->pq, evt);
+	}
+
+	for (diff = (tick ^ w->cur) >> SQ_WHEEL_BITS; diff; diff >>= SQ_WHEEL_BITS)
+		level++;
+
+	idx = (tick >> (level * SQ_WHEEL_BITS)) & (SQ_WHEEL_SLOTS - 1);
+	w->occupied[level] |= 1ULL << idx;
+	idx += level * SQ_WHEEL_SLOTS;
+
+	evt->slot = idx;
+	evt->next = w->slot[idx];
+	if (evt->next)
+		evt->next->pprev = &evt->next;
+	w->slot[idx] = evt;
+	evt->pprev = &w->slot[idx];
+	w->count++;
+
+	return 0;
+}
+
+static void wheel_unlink(struct sq_wheel *w, squeue_event *evt)
+{
+	*evt->pprev = evt->next;
+	if (evt->next)
+		evt->next->pprev = evt->pprev;
+	if (!w->slot[evt->slot]) {
+		w->occupied[evt->slot / SQ_WHEEL_SLOTS] &= ~(1ULL << (evt->slot % SQ_WHEEL_SLOTS));
+	}
+	evt->next = NULL;
+	evt->pprev = NULL;
+	w->count--;
+}
+
+/*
+ * Moves the wheel forward until some events are due, cascading the
+ * content of higher level slots down as we go. Since the lowest
+ * non-empty level always holds the earliest events, and slots within
+ * a level are ordered, the next slot to expire is simply the lowest
+ * set bit of the lowest non-empty level.
+ */
+static void wheel_advance(squeue_t *q)
+{
+	struct sq_wheel *w = q->wheel;
+
+	while (prqueue_size(q->pq) == 0 && w->count) {
+		unsigned int level, idx, shift;
+		squeue_event *evt, *next;
+
+		for (level = 0; !w->occupied[level]; level++)
+			;
+		idx = sq_lowest_bit(w->occupied[level]);
+		shift = level * SQ_WHEEL_BITS;
+
+		/* move to the first tick covered by the slot */
+		w->cur &= ~((1ULL << (shift + SQ_WHEEL_BITS)) - 1);
+		w->cur |= (unsigned long long)idx << shift;
+
+		w->occupied[level] &= ~(1ULL << idx);
+		idx += level * SQ_WHEEL_SLOTS;
+		evt = w->slot[idx];
+		w->slot[idx] = NULL;
+		for (; evt; evt = next) {
+			next = evt->next;
+			w->count--;
+			wheel_insert(q, evt);
+		}
+	}
+}
+
 const struct timeval *squeue_event_runtime(squeue_event *evt)
 {
 	if (evt)
@@ -94,12 +236,72 @@ void *squeue_event_data(squeue_event *evt)
 	return NULL;
 }
 
-squeue_t *squeue_create(unsigned int horizon)
+squeue_t *squeue_create_type(unsigned int horizon, int type)
 {
+	squeue_t *q;
+
+	if (type != SQUEUE_TYPE_HEAP && type != SQUEUE_TYPE_WHEEL)
+		return NULL;
+
+	q = calloc(1, sizeof(*q));
+	if (!q)
+		return NULL;
+	q->type = type;
+
+	if (type == SQUEUE_TYPE_WHEEL) {
+		struct timeval tv;
+
+		q->wheel = calloc(1, sizeof(*q->wheel));
+		if (!q->wheel) {
+			free(q);
+			return NULL;
+		}
+		gettimeofday(&tv, NULL);
+		q->wheel->cur = sq_tick(evt_compute_pri(&tv));
+
+		/* the due queue only holds a tick's worth of events */
+		horizon = 0;
+	}
+
 	if (!horizon)
 		horizon = 127; /* makes prqueue allocate 128 elements */
 
-	return prqueue_init(horizon, sq_cmp_pri, sq_get_pri, sq_set_pri, sq_get_pos, sq_set_pos);
+	q->pq = prqueue_init(horizon, sq_cmp_pri, sq_get_pri, sq_set_pri, sq_get_pos, sq_set_pos);
+	if (!q->pq) {
+		free(q->wheel);
+		free(q);
+		return NULL;
+	}
+
+	return q;
+}
+
+squeue_t *squeue_create(unsigned int horizon)
+{
+	return squeue_create_type(horizon, SQUEUE_TYPE_HEAP);
+}
+
+int squeue_type(squeue_t *q)
+{
+	if (!q)
+		return -1;
+	return q->type;
+}
+
+const char *squeue_type_name(int type)
+{
+	switch (type) {
+	case SQUEUE_TYPE_HEAP: return "heap";
+	case SQUEUE_TYPE_WHEEL: return "wheel";
+	}
+	return "unknown";
+}
+
+static int sq_insert(squeue_t *q, squeue_event *evt)
+{
+	if (q->wheel)
+		return wheel_insert(q, evt);
+	return prqueue_insert(q->pq, evt);
 }
 
 squeue_event *squeue_add_tv(squeue_t *q, struct timeval *tv, void *data)
@@ -131,7 +333,7 @@ squeue_event *squeue_add_tv(squeue_t *q, struct timeval *tv, void *data)
 
 	evt->pri = evt_compute_pri(&evt->when);
 
-	if (!prqueue_insert(q, evt))
+	if (!sq_insert(q, evt))
 		return evt;
 
 	free(evt);
@@ -179,12 +381,34 @@ void squeue_change_priority_tv(squeue_t *q, squeue_event *evt, struct timeval *t
 	}
 	evt->when.tv_usec = tv->tv_usec;
 
-	prqueue_change_priority(q, evt_compute_pri(&evt->when), evt);
+	if (!q->wheel) {
+		prqueue_change_priority(q->pq, evt_compute_pri(&evt->when), evt);
+		return;
+	}
+
+	/* due events that stay due can be shuffled within the due queue */
+	if (!evt->pprev && sq_tick(evt_compute_pri(&evt->when)) <= q->wheel->cur) {
+		prqueue_change_priority(q->pq, evt_compute_pri(&evt->when), evt);
+		return;
+	}
+
+	if (evt->pprev)
+		wheel_unlink(q->wheel, evt);
+	else
+		prqueue_remove(q->pq, evt);
+	evt->pri = evt_compute_pri(&evt->when);
+	wheel_insert(q, evt);
 }
 
 void *squeue_peek(squeue_t *q)
 {
-	squeue_event *evt = prqueue_peek(q);
+	squeue_event *evt;
+
+	if (!q)
+		return NULL;
+	if (q->wheel)
+		wheel_advance(q);
+	evt = prqueue_peek(q->pq);
 	if (evt)
 		return evt->data;
 	return NULL;
@@ -195,7 +419,11 @@ void *squeue_pop(squeue_t *q)
 	squeue_event *evt;
 	void *ptr = NULL;
 
-	evt = prqueue_pop(q);
+	if (!q)
+		return NULL;
+	if (q->wheel)
+		wheel_advance(q);
+	evt = prqueue_pop(q->pq);
 	if (evt) {
 		ptr = evt->data;
 		free(evt);
@@ -209,9 +437,13 @@ int squeue_remove(squeue_t *q, squeue_event *evt)
 
 	if (!q || !evt)
 		return -1;
-	ret = prqueue_remove(q, evt);
-	if (evt)
-		free(evt);
+	if (evt->pprev) {
+		wheel_unlink(q->wheel, evt);
+		ret = 0;
+	} else {
+		ret = prqueue_remove(q->pq, evt);
+	}
+	free(evt);
 
 	return ret;
 }
@@ -219,8 +451,9 @@ int squeue_remove(squeue_t *q, squeue_event *evt)
 void squeue_destroy(squeue_t *q, int flags)
 {
 	unsigned int i;
+	squeue_event *evt, *next;
 
-	if (!q || prqueue_size(q) < 1)
+	if (!q)
 		return;
 
 	/*
@@ -228,23 +461,101 @@ void squeue_destroy(squeue_t *q, int flags)
 	 * doing 1 cmp+branch for every queued item
 	 */
 	if (flags & SQUEUE_FREE_DATA) {
-		for (i = 0; i < prqueue_size(q); i++) {
-			free(((squeue_event *)q->d[i + 1])->data);
-			free(q->d[i + 1]);
+		for (i = 0; i < prqueue_size(q->pq); i++) {
+			free(((squeue_event *)q->pq->d[i + 1])->data);
+			free(q->pq->d[i + 1]);
 		}
 	} else {
-		for (i = 0; i < prqueue_size(q); i++) {
-			free(q->d[i + 1]);
+		for (i = 0; i < prqueue_size(q->pq); i++) {
+			free(q->pq->d[i + 1]);
 		}
 	}
-	prqueue_free(q);
+	prqueue_free(q->pq);
+
+	if (q->wheel) {
+		for (i = 0; i < SQ_WHEEL_LEVELS * SQ_WHEEL_SLOTS; i++) {
+			for (evt = q->wheel->slot[i]; evt; evt = next) {
+				next = evt->next;
+				if (flags & SQUEUE_FREE_DATA)
+					free(evt->data);
+				free(evt);
+			}
+		}
+		free(q->wheel);
+	}
+	free(q);
 }
 
 unsigned int squeue_size(squeue_t *q)
 {
 	if (!q)
 		return 0;
-	return prqueue_size(q);
+	if (q->wheel)
+		return prqueue_size(q->pq) + q->wheel->count;
+	return prqueue_size(q->pq);
+}
+
+/*
+ * Heap children are never scheduled before their parents, so we
+ * can stop descending as soon as we hit an event that's too late.
+ */
+static unsigned int sq_heap_walk(prqueue_t *pq, unsigned int i, time_t until, int (*walker)(squeue_event *, void *), void *arg)
+{
+	unsigned int visited = 0;
+
+	while (i < pq->size) {
+		squeue_event *evt = pq->d[i];
+
+		if (evt->when.tv_sec > until)
+			break;
+		walker(evt, arg);
+		visited++;
+		visited += sq_heap_walk(pq, i * 2, until, walker, arg);
+		i = (i * 2) + 1;
+	}
+
+	return visited;
+}
+
+unsigned int squeue_foreach_until(squeue_t *q, time_t until, int (*walker)(squeue_event *, void *), void *arg)
+{
+	struct sq_wheel *w;
+	unsigned int visited, level;
+
+	if (!q || !walker)
+		return 0;
+
+	visited = sq_heap_walk(q->pq, 1, until, walker, arg);
+	if (!(w = q->wheel))
+		return visited;
+
+	for (level = 0; level < SQ_WHEEL_LEVELS; level++) {
+		unsigned int shift = level * SQ_WHEEL_BITS;
+		unsigned long long bits = w->occupied[level];
+
+		while (bits) {
+			unsigned int idx = sq_lowest_bit(bits);
+			unsigned long long first_tick;
+			squeue_event *evt;
+
+			bits &= bits - 1;
+			first_tick = w->cur & ~((1ULL << (shift + SQ_WHEEL_BITS)) - 1);
+			first_tick |= (unsigned long long)idx << shift;
+
+			/* slots are ordered within a level, so the rest is later too */
+			if ((time_t)(first_tick >> (SQ_BITS - SQ_TICK_SHIFT)) > until)
+				break;
+
+			for (evt = w->slot[idx + (level * SQ_WHEEL_SLOTS)]; evt; evt = evt->next) {
+				if (evt->when.tv_sec > until)
+					continue;
+				walker(evt, arg);
+				visited++;
+			}
+		}
+	}
+
+	return visited;
 }
 
 int squeue_evt_when_is_after(squeue_event *evt, struct timeval *reftime) {
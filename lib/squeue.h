@@ -7,9 +7,14 @@
  * @file squeue.h
  * @brief Scheduling queue function declarations
  *
- * This library is based on the prqueue api, which implements a
+ * This library provides two interchangeable backends behind the same
+ * api. The default one is based on the prqueue api, which implements a
  * priority queue based on a binary heap, providing O(lg n) times
  * for insert() and remove(), and O(1) time for peek().
+ * The other is a hierarchical timing wheel, which provides O(1) insert()
+ * and remove() and amortized O(1) peek() and pop(), at the expense of
+ * some extra memory per queue. The backend is chosen when the queue is
+ * created and can't be changed afterwards.
  * @note There is no "find". Callers must maintain pointers to their
  * scheduled events if they wish to be able to remove them.
  *
@@ -21,7 +26,8 @@
  * The prqueue library can be useful on its own though, so we
  * don't block that from user view.
  */
-typedef prqueue_t squeue_t;
+struct squeue;
+typedef struct squeue squeue_t;
 struct squeue_event;
 typedef struct squeue_event squeue_event;
 
@@ -30,6 +36,12 @@ typedef struct squeue_event squeue_event;
  */
 #define SQUEUE_FREE_DATA (1 << 0) /** Call free() on all data pointers */
 
+/**
+ * Scheduling queue backends, for use with squeue_create_type()
+ */
+#define SQUEUE_TYPE_HEAP  0 /**< Binary heap, O(lg n) insert and remove */
+#define SQUEUE_TYPE_WHEEL 1 /**< Hierarchical timing wheel, O(1) insert and remove */
+
 /**
  * Get the scheduled runtime of this event
  * @param[in] evt The event to get runtime of
@@ -59,6 +71,31 @@ extern void *squeue_event_data(squeue_event *evt);
  */
 extern squeue_t *squeue_create(unsigned int size);
 
+/**
+ * Creates a scheduling queue using the given backend.
+ * squeue_create() is equivalent to calling this function with
+ * SQUEUE_TYPE_HEAP as type.
+ *
+ * @param size Hint about how large this queue will get
+ * @param type One of the SQUEUE_TYPE_* backends
+ * @return A pointer to a scheduling queue, or NULL on errors
+ */
+extern squeue_t *squeue_create_type(unsigned int size, int type);
+
+/**
+ * Get the backend type of a scheduling queue
+ * @param[in] q The queue to inspect
+ * @return One of the SQUEUE_TYPE_* values, or -1 if q is NULL
+ */
+extern int squeue_type(squeue_t *q);
+
+/**
+ * Get the name of a scheduling queue backend
+ * @param[in] type One of the SQUEUE_TYPE_* values
+ * @return A static string naming the backend ("heap", "wheel" or "unknown")
+ */
+extern const char *squeue_type_name(int type);
+
 /**
  * Destroys a scheduling queue completely
  * @param[in] q The doomed queue
@@ -157,6 +194,23 @@ extern int squeue_remove(squeue_t *q, squeue_event *evt);
  */
 extern unsigned int squeue_size(squeue_t *q);
 
+/**
+ * Calls a walker function for every event scheduled to run no later
+ * than the given time. Events are visited in no particular order,
+ * and events scheduled after "until" may be skipped without being
+ * looked at, so this is a lot cheaper than popping the queue. The
+ * walker must not add or remove events from the queue, but it may
+ * save the event pointers and use squeue_change_priority_tv() on
+ * them once this function has returned.
+ *
+ * @param[in] q The scheduling queue to walk
+ * @param[in] until Unix timestamp of the last second to visit
+ * @param[in] walker Function to call for each event
+ * @param[in] arg Argument passed on to walker
+ * @return The number of events passed to walker
+ */
+extern unsigned int squeue_foreach_until(squeue_t *q, time_t until, int (*walker)(squeue_event *, void *), void *arg);
+
 
 /**
  * Returns true if passed timeval is after the time for the event
@@ -0,0 +1,59 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "arena.c"
+#include "t-utils.h"
+
+int main(int argc, char **argv)
+{
+	arena *a;
+	char *p, *q, *big;
+	int i, aligned = 1;
+
+	t_set_colors(0);
+	t_start("arena tests");
+
+	a = arena_create(1024);
+	t_req(a != NULL);
+	ok_int((int)arena_chunks(a), 1, "new arena has one chunk");
+	ok_int((int)arena_used(a), 0, "new arena is empty");
+
+	p = arena_strdup(a, "foo");
+	ok_str(p, "foo", "arena_strdup() copies strings");
+	q = arena_strndup(a, "foobar", 3);
+	ok_str(q, "foo", "arena_strndup() copies at most len bytes");
+	ok_int(p != q, 1, "allocations don't overlap");
+	ok_int(arena_strdup(a, NULL) == NULL, 1, "arena_strdup(NULL) yields NULL");
+	ok_int((int)arena_used(a), 16, "small allocations are rounded up to 8 bytes");
+	q = arena_strndup(a, "ab", 4096);
+	ok_str(q, "ab", "arena_strndup() stops at the end of shorter strings");
+	ok_int((int)arena_used(a), 24, "arena_strndup() only allocates what it copies");
+
+	for (i = 1; i < 100; i++) {
+		p = arena_alloc(a, i);
+		if ((unsigned long)p & 7)
+			aligned = 0;
+	}
+	ok_int(aligned, 1, "allocations are 8-byte aligned");
+	ok_int(arena_chunks(a) > 1, 1, "arena grows beyond its first chunk");
+
+	big = arena_alloc(a, 10000);
+	t_req(big != NULL);
+	memset(big, 'x', 10000);
+	ok_int(arena_chunks(a) > 2, 1, "big allocations get a chunk of their own");
+
+	arena_reset(a);
+	ok_int((int)arena_chunks(a), 1, "reset leaves one chunk");
+	ok_int((int)arena_used(a), 0, "reset empties the arena");
+
+	/* the same workload again fits in the one chunk */
+	for (i = 1; i < 100; i++)
+		arena_alloc(a, i);
+	arena_alloc(a, 10000);
+	ok_int((int)arena_chunks(a), 1, "chunk after reset fits the previous batch");
+	arena_reset(a);
+	ok_int((int)arena_chunks(a), 1, "arena stays at one chunk");
+
+	arena_destroy(a);
+	return t_end();
+}
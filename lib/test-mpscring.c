@@ -0,0 +1,151 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
+#include "mpscring.c"
+#include "t-utils.h"
+
+#define PRODUCERS 4
+#define PER_PRODUCER 50000
+
+static int put(mpscring *r, const char *str)
+{
+	char *buf;
+
+	if (!(buf = mpscring_reserve(r, strlen(str) + 1)))
+		return -1;
+	memcpy(buf, str, strlen(str) + 1);
+	mpscring_commit(r, buf);
+	return 0;
+}
+
+static void test_basics(void)
+{
+	mpscring *r;
+	unsigned long len;
+	char *buf, *a, *b, last[128] = "", str[128];
+	int i, ok;
+
+	r = mpscring_create(1000);
+	t_req(r != NULL);
+	ok_int((int)mpscring_size(r), 1024, "size is rounded up to a power of 2");
+	ok_int(mpscring_peek(r, &len) == NULL, 1, "peek on empty ring yields NULL");
+
+	ok_int(put(r, "first"), 0, "reserve succeeds");
+	ok_int(put(r, "second"), 0, "second reserve succeeds");
+	buf = mpscring_peek(r, &len);
+	ok_str(buf, "first", "first record comes out first");
+	ok_int((int)len, 6, "record length is what was reserved");
+	ok_int(((unsigned long)buf & 7) == 0, 1, "records are 8-byte aligned");
+	mpscring_consume(r);
+	ok_str(mpscring_peek(r, &len), "second", "second record comes out second");
+	mpscring_consume(r);
+	ok_int(mpscring_peek(r, &len) == NULL, 1, "ring is empty once all is consumed");
+	ok_int((int)mpscring_used(r), 0, "nothing is in use once all is consumed");
+
+	/* pending records hold up the ones behind them */
+	a = mpscring_reserve(r, 8);
+	b = mpscring_reserve(r, 8);
+	strcpy(b, "b");
+	mpscring_commit(r, b);
+	ok_int(mpscring_peek(r, &len) == NULL, 1, "uncommitted record blocks the ones after it");
+	strcpy(a, "a");
+	mpscring_commit(r, a);
+	ok_str(mpscring_peek(r, &len), "a", "records come out in reservation order");
+	mpscring_consume(r);
+	ok_str(mpscring_peek(r, &len), "b", "later record shows up once the first is committed");
+	mpscring_consume(r);
+
+	ok_int(mpscring_reserve(r, 2000) == NULL, 1, "records larger than the ring are refused");
+
+	/* drain and refill a few times to make it wrap */
+	ok = 1;
+	for (i = 0; i < 1000; i++) {
+		sprintf(str, "record %d with some padding %.*s", i, i % 37, "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx");
+		while (put(r, str) < 0) {
+			if (!mpscring_peek(r, &len)) {
+				ok = 0;
+				break;
+			}
+			mpscring_consume(r);
+		}
+		if (!ok)
+			break;
+	}
+	ok_int(ok, 1, "ring keeps going when wrapping around");
+	/* consumed records are wiped, so we keep a copy */
+	while ((buf = mpscring_peek(r, &len))) {
+		strcpy(last, buf);
+		mpscring_consume(r);
+	}
+	ok_str(last, str, "last record in is the last one out");
+
+	mpscring_destroy(r);
+}
+
+struct producer_arg {
+	mpscring *r;
+	int id;
+};
+
+static void *producer(void *arg_)
+{
+	struct producer_arg *arg = arg_;
+	char str[32];
+	int i;
+
+	for (i = 0; i < PER_PRODUCER; i++) {
+		sprintf(str, "%d %d", arg->id, i);
+		while (put(arg->r, str) < 0)
+			sched_yield();
+	}
+
+	return NULL;
+}
+
+static void test_threads(void)
+{
+	mpscring *r;
+	pthread_t threads[PRODUCERS];
+	struct producer_arg args[PRODUCERS];
+	int expect[PRODUCERS] = { 0 }, i, id, seq, received = 0, ok = 1;
+	unsigned long len;
+	char *rec;
+
+	r = mpscring_create(4096);
+	t_req(r != NULL);
+	for (i = 0; i < PRODUCERS; i++) {
+		args[i].r = r;
+		args[i].id = i;
+		pthread_create(&threads[i], NULL, producer, &args[i]);
+	}
+
+	while (received < PRODUCERS * PER_PRODUCER) {
+		if (!(rec = mpscring_peek(r, &len))) {
+			sched_yield();
+			continue;
+		}
+		if (sscanf(rec, "%d %d", &id, &seq) != 2 || id < 0 || id >= PRODUCERS || seq != expect[id]++)
+			ok = 0;
+		mpscring_consume(r);
+		received++;
+	}
+	for (i = 0; i < PRODUCERS; i++)
+		pthread_join(threads[i], NULL);
+
+	ok_int(ok, 1, "records from each producer arrive complete and in order");
+	ok_int(mpscring_peek(r, &len) == NULL, 1, "nothing is left over");
+	mpscring_destroy(r);
+}
+
+int main(int argc, char **argv)
+{
+	t_set_colors(0);
+	t_start("mpscring tests");
+
+	test_basics();
+	test_threads();
+
+	return t_end();
+}
@@ -171,6 +171,51 @@ int main(int argc, char **argv)
 		}
 	}
 
+	r2 = t_end();
+	ret = r2 ? r2 : ret;
+	t_reset();
+	t_start("posix_spawn execution");
+	{
+		int i, n, fd, stub_iobregarg = 0;
+		int pfd[2] = {-1, -1}, pfderr[2] = {-1, -1};
+		char *env[] = { "RUNCMD_TEST_ENV", "from env", NULL };
+		char *out = calloc(1, BUF_SIZE);
+		char *cmd;
+
+		ok_int(runcmd_use_spawn(1), 0, "posix_spawn() should be available");
+		for (i = 0; cases[i].input != NULL; i++) {
+			memset(out, 0, BUF_SIZE);
+			asprintf(&cmd, ECHO_COMMAND " -n %s", cases[i].input);
+			fd = runcmd_open(cmd, pfd, pfderr, NULL, stub_iobreg, &stub_iobregarg);
+			free(cmd);
+			read(pfd[0], out, BUF_SIZE);
+			ok_str(cases[i].output, out, "Spawned echo should give expected output");
+			close(pfd[0]);
+			close(pfderr[0]);
+		}
+
+		memset(out, 0, BUF_SIZE);
+		fd = runcmd_open("RUNCMD_TEST_VAR=from_argv /usr/bin/printenv RUNCMD_TEST_VAR RUNCMD_TEST_ENV", pfd, pfderr, env, stub_iobreg, &stub_iobregarg);
+		ok_int(runcmd_pid(fd) > 0, 1, "Spawned command should have a pid");
+		for (i = 0; i < BUF_SIZE - 1; i += n) {
+			if ((n = read(pfd[0], out + i, BUF_SIZE - 1 - i)) <= 0)
+				break;
+		}
+		ok_str("from_argv\nfrom env\n", out, "VAR=value words and env should end up in the environment");
+		close(pfd[0]);
+		close(pfderr[0]);
+
+		memset(out, 0, BUF_SIZE);
+		fd = runcmd_open("/nonexistent/plugin", pfd, pfderr, NULL, stub_iobreg, &stub_iobregarg);
+		read(pfderr[0], out, BUF_SIZE);
+		ok_int(!!strstr(out, "execvp(/nonexistent/plugin"), 1, "Failed spawns should fall back to fork() and explain why");
+		close(pfd[0]);
+		close(pfderr[0]);
+
+		runcmd_use_spawn(0);
+		free(out);
+	}
+
 	r2 = t_end();
 	return r2 ? r2 : ret;
 }
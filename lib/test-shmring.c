@@ -0,0 +1,168 @@
+#define _GNU_SOURCE
+#include <unistd.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <poll.h>
+#include <sched.h>
+#include <sys/wait.h>
+#include "shmring.c"
+#include "t-utils.h"
+
+static int doorbell_rung(shmring *r)
+{
+	struct pollfd pfd;
+
+	pfd.fd = shmring_eventfd(r);
+	pfd.events = POLLIN;
+	return poll(&pfd, 1, 0) == 1;
+}
+
+static int put(shmring *r, const char *str)
+{
+	char *buf;
+
+	if (!(buf = shmring_reserve(r, strlen(str) + 1)))
+		return -1;
+	memcpy(buf, str, strlen(str) + 1);
+	return shmring_commit(r);
+}
+
+static void test_basics(void)
+{
+	shmring *p, *c;
+	unsigned long len;
+	char *buf, *last = NULL, str[128];
+	int i, ok;
+
+	p = shmring_create(1000);
+	t_req(p != NULL);
+	ok_int((int)shmring_size(p), 4096, "size is rounded up to a power of 2");
+	c = shmring_attach(dup(shmring_memfd(p)), dup(shmring_eventfd(p)));
+	t_req(c != NULL);
+	ok_int((int)shmring_size(c), 4096, "attached ring gets its size from the creator");
+
+	ok_int(shmring_peek(c, &len) == NULL, 1, "peek on empty ring yields NULL");
+	ok_int(doorbell_rung(c), 0, "doorbell is quiet on empty ring");
+
+	ok_int(put(p, "first"), 0, "commit succeeds");
+	ok_int(doorbell_rung(c), 1, "doorbell rings when ring was empty");
+	ok_int(put(p, "second"), 0, "second commit succeeds");
+	shmring_ack(c);
+	ok_int(doorbell_rung(c), 0, "ack silences doorbell");
+
+	buf = shmring_peek(c, &len);
+	ok_str(buf, "first", "first record comes out first");
+	ok_int((int)len, 6, "record length is what was reserved");
+	ok_int(((unsigned long)buf & 7) == 0, 1, "records are 8-byte aligned");
+	shmring_consume(c);
+	ok_int(put(p, "third"), 0, "third commit succeeds");
+	ok_int(doorbell_rung(c), 0, "doorbell stays quiet while consumer is busy");
+	ok_str(shmring_peek(c, &len), "second", "second record comes out second");
+	shmring_consume(c);
+	ok_str(shmring_peek(c, &len), "third", "third record comes out third");
+	shmring_consume(c);
+	ok_int(shmring_peek(c, &len) == NULL, 1, "ring is empty once all is consumed");
+
+	ok_int(shmring_commit(p), -1, "commit without reserve fails");
+	ok_int(shmring_reserve(p, 5000) == NULL, 1, "records larger than the ring are refused");
+
+	/* fill it up */
+	for (i = 0; put(p, "0123456789012345678901234567890123456789012345") == 0; i++)
+		;
+	/* 48 bytes are used, and the padding record needs 16 at the end */
+	ok_int(i, (4096 - 48 - 16) / 56, "ring holds as many records as fit");
+
+	/* drain and refill a few times to make it wrap */
+	ok = 1;
+	for (i = 0; i < 1000; i++) {
+		sprintf(str, "record %d with some padding %.*s", i, i % 37, "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx");
+		while (put(p, str) < 0) {
+			if (!shmring_peek(c, &len)) {
+				ok = 0;
+				break;
+			}
+			shmring_consume(c);
+		}
+		if (!ok)
+			break;
+	}
+	ok_int(ok, 1, "ring keeps going when wrapping around");
+	while ((buf = shmring_peek(c, &len))) {
+		last = buf;
+		shmring_consume(c);
+	}
+	ok_str(last, str, "last record in is the last one out");
+
+	shmring_destroy(c);
+	shmring_destroy(p);
+}
+
+static void test_processes(void)
+{
+	shmring *r;
+	int sv[2], fds[2], nfds = 2, pid, status, i, expect = 0, ok = 1;
+	char buf[8];
+
+	t_req(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == 0);
+	r = shmring_create(8192);
+	t_req(r != NULL);
+	fds[0] = shmring_memfd(r);
+	fds[1] = shmring_eventfd(r);
+
+	pid = fork();
+	if (!pid) {
+		shmring *c;
+		unsigned long len;
+		char *rec;
+
+		shmring_destroy(r);
+		close(sv[0]);
+		if (shmring_recv_fds(sv[1], buf, 3, fds, &nfds) != 3 || nfds != 2)
+			exit(1);
+		if (!(c = shmring_attach(fds[0], fds[1])))
+			exit(2);
+		for (;;) {
+			struct pollfd pfd = { shmring_eventfd(c), POLLIN, 0 };
+			poll(&pfd, 1, 5000);
+			shmring_ack(c);
+			while ((rec = shmring_peek(c, &len))) {
+				if (atoi(rec) != expect++)
+					exit(3);
+				shmring_consume(c);
+				if (expect == 100000)
+					exit(0);
+			}
+		}
+	}
+
+	close(sv[1]);
+	ok_int(shmring_send_fds(sv[0], "OK", 3, fds, 2), 3, "sending descriptors");
+	for (i = 0; i < 100000; i++) {
+		char *rec;
+		while (!(rec = shmring_reserve(r, 16)))
+			sched_yield();
+		snprintf(rec, 16, "%d", i);
+		shmring_commit(r);
+	}
+	ok = waitpid(pid, &status, 0) == pid && WIFEXITED(status) && !WEXITSTATUS(status);
+	ok_int(ok, 1, "100000 records make it across processes in order");
+	shmring_destroy(r);
+	close(sv[0]);
+}
+
+int main(int argc, char **argv)
+{
+	t_set_colors(0);
+	t_start("shmring tests");
+
+	if (!shmring_create(1)) {
+		t_diag("shared memory rings aren't supported here");
+		return t_end();
+	}
+
+	test_basics();
+	test_processes();
+
+	return t_end();
+}
@@ -12,23 +12,6 @@
 #include "squeue.c"
 #include "t-utils.h"
 
-static void squeue_foreach(squeue_t *q, int (*walker)(squeue_event *, void *), void *arg)
-{
-	squeue_t *dup;
-	void *e, *dup_d;
-
-	dup = squeue_create(q->size);
-	dup_d = dup->d;
-	memcpy(dup, q, sizeof(*q));
-	dup->d = dup_d;
-	memcpy(dup->d, q->d, (q->size * sizeof(void *)));
-
-	while ((e = prqueue_pop(dup))) {
-		walker(e, arg);
-	}
-	squeue_destroy(dup, 0);
-}
-
 #define t(expr, args...) \
 	do { \
 		if ((expr)) { \
@@ -43,15 +26,14 @@ typedef struct sq_test_event {
 	squeue_event *evt;
 } sq_test_event;
 
-static time_t sq_high = 0;
+static time_t sq_until = 0;
 static int sq_walker(squeue_event *evt, void *arg)
 {
-	static int walks = 0;
+	int *walks = (int *)arg;
 
-	walks++;
-	t(sq_high <= evt->when.tv_sec, "sq_high: %lu; evt->when: %lu\n",
-	  sq_high, evt->when.tv_sec);
-	sq_high = (unsigned long)evt->when.tv_sec;
+	(*walks)++;
+	t(evt->when.tv_sec <= sq_until, "sq_until: %lu; evt->when: %lu\n",
+	  sq_until, evt->when.tv_sec);
 
 	return 0;
 }
@@ -73,7 +55,7 @@ static int sq_test_random(squeue_t *sq)
 		t(squeue_size(sq) == i + 1 + size);
 	}
 
-	t(prqueue_is_valid(sq));
+	t(prqueue_is_valid(sq->pq));
 
 	/*
 	 * make sure we pop events in increasing "priority",
@@ -87,19 +69,60 @@ static int sq_test_random(squeue_t *sq)
 		max = *d;
 		t(squeue_size(sq) == size + (EVT_ARY - i - 1));
 	}
-	t(prqueue_is_valid(sq));
+	t(prqueue_is_valid(sq->pq));
 
 	return 0;
 }
 
-int main(int argc, char **argv)
+/*
+ * events scheduled on the same second in the far future end up in
+ * the same high-level wheel slot and must cascade down in order
+ */
+static void sq_test_cascade(squeue_t *sq)
+{
+	sq_test_event evts[200], *x;
+	struct timeval last;
+	time_t when = time(NULL) + 86400 * 30;
+	int i, ordered = 1;
+
+	for (i = 0; i < 200; i++) {
+		evts[i].id = i;
+		evts[i].evt = squeue_add_usec(sq, when + (i % 3) * 3600, (i * 4999) % 1000000, &evts[i]);
+	}
+	t(squeue_size(sq) == 200);
+
+	/* move a few around and get rid of some others */
+	for (i = 0; i < 200; i += 10) {
+		struct timeval tv = { when - 60, i };
+		squeue_change_priority_tv(sq, evts[i].evt, &tv);
+	}
+	for (i = 5; i < 200; i += 10) {
+		squeue_remove(sq, evts[i].evt);
+	}
+	t(squeue_size(sq) == 180);
+
+	x = squeue_peek(sq);
+	t(x == &evts[0], "x->id: %lu", x ? x->id : -1UL);
+	for (i = 0; (x = squeue_peek(sq)); i++) {
+		struct timeval when = *squeue_event_runtime(x->evt);
+		if (i && squeue_evt_when_is_after(x->evt, &last))
+			ordered = 0;
+		last = when;
+		t(squeue_pop(sq) == x);
+	}
+	t(ordered, "events must come out in order");
+	t(i == 180, "i: %d", i);
+	t(squeue_size(sq) == 0);
+}
+
+static void sq_test_type(int type)
 {
 	squeue_t *sq;
 	struct timeval tv;
 	sq_test_event a, b, c, d, *x;
+	int walks = 0;
 
-	t_set_colors(0);
-	t_start("squeue tests");
+	t_start("squeue tests (%s)", squeue_type_name(type));
 
 	a.id = 1;
 	b.id = 2;
@@ -109,7 +132,8 @@ int main(int argc, char **argv)
 	gettimeofday(&tv, NULL);
 	/* Order in is a, b, c, d, but we should get b, c, d, a out. */
 	srand(tv.tv_usec ^ tv.tv_sec);
-	t((sq = squeue_create(1024)) != NULL);
+	t((sq = squeue_create_type(1024, type)) != NULL);
+	t(squeue_type(sq) == type);
 	t(squeue_size(sq) == 0);
 
 	/* we fill and empty the squeue completely once before testing */
@@ -170,10 +194,31 @@ int main(int argc, char **argv)
 	t(squeue_remove(NULL, NULL) == -1);
 	t(squeue_remove(NULL, a.evt) == -1);
 
-	squeue_foreach(sq, sq_walker, NULL);
+	/* a is 9 seconds out and d is 5 seconds out */
+	sq_until = time(NULL) + 6;
+	t(squeue_foreach_until(sq, sq_until, sq_walker, &walks) == 1);
+	t(walks == 1, "walks: %d", walks);
+	sq_until = time(NULL) + 60;
+	t(squeue_foreach_until(sq, sq_until, sq_walker, &walks) == 2);
 
 	/* clean up to prevent false valgrind positives */
 	squeue_destroy(sq, 0);
 
+	t((sq = squeue_create_type(0, type)) != NULL);
+	sq_test_cascade(sq);
+	squeue_destroy(sq, 0);
+
+	t_end();
+}
+
+int main(int argc, char **argv)
+{
+	t_set_colors(0);
+	t_start("squeue tests");
+
+	t(squeue_create_type(0, 42) == NULL);
+	sq_test_type(SQUEUE_TYPE_HEAP);
+	sq_test_type(SQUEUE_TYPE_WHEEL);
+
 	return t_end();
 }
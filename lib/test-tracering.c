@@ -0,0 +1,58 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "tracering.c"
+#include "t-utils.h"
+
+int main(int argc, char **argv)
+{
+	tracering *r;
+	struct tracering_rec recs[64];
+	struct tracering_header hdr;
+	uint64_t pos = 0;
+	unsigned int i, n;
+	int ordered = 1;
+
+	t_set_colors(0);
+	t_start("tracering tests");
+
+	r = tracering_create(20);
+	t_req(r != NULL);
+	ok_int((int)tracering_size(r), 32, "size is rounded up to a power of 2");
+	ok_int((int)tracering_read(r, &pos, recs, 64), 0, "empty ring has nothing to read");
+
+	tracering_add(r, 1, 2, 3, 4);
+	tracering_add(r, 5, 6, 7, 8);
+	n = tracering_read(r, &pos, recs, 64);
+	ok_int((int)n, 2, "both records are read");
+	ok_int((int)pos, 2, "position moves past the records read");
+	ok_int(recs[0].event == 1 && recs[0].arg0 == 2 && recs[0].arg1 == 3 && recs[0].arg2 == 4, 1, "first record is intact");
+	ok_int(recs[1].event == 5 && recs[1].arg2 == 8, 1, "second record is intact");
+	ok_int(recs[1].ns >= recs[0].ns, 1, "timestamps don't go backwards");
+	ok_int((int)tracering_read(r, &pos, recs, 64), 0, "nothing new to read");
+
+	/* overwrite the ring a few times over */
+	for (i = 0; i < 100; i++)
+		tracering_add(r, 100 + i, i, 0, 0);
+	ok_int((int)tracering_count(r), 102, "all records are counted");
+	ok_int((int)tracering_oldest(r), 70, "oldest record is a ring behind the newest");
+	n = tracering_read(r, &pos, recs, 10);
+	ok_int((int)n, 10, "read stops at max");
+	ok_int(recs[0].event, 100 + 68, "readers that fall behind skip to the oldest record");
+	n += tracering_read(r, &pos, recs + n, 64 - n);
+	ok_int((int)n, 32, "the rest of the ring is read");
+	for (i = 1; i < n; i++) {
+		if (recs[i].event != recs[i - 1].event + 1)
+			ordered = 0;
+	}
+	ok_int(ordered, 1, "records come out in the order they were added");
+	ok_int(recs[n - 1].event, 199, "last record added is the last one read");
+
+	tracering_header(r, &hdr, 70);
+	ok_int(memcmp(hdr.magic, TRACERING_MAGIC, 8), 0, "header has the magic");
+	ok_int((int)hdr.rec_size, (int)sizeof(struct tracering_rec), "header has the record size");
+	ok_int(hdr.first == 70 && hdr.size == 32, 1, "header has the first record and ring size");
+
+	tracering_destroy(r);
+	return t_end();
+}
@@ -0,0 +1,261 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "worker.c"
+#include "t-utils.h"
+
+#define TEST_COMMAND "/usr/lib/nagios/plugins/check_ping -H 127.0.0.1"
+#define TEST_ENV "FOO=bar\nNAGIOS_HOSTNAME=localhost\n"
+
+static char *build_job(uint32_t job_id, uint32_t timeout, const char *command, const char *env, unsigned long *size)
+{
+	struct wproc_frame_job job;
+	struct iovec strv[2];
+
+	memset(&job, 0, sizeof(job));
+	job.job_id = job_id;
+	job.type = 3;
+	job.timeout = timeout;
+	job.command_len = strlen(command);
+	job.env_len = strlen(env);
+	strv[0].iov_base = (char *)command;
+	strv[0].iov_len = job.command_len;
+	strv[1].iov_base = (char *)env;
+	strv[1].iov_len = job.env_len;
+
+	return worker_build_frame(WPROC_FRAME_JOB, &job, sizeof(job), strv, 2, size);
+}
+
+/* feed data to an iocache the way the worker gets it, through a read() */
+static void feed(iocache *ioc, const void *buf, unsigned long len)
+{
+	int pfd[2];
+
+	if (pipe(pfd) < 0)
+		crash("pipe() failed: %s", strerror(errno));
+	if (write(pfd[1], buf, len) != (ssize_t)len)
+		crash("write() to pipe failed");
+	close(pfd[1]);
+	iocache_read(ioc, pfd[0]);
+	close(pfd[0]);
+}
+
+static void free_cp(child_process *cp)
+{
+	if (!cp)
+		return;
+	free(cp->cmd);
+	if (cp->env)
+		kvvec_destroy(cp->env, KVVEC_FREE_ALL);
+	free(cp->ei);
+	free(cp);
+}
+
+static void test_roundtrip(void)
+{
+	struct wproc_frame_hdr hdr;
+	struct wproc_frame_job job;
+	child_process *cp;
+	iocache *ioc;
+	char *frame, *frame2, *buf, *data, *strv[2];
+	uint32_t lens[2];
+	unsigned long size, size2, got;
+
+	frame = build_job(17, 30, TEST_COMMAND, TEST_ENV, &size);
+	t_req(frame != NULL);
+	ok_int((int)size, (int)worker_frame_size(sizeof(job), NULL, 0) + (int)strlen(TEST_COMMAND) + 1 + (int)strlen(TEST_ENV) + 1,
+		   "frame size is header, body and nul-terminated strings");
+	memcpy(&hdr, frame, sizeof(hdr));
+	ok_uint(hdr.size, size, "header holds the frame size");
+	ok_uint(hdr.version, WPROC_FRAME_VERSION, "header holds the frame version");
+	ok_uint(hdr.type, WPROC_FRAME_JOB, "header holds the frame type");
+
+	/* two frames back to back come out one at a time */
+	frame2 = build_job(18, 0, "/bin/true", "", &size2);
+	t_req(frame2 != NULL);
+	ioc = iocache_create(512);
+	t_req(ioc != NULL);
+	feed(ioc, frame, size);
+	feed(ioc, frame2, size2);
+
+	buf = worker_ioc2frame(ioc, &got);
+	ok_int(buf != NULL, 1, "worker_ioc2frame() finds the first frame");
+	t_req(buf != NULL);
+	ok_uint(got, size, "...with the size it was built with");
+	ok_int(memcmp(buf, frame, size), 0, "...and the bytes it was built with");
+
+	data = worker_frame_body(buf, got, &job, sizeof(job));
+	ok_int(data != NULL, 1, "worker_frame_body() copies out the body");
+	ok_uint(job.job_id, 17, "body job_id survives the trip");
+	ok_uint(job.timeout, 30, "body timeout survives the trip");
+	lens[0] = job.command_len;
+	lens[1] = job.env_len;
+	ok_int(worker_frame_strings(buf, got, data, strv, lens, 2), 0, "worker_frame_strings() accepts the strings");
+	ok_str(strv[0], TEST_COMMAND, "command survives the trip");
+	ok_str(strv[1], TEST_ENV, "env survives the trip");
+
+	cp = parse_command_frame(buf, got);
+	ok_int(cp != NULL, 1, "parse_command_frame() parses a job frame");
+	t_req(cp != NULL);
+	ok_uint(cp->id, 17, "job id is parsed");
+	ok_uint(cp->ei->job_type, 3, "job type is parsed");
+	ok_uint(cp->timeout, 30, "timeout is parsed");
+	ok_str(cp->cmd, TEST_COMMAND, "command is parsed");
+	ok_int(cp->env ? cp->env->kv_pairs : -1, 2, "env is parsed into key/value pairs");
+	if (cp->env && cp->env->kv_pairs == 2) {
+		ok_str(cp->env->kv[1].key, "NAGIOS_HOSTNAME", "env keys are parsed");
+		ok_str(cp->env->kv[1].value, "localhost", "env values are parsed");
+	}
+	free_cp(cp);
+
+	buf = worker_ioc2frame(ioc, &got);
+	ok_int(buf != NULL && got == size2, 1, "worker_ioc2frame() finds the second frame");
+	cp = buf ? parse_command_frame(buf, got) : NULL;
+	ok_int(cp != NULL, 1, "parse_command_frame() parses a frame without env");
+	if (cp) {
+		ok_uint(cp->timeout, 60, "jobs without a timeout get 60 seconds");
+		ok_int(cp->env == NULL, 1, "jobs without env get none");
+	}
+	free_cp(cp);
+
+	buf = worker_ioc2frame(ioc, &got);
+	ok_int(buf == NULL && got == 0, 1, "an empty iocache has no frame and isn't garbled");
+
+	iocache_destroy(ioc);
+	free(frame);
+	free(frame2);
+}
+
+static void test_truncated(void)
+{
+	struct wproc_frame_job job;
+	iocache *ioc;
+	char *frame, *buf, *data, *strv[2];
+	uint32_t lens[2];
+	unsigned long size, got;
+
+	frame = build_job(42, 10, TEST_COMMAND, TEST_ENV, &size);
+	t_req(frame != NULL);
+	ioc = iocache_create(64);
+	t_req(ioc != NULL);
+
+	feed(ioc, frame, sizeof(struct wproc_frame_hdr) - 1);
+	buf = worker_ioc2frame(ioc, &got);
+	ok_int(buf == NULL && got == 0, 1, "a partial header is no frame yet");
+
+	feed(ioc, frame + sizeof(struct wproc_frame_hdr) - 1, 1);
+	buf = worker_ioc2frame(ioc, &got);
+	ok_int(buf == NULL && got == 0, 1, "a header without its body is no frame yet");
+	ok_int(iocache_size(ioc) >= size, 1, "the iocache is grown to fit the whole frame");
+
+	feed(ioc, frame + sizeof(struct wproc_frame_hdr), size - sizeof(struct wproc_frame_hdr) - 1);
+	buf = worker_ioc2frame(ioc, &got);
+	ok_int(buf == NULL && got == 0, 1, "a frame missing its last byte is no frame yet");
+
+	feed(ioc, frame + size - 1, 1);
+	buf = worker_ioc2frame(ioc, &got);
+	ok_int(buf != NULL && got == size, 1, "the frame is found once its last byte arrives");
+	iocache_destroy(ioc);
+
+	/* frames that claim to be shorter than they need to be */
+	ok_int(worker_frame_body(frame, sizeof(struct wproc_frame_hdr) + sizeof(job) - 1, &job, sizeof(job)) == NULL, 1,
+		   "worker_frame_body() refuses a frame too short for its body");
+	data = worker_frame_body(frame, size, &job, sizeof(job));
+	t_req(data != NULL);
+	lens[0] = job.command_len;
+	lens[1] = job.env_len;
+	ok_int(worker_frame_strings(frame, size - 1, data, strv, lens, 2), -1, "worker_frame_strings() refuses strings running past the frame");
+	ok_int(parse_command_frame(frame, size - 1) == NULL, 1, "parse_command_frame() refuses a truncated frame");
+	ok_int(parse_command_frame(frame, sizeof(struct wproc_frame_hdr)) == NULL, 1, "parse_command_frame() refuses a frame without a body");
+
+	free(frame);
+}
+
+static void test_garbled(void)
+{
+	struct wproc_frame_hdr hdr;
+	struct wproc_frame_job job;
+	iocache *ioc;
+	char *frame, *buf, *data, *strv[2];
+	uint32_t lens[2];
+	unsigned long size, got, ioc_size;
+
+	frame = build_job(7, 10, TEST_COMMAND, TEST_ENV, &size);
+	t_req(frame != NULL);
+	memcpy(&hdr, frame, sizeof(hdr));
+
+	ioc = iocache_create(512);
+	t_req(ioc != NULL);
+	hdr.version = WPROC_FRAME_VERSION + 1;
+	feed(ioc, &hdr, sizeof(hdr));
+	buf = worker_ioc2frame(ioc, &got);
+	ok_int(buf == NULL && got == size, 1, "a frame of another version garbles the stream");
+	iocache_destroy(ioc);
+
+	ioc = iocache_create(512);
+	hdr.version = WPROC_FRAME_VERSION;
+	hdr.size = sizeof(hdr) - 1;
+	feed(ioc, &hdr, sizeof(hdr));
+	buf = worker_ioc2frame(ioc, &got);
+	ok_int(buf == NULL && got == sizeof(hdr) - 1, 1, "a frame smaller than its header garbles the stream");
+	iocache_destroy(ioc);
+
+	ioc = iocache_create(512);
+	hdr.size = 0;
+	feed(ioc, &hdr, sizeof(hdr));
+	buf = worker_ioc2frame(ioc, &got);
+	ok_int(buf == NULL && got != 0, 1, "a frame of size 0 garbles the stream");
+	iocache_destroy(ioc);
+
+	ioc = iocache_create(512);
+	ioc_size = iocache_size(ioc);
+	hdr.size = 0xffffffff;
+	feed(ioc, &hdr, sizeof(hdr));
+	buf = worker_ioc2frame(ioc, &got);
+	ok_int(buf == NULL && got == 0xffffffff, 1, "a frame larger than WPROC_FRAME_MAX garbles the stream");
+	ok_uint(iocache_size(ioc), ioc_size, "...and doesn't grow the iocache");
+	iocache_destroy(ioc);
+
+	/* strings that aren't nul-terminated where the body says */
+	data = worker_frame_body(frame, size, &job, sizeof(job));
+	t_req(data != NULL);
+	lens[0] = job.command_len - 1;
+	lens[1] = job.env_len;
+	ok_int(worker_frame_strings(frame, size, data, strv, lens, 2), -1, "worker_frame_strings() refuses a string with the wrong length");
+	data[job.command_len] = 'x';
+	lens[0] = job.command_len;
+	ok_int(worker_frame_strings(frame, size, data, strv, lens, 2), -1, "worker_frame_strings() refuses an unterminated string");
+	ok_int(parse_command_frame(frame, size) == NULL, 1, "parse_command_frame() refuses an unterminated string");
+
+	/* a body claiming more string data than there is */
+	job.command_len = 0xfffffff0;
+	memcpy(frame + sizeof(hdr), &job, sizeof(job));
+	ok_int(parse_command_frame(frame, size) == NULL, 1, "parse_command_frame() refuses string lengths past the frame");
+	free(frame);
+}
+
+static void test_limits(void)
+{
+	struct wproc_frame_job job;
+	struct iovec strv;
+	unsigned long size = 0;
+
+	memset(&job, 0, sizeof(job));
+	strv.iov_base = NULL;
+	strv.iov_len = WPROC_FRAME_MAX;
+	ok_int(worker_build_frame(WPROC_FRAME_JOB, &job, sizeof(job), &strv, 1, &size) == NULL, 1,
+		   "worker_build_frame() won't build frames larger than WPROC_FRAME_MAX");
+}
+
+int main(int argc, char **argv)
+{
+	t_set_colors(0);
+	t_start("worker frame tests");
+
+	test_roundtrip();
+	test_truncated();
+	test_garbled();
+	test_limits();
+
+	return t_end();
+}
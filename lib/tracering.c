@@ -0,0 +1,100 @@
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "tracering.h"
+
+struct tracering {
+	unsigned int size;
+	unsigned int mask;
+	uint64_t count;
+	struct tracering_rec *recs;
+};
+
+static inline uint64_t clock_ns(clockid_t clk)
+{
+	struct timespec ts;
+
+	clock_gettime(clk, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+tracering *tracering_create(unsigned int size)
+{
+	tracering *r;
+	unsigned int rsize = 16;
+
+	while (rsize < size && rsize < (1U << 30))
+		rsize <<= 1;
+
+	if (!(r = calloc(1, sizeof(*r))))
+		return NULL;
+	if (!(r->recs = calloc(rsize, sizeof(struct tracering_rec)))) {
+		free(r);
+		return NULL;
+	}
+	r->size = rsize;
+	r->mask = rsize - 1;
+
+	return r;
+}
+
+void tracering_destroy(tracering *r)
+{
+	if (!r)
+		return;
+	free(r->recs);
+	free(r);
+}
+
+void tracering_add(tracering *r, uint32_t event, uint32_t arg0, uint64_t arg1, uint64_t arg2)
+{
+	struct tracering_rec *rec = &r->recs[r->count++ & r->mask];
+
+	rec->ns = clock_ns(CLOCK_MONOTONIC);
+	rec->event = event;
+	rec->arg0 = arg0;
+	rec->arg1 = arg1;
+	rec->arg2 = arg2;
+}
+
+uint64_t tracering_oldest(tracering *r)
+{
+	return r->count > r->size ? r->count - r->size : 0;
+}
+
+unsigned int tracering_read(tracering *r, uint64_t *pos, struct tracering_rec *recs, unsigned int max)
+{
+	unsigned int i;
+
+	if (*pos < tracering_oldest(r))
+		*pos = tracering_oldest(r);
+
+	for (i = 0; i < max && *pos < r->count; i++, (*pos)++)
+		recs[i] = r->recs[*pos & r->mask];
+
+	return i;
+}
+
+uint64_t tracering_count(tracering *r)
+{
+	return r->count;
+}
+
+unsigned int tracering_size(tracering *r)
+{
+	return r->size;
+}
+
+void tracering_header(tracering *r, struct tracering_header *hdr, uint64_t first)
+{
+	memset(hdr, 0, sizeof(*hdr));
+	memcpy(hdr->magic, TRACERING_MAGIC, sizeof(hdr->magic));
+	hdr->version = TRACERING_VERSION;
+	hdr->rec_size = sizeof(struct tracering_rec);
+	hdr->mono_ns = clock_ns(CLOCK_MONOTONIC);
+	hdr->real_ns = clock_ns(CLOCK_REALTIME);
+	hdr->first = first;
+	hdr->pid = (uint32_t)getpid();
+	hdr->size = r->size;
+}
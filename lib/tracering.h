@@ -0,0 +1,126 @@
+#ifndef LIBNAGIOS_TRACERING_H_INCLUDED
+#define LIBNAGIOS_TRACERING_H_INCLUDED
+#include <stdint.h>
+#include "lnag-utils.h"
+
+/**
+ * @file tracering.h
+ * @brief Fixed-size binary trace records in a ring buffer
+ *
+ * A tracering is a flight recorder: a ring of fixed-size records,
+ * each holding a timestamp, an event id and three integer arguments.
+ * Adding a record doesn't format anything or make any system calls
+ * apart from reading the clock, so it's cheap enough to leave in hot
+ * code paths. Once the ring is full, the oldest records are
+ * overwritten.
+ *
+ * Records are numbered from 0 as they're added, and readers keep
+ * track of the next record they want, so several readers can follow
+ * the same ring. A reader that falls more than a full ring behind
+ * loses the records that were overwritten.
+ *
+ * A tracering isn't thread-safe. It's meant to be written and read
+ * by the same thread.
+ * @{
+ */
+
+NAGIOS_BEGIN_DECL
+
+/** Primary (opaque) type for this api */
+typedef struct tracering tracering;
+
+/** A trace record, as stored and as dumped */
+struct tracering_rec {
+	uint64_t ns;    /**< CLOCK_MONOTONIC, in nanoseconds */
+	uint32_t event; /**< what happened */
+	uint32_t arg0;
+	uint64_t arg1;
+	uint64_t arg2;
+};
+
+#define TRACERING_MAGIC "NAGTRACE"
+#define TRACERING_VERSION 1
+
+/**
+ * Written ahead of dumped records, so a decoder can tell what it's
+ * looking at and turn record timestamps into wall clock time.
+ */
+struct tracering_header {
+	char magic[8];      /**< TRACERING_MAGIC, not nul-terminated */
+	uint32_t version;   /**< TRACERING_VERSION */
+	uint32_t rec_size;  /**< sizeof(struct tracering_rec) */
+	uint64_t mono_ns;   /**< CLOCK_MONOTONIC when the header was made */
+	uint64_t real_ns;   /**< CLOCK_REALTIME at the same time */
+	uint64_t first;     /**< number of the first record that follows */
+	uint32_t pid;       /**< the traced process */
+	uint32_t size;      /**< number of records the ring holds */
+};
+
+/**
+ * Create a trace ring
+ * @param[in] size Number of records. Rounded up to a power of 2
+ * @return A new ring on success, NULL on errors
+ */
+extern tracering *tracering_create(unsigned int size);
+
+/**
+ * Destroy a trace ring
+ * @param[in] r The ring to destroy
+ */
+extern void tracering_destroy(tracering *r);
+
+/**
+ * Add a record, overwriting the oldest one if the ring is full
+ * @param[in] r The ring
+ * @param[in] event The event id
+ * @param[in] arg0 First argument
+ * @param[in] arg1 Second argument
+ * @param[in] arg2 Third argument
+ */
+extern void tracering_add(tracering *r, uint32_t event, uint32_t arg0, uint64_t arg1, uint64_t arg2);
+
+/**
+ * Copy records out of a ring
+ * @param[in] r The ring
+ * @param[in,out] pos Number of the next record to copy. Moved past
+ *                    the records copied, and past any that were
+ *                    overwritten before they could be copied
+ * @param[out] recs Where to copy the records
+ * @param[in] max Max number of records to copy
+ * @return The number of records copied
+ */
+extern unsigned int tracering_read(tracering *r, uint64_t *pos, struct tracering_rec *recs, unsigned int max);
+
+/**
+ * Get the number of the oldest record still in the ring
+ * @param[in] r The ring
+ * @return The number of the oldest record
+ */
+extern uint64_t tracering_oldest(tracering *r);
+
+/**
+ * Get the number of records added to a ring since it was created
+ * @param[in] r The ring
+ * @return Number of records added, which is also the number the
+ *         next record will get
+ */
+extern uint64_t tracering_count(tracering *r);
+
+/**
+ * Get the number of records a ring holds
+ * @param[in] r The ring
+ * @return The size of the ring
+ */
+extern unsigned int tracering_size(tracering *r);
+
+/**
+ * Fill in a dump header for a ring
+ * @param[in] r The ring
+ * @param[out] hdr The header to fill in
+ * @param[in] first Number of the first record that will follow it
+ */
+extern void tracering_header(tracering *r, struct tracering_header *hdr, uint64_t first);
+
+NAGIOS_END_DECL
+/** @} */
+#endif
@@ -23,6 +23,8 @@ struct execution_information {
 	struct timeval start;
 	struct timeval stop;
 	float runtime;
+	float spawn_time; /* how long it took to get the child started */
+	unsigned int job_type; /* echoed back in framed results */
 	/* 5DEPR: rusage is deprecated for Nagios, will be removed in 5.0.0 */
 	struct rusage rusage;
 };
@@ -33,6 +35,11 @@ static unsigned int started, running_jobs, timeouts, reapable;
 static int master_sd;
 static int parent_pid;
 static fanout_table *ptab;
+static int frame_version; /* 0 means key/value vectors */
+static shmring *job_ring, *result_ring;
+
+/* forward declaration */
+static int send_frame(int type, const void *body, size_t body_size, const struct iovec *strv, int nstr);
 
 static void exit_worker(int code, const char *msg)
 {
@@ -106,6 +113,18 @@ static void wlog(const char *fmt, ...)
 		len = sizeof(lmsg) - MSG_DELIM_LEN - 1;
 	}
 
+	if (frame_version) {
+		struct wproc_frame_log body;
+		struct iovec msg;
+
+		msg.iov_base = lmsg + LOG_KEY_LEN;
+		msg.iov_len = body.msg_len = len - LOG_KEY_LEN;
+		if (send_frame(WPROC_FRAME_LOG, &body, sizeof(body), &msg, 1) < 0 && errno == EPIPE) {
+			exit_worker(1, "Failed to write() to master");
+		}
+		return;
+	}
+
 	/* Add the kv pair separator and the message delimiter. */
 	lmsg[len] = 0;
 	len++;
@@ -130,7 +149,8 @@ static void job_error(child_process *cp, struct kvvec *kvv, const char *fmt, ...
 	va_end(ap);
 	if (len < 0) {
 		/* We can't send what we can't print. */
-		kvvec_destroy(kvv, 0);
+		if (kvv)
+			kvvec_destroy(kvv, 0);
 		return;
 	}
 
@@ -140,6 +160,28 @@ static void job_error(child_process *cp, struct kvvec *kvv, const char *fmt, ...
 	}
 	msg[len] = 0;
 
+	if (frame_version) {
+		struct wproc_frame_result res;
+		struct iovec strv[4];
+
+		memset(&res, 0, sizeof(res));
+		memset(strv, 0, sizeof(strv));
+		if (cp) {
+			res.job_id = cp->id;
+			res.type = cp->ei->job_type;
+			res.timeout = cp->timeout;
+			strv[0].iov_base = cp->cmd;
+			strv[0].iov_len = res.command_len = cp->cmd ? strlen(cp->cmd) : 0;
+		}
+		res.flags = WPROC_RESULT_ERROR_MSG;
+		strv[3].iov_base = msg;
+		strv[3].iov_len = res.error_msg_len = len;
+		if (send_frame(WPROC_FRAME_RESULT, &res, sizeof(res), strv, 4) < 0 && errno == EPIPE) {
+			exit_worker(1, "Failed to send job error frame to master");
+		}
+		return;
+	}
+
 	if (cp) {
 		kvvec_addkv(kvv, "job_id", mkstr("%d", cp->id));
 	}
@@ -202,6 +244,221 @@ int worker_buf2kvvec_prealloc(struct kvvec *kvv, char *buf, unsigned long len, i
 	return buf2kvvec_prealloc(kvv, buf, len, KV_SEP, PAIR_SEP, kvv_flags);
 }
 
+void worker_set_frame_version(int version)
+{
+	frame_version = version;
+}
+
+char *worker_ioc2frame(iocache *ioc, unsigned long *size)
+{
+	struct wproc_frame_hdr hdr;
+	char *buf;
+
+	*size = 0;
+	if (iocache_available(ioc) < sizeof(hdr))
+		return NULL;
+
+	/* peek at the header; it may not be aligned */
+	buf = iocache_use_size(ioc, sizeof(hdr));
+	memcpy(&hdr, buf, sizeof(hdr));
+	iocache_unuse_size(ioc, sizeof(hdr));
+
+	if (hdr.version != WPROC_FRAME_VERSION || hdr.size < sizeof(hdr) || hdr.size > WPROC_FRAME_MAX) {
+		*size = hdr.size ? hdr.size : 1;
+		return NULL;
+	}
+
+	if (iocache_available(ioc) < hdr.size) {
+		/* make room for all of it, so we needn't grow piecemeal */
+		if (hdr.size > iocache_size(ioc))
+			iocache_grow(ioc, hdr.size);
+		return NULL;
+	}
+
+	*size = hdr.size;
+	return iocache_use_size(ioc, hdr.size);
+}
+
+unsigned long worker_frame_size(size_t body_size, const struct iovec *strv, int nstr)
+{
+	unsigned long len;
+	int i;
+
+	len = sizeof(struct wproc_frame_hdr) + body_size;
+	for (i = 0; i < nstr; i++)
+		len += strv[i].iov_len + 1;
+
+	return len;
+}
+
+void worker_write_frame(char *buf, unsigned long size, int type, const void *body, size_t body_size, const struct iovec *strv, int nstr)
+{
+	struct wproc_frame_hdr hdr;
+	char *ptr;
+	int i;
+
+	hdr.size = size;
+	hdr.version = WPROC_FRAME_VERSION;
+	hdr.type = type;
+	memcpy(buf, &hdr, sizeof(hdr));
+	ptr = buf + sizeof(hdr);
+	memcpy(ptr, body, body_size);
+	ptr += body_size;
+	for (i = 0; i < nstr; i++) {
+		if (strv[i].iov_len) {
+			memcpy(ptr, strv[i].iov_base, strv[i].iov_len);
+			ptr += strv[i].iov_len;
+		}
+		*ptr++ = 0;
+	}
+}
+
+char *worker_build_frame(int type, const void *body, size_t body_size, const struct iovec *strv, int nstr, unsigned long *size)
+{
+	unsigned long len;
+	char *buf;
+
+	len = worker_frame_size(body_size, strv, nstr);
+	if (len > WPROC_FRAME_MAX)
+		return NULL;
+
+	if (!(buf = malloc(len)))
+		return NULL;
+	worker_write_frame(buf, len, type, body, body_size, strv, nstr);
+
+	*size = len;
+	return buf;
+}
+
+/* read all of count bytes, or fail */
+static int read_all(int fd, void *buf, size_t count)
+{
+	size_t total = 0;
+	ssize_t ret;
+
+	while (total < count) {
+		ret = read(fd, (char *)buf + total, count - total);
+		if (ret < 0 && errno == EINTR)
+			continue;
+		if (ret <= 0)
+			return -1;
+		total += ret;
+	}
+
+	return 0;
+}
+
+char *worker_read_frame(int sd, unsigned long *size)
+{
+	struct wproc_frame_hdr hdr;
+	char *buf;
+
+	if (read_all(sd, &hdr, sizeof(hdr)) < 0)
+		return NULL;
+	if (hdr.version != WPROC_FRAME_VERSION || hdr.size < sizeof(hdr) || hdr.size > WPROC_FRAME_MAX)
+		return NULL;
+	if (!(buf = malloc(hdr.size)))
+		return NULL;
+	memcpy(buf, &hdr, sizeof(hdr));
+	if (read_all(sd, buf + sizeof(hdr), hdr.size - sizeof(hdr)) < 0) {
+		free(buf);
+		return NULL;
+	}
+
+	*size = hdr.size;
+	return buf;
+}
+
+int worker_set_env_frame(char *frame, unsigned long size)
+{
+	struct wproc_frame_hdr hdr;
+	struct wproc_frame_env body;
+	struct kvvec *kvv;
+	char *data, *env;
+	int i;
+
+	if (size < sizeof(hdr))
+		return -1;
+	memcpy(&hdr, frame, sizeof(hdr));
+	if (hdr.type != WPROC_FRAME_ENV)
+		return -1;
+	if (!(data = worker_frame_body(frame, size, &body, sizeof(body))))
+		return -1;
+	if (worker_frame_strings(frame, size, data, &env, &body.env_len, 1) < 0)
+		return -1;
+	if (!body.env_len)
+		return 0;
+
+	if (!(kvv = buf2kvvec(env, body.env_len, '=', '\n', 0)))
+		return -1;
+	for (i = 0; i < kvv->kv_pairs; i++)
+		setenv(kvv->kv[i].key, kvv->kv[i].value, 1);
+	kvvec_destroy(kvv, 0);
+
+	return i;
+}
+
+void worker_set_rings(shmring *jobs, shmring *results)
+{
+	job_ring = jobs;
+	result_ring = results;
+}
+
+/* frames for the master go in the result ring when there's room */
+static int send_frame(int type, const void *body, size_t body_size, const struct iovec *strv, int nstr)
+{
+	unsigned long size;
+	char *buf;
+
+	if (result_ring) {
+		size = worker_frame_size(body_size, strv, nstr);
+		if ((buf = shmring_reserve(result_ring, size))) {
+			worker_write_frame(buf, size, type, body, body_size, strv, nstr);
+			return shmring_commit(result_ring);
+		}
+	}
+
+	return worker_send_frame(master_sd, type, body, body_size, strv, nstr);
+}
+
+int worker_send_frame(int sd, int type, const void *body, size_t body_size, const struct iovec *strv, int nstr)
+{
+	unsigned long size;
+	char *buf;
+	int ret;
+
+	if (!(buf = worker_build_frame(type, body, body_size, strv, nstr, &size)))
+		return -1;
+	ret = nwrite(sd, buf, size, NULL);
+	free(buf);
+
+	return ret;
+}
+
+char *worker_frame_body(char *frame, unsigned long size, void *body, size_t body_size)
+{
+	if (size < sizeof(struct wproc_frame_hdr) + body_size)
+		return NULL;
+	memcpy(body, frame + sizeof(struct wproc_frame_hdr), body_size);
+
+	return frame + sizeof(struct wproc_frame_hdr) + body_size;
+}
+
+int worker_frame_strings(char *frame, unsigned long size, char *data, char **strv, const uint32_t *lens, int nstr)
+{
+	char *end = frame + size;
+	int i;
+
+	for (i = 0; i < nstr; i++) {
+		if (lens[i] >= (unsigned long)(end - data) || data[lens[i]])
+			return -1;
+		strv[i] = data;
+		data += lens[i] + 1;
+	}
+
+	return 0;
+}
+
 #define kvvec_add_long(kvv, key, value) \
 	do { \
 		const char *buf = mkstr("%ld", value); \
@@ -238,7 +495,8 @@ static void destroy_job(child_process *cp)
 	}
 
 	if(NULL != cp->env) kvvec_destroy(cp->env, KVVEC_FREE_ALL);
-	kvvec_destroy(cp->request, KVVEC_FREE_ALL);
+	if (cp->request)
+		kvvec_destroy(cp->request, KVVEC_FREE_ALL);
 	free(cp->cmd);
 
 	free(cp->ei);
@@ -274,12 +532,6 @@ int finish_job(child_process *cp, int reason)
 	strip_nul_bytes(cp->outstd);
 	strip_nul_bytes(cp->outerr);
 
-	/* how many key/value pairs do we need? */
-	if (kvvec_init(&resp, 12 + cp->request->kv_pairs) == NULL) {
-		/* what the hell do we do now? */
-		exit_worker(1, "Failed to init response key/value vector");
-	}
-
 	gettimeofday(&cp->ei->stop, NULL);
 
 	if (running_jobs != squeue_size(sq)) {
@@ -291,6 +543,43 @@ int finish_job(child_process *cp, int reason)
 
 	cp->ei->runtime = tv_delta_f(&cp->ei->start, &cp->ei->stop);
 
+	if (frame_version) {
+		struct wproc_frame_result res;
+		struct iovec strv[4];
+
+		memset(&res, 0, sizeof(res));
+		res.job_id = cp->id;
+		res.type = cp->ei->job_type;
+		res.timeout = cp->timeout;
+		res.flags = WPROC_RESULT_OUTPUT;
+		res.wait_status = cp->ret;
+		res.error_code = reason;
+		res.start_sec = cp->ei->start.tv_sec;
+		res.start_usec = cp->ei->start.tv_usec;
+		res.stop_sec = cp->ei->stop.tv_sec;
+		res.stop_usec = cp->ei->stop.tv_usec;
+		res.runtime = cp->ei->runtime;
+		res.time_to_spawn = cp->ei->spawn_time;
+		strv[0].iov_base = cp->cmd;
+		strv[0].iov_len = res.command_len = strlen(cp->cmd);
+		strv[1].iov_base = cp->outstd.buf;
+		strv[1].iov_len = res.outstd_len = cp->outstd.len;
+		strv[2].iov_base = cp->outerr.buf;
+		strv[2].iov_len = res.outerr_len = cp->outerr.len;
+		strv[3].iov_base = NULL;
+		strv[3].iov_len = res.error_msg_len = 0;
+		ret = send_frame(WPROC_FRAME_RESULT, &res, sizeof(res), strv, 4);
+		if (ret < 0 && errno == EPIPE)
+			exit_worker(1, "Failed to send result frame to master");
+		return 0;
+	}
+
+	/* how many key/value pairs do we need? */
+	if (kvvec_init(&resp, 12 + cp->request->kv_pairs) == NULL) {
+		/* what the hell do we do now? */
+		exit_worker(1, "Failed to init response key/value vector");
+	}
+
 	/*
 	 * Now build the return message.
 	 * First comes the request, minus environment variables
@@ -307,6 +596,7 @@ int finish_job(child_process *cp, int reason)
 	kvvec_add_tv(&resp, "start", cp->ei->start);
 	kvvec_add_tv(&resp, "stop", cp->ei->stop);
 	kvvec_addkv(&resp, "runtime", mkstr("%f", cp->ei->runtime));
+	kvvec_addkv(&resp, "time_to_spawn", mkstr("%f", cp->ei->spawn_time));
 	if (!reason) {
 		/* child exited nicely */
 		kvvec_addkv(&resp, "exited_ok", "1");
@@ -570,11 +860,15 @@ char **env_from_kvvec(struct kvvec *kvv_env) {
 int start_cmd(child_process *cp)
 {
 	int pfd[2] = {-1, -1}, pfderr[2] = {-1, -1};
+	struct timeval spawn_start, spawn_stop;
 
 	char **env = env_from_kvvec(cp->env);
 
+	gettimeofday(&spawn_start, NULL);
 	cp->outstd.fd = runcmd_open(cp->cmd, pfd, pfderr, env, 
 			cmd_iobroker_register, cp);
+	gettimeofday(&spawn_stop, NULL);
+	cp->ei->spawn_time = tv_delta_f(&spawn_start, &spawn_stop);
 	my_free(env);
 	if (cp->outstd.fd < 0) {
 		return -1;
@@ -634,6 +928,10 @@ static child_process *parse_command_kvvec(struct kvvec *kvv)
 			cp->timeout = (unsigned int)strtoul(value, &endptr, 0);
 			continue;
 		}
+		if (!strcmp(key, "type")) {
+			cp->ei->job_type = (unsigned int)strtoul(value, &endptr, 0);
+			continue;
+		}
 		if (!strcmp(key, "env")) {
 			cp->env = buf2kvvec(value, strlen(value), '=', '\n', KVVEC_COPY);
 			continue;
@@ -648,21 +946,50 @@ static child_process *parse_command_kvvec(struct kvvec *kvv)
 	return cp;
 }
 
-static void spawn_job(struct kvvec *kvv, int(*cb)(child_process *))
+static child_process *parse_command_frame(char *buf, unsigned long size)
 {
-	int result;
+	struct wproc_frame_job job;
 	child_process *cp;
+	char *data, *strv[2];
+	uint32_t lens[2];
 
-	if (!kvv) {
-		wlog("Received NULL command key/value vector. Bug in iocache.c or kvvec.c?");
-		return;
+	if (!(data = worker_frame_body(buf, size, &job, sizeof(job)))) {
+		return NULL;
+	}
+	lens[0] = job.command_len;
+	lens[1] = job.env_len;
+	if (worker_frame_strings(buf, size, data, strv, lens, 2) < 0) {
+		return NULL;
 	}
 
-	cp = parse_command_kvvec(kvv);
+	cp = calloc(1, sizeof(*cp));
 	if (!cp) {
-		job_error(NULL, kvv, "Failed to parse worker-command");
-		return;
+		wlog("Failed to calloc() a child_process struct");
+		return NULL;
 	}
+	cp->ei = calloc(1, sizeof(*cp->ei));
+	if (!cp->ei) {
+		wlog("Failed to calloc() a execution_information struct");
+		free(cp);
+		return NULL;
+	}
+
+	/* the strings live in the iocache, so we copy them too */
+	cp->id = job.job_id;
+	cp->ei->job_type = job.type;
+	cp->timeout = job.timeout ? job.timeout : 60;
+	cp->cmd = strdup(strv[0]);
+	if (job.env_len) {
+		cp->env = buf2kvvec(strv[1], job.env_len, '=', '\n', KVVEC_COPY);
+	}
+
+	return cp;
+}
+
+static void run_job(child_process *cp, struct kvvec *kvv, int(*cb)(child_process *))
+{
+	int result;
+
 	if (!cp->cmd) {
 		job_error(cp, kvv, "Failed to parse commandline. Ignoring job %u", cp->id);
 		return;
@@ -682,6 +1009,55 @@ static void spawn_job(struct kvvec *kvv, int(*cb)(child_process *))
 	}
 }
 
+static void spawn_job(struct kvvec *kvv, int(*cb)(child_process *))
+{
+	child_process *cp;
+
+	if (!kvv) {
+		wlog("Received NULL command key/value vector. Bug in iocache.c or kvvec.c?");
+		return;
+	}
+
+	cp = parse_command_kvvec(kvv);
+	if (!cp) {
+		job_error(NULL, kvv, "Failed to parse worker-command");
+		return;
+	}
+	run_job(cp, kvv, cb);
+}
+
+static void spawn_framed_job(char *buf, unsigned long size, int(*cb)(child_process *))
+{
+	struct wproc_frame_hdr hdr;
+	child_process *cp;
+
+	if (size < sizeof(hdr)) {
+		wlog("Ignoring runt frame of %lu bytes from master", size);
+		return;
+	}
+	memcpy(&hdr, buf, sizeof(hdr));
+	if (hdr.version != WPROC_FRAME_VERSION || hdr.size != size) {
+		wlog("Ignoring malformed frame from master");
+		return;
+	}
+	if (hdr.type == WPROC_FRAME_ENV) {
+		if (worker_set_env_frame(buf, size) < 0)
+			wlog("Ignoring malformed environment frame from master");
+		return;
+	}
+	if (hdr.type != WPROC_FRAME_JOB) {
+		wlog("Ignoring frame of unknown type %u from master", hdr.type);
+		return;
+	}
+
+	cp = parse_command_frame(buf, size);
+	if (!cp) {
+		job_error(NULL, NULL, "Failed to parse worker-command frame");
+		return;
+	}
+	run_job(cp, NULL, cb);
+}
+
 static int receive_command(int sd, int events, void *arg)
 {
 	int ioc_ret;
@@ -708,6 +1084,19 @@ static int receive_command(int sd, int events, void *arg)
 	write(master_sd, buf, ioc_ret);
 	return 0;
 #endif
+	if (frame_version) {
+		while ((buf = worker_ioc2frame(ioc, &size))) {
+			spawn_framed_job(buf, size, arg);
+		}
+		if (size) {
+			/* there's no finding the next frame after a bad one */
+			wlog("Garbled frame with size %lu from master. Exiting", size);
+			iobroker_close(iobs, sd);
+			exit_worker(1, NULL);
+		}
+		return 0;
+	}
+
 	/*
 	 * now loop over all inbound messages in the iocache.
 	 * Since KV_TERMINATOR is a nul-byte, they're separated by 3 nuls
@@ -723,6 +1112,21 @@ static int receive_command(int sd, int events, void *arg)
 	return 0;
 }
 
+/* the ring counterpart of receive_command() */
+static int receive_ring_jobs(int fd, int events, void *arg)
+{
+	char *buf;
+	unsigned long size;
+
+	shmring_ack(job_ring);
+	while ((buf = shmring_peek(job_ring, &size))) {
+		spawn_framed_job(buf, size, arg);
+		shmring_consume(job_ring);
+	}
+
+	return 0;
+}
+
 int worker_set_sockopts(int sd, int bufsize)
 {
 	int ret;
@@ -790,6 +1194,8 @@ void enter_worker(int sd, int (*cb)(child_process*))
 	worker_set_sockopts(master_sd, 256 * 1024);
 
 	iobroker_register(iobs, master_sd, cb, receive_command);
+	if (job_ring)
+		iobroker_register(iobs, shmring_eventfd(job_ring), cb, receive_ring_jobs);
 	while (iobroker_get_num_fds(iobs) > 0) {
 		int poll_time = -1;
 
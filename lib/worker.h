@@ -7,6 +7,8 @@
 #include <sys/wait.h>
 #include <sys/time.h>
 #include <sys/resource.h>
+#include <sys/uio.h>
+#include <stdint.h>
 #include "libnagios.h"
 
 /**
@@ -119,6 +121,187 @@ extern char *worker_ioc2msg(iocache *ioc, unsigned long *size, int flags);
  */
 extern int worker_buf2kvvec_prealloc(struct kvvec *kvv, char *buf, unsigned long len, int kvv_flags);
 
+/**
+ * @name Binary framing
+ * Workers that register with "frames=<version>" and get "OK frames=<version>"
+ * back talk to the master in length-prefixed binary frames rather than
+ * key/value vectors. Each frame is a header, a fixed-size body for its
+ * type and then the variable-length strings the body has lengths for,
+ * each one followed by a nul byte so it can be used in place. Workers
+ * talk to the master over a unix socket, so everything is in host byte
+ * order.
+ * @{
+ */
+#define WPROC_FRAME_VERSION 1 /**< The framing version we speak */
+#define WPROC_FRAME_MAX (64 * 1024 * 1024) /**< Larger frames are garbage */
+
+#define WPROC_FRAME_JOB    1 /**< master -> worker: run a job */
+#define WPROC_FRAME_RESULT 2 /**< worker -> master: a job finished or failed */
+#define WPROC_FRAME_LOG    3 /**< worker -> master: log message */
+#define WPROC_FRAME_ENV    4 /**< master -> worker: environment for all jobs */
+
+#define WPROC_RESULT_OUTPUT    (1 << 0) /**< outstd and outerr are set */
+#define WPROC_RESULT_ERROR_MSG (1 << 1) /**< error_msg is set */
+
+struct wproc_frame_hdr {
+	uint32_t size;    /**< size of the whole frame, header included */
+	uint16_t version; /**< WPROC_FRAME_VERSION */
+	uint16_t type;    /**< WPROC_FRAME_* */
+};
+
+/** followed by command and env ("key=value\n" pairs) */
+struct wproc_frame_job {
+	uint32_t job_id;
+	uint32_t type;
+	uint32_t timeout;
+	uint32_t command_len;
+	uint32_t env_len;
+};
+
+/** followed by command, outstd, outerr and error_msg */
+struct wproc_frame_result {
+	uint32_t job_id;
+	uint32_t type;
+	uint32_t timeout;
+	uint32_t flags;   /**< WPROC_RESULT_* */
+	int32_t wait_status;
+	int32_t error_code;
+	int64_t start_sec;
+	int64_t start_usec;
+	int64_t stop_sec;
+	int64_t stop_usec;
+	double runtime;
+	double time_to_spawn;
+	uint32_t command_len;
+	uint32_t outstd_len;
+	uint32_t outerr_len;
+	uint32_t error_msg_len;
+};
+
+/** followed by the message */
+struct wproc_frame_log {
+	uint32_t msg_len;
+};
+
+/** followed by env ("key=value\n" pairs) */
+struct wproc_frame_env {
+	uint32_t env_len;
+};
+
+/**
+ * Grab a complete frame from an iocache buffer. The iocache is
+ * grown if the frame doesn't fit in it.
+ * @param[in] ioc The io cache
+ * @param[out] size Out buffer for the frame size
+ * @return The frame (unaligned) on success. NULL if there isn't a
+ * complete frame yet, in which case size is 0, or if the stream is
+ * garbled or the frame is larger than WPROC_FRAME_MAX, in which case
+ * size is set to the bogus frame size.
+ */
+extern char *worker_ioc2frame(iocache *ioc, unsigned long *size);
+
+/**
+ * Build a frame from a body and the strings that go after it.
+ * Each string gets a nul byte appended.
+ * @param[in] type The frame type (WPROC_FRAME_*)
+ * @param[in] body The fixed-size body
+ * @param[in] body_size Size of the body
+ * @param[in] strv The strings to append. NULL iov_base is "".
+ * @param[in] nstr Number of strings in strv
+ * @param[out] size Out buffer for the frame size
+ * @return A malloc()'ed frame on success, NULL on errors or if the
+ * frame would be larger than WPROC_FRAME_MAX
+ */
+extern char *worker_build_frame(int type, const void *body, size_t body_size, const struct iovec *strv, int nstr, unsigned long *size);
+
+/**
+ * Calculate the size of a frame
+ * @param[in] body_size Size of the body
+ * @param[in] strv The strings that go after the body
+ * @param[in] nstr Number of strings in strv
+ * @return The size of the frame
+ */
+extern unsigned long worker_frame_size(size_t body_size, const struct iovec *strv, int nstr);
+
+/**
+ * Build a frame in a buffer the caller provides, such as a slot in
+ * a shared memory ring
+ * @param[out] buf Where to put the frame
+ * @param[in] size Size of the frame, from worker_frame_size()
+ * @see worker_build_frame()
+ */
+extern void worker_write_frame(char *buf, unsigned long size, int type, const void *body, size_t body_size, const struct iovec *strv, int nstr);
+
+/**
+ * Build a frame and send it in one go
+ * @param[in] sd The socket to send it on
+ * @return Whatever nwrite() returns
+ * @see worker_build_frame()
+ */
+extern int worker_send_frame(int sd, int type, const void *body, size_t body_size, const struct iovec *strv, int nstr);
+
+/**
+ * Copy the body of a frame out to properly aligned storage
+ * @param[in] frame The frame, as returned by worker_ioc2frame()
+ * @param[in] size Size of the frame
+ * @param[out] body Where to put the body
+ * @param[in] body_size Size of the body
+ * @return The string data following the body, or NULL if the frame
+ * is too short to hold a body of that size
+ */
+extern char *worker_frame_body(char *frame, unsigned long size, void *body, size_t body_size);
+
+/**
+ * Point a set of strings at the string data of a frame, making sure
+ * they're all nul-terminated and within the frame.
+ * @param[in] frame The frame
+ * @param[in] size Size of the frame
+ * @param[in] data The string data, as returned by worker_frame_body()
+ * @param[out] strv The strings
+ * @param[in] lens Lengths of the strings, as found in the body
+ * @param[in] nstr Number of strings
+ * @return 0 on success, -1 if the frame is malformed
+ */
+extern int worker_frame_strings(char *frame, unsigned long size, char *data, char **strv, const uint32_t *lens, int nstr);
+
+/**
+ * Read exactly one frame from a blocking socket. Meant for the
+ * registration handshake, before enter_worker() takes over.
+ * @param[in] sd The socket to read from
+ * @param[out] size Out buffer for the frame size
+ * @return A malloc()'ed frame on success, NULL on errors
+ */
+extern char *worker_read_frame(int sd, unsigned long *size);
+
+/**
+ * Put the variables of a WPROC_FRAME_ENV frame in our own
+ * environment, so every job we start inherits them. The master
+ * sends one of those to workers that register with "base_env=1"
+ * and leaves the variables out of the jobs it sends them.
+ * @param[in] frame The frame
+ * @param[in] size Size of the frame
+ * @return The number of variables set on success, -1 on errors
+ */
+extern int worker_set_env_frame(char *frame, unsigned long size);
+
+/**
+ * Make enter_worker() talk to the master in binary frames
+ * @param[in] version The version the master accepted, or 0 for
+ * key/value vectors
+ */
+extern void worker_set_frame_version(int version);
+
+/**
+ * Make enter_worker() take jobs from and send results and log
+ * messages through a pair of shared memory rings. The socket is
+ * still read for jobs, and used whenever the result ring is full.
+ * Requires framing.
+ * @param[in] jobs The ring the master puts jobs in
+ * @param[in] results The ring we put results in
+ */
+extern void worker_set_rings(shmring *jobs, shmring *results);
+/** @} */
+
 /**
  * Set some common socket options
  * @param[in] sd The socket to set options for
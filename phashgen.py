@@ -0,0 +1,271 @@
+#!/usr/bin/env python3
+#
+# A stand-in for gperf, for building the *-phash.h headers where gperf
+# isn't installed:
+#
+#   make GPERF=$PWD/phashgen.py
+#
+# It takes the subset of gperf's command line the Makefiles use
+# (-t -H <hash> -N <lookup> [--ignore-case] <file>.gperf) and writes C
+# in gperf's output layout to stdout, so the generated code is used the
+# same way whichever of the two made it. The .gperf file must have a
+# %{ %} prologue, a struct declaration and "name, value" keyword lines.
+#
+# The search is seeded, so the same input always gives the same output.
+#
+import sys, itertools, random
+
+def usage(msg):
+    sys.stderr.write("phashgen: %s\n" % msg)
+    sys.stderr.write("usage: phashgen.py [--ignore-case] -t -H <hash> -N <lookup> <file>.gperf\n")
+    sys.exit(1)
+
+def parse(path):
+    lines = open(path).read().split('\n')
+    if lines[0] != '%{' or '%}' not in lines or '%%' not in lines:
+        usage("%s isn't in the format we understand" % path)
+    end = lines.index('%}')
+    prologue = lines[1:end]
+    sep = lines.index('%%')
+    decl_line = end + 2   # 1-based line number of the struct decl
+    decl = lines[end + 1:sep]
+    keys = []
+    for n in range(sep + 1, len(lines)):
+        l = lines[n]
+        if l == '%%':
+            break
+        if not l.strip():
+            continue
+        name, code = [x.strip() for x in l.split(',', 1)]
+        keys.append((name, code, n + 1))
+    return prologue, decl, decl_line, keys
+
+def chars_of(w, pos):
+    return [w[p] if p != '$' else w[-1] for p in pos if p == '$' or p < len(w)]
+
+# key positions that, along with the length, tell all words apart
+def find_positions(words):
+    maxlen = max(len(w) for w in words)
+    cands = list(range(maxlen)) + ['$']
+    def sig(w, pos):
+        return (len(w), tuple(sorted(chars_of(w, pos))))
+    found = []
+    for k in range(1, 6):
+        for pos in itertools.combinations(cands, k):
+            s = set(sig(w, pos) for w in words)
+            if len(s) == len(words):
+                found.append(list(pos))
+                if len(found) >= 6:
+                    return found
+        if found and k >= len(found[0]) + 1:
+            return found
+    if not found:
+        usage("no set of key positions tells the keywords apart")
+    return found
+
+# find associated values giving every word a hash value of its own
+def search(words, pos, seed, scale):
+    rnd = random.Random(seed)
+    chars = sorted(set(c for w in words for c in chars_of(w, pos)))
+    wc = {w: chars_of(w, pos) for w in words}
+    R = len(words) * scale
+    asso = {c: rnd.randrange(R) for c in chars}
+    def h(w):
+        return len(w) + sum(asso[c] for c in wc[w])
+    def collisions():
+        b = {}
+        for w in words:
+            b.setdefault(h(w), []).append(w)
+        return [ws for ws in b.values() if len(ws) > 1]
+    cur = collisions()
+    for it in range(20000):
+        if not cur:
+            return asso
+        w = rnd.choice(rnd.choice(cur))
+        c = rnd.choice(wc[w])
+        old = asso[c]
+        asso[c] = rnd.randrange(R)
+        new = collisions()
+        if sum(len(x) for x in new) <= sum(len(x) for x in cur) or rnd.random() < 0.05:
+            cur = new
+        else:
+            asso[c] = old
+    return None
+
+def find_hash(words):
+    best = None
+    for scale in range(1, 9):
+        for cand in find_positions(words):
+            for seed in range(3):
+                asso = search(words, cand, seed, scale)
+                if asso is None:
+                    continue
+                mx = max(len(w) + sum(asso[c] for c in chars_of(w, cand)) for w in words)
+                if best is None or mx < best[0]:
+                    best = (mx, asso, cand)
+        if best:
+            return best
+    usage("no perfect hash found")
+
+def main():
+    args = sys.argv[1:]
+    icase = False
+    hashname = lookup = src = None
+    while args:
+        a = args.pop(0)
+        if a == '--ignore-case':
+            icase = True
+        elif a == '-t':
+            pass
+        elif a == '-H' and args:
+            hashname = args.pop(0)
+        elif a == '-N' and args:
+            lookup = args.pop(0)
+        elif not a.startswith('-') and src is None:
+            src = a
+        else:
+            usage("unsupported option '%s'" % a)
+    if not (hashname and lookup and src):
+        usage("-H, -N and an input file are required")
+
+    prologue, decl, decl_line, keys = parse(src)
+    words = [k[0] for k in keys]
+    mx, asso, pos = find_hash(words)
+    hv = {w: len(w) + sum(asso[c] for c in chars_of(w, pos)) for w in words}
+    assert len(set(hv.values())) == len(words)
+    minh = min(hv.values())
+    fill = mx + 1
+    struct = [l for l in decl if l.startswith('struct ')][0].split()[1]
+    base = src.split('/')[-1]
+
+    o = []
+    o.append('/* C code generated from %s in gperf\'s output format */' % base)
+    o.append('/* Command-line: gperf %s-t -H %s -N %s %s  */' % ('--ignore-case ' if icase else '', hashname, lookup, base))
+    o.append('/* Computed positions: -k\'%s\' */' % ','.join(str(p + 1) if p != '$' else '$' for p in sorted(pos, key=lambda p: (p == '$', p))))
+    o.append('')
+    o.append('#line 1 "%s"' % base)
+    o.extend(prologue)
+    o.append('#line %d "%s"' % (decl_line, base))
+    o.extend(decl)
+    o.append('')
+    o.append('#define TOTAL_KEYWORDS %d' % len(words))
+    o.append('#define MIN_WORD_LENGTH %d' % min(len(w) for w in words))
+    o.append('#define MAX_WORD_LENGTH %d' % max(len(w) for w in words))
+    o.append('#define MIN_HASH_VALUE %d' % minh)
+    o.append('#define MAX_HASH_VALUE %d' % mx)
+    o.append('/* maximum key range = %d, duplicates = 0 */' % (mx - minh + 1))
+    o.append('')
+    o.append('#ifdef __GNUC__\n__inline\n#else\n#ifdef __cplusplus\ninline\n#endif\n#endif')
+    o.append('static unsigned int')
+    o.append('%s (register const char *str, register size_t len)' % hashname)
+    o.append('{')
+    ctype = 'unsigned char' if fill < 256 else 'unsigned short'
+    o.append('  static %s asso_values[] =' % ctype)
+    o.append('    {')
+    vals = [asso.get(chr(i), asso.get(chr(i).upper(), fill) if icase and chr(i).isalpha() and i < 128 else fill) for i in range(256)]
+    width = len(str(max(vals)))
+    rows = []
+    for i in range(0, 256, 10):
+        rows.append('      ' + ', '.join('%*d' % (width, v) for v in vals[i:i + 10]))
+    o.append(',\n'.join(rows))
+    o.append('    };')
+    fixed = sorted([p for p in pos if p != '$'], reverse=True)
+    minlen = min(len(w) for w in words)
+    o.append('  register unsigned int hval = len;')
+    o.append('')
+    if fixed:
+        o.append('  switch (hval)')
+        o.append('    {')
+        o.append('      default:')
+        for i, p in enumerate(fixed):
+            o.append('        hval += asso_values[(unsigned char)str[%d]];' % p)
+            nxt = fixed[i + 1] if i + 1 < len(fixed) else -1
+            labels = [l for l in range(p, nxt, -1) if l >= minlen and l >= 1]
+            if i + 1 == len(fixed):
+                if labels:
+                    o.append('      /*FALLTHROUGH*/')
+                    for l in labels:
+                        o.append('      case %d:' % l)
+                o.append('        break;')
+            else:
+                o.append('      /*FALLTHROUGH*/')
+                for l in labels:
+                    o.append('      case %d:' % l)
+        o.append('    }')
+    if '$' in pos:
+        o.append('  return hval + asso_values[(unsigned char)str[len - 1]];')
+    else:
+        o.append('  return hval;')
+    o.append('}')
+    o.append('')
+    if icase:
+        o.append('#ifndef GPERF_DOWNCASE')
+        o.append('#define GPERF_DOWNCASE 1')
+        o.append('static unsigned char gperf_downcase[256] =')
+        o.append('  {')
+        dc = [i + 32 if 65 <= i <= 90 else i for i in range(256)]
+        o.append(',\n'.join('    ' + ', '.join('%3d' % v for v in dc[i:i + 15]) for i in range(0, 256, 15)))
+        o.append('  };')
+        o.append('#endif')
+        o.append('')
+        o.append('#ifndef GPERF_CASE_STRCMP')
+        o.append('#define GPERF_CASE_STRCMP 1')
+        o.append('static int')
+        o.append('gperf_case_strcmp (register const char *s1, register const char *s2)')
+        o.append('{')
+        o.append('  for (;;)')
+        o.append('    {')
+        o.append('      unsigned char c1 = gperf_downcase[(unsigned char)*s1++];')
+        o.append('      unsigned char c2 = gperf_downcase[(unsigned char)*s2++];')
+        o.append('      if (c1 != 0 && c1 == c2)')
+        o.append('        continue;')
+        o.append('      return (int)c1 - (int)c2;')
+        o.append('    }')
+        o.append('}')
+        o.append('#endif')
+        o.append('')
+    o.append('struct %s *' % struct)
+    o.append('%s (register const char *str, register size_t len)' % lookup)
+    o.append('{')
+    o.append('  static struct %s wordlist[] =' % struct)
+    o.append('    {')
+    byhash = {hv[k[0]]: k for k in keys}
+    ents = []
+    empties = []
+    for h in range(0, mx + 1):
+        if h in byhash:
+            if empties:
+                ents.append('      ' + ', '.join(empties))
+                empties = []
+            name, code, line = byhash[h]
+            ents.append('#line %d "%s"\n      {"%s", %s}' % (line, base, name, code))
+        else:
+            empties.append('{""}')
+            if len(empties) == 8:
+                ents.append('      ' + ', '.join(empties))
+                empties = []
+    if empties:
+        ents.append('      ' + ', '.join(empties))
+    o.append(',\n'.join(ents))
+    o.append('    };')
+    o.append('')
+    o.append('  if (len <= MAX_WORD_LENGTH && len >= MIN_WORD_LENGTH)')
+    o.append('    {')
+    o.append('      register unsigned int key = %s (str, len);' % hashname)
+    o.append('')
+    o.append('      if (key <= MAX_HASH_VALUE)')
+    o.append('        {')
+    o.append('          register const char *s = wordlist[key].name;')
+    o.append('')
+    if icase:
+        o.append('          if ((((unsigned char)*str ^ (unsigned char)*s) & ~32) == 0 && !gperf_case_strcmp (str, s))')
+    else:
+        o.append('          if (*str == *s && !strcmp (str + 1, s + 1))')
+    o.append('            return &wordlist[key];')
+    o.append('        }')
+    o.append('    }')
+    o.append('  return 0;')
+    o.append('}')
+    sys.stdout.write('\n'.join(o) + '\n')
+
+main()
@@ -4,11 +4,13 @@ void schedule_host_check(host *hst, time_t check_time, int options)
 void schedule_service_check(service *svc, time_t check_time, int options) 
 { }
 
+#ifndef TEST_COMMANDS
 int handle_async_host_check_result(host *temp_host, check_result *queued_check_result) 
 { return OK; }
 
 int handle_async_service_check_result(service *temp_service, check_result *queued_check_result) 
 { return OK; }
+#endif
 
 int reap_check_results(void) 
 { return OK; }
@@ -28,6 +30,24 @@ void check_host_result_freshness(void)
 void check_for_orphaned_hosts(void) 
 { }
 
+void update_host_freshness(host *hst) 
+{ }
+
+void update_service_freshness(service *svc) 
+{ }
+
+void free_freshness_index(void) 
+{ }
+
+void invalidate_host_check_template(host *hst)
+{ }
+
+void invalidate_service_check_template(service *svc)
+{ }
+
+void free_check_templates(void)
+{ }
+
 #ifndef TEST_EVENTS_C
 
 int run_scheduled_service_check(service *svc, int check_options, double latency) 
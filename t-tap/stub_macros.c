@@ -29,3 +29,18 @@ int clear_argv_macros_r(nagios_macros *mac)
 
 int set_all_macro_environment_vars_r(nagios_macros *mac, int set) 
 { return OK; }
+
+command_template *compile_command_template(command *cmd_ptr, char *cmd)
+{ return NULL; }
+
+void free_command_template(command_template *tpl)
+{ }
+
+int command_template_matches(command_template *tpl, command *cmd_ptr, char *cmd)
+{ return FALSE; }
+
+int expand_command_template_r(nagios_macros *mac, command_template *tpl, char **output_buffer, int options)
+{ return ERROR; }
+
+int set_environment_macro_filter(const char *list)
+{ return OK; }
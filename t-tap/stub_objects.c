@@ -1,8 +1,10 @@
+#ifndef TEST_COMMANDS
 service *find_service(const char *host_name, const char *svc_desc) 
 { return NULL; }
 
 host *find_host(const char *name) 
 { return NULL; }
+#endif
 
 hostgroup *find_hostgroup(const char *name) 
 { return NULL; }
@@ -30,3 +32,12 @@ int free_objectlist(objectlist **temp_list)
 
 int free_object_data(void) 
 { return OK; }
+
+customvariablesmember *find_host_custom_variable(host *hst, const char *name)
+{ return NULL; }
+
+customvariablesmember *find_service_custom_variable(service *svc, const char *name)
+{ return NULL; }
+
+customvariablesmember *find_contact_custom_variable(contact *cntct, const char *name)
+{ return NULL; }
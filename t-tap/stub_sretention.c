@@ -3,3 +3,6 @@ int read_initial_state_information(void)
 
 int save_state_information(int autosave) 
 { }
+
+int sync_retention_journal(void)
+{ }
@@ -1534,6 +1534,341 @@ void run_reaper_tests()
 
 }
 
+void run_output_reuse_tests()
+{
+    char *buf;
+
+    create_objects(STATE_UP, HARD_STATE, "host up", STATE_OK, HARD_STATE, "service up");
+
+    create_check_result(CHECK_TYPE_ACTIVE, STATE_OK, "service ok 1");
+    handle_svc1();
+    buf = svc1->plugin_output;
+
+    create_check_result(CHECK_TYPE_ACTIVE, STATE_OK, "service ok 2");
+    handle_svc1();
+    ok(svc1->plugin_output == buf,
+        "plugin output buffer is reused between checks");
+    ok(!strcmp(svc1->plugin_output, "service ok 2"),
+        "reused buffer has the new output, got '%s'", svc1->plugin_output);
+
+    /* stalking needs the old output to compare with */
+    svc1->stalking_options = 1 << STATE_OK;
+    create_check_result(CHECK_TYPE_ACTIVE, STATE_OK, "service ok 3");
+    handle_svc1();
+    ok(svc1_logs == 1,
+        "stalked service logs changed output");
+    ok(!strcmp(svc1->plugin_output, "service ok 3"),
+        "stalked service has the new output, got '%s'", svc1->plugin_output);
+
+    create_check_result(CHECK_TYPE_ACTIVE, STATE_OK, "service ok 3");
+    handle_svc1();
+    ok(svc1_logs == 0,
+        "stalked service doesn't log unchanged output");
+}
+
+void run_freshness_tests()
+{
+    time_t now = time(NULL);
+
+    create_objects(STATE_UP, HARD_STATE, "host up", STATE_OK, HARD_STATE, "service up");
+
+    num_objects.hosts = 1;
+    num_objects.services = 1;
+    host_ary = &hst1;
+    service_ary = &svc1;
+    check_host_freshness = TRUE;
+    check_service_freshness = TRUE;
+
+    svc1->check_freshness = TRUE;
+    svc1->freshness_threshold = 300;
+    svc1->last_check = now;
+    hst1->check_freshness = TRUE;
+    hst1->freshness_threshold = 300;
+    hst1->last_check = now;
+
+    /* the index is built on first use */
+    check_service_result_freshness();
+    check_host_result_freshness();
+    ok(svc1->is_being_freshened == FALSE && hst1->is_being_freshened == FALSE,
+        "fresh results aren't freshened");
+
+    /* a deadline that passes is only noticed once it's recalculated */
+    svc1->last_check = now - 1000;
+    hst1->last_check = now - 1000;
+    check_service_result_freshness();
+    check_host_result_freshness();
+    ok(svc1->is_being_freshened == FALSE && hst1->is_being_freshened == FALSE,
+        "stale results aren't noticed before their deadline is updated");
+
+    update_service_freshness(svc1);
+    update_host_freshness(hst1);
+    check_service_result_freshness();
+    check_host_result_freshness();
+    ok(svc1->is_being_freshened == TRUE && svc1->next_check_event != NULL,
+        "stale service is freshened");
+    ok(hst1->is_being_freshened == TRUE && hst1->next_check_event != NULL,
+        "stale host is freshened");
+    my_free(svc1->next_check_event);
+    my_free(hst1->next_check_event);
+
+    /* objects being freshened are out of the index until their status is updated */
+    svc1->is_being_freshened = FALSE;
+    check_service_result_freshness();
+    ok(svc1->is_being_freshened == FALSE,
+        "freshened service isn't popped again");
+    update_service_freshness(svc1);
+    check_service_result_freshness();
+    ok(svc1->is_being_freshened == TRUE,
+        "freshened service is requeued when its status is updated");
+    my_free(svc1->next_check_event);
+
+    /* a deadline that moved on without an update is requeued, not freshened */
+    svc1->is_being_freshened = FALSE;
+    update_service_freshness(svc1);
+    svc1->last_check = now;
+    check_service_result_freshness();
+    ok(svc1->is_being_freshened == FALSE && svc1->next_check_event == NULL,
+        "service that became fresh again isn't freshened");
+    svc1->last_check = now - 1000;
+    check_service_result_freshness();
+    ok(svc1->is_being_freshened == FALSE,
+        "requeued service waits for its new deadline");
+
+    /* objects that don't want freshness checks are dropped from the index */
+    svc1->check_freshness = FALSE;
+    update_service_freshness(svc1);
+    svc1->check_freshness = TRUE;
+    check_service_result_freshness();
+    ok(svc1->is_being_freshened == FALSE,
+        "service without freshness checking isn't freshened");
+
+    /* a rebuilt index picks up every object again */
+    free_freshness_index();
+    check_service_result_freshness();
+    ok(svc1->is_being_freshened == TRUE,
+        "rebuilt index finds the stale service");
+    my_free(svc1->next_check_event);
+
+    free_freshness_index();
+    num_objects.hosts = 0;
+    num_objects.services = 0;
+    host_ary = NULL;
+    service_ary = NULL;
+}
+
+void run_freshness_input_tests()
+{
+    time_t now = time(NULL);
+
+    create_objects(STATE_UP, HARD_STATE, "host up", STATE_OK, HARD_STATE, "service up");
+
+    num_objects.hosts = 1;
+    num_objects.services = 1;
+    host_ary = &hst1;
+    service_ary = &svc1;
+    check_host_freshness = TRUE;
+    check_service_freshness = TRUE;
+    interval_length = 60;
+    additional_freshness_latency = 15;
+
+    svc1->check_freshness = TRUE;
+    svc1->freshness_threshold = 300;
+    svc1->last_check = now;
+    svc1->checks_enabled = TRUE;
+    hst1->check_freshness = TRUE;
+    hst1->freshness_threshold = 300;
+    hst1->last_check = now;
+    hst1->checks_enabled = TRUE;
+
+    check_service_result_freshness();
+    check_host_result_freshness();
+    ok(get_service_freshness_deadline(svc1) == now + 300 && get_host_freshness_deadline(hst1) == now + 300,
+        "freshness index has both deadlines");
+
+    /* every input to a deadline moves it once the object is updated */
+    svc1->freshness_threshold = 600;
+    update_service_freshness(svc1);
+    ok(get_service_freshness_deadline(svc1) == now + 600,
+        "changing the freshness threshold moves the deadline");
+
+    svc1->last_check = now + 60;
+    update_service_freshness(svc1);
+    ok(get_service_freshness_deadline(svc1) == now + 660,
+        "changing the last check moves the deadline");
+
+    svc1->check_freshness = FALSE;
+    update_service_freshness(svc1);
+    ok(get_service_freshness_deadline(svc1) == 0,
+        "disabling freshness checks takes the service off the index");
+    svc1->check_freshness = TRUE;
+    update_service_freshness(svc1);
+    ok(get_service_freshness_deadline(svc1) == now + 660,
+        "enabling them puts it back");
+
+    svc1->checks_enabled = FALSE;
+    update_service_freshness(svc1);
+    ok(get_service_freshness_deadline(svc1) == now + 660,
+        "a service that only takes passive checks stays on the index");
+    svc1->accept_passive_checks = FALSE;
+    update_service_freshness(svc1);
+    ok(get_service_freshness_deadline(svc1) == 0,
+        "a service that takes no checks at all is taken off");
+    svc1->checks_enabled = TRUE;
+    update_service_freshness(svc1);
+    ok(get_service_freshness_deadline(svc1) == now + 660,
+        "enabling active checks puts it back");
+    svc1->accept_passive_checks = TRUE;
+
+    svc1->freshness_threshold = 0;
+    svc1->latency = 0;
+    update_service_freshness(svc1);
+    ok(get_service_freshness_deadline(svc1) == now + 60 + 5 * 60 + 15,
+        "without a threshold the check interval sets the deadline");
+    svc1->check_interval = 10;
+    update_service_freshness(svc1);
+    ok(get_service_freshness_deadline(svc1) == now + 60 + 10 * 60 + 15,
+        "changing the check interval moves the deadline");
+    svc1->state_type = SOFT_STATE;
+    svc1->current_state = STATE_CRITICAL;
+    update_service_freshness(svc1);
+    ok(get_service_freshness_deadline(svc1) == now + 60 + 1 * 60 + 15,
+        "a soft problem state uses the retry interval");
+    svc1->check_interval = 0;
+    update_service_freshness(svc1);
+    ok(get_service_freshness_deadline(svc1) == 0,
+        "a service without a check interval or threshold is taken off");
+    svc1->check_interval = 5;
+    svc1->freshness_threshold = 300;
+    svc1->state_type = HARD_STATE;
+    svc1->current_state = STATE_OK;
+
+    svc1->has_been_checked = FALSE;
+    update_service_freshness(svc1);
+    ok(get_service_freshness_deadline(svc1) == event_start + 300,
+        "a service that was never checked goes stale after program start");
+    svc1->has_been_checked = TRUE;
+
+    /* check results update the status, which updates the deadline */
+    create_check_result(CHECK_TYPE_PASSIVE, STATE_OK, "service ok");
+    handle_svc1();
+    ok(svc1->last_check == ORIG_START_TIME && get_service_freshness_deadline(svc1) == ORIG_START_TIME + 300,
+        "a service check result moves the deadline");
+
+    hst1->freshness_threshold = 600;
+    update_host_freshness(hst1);
+    ok(get_host_freshness_deadline(hst1) == now + 600,
+        "changing a host's freshness threshold moves its deadline");
+    hst1->last_check = now + 60;
+    update_host_freshness(hst1);
+    ok(get_host_freshness_deadline(hst1) == now + 660,
+        "changing its last check moves it");
+    hst1->checks_enabled = FALSE;
+    hst1->accept_passive_checks = FALSE;
+    update_host_freshness(hst1);
+    ok(get_host_freshness_deadline(hst1) == 0,
+        "a host that takes no checks is taken off the index");
+    hst1->checks_enabled = TRUE;
+    hst1->accept_passive_checks = TRUE;
+    hst1->freshness_threshold = 300;
+
+    create_check_result(CHECK_TYPE_ACTIVE, HOST_UP, "host up");
+    hst1->is_executing = TRUE;
+    handle_hst1();
+    ok(hst1->last_check == ORIG_START_TIME && get_host_freshness_deadline(hst1) == ORIG_START_TIME + 300,
+        "a host check result moves the deadline");
+
+    free_freshness_index();
+    num_objects.hosts = 0;
+    num_objects.services = 0;
+    host_ary = NULL;
+    service_ary = NULL;
+}
+
+void run_lost_check_tests()
+{
+    create_objects(STATE_UP, HARD_STATE, "host up", STATE_OK, HARD_STATE, "service up");
+    hst1->checks_enabled = TRUE;
+    svc1->checks_enabled = TRUE;
+
+    svc1->is_executing = TRUE;
+    currently_running_service_checks = 1;
+    reschedule_lost_service_check(svc1);
+    ok(svc1->is_executing == FALSE && currently_running_service_checks == 0,
+        "lost service check no longer counts as running");
+    ok(svc1->next_check_event != NULL && (svc1->check_options & CHECK_OPTION_ORPHAN_CHECK),
+        "lost service check is scheduled again");
+    my_free(svc1->next_check_event);
+
+    currently_running_service_checks = 1;
+    reschedule_lost_service_check(svc1);
+    ok(svc1->next_check_event == NULL && currently_running_service_checks == 1,
+        "service that isn't executing is left alone");
+    currently_running_service_checks = 0;
+
+    hst1->is_executing = TRUE;
+    currently_running_host_checks = 1;
+    reschedule_lost_host_check(hst1);
+    ok(hst1->is_executing == FALSE && currently_running_host_checks == 0,
+        "lost host check no longer counts as running");
+    ok(hst1->next_check_event != NULL && (hst1->check_options & CHECK_OPTION_ORPHAN_CHECK),
+        "lost host check is scheduled again");
+    my_free(hst1->next_check_event);
+}
+
+void run_parse_output_tests()
+{
+    char *short_output = NULL;
+    char *long_output = NULL;
+    char *perf_data = NULL;
+    char buf[256];
+
+    strcpy(buf, " short output |perf=1\nlong 1\nlong 2|perf=2\nperf=3");
+    parse_check_output(buf, &short_output, &long_output, &perf_data, TRUE, FALSE);
+    ok(short_output && !strcmp(short_output, "short output"),
+        "short output is stripped, got '%s'", short_output);
+    ok(long_output && !strcmp(long_output, "long 1\\nlong 2"),
+        "long output has escaped newlines, got '%s'", long_output);
+    ok(perf_data && !strcmp(perf_data, "perf=1 perf=2 perf=3"),
+        "perf data is collected from all lines, got '%s'", perf_data);
+    ok(!strcmp(buf, " short output |perf=1"),
+        "first line keeps its perf data separator, got '%s'", buf);
+    my_free(short_output);
+    my_free(long_output);
+    my_free(perf_data);
+
+    strcpy(buf, "|perf=1");
+    parse_check_output(buf, &short_output, &long_output, &perf_data, TRUE, FALSE);
+    ok(short_output && !*short_output,
+        "leading separator gives empty short output");
+    ok(perf_data && !strcmp(perf_data, "perf=1"),
+        "leading separator keeps perf data, got '%s'", perf_data);
+    my_free(short_output);
+    my_free(long_output);
+    my_free(perf_data);
+
+    strcpy(buf, "\nlong only");
+    parse_check_output(buf, &short_output, &long_output, &perf_data, TRUE, FALSE);
+    ok(short_output == NULL,
+        "empty first line gives no short output");
+    ok(long_output && !strcmp(long_output, "long only"),
+        "long output without short output, got '%s'", long_output);
+    ok(perf_data == NULL,
+        "no perf data");
+    my_free(short_output);
+    my_free(long_output);
+    my_free(perf_data);
+
+    strcpy(buf, "ok|\\nlong");
+    parse_check_output(buf, &short_output, &long_output, &perf_data, TRUE, TRUE);
+    ok(short_output && !strcmp(short_output, "ok"),
+        "escaped newlines are unescaped, got '%s'", short_output);
+    ok(perf_data == NULL,
+        "empty perf data is ignored");
+    my_free(short_output);
+    my_free(long_output);
+    my_free(perf_data);
+}
+
 int main(int argc, char **argv)
 {
     char cwd[1024];
@@ -1551,7 +1886,7 @@ int main(int argc, char **argv)
     accept_passive_service_checks   = TRUE;
 
     /* Increment this when the check_reaper test is fixed */
-    plan_tests(452);
+    plan_tests(501);
 
     time(&now);
 
@@ -1567,6 +1902,11 @@ int main(int argc, char **argv)
 
     run_misc_host_check_tests(now);
     run_reaper_tests();
+    run_parse_output_tests();
+    run_output_reuse_tests();
+    run_freshness_tests();
+    run_freshness_input_tests();
+    run_lost_check_tests();
 
     return exit_status();
 }
@@ -59,6 +59,8 @@
 
 #include "tap.h"
 
+#include "../base/commands.c"
+
 char *temp_path;
 extern int date_format;
 host *host_list;
@@ -125,11 +127,165 @@ void reset_vars() {
 
 hostgroup *temp_hostgroup = NULL;
 
+/* the objects passive check results are for, and what was done with them */
+static host test_host;
+static service test_service;
+static char *test_svc_lookup = NULL;
+static char test_output[256];
+static int test_return_code = -1;
+static int host_results = 0;
+static int service_results = 0;
+
+host *find_host(const char *name) {
+	return (name && !strcmp(name, "host1")) ? &test_host : NULL;
+	}
+
+service *find_service(const char *host_name, const char *svc_desc) {
+	my_free(test_svc_lookup);
+	test_svc_lookup = svc_desc ? strdup(svc_desc) : NULL;
+	return (svc_desc && !strcmp(svc_desc, "svc1")) ? &test_service : NULL;
+	}
+
+static void save_check_result(check_result *cr) {
+	strncpy(test_output, cr->output ? cr->output : "(null)", sizeof(test_output) - 1);
+	test_return_code = cr->return_code;
+	}
+
+int handle_async_host_check_result(host *temp_host, check_result *queued_check_result) {
+	host_results++;
+	save_check_result(queued_check_result);
+	return OK;
+	}
+
+int handle_async_service_check_result(service *temp_service, check_result *queued_check_result) {
+	service_results++;
+	save_check_result(queued_check_result);
+	return OK;
+	}
+
+static void reset_results(void) {
+	host_results = service_results = 0;
+	test_return_code = -1;
+	*test_output = 0;
+	my_free(test_svc_lookup);
+	}
+
+/* runs a single command from a writable copy, checking it's given back intact */
+static int run_command(const char *cmd, int *intact) {
+	char *buf = strdup(cmd);
+	int result;
+
+	result = process_external_command1(buf);
+	*intact = !strcmp(buf, cmd);
+	free(buf);
+
+	return result;
+	}
+
+static void test_cmd_args(void) {
+	struct cmd_args ca;
+	char args[] = "a;;b;c;d;e;f;g;h;i;j";
+	char *tok[CMD_ARGS_MAX_TOKENS + 1];
+	int i;
+
+	cmd_args_init(&ca, args);
+	ok(!strcmp(cmd_args_next(&ca, ';'), "a"), "cmd_args_next() returns the first token");
+	ok(!strcmp(cmd_args_next(&ca, ';'), ""), "...and empty ones");
+	for(i = 0; i < CMD_ARGS_MAX_TOKENS - 2; i++)
+		tok[i] = cmd_args_next(&ca, ';');
+	ok(tok[CMD_ARGS_MAX_TOKENS - 3] && !strcmp(tok[CMD_ARGS_MAX_TOKENS - 3], "g"), "...up to the last one it has room to cut");
+	tok[CMD_ARGS_MAX_TOKENS] = cmd_args_next(&ca, ';');
+	ok(tok[CMD_ARGS_MAX_TOKENS] && !strcmp(tok[CMD_ARGS_MAX_TOKENS], "h;i;j"), "The rest is the last token once it's out of room") || diag("token=%s", tok[CMD_ARGS_MAX_TOKENS]);
+	ok(cmd_args_next(&ca, ';') == NULL, "...and then there's nothing left");
+	cmd_args_restore(&ca);
+	ok(!strcmp(args, "a;;b;c;d;e;f;g;h;i;j"), "cmd_args_restore() puts the separators back");
+	}
+
+static void test_passive_results(void) {
+	int intact = FALSE;
+
+	test_host.name = "host1";
+	test_host.address = "127.0.0.1";
+	test_host.accept_passive_checks = TRUE;
+	host_list = &test_host;
+	test_service.host_name = "host1";
+	test_service.description = "svc1";
+	test_service.accept_passive_checks = TRUE;
+	accept_passive_service_checks = TRUE;
+	accept_passive_host_checks = TRUE;
+
+	reset_results();
+	ok(run_command("[1234567890] PROCESS_SERVICE_CHECK_RESULT;host1;svc1;2;Disk full", &intact) == CMD_ERROR_OK, "A passive service check result is processed");
+	ok(service_results == 1 && test_return_code == 2 && !strcmp(test_output, "Disk full"), "...with its return code and output");
+	ok(intact, "...and the command is given back the way it was");
+
+	reset_results();
+	ok(run_command("[1234567890] process_service_check_result;127.0.0.1;svc1;1;lower", &intact) == CMD_ERROR_OK, "Command names are case-insensitive");
+	ok(service_results == 1 && test_return_code == 1 && !strcmp(test_output, "lower"), "...and hosts are found by their address");
+
+	reset_results();
+	ok(run_command("[1234567890] PROCESS_SERVICE_CHECK_RESULT;host1;;0;out", &intact) == CMD_ERROR_FAILURE, "An empty service description is refused");
+	ok(service_results == 0 && test_svc_lookup && !strcmp(test_svc_lookup, ""), "...after looking for a service without a name");
+	ok(intact, "...and the command is given back the way it was");
+
+	reset_results();
+	ok(run_command("[1234567890] PROCESS_SERVICE_CHECK_RESULT;host1;svc1;0;", &intact) == CMD_ERROR_OK, "Empty output is fine");
+	ok(service_results == 1 && !strcmp(test_output, ""), "...and passed on as such");
+
+	reset_results();
+	ok(run_command("[1234567890] PROCESS_SERVICE_CHECK_RESULT;host1;svc1;0;a;b;c;d;e;f;g;h;i", &intact) == CMD_ERROR_OK, "Output with lots of semicolons is fine");
+	ok(!strcmp(test_output, "a;b;c;d;e;f;g;h;i"), "...and kept in one piece");
+	ok(intact, "...and the command is given back the way it was");
+
+	reset_results();
+	ok(run_command("[1234567890] PROCESS_HOST_CHECK_RESULT;host1;;host output", &intact) == CMD_ERROR_OK, "A host check result with an empty return code is processed");
+	ok(host_results == 1 && test_return_code == 0 && !strcmp(test_output, "host output"), "...as an UP result");
+
+	reset_results();
+	ok(run_command("PROCESS_HOST_CHECK_RESULT;host1;0;no entry time", &intact) == CMD_ERROR_MALFORMED_COMMAND, "A command not starting with '[' is malformed");
+	ok(run_command("", &intact) == CMD_ERROR_MALFORMED_COMMAND, "...as is an empty one");
+	ok(run_command("[1234567890]", &intact) == CMD_ERROR_MALFORMED_COMMAND, "...and one with just an entry time");
+	ok(run_command("[1234567890] NO_SUCH_COMMAND;host1", &intact) == CMD_ERROR_UNKNOWN_COMMAND && intact, "Unknown commands are refused and given back intact");
+	ok(host_results == 0, "...and none of them got anywhere");
+
+	/* aliases run the same command as the names they stand in for */
+	enable_notifications = TRUE;
+	ok(run_command("[1234567890] enter_standby_mode", &intact) == CMD_ERROR_OK && enable_notifications == FALSE, "ENTER_STANDBY_MODE disables notifications");
+	ok(run_command("[1234567890] Enter_Active_Mode", &intact) == CMD_ERROR_OK && enable_notifications == TRUE, "ENTER_ACTIVE_MODE enables them");
+	}
+
+static void test_batch(void) {
+	const char input[] =
+		"[1234567890] PROCESS_SERVICE_CHECK_RESULT;host1;svc1;2;first\n"
+		"garbage without an entry time\n"
+		"\n"
+		"[1234567890] Process_Host_Check_Result;host1;1;second\n"
+		"[1234567890] PROCESS_SERVICE_CHECK_RESULT;host1;;0;empty service\n"
+		"[1234567890] PROCESS_SERVICE_CHECK_RESULT;host1;svc1;0;third\n"
+		"[1234567890] PROCESS_SERVICE_CHECK_RESULT;host1;svc1;0;part";
+	char *buf = strdup(input);
+	unsigned long size = sizeof(input) - 1, used;
+
+	reset_results();
+	used = process_external_command_batch(buf, size);
+	ok(used == (unsigned long)(strrchr(input, '\n') - input + 1), "A batch uses up to the last newline") || diag("used %lu of %lu", used, size);
+	ok(!strcmp(buf + used, "[1234567890] PROCESS_SERVICE_CHECK_RESULT;host1;svc1;0;part"), "...leaving the partial last line");
+	ok(service_results == 2 && host_results == 1, "Every complete, good command was processed");
+	ok(!strcmp(test_output, "third"), "...in order");
+	ok(!memcmp(buf, input, size), "The buffer is the same after processing as before");
+	ok(cmd_batch.active == FALSE && cmd_batch.last_host == NULL, "The batch state is reset afterwards");
+
+	reset_results();
+	ok(process_external_command_batch(buf, used) == used && service_results == 2, "Processing it again gives the same result");
+	ok(process_external_command_batch(buf + used, size - used) == 0 && service_results == 2, "A lone partial line is left alone");
+	free(buf);
+	}
+
 int
 main() {
 	time_t now = 0L;
 
-	plan_tests(62);
+	plan_tests(98);
 
 	ok(test_start_time == 0L, "Start time is empty");
 	ok(test_comment == NULL, "And test_comment is blank");
@@ -226,6 +382,9 @@ main() {
 	ok(test_servicename == NULL, "servicename right") || diag("servicename=%s", test_servicename);
 	ok(strcmp(test_comment, "comment") == 0, "comment right") || diag("comment=%s", test_comment);
 
+	test_cmd_args();
+	test_passive_results();
+	test_batch();
 
 	return exit_status();
 	}
@@ -49,6 +49,8 @@ timed_event *event_list_high_tail = NULL;
 
 extern scheduled_downtime *scheduled_downtime_list;
 
+void journal_downtime(scheduled_downtime *temp_downtime, int deleted) {}
+
 int main(int argc, char **argv)
 {
     time_t now                = 0L;
@@ -80,6 +80,8 @@ int adjust_service_check(service * svc, time_t next_check)
     svc->next_check = next_check;
 }
 
+void qh_trace_flush(void) {}
+
 int c = 0;
 
 int update_program_status(int aggregated_dump)
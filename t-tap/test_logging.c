@@ -41,6 +41,10 @@ char *log_archive_path              = "var";
 int log_current_states              = DEFAULT_LOG_CURRENT_STATES;
 int log_service_retries             = DEFAULT_LOG_SERVICE_RETRIES;
 int use_large_installation_tweaks   = DEFAULT_USE_LARGE_INSTALLATION_TWEAKS;
+int use_log_thread                  = DEFAULT_USE_LOG_THREAD;
+unsigned long log_thread_buffer_size = DEFAULT_LOG_THREAD_BUFFER_SIZE;
+int log_overflow_policy             = DEFAULT_LOG_OVERFLOW_POLICY;
+int log_fsync_interval              = DEFAULT_LOG_FSYNC_INTERVAL;
 
 
 char *saved_source;
@@ -75,7 +79,7 @@ int main(int argc, char **argv)
     char *temp_command = NULL;
     struct tm *t;
 
-    plan_tests(14);
+    plan_tests(19);
 
     rotation_time = (time_t)1242949698;
     t = localtime(&rotation_time);
@@ -119,6 +123,26 @@ int main(int argc, char **argv)
     ok(stat_info.st_mode == stat_new.st_mode, "Mode for new log file kept same as original log file");
     unlink(log_filename_localtime);
 
+    /* rotations queued for the log thread split the log in the same place */
+    use_log_thread = TRUE;
+    logging_options = NSLOG_INFO_MESSAGE | NSLOG_PROCESS_INFO;
+    log_fsync_interval = LOG_FSYNC_BATCH;
+    ok(start_log_thread() == OK, "Started the log thread");
+    write_to_log("logged before rotation", NSLOG_INFO_MESSAGE, &rotation_time);
+    ok(rotate_log_file(rotation_time) == OK, "Log rotation is queued for the log thread");
+    write_to_log("logged after rotation", NSLOG_INFO_MESSAGE, &rotation_time);
+    stop_log_thread();
+    free_my_saved_chars();
+
+    asprintf(&temp_command, "grep -q 'logged before rotation' %s && ! grep -q 'logged after rotation' %s", log_filename_localtime, log_filename_localtime);
+    ok(system(temp_command) == 0, "Messages logged before the rotation are archived");
+    my_free(temp_command);
+    ok(system("grep -q 'logged after rotation' var/nagios.log && ! grep -q 'logged before rotation' var/nagios.log") == 0, "Messages logged after the rotation go to the new log file");
+    ok(system("grep -q 'LOG ROTATION: HOURLY' var/nagios.log") == 0, "Rotation is recorded in the new log file");
+    unlink(log_filename_localtime);
+    logging_options = 0;
+    use_log_thread = FALSE;
+
     my_free(log_filename_localtime);
     close_log_file();
     
@@ -351,19 +351,140 @@ void test_escaping(nagios_macros *mac)
     ALLOC_MACROS("$TOTALSERVICESCRITICALUNHANDLED$");
 }
 
+/*
+    Compiled templates must expand to exactly what process_macros_r() does
+*/
+void test_templates(nagios_macros *mac)
+{
+    const char *strings[] = {
+        "$HOSTNAME$ '&%",
+        "$HOSTOUTPUT$ $HOSTADDRESS$ $SERVICEDESC$",
+        "$HOSTNOTESURL$ '&% $$ $$$",
+        "plain text",
+        "$NOTAMACRO$ and a stray $",
+        "$ARG1$ $ARG99$ $USER1$ $HOSTNAME:name'&%$",
+        "$",
+        "",
+    };
+    int opts[] = { NO_OPTIONS, STRIP_ILLEGAL_MACRO_CHARS | ESCAPE_MACRO_CHARS, URL_ENCODE_MACRO_CHARS };
+    char *expected = NULL, *output = NULL, *raw = NULL;
+    macro_template *tpl;
+    command_template *ctpl;
+    command cmd = { 0 };
+    unsigned int i, j;
+    int same = 1;
+
+    for (i = 0; i < sizeof(strings) / sizeof(strings[0]); i++) {
+        tpl = compile_macro_template(strings[i]);
+        for (j = 0; j < sizeof(opts) / sizeof(opts[0]); j++) {
+            process_macros_r(mac, (char *)strings[i], &expected, opts[j]);
+            expand_macro_template_r(mac, tpl, &output, opts[j]);
+            if (!output || strcmp(output, expected)) {
+                diag("'%s' (%d): '%s' != '%s'", strings[i], opts[j], output, expected);
+                same = 0;
+            }
+            my_free(expected);
+            my_free(output);
+        }
+        free_macro_template(tpl);
+    }
+    ok(same, "Compiled templates expand like process_macros_r");
+
+    cmd.name = "check_it";
+    cmd.command_line = "/bin/check -H $HOSTADDRESS$ -w $ARG1$ -c $ARG2$ -x '$ARG3$' $$";
+    ctpl = compile_command_template(&cmd, "check_it!10\\!20!$ARG1$/$HOSTNAME$!$HOSTOUTPUT$");
+    get_raw_command_line_r(mac, &cmd, "check_it!10\\!20!$ARG1$/$HOSTNAME$!$HOSTOUTPUT$", &raw, STRIP_ILLEGAL_MACRO_CHARS);
+    process_macros_r(mac, raw, &expected, STRIP_ILLEGAL_MACRO_CHARS);
+    expand_command_template_r(mac, ctpl, &output, STRIP_ILLEGAL_MACRO_CHARS);
+    ok(output && !strcmp(output, expected), "Compiled command lines expand like the raw ones: '%s' == '%s'", output, expected);
+    ok(command_template_matches(ctpl, &cmd, NULL) == FALSE, "Templates don't match other check commands");
+    my_free(raw);
+    my_free(expected);
+    my_free(output);
+    free_command_template(ctpl);
+    clear_argv_macros_r(mac);
+}
+
+/*
+    Custom variables come out the same with and without the index
+*/
+void test_custom_variables(nagios_macros *mac)
+{
+    host *hosts[1];
+    customvariablesmember *cv, *next;
+    char *output = NULL, name[16], value[16];
+    int i;
+
+    for (i = 0; i < 20; i++) {
+        sprintf(name, "VAR%d", i);
+        sprintf(value, "value%d", i);
+        add_custom_variable_to_host(hst1, name, value);
+    }
+    add_custom_variable_to_host(hst1, "VAR3", "shadowed");
+
+    RUN_MACRO_TEST("$_HOSTVAR3$ $_HOSTVAR19$ $_HOSTNOPE$", "shadowed value19 $_HOSTNOPE$", NO_OPTIONS);
+
+    hosts[0] = hst1;
+    host_ary = hosts;
+    num_objects.hosts = 1;
+    ok(init_custom_variable_index() == OK, "Custom variables are indexed");
+    RUN_MACRO_TEST("$_HOSTVAR3$ $_HOSTVAR19$ $_HOSTNOPE$", "shadowed value19 $_HOSTNOPE$", NO_OPTIONS);
+    cv = find_host_custom_variable(hst1, "VAR7");
+    ok(cv && !strcmp(cv->variable_value, "value7"), "Indexed lookups find the list members");
+    ok(find_host_custom_variable(hst1, "VAR") == NULL, "Indexed lookups don't match prefixes");
+
+    free_custom_variable_index();
+    host_ary = NULL;
+    num_objects.hosts = 0;
+    for (cv = hst1->custom_variables; cv; cv = next) {
+        next = cv->next;
+        my_free(cv->variable_name);
+        my_free(cv->variable_value);
+        my_free(cv);
+    }
+    hst1->custom_variables = NULL;
+}
+
+/*
+    Only whitelisted macros make it to the environment
+*/
+void test_environment_filter(nagios_macros *mac)
+{
+    struct kvvec *kvv;
+
+    enable_environment_macros = TRUE;
+    ok(set_environment_macro_filter("HOSTNAME, ARG1,MAINCONFIGFILE,_HOSTFOO") == OK, "Environment macro whitelist is accepted");
+
+    kvv = env_macros_to_kvv(mac, ENV_MACROS_VOLATILE);
+    ok(kvv && kvv->kv_pairs == 2 && !strcmp(kvv->kv[0].key, "NAGIOS_HOSTNAME") && !strcmp(kvv->kv[1].key, "NAGIOS_ARG1"),
+        "Only the listed volatile macros are exported");
+    kvvec_destroy(kvv, KVVEC_FREE_KEYS);
+
+    kvv = env_macros_to_kvv(mac, ENV_MACROS_CONSTANT);
+    ok(kvv && kvv->kv_pairs == 1 && !strcmp(kvv->kv[0].key, "NAGIOS_MAINCONFIGFILE"), "Constant macros are exported separately");
+    kvvec_destroy(kvv, KVVEC_FREE_KEYS);
+
+    ok(set_environment_macro_filter("HOSTNAME,NOSUCHMACRO") == ERROR, "Unknown macros in the whitelist are rejected");
+    set_environment_macro_filter(NULL);
+    enable_environment_macros = FALSE;
+}
+
 /*****************************************************************************/
 /*                             Main function                                 */
 /*****************************************************************************/
 
 int main(void) {
 
-    plan_tests(23);
+    plan_tests(35);
 
     reset_variables();
     setup_environment();
     setup_objects();
 
     test_escaping(mac);
+    test_templates(mac);
+    test_custom_variables(mac);
+    test_environment_filter(mac);
 
     free_memory(mac);
     free(mac);
@@ -58,6 +58,9 @@
 
 int xrddefault_read_state_information(void);
 
+void journal_comment(nagios_comment *temp_comment, int deleted) {}
+void journal_downtime(scheduled_downtime *temp_downtime, int deleted) {}
+
 int main(int argc, char **argv) {
 	int result;
 	int error = FALSE;
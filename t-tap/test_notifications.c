@@ -0,0 +1,292 @@
+/*****************************************************************************
+ *
+ * test_notifications.c - Test notification recipient lists
+ *
+ * Program: Nagios Core Testing
+ * License: GPL
+ *
+ * Description:
+ *
+ * Tests that the contact fanout lists hold every contact an object
+ * notifies exactly once, that contact marks keep each round of
+ * add_notification() calls free of duplicates, and that
+ * $NOTIFICATIONRECIPIENTS$ lists the recipients in the order they
+ * were added.
+ *
+ * License:
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ *****************************************************************************/
+
+#define NSCORE 1
+#include "../base/notifications.c"
+#include "../include/comments.h"
+#include "../include/downtime.h"
+#include "tap.h"
+#include "stub_downtime.c"
+#include "stub_perfdata.c"
+#include "stub_workers.c"
+#include "stub_netutils.c"
+#include "stub_comments.c"
+#include "stub_broker.c"
+#include "stub_nebmods.c"
+
+#define TEST_CONFIG_DIR "var/notify-test"
+
+nagios_comment *comment_list = NULL;
+scheduled_downtime *scheduled_downtime_list = NULL;
+
+/* Dummy functions */
+void logit(int data_type, int display, const char *fmt, ...) {}
+int write_to_log(char *buffer, unsigned long data_type, time_t *timestamp) { return 0; }
+int log_debug_info(int level, int verbosity, const char *fmt, ...) { return 0; }
+void journal_host_state(host *hst) {}
+void journal_service_state(service *svc) {}
+void journal_contact_state(contact *cntct) {}
+void journal_program_state(void) {}
+void update_host_freshness(host *hst) {}
+void update_service_freshness(service *svc) {}
+int close_command_file(void) { return 0; }
+int close_log_file(void) { return 0; }
+int fix_log_file_owner(uid_t uid, gid_t gid) { return 0; }
+int handle_async_service_check_result(service *temp_service, check_result *queued_check_result) { return 0; }
+int handle_async_host_check_result(host *temp_host, check_result *queued_check_result) { return 0; }
+void free_freshness_index(void) {}
+void free_check_templates(void) {}
+timed_event *schedule_new_event(int event_type, int high_priority, time_t run_time, int recurring, unsigned long event_interval, void *timing_func, int compensate_for_time_change, void *event_data, void *event_args, int event_options) { return NULL; }
+int write_to_all_logs(char *buffer, unsigned long data_type) { return OK; }
+int update_host_status(host *hst, int aggregated_dump) { return OK; }
+int update_service_status(service *svc, int aggregated_dump) { return OK; }
+int check_host_dependencies(host *hst, int dependency_type) { return DEPENDENCIES_OK; }
+int check_service_dependencies(service *svc, int dependency_type) { return DEPENDENCIES_OK; }
+int wproc_notify(char *cname, char *hname, char *sdesc, char *cmd, nagios_macros *mac) { return OK; }
+int broker_notification_data(int type, int flags, int attr, int notification_type, int reason_type, struct timeval start_time, struct timeval end_time, void *data, char *ack_author, char *ack_data, int escalated, int contacts_notified, struct timeval *timestamp) { return OK; }
+int broker_contact_notification_data(int type, int flags, int attr, int notification_type, int reason_type, struct timeval start_time, struct timeval end_time, void *data, contact *cntct, char *ack_author, char *ack_data, int escalated, struct timeval *timestamp) { return OK; }
+int broker_contact_notification_method_data(int type, int flags, int attr, int notification_type, int reason_type, struct timeval start_time, struct timeval end_time, void *data, contact *cntct, char *cmd, char *ack_author, char *ack_data, int escalated, struct timeval *timestamp) { return OK; }
+
+
+/*
+ * contacts c1-c5, with the groups and objects listing them so that
+ * most of them are reachable more than one way
+ */
+static void write_test_config(void) {
+	FILE *fp;
+	int i;
+
+	mkdir(TEST_CONFIG_DIR, 0755);
+	fp = fopen(TEST_CONFIG_DIR "/nagios.cfg", "w");
+	fprintf(fp, "cfg_file=objects.cfg\n");
+	fclose(fp);
+
+	fp = fopen(TEST_CONFIG_DIR "/objects.cfg", "w");
+	fprintf(fp, "define timeperiod {\n\ttimeperiod_name\tnone\n\talias\tnone\n}\n");
+	fprintf(fp, "define command {\n\tcommand_name\tcheck_me\n\tcommand_line\t/bin/true\n}\n");
+	for(i = 1; i <= 5; i++) {
+		fprintf(fp, "define contact {\n\tcontact_name\tc%d-with-a-fairly-long-contact-name\n", i);
+		fprintf(fp, "\thost_notification_period\tnone\n\tservice_notification_period\tnone\n");
+		fprintf(fp, "\thost_notification_commands\tcheck_me\n\tservice_notification_commands\tcheck_me\n}\n");
+		}
+	fprintf(fp, "define contactgroup {\n\tcontactgroup_name\tg1\n\talias\tg1\n");
+	fprintf(fp, "\tmembers\tc2-with-a-fairly-long-contact-name,c3-with-a-fairly-long-contact-name\n}\n");
+	fprintf(fp, "define contactgroup {\n\tcontactgroup_name\tg2\n\talias\tg2\n");
+	fprintf(fp, "\tmembers\tc3-with-a-fairly-long-contact-name,c4-with-a-fairly-long-contact-name,c1-with-a-fairly-long-contact-name\n}\n");
+	fprintf(fp, "define host {\n\thost_name\thost1\n\talias\thost1\n\taddress\t127.0.0.1\n\tmax_check_attempts\t1\n");
+	fprintf(fp, "\tcheck_period\tnone\n\tnotification_interval\t60\n\tnotification_period\tnone\n");
+	fprintf(fp, "\tcontacts\tc1-with-a-fairly-long-contact-name,c3-with-a-fairly-long-contact-name\n\tcontact_groups\tg1,g2\n}\n");
+	fprintf(fp, "define service {\n\thost_name\thost1\n\tservice_description\tsvc1\n\tcheck_command\tcheck_me\n");
+	fprintf(fp, "\tmax_check_attempts\t1\n\tcheck_interval\t5\n\tretry_interval\t1\n\tcheck_period\tnone\n");
+	fprintf(fp, "\tnotification_interval\t60\n\tnotification_period\tnone\n\tcontact_groups\tg2\n}\n");
+	fprintf(fp, "define service {\n\thost_name\thost1\n\tservice_description\tsvc2\n\tcheck_command\tcheck_me\n");
+	fprintf(fp, "\tmax_check_attempts\t1\n\tcheck_interval\t5\n\tretry_interval\t1\n\tcheck_period\tnone\n");
+	fprintf(fp, "\tnotification_interval\t60\n\tnotification_period\tnone\n\tcontacts\tc5-with-a-fairly-long-contact-name\n}\n");
+	fclose(fp);
+	}
+
+
+static void remove_test_config(void) {
+	unlink(TEST_CONFIG_DIR "/objects.cfg");
+	unlink(TEST_CONFIG_DIR "/nagios.cfg");
+	rmdir(TEST_CONFIG_DIR);
+	}
+
+
+/*
+ * checks a fanout list against the contacts and contact groups it was
+ * built from: every contact once, in the order they're first found
+ */
+static int fanout_matches(struct contact_fanout *fo, contactsmember *contacts, contactgroupsmember *groups) {
+	contact *expect[16];
+	contactsmember *cm;
+	contactgroupsmember *cgm;
+	unsigned int i, n = 0;
+
+#define EXPECT(c) do { \
+		for(i = 0; i < n && expect[i] != (c); i++) \
+			; \
+		if(i == n) \
+			expect[n++] = (c); \
+		} while(0)
+
+	for(cm = contacts; cm; cm = cm->next)
+		EXPECT(cm->contact_ptr);
+	for(cgm = groups; cgm; cgm = cgm->next) {
+		for(cm = cgm->group_ptr->members; cm; cm = cm->next)
+			EXPECT(cm->contact_ptr);
+		}
+
+	if(fo->count != n)
+		return FALSE;
+	for(i = 0; i < n; i++) {
+		if(fo->contacts[i] != expect[i])
+			return FALSE;
+		}
+
+	return TRUE;
+	}
+
+
+/* the recipients macro for a list of contacts, in the order given */
+static char *expected_recipients(contact **list, int n) {
+	static char buf[1024];
+	int i;
+
+	*buf = 0;
+	for(i = 0; i < n; i++) {
+		if(i)
+			strcat(buf, ",");
+		strcat(buf, list[i]->name);
+		}
+
+	return buf;
+	}
+
+
+static int notification_list_length(void) {
+	notification *temp_notification;
+	int len = 0;
+
+	for(temp_notification = notification_list; temp_notification; temp_notification = temp_notification->next)
+		len++;
+
+	return len;
+	}
+
+
+int main(int argc, char **argv) {
+	nagios_macros mac;
+	contact *c[6], *order[6];
+	host *hst;
+	service *svc1, *svc2;
+	char *old_recipients;
+	int i;
+
+	plan_tests(21);
+
+	init_main_cfg_vars(1);
+	init_shared_cfg_vars(1);
+	write_test_config();
+	ok(read_object_config_data(TEST_CONFIG_DIR "/nagios.cfg", READ_ALL_OBJECT_DATA) == OK, "Read the test config");
+	for(i = 1; i <= 5; i++) {
+		char name[64];
+		snprintf(name, sizeof(name), "c%d-with-a-fairly-long-contact-name", i);
+		c[i] = find_contact(name);
+		}
+	hst = find_host("host1");
+	svc1 = find_service("host1", "svc1");
+	svc2 = find_service("host1", "svc2");
+	ok(hst && svc1 && svc2 && c[1] && c[5], "Found the test objects");
+
+	/* fanout */
+	ok(init_contact_fanout() == OK, "Built the contact fanout lists");
+	ok(host_contact_fanout[hst->id].count == 4, "The host notifies four contacts, each once") || diag("count=%u", host_contact_fanout[hst->id].count);
+	ok(fanout_matches(&host_contact_fanout[hst->id], hst->contacts, hst->contact_groups), "...in the order they're first listed");
+	ok(fanout_matches(&service_contact_fanout[svc1->id], svc1->contacts, svc1->contact_groups), "A service notifying a group gets its members");
+	ok(service_contact_fanout[svc2->id].count == 1 && service_contact_fanout[svc2->id].contacts[0] == c[5], "A service notifying one contact gets just that");
+	ok(service_contact_fanout[svc1->id].contacts >= host_contact_fanout[hst->id].contacts + host_contact_fanout[hst->id].count ||
+	   service_contact_fanout[svc1->id].contacts + service_contact_fanout[svc1->id].count <= host_contact_fanout[hst->id].contacts,
+	   "Lists sharing the pool don't overlap");
+
+	/* contact marks */
+	new_contact_marks();
+	ok(mark_contact(c[1]) == TRUE && mark_contact(c[2]) == TRUE, "Contacts not seen in a round are marked");
+	ok(mark_contact(c[1]) == FALSE, "...and found marked the next time");
+	new_contact_marks();
+	ok(mark_contact(c[1]) == TRUE && mark_contact(c[2]) == TRUE, "A new round forgets the old marks");
+
+	/* the recipients macro */
+	memset(&mac, 0, sizeof(mac));
+	add_notification(&mac, c[3]);
+	add_notification(&mac, c[1]);
+	add_notification(&mac, c[3]);
+	add_notification(&mac, c[5]);
+	add_notification(&mac, c[1]);
+	add_notification(&mac, c[2]);
+	order[0] = c[3];
+	order[1] = c[1];
+	order[2] = c[5];
+	order[3] = c[2];
+	ok(notification_list_length() == 4, "Contacts added twice are on the notification list once");
+	ok(mac.x[MACRO_NOTIFICATIONRECIPIENTS] && !strcmp(mac.x[MACRO_NOTIFICATIONRECIPIENTS], expected_recipients(order, 4)),
+	   "$NOTIFICATIONRECIPIENTS$ has the recipients in the order they were added, past its first allocation") || diag("got '%s'", mac.x[MACRO_NOTIFICATIONRECIPIENTS]);
+
+	/* the next notification starts over, both with the marks and the macro */
+	free_notification_list();
+	my_free(mac.x[MACRO_NOTIFICATIONRECIPIENTS]);
+	add_notification(&mac, c[1]);
+	add_notification(&mac, c[4]);
+	ok(notification_list_length() == 2, "A new list doesn't remember who was on the last one");
+	order[0] = c[1];
+	order[1] = c[4];
+	ok(mac.x[MACRO_NOTIFICATIONRECIPIENTS] && !strcmp(mac.x[MACRO_NOTIFICATIONRECIPIENTS], expected_recipients(order, 2)),
+	   "...and neither does its recipients macro") || diag("got '%s'", mac.x[MACRO_NOTIFICATIONRECIPIENTS]);
+
+	/* a macro someone else set is added to */
+	free_notification_list();
+	my_free(mac.x[MACRO_NOTIFICATIONRECIPIENTS]);
+	mac.x[MACRO_NOTIFICATIONRECIPIENTS] = strdup("someone");
+	add_notification(&mac, c[2]);
+	ok(!strcmp(mac.x[MACRO_NOTIFICATIONRECIPIENTS], "someone,c2-with-a-fairly-long-contact-name"), "Recipients are appended to a macro that was already set");
+
+	/* ...even when it's replaced halfway through a list */
+	old_recipients = mac.x[MACRO_NOTIFICATIONRECIPIENTS];
+	mac.x[MACRO_NOTIFICATIONRECIPIENTS] = strdup("replaced");
+	free(old_recipients);
+	add_notification(&mac, c[4]);
+	ok(!strcmp(mac.x[MACRO_NOTIFICATIONRECIPIENTS], "replaced,c4-with-a-fairly-long-contact-name"), "...or replaced halfway through a list");
+	add_notification(&mac, c[2]);
+	ok(notification_list_length() == 2 && !strcmp(mac.x[MACRO_NOTIFICATIONRECIPIENTS], "replaced,c4-with-a-fairly-long-contact-name"), "...which still doesn't get anyone twice");
+
+	/* and a macro set of its own for every list */
+	free_notification_list();
+	my_free(mac.x[MACRO_NOTIFICATIONRECIPIENTS]);
+	{
+		nagios_macros mac2;
+
+		memset(&mac2, 0, sizeof(mac2));
+		add_notification(&mac2, c[5]);
+		ok(mac2.x[MACRO_NOTIFICATIONRECIPIENTS] && !strcmp(mac2.x[MACRO_NOTIFICATIONRECIPIENTS], "c5-with-a-fairly-long-contact-name"), "A list built with another macro set has its own recipients");
+		ok(mac.x[MACRO_NOTIFICATIONRECIPIENTS] == NULL, "...and leaves the first one alone");
+		free_notification_list();
+		my_free(mac2.x[MACRO_NOTIFICATIONRECIPIENTS]);
+	}
+
+	ok(notification_list == NULL, "The notification list is empty at the end");
+
+	free_contact_fanout();
+	free_object_data();
+	remove_test_config();
+
+	return exit_status();
+	}
@@ -0,0 +1,254 @@
+/*****************************************************************************
+ *
+ * test_object_config.c - Test parallel object config parsing
+ *
+ * Program: Nagios Core Testing
+ * License: GPL
+ *
+ * Description:
+ *
+ * Tests that reading the object configuration on several threads gives
+ * the same objects, and reports the same errors in the same order, as
+ * reading it on one.
+ *
+ * License:
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ *****************************************************************************/
+
+#define NSCORE 1
+#include "../include/config.h"
+#include "../include/common.h"
+#include "../include/objects.h"
+#include "../include/comments.h"
+#include "../include/downtime.h"
+#include "../include/statusdata.h"
+#include "../include/macros.h"
+#include "../include/nagios.h"
+#include "../include/sretention.h"
+#include "../include/perfdata.h"
+#include "../include/broker.h"
+#include "../include/nebmods.h"
+#include "../include/nebmodules.h"
+#include "tap.h"
+#include "stub_downtime.c"
+#include "stub_perfdata.c"
+#include "stub_workers.c"
+#include "stub_netutils.c"
+#include "stub_comments.c"
+#include "stub_notifications.c"
+#include "stub_broker.c"
+#include "stub_nebmods.c"
+
+#define TEST_CONFIG_DIR "var/objcfg-test"
+#define TEST_CONFIG_FILES 40
+#define TEST_CONFIG_HOSTS 10
+
+nagios_comment *comment_list = NULL;
+scheduled_downtime *scheduled_downtime_list = NULL;
+
+/* everything logged while reading the config, in order */
+static char *config_log = NULL;
+static size_t config_log_len = 0;
+
+/* Dummy functions */
+void logit(int data_type, int display, const char *fmt, ...) {
+	char *buf = NULL;
+	va_list ap;
+	int len;
+
+	va_start(ap, fmt);
+	len = vasprintf(&buf, fmt, ap);
+	va_end(ap);
+	if(len < 0)
+		return;
+	config_log = realloc(config_log, config_log_len + len + 1);
+	memcpy(config_log + config_log_len, buf, len + 1);
+	config_log_len += len;
+	free(buf);
+	}
+int write_to_log(char *buffer, unsigned long data_type, time_t *timestamp) { return 0; }
+int log_debug_info(int level, int verbosity, const char *fmt, ...) { return 0; }
+void journal_host_state(host *hst) {}
+void journal_service_state(service *svc) {}
+void journal_contact_state(contact *cntct) {}
+void journal_program_state(void) {}
+void update_host_freshness(host *hst) {}
+void update_service_freshness(service *svc) {}
+int close_command_file(void) { return 0; }
+int close_log_file(void) { return 0; }
+int fix_log_file_owner(uid_t uid, gid_t gid) { return 0; }
+int handle_async_service_check_result(service *temp_service, check_result *queued_check_result) { return 0; }
+int handle_async_host_check_result(host *temp_host, check_result *queued_check_result) { return 0; }
+void free_freshness_index(void) {}
+void free_check_templates(void) {}
+timed_event *schedule_new_event(int event_type, int high_priority, time_t run_time, int recurring, unsigned long event_interval, void *timing_func, int compensate_for_time_change, void *event_data, void *event_args, int event_options) { return NULL; }
+
+
+/* the files in extra/ and extra-dir/ are only read through includes */
+static const char *test_config_subdir(int i) {
+
+	if(i % 10)
+		return "objects";
+
+	return i < TEST_CONFIG_FILES / 2 ? "extra" : "extra-dir";
+	}
+
+
+/*
+ * writes a config with lots of files to tokenize, includes to
+ * follow and the same service defined in every file
+ */
+static void write_test_config(int broken) {
+	char path[256];
+	FILE *fp;
+	int i, x;
+
+	mkdir(TEST_CONFIG_DIR, 0755);
+	mkdir(TEST_CONFIG_DIR "/objects", 0755);
+	mkdir(TEST_CONFIG_DIR "/extra", 0755);
+	mkdir(TEST_CONFIG_DIR "/extra-dir", 0755);
+
+	fp = fopen(TEST_CONFIG_DIR "/nagios.cfg", "w");
+	fprintf(fp, "cfg_file=../../smallconfig/minimal.cfg\ncfg_dir=objects\n");
+	fclose(fp);
+
+	for(i = 0; i < TEST_CONFIG_FILES; i++) {
+		snprintf(path, sizeof(path), TEST_CONFIG_DIR "/%s/hosts-%02d.cfg", test_config_subdir(i), i);
+		fp = fopen(path, "w");
+		for(x = 0; x < TEST_CONFIG_HOSTS; x++) {
+			fprintf(fp, "define host {\n\thost_name\tgen-%02d-%02d\n\talias\tgen %d %d\n\taddress\t10.0.%d.%d\n", i, x, i, x, i, x);
+			fprintf(fp, "\tmax_check_attempts\t%d\n\tcheck_period\tnone\n\tcontacts\tnagiosadmin\n", x % 5 + 1);
+			fprintf(fp, "\tnotification_interval\t60\n\tnotification_period\tnone\n\thostgroups\thostgroup1, hostgroup2\n}\n");
+			}
+		fprintf(fp, "define service {\n\thost_name\thost1\n\tservice_description\tShared service\n");
+		fprintf(fp, "\tcheck_command\tcheck_me!%d\n\tmax_check_attempts\t3\n\tcheck_interval\t5\n\tretry_interval\t1\n", i);
+		fprintf(fp, "\tcheck_period\tnone\n\tnotification_interval\t60\n\tnotification_period\tnone\n\tcontacts\tnagiosadmin\n}\n");
+		fprintf(fp, "define service {\n\thost_name\tgen-%02d-00, gen-%02d-01, gen-%02d-02\n", i, i, i);
+		fprintf(fp, "\tservice_description\tGenerated service %d\n\tcheck_command\tcheck_me!%d\n", i, i);
+		fprintf(fp, "\tmax_check_attempts\t3\n\tcheck_interval\t5\n\tretry_interval\t1\n\tcheck_period\tnone\n");
+		fprintf(fp, "\tnotification_interval\t60\n\tnotification_period\tnone\n\tcontacts\tnagiosadmin\n}\n");
+		if(broken == TRUE && i == TEST_CONFIG_FILES / 2)
+			fprintf(fp, "define host {\n\thost_name\tbroken\n\tno_such_directive\t1\n}\n");
+
+		if(i == 1 || i == 11)
+			fprintf(fp, "include_file=" TEST_CONFIG_DIR "/extra/hosts-%02d.cfg\n", i - 1);
+		if(i == 5)
+			fprintf(fp, "include_dir=" TEST_CONFIG_DIR "/extra-dir/\n");
+		fclose(fp);
+		}
+	}
+
+
+static void remove_test_config(void) {
+	char path[256];
+	int i;
+
+	for(i = 0; i < TEST_CONFIG_FILES; i++) {
+		snprintf(path, sizeof(path), TEST_CONFIG_DIR "/%s/hosts-%02d.cfg", test_config_subdir(i), i);
+		unlink(path);
+		}
+	unlink(TEST_CONFIG_DIR "/nagios.cfg");
+	rmdir(TEST_CONFIG_DIR "/objects");
+	rmdir(TEST_CONFIG_DIR "/extra");
+	rmdir(TEST_CONFIG_DIR "/extra-dir");
+	rmdir(TEST_CONFIG_DIR);
+	}
+
+
+/* reads the test config and caches the resulting objects */
+static int read_test_config(int threads, const char *cache_file) {
+	int result;
+
+	free_object_data();
+	my_free(config_log);
+	config_log_len = 0;
+	object_config_threads = threads;
+	result = read_object_config_data(TEST_CONFIG_DIR "/nagios.cfg", READ_ALL_OBJECT_DATA);
+	if(result == OK)
+		fcache_objects((char *)cache_file);
+
+	return result;
+	}
+
+
+/* compares two object caches, ignoring when they were created */
+static int same_objects(const char *file1, const char *file2) {
+	char line1[8192], line2[8192];
+	FILE *fp1, *fp2;
+	int same = FALSE, lines = 0;
+
+	fp1 = fopen(file1, "r");
+	fp2 = fopen(file2, "r");
+	if(fp1 && fp2) {
+		while(1) {
+			char *l1 = fgets(line1, sizeof(line1), fp1);
+			char *l2 = fgets(line2, sizeof(line2), fp2);
+
+			if(l1 == NULL || l2 == NULL) {
+				same = (l1 == l2 && lines > 0);
+				break;
+				}
+			if(strncmp(line1, "# Created:", 10) && strcmp(line1, line2))
+				break;
+			lines++;
+			}
+		}
+	if(fp1)
+		fclose(fp1);
+	if(fp2)
+		fclose(fp2);
+
+	return same;
+	}
+
+
+int main(int argc, char **argv) {
+	char *serial_log = NULL;
+	int result;
+
+	plan_tests(7);
+
+	init_main_cfg_vars(1);
+	init_shared_cfg_vars(1);
+	write_test_config(FALSE);
+
+	result = read_test_config(1, "var/objcfg-serial.cache");
+	ok(result == OK && num_objects.hosts == TEST_CONFIG_FILES * TEST_CONFIG_HOSTS + 2, "Read the config on one thread");
+	serial_log = config_log ? strdup(config_log) : NULL;
+	ok(serial_log != NULL && strstr(serial_log, "Duplicate definition found for service 'Shared service'") != NULL, "Duplicate definitions are warned about");
+
+	result = read_test_config(8, "var/objcfg-parallel.cache");
+	ok(result == OK && same_objects("var/objcfg-serial.cache", "var/objcfg-parallel.cache"), "Reading it on several threads gives the same objects");
+	ok(config_log != NULL && !strcmp(config_log, serial_log), "...and the same warnings in the same order");
+	my_free(serial_log);
+
+	/* a config error stops both at the same place */
+	write_test_config(TRUE);
+	result = read_test_config(1, NULL);
+	serial_log = config_log ? strdup(config_log) : NULL;
+	ok(result == ERROR && serial_log != NULL && strstr(serial_log, "no_such_directive") != NULL, "A broken config fails on one thread");
+	result = read_test_config(8, NULL);
+	ok(result == ERROR, "...and on several");
+	ok(config_log != NULL && !strcmp(config_log, serial_log), "Both report the same errors in the same order");
+	my_free(serial_log);
+
+	free_object_data();
+	unlink("var/objcfg-serial.cache");
+	unlink("var/objcfg-parallel.cache");
+	remove_test_config();
+
+	return exit_status();
+	}
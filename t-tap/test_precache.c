@@ -0,0 +1,242 @@
+/*****************************************************************************
+ *
+ * test_precache.c - Test the binary object precache
+ *
+ * Program: Nagios Core Testing
+ * License: GPL
+ *
+ * Description:
+ *
+ * Tests that objects read back from a binary precache are the ones that
+ * were written to it, and that truncated or corrupted precaches are
+ * refused instead of being read.
+ *
+ * License:
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ *****************************************************************************/
+
+#define NSCORE 1
+#include "../include/config.h"
+#include "../include/common.h"
+#include "../include/objects.h"
+#include "../include/comments.h"
+#include "../include/downtime.h"
+#include "../include/statusdata.h"
+#include "../include/macros.h"
+#include "../include/nagios.h"
+#include "../include/sretention.h"
+#include "../include/perfdata.h"
+#include "../include/broker.h"
+#include "../include/nebmods.h"
+#include "../include/nebmodules.h"
+#include "../xdata/xodbinary.h"
+#include "tap.h"
+#include "stub_downtime.c"
+#include "stub_perfdata.c"
+#include "stub_workers.c"
+#include "stub_netutils.c"
+#include "stub_comments.c"
+#include "stub_notifications.c"
+#include "stub_broker.c"
+#include "stub_nebmods.c"
+
+#define TEST_PRECACHE "var/precache-test.bin"
+#define TEST_BROKEN_PRECACHE "var/precache-broken.bin"
+
+nagios_comment *comment_list = NULL;
+scheduled_downtime *scheduled_downtime_list = NULL;
+
+/* the last thing logged */
+static char last_log[1024];
+
+/* Dummy functions */
+void logit(int data_type, int display, const char *fmt, ...) {
+	va_list ap;
+
+	va_start(ap, fmt);
+	vsnprintf(last_log, sizeof(last_log), fmt, ap);
+	va_end(ap);
+	}
+int write_to_log(char *buffer, unsigned long data_type, time_t *timestamp) { return 0; }
+int log_debug_info(int level, int verbosity, const char *fmt, ...) { return 0; }
+void journal_host_state(host *hst) {}
+void journal_service_state(service *svc) {}
+void journal_contact_state(contact *cntct) {}
+void journal_program_state(void) {}
+void update_host_freshness(host *hst) {}
+void update_service_freshness(service *svc) {}
+int close_command_file(void) { return 0; }
+int close_log_file(void) { return 0; }
+int fix_log_file_owner(uid_t uid, gid_t gid) { return 0; }
+int handle_async_service_check_result(service *temp_service, check_result *queued_check_result) { return 0; }
+int handle_async_host_check_result(host *temp_host, check_result *queued_check_result) { return 0; }
+void free_freshness_index(void) {}
+void free_check_templates(void) {}
+timed_event *schedule_new_event(int event_type, int high_priority, time_t run_time, int recurring, unsigned long event_interval, void *timing_func, int compensate_for_time_change, void *event_data, void *event_args, int event_options) { return NULL; }
+
+
+static char *precache = NULL;
+static size_t precache_size = 0;
+
+static int load_precache(void) {
+	struct stat st;
+	int fd;
+
+	if((fd = open(TEST_PRECACHE, O_RDONLY)) < 0 || fstat(fd, &st) < 0)
+		return ERROR;
+	precache_size = st.st_size;
+	precache = malloc(precache_size);
+	if(precache == NULL || read(fd, precache, precache_size) != (ssize_t)precache_size) {
+		close(fd);
+		return ERROR;
+		}
+	close(fd);
+
+	return OK;
+	}
+
+
+/* writes the first len bytes of the precache, with buf in place of the original */
+static int read_broken_precache(const char *buf, size_t len) {
+	int fd;
+
+	if((fd = open(TEST_BROKEN_PRECACHE, O_WRONLY | O_CREAT | O_TRUNC, 0644)) < 0)
+		return ERROR;
+	if(write(fd, buf, len) != (ssize_t)len) {
+		close(fd);
+		return ERROR;
+		}
+	close(fd);
+
+	*last_log = 0;
+	free_object_data();
+	if(xodbinary_read_precache(TEST_BROKEN_PRECACHE) == OK)
+		return OK;
+
+	return ERROR;
+	}
+
+
+static int read_truncated_precache(size_t len) {
+	return read_broken_precache(precache, len);
+	}
+
+
+/* compares two object caches, ignoring when they were created */
+static int same_objects(const char *file1, const char *file2) {
+	char line1[8192], line2[8192];
+	FILE *fp1, *fp2;
+	int same = FALSE, lines = 0;
+
+	fp1 = fopen(file1, "r");
+	fp2 = fopen(file2, "r");
+	if(fp1 && fp2) {
+		while(1) {
+			char *l1 = fgets(line1, sizeof(line1), fp1);
+			char *l2 = fgets(line2, sizeof(line2), fp2);
+
+			if(l1 == NULL || l2 == NULL) {
+				same = (l1 == l2 && lines > 0);
+				break;
+				}
+			if(strncmp(line1, "# Created:", 10) && strcmp(line1, line2))
+				break;
+			lines++;
+			}
+		}
+	if(fp1)
+		fclose(fp1);
+	if(fp2)
+		fclose(fp2);
+
+	return same;
+	}
+
+
+int main(int argc, char **argv) {
+	struct xodbinary_header *hdr;
+	struct xodbinary_host *hst;
+	uint32_t *ids;
+	char *buf;
+	unsigned int hosts, services, i;
+
+	plan_tests(16);
+
+	init_main_cfg_vars(1);
+	init_shared_cfg_vars(1);
+	read_main_config_file("smallconfig/nagios.cfg");
+	read_object_config_data("smallconfig/nagios.cfg", READ_ALL_OBJECT_DATA);
+	pre_flight_check();
+	hosts = num_objects.hosts;
+	services = num_objects.services;
+
+	/* what's read back from a precache is what was written to it */
+	ok(fcache_objects("var/precache-test.cache") == OK && xodbinary_write_precache(TEST_PRECACHE) == OK, "Wrote the text and binary precaches");
+	ok(xodbinary_is_precache(TEST_PRECACHE) == TRUE && xodbinary_is_precache("var/precache-test.cache") == FALSE, "Binary precaches are told apart from text ones");
+	free_object_data();
+	my_free(object_precache_file);
+	object_precache_file = strdup(TEST_PRECACHE);
+	use_precached_objects = TRUE;
+	ok(read_object_config_data(object_precache_file, READ_ALL_OBJECT_DATA) == OK, "Read the binary precache");
+	ok(num_objects.hosts == hosts && num_objects.services == services && find_service("host1", "Dummy service") != NULL, "It has the same objects");
+	ok(fcache_objects("var/precache-roundtrip.cache") == OK && same_objects("var/precache-test.cache", "var/precache-roundtrip.cache"), "...with the same settings and relations");
+
+	/* truncated precaches */
+	ok(load_precache() == OK, "Loaded the precache");
+	hdr = (struct xodbinary_header *)precache;
+	ok(read_truncated_precache(0) == ERROR, "An empty precache is refused");
+	ok(read_truncated_precache(sizeof(*hdr) - 1) == ERROR, "A precache without a whole header is refused");
+	ok(read_truncated_precache(precache_size / 2) == ERROR && strstr(last_log, "truncated") != NULL, "A precache cut in half is refused");
+	ok(read_truncated_precache(precache_size - 1) == ERROR && strstr(last_log, "truncated") != NULL, "A precache missing its last byte is refused");
+
+	/* corrupted ones */
+	buf = malloc(precache_size);
+	memcpy(buf, precache, precache_size);
+	((struct xodbinary_header *)buf)->version++;
+	ok(read_broken_precache(buf, precache_size) == ERROR && strstr(last_log, "different version") != NULL, "A precache from another version is refused");
+
+	memcpy(buf, precache, precache_size);
+	((struct xodbinary_header *)buf)->section[XODBINARY_HOSTS].count += 1000;
+	ok(read_broken_precache(buf, precache_size) == ERROR && strstr(last_log, "corrupt section table") != NULL, "A section that runs past the end is refused");
+
+	memcpy(buf, precache, precache_size);
+	buf[hdr->section[XODBINARY_STRINGS].offset + hdr->section[XODBINARY_STRINGS].count - 1] = 'x';
+	ok(read_broken_precache(buf, precache_size) == ERROR && strstr(last_log, "corrupt string table") != NULL, "An unterminated string table is refused");
+
+	memcpy(buf, precache, precache_size);
+	hst = (struct xodbinary_host *)(buf + hdr->section[XODBINARY_HOSTS].offset);
+	hst->alias = hdr->section[XODBINARY_STRINGS].count + 1;
+	ok(read_broken_precache(buf, precache_size) == ERROR && strstr(last_log, "is corrupt") != NULL, "A string past the string table is refused");
+
+	memcpy(buf, precache, precache_size);
+	ids = (uint32_t *)(buf + hdr->section[XODBINARY_IDS].offset);
+	for(i = 0; i < hdr->section[XODBINARY_IDS].count; i++)
+		ids[i] = XODBINARY_NONE - 1;
+	ok(hdr->section[XODBINARY_IDS].count > 0 && read_broken_precache(buf, precache_size) == ERROR && strstr(last_log, "is corrupt") != NULL, "An object id past its table is refused");
+
+	/* and the good one still reads fine after all that */
+	ok(read_broken_precache(precache, precache_size) == OK && num_objects.hosts == hosts, "The original precache still reads");
+
+	free_object_data();
+	free(buf);
+	free(precache);
+	unlink(TEST_PRECACHE);
+	unlink(TEST_BROKEN_PRECACHE);
+	unlink("var/precache-test.cache");
+	unlink("var/precache-roundtrip.cache");
+
+	return exit_status();
+	}
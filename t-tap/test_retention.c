@@ -0,0 +1,291 @@
+/*****************************************************************************
+ *
+ * test_retention.c - Test the retention journal
+ *
+ * Program: Nagios Core Testing
+ * License: GPL
+ *
+ * Description:
+ *
+ * Tests that changes to retained state are journaled, and that the
+ * journal is replayed on top of the retention file: batches the file
+ * already covers are skipped, a torn last block is ignored and only
+ * the last word on a comment or downtime counts. Also tests saving
+ * retention data in the background: a save completing, a save skipped
+ * while one is running, waiting for a save at shutdown and a failing
+ * child being reported.
+ *
+ * License:
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ *****************************************************************************/
+
+#include "../include/config.h"
+#include "../include/common.h"
+#include "../include/objects.h"
+#include "../include/comments.h"
+#include "../include/downtime.h"
+#include "../include/statusdata.h"
+#include "../include/macros.h"
+#include "../include/nagios.h"
+#include "../include/sretention.h"
+#include "../include/perfdata.h"
+#include "../include/broker.h"
+#include "../include/nebmods.h"
+#include "../include/nebmodules.h"
+#include "../xdata/xrddefault.h"
+
+#include "tap.h"
+#include "stub_perfdata.c"
+#include "stub_workers.c"
+#include "stub_events.c"
+#include "stub_logging.c"
+#include "stub_commands.c"
+#include "stub_checks.c"
+#include "stub_nebmods.c"
+#include "stub_netutils.c"
+#include "stub_broker.c"
+#include "stub_statusdata.c"
+#include "stub_flapping.c"
+#include "stub_notifications.c"
+#include "../base/sretention.c"
+
+#define TEST_RETENTION_FILE "var/retention-test.dat"
+#define TEST_JOURNAL_FILE TEST_RETENTION_FILE ".journal"
+
+void broker_retention_data(int type, int flags, int attr, struct timeval *timestamp) {}
+
+
+/* changes a custom variable the way CHANGE_CUSTOM_HOST_VAR does */
+static void change_custom_var(host *hst, customvariablesmember *cvar, const char *value) {
+
+	my_free(cvar->variable_value);
+	cvar->variable_value = strdup(value);
+	cvar->has_been_modified = TRUE;
+	hst->modified_attributes |= MODATTR_CUSTOM_VARIABLE;
+	xrddefault_journal_host(hst);
+	}
+
+
+static unsigned long journal_records(void) {
+	struct xrddefault_journal_stats js;
+
+	xrddefault_get_journal_stats(&js);
+
+	return js.records;
+	}
+
+
+/* runs the event loop until the background save is done, or 10 seconds have passed */
+static void wait_for_background_save(void) {
+	int i;
+
+	for(i = 0; retention_save.pid && i < 100; i++)
+		iobroker_poll(nagios_iobs, 100);
+	}
+
+
+static void test_background_save(void) {
+	struct stat st;
+	unsigned long saves, failures;
+	pid_t pid;
+	int pfd[2];
+
+	retain_state_information = TRUE;
+	retention_save_mode = RETENTION_SAVE_BACKGROUND;
+	sigshutdown = sigrestart = FALSE;
+	nagios_iobs = iobroker_create();
+	unlink(TEST_RETENTION_FILE);
+	saves = retention_save.saves;
+	failures = retention_save.failures;
+
+	ok(save_state_information(FALSE) == OK && retention_save.pid > 0, "A background save forks a child to do it");
+	pid = retention_save.pid;
+	ok(save_state_information(FALSE) == OK && retention_save.skipped == 1 && retention_save.pid == pid,
+	   "A save requested while one is running is skipped");
+	wait_for_background_save();
+	ok(retention_save.pid == 0 && retention_save.saves == saves + 1 && retention_save.failures == failures,
+	   "The event loop picks up the save completing");
+	ok(stat(TEST_RETENTION_FILE, &st) == 0 && retention_save.last_size == (unsigned long long)st.st_size,
+	   "...and the file it wrote is in place");
+	ok(iobroker_get_num_fds(nagios_iobs) == 0, "...and its pipe is closed");
+
+	/* the final save must not be overtaken by the one running */
+	save_state_information(FALSE);
+	sigshutdown = TRUE;
+	ok(save_state_information(FALSE) == OK && retention_save.pid == 0 && retention_save.saves == saves + 3,
+	   "A save at shutdown waits for the running one, then saves in the foreground");
+	sigshutdown = FALSE;
+
+	/* the child can't create its temp file */
+	my_free(temp_file);
+	temp_file = strdup("var/no-such-dir/retention-test.tmp");
+	ok(save_state_information(FALSE) == OK, "A save that will fail is started all the same");
+	wait_for_background_save();
+	ok(retention_save.pid == 0 && retention_save.failures == failures + 1 && retention_save.saves == saves + 3,
+	   "A save failing in the child is reported");
+	my_free(temp_file);
+	temp_file = strdup("var/retention-test.tmp");
+
+	/* a child that dies before writing its result */
+	if(pipe(pfd) < 0 || (pid = fork()) < 0) {
+		ok(0, "Failed to start a child to kill: %s", strerror(errno));
+		}
+	else {
+		if(pid == 0)
+			_exit(1);
+		close(pfd[1]);
+		retention_save.pid = pid;
+		retention_save.fd = pfd[0];
+		iobroker_register(nagios_iobs, pfd[0], NULL, background_save_done);
+		wait_for_state_information_save();
+		ok(retention_save.pid == 0 && retention_save.failures == failures + 2, "A child dying before it reports back counts as a failure");
+		}
+
+	iobroker_destroy(nagios_iobs, 0);
+	nagios_iobs = NULL;
+	}
+
+
+static int comment_copies(unsigned long comment_id) {
+	nagios_comment *temp_comment;
+	int copies = 0;
+
+	for(temp_comment = comment_list; temp_comment != NULL; temp_comment = temp_comment->next) {
+		if(temp_comment->comment_id == comment_id)
+			copies++;
+		}
+
+	return copies;
+	}
+
+
+static void write_host_comment(FILE *fp, unsigned long comment_id, const char *comment_data) {
+
+	fprintf(fp, "hostcomment {\nhost_name=host1\nentry_type=%d\ncomment_id=%lu\n", USER_COMMENT, comment_id);
+	fprintf(fp, "source=%d\npersistent=1\nentry_time=%lu\nexpires=0\nexpire_time=0\n", COMMENTSOURCE_EXTERNAL, (unsigned long)time(NULL));
+	fprintf(fp, "author=tester\ncomment_data=%s\n}\n", comment_data);
+	}
+
+
+int main(int argc, char **argv) {
+	struct xrddefault_journal_stats js;
+	customvariablesmember *cvar;
+	nagios_comment *temp_comment;
+	unsigned long records, base_seq, comment_id = 0;
+	time_t now = time(NULL);
+	off_t offset;
+	host *hst;
+	FILE *fp;
+
+	plan_tests(26);
+
+	reset_variables();
+	config_file = strdup("smallconfig/nagios.cfg");
+	read_main_config_file(config_file);
+	read_all_object_data(config_file);
+	pre_flight_check();
+	initialize_downtime_data();
+
+	my_free(retention_file);
+	retention_file = strdup(TEST_RETENTION_FILE);
+	my_free(temp_file);
+	temp_file = strdup("var/retention-test.tmp");
+	retention_journal = TRUE;
+	unlink(TEST_RETENTION_FILE);
+	unlink(TEST_JOURNAL_FILE);
+
+	hst = find_host("host1");
+	cvar = add_custom_variable_to_host(hst, "TESTVAR", "one");
+	ok(hst != NULL && cvar != NULL && xrddefault_open_journal() == OK, "Opened the journal");
+
+	/* freed values tend to come straight back from the strdup() that replaces them */
+	records = journal_records();
+	change_custom_var(hst, cvar, "two");
+	ok(journal_records() > records, "Changing a custom variable is journaled");
+	records = journal_records();
+	change_custom_var(hst, cvar, "six");
+	ok(journal_records() > records, "Changing it again is journaled too");
+	records = journal_records();
+	change_custom_var(hst, cvar, "six");
+	ok(journal_records() == records, "Setting the value it already has isn't");
+
+	/* the retention file covers everything journaled so far */
+	hst->current_state = HOST_DOWN;
+	xrddefault_journal_host(hst);
+	add_comment(HOST_COMMENT, USER_COMMENT, "host1", NULL, now, "tester", "saved", 9001, TRUE, FALSE, 0, COMMENTSOURCE_EXTERNAL);
+	add_comment(HOST_COMMENT, USER_COMMENT, "host1", NULL, now, "tester", "saved", 9002, TRUE, FALSE, 0, COMMENTSOURCE_EXTERNAL);
+	add_host_downtime("host1", now, "tester", "saved", now + 3600, 0, now + 7200, TRUE, 0, 3600, 9101, FALSE, FALSE);
+	add_host_downtime("host1", now, "tester", "saved", now + 3600, 0, now + 7200, TRUE, 0, 3600, 9102, FALSE, FALSE);
+	offset = xrddefault_checkpoint_journal();
+	ok(xrddefault_save_state_information() == OK && xrddefault_compact_journal(offset) == OK, "Saved the retention data");
+	xrddefault_get_journal_stats(&js);
+	ok(js.size == 0, "A save empties the journal");
+	base_seq = js.seq;
+
+	/* what changes after the save is only in the journal */
+	hst->current_state = HOST_UNREACHABLE;
+	change_custom_var(hst, cvar, "ten");
+	add_new_host_comment(USER_COMMENT, "host1", now, "tester", "journaled", TRUE, COMMENTSOURCE_EXTERNAL, FALSE, 0, &comment_id);
+	xrddefault_close_journal();
+
+	hst->current_state = HOST_UP;
+	change_custom_var(hst, cvar, "one");
+	free_comment_data();
+	free_downtime_data();
+	initialize_downtime_data();
+	ok(xrddefault_read_state_information() == OK, "Read the retention data and journal");
+	ok(hst->current_state == HOST_UNREACHABLE, "Journaled host state is replayed");
+	ok(!strcmp(cvar->variable_value, "ten"), "Journaled custom variables are replayed");
+	ok(find_host_comment(comment_id) != NULL && find_host_comment(9001) != NULL, "Journaled comments are added to the saved ones");
+
+	/*
+	 * A journal with a batch the retention file covers, a comment that
+	 * was changed twice, a deleted downtime and a block torn by a crash
+	 */
+	fp = fopen(TEST_JOURNAL_FILE, "w");
+	fprintf(fp, "journal {\nseq=%lu\n}\n", base_seq);
+	fprintf(fp, "host {\nhost_name=host1\ncurrent_state=%d\n}\n", HOST_UNREACHABLE);
+	fprintf(fp, "deletedcomment {\ncomment_id=9001\n}\n");
+	fprintf(fp, "journal {\nseq=%lu\n}\n", base_seq + 1);
+	write_host_comment(fp, 9002, "first");
+	write_host_comment(fp, 9002, "second");
+	fprintf(fp, "deleteddowntime {\ndowntime_id=9101\n}\n");
+	fprintf(fp, "host {\nhost_name=host1\n_TESTVAR=1;last\n}\n");
+	fprintf(fp, "host {\nhost_name=host1\ncurrent_state=%d\n", HOST_UP);
+	fclose(fp);
+
+	hst->current_state = HOST_UP;
+	change_custom_var(hst, cvar, "one");
+	free_comment_data();
+	free_downtime_data();
+	initialize_downtime_data();
+	ok(xrddefault_read_state_information() == OK, "Read the retention data and a hand written journal");
+	ok(hst->current_state == HOST_DOWN, "Batches the retention file covers are skipped, and a torn block is ignored");
+	ok(!strcmp(cvar->variable_value, "last"), "Batches after the retention file are replayed");
+	ok(find_host_comment(9001) != NULL, "A deletion in a covered batch doesn't remove the saved comment");
+	temp_comment = find_host_comment(9002);
+	ok(temp_comment != NULL && !strcmp(temp_comment->comment_data, "second") && comment_copies(9002) == 1, "Only the last copy of a journaled comment counts");
+	ok(find_host_downtime(9101) == NULL, "A journaled deletion removes the saved downtime");
+	ok(find_host_downtime(9102) != NULL, "Other saved downtime is kept");
+
+	test_background_save();
+
+	unlink(TEST_RETENTION_FILE);
+	unlink(TEST_JOURNAL_FILE);
+	my_free(config_file);
+
+	return exit_status();
+	}
@@ -0,0 +1,220 @@
+/*****************************************************************************
+ *
+ * test_statusdata.c - Test incremental status.dat dumps
+ *
+ * Program: Nagios Core Testing
+ * License: GPL
+ *
+ * Description:
+ *
+ * Tests that changes to hosts and services show up in the very next
+ * status dump, and that clean objects aren't re-rendered.
+ *
+ * License:
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ *****************************************************************************/
+
+#define NSCORE 1
+#include "../include/config.h"
+#include "../include/common.h"
+#include "../include/objects.h"
+#include "../include/comments.h"
+#include "../include/downtime.h"
+#include "../include/statusdata.h"
+#include "../include/macros.h"
+#include "../include/nagios.h"
+#include "../include/sretention.h"
+#include "../include/perfdata.h"
+#include "../include/broker.h"
+#include "../include/nebmods.h"
+#include "../include/nebmodules.h"
+#include "tap.h"
+#include "stub_downtime.c"
+#include "stub_perfdata.c"
+#include "stub_workers.c"
+#include "stub_netutils.c"
+#include "stub_comments.c"
+#include "stub_notifications.c"
+#include "stub_broker.c"
+#include "stub_nebmods.c"
+
+nagios_comment *comment_list = NULL;
+scheduled_downtime *scheduled_downtime_list = NULL;
+
+/* Dummy functions */
+void logit(int data_type, int display, const char *fmt, ...) {}
+int write_to_log(char *buffer, unsigned long data_type, time_t *timestamp) { return 0; }
+int log_debug_info(int level, int verbosity, const char *fmt, ...) { return 0; }
+void journal_host_state(host *hst) {}
+void journal_service_state(service *svc) {}
+void journal_contact_state(contact *cntct) {}
+void journal_program_state(void) {}
+void broker_aggregated_status_data(int type, int flags, int attr, struct timeval *timestamp) {}
+void broker_program_status(int type, int flags, int attr, struct timeval *timestamp) {}
+void broker_host_status(int type, int flags, int attr, host *hst, struct timeval *timestamp) {}
+void broker_service_status(int type, int flags, int attr, service *svc, struct timeval *timestamp) {}
+void broker_contact_status(int type, int flags, int attr, contact *cntct, struct timeval *timestamp) {}
+void update_host_freshness(host *hst) {}
+void update_service_freshness(service *svc) {}
+int close_command_file(void) { return 0; }
+int close_log_file(void) { return 0; }
+int fix_log_file_owner(uid_t uid, gid_t gid) { return 0; }
+int handle_async_service_check_result(service *temp_service, check_result *queued_check_result) { return 0; }
+int handle_async_host_check_result(host *temp_host, check_result *queued_check_result) { return 0; }
+void free_freshness_index(void) {}
+void free_check_templates(void) {}
+timed_event *schedule_new_event(int event_type, int high_priority, time_t run_time, int recurring, unsigned long event_interval, void *timing_func, int compensate_for_time_change, void *event_data, void *event_args, int event_options) { return NULL; }
+
+
+/* reads the status file and returns the value of a field in a block */
+static char *status_field(const char *block, const char *field) {
+	static char value[1024];
+	char line[8192], *buf = NULL, *p, *end;
+	size_t len = 0;
+	FILE *fp;
+
+	*value = 0;
+	if(!(fp = fopen(status_file, "r")))
+		return value;
+	while(fgets(line, sizeof(line), fp)) {
+		buf = realloc(buf, len + strlen(line) + 1);
+		strcpy(buf + len, line);
+		len += strlen(line);
+		}
+	fclose(fp);
+	if(!buf)
+		return value;
+
+	/* blocks are identified by their first few lines */
+	if((p = strstr(buf, block)) && (end = strstr(p, "\n\t}\n"))) {
+		char *f;
+		*end = 0;
+		asprintf(&f, "\n\t%s=", field);
+		if((p = strstr(p, f)) != NULL) {
+			p += strlen(f);
+			if((end = strchr(p, '\n')))
+				*end = 0;
+			snprintf(value, sizeof(value), "%s", p);
+			}
+		free(f);
+		}
+	free(buf);
+
+	return value;
+	}
+
+
+/* returns how many objects the last dump re-rendered */
+static int dirty_objects(void) {
+	char buf[256], *p;
+	int pfd[2], n;
+
+	if(pipe(pfd) < 0)
+		return -1;
+	dump_status_data_stats(pfd[1]);
+	close(pfd[1]);
+	n = read(pfd[0], buf, sizeof(buf) - 1);
+	close(pfd[0]);
+	if(n <= 0)
+		return -1;
+	buf[n] = 0;
+	if(!(p = strstr(buf, ";dirty=")))
+		return -1;
+
+	return atoi(p + 7);
+	}
+
+
+int main(int argc, char **argv) {
+	const char *svc_block = "servicestatus {\n\thost_name=host1\n\tservice_description=Dummy service\n";
+	const char *host_block = "hoststatus {\n\thost_name=host1\n";
+	service *svc;
+	host *hst;
+	int i;
+
+	plan_tests(15);
+
+	init_main_cfg_vars(1);
+	init_shared_cfg_vars(1);
+	read_main_config_file("smallconfig/nagios.cfg");
+	read_object_config_data("smallconfig/nagios.cfg", READ_ALL_OBJECT_DATA);
+	pre_flight_check();
+
+	my_free(status_file);
+	status_file = strdup("var/status-test.dat");
+	my_free(temp_file);
+	temp_file = strdup("var/status-test.tmp");
+	initialize_status_data(NULL);
+
+	svc = find_service("host1", "Dummy service");
+	hst = find_host("host1");
+	ok(svc != NULL && hst != NULL, "Found the test host and service");
+
+	/* the first dump renders everything */
+	update_all_status_data();
+	ok(dirty_objects() == (int)(num_objects.hosts + num_objects.services), "First dump renders every object");
+	update_all_status_data();
+	ok(dirty_objects() == 0, "Second dump renders nothing");
+
+	/* a change that goes through update_service_status() */
+	my_free(svc->plugin_output);
+	svc->plugin_output = strdup("changed output");
+	svc->current_state = STATE_CRITICAL;
+	update_service_status(svc, FALSE);
+	ok(service_state_ary.flags[svc->id] & OBJSTATE_STATUS_DIRTY, "Updating the service's status flags it in the state array");
+	update_all_status_data();
+	ok(dirty_objects() == 1, "Only the changed service is rendered");
+	ok(!(service_state_ary.flags[svc->id] & OBJSTATE_STATUS_DIRTY), "...which clears its flag");
+	ok(!strcmp(status_field(svc_block, "plugin_output"), "changed output"), "Changed plugin_output shows up in the next dump");
+	ok(!strcmp(status_field(svc_block, "current_state"), "2"), "Changed current_state shows up in the next dump");
+
+	/*
+	 * flap state set outside a check. Turning flap detection back on
+	 * finds the service isn't flapping (its history is all OK) and
+	 * clears it, which must reach the next dump too.
+	 */
+	svc->is_flapping = TRUE;
+	hst->is_flapping = TRUE;
+	update_service_status(svc, FALSE);
+	update_host_status(hst, FALSE);
+	update_all_status_data();
+	ok(!strcmp(status_field(svc_block, "is_flapping"), "1"), "Service is flapping in the status file");
+	ok(!strcmp(status_field(host_block, "is_flapping"), "1"), "Host is flapping in the status file");
+	enable_flap_detection = FALSE;
+	enable_flap_detection_routines();
+	update_all_status_data();
+	ok(!strcmp(status_field(svc_block, "is_flapping"), "0"), "Enabling flap detection clears the service's flap state in the next dump");
+	ok(!strcmp(status_field(host_block, "is_flapping"), "0"), "Enabling flap detection clears the host's flap state in the next dump");
+
+	/* with nothing changed, no dump re-renders anything, no matter how many we do */
+	for(i = 0; i < 100; i++) {
+		update_all_status_data();
+		if(dirty_objects() != 0)
+			break;
+		}
+	ok(i == 100, "No dump re-renders clean objects");
+	ok(!strcmp(status_field(svc_block, "plugin_output"), "changed output"), "Clean objects are still written");
+
+	/* objects read again have nothing to do with what was rendered before */
+	free_object_data();
+	read_object_config_data("smallconfig/nagios.cfg", READ_ALL_OBJECT_DATA);
+	update_all_status_data();
+	ok(dirty_objects() == (int)(num_objects.hosts + num_objects.services), "Every object is rendered again after the objects are read again");
+
+	cleanup_status_data(TRUE);
+
+	return exit_status();
+	}
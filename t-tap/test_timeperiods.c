@@ -70,9 +70,64 @@ int close_log_file(void) { return 0; }
 int fix_log_file_owner(uid_t uid, gid_t gid) { return 0; }
 int handle_async_service_check_result(service *temp_service, check_result *queued_check_result) { return 0; }
 int handle_async_host_check_result(host *temp_host, check_result *queued_check_result) { return 0; }
+void free_freshness_index(void) {}
+void free_check_templates(void) {}
 
 void _get_next_valid_time(time_t pref_time, time_t *valid_time, timeperiod *tperiod);
 
+/*
+ * Compares the compiled timeperiods with the uncompiled ones over the
+ * next 12 days, looking closer wherever the result changes.
+ */
+static void test_compiled_timeperiods(const char *tz) {
+	time_t now, t, prev, next, lo, hi;
+	unsigned int i;
+	int valid, prev_valid, bad_valid = 0, bad_next = 0;
+
+	setenv("TZ", tz, 1);
+	tzset();
+	invalidate_timeperiod_cache();
+
+	/* leave get_next_valid_time() some room to not move our times forward */
+	now = time(NULL) + 60;
+
+	for(i = 0; i < num_objects.timeperiods; i++) {
+		timeperiod *tp = timeperiod_ary[i];
+
+		prev = now;
+		prev_valid = _check_time_against_period(now, tp);
+		for(t = now; t < now + 12 * 86400; prev = t, prev_valid = valid, t += 1799) {
+			valid = _check_time_against_period(t, tp);
+			if(check_time_against_period(t, tp) != valid)
+				bad_valid++;
+
+			/* find the exact second it changed */
+			if(valid != prev_valid) {
+				for(lo = prev, hi = t; hi - lo > 1;) {
+					time_t mid = lo + (hi - lo) / 2;
+					if(_check_time_against_period(mid, tp) == valid)
+						hi = mid;
+					else
+						lo = mid;
+					}
+				if(check_time_against_period(hi, tp) != valid || check_time_against_period(lo, tp) == valid)
+					bad_valid++;
+				}
+
+			get_next_valid_time(t, &next, tp);
+			if(next != t && next < now + 12 * 86400) {
+				if(_check_time_against_period(next, tp) != OK || _check_time_against_period(next - 1, tp) == OK)
+					bad_next++;
+				}
+			else if(next == t && valid == OK && _check_time_against_period(t, tp) != OK)
+				bad_next++;
+			}
+		}
+
+	ok(bad_valid == 0, "Compiled timeperiods agree with check_time_against_period() for TZ=%s (%d mismatches)", tz, bad_valid);
+	ok(bad_next == 0, "Compiled timeperiods give the first valid time for TZ=%s (%d mismatches)", tz, bad_next);
+	}
+
 int main(int argc, char **argv) {
 	int result;
 	int c = 0;
@@ -85,7 +140,7 @@ int main(int argc, char **argv) {
 	int is_valid_time = 0;
 	int iterations = 1000;
 
-	plan_tests(6046);
+	plan_tests(6054);
 
 	/* reset program variables */
 	reset_variables();
@@ -317,7 +372,10 @@ int main(int argc, char **argv) {
 
 
 
-
+	test_compiled_timeperiods("UTC");
+	test_compiled_timeperiods("Europe/London");
+	test_compiled_timeperiods("America/New_York");
+	test_compiled_timeperiods("Australia/Lord_Howe");
 
 	cleanup();
 
@@ -0,0 +1,176 @@
+/*****************************************************************************
+ *
+ * test_workers.c - Test check deadlines and lost worker jobs
+ *
+ * Program: Nagios Core Testing
+ * License: GPL
+ *
+ * Description:
+ *
+ * Tests that running checks come out of the deadline queue in the order
+ * their results are due, and that the checks of a worker that dies are
+ * either handed to another worker or rescheduled.
+ *
+ * License:
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ *****************************************************************************/
+
+#define NSCORE 1
+#include "../base/workers.c"
+#include "../include/comments.h"
+#include "../include/downtime.h"
+#include "tap.h"
+#include "stub_downtime.c"
+#include "stub_perfdata.c"
+#include "stub_netutils.c"
+#include "stub_comments.c"
+#include "stub_broker.c"
+#include "stub_nebmods.c"
+
+int lost_host_checks = 0;
+int lost_service_checks = 0;
+
+/* Dummy functions */
+void logit(int data_type, int display, const char *fmt, ...) {}
+int log_debug_info(int level, int verbosity, const char *fmt, ...) { return 0; }
+int close_command_file(void) { return 0; }
+int close_log_file(void) { return 0; }
+int fix_log_file_owner(uid_t uid, gid_t gid) { return 0; }
+int handle_async_service_check_result(service *temp_service, check_result *queued_check_result) { return 0; }
+int handle_async_host_check_result(host *temp_host, check_result *queued_check_result) { return 0; }
+int parse_check_output_arena(arena *a, char *buf, char **short_output, char **long_output, char **perf_data, int escape_newlines_please, int newlines_are_escaped) { return OK; }
+int qh_register_handler(const char *name, const char *description, unsigned int options, qh_handler handler) { return 0; }
+void free_freshness_index(void) {}
+void free_check_templates(void) {}
+timed_event *schedule_new_event(int event_type, int high_priority, time_t run_time, int recurring, unsigned long event_interval, void *timing_func, int compensate_for_time_change, void *event_data, void *event_args, int event_options) { return NULL; }
+void reschedule_lost_host_check(host *hst) { lost_host_checks++; hst->is_executing = FALSE; }
+void reschedule_lost_service_check(service *svc) { lost_service_checks++; svc->is_executing = FALSE; }
+
+
+/* registers a worker that talks to us over a socket pair, and returns our end of it */
+static struct wproc_worker *add_test_worker(const char *name, int *peer)
+{
+	char buf[128];
+	int sv[2];
+
+	if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) < 0)
+		return NULL;
+	*peer = sv[1];
+	snprintf(buf, sizeof(buf), "name=%s;max_jobs=16", name);
+	if (register_worker(sv[0], buf, strlen(buf)) != QH_TAKEOVER)
+		return NULL;
+
+	return workers.wps[workers.len - 1];
+}
+
+/* closes the worker's end of the socket pair */
+static void close_test_worker(int peer)
+{
+	char buf[4096];
+
+	/* a worker that dies with unread jobs makes the socket look reset, not closed */
+	while (recv(peer, buf, sizeof(buf), MSG_DONTWAIT) > 0)
+		;
+	close(peer);
+}
+
+static check_result *test_check(const char *host_name, const char *service_description)
+{
+	check_result *cr = alloc_check_result();
+
+	cr->host_name = strdup(host_name);
+	if (service_description) {
+		cr->object_check_type = SERVICE_CHECK;
+		cr->service_description = strdup(service_description);
+	}
+
+	return cr;
+}
+
+
+int main(int argc, char **argv)
+{
+	struct wproc_worker *w1, *w2, *w3;
+	check_result *cr1, *cr2, *cr3;
+	time_t later;
+	service *svc;
+	host *hst;
+	int p1, p2, p3;
+
+	plan_tests(14);
+
+	signal(SIGPIPE, SIG_IGN);
+	nagios_pid = getpid();
+	nagios_iobs = iobroker_create();
+	specialized_workers = dkhash_create(512);
+
+	init_main_cfg_vars(1);
+	init_shared_cfg_vars(1);
+	read_main_config_file("smallconfig/nagios.cfg");
+	read_object_config_data("smallconfig/nagios.cfg", READ_ALL_OBJECT_DATA);
+	svc = find_service("host1", "Dummy service");
+	hst = find_host("host1");
+
+	w1 = add_test_worker("w1", &p1);
+	w2 = add_test_worker("w2", &p2);
+	ok(svc != NULL && hst != NULL && w1 != NULL && w2 != NULL, "Set up the test objects and workers");
+
+	/* checks come out of the deadline queue in the order their results are due */
+	service_check_timeout = 60;
+	cr1 = test_check("host1", "Dummy service");
+	wproc_run_check(cr1, "/bin/true", NULL);
+	service_check_timeout = 30;
+	cr2 = test_check("host1", "Dummy service");
+	wproc_run_check(cr2, "/bin/true", NULL);
+	host_check_timeout = 60;
+	cr3 = test_check("host1", NULL);
+	wproc_run_check(cr3, "/bin/true", NULL);
+	ok(checks_in_flight(0) == 1 && checks_in_flight(1) == 2, "Host and service checks are queued separately");
+
+	later = time(NULL) + 3600;
+	ok(wproc_next_orphaned_check(SERVICE_CHECK, time(NULL)) == NULL, "Nothing is orphaned before its deadline");
+	ok(wproc_next_orphaned_check(SERVICE_CHECK, later) == cr2, "The check with the earliest deadline is orphaned first");
+	ok(wproc_next_orphaned_check(SERVICE_CHECK, later) == cr1, "Then the next one");
+	ok(wproc_next_orphaned_check(SERVICE_CHECK, later) == NULL && check_deadlines.overdue == 2, "Orphaned checks leave the queue and count as overdue");
+
+	/* a late result still finds its job, which is no longer overdue once it's gone */
+	destroy_job(get_job(w2, 0));
+	ok(check_deadlines.overdue == 1, "A late result clears the overdue count");
+
+	/* the checks of a worker that dies are handed to the next one */
+	hst->is_executing = TRUE;
+	close_test_worker(p1);
+	handle_worker_result(w1->sd, 0, w1);
+	ok(workers.len == 1 && lost_host_checks == 0, "A check of a dead worker is handed to another worker");
+	ok(checks_in_flight(0) == 1 && check_deadlines.overdue == 1, "A handed over check keeps its deadline");
+	ok(fanout_get(w2->jobs, 1) != NULL && fanout_get(w2->jobs, 2) != NULL, "Handed over checks can be found by their results");
+
+	/* if nobody can take them, the checks are rescheduled */
+	svc->is_executing = TRUE;
+	w3 = add_test_worker("w3", &p3);
+	close_test_worker(p3);
+	close_test_worker(p2);
+	handle_worker_result(w2->sd, 0, w2);
+	ok(lost_host_checks == 1 && hst->is_executing == FALSE, "A host check no worker will take is rescheduled");
+	ok(lost_service_checks == 1 && svc->is_executing == FALSE, "A service check no worker will take is rescheduled");
+	ok(checks_in_flight(0) == 0 && checks_in_flight(1) == 0 && check_deadlines.overdue == 0, "Lost checks leave the deadline queue");
+
+	hst->is_executing = TRUE;
+	handle_worker_result(w3->sd, 0, w3);
+	ok(workers.len == 0 && lost_host_checks == 1, "Nothing is rescheduled once there are no checks left");
+
+	return exit_status();
+}
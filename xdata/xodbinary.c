@@ -0,0 +1,1407 @@
+/*****************************************************************************
+ *
+ * XODBINARY.C - Binary object precache routines for Nagios
+ *
+ * The binary precache is written with -p when binary_object_precache is
+ * enabled and read with -u in place of the text precache. Writing it
+ * walks the registered objects after the pre-flight check, so reading
+ * it back rebuilds the same objects in the same order, with the same
+ * ids and the same list orders, without going through the template
+ * code at all. The file is mapped rather than read, and relationships
+ * are linked up by id instead of being looked up by name.
+ *
+ *
+ * License:
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ *****************************************************************************/
+
+
+/*********** COMMON HEADER FILES ***********/
+
+#include "../include/config.h"
+#include "../include/common.h"
+#include "../include/objects.h"
+#include "../include/nagios.h"
+#include "xodbinary.h"
+
+#include <sys/mman.h>
+
+
+/* record sizes, by section */
+static const uint32_t xodbinary_rec_size[XODBINARY_NUM_SECTIONS] = {
+	1,
+	sizeof(uint32_t),
+	sizeof(struct xodbinary_timerange),
+	sizeof(struct xodbinary_daterange),
+	sizeof(struct xodbinary_customvar),
+	sizeof(struct xodbinary_timeperiod),
+	sizeof(struct xodbinary_command),
+	sizeof(struct xodbinary_group),
+	sizeof(struct xodbinary_group),
+	sizeof(struct xodbinary_group),
+	sizeof(struct xodbinary_contact),
+	sizeof(struct xodbinary_host),
+	sizeof(struct xodbinary_service),
+	sizeof(struct xodbinary_dependency),
+	sizeof(struct xodbinary_dependency),
+	sizeof(struct xodbinary_escalation),
+	sizeof(struct xodbinary_escalation),
+	};
+
+/* sections are 8-byte aligned so the doubles in records are too */
+#define xodbinary_align(x) (((x) + 7) & ~(uint64_t)7)
+
+
+/******************************************************************/
+/************************* WRITE FUNCTIONS ************************/
+/******************************************************************/
+
+typedef struct xodbinary_buf {
+	char *buf;
+	size_t len;
+	size_t size;
+	} xodbinary_buf;
+
+typedef struct xodbinary_writer {
+	xodbinary_buf sect[XODBINARY_NUM_SECTIONS];
+	dkhash_table *strings;                          /* string -> table offset */
+	int error;
+	} xodbinary_writer;
+
+
+/* appends a record to a section and returns its index */
+static uint32_t xodbinary_append(xodbinary_writer *w, int section, const void *rec) {
+	xodbinary_buf *b = &w->sect[section];
+	size_t size = xodbinary_rec_size[section];
+	uint32_t index = (uint32_t)(b->len / size);
+
+	if(b->len + size > b->size) {
+		size_t new_size = b->size ? b->size * 2 : 4096;
+		char *buf;
+
+		while(new_size < b->len + size)
+			new_size *= 2;
+		if((buf = (char *)realloc(b->buf, new_size)) == NULL) {
+			w->error = TRUE;
+			return 0;
+			}
+		b->buf = buf;
+		b->size = new_size;
+		}
+
+	memcpy(b->buf + b->len, rec, size);
+	b->len += size;
+
+	return index;
+	}
+
+
+/* adds a string to the string table, returning its offset (0 for NULL) */
+static uint32_t xodbinary_string(xodbinary_writer *w, const char *str) {
+	void *known;
+	uint32_t offset;
+	const char *p;
+
+	if(str == NULL)
+		return 0;
+
+	if((known = dkhash_get(w->strings, str, NULL)) != NULL)
+		return (uint32_t)(uintptr_t)known;
+
+	offset = (uint32_t)w->sect[XODBINARY_STRINGS].len;
+	for(p = str; ; p++) {
+		xodbinary_append(w, XODBINARY_STRINGS, p);
+		if(*p == '\0')
+			break;
+		}
+
+	if(dkhash_insert(w->strings, str, NULL, (void *)(uintptr_t)offset) != DKHASH_OK)
+		w->error = TRUE;
+
+	return offset;
+	}
+
+
+/* strings that default to the object name are stored as NULL */
+static uint32_t xodbinary_string_or_name(xodbinary_writer *w, const char *str, const char *name) {
+	return str == name ? 0 : xodbinary_string(w, str);
+	}
+
+
+static uint32_t xodbinary_period_id(timeperiod *tp, const char *name) {
+	if(tp == NULL && name != NULL)
+		tp = find_timeperiod(name);
+	return tp ? tp->id : XODBINARY_NONE;
+	}
+
+
+/* starts a list of records in a section */
+static void xodbinary_list_start(xodbinary_writer *w, struct xodbinary_list *l, int section) {
+	l->first = (uint32_t)(w->sect[section].len / xodbinary_rec_size[section]);
+	l->count = 0;
+	}
+
+
+static void xodbinary_list_id(xodbinary_writer *w, struct xodbinary_list *l, uint32_t id) {
+	xodbinary_append(w, XODBINARY_IDS, &id);
+	l->count++;
+	}
+
+
+static void xodbinary_write_contacts(xodbinary_writer *w, struct xodbinary_list *l, contactsmember *list) {
+	xodbinary_list_start(w, l, XODBINARY_IDS);
+	for(; list; list = list->next)
+		xodbinary_list_id(w, l, list->contact_ptr->id);
+	}
+
+
+static void xodbinary_write_contactgroups(xodbinary_writer *w, struct xodbinary_list *l, contactgroupsmember *list) {
+	xodbinary_list_start(w, l, XODBINARY_IDS);
+	for(; list; list = list->next)
+		xodbinary_list_id(w, l, list->group_ptr->id);
+	}
+
+
+/* objectlists of groups, which all start with their id */
+static void xodbinary_write_groups(xodbinary_writer *w, struct xodbinary_list *l, objectlist *list) {
+	xodbinary_list_start(w, l, XODBINARY_IDS);
+	for(; list; list = list->next)
+		xodbinary_list_id(w, l, *(unsigned int *)list->object_ptr);
+	}
+
+
+static void xodbinary_write_customvars(xodbinary_writer *w, struct xodbinary_list *l, customvariablesmember *list) {
+	struct xodbinary_customvar cv;
+
+	xodbinary_list_start(w, l, XODBINARY_CUSTOMVARS);
+	for(; list; list = list->next) {
+		cv.name = xodbinary_string(w, list->variable_name);
+		cv.value = xodbinary_string(w, list->variable_value);
+		xodbinary_append(w, XODBINARY_CUSTOMVARS, &cv);
+		l->count++;
+		}
+	}
+
+
+static void xodbinary_write_timeranges(xodbinary_writer *w, struct xodbinary_list *l, timerange *list) {
+	struct xodbinary_timerange tr;
+
+	xodbinary_list_start(w, l, XODBINARY_TIMERANGES);
+	for(; list; list = list->next) {
+		tr.start = (uint32_t)list->range_start;
+		tr.end = (uint32_t)list->range_end;
+		xodbinary_append(w, XODBINARY_TIMERANGES, &tr);
+		l->count++;
+		}
+	}
+
+
+static void xodbinary_write_timeperiod(xodbinary_writer *w, timeperiod *tp) {
+	struct xodbinary_timeperiod rec;
+	struct xodbinary_daterange dr;
+	timeperiodexclusion *exclusion;
+	daterange *range;
+	int x;
+
+	memset(&rec, 0, sizeof(rec));
+	rec.name = xodbinary_string(w, tp->name);
+	rec.alias = xodbinary_string_or_name(w, tp->alias, tp->name);
+
+	for(x = 0; x < 7; x++)
+		xodbinary_write_timeranges(w, &rec.days[x], tp->days[x]);
+
+	for(x = 0; x < DATERANGE_TYPES; x++) {
+		xodbinary_list_start(w, &rec.exceptions[x], XODBINARY_DATERANGES);
+		for(range = tp->exceptions[x]; range; range = range->next) {
+			memset(&dr, 0, sizeof(dr));
+			dr.type = range->type;
+			dr.syear = range->syear;
+			dr.smon = range->smon;
+			dr.smday = range->smday;
+			dr.swday = range->swday;
+			dr.swday_offset = range->swday_offset;
+			dr.eyear = range->eyear;
+			dr.emon = range->emon;
+			dr.emday = range->emday;
+			dr.ewday = range->ewday;
+			dr.ewday_offset = range->ewday_offset;
+			dr.skip_interval = range->skip_interval;
+			xodbinary_write_timeranges(w, &dr.times, range->times);
+			xodbinary_append(w, XODBINARY_DATERANGES, &dr);
+			rec.exceptions[x].count++;
+			}
+		}
+
+	xodbinary_list_start(w, &rec.exclusions, XODBINARY_IDS);
+	for(exclusion = tp->exclusions; exclusion; exclusion = exclusion->next) {
+		uint32_t id = xodbinary_period_id(exclusion->timeperiod_ptr, exclusion->timeperiod_name);
+		if(id == XODBINARY_NONE)
+			w->error = TRUE;
+		xodbinary_list_id(w, &rec.exclusions, id);
+		}
+
+	xodbinary_append(w, XODBINARY_TIMEPERIODS, &rec);
+	}
+
+
+static void xodbinary_write_command(xodbinary_writer *w, command *cmd) {
+	struct xodbinary_command rec;
+
+	rec.name = xodbinary_string(w, cmd->name);
+	rec.command_line = xodbinary_string(w, cmd->command_line);
+	xodbinary_append(w, XODBINARY_COMMANDS, &rec);
+	}
+
+
+static void xodbinary_write_contactgroup(xodbinary_writer *w, contactgroup *cg) {
+	struct xodbinary_group rec;
+
+	memset(&rec, 0, sizeof(rec));
+	rec.name = xodbinary_string(w, cg->group_name);
+	rec.alias = xodbinary_string_or_name(w, cg->alias, cg->group_name);
+	xodbinary_write_contacts(w, &rec.members, cg->members);
+	xodbinary_append(w, XODBINARY_CONTACTGROUPS, &rec);
+	}
+
+
+static void xodbinary_write_hostgroup(xodbinary_writer *w, hostgroup *hg) {
+	struct xodbinary_group rec;
+	hostsmember *hm;
+
+	memset(&rec, 0, sizeof(rec));
+	rec.name = xodbinary_string(w, hg->group_name);
+	rec.alias = xodbinary_string_or_name(w, hg->alias, hg->group_name);
+	rec.notes = xodbinary_string(w, hg->notes);
+	rec.notes_url = xodbinary_string(w, hg->notes_url);
+	rec.action_url = xodbinary_string(w, hg->action_url);
+	xodbinary_list_start(w, &rec.members, XODBINARY_IDS);
+	for(hm = hg->members; hm; hm = hm->next)
+		xodbinary_list_id(w, &rec.members, hm->host_ptr->id);
+	xodbinary_append(w, XODBINARY_HOSTGROUPS, &rec);
+	}
+
+
+static void xodbinary_write_servicegroup(xodbinary_writer *w, servicegroup *sg) {
+	struct xodbinary_group rec;
+	servicesmember *sm;
+
+	memset(&rec, 0, sizeof(rec));
+	rec.name = xodbinary_string(w, sg->group_name);
+	rec.alias = xodbinary_string_or_name(w, sg->alias, sg->group_name);
+	rec.notes = xodbinary_string(w, sg->notes);
+	rec.notes_url = xodbinary_string(w, sg->notes_url);
+	rec.action_url = xodbinary_string(w, sg->action_url);
+	xodbinary_list_start(w, &rec.members, XODBINARY_IDS);
+	for(sm = sg->members; sm; sm = sm->next)
+		xodbinary_list_id(w, &rec.members, sm->service_ptr->id);
+	xodbinary_append(w, XODBINARY_SERVICEGROUPS, &rec);
+	}
+
+
+static void xodbinary_write_commands(xodbinary_writer *w, struct xodbinary_list *l, commandsmember *list) {
+	xodbinary_list_start(w, l, XODBINARY_IDS);
+	for(; list; list = list->next)
+		xodbinary_list_id(w, l, xodbinary_string(w, list->command));
+	}
+
+
+static void xodbinary_write_contact(xodbinary_writer *w, contact *cntct) {
+	struct xodbinary_contact rec;
+	int x;
+
+	memset(&rec, 0, sizeof(rec));
+	rec.name = xodbinary_string(w, cntct->name);
+	rec.alias = xodbinary_string_or_name(w, cntct->alias, cntct->name);
+	rec.email = xodbinary_string(w, cntct->email);
+	rec.pager = xodbinary_string(w, cntct->pager);
+	for(x = 0; x < MAX_CONTACT_ADDRESSES; x++)
+		rec.address[x] = xodbinary_string(w, cntct->address[x]);
+	rec.host_notification_period = xodbinary_period_id(cntct->host_notification_period_ptr, cntct->host_notification_period);
+	rec.service_notification_period = xodbinary_period_id(cntct->service_notification_period_ptr, cntct->service_notification_period);
+	rec.host_notification_options = cntct->host_notification_options;
+	rec.service_notification_options = cntct->service_notification_options;
+	rec.minimum_value = cntct->minimum_value;
+	rec.host_notifications_enabled = cntct->host_notifications_enabled;
+	rec.service_notifications_enabled = cntct->service_notifications_enabled;
+	rec.can_submit_commands = cntct->can_submit_commands;
+	rec.retain_status_information = cntct->retain_status_information;
+	rec.retain_nonstatus_information = cntct->retain_nonstatus_information;
+	xodbinary_write_commands(w, &rec.host_notification_commands, cntct->host_notification_commands);
+	xodbinary_write_commands(w, &rec.service_notification_commands, cntct->service_notification_commands);
+	xodbinary_write_groups(w, &rec.contactgroups, cntct->contactgroups_ptr);
+	xodbinary_write_customvars(w, &rec.custom_variables, cntct->custom_variables);
+	xodbinary_append(w, XODBINARY_CONTACTS, &rec);
+	}
+
+
+static void xodbinary_write_host(xodbinary_writer *w, host *hst) {
+	struct xodbinary_host rec;
+	hostsmember *parent;
+
+	memset(&rec, 0, sizeof(rec));
+	rec.name = xodbinary_string(w, hst->name);
+	rec.display_name = xodbinary_string_or_name(w, hst->display_name, hst->name);
+	rec.alias = xodbinary_string_or_name(w, hst->alias, hst->name);
+	rec.address = xodbinary_string_or_name(w, hst->address, hst->name);
+	rec.check_command = xodbinary_string(w, hst->check_command);
+	rec.event_handler = xodbinary_string(w, hst->event_handler);
+	rec.notes = xodbinary_string(w, hst->notes);
+	rec.notes_url = xodbinary_string(w, hst->notes_url);
+	rec.action_url = xodbinary_string(w, hst->action_url);
+	rec.icon_image = xodbinary_string(w, hst->icon_image);
+	rec.icon_image_alt = xodbinary_string(w, hst->icon_image_alt);
+	rec.vrml_image = xodbinary_string(w, hst->vrml_image);
+	rec.statusmap_image = xodbinary_string(w, hst->statusmap_image);
+	rec.check_period = xodbinary_period_id(hst->check_period_ptr, hst->check_period);
+	rec.notification_period = xodbinary_period_id(hst->notification_period_ptr, hst->notification_period);
+	rec.event_handler_period = xodbinary_period_id(hst->event_handler_period_ptr, hst->event_handler_period);
+
+	/* nothing has changed the state since the host was added */
+	rec.initial_state = hst->current_state;
+	rec.check_interval = hst->check_interval;
+	rec.retry_interval = hst->retry_interval;
+	rec.max_attempts = hst->max_attempts;
+	rec.notification_options = hst->notification_options;
+	rec.notification_interval = hst->notification_interval;
+	rec.first_notification_delay = hst->first_notification_delay;
+	rec.notifications_enabled = hst->notifications_enabled;
+	rec.checks_enabled = hst->checks_enabled;
+	rec.accept_passive_checks = hst->accept_passive_checks;
+	rec.event_handler_enabled = hst->event_handler_enabled;
+	rec.flap_detection_enabled = hst->flap_detection_enabled;
+	rec.low_flap_threshold = hst->low_flap_threshold;
+	rec.high_flap_threshold = hst->high_flap_threshold;
+	rec.flap_detection_options = hst->flap_detection_options;
+	rec.stalking_options = hst->stalking_options;
+	rec.process_performance_data = hst->process_performance_data;
+	rec.check_freshness = hst->check_freshness;
+	rec.freshness_threshold = hst->freshness_threshold;
+	rec.x_2d = hst->x_2d;
+	rec.y_2d = hst->y_2d;
+	rec.have_2d_coords = hst->have_2d_coords;
+	rec.x_3d = hst->x_3d;
+	rec.y_3d = hst->y_3d;
+	rec.z_3d = hst->z_3d;
+	rec.have_3d_coords = hst->have_3d_coords;
+	rec.should_be_drawn = hst->should_be_drawn;
+	rec.retain_status_information = hst->retain_status_information;
+	rec.retain_nonstatus_information = hst->retain_nonstatus_information;
+	rec.obsess = hst->obsess;
+	rec.hourly_value = hst->hourly_value;
+
+	xodbinary_list_start(w, &rec.parents, XODBINARY_IDS);
+	for(parent = hst->parent_hosts; parent; parent = parent->next) {
+		host *h = parent->host_ptr ? parent->host_ptr : find_host(parent->host_name);
+		if(h == NULL) {
+			w->error = TRUE;
+			break;
+			}
+		xodbinary_list_id(w, &rec.parents, h->id);
+		}
+	xodbinary_write_contacts(w, &rec.contacts, hst->contacts);
+	xodbinary_write_contactgroups(w, &rec.contact_groups, hst->contact_groups);
+	xodbinary_write_groups(w, &rec.hostgroups, hst->hostgroups_ptr);
+	xodbinary_write_customvars(w, &rec.custom_variables, hst->custom_variables);
+
+	xodbinary_append(w, XODBINARY_HOSTS, &rec);
+	}
+
+
+static void xodbinary_write_service(xodbinary_writer *w, service *svc) {
+	struct xodbinary_service rec;
+	servicesmember *parent;
+
+	memset(&rec, 0, sizeof(rec));
+	rec.host = svc->host_ptr->id;
+	rec.description = xodbinary_string(w, svc->description);
+	rec.display_name = xodbinary_string_or_name(w, svc->display_name, svc->description);
+	rec.check_command = xodbinary_string(w, svc->check_command);
+	rec.event_handler = xodbinary_string(w, svc->event_handler);
+	rec.notes = xodbinary_string(w, svc->notes);
+	rec.notes_url = xodbinary_string(w, svc->notes_url);
+	rec.action_url = xodbinary_string(w, svc->action_url);
+	rec.icon_image = xodbinary_string(w, svc->icon_image);
+	rec.icon_image_alt = xodbinary_string(w, svc->icon_image_alt);
+	rec.check_period = xodbinary_period_id(svc->check_period_ptr, svc->check_period);
+	rec.notification_period = xodbinary_period_id(svc->notification_period_ptr, svc->notification_period);
+	rec.event_handler_period = xodbinary_period_id(svc->event_handler_period_ptr, svc->event_handler_period);
+
+	rec.initial_state = svc->current_state;
+	rec.max_attempts = svc->max_attempts;
+	rec.parallelize = svc->parallelize;
+	rec.accept_passive_checks = svc->accept_passive_checks;
+	rec.check_interval = svc->check_interval;
+	rec.retry_interval = svc->retry_interval;
+	rec.notification_interval = svc->notification_interval;
+	rec.first_notification_delay = svc->first_notification_delay;
+	rec.notification_options = svc->notification_options;
+	rec.notifications_enabled = svc->notifications_enabled;
+	rec.is_volatile = svc->is_volatile;
+	rec.event_handler_enabled = svc->event_handler_enabled;
+	rec.checks_enabled = svc->checks_enabled;
+	rec.flap_detection_enabled = svc->flap_detection_enabled;
+	rec.low_flap_threshold = svc->low_flap_threshold;
+	rec.high_flap_threshold = svc->high_flap_threshold;
+	rec.flap_detection_options = svc->flap_detection_options;
+	rec.stalking_options = svc->stalking_options;
+	rec.process_performance_data = svc->process_performance_data;
+	rec.check_freshness = svc->check_freshness;
+	rec.freshness_threshold = svc->freshness_threshold;
+	rec.retain_status_information = svc->retain_status_information;
+	rec.retain_nonstatus_information = svc->retain_nonstatus_information;
+	rec.obsess = svc->obsess;
+	rec.hourly_value = svc->hourly_value;
+
+	xodbinary_list_start(w, &rec.parents, XODBINARY_IDS);
+	for(parent = svc->parents; parent; parent = parent->next) {
+		service *s = parent->service_ptr ? parent->service_ptr : find_service(parent->host_name, parent->service_description);
+		if(s == NULL) {
+			w->error = TRUE;
+			break;
+			}
+		xodbinary_list_id(w, &rec.parents, s->id);
+		}
+	xodbinary_write_contacts(w, &rec.contacts, svc->contacts);
+	xodbinary_write_contactgroups(w, &rec.contact_groups, svc->contact_groups);
+	xodbinary_write_groups(w, &rec.servicegroups, svc->servicegroups_ptr);
+	xodbinary_write_customvars(w, &rec.custom_variables, svc->custom_variables);
+
+	xodbinary_append(w, XODBINARY_SERVICES, &rec);
+	}
+
+
+static void xodbinary_write_hostdependencies(xodbinary_writer *w, objectlist *list) {
+	struct xodbinary_dependency rec;
+
+	for(; list; list = list->next) {
+		hostdependency *hd = (hostdependency *)list->object_ptr;
+		rec.dependent = hd->dependent_host_ptr->id;
+		rec.master = hd->master_host_ptr->id;
+		rec.dependency_period = xodbinary_period_id(hd->dependency_period_ptr, hd->dependency_period);
+		rec.dependency_type = hd->dependency_type;
+		rec.inherits_parent = hd->inherits_parent;
+		rec.failure_options = hd->failure_options;
+		xodbinary_append(w, XODBINARY_HOSTDEPENDENCIES, &rec);
+		}
+	}
+
+
+static void xodbinary_write_servicedependencies(xodbinary_writer *w, objectlist *list) {
+	struct xodbinary_dependency rec;
+
+	for(; list; list = list->next) {
+		servicedependency *sd = (servicedependency *)list->object_ptr;
+		rec.dependent = sd->dependent_service_ptr->id;
+		rec.master = sd->master_service_ptr->id;
+		rec.dependency_period = xodbinary_period_id(sd->dependency_period_ptr, sd->dependency_period);
+		rec.dependency_type = sd->dependency_type;
+		rec.inherits_parent = sd->inherits_parent;
+		rec.failure_options = sd->failure_options;
+		xodbinary_append(w, XODBINARY_SERVICEDEPENDENCIES, &rec);
+		}
+	}
+
+
+static void xodbinary_write_escalation(xodbinary_writer *w, int section, uint32_t object, int first, int last, double interval, timeperiod *tp, const char *period, int options, contactsmember *contacts, contactgroupsmember *contact_groups) {
+	struct xodbinary_escalation rec;
+
+	memset(&rec, 0, sizeof(rec));
+	rec.object = object;
+	rec.first_notification = first;
+	rec.last_notification = last;
+	rec.notification_interval = interval;
+	rec.escalation_period = xodbinary_period_id(tp, period);
+	rec.escalation_options = options;
+	xodbinary_write_contacts(w, &rec.contacts, contacts);
+	xodbinary_write_contactgroups(w, &rec.contact_groups, contact_groups);
+	xodbinary_append(w, section, &rec);
+	}
+
+
+/* writes the header and all sections, padding each to 8 bytes */
+static int xodbinary_write_file(xodbinary_writer *w, FILE *fp) {
+	static const char pad[8];
+	struct xodbinary_header hdr;
+	uint64_t offset;
+	int i;
+
+	memset(&hdr, 0, sizeof(hdr));
+	memcpy(hdr.magic, XODBINARY_MAGIC, sizeof(hdr.magic));
+	hdr.version = XODBINARY_VERSION;
+	hdr.byte_order = XODBINARY_BYTE_ORDER;
+	hdr.header_size = sizeof(hdr);
+	hdr.num_sections = XODBINARY_NUM_SECTIONS;
+
+	offset = xodbinary_align(sizeof(hdr));
+	for(i = 0; i < XODBINARY_NUM_SECTIONS; i++) {
+		hdr.section[i].offset = offset;
+		hdr.section[i].count = (uint32_t)(w->sect[i].len / xodbinary_rec_size[i]);
+		hdr.section[i].rec_size = xodbinary_rec_size[i];
+		offset = xodbinary_align(offset + w->sect[i].len);
+		}
+	hdr.file_size = offset;
+
+	if(fwrite(&hdr, sizeof(hdr), 1, fp) != 1)
+		return ERROR;
+	offset = sizeof(hdr);
+	for(i = 0; i < XODBINARY_NUM_SECTIONS; i++) {
+		if(fwrite(pad, 1, hdr.section[i].offset - offset, fp) != hdr.section[i].offset - offset)
+			return ERROR;
+		if(w->sect[i].len && fwrite(w->sect[i].buf, w->sect[i].len, 1, fp) != 1)
+			return ERROR;
+		offset = hdr.section[i].offset + w->sect[i].len;
+		}
+	if(fwrite(pad, 1, hdr.file_size - offset, fp) != hdr.file_size - offset)
+		return ERROR;
+
+	return OK;
+	}
+
+
+/* writes all registered objects to a binary precache */
+int xodbinary_write_precache(const char *precache_file) {
+	xodbinary_writer w;
+	char *tmp_file = NULL;
+	unsigned int i;
+	int fd, result = OK, saved_errno = 0;
+	FILE *fp;
+
+	memset(&w, 0, sizeof(w));
+	w.strings = dkhash_create(num_objects.hosts + num_objects.services + num_objects.contacts + 1024);
+	if(w.strings == NULL)
+		return ERROR;
+
+	/* offset 0 is NULL */
+	xodbinary_append(&w, XODBINARY_STRINGS, "");
+
+	for(i = 0; i < num_objects.timeperiods; i++)
+		xodbinary_write_timeperiod(&w, timeperiod_ary[i]);
+	for(i = 0; i < num_objects.commands; i++)
+		xodbinary_write_command(&w, command_ary[i]);
+	for(i = 0; i < num_objects.contactgroups; i++)
+		xodbinary_write_contactgroup(&w, contactgroup_ary[i]);
+	for(i = 0; i < num_objects.hostgroups; i++)
+		xodbinary_write_hostgroup(&w, hostgroup_ary[i]);
+	for(i = 0; i < num_objects.servicegroups; i++)
+		xodbinary_write_servicegroup(&w, servicegroup_ary[i]);
+	for(i = 0; i < num_objects.contacts; i++)
+		xodbinary_write_contact(&w, contact_ary[i]);
+	for(i = 0; i < num_objects.hosts; i++)
+		xodbinary_write_host(&w, host_ary[i]);
+	for(i = 0; i < num_objects.services; i++)
+		xodbinary_write_service(&w, service_ary[i]);
+
+	/*
+	 * dependencies have no ids of their own, so they're stored in the
+	 * order they sit in the dependent objects' lists. Reading them back
+	 * in reverse rebuilds those lists exactly.
+	 */
+	for(i = 0; i < num_objects.hosts; i++) {
+		xodbinary_write_hostdependencies(&w, host_ary[i]->notify_deps);
+		xodbinary_write_hostdependencies(&w, host_ary[i]->exec_deps);
+		}
+	for(i = 0; i < num_objects.services; i++) {
+		xodbinary_write_servicedependencies(&w, service_ary[i]->notify_deps);
+		xodbinary_write_servicedependencies(&w, service_ary[i]->exec_deps);
+		}
+
+	for(i = 0; i < num_objects.hostescalations; i++) {
+		hostescalation *he = hostescalation_ary[i];
+		xodbinary_write_escalation(&w, XODBINARY_HOSTESCALATIONS, he->host_ptr->id, he->first_notification, he->last_notification, he->notification_interval, he->escalation_period_ptr, he->escalation_period, he->escalation_options, he->contacts, he->contact_groups);
+		}
+	for(i = 0; i < num_objects.serviceescalations; i++) {
+		serviceescalation *se = serviceescalation_ary[i];
+		xodbinary_write_escalation(&w, XODBINARY_SERVICEESCALATIONS, se->service_ptr->id, se->first_notification, se->last_notification, se->notification_interval, se->escalation_period_ptr, se->escalation_period, se->escalation_options, se->contacts, se->contact_groups);
+		}
+
+	dkhash_destroy(w.strings);
+
+	if(w.error == TRUE) {
+		logit(NSLOG_CONFIG_ERROR, TRUE, "Error: Failed to build binary object precache\n");
+		result = ERROR;
+		saved_errno = ENOMEM;
+		}
+
+	/* a running core may still be reading the old one, so replace it atomically */
+	if(result == OK) {
+		asprintf(&tmp_file, "%s.XXXXXX", precache_file);
+		if(tmp_file == NULL || (fd = mkstemp(tmp_file)) < 0) {
+			saved_errno = errno;
+			result = ERROR;
+			}
+		else {
+			fchmod(fd, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+			if((fp = fdopen(fd, "w")) == NULL) {
+				saved_errno = errno;
+				close(fd);
+				result = ERROR;
+				}
+			else {
+				if(xodbinary_write_file(&w, fp) != OK)
+					saved_errno = errno;
+				if(fclose(fp) != 0 && !saved_errno)
+					saved_errno = errno;
+				if(saved_errno || rename(tmp_file, precache_file) < 0) {
+					if(!saved_errno)
+						saved_errno = errno;
+					unlink(tmp_file);
+					result = ERROR;
+					}
+				}
+			}
+		my_free(tmp_file);
+		}
+
+	for(i = 0; i < XODBINARY_NUM_SECTIONS; i++)
+		my_free(w.sect[i].buf);
+
+	errno = saved_errno;
+	return result;
+	}
+
+
+
+/******************************************************************/
+/************************** READ FUNCTIONS ************************/
+/******************************************************************/
+
+typedef struct xodbinary_map {
+	const char *path;
+	char *base;
+	size_t size;
+	const void *sect[XODBINARY_NUM_SECTIONS];
+	uint32_t count[XODBINARY_NUM_SECTIONS];
+	int corrupt;
+	} xodbinary_map;
+
+
+/* checks if a file is a binary precache */
+int xodbinary_is_precache(const char *precache_file) {
+	char magic[8];
+	int fd, result = FALSE;
+
+	if((fd = open(precache_file, O_RDONLY)) < 0)
+		return FALSE;
+	if(read(fd, magic, sizeof(magic)) == sizeof(magic) && !memcmp(magic, XODBINARY_MAGIC, sizeof(magic)))
+		result = TRUE;
+	close(fd);
+
+	return result;
+	}
+
+
+/* validates the header and locates the sections */
+static const char *xodbinary_check_header(xodbinary_map *m) {
+	const struct xodbinary_header *hdr = (const struct xodbinary_header *)m->base;
+	int i;
+
+	if(m->size < sizeof(*hdr) || memcmp(hdr->magic, XODBINARY_MAGIC, sizeof(hdr->magic)))
+		return "not a binary object precache";
+	if(hdr->byte_order != XODBINARY_BYTE_ORDER)
+		return "written on a machine with a different byte order";
+	if(hdr->version != XODBINARY_VERSION || hdr->header_size != sizeof(*hdr) || hdr->num_sections != XODBINARY_NUM_SECTIONS)
+		return "written by a different version of Nagios";
+	if(hdr->file_size != m->size)
+		return "truncated";
+
+	for(i = 0; i < XODBINARY_NUM_SECTIONS; i++) {
+		const struct xodbinary_section *s = &hdr->section[i];
+		if(s->rec_size != xodbinary_rec_size[i])
+			return "written by a different version of Nagios";
+		if(s->offset < sizeof(*hdr) || s->offset % 8 || s->offset + (uint64_t)s->count * s->rec_size > m->size)
+			return "corrupt section table";
+		m->sect[i] = m->base + s->offset;
+		m->count[i] = s->count;
+		}
+
+	/* every string offset then points at a terminated string */
+	if(!m->count[XODBINARY_STRINGS] || ((const char *)m->sect[XODBINARY_STRINGS])[m->count[XODBINARY_STRINGS] - 1] != '\0')
+		return "corrupt string table";
+
+	return NULL;
+	}
+
+
+static char *xodbinary_str(xodbinary_map *m, uint32_t offset) {
+	if(offset == 0)
+		return NULL;
+	if(offset >= m->count[XODBINARY_STRINGS]) {
+		m->corrupt = TRUE;
+		return NULL;
+		}
+	return (char *)m->sect[XODBINARY_STRINGS] + offset;
+	}
+
+
+/* the core frees object strings one by one, so they can't point into the map */
+static char *xodbinary_strdup(xodbinary_map *m, uint32_t offset) {
+	char *str = xodbinary_str(m, offset);
+	return str ? strdup(str) : NULL;
+	}
+
+
+static char *xodbinary_period(xodbinary_map *m, uint32_t id) {
+	if(id == XODBINARY_NONE)
+		return NULL;
+	if(id >= num_objects.timeperiods) {
+		m->corrupt = TRUE;
+		return NULL;
+		}
+	return timeperiod_ary[id]->name;
+	}
+
+
+/* returns the first record of a list, after making sure it's all there */
+static const void *xodbinary_run(xodbinary_map *m, int section, const struct xodbinary_list *l) {
+	if((uint64_t)l->first + l->count > m->count[section]) {
+		m->corrupt = TRUE;
+		return NULL;
+		}
+	return (const char *)m->sect[section] + (size_t)l->first * xodbinary_rec_size[section];
+	}
+
+
+/* returns a list of ids, after making sure they're all below limit */
+static const uint32_t *xodbinary_ids(xodbinary_map *m, const struct xodbinary_list *l, uint32_t limit) {
+	const uint32_t *ids = (const uint32_t *)xodbinary_run(m, XODBINARY_IDS, l);
+	uint32_t i;
+
+	if(ids == NULL)
+		return NULL;
+	for(i = 0; i < l->count; i++) {
+		if(ids[i] >= limit) {
+			m->corrupt = TRUE;
+			return NULL;
+			}
+		}
+	return ids;
+	}
+
+
+/*
+ * The list builders below append, so lists come out in the order they
+ * were written, which is the order they had when the precache was made.
+ */
+static int xodbinary_read_contacts(xodbinary_map *m, contactsmember **list, const struct xodbinary_list *l) {
+	const uint32_t *ids = xodbinary_ids(m, l, num_objects.contacts);
+	contactsmember *cm;
+	uint32_t i;
+
+	if(ids == NULL)
+		return ERROR;
+	for(i = 0; i < l->count; i++) {
+		if((cm = (contactsmember *)malloc(sizeof(*cm))) == NULL)
+			return ERROR;
+		cm->contact_ptr = contact_ary[ids[i]];
+		cm->contact_name = cm->contact_ptr->name;
+		cm->next = NULL;
+		*list = cm;
+		list = &cm->next;
+		}
+	return OK;
+	}
+
+
+static int xodbinary_read_contactgroups(xodbinary_map *m, contactgroupsmember **list, const struct xodbinary_list *l) {
+	const uint32_t *ids = xodbinary_ids(m, l, num_objects.contactgroups);
+	contactgroupsmember *cgm;
+	uint32_t i;
+
+	if(ids == NULL)
+		return ERROR;
+	for(i = 0; i < l->count; i++) {
+		if((cgm = (contactgroupsmember *)malloc(sizeof(*cgm))) == NULL)
+			return ERROR;
+		cgm->group_ptr = contactgroup_ary[ids[i]];
+		cgm->group_name = cgm->group_ptr->group_name;
+		cgm->next = NULL;
+		*list = cgm;
+		list = &cgm->next;
+		}
+	return OK;
+	}
+
+
+static int xodbinary_read_groups(xodbinary_map *m, objectlist **list, const struct xodbinary_list *l, void **ary, unsigned int num) {
+	const uint32_t *ids = xodbinary_ids(m, l, num);
+	objectlist *item;
+	uint32_t i;
+
+	if(ids == NULL)
+		return ERROR;
+	for(i = 0; i < l->count; i++) {
+		if((item = (objectlist *)malloc(sizeof(*item))) == NULL)
+			return ERROR;
+		item->object_ptr = ary[ids[i]];
+		item->next = NULL;
+		*list = item;
+		list = &item->next;
+		}
+	return OK;
+	}
+
+
+static int xodbinary_read_customvars(xodbinary_map *m, customvariablesmember **list, const struct xodbinary_list *l) {
+	const struct xodbinary_customvar *cv = xodbinary_run(m, XODBINARY_CUSTOMVARS, l);
+	customvariablesmember *cvm;
+	uint32_t i;
+
+	if(cv == NULL)
+		return ERROR;
+	for(i = 0; i < l->count; i++) {
+		if((cvm = (customvariablesmember *)malloc(sizeof(*cvm))) == NULL)
+			return ERROR;
+		cvm->variable_name = xodbinary_strdup(m, cv[i].name);
+		cvm->variable_value = xodbinary_strdup(m, cv[i].value);
+		cvm->has_been_modified = FALSE;
+		cvm->next = NULL;
+		*list = cvm;
+		list = &cvm->next;
+		}
+	return m->corrupt ? ERROR : OK;
+	}
+
+
+static int xodbinary_read_commands(xodbinary_map *m, commandsmember **list, const struct xodbinary_list *l) {
+	const uint32_t *ids = xodbinary_ids(m, l, m->count[XODBINARY_STRINGS]);
+	commandsmember *cmd;
+	uint32_t i;
+
+	if(ids == NULL)
+		return ERROR;
+	for(i = 0; i < l->count; i++) {
+		if((cmd = (commandsmember *)calloc(1, sizeof(*cmd))) == NULL)
+			return ERROR;
+		cmd->command = xodbinary_strdup(m, ids[i]);
+		*list = cmd;
+		list = &cmd->next;
+		}
+	return OK;
+	}
+
+
+static int xodbinary_read_timeranges(xodbinary_map *m, timerange **list, const struct xodbinary_list *l) {
+	const struct xodbinary_timerange *tr = xodbinary_run(m, XODBINARY_TIMERANGES, l);
+	timerange *range;
+	uint32_t i;
+
+	if(tr == NULL)
+		return ERROR;
+	for(i = 0; i < l->count; i++) {
+		if((range = (timerange *)malloc(sizeof(*range))) == NULL)
+			return ERROR;
+		range->range_start = tr[i].start;
+		range->range_end = tr[i].end;
+		range->next = NULL;
+		*list = range;
+		list = &range->next;
+		}
+	return OK;
+	}
+
+
+static int xodbinary_read_timeperiod(xodbinary_map *m, const struct xodbinary_timeperiod *rec) {
+	const struct xodbinary_daterange *dr;
+	daterange *range, **tail;
+	timeperiod *tp;
+	char *name;
+	uint32_t i;
+	int x;
+
+	name = xodbinary_strdup(m, rec->name);
+	tp = add_timeperiod(name, rec->alias ? xodbinary_strdup(m, rec->alias) : name);
+	if(tp == NULL)
+		return ERROR;
+
+	for(x = 0; x < 7; x++) {
+		if(xodbinary_read_timeranges(m, &tp->days[x], &rec->days[x]) != OK)
+			return ERROR;
+		}
+
+	for(x = 0; x < DATERANGE_TYPES; x++) {
+		if((dr = xodbinary_run(m, XODBINARY_DATERANGES, &rec->exceptions[x])) == NULL)
+			return ERROR;
+		tail = &tp->exceptions[x];
+		for(i = 0; i < rec->exceptions[x].count; i++, dr++) {
+			if((range = (daterange *)calloc(1, sizeof(*range))) == NULL)
+				return ERROR;
+			range->type = dr->type;
+			range->syear = dr->syear;
+			range->smon = dr->smon;
+			range->smday = dr->smday;
+			range->swday = dr->swday;
+			range->swday_offset = dr->swday_offset;
+			range->eyear = dr->eyear;
+			range->emon = dr->emon;
+			range->emday = dr->emday;
+			range->ewday = dr->ewday;
+			range->ewday_offset = dr->ewday_offset;
+			range->skip_interval = dr->skip_interval;
+			*tail = range;
+			tail = &range->next;
+			if(xodbinary_read_timeranges(m, &range->times, &dr->times) != OK)
+				return ERROR;
+			}
+		}
+
+	return OK;
+	}
+
+
+/* exclusions may name timeperiods that come later, so they're done last */
+static int xodbinary_read_exclusions(xodbinary_map *m, timeperiod *tp, const struct xodbinary_list *l) {
+	const uint32_t *ids = xodbinary_ids(m, l, num_objects.timeperiods);
+	timeperiodexclusion *exclusion, **tail = &tp->exclusions;
+	uint32_t i;
+
+	if(ids == NULL)
+		return ERROR;
+	for(i = 0; i < l->count; i++) {
+		if((exclusion = (timeperiodexclusion *)malloc(sizeof(*exclusion))) == NULL)
+			return ERROR;
+		exclusion->timeperiod_ptr = timeperiod_ary[ids[i]];
+		exclusion->timeperiod_name = strdup(exclusion->timeperiod_ptr->name);
+		exclusion->next = NULL;
+		*tail = exclusion;
+		tail = &exclusion->next;
+		}
+	return OK;
+	}
+
+
+static int xodbinary_read_contact(xodbinary_map *m, const struct xodbinary_contact *rec) {
+	char *addresses[MAX_CONTACT_ADDRESSES];
+	char *name;
+	contact *cntct;
+	int x;
+
+	for(x = 0; x < MAX_CONTACT_ADDRESSES; x++)
+		addresses[x] = xodbinary_strdup(m, rec->address[x]);
+	name = xodbinary_strdup(m, rec->name);
+
+	cntct = add_contact(name, rec->alias ? xodbinary_strdup(m, rec->alias) : NULL,
+	                    xodbinary_strdup(m, rec->email), xodbinary_strdup(m, rec->pager), addresses,
+	                    xodbinary_period(m, rec->service_notification_period), xodbinary_period(m, rec->host_notification_period),
+	                    rec->service_notification_options, rec->host_notification_options,
+	                    rec->host_notifications_enabled, rec->service_notifications_enabled, rec->can_submit_commands,
+	                    rec->retain_status_information, rec->retain_nonstatus_information, rec->minimum_value);
+	if(cntct == NULL || m->corrupt)
+		return ERROR;
+
+	if(xodbinary_read_commands(m, &cntct->host_notification_commands, &rec->host_notification_commands) != OK)
+		return ERROR;
+	if(xodbinary_read_commands(m, &cntct->service_notification_commands, &rec->service_notification_commands) != OK)
+		return ERROR;
+	if(xodbinary_read_groups(m, &cntct->contactgroups_ptr, &rec->contactgroups, (void **)contactgroup_ary, num_objects.contactgroups) != OK)
+		return ERROR;
+	return xodbinary_read_customvars(m, &cntct->custom_variables, &rec->custom_variables);
+	}
+
+
+static int xodbinary_read_host(xodbinary_map *m, const struct xodbinary_host *rec) {
+	host *hst;
+
+	hst = add_host(xodbinary_strdup(m, rec->name), xodbinary_strdup(m, rec->display_name),
+	               xodbinary_strdup(m, rec->alias), xodbinary_strdup(m, rec->address),
+	               xodbinary_period(m, rec->check_period), rec->initial_state,
+	               rec->check_interval, rec->retry_interval, rec->max_attempts,
+	               rec->notification_options, rec->notification_interval, rec->first_notification_delay,
+	               xodbinary_period(m, rec->notification_period), rec->notifications_enabled,
+	               xodbinary_strdup(m, rec->check_command), rec->checks_enabled, rec->accept_passive_checks,
+	               xodbinary_strdup(m, rec->event_handler), rec->event_handler_enabled,
+	               xodbinary_period(m, rec->event_handler_period), rec->flap_detection_enabled,
+	               rec->low_flap_threshold, rec->high_flap_threshold, rec->flap_detection_options,
+	               rec->stalking_options, rec->process_performance_data, rec->check_freshness,
+	               rec->freshness_threshold, xodbinary_strdup(m, rec->notes), xodbinary_strdup(m, rec->notes_url),
+	               xodbinary_strdup(m, rec->action_url), xodbinary_strdup(m, rec->icon_image),
+	               xodbinary_strdup(m, rec->icon_image_alt), xodbinary_strdup(m, rec->vrml_image),
+	               xodbinary_strdup(m, rec->statusmap_image), rec->x_2d, rec->y_2d, rec->have_2d_coords,
+	               rec->x_3d, rec->y_3d, rec->z_3d, rec->have_3d_coords, rec->should_be_drawn,
+	               rec->retain_status_information, rec->retain_nonstatus_information, rec->obsess,
+	               rec->hourly_value);
+	if(hst == NULL || m->corrupt)
+		return ERROR;
+
+	if(xodbinary_read_contacts(m, &hst->contacts, &rec->contacts) != OK)
+		return ERROR;
+	if(xodbinary_read_contactgroups(m, &hst->contact_groups, &rec->contact_groups) != OK)
+		return ERROR;
+	if(xodbinary_read_groups(m, &hst->hostgroups_ptr, &rec->hostgroups, (void **)hostgroup_ary, num_objects.hostgroups) != OK)
+		return ERROR;
+	return xodbinary_read_customvars(m, &hst->custom_variables, &rec->custom_variables);
+	}
+
+
+/* child links are added by the pre-flight check, as they are for text configs */
+static int xodbinary_read_host_parents(xodbinary_map *m, host *hst, const struct xodbinary_list *l) {
+	const uint32_t *ids = xodbinary_ids(m, l, num_objects.hosts);
+	hostsmember *hm, **tail = &hst->parent_hosts;
+	uint32_t i;
+
+	if(ids == NULL)
+		return ERROR;
+	for(i = 0; i < l->count; i++) {
+		if((hm = (hostsmember *)malloc(sizeof(*hm))) == NULL)
+			return ERROR;
+		hm->host_ptr = host_ary[ids[i]];
+		hm->host_name = strdup(hm->host_ptr->name);
+		hm->next = NULL;
+		*tail = hm;
+		tail = &hm->next;
+		}
+	return OK;
+	}
+
+
+static int xodbinary_read_service(xodbinary_map *m, const struct xodbinary_service *rec) {
+	service *svc;
+
+	if(rec->host >= num_objects.hosts)
+		return ERROR;
+
+	/* add_service() copies its strings, so they can come straight from the map */
+	svc = add_service(host_ary[rec->host]->name, xodbinary_str(m, rec->description), xodbinary_str(m, rec->display_name),
+	                  xodbinary_period(m, rec->check_period), rec->initial_state, rec->max_attempts,
+	                  rec->parallelize, rec->accept_passive_checks, rec->check_interval, rec->retry_interval,
+	                  rec->notification_interval, rec->first_notification_delay,
+	                  xodbinary_period(m, rec->notification_period), rec->notification_options,
+	                  rec->notifications_enabled, rec->is_volatile, xodbinary_str(m, rec->event_handler),
+	                  rec->event_handler_enabled, xodbinary_period(m, rec->event_handler_period),
+	                  xodbinary_str(m, rec->check_command), rec->checks_enabled, rec->flap_detection_enabled,
+	                  rec->low_flap_threshold, rec->high_flap_threshold, rec->flap_detection_options,
+	                  rec->stalking_options, rec->process_performance_data, rec->check_freshness,
+	                  rec->freshness_threshold, xodbinary_str(m, rec->notes), xodbinary_str(m, rec->notes_url),
+	                  xodbinary_str(m, rec->action_url), xodbinary_str(m, rec->icon_image),
+	                  xodbinary_str(m, rec->icon_image_alt), rec->retain_status_information,
+	                  rec->retain_nonstatus_information, rec->obsess, rec->hourly_value);
+	if(svc == NULL || m->corrupt)
+		return ERROR;
+
+	if(xodbinary_read_contacts(m, &svc->contacts, &rec->contacts) != OK)
+		return ERROR;
+	if(xodbinary_read_contactgroups(m, &svc->contact_groups, &rec->contact_groups) != OK)
+		return ERROR;
+	if(xodbinary_read_groups(m, &svc->servicegroups_ptr, &rec->servicegroups, (void **)servicegroup_ary, num_objects.servicegroups) != OK)
+		return ERROR;
+	return xodbinary_read_customvars(m, &svc->custom_variables, &rec->custom_variables);
+	}
+
+
+static int xodbinary_read_service_parents(xodbinary_map *m, service *svc, const struct xodbinary_list *l) {
+	const uint32_t *ids = xodbinary_ids(m, l, num_objects.services);
+	servicesmember *sm, **tail = &svc->parents;
+	uint32_t i;
+
+	if(ids == NULL)
+		return ERROR;
+	for(i = 0; i < l->count; i++) {
+		if((sm = (servicesmember *)malloc(sizeof(*sm))) == NULL)
+			return ERROR;
+		sm->service_ptr = service_ary[ids[i]];
+		sm->host_name = strdup(sm->service_ptr->host_name);
+		sm->service_description = strdup(sm->service_ptr->description);
+		sm->next = NULL;
+		*tail = sm;
+		tail = &sm->next;
+		}
+	return OK;
+	}
+
+
+static int xodbinary_read_group_members(xodbinary_map *m) {
+	const struct xodbinary_group *rec;
+	const uint32_t *ids;
+	uint32_t i, j;
+
+	rec = (const struct xodbinary_group *)m->sect[XODBINARY_CONTACTGROUPS];
+	for(i = 0; i < num_objects.contactgroups; i++) {
+		contactsmember **tail = &contactgroup_ary[i]->members;
+		if((ids = xodbinary_ids(m, &rec[i].members, num_objects.contacts)) == NULL)
+			return ERROR;
+		for(j = 0; j < rec[i].members.count; j++) {
+			contactsmember *cm = (contactsmember *)calloc(1, sizeof(*cm));
+			if(cm == NULL)
+				return ERROR;
+			cm->contact_ptr = contact_ary[ids[j]];
+			cm->contact_name = cm->contact_ptr->name;
+			*tail = cm;
+			tail = &cm->next;
+			}
+		}
+
+	rec = (const struct xodbinary_group *)m->sect[XODBINARY_HOSTGROUPS];
+	for(i = 0; i < num_objects.hostgroups; i++) {
+		hostsmember **tail = &hostgroup_ary[i]->members;
+		if((ids = xodbinary_ids(m, &rec[i].members, num_objects.hosts)) == NULL)
+			return ERROR;
+		for(j = 0; j < rec[i].members.count; j++) {
+			hostsmember *hm = (hostsmember *)calloc(1, sizeof(*hm));
+			if(hm == NULL)
+				return ERROR;
+			hm->host_ptr = host_ary[ids[j]];
+			hm->host_name = hm->host_ptr->name;
+			*tail = hm;
+			tail = &hm->next;
+			}
+		}
+
+	rec = (const struct xodbinary_group *)m->sect[XODBINARY_SERVICEGROUPS];
+	for(i = 0; i < num_objects.servicegroups; i++) {
+		servicesmember **tail = &servicegroup_ary[i]->members;
+		if((ids = xodbinary_ids(m, &rec[i].members, num_objects.services)) == NULL)
+			return ERROR;
+		for(j = 0; j < rec[i].members.count; j++) {
+			servicesmember *sm = (servicesmember *)calloc(1, sizeof(*sm));
+			if(sm == NULL)
+				return ERROR;
+			sm->service_ptr = service_ary[ids[j]];
+			sm->host_name = sm->service_ptr->host_name;
+			sm->service_description = sm->service_ptr->description;
+			*tail = sm;
+			tail = &sm->next;
+			}
+		}
+
+	return OK;
+	}
+
+
+static int xodbinary_read_dependencies(xodbinary_map *m) {
+	const struct xodbinary_dependency *rec;
+	uint32_t i;
+
+	/* written in list order, so adding them backwards rebuilds the lists */
+	rec = (const struct xodbinary_dependency *)m->sect[XODBINARY_HOSTDEPENDENCIES];
+	for(i = m->count[XODBINARY_HOSTDEPENDENCIES]; i > 0; i--) {
+		const struct xodbinary_dependency *d = &rec[i - 1];
+		if(d->dependent >= num_objects.hosts || d->master >= num_objects.hosts)
+			return ERROR;
+		if(!add_host_dependency(host_ary[d->dependent]->name, host_ary[d->master]->name, d->dependency_type, d->inherits_parent, d->failure_options, xodbinary_period(m, d->dependency_period)) || m->corrupt)
+			return ERROR;
+		}
+
+	rec = (const struct xodbinary_dependency *)m->sect[XODBINARY_SERVICEDEPENDENCIES];
+	for(i = m->count[XODBINARY_SERVICEDEPENDENCIES]; i > 0; i--) {
+		const struct xodbinary_dependency *d = &rec[i - 1];
+		service *dependent, *master;
+		if(d->dependent >= num_objects.services || d->master >= num_objects.services)
+			return ERROR;
+		dependent = service_ary[d->dependent];
+		master = service_ary[d->master];
+		if(!add_service_dependency(dependent->host_name, dependent->description, master->host_name, master->description, d->dependency_type, d->inherits_parent, d->failure_options, xodbinary_period(m, d->dependency_period)) || m->corrupt)
+			return ERROR;
+		}
+
+	return OK;
+	}
+
+
+static int xodbinary_read_escalations(xodbinary_map *m) {
+	const struct xodbinary_escalation *rec;
+	uint32_t i;
+
+	rec = (const struct xodbinary_escalation *)m->sect[XODBINARY_HOSTESCALATIONS];
+	for(i = 0; i < m->count[XODBINARY_HOSTESCALATIONS]; i++) {
+		hostescalation *he;
+		if(rec[i].object >= num_objects.hosts)
+			return ERROR;
+		he = add_hostescalation(host_ary[rec[i].object]->name, rec[i].first_notification, rec[i].last_notification, rec[i].notification_interval, xodbinary_period(m, rec[i].escalation_period), rec[i].escalation_options);
+		if(he == NULL || m->corrupt)
+			return ERROR;
+		if(xodbinary_read_contacts(m, &he->contacts, &rec[i].contacts) != OK)
+			return ERROR;
+		if(xodbinary_read_contactgroups(m, &he->contact_groups, &rec[i].contact_groups) != OK)
+			return ERROR;
+		}
+
+	rec = (const struct xodbinary_escalation *)m->sect[XODBINARY_SERVICEESCALATIONS];
+	for(i = 0; i < m->count[XODBINARY_SERVICEESCALATIONS]; i++) {
+		serviceescalation *se;
+		service *svc;
+		if(rec[i].object >= num_objects.services)
+			return ERROR;
+		svc = service_ary[rec[i].object];
+		se = add_serviceescalation(svc->host_name, svc->description, rec[i].first_notification, rec[i].last_notification, rec[i].notification_interval, xodbinary_period(m, rec[i].escalation_period), rec[i].escalation_options);
+		if(se == NULL || m->corrupt)
+			return ERROR;
+		if(xodbinary_read_contacts(m, &se->contacts, &rec[i].contacts) != OK)
+			return ERROR;
+		if(xodbinary_read_contactgroups(m, &se->contact_groups, &rec[i].contact_groups) != OK)
+			return ERROR;
+		}
+
+	return OK;
+	}
+
+
+/* registers all the objects in a mapped precache, in the order xodtemplate does */
+static int xodbinary_register_objects(xodbinary_map *m) {
+	const struct xodbinary_timeperiod *tp = m->sect[XODBINARY_TIMEPERIODS];
+	const struct xodbinary_command *cmd = m->sect[XODBINARY_COMMANDS];
+	const struct xodbinary_group *grp;
+	const struct xodbinary_contact *cntct = m->sect[XODBINARY_CONTACTS];
+	const struct xodbinary_host *hst = m->sect[XODBINARY_HOSTS];
+	const struct xodbinary_service *svc = m->sect[XODBINARY_SERVICES];
+	unsigned int ocount[NUM_OBJECT_SKIPLISTS];
+	uint32_t i;
+
+	memset(ocount, 0, sizeof(ocount));
+	ocount[TIMEPERIOD_SKIPLIST] = m->count[XODBINARY_TIMEPERIODS];
+	ocount[COMMAND_SKIPLIST] = m->count[XODBINARY_COMMANDS];
+	ocount[CONTACTGROUP_SKIPLIST] = m->count[XODBINARY_CONTACTGROUPS];
+	ocount[HOSTGROUP_SKIPLIST] = m->count[XODBINARY_HOSTGROUPS];
+	ocount[SERVICEGROUP_SKIPLIST] = m->count[XODBINARY_SERVICEGROUPS];
+	ocount[CONTACT_SKIPLIST] = m->count[XODBINARY_CONTACTS];
+	ocount[HOST_SKIPLIST] = m->count[XODBINARY_HOSTS];
+	ocount[SERVICE_SKIPLIST] = m->count[XODBINARY_SERVICES];
+	ocount[HOSTESCALATION_SKIPLIST] = m->count[XODBINARY_HOSTESCALATIONS];
+	ocount[SERVICEESCALATION_SKIPLIST] = m->count[XODBINARY_SERVICEESCALATIONS];
+
+	if(create_object_tables(ocount) != OK) {
+		logit(NSLOG_CONFIG_ERROR, TRUE, "Failed to create object tables\n");
+		return ERROR;
+		}
+
+	for(i = 0; i < m->count[XODBINARY_TIMEPERIODS]; i++) {
+		if(xodbinary_read_timeperiod(m, &tp[i]) != OK)
+			return ERROR;
+		}
+	for(i = 0; i < m->count[XODBINARY_TIMEPERIODS]; i++) {
+		if(xodbinary_read_exclusions(m, timeperiod_ary[i], &tp[i].exclusions) != OK)
+			return ERROR;
+		}
+	timing_point("%u timeperiods registered\n", num_objects.timeperiods);
+
+	for(i = 0; i < m->count[XODBINARY_COMMANDS]; i++) {
+		if(!add_command(xodbinary_strdup(m, cmd[i].name), xodbinary_strdup(m, cmd[i].command_line)))
+			return ERROR;
+		}
+	timing_point("%u commands registered\n", num_objects.commands);
+
+	grp = m->sect[XODBINARY_CONTACTGROUPS];
+	for(i = 0; i < m->count[XODBINARY_CONTACTGROUPS]; i++) {
+		if(!add_contactgroup(xodbinary_strdup(m, grp[i].name), xodbinary_strdup(m, grp[i].alias)))
+			return ERROR;
+		}
+	grp = m->sect[XODBINARY_HOSTGROUPS];
+	for(i = 0; i < m->count[XODBINARY_HOSTGROUPS]; i++) {
+		if(!add_hostgroup(xodbinary_strdup(m, grp[i].name), xodbinary_strdup(m, grp[i].alias), xodbinary_strdup(m, grp[i].notes), xodbinary_strdup(m, grp[i].notes_url), xodbinary_strdup(m, grp[i].action_url)))
+			return ERROR;
+		}
+	grp = m->sect[XODBINARY_SERVICEGROUPS];
+	for(i = 0; i < m->count[XODBINARY_SERVICEGROUPS]; i++) {
+		if(!add_servicegroup(xodbinary_strdup(m, grp[i].name), xodbinary_strdup(m, grp[i].alias), xodbinary_strdup(m, grp[i].notes), xodbinary_strdup(m, grp[i].notes_url), xodbinary_strdup(m, grp[i].action_url)))
+			return ERROR;
+		}
+	timing_point("%u contactgroups, %u hostgroups and %u servicegroups registered\n", num_objects.contactgroups, num_objects.hostgroups, num_objects.servicegroups);
+
+	for(i = 0; i < m->count[XODBINARY_CONTACTS]; i++) {
+		if(xodbinary_read_contact(m, &cntct[i]) != OK)
+			return ERROR;
+		}
+	timing_point("%u contacts registered\n", num_objects.contacts);
+
+	for(i = 0; i < m->count[XODBINARY_HOSTS]; i++) {
+		if(xodbinary_read_host(m, &hst[i]) != OK)
+			return ERROR;
+		}
+	for(i = 0; i < m->count[XODBINARY_HOSTS]; i++) {
+		if(xodbinary_read_host_parents(m, host_ary[i], &hst[i].parents) != OK)
+			return ERROR;
+		}
+	timing_point("%u hosts registered\n", num_objects.hosts);
+
+	for(i = 0; i < m->count[XODBINARY_SERVICES]; i++) {
+		if(xodbinary_read_service(m, &svc[i]) != OK)
+			return ERROR;
+		}
+	for(i = 0; i < m->count[XODBINARY_SERVICES]; i++) {
+		if(xodbinary_read_service_parents(m, service_ary[i], &svc[i].parents) != OK)
+			return ERROR;
+		}
+	timing_point("%u services registered\n", num_objects.services);
+
+	if(xodbinary_read_group_members(m) != OK)
+		return ERROR;
+	timing_point("Group memberships registered\n");
+
+	if(xodbinary_read_dependencies(m) != OK)
+		return ERROR;
+	timing_point("%u hostdependencies and %u servicedependencies registered\n", num_objects.hostdependencies, num_objects.servicedependencies);
+
+	if(xodbinary_read_escalations(m) != OK)
+		return ERROR;
+	timing_point("%u hostescalations and %u serviceescalations registered\n", num_objects.hostescalations, num_objects.serviceescalations);
+
+	return OK;
+	}
+
+
+/* registers all objects from a binary precache */
+int xodbinary_read_precache(const char *precache_file) {
+	xodbinary_map m;
+	struct timeval start, end;
+	struct stat st;
+	const char *problem;
+	int fd, result;
+
+	gettimeofday(&start, NULL);
+
+	memset(&m, 0, sizeof(m));
+	m.path = precache_file;
+
+	if((fd = open(precache_file, O_RDONLY)) < 0 || fstat(fd, &st) < 0) {
+		logit(NSLOG_CONFIG_ERROR, TRUE, "Error: Cannot open binary object precache '%s': %s\n", precache_file, strerror(errno));
+		if(fd >= 0)
+			close(fd);
+		return ERROR;
+		}
+	m.size = (size_t)st.st_size;
+	m.base = mmap(NULL, m.size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if(m.base == MAP_FAILED) {
+		logit(NSLOG_CONFIG_ERROR, TRUE, "Error: Cannot map binary object precache '%s': %s\n", precache_file, strerror(errno));
+		return ERROR;
+		}
+
+	if((problem = xodbinary_check_header(&m)) != NULL) {
+		logit(NSLOG_CONFIG_ERROR, TRUE, "Error: Cannot use binary object precache '%s': %s. Run Nagios with -p to recreate it.\n", precache_file, problem);
+		munmap(m.base, m.size);
+		return ERROR;
+		}
+	timing_point("Mapped binary object precache\n");
+
+	result = xodbinary_register_objects(&m);
+	if(result != OK && m.corrupt)
+		logit(NSLOG_CONFIG_ERROR, TRUE, "Error: Binary object precache '%s' is corrupt. Run Nagios with -p to recreate it.\n", precache_file);
+	else if(result != OK)
+		logit(NSLOG_CONFIG_ERROR, TRUE, "Error: Could not register objects from binary object precache '%s'\n", precache_file);
+
+	munmap(m.base, m.size);
+
+	if(test_scheduling == TRUE) {
+		gettimeofday(&end, NULL);
+		printf("Timing information on object configuration processing is listed\n");
+		printf("below.\n\n");
+		printf("Object Config Source: Binary pre-cached config file\n\n");
+		printf("OBJECT CONFIG PROCESSING TIMES\n");
+		printf("----------------------------------\n");
+		printf("Map and register:     %.6lf sec\n", tv_delta_f(&start, &end));
+		printf("\n\n");
+		}
+
+	return result;
+	}
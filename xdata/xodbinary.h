@@ -0,0 +1,222 @@
+/*****************************************************************************
+ *
+ * XODBINARY.H - Binary object precache header file
+ *
+ *
+ * License:
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ *****************************************************************************/
+
+#ifndef NAGIOS_XODBINARY_H_INCLUDED
+#define NAGIOS_XODBINARY_H_INCLUDED
+
+#include <stdint.h>
+
+/*
+ * A binary precache holds the registered objects exactly as they were
+ * after the pre-flight check, so -u can rebuild them without parsing
+ * or resolving anything. The file is a header followed by sections of
+ * fixed-size records. Strings live in one deduplicated table and are
+ * referenced by their offset in it, with 0 meaning NULL. Objects refer
+ * to each other by id, which is their index in their own section, and
+ * lists of ids (members, contacts, parents and so on) are runs in the
+ * ids section. The file is only meant to be read by the binary that
+ * wrote it, so numbers are stored in host byte order and the header
+ * carries enough to refuse anything else.
+ */
+
+#define XODBINARY_MAGIC         "NAGOBJ\0\0"
+#define XODBINARY_VERSION       1
+#define XODBINARY_BYTE_ORDER    0x01020304
+#define XODBINARY_NONE          0xffffffff  /* no object, for optional ids */
+
+/* sections, in file order */
+#define XODBINARY_STRINGS               0   /* char */
+#define XODBINARY_IDS                   1   /* uint32_t */
+#define XODBINARY_TIMERANGES            2
+#define XODBINARY_DATERANGES            3
+#define XODBINARY_CUSTOMVARS            4
+#define XODBINARY_TIMEPERIODS           5
+#define XODBINARY_COMMANDS              6
+#define XODBINARY_CONTACTGROUPS         7
+#define XODBINARY_HOSTGROUPS            8
+#define XODBINARY_SERVICEGROUPS         9
+#define XODBINARY_CONTACTS              10
+#define XODBINARY_HOSTS                 11
+#define XODBINARY_SERVICES              12
+#define XODBINARY_HOSTDEPENDENCIES      13
+#define XODBINARY_SERVICEDEPENDENCIES   14
+#define XODBINARY_HOSTESCALATIONS       15
+#define XODBINARY_SERVICEESCALATIONS    16
+#define XODBINARY_NUM_SECTIONS          17
+
+struct xodbinary_section {
+	uint64_t offset;
+	uint32_t count;
+	uint32_t rec_size;
+	};
+
+struct xodbinary_header {
+	char magic[8];
+	uint32_t version;
+	uint32_t byte_order;
+	uint32_t header_size;
+	uint32_t num_sections;
+	uint64_t file_size;
+	struct xodbinary_section section[XODBINARY_NUM_SECTIONS];
+	};
+
+/* a run of records in another section */
+struct xodbinary_list {
+	uint32_t first;
+	uint32_t count;
+	};
+
+struct xodbinary_timerange {
+	uint32_t start;
+	uint32_t end;
+	};
+
+struct xodbinary_daterange {
+	int32_t type;
+	int32_t syear, smon, smday, swday, swday_offset;
+	int32_t eyear, emon, emday, ewday, ewday_offset;
+	int32_t skip_interval;
+	struct xodbinary_list times;                /* timeranges */
+	};
+
+struct xodbinary_customvar {
+	uint32_t name;
+	uint32_t value;
+	};
+
+struct xodbinary_timeperiod {
+	uint32_t name;
+	uint32_t alias;
+	struct xodbinary_list days[7];              /* timeranges */
+	struct xodbinary_list exceptions[DATERANGE_TYPES]; /* dateranges */
+	struct xodbinary_list exclusions;           /* timeperiod ids */
+	};
+
+struct xodbinary_command {
+	uint32_t name;
+	uint32_t command_line;
+	};
+
+/* contact-, host- and servicegroups */
+struct xodbinary_group {
+	uint32_t name;
+	uint32_t alias;
+	uint32_t notes;
+	uint32_t notes_url;
+	uint32_t action_url;
+	struct xodbinary_list members;              /* contact, host or service ids */
+	};
+
+struct xodbinary_contact {
+	uint32_t name, alias, email, pager;
+	uint32_t address[MAX_CONTACT_ADDRESSES];
+	uint32_t host_notification_period;          /* timeperiod ids */
+	uint32_t service_notification_period;
+	uint32_t host_notification_options;
+	uint32_t service_notification_options;
+	uint32_t minimum_value;
+	int32_t host_notifications_enabled;
+	int32_t service_notifications_enabled;
+	int32_t can_submit_commands;
+	int32_t retain_status_information;
+	int32_t retain_nonstatus_information;
+	struct xodbinary_list host_notification_commands;    /* strings */
+	struct xodbinary_list service_notification_commands; /* strings */
+	struct xodbinary_list contactgroups;        /* contactgroup ids */
+	struct xodbinary_list custom_variables;     /* customvars */
+	};
+
+struct xodbinary_host {
+	double check_interval, retry_interval;
+	double notification_interval, first_notification_delay;
+	double low_flap_threshold, high_flap_threshold;
+	double x_3d, y_3d, z_3d;
+	uint32_t name, display_name, alias, address;
+	uint32_t check_command, event_handler;
+	uint32_t notes, notes_url, action_url;
+	uint32_t icon_image, icon_image_alt, vrml_image, statusmap_image;
+	uint32_t check_period, notification_period, event_handler_period; /* timeperiod ids */
+	int32_t initial_state, max_attempts;
+	int32_t notification_options, notifications_enabled;
+	int32_t checks_enabled, accept_passive_checks, event_handler_enabled;
+	int32_t flap_detection_enabled, flap_detection_options, stalking_options;
+	int32_t process_performance_data, check_freshness, freshness_threshold;
+	int32_t x_2d, y_2d, have_2d_coords, have_3d_coords, should_be_drawn;
+	int32_t retain_status_information, retain_nonstatus_information, obsess;
+	uint32_t hourly_value;
+	struct xodbinary_list parents;              /* host ids */
+	struct xodbinary_list contacts;             /* contact ids */
+	struct xodbinary_list contact_groups;       /* contactgroup ids */
+	struct xodbinary_list hostgroups;           /* hostgroup ids */
+	struct xodbinary_list custom_variables;     /* customvars */
+	};
+
+struct xodbinary_service {
+	double check_interval, retry_interval;
+	double notification_interval, first_notification_delay;
+	double low_flap_threshold, high_flap_threshold;
+	uint32_t host;                              /* host id */
+	uint32_t description, display_name;
+	uint32_t check_command, event_handler;
+	uint32_t notes, notes_url, action_url, icon_image, icon_image_alt;
+	uint32_t check_period, notification_period, event_handler_period; /* timeperiod ids */
+	int32_t initial_state, max_attempts, parallelize;
+	int32_t notification_options, notifications_enabled, is_volatile;
+	int32_t checks_enabled, accept_passive_checks, event_handler_enabled;
+	int32_t flap_detection_enabled, flap_detection_options, stalking_options;
+	int32_t process_performance_data, check_freshness, freshness_threshold;
+	int32_t retain_status_information, retain_nonstatus_information, obsess;
+	uint32_t hourly_value;
+	struct xodbinary_list parents;              /* service ids */
+	struct xodbinary_list contacts;             /* contact ids */
+	struct xodbinary_list contact_groups;       /* contactgroup ids */
+	struct xodbinary_list servicegroups;        /* servicegroup ids */
+	struct xodbinary_list custom_variables;     /* customvars */
+	};
+
+/* host and service dependencies */
+struct xodbinary_dependency {
+	uint32_t dependent;                         /* host or service ids */
+	uint32_t master;
+	uint32_t dependency_period;                 /* timeperiod id */
+	int32_t dependency_type;
+	int32_t inherits_parent;
+	int32_t failure_options;
+	};
+
+/* host and service escalations */
+struct xodbinary_escalation {
+	double notification_interval;
+	uint32_t object;                            /* host or service id */
+	uint32_t escalation_period;                 /* timeperiod id */
+	int32_t first_notification;
+	int32_t last_notification;
+	int32_t escalation_options;
+	struct xodbinary_list contacts;             /* contact ids */
+	struct xodbinary_list contact_groups;       /* contactgroup ids */
+	};
+
+int xodbinary_is_precache(const char *);           /* checks if a file is a binary precache */
+int xodbinary_read_precache(const char *);         /* registers all objects from a binary precache */
+int xodbinary_write_precache(const char *);        /* writes all registered objects to a binary precache */
+
+#endif
@@ -0,0 +1,544 @@
+/* C code generated from xoddir.gperf in gperf's output format */
+/* Command-line: gperf -t -H xoddir_key_phash -N xoddir_get_key xoddir.gperf  */
+/* Computed positions: -k'1,6,9,$' */
+
+#line 1 "xoddir.gperf"
+enum {
+	XODDIR_use,
+	XODDIR_name,
+	XODDIR_timeperiod_name,
+	XODDIR_alias,
+	XODDIR_exclude,
+	XODDIR_register,
+	XODDIR_command_name,
+	XODDIR_command_line,
+	XODDIR_contactgroup_name,
+	XODDIR_members,
+	XODDIR_contactgroup_members,
+	XODDIR_hostgroup_name,
+	XODDIR_hostgroup_members,
+	XODDIR_notes,
+	XODDIR_notes_url,
+	XODDIR_action_url,
+	XODDIR_servicegroup_name,
+	XODDIR_servicegroup_members,
+	XODDIR_servicegroup,
+	XODDIR_servicegroups,
+	XODDIR_hostgroup,
+	XODDIR_hostgroups,
+	XODDIR_host,
+	XODDIR_host_name,
+	XODDIR_master_host,
+	XODDIR_master_host_name,
+	XODDIR_description,
+	XODDIR_service_description,
+	XODDIR_master_description,
+	XODDIR_master_service_description,
+	XODDIR_dependent_servicegroup,
+	XODDIR_dependent_servicegroups,
+	XODDIR_dependent_servicegroup_name,
+	XODDIR_dependent_hostgroup,
+	XODDIR_dependent_hostgroups,
+	XODDIR_dependent_hostgroup_name,
+	XODDIR_dependent_host,
+	XODDIR_dependent_host_name,
+	XODDIR_dependent_description,
+	XODDIR_dependent_service_description,
+	XODDIR_dependency_period,
+	XODDIR_inherits_parent,
+	XODDIR_execution_failure_options,
+	XODDIR_execution_failure_criteria,
+	XODDIR_notification_failure_options,
+	XODDIR_notification_failure_criteria,
+	XODDIR_contact_groups,
+	XODDIR_contacts,
+	XODDIR_escalation_period,
+	XODDIR_first_notification,
+	XODDIR_last_notification,
+	XODDIR_notification_interval,
+	XODDIR_escalation_options,
+	XODDIR_contact_name,
+	XODDIR_contactgroups,
+	XODDIR_email,
+	XODDIR_pager,
+	XODDIR_host_notification_period,
+	XODDIR_host_notification_commands,
+	XODDIR_service_notification_period,
+	XODDIR_service_notification_commands,
+	XODDIR_host_notification_options,
+	XODDIR_service_notification_options,
+	XODDIR_host_notifications_enabled,
+	XODDIR_service_notifications_enabled,
+	XODDIR_can_submit_commands,
+	XODDIR_retain_status_information,
+	XODDIR_retain_nonstatus_information,
+	XODDIR_minimum_importance,
+	XODDIR_minimum_value,
+	XODDIR_display_name,
+	XODDIR_address,
+	XODDIR_parents,
+	XODDIR_host_groups,
+	XODDIR_notification_period,
+	XODDIR_check_command,
+	XODDIR_check_period,
+	XODDIR_event_handler,
+	XODDIR_event_handler_period,
+	XODDIR_failure_prediction_options,
+	XODDIR_icon_image,
+	XODDIR_icon_image_alt,
+	XODDIR_vrml_image,
+	XODDIR_gd2_image,
+	XODDIR_statusmap_image,
+	XODDIR_initial_state,
+	XODDIR_check_interval,
+	XODDIR_normal_check_interval,
+	XODDIR_retry_interval,
+	XODDIR_retry_check_interval,
+	XODDIR_importance,
+	XODDIR_hourly_value,
+	XODDIR_max_check_attempts,
+	XODDIR_checks_enabled,
+	XODDIR_active_checks_enabled,
+	XODDIR_passive_checks_enabled,
+	XODDIR_event_handler_enabled,
+	XODDIR_check_freshness,
+	XODDIR_freshness_threshold,
+	XODDIR_low_flap_threshold,
+	XODDIR_high_flap_threshold,
+	XODDIR_flap_detection_enabled,
+	XODDIR_flap_detection_options,
+	XODDIR_notification_options,
+	XODDIR_notifications_enabled,
+	XODDIR_first_notification_delay,
+	XODDIR_stalking_options,
+	XODDIR_process_perf_data,
+	XODDIR_failure_prediction_enabled,
+	XODDIR_2d_coords,
+	XODDIR_3d_coords,
+	XODDIR_obsess_over_host,
+	XODDIR_obsess,
+	XODDIR_hosts,
+	XODDIR_service_groups,
+	XODDIR_parallelize_check,
+	XODDIR_is_volatile,
+	XODDIR_obsess_over_service,
+};
+#include <string.h> /* for strcmp() */
+#line 124 "xoddir.gperf"
+struct xoddir_key {
+	const char *name;
+	int code;
+};
+
+#define TOTAL_KEYWORDS 118
+#define MIN_WORD_LENGTH 3
+#define MAX_WORD_LENGTH 29
+#define MIN_HASH_VALUE 21
+#define MAX_HASH_VALUE 415
+/* maximum key range = 395, duplicates = 0 */
+
+#ifdef __GNUC__
+__inline
+#else
+#ifdef __cplusplus
+inline
+#endif
+#endif
+static unsigned int
+xoddir_key_phash (register const char *str, register size_t len)
+{
+  static unsigned short asso_values[] =
+    {
+      416, 416, 416, 416, 416, 416, 416, 416, 416, 416,
+      416, 416, 416, 416, 416, 416, 416, 416, 416, 416,
+      416, 416, 416, 416, 416, 416, 416, 416, 416, 416,
+      416, 416, 416, 416, 416, 416, 416, 416, 416, 416,
+      416, 416, 416, 416, 416, 416, 416, 416, 416, 416,
+       92,  50, 416, 416, 416, 416, 416, 416, 416, 416,
+      416, 416, 416, 416, 416, 416, 416, 416, 416, 416,
+      416, 416, 416, 416, 416, 416, 416, 416, 416, 416,
+      416, 416, 416, 416, 416, 416, 416, 416, 416, 416,
+      416, 416, 416, 416, 416,  36, 416,  10, 416,  84,
+       36,   4,  91,  69, 109, 117, 416,  69,  85, 107,
+       13,  22, 117, 416,  10,  80,  62, 115,  16, 416,
+      416,  56, 416, 416, 416, 416, 416, 416, 416, 416,
+      416, 416, 416, 416, 416, 416, 416, 416, 416, 416,
+      416, 416, 416, 416, 416, 416, 416, 416, 416, 416,
+      416, 416, 416, 416, 416, 416, 416, 416, 416, 416,
+      416, 416, 416, 416, 416, 416, 416, 416, 416, 416,
+      416, 416, 416, 416, 416, 416, 416, 416, 416, 416,
+      416, 416, 416, 416, 416, 416, 416, 416, 416, 416,
+      416, 416, 416, 416, 416, 416, 416, 416, 416, 416,
+      416, 416, 416, 416, 416, 416, 416, 416, 416, 416,
+      416, 416, 416, 416, 416, 416, 416, 416, 416, 416,
+      416, 416, 416, 416, 416, 416, 416, 416, 416, 416,
+      416, 416, 416, 416, 416, 416, 416, 416, 416, 416,
+      416, 416, 416, 416, 416, 416, 416, 416, 416, 416,
+      416, 416, 416, 416, 416, 416
+    };
+  register unsigned int hval = len;
+
+  switch (hval)
+    {
+      default:
+        hval += asso_values[(unsigned char)str[8]];
+      /*FALLTHROUGH*/
+      case 8:
+      case 7:
+      case 6:
+        hval += asso_values[(unsigned char)str[5]];
+      /*FALLTHROUGH*/
+      case 5:
+      case 4:
+      case 3:
+        hval += asso_values[(unsigned char)str[0]];
+        break;
+    }
+  return hval + asso_values[(unsigned char)str[len - 1]];
+}
+
+struct xoddir_key *
+xoddir_get_key (register const char *str, register size_t len)
+{
+  static struct xoddir_key wordlist[] =
+    {
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""},
+#line 130 "xoddir.gperf"
+      {"name", XODDIR_name},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""},
+#line 133 "xoddir.gperf"
+      {"exclude", XODDIR_exclude},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""},
+#line 199 "xoddir.gperf"
+      {"display_name", XODDIR_display_name},
+#line 206 "xoddir.gperf"
+      {"event_handler", XODDIR_event_handler},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""},
+#line 196 "xoddir.gperf"
+      {"retain_nonstatus_information", XODDIR_retain_nonstatus_information},
+      {""}, {""},
+#line 177 "xoddir.gperf"
+      {"escalation_period", XODDIR_escalation_period},
+#line 134 "xoddir.gperf"
+      {"register", XODDIR_register},
+      {""}, {""}, {""},
+#line 184 "xoddir.gperf"
+      {"email", XODDIR_email},
+#line 132 "xoddir.gperf"
+      {"alias", XODDIR_alias},
+      {""}, {""},
+#line 142 "xoddir.gperf"
+      {"notes", XODDIR_notes},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+#line 131 "xoddir.gperf"
+      {"timeperiod_name", XODDIR_timeperiod_name},
+      {""},
+#line 207 "xoddir.gperf"
+      {"event_handler_period", XODDIR_event_handler_period},
+#line 225 "xoddir.gperf"
+      {"event_handler_enabled", XODDIR_event_handler_enabled},
+      {""}, {""}, {""}, {""},
+#line 172 "xoddir.gperf"
+      {"execution_failure_criteria", XODDIR_execution_failure_criteria},
+      {""}, {""}, {""}, {""}, {""}, {""},
+#line 129 "xoddir.gperf"
+      {"use", XODDIR_use},
+#line 195 "xoddir.gperf"
+      {"retain_status_information", XODDIR_retain_status_information},
+      {""}, {""},
+#line 135 "xoddir.gperf"
+      {"command_name", XODDIR_command_name},
+      {""},
+#line 144 "xoddir.gperf"
+      {"action_url", XODDIR_action_url},
+      {""}, {""}, {""},
+#line 185 "xoddir.gperf"
+      {"pager", XODDIR_pager},
+      {""},
+#line 181 "xoddir.gperf"
+      {"escalation_options", XODDIR_escalation_options},
+      {""}, {""}, {""}, {""},
+#line 152 "xoddir.gperf"
+      {"host_name", XODDIR_host_name},
+      {""},
+#line 246 "xoddir.gperf"
+      {"obsess_over_service", XODDIR_obsess_over_service},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""},
+#line 157 "xoddir.gperf"
+      {"master_description", XODDIR_master_description},
+      {""}, {""},
+#line 218 "xoddir.gperf"
+      {"retry_check_interval", XODDIR_retry_check_interval},
+      {""},
+#line 166 "xoddir.gperf"
+      {"dependent_host_name", XODDIR_dependent_host_name},
+      {""},
+#line 154 "xoddir.gperf"
+      {"master_host_name", XODDIR_master_host_name},
+#line 158 "xoddir.gperf"
+      {"master_service_description", XODDIR_master_service_description},
+      {""},
+#line 164 "xoddir.gperf"
+      {"dependent_hostgroup_name", XODDIR_dependent_hostgroup_name},
+      {""}, {""},
+#line 161 "xoddir.gperf"
+      {"dependent_servicegroup_name", XODDIR_dependent_servicegroup_name},
+      {""}, {""},
+#line 167 "xoddir.gperf"
+      {"dependent_description", XODDIR_dependent_description},
+      {""}, {""}, {""}, {""}, {""}, {""},
+#line 151 "xoddir.gperf"
+      {"host", XODDIR_host},
+#line 168 "xoddir.gperf"
+      {"dependent_service_description", XODDIR_dependent_service_description},
+#line 200 "xoddir.gperf"
+      {"address", XODDIR_address},
+#line 205 "xoddir.gperf"
+      {"check_period", XODDIR_check_period},
+      {""},
+#line 223 "xoddir.gperf"
+      {"active_checks_enabled", XODDIR_active_checks_enabled},
+      {""}, {""}, {""},
+#line 171 "xoddir.gperf"
+      {"execution_failure_options", XODDIR_execution_failure_options},
+      {""}, {""}, {""},
+#line 241 "xoddir.gperf"
+      {"obsess", XODDIR_obsess},
+#line 230 "xoddir.gperf"
+      {"flap_detection_enabled", XODDIR_flap_detection_enabled},
+      {""},
+#line 220 "xoddir.gperf"
+      {"hourly_value", XODDIR_hourly_value},
+      {""},
+#line 212 "xoddir.gperf"
+      {"gd2_image", XODDIR_gd2_image},
+#line 242 "xoddir.gperf"
+      {"hosts", XODDIR_hosts},
+#line 145 "xoddir.gperf"
+      {"servicegroup_name", XODDIR_servicegroup_name},
+#line 240 "xoddir.gperf"
+      {"obsess_over_host", XODDIR_obsess_over_host},
+#line 182 "xoddir.gperf"
+      {"contact_name", XODDIR_contact_name},
+#line 136 "xoddir.gperf"
+      {"command_line", XODDIR_command_line},
+#line 137 "xoddir.gperf"
+      {"contactgroup_name", XODDIR_contactgroup_name},
+      {""}, {""}, {""}, {""},
+#line 138 "xoddir.gperf"
+      {"members", XODDIR_members},
+      {""}, {""},
+#line 217 "xoddir.gperf"
+      {"retry_interval", XODDIR_retry_interval},
+      {""},
+#line 169 "xoddir.gperf"
+      {"dependency_period", XODDIR_dependency_period},
+#line 165 "xoddir.gperf"
+      {"dependent_host", XODDIR_dependent_host},
+      {""},
+#line 153 "xoddir.gperf"
+      {"master_host", XODDIR_master_host},
+      {""}, {""}, {""},
+#line 211 "xoddir.gperf"
+      {"vrml_image", XODDIR_vrml_image},
+      {""}, {""},
+#line 226 "xoddir.gperf"
+      {"check_freshness", XODDIR_check_freshness},
+#line 178 "xoddir.gperf"
+      {"first_notification", XODDIR_first_notification},
+      {""}, {""}, {""},
+#line 214 "xoddir.gperf"
+      {"initial_state", XODDIR_initial_state},
+      {""}, {""},
+#line 222 "xoddir.gperf"
+      {"checks_enabled", XODDIR_checks_enabled},
+#line 143 "xoddir.gperf"
+      {"notes_url", XODDIR_notes_url},
+      {""}, {""},
+#line 174 "xoddir.gperf"
+      {"notification_failure_criteria", XODDIR_notification_failure_criteria},
+#line 156 "xoddir.gperf"
+      {"service_description", XODDIR_service_description},
+#line 231 "xoddir.gperf"
+      {"flap_detection_options", XODDIR_flap_detection_options},
+#line 163 "xoddir.gperf"
+      {"dependent_hostgroups", XODDIR_dependent_hostgroups},
+      {""}, {""},
+#line 160 "xoddir.gperf"
+      {"dependent_servicegroups", XODDIR_dependent_servicegroups},
+      {""},
+#line 227 "xoddir.gperf"
+      {"freshness_threshold", XODDIR_freshness_threshold},
+#line 188 "xoddir.gperf"
+      {"service_notification_period", XODDIR_service_notification_period},
+#line 239 "xoddir.gperf"
+      {"3d_coords", XODDIR_3d_coords},
+#line 193 "xoddir.gperf"
+      {"service_notifications_enabled", XODDIR_service_notifications_enabled},
+      {""}, {""},
+#line 179 "xoddir.gperf"
+      {"last_notification", XODDIR_last_notification},
+      {""},
+#line 203 "xoddir.gperf"
+      {"notification_period", XODDIR_notification_period},
+      {""},
+#line 233 "xoddir.gperf"
+      {"notifications_enabled", XODDIR_notifications_enabled},
+      {""}, {""}, {""}, {""},
+#line 140 "xoddir.gperf"
+      {"hostgroup_name", XODDIR_hostgroup_name},
+#line 198 "xoddir.gperf"
+      {"minimum_value", XODDIR_minimum_value},
+#line 176 "xoddir.gperf"
+      {"contacts", XODDIR_contacts},
+      {""}, {""}, {""},
+#line 228 "xoddir.gperf"
+      {"low_flap_threshold", XODDIR_low_flap_threshold},
+      {""}, {""}, {""}, {""}, {""},
+#line 201 "xoddir.gperf"
+      {"parents", XODDIR_parents},
+#line 148 "xoddir.gperf"
+      {"servicegroups", XODDIR_servicegroups},
+      {""},
+#line 234 "xoddir.gperf"
+      {"first_notification_delay", XODDIR_first_notification_delay},
+#line 162 "xoddir.gperf"
+      {"dependent_hostgroup", XODDIR_dependent_hostgroup},
+#line 183 "xoddir.gperf"
+      {"contactgroups", XODDIR_contactgroups},
+      {""},
+#line 159 "xoddir.gperf"
+      {"dependent_servicegroup", XODDIR_dependent_servicegroup},
+#line 146 "xoddir.gperf"
+      {"servicegroup_members", XODDIR_servicegroup_members},
+#line 224 "xoddir.gperf"
+      {"passive_checks_enabled", XODDIR_passive_checks_enabled},
+#line 204 "xoddir.gperf"
+      {"check_command", XODDIR_check_command},
+#line 219 "xoddir.gperf"
+      {"importance", XODDIR_importance},
+#line 139 "xoddir.gperf"
+      {"contactgroup_members", XODDIR_contactgroup_members},
+      {""},
+#line 237 "xoddir.gperf"
+      {"failure_prediction_enabled", XODDIR_failure_prediction_enabled},
+#line 215 "xoddir.gperf"
+      {"check_interval", XODDIR_check_interval},
+      {""},
+#line 238 "xoddir.gperf"
+      {"2d_coords", XODDIR_2d_coords},
+      {""},
+#line 191 "xoddir.gperf"
+      {"service_notification_options", XODDIR_service_notification_options},
+#line 189 "xoddir.gperf"
+      {"service_notification_commands", XODDIR_service_notification_commands},
+      {""}, {""}, {""}, {""}, {""},
+#line 232 "xoddir.gperf"
+      {"notification_options", XODDIR_notification_options},
+      {""},
+#line 155 "xoddir.gperf"
+      {"description", XODDIR_description},
+      {""},
+#line 213 "xoddir.gperf"
+      {"statusmap_image", XODDIR_statusmap_image},
+      {""},
+#line 180 "xoddir.gperf"
+      {"notification_interval", XODDIR_notification_interval},
+#line 186 "xoddir.gperf"
+      {"host_notification_period", XODDIR_host_notification_period},
+#line 173 "xoddir.gperf"
+      {"notification_failure_options", XODDIR_notification_failure_options},
+#line 192 "xoddir.gperf"
+      {"host_notifications_enabled", XODDIR_host_notifications_enabled},
+      {""},
+#line 147 "xoddir.gperf"
+      {"servicegroup", XODDIR_servicegroup},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""},
+#line 216 "xoddir.gperf"
+      {"normal_check_interval", XODDIR_normal_check_interval},
+      {""}, {""}, {""},
+#line 209 "xoddir.gperf"
+      {"icon_image", XODDIR_icon_image},
+      {""}, {""}, {""}, {""}, {""}, {""},
+#line 208 "xoddir.gperf"
+      {"failure_prediction_options", XODDIR_failure_prediction_options},
+      {""},
+#line 150 "xoddir.gperf"
+      {"hostgroups", XODDIR_hostgroups},
+#line 243 "xoddir.gperf"
+      {"service_groups", XODDIR_service_groups},
+      {""},
+#line 235 "xoddir.gperf"
+      {"stalking_options", XODDIR_stalking_options},
+      {""},
+#line 175 "xoddir.gperf"
+      {"contact_groups", XODDIR_contact_groups},
+      {""},
+#line 141 "xoddir.gperf"
+      {"hostgroup_members", XODDIR_hostgroup_members},
+#line 245 "xoddir.gperf"
+      {"is_volatile", XODDIR_is_volatile},
+      {""}, {""}, {""}, {""}, {""}, {""},
+#line 236 "xoddir.gperf"
+      {"process_perf_data", XODDIR_process_perf_data},
+      {""}, {""},
+#line 190 "xoddir.gperf"
+      {"host_notification_options", XODDIR_host_notification_options},
+#line 187 "xoddir.gperf"
+      {"host_notification_commands", XODDIR_host_notification_commands},
+      {""},
+#line 170 "xoddir.gperf"
+      {"inherits_parent", XODDIR_inherits_parent},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""},
+#line 197 "xoddir.gperf"
+      {"minimum_importance", XODDIR_minimum_importance},
+#line 149 "xoddir.gperf"
+      {"hostgroup", XODDIR_hostgroup},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""},
+#line 229 "xoddir.gperf"
+      {"high_flap_threshold", XODDIR_high_flap_threshold},
+      {""}, {""}, {""}, {""}, {""}, {""},
+#line 210 "xoddir.gperf"
+      {"icon_image_alt", XODDIR_icon_image_alt},
+      {""}, {""}, {""},
+#line 221 "xoddir.gperf"
+      {"max_check_attempts", XODDIR_max_check_attempts},
+#line 202 "xoddir.gperf"
+      {"host_groups", XODDIR_host_groups},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""}, {""}, {""}, {""},
+#line 244 "xoddir.gperf"
+      {"parallelize_check", XODDIR_parallelize_check},
+      {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""},
+      {""},
+#line 194 "xoddir.gperf"
+      {"can_submit_commands", XODDIR_can_submit_commands}
+    };
+
+  if (len <= MAX_WORD_LENGTH && len >= MIN_WORD_LENGTH)
+    {
+      register unsigned int key = xoddir_key_phash (str, len);
+
+      if (key <= MAX_HASH_VALUE)
+        {
+          register const char *s = wordlist[key].name;
+
+          if (*str == *s && !strcmp (str + 1, s + 1))
+            return &wordlist[key];
+        }
+    }
+  return 0;
+}
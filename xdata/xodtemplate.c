@@ -55,6 +55,8 @@
 
 #ifdef NSCORE
 #include "../include/nagios.h"
+#include <pthread.h>
+#include "xodbinary.h"
 #endif
 
 #ifdef NSCGI
@@ -64,6 +66,7 @@
 /**** DATA INPUT-SPECIFIC HEADER FILES ****/
 
 #include "xodtemplate.h"
+#include "xoddir-phash.h"
 
 #define XOD_NEW   0 /* not seen */
 #define XOD_SEEN  1 /* seen, but not yet loopy */
@@ -116,6 +119,34 @@ int presorted_objects = FALSE;
 /* xodtemplate id / object counter */
 static struct object_count xodcount;
 
+#ifdef NSCORE
+/* shared between the tokenizer threads and the thread building objects */
+static struct {
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	xodtemplate_staged_list *list;
+	unsigned int next;      /* next file to tokenize */
+	unsigned int built;     /* files we're done building objects from */
+	unsigned int window;    /* max files tokenized ahead of the builder */
+	int abort;
+	double tokenize_time;
+	} xodstage;
+
+/* timing information for test_scheduling */
+static struct {
+	unsigned int files;
+	unsigned int threads;
+	double tokenize;        /* time spent tokenizing, summed over all threads */
+	double build;           /* time spent building objects */
+	double stall;           /* time the builder spent waiting for tokenizers */
+	int depth;              /* included files are processed while building */
+	} xodstage_timing;
+#endif
+
+static xodtemplate_staged_file *xodtemplate_stage_entry(xodtemplate_staged_list *, int, const char *);
+static int xodtemplate_stage_config_dir(xodtemplate_staged_list *, const char *);
+static int xodtemplate_process_staged_files(xodtemplate_staged_list *, int, int);
+
 /* reusable bitmaps for expanding objects */
 static bitmap *host_map = NULL, *contact_map = NULL;
 static bitmap *service_map = NULL, *parent_map = NULL;
@@ -193,6 +224,8 @@ int xodtemplate_read_config_data(const char *main_config_file, int options) {
 	char *val = NULL;
 	double runtime[11];
 	mmapfile *thefile = NULL;
+	xodtemplate_staged_list list = { NULL, 0, 0 };
+	int threads = 1;
 #endif
 	struct timeval tv[12];
 	int result = OK;
@@ -205,6 +238,12 @@ int xodtemplate_read_config_data(const char *main_config_file, int options) {
 		return ERROR;
 		}
 
+#ifdef NSCORE
+	/* binary precaches register their objects directly */
+	if(use_precached_objects == TRUE && xodbinary_is_precache(object_precache_file) == TRUE)
+		return xodbinary_read_precache(object_precache_file);
+#endif
+
 	timing_point("Reading config data from '%s'\n", main_config_file);
 
 	/* initialize variables */
@@ -246,6 +285,8 @@ int xodtemplate_read_config_data(const char *main_config_file, int options) {
 #endif
 
 #ifdef NSCORE
+	memset(&xodstage_timing, 0, sizeof(xodstage_timing));
+
 	if(test_scheduling == TRUE)
 		gettimeofday(&tv[0], NULL);
 
@@ -305,12 +346,13 @@ int xodtemplate_read_config_data(const char *main_config_file, int options) {
 				else
 					cfgfile = strdup(val);
 
-				/* process the config file... */
-				result = xodtemplate_process_config_file(cfgfile, options);
+				/* stage the config file... */
+				if(xodtemplate_stage_entry(&list, XODTEMPLATE_STAGED_FILE, cfgfile) == NULL)
+					result = ERROR;
 
 				my_free(cfgfile);
 
-				/* if there was an error processing the config file, break out of loop */
+				/* if there was an error staging the config file, break out of loop */
 				if(result == ERROR)
 					break;
 				}
@@ -328,12 +370,12 @@ int xodtemplate_read_config_data(const char *main_config_file, int options) {
 				if(cfgfile != NULL && cfgfile[strlen(cfgfile) - 1] == '/')
 					cfgfile[strlen(cfgfile) - 1] = '\x0';
 
-				/* process the config directory... */
-				result = xodtemplate_process_config_dir(cfgfile, options);
+				/* stage all files in the config directory... */
+				result = xodtemplate_stage_config_dir(&list, cfgfile);
 
 				my_free(cfgfile);
 
-				/* if there was an error processing the config file, break out of loop */
+				/* if there was an error staging the config directory, break out of loop */
 				if(result == ERROR)
 					break;
 				}
@@ -343,6 +385,20 @@ int xodtemplate_read_config_data(const char *main_config_file, int options) {
 		my_free(config_base_dir);
 		my_free(input);
 		mmap_fclose(thefile);
+
+		/* tokenize files in parallel, but build objects from them in order */
+		threads = object_config_threads;
+		if(threads <= 0) {
+			threads = online_cpus();
+			if(threads > XODTEMPLATE_MAX_AUTO_THREADS)
+				threads = XODTEMPLATE_MAX_AUTO_THREADS;
+			}
+		if((unsigned int)threads > list.num_files)
+			threads = list.num_files;
+
+		/* errors while staging are reported once we get to them */
+		if(xodtemplate_process_staged_files(&list, options, threads) == ERROR)
+			result = ERROR;
 		}
 
 	if(test_scheduling == TRUE)
@@ -488,6 +544,9 @@ int xodtemplate_read_config_data(const char *main_config_file, int options) {
 		printf("OBJECT CONFIG PROCESSING TIMES      (* = Potential for precache savings with -u option)\n");
 		printf("----------------------------------\n");
 		printf("Read:                 %.6lf sec\n", runtime[0]);
+		printf("  Tokenize:           %.6lf sec  (%u files, %u thread%s, summed over threads)\n", xodstage_timing.tokenize, xodstage_timing.files, xodstage_timing.threads, xodstage_timing.threads == 1 ? "" : "s");
+		printf("  Build:              %.6lf sec\n", xodstage_timing.build);
+		printf("  Build stalled:      %.6lf sec\n", xodstage_timing.stall);
 		printf("Resolve:              %.6lf sec  *\n", runtime[1]);
 		printf("Recomb Contactgroups: %.6lf sec  *\n", runtime[2]);
 		printf("Recomb Hostgroups:    %.6lf sec  *\n", runtime[3]);
@@ -560,8 +619,36 @@ void xodtemplate_handle_semicolons(char* input) {
 }
 
 
-/* process all files in a specific config directory */
-int xodtemplate_process_config_dir(const char *dirname, int options) {
+/* adds an entry to a list of staged config files */
+static xodtemplate_staged_file *xodtemplate_stage_entry(xodtemplate_staged_list *list, int type, const char *filename) {
+	xodtemplate_staged_file *sf = NULL;
+
+	if(list->num_files == list->max_files) {
+		unsigned int max_files = list->max_files ? list->max_files * 2 : 256;
+		xodtemplate_staged_file *files = (xodtemplate_staged_file *)realloc(list->files, max_files * sizeof(*files));
+		if(files == NULL)
+			return NULL;
+		list->files = files;
+		list->max_files = max_files;
+		}
+
+	sf = &list->files[list->num_files];
+	memset(sf, 0, sizeof(*sf));
+	if((sf->filename = (char *)strdup(filename)) == NULL)
+		return NULL;
+	sf->type = type;
+
+	/* only files have anything to tokenize */
+	sf->ready = (type == XODTEMPLATE_STAGED_FILE) ? FALSE : TRUE;
+
+	list->num_files++;
+
+	return sf;
+	}
+
+
+/* finds all config files in a directory, in the order they'll be processed */
+static int xodtemplate_stage_config_dir(xodtemplate_staged_list *list, const char *dirname) {
 	char file[MAX_FILENAME_LENGTH];
 	DIR *dirp = NULL;
 	struct dirent *dirfile = NULL;
@@ -570,15 +657,13 @@ int xodtemplate_process_config_dir(const char *dirname, int options) {
 	struct stat stat_buf;
 	int ofs = 0;
 
-#ifdef NSCORE
-	if(verify_config >= 2)
-		printf("Processing object config directory '%s'...\n", dirname);
-#endif
+	if(xodtemplate_stage_entry(list, XODTEMPLATE_STAGED_DIR, dirname) == NULL)
+		return ERROR;
 
 	/* open the directory for reading */
 	dirp = opendir(dirname);
 	if(dirp == NULL) {
-		logit(NSLOG_CONFIG_ERROR, TRUE, "Error: Could not open config directory '%s' for reading.\n", dirname);
+		xodtemplate_stage_entry(list, XODTEMPLATE_STAGED_DIR_ERROR, dirname);
 		return ERROR;
 		}
 
@@ -587,7 +672,7 @@ int xodtemplate_process_config_dir(const char *dirname, int options) {
 	ensure_path_separator(file, sizeof(file));
 	ofs = strlen(file);
 
-	/* process all files in the directory... */
+	/* stage all files in the directory... */
 	while((dirfile = readdir(dirp)) != NULL) {
 
 		/* skip hidden files and directories, and current and parent dir */
@@ -601,9 +686,9 @@ int xodtemplate_process_config_dir(const char *dirname, int options) {
 		/* create /path/to/file */
 		strncpy(file + ofs, dirfile->d_name, sizeof(file) - ofs);
 
-		/* process this if it's a non-hidden config file... */
+		/* stage this if it's a non-hidden config file... */
 		if(stat(file, &stat_buf) == -1) {
-			logit(NSLOG_RUNTIME_ERROR, TRUE, "Error: Could not open config directory member '%s' for reading.\n", file);
+			xodtemplate_stage_entry(list, XODTEMPLATE_STAGED_MEMBER_ERROR, file);
 			closedir(dirp);
 			return ERROR;
 			}
@@ -615,10 +700,7 @@ int xodtemplate_process_config_dir(const char *dirname, int options) {
 				if(x <= 4 || strcmp(dirfile->d_name + (x - 4), ".cfg"))
 					break;
 
-				/* process the config file */
-				result = xodtemplate_process_config_file(file, options);
-
-				if(result == ERROR) {
+				if(xodtemplate_stage_entry(list, XODTEMPLATE_STAGED_FILE, file) == NULL) {
 					closedir(dirp);
 					return ERROR;
 					}
@@ -627,7 +709,7 @@ int xodtemplate_process_config_dir(const char *dirname, int options) {
 
 			case S_IFDIR:
 				/* recurse into subdirectories... */
-				result = xodtemplate_process_config_dir(file, options);
+				result = xodtemplate_stage_config_dir(list, file);
 
 				if(result == ERROR) {
 					closedir(dirp);
@@ -648,41 +730,73 @@ int xodtemplate_process_config_dir(const char *dirname, int options) {
 	}
 
 
-/* process data in a specific config file */
-int xodtemplate_process_config_file(const char *filename, int options) {
+/* adds a tokenized line to a staged config file */
+static int xodtemplate_stage_line(xodtemplate_staged_file *sf, int type, int line, const char *text) {
+	size_t len = text ? strlen(text) + 1 : 1;
+
+	if(sf->num_lines == sf->max_lines) {
+		unsigned int max_lines = sf->max_lines ? sf->max_lines * 2 : 256;
+		xodtemplate_staged_line *lines = (xodtemplate_staged_line *)realloc(sf->lines, max_lines * sizeof(*lines));
+		if(lines == NULL)
+			return ERROR;
+		sf->lines = lines;
+		sf->max_lines = max_lines;
+		}
+
+	if(sf->buf_len + len > sf->buf_size) {
+		size_t buf_size = sf->buf_size * 2 > sf->buf_len + len ? sf->buf_size * 2 : sf->buf_len + len + 4096;
+		char *buf = (char *)realloc(sf->buf, buf_size);
+		if(buf == NULL)
+			return ERROR;
+		sf->buf = buf;
+		sf->buf_size = buf_size;
+		}
+
+	sf->lines[sf->num_lines].type = type;
+	sf->lines[sf->num_lines].line = line;
+	sf->lines[sf->num_lines].text = sf->buf_len;
+	sf->num_lines++;
+	if(text)
+		memcpy(sf->buf + sf->buf_len, text, len);
+	else
+		sf->buf[sf->buf_len] = '\x0';
+	sf->buf_len += len;
+
+	return OK;
+	}
+
+
+/*
+ * reads and tokenizes a config file without touching any objects or
+ * global state, so several files can be tokenized at once. Errors are
+ * staged along with everything else and only logged when objects are
+ * built from the file, so they show up in the same order as always.
+ */
+static int xodtemplate_tokenize_config_file(xodtemplate_staged_file *sf) {
 	mmapfile *thefile = NULL;
 	char *input = NULL;
 	register int in_definition = FALSE;
 	register int current_line = 0;
 	int result = OK;
+	int type = 0;
 	register int x = 0;
 	register int y = 0;
 	char *ptr = NULL;
 
-
-#ifdef NSCORE
-	if(verify_config >= 2)
-		printf("Processing object config file '%s'...\n", filename);
-#endif
-
-	/* save config file name */
-	xodtemplate_config_files[xodtemplate_current_config_file++] = (char *)strdup(filename);
-
-	/* reallocate memory for config files */
-	if(!(xodtemplate_current_config_file % 256)) {
-		xodtemplate_config_files = (char **)realloc(xodtemplate_config_files, (xodtemplate_current_config_file + 256) * sizeof(char *));
-		if(xodtemplate_config_files == NULL)
-			return ERROR;
-		}
-
 	/* open the config file for reading */
-	if((thefile = mmap_fopen(filename)) == NULL) {
-		logit(NSLOG_CONFIG_ERROR, TRUE, "Error: Cannot open config file '%s' for reading: %s\n", filename, strerror(errno));
+	if((thefile = mmap_fopen(sf->filename)) == NULL) {
+		sf->error = errno;
+		if(xodtemplate_stage_line(sf, XODTEMPLATE_LINE_NO_FILE, 0, NULL) == ERROR)
+			sf->error = ENOMEM;
 		return ERROR;
 		}
 
+	/* lines only ever shrink, so the file size is a good first guess */
+	if((sf->buf = (char *)malloc(thefile->file_size + 1)) != NULL)
+		sf->buf_size = thefile->file_size + 1;
+
 	/* read in all lines from the config file */
-	while(1) {
+	while(result == OK) {
 
 		/* free memory */
 		my_free(input);
@@ -720,8 +834,7 @@ int xodtemplate_process_config_file(const char *filename, int options) {
 
 			/* make sure an object type is specified... */
 			if(input[0] == '\x0') {
-				logit(NSLOG_CONFIG_ERROR, TRUE, "Error: No object type specified in file '%s' on line %d.\n", filename, current_line);
-				result = ERROR;
+				type = XODTEMPLATE_LINE_NO_TYPE;
 				break;
 				}
 
@@ -743,27 +856,22 @@ int xodtemplate_process_config_file(const char *filename, int options) {
 				if (   strcmp(input, "hostextinfo") 
 				    && strcmp(input, "serviceextinfo")) {
 
-					logit(NSLOG_CONFIG_ERROR, TRUE, "Error: Invalid object definition type '%s' in file '%s' on line %d.\n", input, filename, current_line);
-					result = ERROR;
+					type = XODTEMPLATE_LINE_BAD_TYPE;
 					break;
 				}
 
-				logit(NSLOG_CONFIG_WARNING, TRUE, "WARNING: Extinfo objects are deprecated and will be removed in future versions\n");
+				result = xodtemplate_stage_line(sf, XODTEMPLATE_LINE_EXTINFO, current_line, NULL);
 			}
 
 			/* we're already in an object definition... */
 			if(in_definition == TRUE) {
-				logit(NSLOG_CONFIG_ERROR, TRUE, "Error: Unexpected start of object definition in file '%s' on line %d.  Make sure you close preceding objects before starting a new one.\n", filename, current_line);
-				result = ERROR;
+				type = XODTEMPLATE_LINE_NESTED;
 				break;
 				}
 
 			/* start a new definition */
-			if(xodtemplate_begin_object_definition(input, options, xodtemplate_current_config_file, current_line) == ERROR) {
-				logit(NSLOG_CONFIG_ERROR, TRUE, "Error: Could not add object definition in file '%s' on line %d.\n", filename, current_line);
-				result = ERROR;
-				break;
-				}
+			if(result == OK)
+				result = xodtemplate_stage_line(sf, XODTEMPLATE_LINE_BEGIN, current_line, input);
 
 			in_definition = TRUE;
 			}
@@ -773,77 +881,357 @@ int xodtemplate_process_config_file(const char *filename, int options) {
 
 			/* this is the close of an object definition */
 			if(!strcmp(input, "}")) {
-
 				in_definition = FALSE;
-
-				/* close out current definition */
-				if(xodtemplate_end_object_definition(options) == ERROR) {
-					logit(NSLOG_CONFIG_ERROR, TRUE, "Error: Could not complete object definition in file '%s' on line %d. Have you named all your objects?\n", filename, current_line);
-					result = ERROR;
-					break;
-					}
+				result = xodtemplate_stage_line(sf, XODTEMPLATE_LINE_END, current_line, NULL);
 				}
 
 			/* this is a directive inside an object definition */
-			else {
-
-				/* add directive to object definition */
-				if(xodtemplate_add_object_property(input, options) == ERROR) {
-					logit(NSLOG_CONFIG_ERROR, TRUE, "Error: Could not add object property in file '%s' on line %d.\n", filename, current_line);
-					result = ERROR;
-					break;
-					}
-				}
+			else
+				result = xodtemplate_stage_line(sf, XODTEMPLATE_LINE_PROPERTY, current_line, input);
 			}
 
 		/* include another file */
 		else if(strstr(input, "include_file=") == input) {
 
-			ptr = strtok(input, "=");
-			ptr = strtok(NULL, "\n");
+			/* files are tokenized on several threads, so no strtok() here */
+			ptr = strchr(input, '=') + 1;
 
-			if(ptr != NULL) {
-				result = xodtemplate_process_config_file(ptr, options);
-				if(result == ERROR)
-					break;
-				}
+			if(*ptr != '\x0')
+				result = xodtemplate_stage_line(sf, XODTEMPLATE_LINE_INCLUDE_FILE, current_line, ptr);
 			}
 
 		/* include a directory */
 		else if(strstr(input, "include_dir") == input) {
 
-			ptr = strtok(input, "=");
-			ptr = strtok(NULL, "\n");
-
-			if(ptr != NULL) {
-				result = xodtemplate_process_config_dir(ptr, options);
-				if(result == ERROR)
-					break;
-				}
+			if((ptr = strchr(input, '=')) != NULL && *(++ptr) != '\x0')
+				result = xodtemplate_stage_line(sf, XODTEMPLATE_LINE_INCLUDE_DIR, current_line, ptr);
 			}
 
 		/* unexpected token or statement */
 		else {
-			logit(NSLOG_CONFIG_ERROR, TRUE, "Error: Unexpected token or statement in file '%s' on line %d.\n", filename, current_line);
-			result = ERROR;
+			type = XODTEMPLATE_LINE_UNEXPECTED;
 			break;
 			}
 		}
 
+	/* whoops - EOF while we were in the middle of an object definition... */
+	if(type == 0 && in_definition == TRUE)
+		type = XODTEMPLATE_LINE_EOF;
+
+	if(type != 0 && result == OK)
+		result = xodtemplate_stage_line(sf, type, current_line, input);
+
+	if(result == ERROR)
+		sf->error = ENOMEM;
+
 	/* free memory and close file */
 	my_free(input);
 	mmap_fclose(thefile);
 
-	/* whoops - EOF while we were in the middle of an object definition... */
-	if(in_definition == TRUE && result == OK) {
-		logit(NSLOG_CONFIG_ERROR, TRUE, "Error: Unexpected EOF in file '%s' on line %d - check for a missing closing bracket.\n", filename, current_line);
-		result = ERROR;
+	return type == 0 ? result : ERROR;
+	}
+
+
+/* frees a staged config file once it's no longer needed */
+static void xodtemplate_free_staged_file(xodtemplate_staged_file *sf) {
+
+	my_free(sf->filename);
+	my_free(sf->buf);
+	my_free(sf->lines);
+	sf->buf_len = sf->buf_size = 0;
+	sf->num_lines = sf->max_lines = 0;
+	}
+
+
+/* adds objects from a tokenized config file, in the order they're defined */
+static int xodtemplate_build_config_file(xodtemplate_staged_file *sf, int options) {
+	xodtemplate_staged_line *line = NULL;
+	const char *filename = sf->filename;
+	char *text = NULL;
+	unsigned int i;
+
+	switch(sf->type) {
+
+		case XODTEMPLATE_STAGED_DIR:
+#ifdef NSCORE
+			if(verify_config >= 2)
+				printf("Processing object config directory '%s'...\n", filename);
+#endif
+			return OK;
+
+		case XODTEMPLATE_STAGED_DIR_ERROR:
+			logit(NSLOG_CONFIG_ERROR, TRUE, "Error: Could not open config directory '%s' for reading.\n", filename);
+			return ERROR;
+
+		case XODTEMPLATE_STAGED_MEMBER_ERROR:
+			logit(NSLOG_RUNTIME_ERROR, TRUE, "Error: Could not open config directory member '%s' for reading.\n", filename);
+			return ERROR;
+		}
+
+#ifdef NSCORE
+	if(verify_config >= 2)
+		printf("Processing object config file '%s'...\n", filename);
+#endif
+
+	/* save config file name */
+	xodtemplate_config_files[xodtemplate_current_config_file++] = (char *)strdup(filename);
+
+	/* reallocate memory for config files */
+	if(!(xodtemplate_current_config_file % 256)) {
+		xodtemplate_config_files = (char **)realloc(xodtemplate_config_files, (xodtemplate_current_config_file + 256) * sizeof(char *));
+		if(xodtemplate_config_files == NULL)
+			return ERROR;
+		}
+
+	if(sf->error == ENOMEM) {
+		logit(NSLOG_CONFIG_ERROR, TRUE, "Error: Unable to allocate memory for reading config file '%s'.\n", filename);
+		return ERROR;
+		}
+
+	for(i = 0; i < sf->num_lines; i++) {
+		line = &sf->lines[i];
+		text = sf->buf + line->text;
+
+		switch(line->type) {
+
+			case XODTEMPLATE_LINE_BEGIN:
+				if(xodtemplate_begin_object_definition(text, options, xodtemplate_current_config_file, line->line) == ERROR) {
+					logit(NSLOG_CONFIG_ERROR, TRUE, "Error: Could not add object definition in file '%s' on line %d.\n", filename, line->line);
+					return ERROR;
+					}
+				break;
+
+			case XODTEMPLATE_LINE_PROPERTY:
+				if(xodtemplate_add_object_property(text, options) == ERROR) {
+					logit(NSLOG_CONFIG_ERROR, TRUE, "Error: Could not add object property in file '%s' on line %d.\n", filename, line->line);
+					return ERROR;
+					}
+				break;
+
+			case XODTEMPLATE_LINE_END:
+				if(xodtemplate_end_object_definition(options) == ERROR) {
+					logit(NSLOG_CONFIG_ERROR, TRUE, "Error: Could not complete object definition in file '%s' on line %d. Have you named all your objects?\n", filename, line->line);
+					return ERROR;
+					}
+				break;
+
+			case XODTEMPLATE_LINE_INCLUDE_FILE:
+				if(xodtemplate_process_config_file(text, options) == ERROR)
+					return ERROR;
+				break;
+
+			case XODTEMPLATE_LINE_INCLUDE_DIR:
+				if(xodtemplate_process_config_dir(text, options) == ERROR)
+					return ERROR;
+				break;
+
+			case XODTEMPLATE_LINE_EXTINFO:
+				logit(NSLOG_CONFIG_WARNING, TRUE, "WARNING: Extinfo objects are deprecated and will be removed in future versions\n");
+				break;
+
+			case XODTEMPLATE_LINE_NO_FILE:
+				logit(NSLOG_CONFIG_ERROR, TRUE, "Error: Cannot open config file '%s' for reading: %s\n", filename, strerror(sf->error));
+				return ERROR;
+
+			case XODTEMPLATE_LINE_NO_TYPE:
+				logit(NSLOG_CONFIG_ERROR, TRUE, "Error: No object type specified in file '%s' on line %d.\n", filename, line->line);
+				return ERROR;
+
+			case XODTEMPLATE_LINE_BAD_TYPE:
+				logit(NSLOG_CONFIG_ERROR, TRUE, "Error: Invalid object definition type '%s' in file '%s' on line %d.\n", text, filename, line->line);
+				return ERROR;
+
+			case XODTEMPLATE_LINE_NESTED:
+				logit(NSLOG_CONFIG_ERROR, TRUE, "Error: Unexpected start of object definition in file '%s' on line %d.  Make sure you close preceding objects before starting a new one.\n", filename, line->line);
+				return ERROR;
+
+			case XODTEMPLATE_LINE_UNEXPECTED:
+				logit(NSLOG_CONFIG_ERROR, TRUE, "Error: Unexpected token or statement in file '%s' on line %d.\n", filename, line->line);
+				return ERROR;
+
+			case XODTEMPLATE_LINE_EOF:
+				logit(NSLOG_CONFIG_ERROR, TRUE, "Error: Unexpected EOF in file '%s' on line %d - check for a missing closing bracket.\n", filename, line->line);
+				return ERROR;
+			}
+		}
+
+	return OK;
+	}
+
+
+#ifdef NSCORE
+static void *xodtemplate_tokenize_thread(void *arg) {
+	xodtemplate_staged_file *sf = NULL;
+	struct timeval start, stop;
+
+	pthread_mutex_lock(&xodstage.lock);
+	while(xodstage.abort == FALSE && xodstage.next < xodstage.list->num_files) {
+
+		/* don't get too far ahead of the builder */
+		if(xodstage.next >= xodstage.built + xodstage.window) {
+			pthread_cond_wait(&xodstage.cond, &xodstage.lock);
+			continue;
+			}
+
+		sf = &xodstage.list->files[xodstage.next++];
+		if(sf->ready == TRUE)
+			continue;
+		pthread_mutex_unlock(&xodstage.lock);
+
+		gettimeofday(&start, NULL);
+		xodtemplate_tokenize_config_file(sf);
+		gettimeofday(&stop, NULL);
+
+		pthread_mutex_lock(&xodstage.lock);
+		xodstage.tokenize_time += tv_delta_f(&start, &stop);
+		sf->ready = TRUE;
+		pthread_cond_broadcast(&xodstage.cond);
 		}
+	pthread_mutex_unlock(&xodstage.lock);
+
+	return NULL;
+	}
+#endif
+
+
+/*
+ * builds objects from a list of staged config files, in list order.
+ * In the core, files are tokenized on a pool of threads while objects
+ * are built from the ones that are ready, so the order of object
+ * definitions (and with it, duplicate and precedence handling) is the
+ * same as if every file was read one at a time.
+ */
+static int xodtemplate_process_staged_files(xodtemplate_staged_list *list, int options, int threads) {
+	xodtemplate_staged_file *sf = NULL;
+	int result = OK;
+	unsigned int i;
+#ifdef NSCORE
+	pthread_t *tids = NULL;
+	struct timeval start, ready, stop;
+	int started = 0;
+	int timed = (xodstage_timing.depth++ == 0);
+
+	if(threads > 1 && (tids = (pthread_t *)calloc(threads, sizeof(pthread_t))) != NULL) {
+		pthread_mutex_init(&xodstage.lock, NULL);
+		pthread_cond_init(&xodstage.cond, NULL);
+		xodstage.list = list;
+		xodstage.next = 0;
+		xodstage.built = 0;
+		xodstage.window = threads * 8;
+		xodstage.abort = FALSE;
+		xodstage.tokenize_time = 0.0;
+		for(started = 0; started < threads; started++) {
+			if(pthread_create(&tids[started], NULL, xodtemplate_tokenize_thread, NULL))
+				break;
+			}
+		}
+	if(timed == TRUE)
+		xodstage_timing.threads = started > 0 ? started : 1;
+#endif
+
+	for(i = 0; i < list->num_files; i++) {
+		sf = &list->files[i];
+
+#ifdef NSCORE
+		gettimeofday(&start, NULL);
+		if(started > 0) {
+			pthread_mutex_lock(&xodstage.lock);
+			while(sf->ready == FALSE)
+				pthread_cond_wait(&xodstage.cond, &xodstage.lock);
+			pthread_mutex_unlock(&xodstage.lock);
+			}
+#endif
+		if(sf->ready == FALSE) {
+			xodtemplate_tokenize_config_file(sf);
+			sf->ready = TRUE;
+			}
+#ifdef NSCORE
+		gettimeofday(&ready, NULL);
+#endif
+
+		result = xodtemplate_build_config_file(sf, options);
+		xodtemplate_free_staged_file(sf);
+
+#ifdef NSCORE
+		if(started > 0) {
+			pthread_mutex_lock(&xodstage.lock);
+			xodstage.built++;
+			if(result == ERROR)
+				xodstage.abort = TRUE;
+			pthread_cond_broadcast(&xodstage.cond);
+			pthread_mutex_unlock(&xodstage.lock);
+			}
+
+		if(timed == TRUE) {
+			gettimeofday(&stop, NULL);
+			if(started > 0)
+				xodstage_timing.stall += tv_delta_f(&start, &ready);
+			else
+				xodstage_timing.tokenize += tv_delta_f(&start, &ready);
+			xodstage_timing.build += tv_delta_f(&ready, &stop);
+			if(sf->type == XODTEMPLATE_STAGED_FILE)
+				xodstage_timing.files++;
+			}
+#endif
+
+		if(result == ERROR)
+			break;
+		}
+
+#ifdef NSCORE
+	if(tids != NULL) {
+		pthread_mutex_lock(&xodstage.lock);
+		xodstage.abort = TRUE;
+		pthread_cond_broadcast(&xodstage.cond);
+		pthread_mutex_unlock(&xodstage.lock);
+		while(started > 0)
+			pthread_join(tids[--started], NULL);
+		if(timed == TRUE)
+			xodstage_timing.tokenize += xodstage.tokenize_time;
+		pthread_mutex_destroy(&xodstage.lock);
+		pthread_cond_destroy(&xodstage.cond);
+		free(tids);
+		}
+	xodstage_timing.depth--;
+#endif
+
+	/* anything left over after errors */
+	for(; i < list->num_files; i++)
+		xodtemplate_free_staged_file(&list->files[i]);
+	my_free(list->files);
+	list->num_files = list->max_files = 0;
+
+	return result;
+	}
+
+
+/* process all files in a specific config directory */
+int xodtemplate_process_config_dir(const char *dirname, int options) {
+	xodtemplate_staged_list list = { NULL, 0, 0 };
+	int result = OK;
+
+	/* whatever we managed to stage before an error is still processed */
+	result = xodtemplate_stage_config_dir(&list, dirname);
+	if(xodtemplate_process_staged_files(&list, options, 1) == ERROR)
+		result = ERROR;
 
 	return result;
 	}
 
 
+/* process data in a specific config file */
+int xodtemplate_process_config_file(const char *filename, int options) {
+	xodtemplate_staged_list list = { NULL, 0, 0 };
+
+	if(xodtemplate_stage_entry(&list, XODTEMPLATE_STAGED_FILE, filename) == NULL) {
+		my_free(list.files);
+		return ERROR;
+		}
+
+	return xodtemplate_process_staged_files(&list, options, 1);
+	}
+
+
 
 
 
@@ -1164,7 +1552,8 @@ int xodtemplate_add_object_property(char *input, int options) {
 	xodtemplate_hostescalation *temp_hostescalation = NULL;
 	xodtemplate_hostextinfo *temp_hostextinfo = NULL;
 	xodtemplate_serviceextinfo *temp_serviceextinfo = NULL;
-	int x, lth, force_skiplists = FALSE;
+	struct xoddir_key *key;
+	int x, lth, directive, force_skiplists = FALSE;
 
 
 	/* should some object definitions be added to skiplists immediately? */
@@ -1259,17 +1648,21 @@ int xodtemplate_add_object_property(char *input, int options) {
 	/* now strip trailing spaces */
 	strip(value);
 
+	/* look the directive up once instead of comparing it against each one this object type knows */
+	key = xoddir_get_key(variable, x);
+	directive = key ? key->code : -1;
+
 	switch(xodtemplate_current_object_type) {
 
 		case XODTEMPLATE_TIMEPERIOD:
 
 			temp_timeperiod = (xodtemplate_timeperiod *)xodtemplate_current_object;
 
-			if(!strcmp(variable, "use")) {
+			if(directive == XODDIR_use) {
 				if((temp_timeperiod->template = (char *)strdup(value)) == NULL)
 					result = ERROR;
 				}
-			else if(!strcmp(variable, "name")) {
+			else if(directive == XODDIR_name) {
 
 				if((temp_timeperiod->name = (char *)strdup(value)) == NULL)
 					result = ERROR;
@@ -1291,7 +1684,7 @@ int xodtemplate_add_object_property(char *input, int options) {
 						}
 					}
 				}
-			else if(!strcmp(variable, "timeperiod_name")) {
+			else if(directive == XODDIR_timeperiod_name) {
 				if((temp_timeperiod->timeperiod_name = (char *)strdup(value)) == NULL)
 					result = ERROR;
 
@@ -1312,15 +1705,15 @@ int xodtemplate_add_object_property(char *input, int options) {
 						}
 					}
 				}
-			else if(!strcmp(variable, "alias")) {
+			else if(directive == XODDIR_alias) {
 				if((temp_timeperiod->alias = (char *)strdup(value)) == NULL)
 					result = ERROR;
 				}
-			else if(!strcmp(variable, "exclude")) {
+			else if(directive == XODDIR_exclude) {
 				if((temp_timeperiod->exclusions = (char *)strdup(value)) == NULL)
 					result = ERROR;
 				}
-			else if(!strcmp(variable, "register"))
+			else if(directive == XODDIR_register)
 				temp_timeperiod->register_object = (atoi(value) > 0) ? TRUE : FALSE;
 			else if(xodtemplate_parse_timeperiod_directive(temp_timeperiod, variable, value) == OK)
 				result = OK;
@@ -1336,11 +1729,11 @@ int xodtemplate_add_object_property(char *input, int options) {
 
 			temp_command = (xodtemplate_command *)xodtemplate_current_object;
 
-			if(!strcmp(variable, "use")) {
+			if(directive == XODDIR_use) {
 				if((temp_command->template = (char *)strdup(value)) == NULL)
 					result = ERROR;
 				}
-			else if(!strcmp(variable, "name")) {
+			else if(directive == XODDIR_name) {
 				if((temp_command->name = (char *)strdup(value)) == NULL)
 					result = ERROR;
 
@@ -1361,7 +1754,7 @@ int xodtemplate_add_object_property(char *input, int options) {
 						}
 					}
 				}
-			else if(!strcmp(variable, "command_name")) {
+			else if(directive == XODDIR_command_name) {
 				if((temp_command->command_name = (char *)strdup(value)) == NULL)
 					result = ERROR;
 
@@ -1382,11 +1775,11 @@ int xodtemplate_add_object_property(char *input, int options) {
 						}
 					}
 				}
-			else if(!strcmp(variable, "command_line")) {
+			else if(directive == XODDIR_command_line) {
 				if((temp_command->command_line = (char *)strdup(value)) == NULL)
 					result = ERROR;
 				}
-			else if(!strcmp(variable, "register"))
+			else if(directive == XODDIR_register)
 				temp_command->register_object = (atoi(value) > 0) ? TRUE : FALSE;
 			else {
 				logit(NSLOG_CONFIG_ERROR, TRUE, "Error: Invalid command object directive '%s'.\n", variable);
@@ -1399,11 +1792,11 @@ int xodtemplate_add_object_property(char *input, int options) {
 
 			temp_contactgroup = (xodtemplate_contactgroup *)xodtemplate_current_object;
 
-			if(!strcmp(variable, "use")) {
+			if(directive == XODDIR_use) {
 				if((temp_contactgroup->template = (char *)strdup(value)) == NULL)
 					result = ERROR;
 				}
-			else if(!strcmp(variable, "name")) {
+			else if(directive == XODDIR_name) {
 
 				if((temp_contactgroup->name = (char *)strdup(value)) == NULL)
 					result = ERROR;
@@ -1425,7 +1818,7 @@ int xodtemplate_add_object_property(char *input, int options) {
 						}
 					}
 				}
-			else if(!strcmp(variable, "contactgroup_name")) {
+			else if(directive == XODDIR_contactgroup_name) {
 				if((temp_contactgroup->contactgroup_name = (char *)strdup(value)) == NULL)
 					result = ERROR;
 
@@ -1446,11 +1839,11 @@ int xodtemplate_add_object_property(char *input, int options) {
 						}
 					}
 				}
-			else if(!strcmp(variable, "alias")) {
+			else if(directive == XODDIR_alias) {
 				if((temp_contactgroup->alias = (char *)strdup(value)) == NULL)
 					result = ERROR;
 				}
-			else if(!strcmp(variable, "members")) {
+			else if(directive == XODDIR_members) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if(temp_contactgroup->members == NULL)
 						temp_contactgroup->members = (char *)strdup(value);
@@ -1466,7 +1859,7 @@ int xodtemplate_add_object_property(char *input, int options) {
 					}
 				temp_contactgroup->have_members = TRUE;
 				}
-			else if(!strcmp(variable, "contactgroup_members")) {
+			else if(directive == XODDIR_contactgroup_members) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if(temp_contactgroup->contactgroup_members == NULL)
 						temp_contactgroup->contactgroup_members = (char *)strdup(value);
@@ -1482,7 +1875,7 @@ int xodtemplate_add_object_property(char *input, int options) {
 					}
 				temp_contactgroup->have_contactgroup_members = TRUE;
 				}
-			else if(!strcmp(variable, "register"))
+			else if(directive == XODDIR_register)
 				temp_contactgroup->register_object = (atoi(value) > 0) ? TRUE : FALSE;
 			else {
 				logit(NSLOG_CONFIG_ERROR, TRUE, "Error: Invalid contactgroup object directive '%s'.\n", variable);
@@ -1495,11 +1888,11 @@ int xodtemplate_add_object_property(char *input, int options) {
 
 			temp_hostgroup = (xodtemplate_hostgroup *)xodtemplate_current_object;
 
-			if(!strcmp(variable, "use")) {
+			if(directive == XODDIR_use) {
 				if((temp_hostgroup->template = (char *)strdup(value)) == NULL)
 					result = ERROR;
 				}
-			else if(!strcmp(variable, "name")) {
+			else if(directive == XODDIR_name) {
 
 				if((temp_hostgroup->name = (char *)strdup(value)) == NULL)
 					result = ERROR;
@@ -1521,7 +1914,7 @@ int xodtemplate_add_object_property(char *input, int options) {
 						}
 					}
 				}
-			else if(!strcmp(variable, "hostgroup_name")) {
+			else if(directive == XODDIR_hostgroup_name) {
 				if((temp_hostgroup->hostgroup_name = (char *)strdup(value)) == NULL)
 					result = ERROR;
 
@@ -1542,11 +1935,11 @@ int xodtemplate_add_object_property(char *input, int options) {
 						}
 					}
 				}
-			else if(!strcmp(variable, "alias")) {
+			else if(directive == XODDIR_alias) {
 				if((temp_hostgroup->alias = (char *)strdup(value)) == NULL)
 					result = ERROR;
 				}
-			else if(!strcmp(variable, "members")) {
+			else if(directive == XODDIR_members) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if(temp_hostgroup->members == NULL)
 						temp_hostgroup->members = (char *)strdup(value);
@@ -1562,7 +1955,7 @@ int xodtemplate_add_object_property(char *input, int options) {
 					}
 				temp_hostgroup->have_members = TRUE;
 				}
-			else if(!strcmp(variable, "hostgroup_members")) {
+			else if(directive == XODDIR_hostgroup_members) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if(temp_hostgroup->hostgroup_members == NULL)
 						temp_hostgroup->hostgroup_members = (char *)strdup(value);
@@ -1578,28 +1971,28 @@ int xodtemplate_add_object_property(char *input, int options) {
 					}
 				temp_hostgroup->have_hostgroup_members = TRUE;
 				}
-			else if(!strcmp(variable, "notes")) {
+			else if(directive == XODDIR_notes) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_hostgroup->notes = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_hostgroup->have_notes = TRUE;
 				}
-			else if(!strcmp(variable, "notes_url")) {
+			else if(directive == XODDIR_notes_url) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_hostgroup->notes_url = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_hostgroup->have_notes_url = TRUE;
 				}
-			else if(!strcmp(variable, "action_url")) {
+			else if(directive == XODDIR_action_url) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_hostgroup->action_url = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_hostgroup->have_action_url = TRUE;
 				}
-			else if(!strcmp(variable, "register"))
+			else if(directive == XODDIR_register)
 				temp_hostgroup->register_object = (atoi(value) > 0) ? TRUE : FALSE;
 			else {
 				logit(NSLOG_CONFIG_ERROR, TRUE, "Error: Invalid hostgroup object directive '%s'.\n", variable);
@@ -1613,11 +2006,11 @@ int xodtemplate_add_object_property(char *input, int options) {
 
 			temp_servicegroup = (xodtemplate_servicegroup *)xodtemplate_current_object;
 
-			if(!strcmp(variable, "use")) {
+			if(directive == XODDIR_use) {
 				if((temp_servicegroup->template = (char *)strdup(value)) == NULL)
 					result = ERROR;
 				}
-			else if(!strcmp(variable, "name")) {
+			else if(directive == XODDIR_name) {
 
 				if((temp_servicegroup->name = (char *)strdup(value)) == NULL)
 					result = ERROR;
@@ -1639,7 +2032,7 @@ int xodtemplate_add_object_property(char *input, int options) {
 						}
 					}
 				}
-			else if(!strcmp(variable, "servicegroup_name")) {
+			else if(directive == XODDIR_servicegroup_name) {
 				if((temp_servicegroup->servicegroup_name = (char *)strdup(value)) == NULL)
 					result = ERROR;
 
@@ -1660,11 +2053,11 @@ int xodtemplate_add_object_property(char *input, int options) {
 						}
 					}
 				}
-			else if(!strcmp(variable, "alias")) {
+			else if(directive == XODDIR_alias) {
 				if((temp_servicegroup->alias = (char *)strdup(value)) == NULL)
 					result = ERROR;
 				}
-			else if(!strcmp(variable, "members")) {
+			else if(directive == XODDIR_members) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if(temp_servicegroup->members == NULL)
 						temp_servicegroup->members = (char *)strdup(value);
@@ -1680,7 +2073,7 @@ int xodtemplate_add_object_property(char *input, int options) {
 					}
 				temp_servicegroup->have_members = TRUE;
 				}
-			else if(!strcmp(variable, "servicegroup_members")) {
+			else if(directive == XODDIR_servicegroup_members) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if(temp_servicegroup->servicegroup_members == NULL)
 						temp_servicegroup->servicegroup_members = (char *)strdup(value);
@@ -1696,28 +2089,28 @@ int xodtemplate_add_object_property(char *input, int options) {
 					}
 				temp_servicegroup->have_servicegroup_members = TRUE;
 				}
-			else if(!strcmp(variable, "notes")) {
+			else if(directive == XODDIR_notes) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_servicegroup->notes = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_servicegroup->have_notes = TRUE;
 				}
-			else if(!strcmp(variable, "notes_url")) {
+			else if(directive == XODDIR_notes_url) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_servicegroup->notes_url = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_servicegroup->have_notes_url = TRUE;
 				}
-			else if(!strcmp(variable, "action_url")) {
+			else if(directive == XODDIR_action_url) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_servicegroup->action_url = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_servicegroup->have_action_url = TRUE;
 				}
-			else if(!strcmp(variable, "register"))
+			else if(directive == XODDIR_register)
 				temp_servicegroup->register_object = (atoi(value) > 0) ? TRUE : FALSE;
 			else {
 				logit(NSLOG_CONFIG_ERROR, TRUE, "Error: Invalid servicegroup object directive '%s'.\n", variable);
@@ -1731,11 +2124,11 @@ int xodtemplate_add_object_property(char *input, int options) {
 
 			temp_servicedependency = (xodtemplate_servicedependency *)xodtemplate_current_object;
 
-			if(!strcmp(variable, "use")) {
+			if(directive == XODDIR_use) {
 				if((temp_servicedependency->template = (char *)strdup(value)) == NULL)
 					result = ERROR;
 				}
-			else if(!strcmp(variable, "name")) {
+			else if(directive == XODDIR_name) {
 
 				if((temp_servicedependency->name = (char *)strdup(value)) == NULL)
 					result = ERROR;
@@ -1757,74 +2150,74 @@ int xodtemplate_add_object_property(char *input, int options) {
 						}
 					}
 				}
-			else if(!strcmp(variable, "servicegroup") || !strcmp(variable, "servicegroups") || !strcmp(variable, "servicegroup_name")) {
+			else if(directive == XODDIR_servicegroup || directive == XODDIR_servicegroups || directive == XODDIR_servicegroup_name) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_servicedependency->servicegroup_name = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_servicedependency->have_servicegroup_name = TRUE;
 				}
-			else if(!strcmp(variable, "hostgroup") || !strcmp(variable, "hostgroups") || !strcmp(variable, "hostgroup_name")) {
+			else if(directive == XODDIR_hostgroup || directive == XODDIR_hostgroups || directive == XODDIR_hostgroup_name) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_servicedependency->hostgroup_name = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_servicedependency->have_hostgroup_name = TRUE;
 				}
-			else if(!strcmp(variable, "host") || !strcmp(variable, "host_name") || !strcmp(variable, "master_host") || !strcmp(variable, "master_host_name")) {
+			else if(directive == XODDIR_host || directive == XODDIR_host_name || directive == XODDIR_master_host || directive == XODDIR_master_host_name) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_servicedependency->host_name = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_servicedependency->have_host_name = TRUE;
 				}
-			else if(!strcmp(variable, "description") || !strcmp(variable, "service_description") || !strcmp(variable, "master_description") || !strcmp(variable, "master_service_description")) {
+			else if(directive == XODDIR_description || directive == XODDIR_service_description || directive == XODDIR_master_description || directive == XODDIR_master_service_description) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_servicedependency->service_description = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_servicedependency->have_service_description = TRUE;
 				}
-			else if(!strcmp(variable, "dependent_servicegroup") || !strcmp(variable, "dependent_servicegroups") || !strcmp(variable, "dependent_servicegroup_name")) {
+			else if(directive == XODDIR_dependent_servicegroup || directive == XODDIR_dependent_servicegroups || directive == XODDIR_dependent_servicegroup_name) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_servicedependency->dependent_servicegroup_name = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_servicedependency->have_dependent_servicegroup_name = TRUE;
 				}
-			else if(!strcmp(variable, "dependent_hostgroup") || !strcmp(variable, "dependent_hostgroups") || !strcmp(variable, "dependent_hostgroup_name")) {
+			else if(directive == XODDIR_dependent_hostgroup || directive == XODDIR_dependent_hostgroups || directive == XODDIR_dependent_hostgroup_name) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_servicedependency->dependent_hostgroup_name = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_servicedependency->have_dependent_hostgroup_name = TRUE;
 				}
-			else if(!strcmp(variable, "dependent_host") || !strcmp(variable, "dependent_host_name")) {
+			else if(directive == XODDIR_dependent_host || directive == XODDIR_dependent_host_name) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_servicedependency->dependent_host_name = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_servicedependency->have_dependent_host_name = TRUE;
 				}
-			else if(!strcmp(variable, "dependent_description") || !strcmp(variable, "dependent_service_description")) {
+			else if(directive == XODDIR_dependent_description || directive == XODDIR_dependent_service_description) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_servicedependency->dependent_service_description = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_servicedependency->have_dependent_service_description = TRUE;
 				}
-			else if(!strcmp(variable, "dependency_period")) {
+			else if(directive == XODDIR_dependency_period) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_servicedependency->dependency_period = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_servicedependency->have_dependency_period = TRUE;
 				}
-			else if(!strcmp(variable, "inherits_parent")) {
+			else if(directive == XODDIR_inherits_parent) {
 				temp_servicedependency->inherits_parent = (atoi(value) > 0) ? TRUE : FALSE;
 				temp_servicedependency->have_inherits_parent = TRUE;
 				}
-			else if(!strcmp(variable, "execution_failure_options") || !strcmp(variable, "execution_failure_criteria")) {
+			else if(directive == XODDIR_execution_failure_options || directive == XODDIR_execution_failure_criteria) {
 				temp_servicedependency->have_execution_failure_options = TRUE;
 				for(temp_ptr = strtok(value, ", "); temp_ptr; temp_ptr = strtok(NULL, ", ")) {
 					if(!strcmp(temp_ptr, "o") || !strcmp(temp_ptr, "ok"))
@@ -1850,7 +2243,7 @@ int xodtemplate_add_object_property(char *input, int options) {
 						}
 					}
 				}
-			else if(!strcmp(variable, "notification_failure_options") || !strcmp(variable, "notification_failure_criteria")) {
+			else if(directive == XODDIR_notification_failure_options || directive == XODDIR_notification_failure_criteria) {
 				temp_servicedependency->have_notification_failure_options = TRUE;
 				for(temp_ptr = strtok(value, ", "); temp_ptr; temp_ptr = strtok(NULL, ", ")) {
 					if(!strcmp(temp_ptr, "o") || !strcmp(temp_ptr, "ok"))
@@ -1876,7 +2269,7 @@ int xodtemplate_add_object_property(char *input, int options) {
 						}
 					}
 				}
-			else if(!strcmp(variable, "register"))
+			else if(directive == XODDIR_register)
 				temp_servicedependency->register_object = (atoi(value) > 0) ? TRUE : FALSE;
 			else {
 				logit(NSLOG_CONFIG_ERROR, TRUE, "Error: Invalid servicedependency object directive '%s'.\n", variable);
@@ -1890,11 +2283,11 @@ int xodtemplate_add_object_property(char *input, int options) {
 
 			temp_serviceescalation = (xodtemplate_serviceescalation *)xodtemplate_current_object;
 
-			if(!strcmp(variable, "use")) {
+			if(directive == XODDIR_use) {
 				if((temp_serviceescalation->template = (char *)strdup(value)) == NULL)
 					result = ERROR;
 				}
-			else if(!strcmp(variable, "name")) {
+			else if(directive == XODDIR_name) {
 
 				if((temp_serviceescalation->name = (char *)strdup(value)) == NULL)
 					result = ERROR;
@@ -1916,7 +2309,7 @@ int xodtemplate_add_object_property(char *input, int options) {
 						}
 					}
 				}
-			else if(!strcmp(variable, "host") || !strcmp(variable, "host_name")) {
+			else if(directive == XODDIR_host || directive == XODDIR_host_name) {
 
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_serviceescalation->host_name = (char *)strdup(value)) == NULL)
@@ -1924,28 +2317,28 @@ int xodtemplate_add_object_property(char *input, int options) {
 					}
 				temp_serviceescalation->have_host_name = TRUE;
 				}
-			else if(!strcmp(variable, "description") || !strcmp(variable, "service_description")) {
+			else if(directive == XODDIR_description || directive == XODDIR_service_description) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_serviceescalation->service_description = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_serviceescalation->have_service_description = TRUE;
 				}
-			else if(!strcmp(variable, "servicegroup") || !strcmp(variable, "servicegroups") || !strcmp(variable, "servicegroup_name")) {
+			else if(directive == XODDIR_servicegroup || directive == XODDIR_servicegroups || directive == XODDIR_servicegroup_name) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_serviceescalation->servicegroup_name = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_serviceescalation->have_servicegroup_name = TRUE;
 				}
-			else if(!strcmp(variable, "hostgroup") || !strcmp(variable, "hostgroups") || !strcmp(variable, "hostgroup_name")) {
+			else if(directive == XODDIR_hostgroup || directive == XODDIR_hostgroups || directive == XODDIR_hostgroup_name) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_serviceescalation->hostgroup_name = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_serviceescalation->have_hostgroup_name = TRUE;
 				}
-			else if(!strcmp(variable, "contact_groups")) {
+			else if(directive == XODDIR_contact_groups) {
 				if (*value == '\0') {
 					logit(NSLOG_CONFIG_WARNING, TRUE, "Error: Empty value for contact_groups (config file '%s', starting on line %d)\n", xodtemplate_config_file_name(temp_serviceescalation->_config_file), temp_serviceescalation->_start_line);
 					result = ERROR;
@@ -1957,7 +2350,7 @@ int xodtemplate_add_object_property(char *input, int options) {
 					}
 				temp_serviceescalation->have_contact_groups = TRUE;
 				}
-			else if(!strcmp(variable, "contacts")) {
+			else if(directive == XODDIR_contacts) {
 				if (*value == '\0') {
 					logit(NSLOG_CONFIG_WARNING, TRUE, "Error: Empty value for contacts (config file '%s', starting on line %d)\n", xodtemplate_config_file_name(temp_serviceescalation->_config_file), temp_serviceescalation->_start_line);
 					result = ERROR;
@@ -1969,26 +2362,26 @@ int xodtemplate_add_object_property(char *input, int options) {
 					}
 				temp_serviceescalation->have_contacts = TRUE;
 				}
-			else if(!strcmp(variable, "escalation_period")) {
+			else if(directive == XODDIR_escalation_period) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_serviceescalation->escalation_period = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_serviceescalation->have_escalation_period = TRUE;
 				}
-			else if(!strcmp(variable, "first_notification")) {
+			else if(directive == XODDIR_first_notification) {
 				temp_serviceescalation->first_notification = atoi(value);
 				temp_serviceescalation->have_first_notification = TRUE;
 				}
-			else if(!strcmp(variable, "last_notification")) {
+			else if(directive == XODDIR_last_notification) {
 				temp_serviceescalation->last_notification = atoi(value);
 				temp_serviceescalation->have_last_notification = TRUE;
 				}
-			else if(!strcmp(variable, "notification_interval")) {
+			else if(directive == XODDIR_notification_interval) {
 				temp_serviceescalation->notification_interval = strtod(value, NULL);
 				temp_serviceescalation->have_notification_interval = TRUE;
 				}
-			else if(!strcmp(variable, "escalation_options")) {
+			else if(directive == XODDIR_escalation_options) {
 				for(temp_ptr = strtok(value, ", "); temp_ptr; temp_ptr = strtok(NULL, ", ")) {
 					if(!strcmp(temp_ptr, "w") || !strcmp(temp_ptr, "warning"))
 						flag_set(temp_serviceescalation->escalation_options, OPT_WARNING);
@@ -2011,7 +2404,7 @@ int xodtemplate_add_object_property(char *input, int options) {
 					}
 				temp_serviceescalation->have_escalation_options = TRUE;
 				}
-			else if(!strcmp(variable, "register"))
+			else if(directive == XODDIR_register)
 				temp_serviceescalation->register_object = (atoi(value) > 0) ? TRUE : FALSE;
 			else {
 				logit(NSLOG_CONFIG_ERROR, TRUE, "Error: Invalid serviceescalation object directive '%s'.\n", variable);
@@ -2025,11 +2418,11 @@ int xodtemplate_add_object_property(char *input, int options) {
 
 			temp_contact = (xodtemplate_contact *)xodtemplate_current_object;
 
-			if(!strcmp(variable, "use")) {
+			if(directive == XODDIR_use) {
 				if((temp_contact->template = (char *)strdup(value)) == NULL)
 					result = ERROR;
 				}
-			else if(!strcmp(variable, "name")) {
+			else if(directive == XODDIR_name) {
 
 				if((temp_contact->name = (char *)strdup(value)) == NULL)
 					result = ERROR;
@@ -2051,7 +2444,7 @@ int xodtemplate_add_object_property(char *input, int options) {
 						}
 					}
 				}
-			else if(!strcmp(variable, "contact_name")) {
+			else if(directive == XODDIR_contact_name) {
 				if((temp_contact->contact_name = (char *)strdup(value)) == NULL)
 					result = ERROR;
 
@@ -2073,25 +2466,25 @@ int xodtemplate_add_object_property(char *input, int options) {
 					}
 				temp_contact->id = xodcount.contacts++;
 				}
-			else if(!strcmp(variable, "alias")) {
+			else if(directive == XODDIR_alias) {
 				if((temp_contact->alias = (char *)strdup(value)) == NULL)
 					result = ERROR;
 				}
-			else if(!strcmp(variable, "contact_groups") || !strcmp(variable, "contactgroups")) {
+			else if(directive == XODDIR_contact_groups || directive == XODDIR_contactgroups) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_contact->contact_groups = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_contact->have_contact_groups = TRUE;
 				}
-			else if(!strcmp(variable, "email")) {
+			else if(directive == XODDIR_email) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_contact->email = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_contact->have_email = TRUE;
 				}
-			else if(!strcmp(variable, "pager")) {
+			else if(directive == XODDIR_pager) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_contact->pager = (char *)strdup(value)) == NULL)
 						result = ERROR;
@@ -2109,35 +2502,35 @@ int xodtemplate_add_object_property(char *input, int options) {
 				if(result == OK)
 					temp_contact->have_address[x - 1] = TRUE;
 				}
-			else if(!strcmp(variable, "host_notification_period")) {
+			else if(directive == XODDIR_host_notification_period) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_contact->host_notification_period = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_contact->have_host_notification_period = TRUE;
 				}
-			else if(!strcmp(variable, "host_notification_commands")) {
+			else if(directive == XODDIR_host_notification_commands) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_contact->host_notification_commands = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_contact->have_host_notification_commands = TRUE;
 				}
-			else if(!strcmp(variable, "service_notification_period")) {
+			else if(directive == XODDIR_service_notification_period) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_contact->service_notification_period = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_contact->have_service_notification_period = TRUE;
 				}
-			else if(!strcmp(variable, "service_notification_commands")) {
+			else if(directive == XODDIR_service_notification_commands) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_contact->service_notification_commands = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_contact->have_service_notification_commands = TRUE;
 				}
-			else if(!strcmp(variable, "host_notification_options")) {
+			else if(directive == XODDIR_host_notification_options) {
 				for(temp_ptr = strtok(value, ", "); temp_ptr; temp_ptr = strtok(NULL, ", ")) {
 					if(!strcmp(temp_ptr, "d") || !strcmp(temp_ptr, "down"))
 						flag_set(temp_contact->host_notification_options, OPT_DOWN);
@@ -2162,7 +2555,7 @@ int xodtemplate_add_object_property(char *input, int options) {
 					}
 				temp_contact->have_host_notification_options = TRUE;
 				}
-			else if(!strcmp(variable, "service_notification_options")) {
+			else if(directive == XODDIR_service_notification_options) {
 				for(temp_ptr = strtok(value, ", "); temp_ptr; temp_ptr = strtok(NULL, ", ")) {
 					if(!strcmp(temp_ptr, "u") || !strcmp(temp_ptr, "unknown"))
 						flag_set(temp_contact->service_notification_options, OPT_UNKNOWN);
@@ -2189,35 +2582,35 @@ int xodtemplate_add_object_property(char *input, int options) {
 					}
 				temp_contact->have_service_notification_options = TRUE;
 				}
-			else if(!strcmp(variable, "host_notifications_enabled")) {
+			else if(directive == XODDIR_host_notifications_enabled) {
 				temp_contact->host_notifications_enabled = (atoi(value) > 0) ? TRUE : FALSE;
 				temp_contact->have_host_notifications_enabled = TRUE;
 				}
-			else if(!strcmp(variable, "service_notifications_enabled")) {
+			else if(directive == XODDIR_service_notifications_enabled) {
 				temp_contact->service_notifications_enabled = (atoi(value) > 0) ? TRUE : FALSE;
 				temp_contact->have_service_notifications_enabled = TRUE;
 				}
-			else if(!strcmp(variable, "can_submit_commands")) {
+			else if(directive == XODDIR_can_submit_commands) {
 				temp_contact->can_submit_commands = (atoi(value) > 0) ? TRUE : FALSE;
 				temp_contact->have_can_submit_commands = TRUE;
 				}
-			else if(!strcmp(variable, "retain_status_information")) {
+			else if(directive == XODDIR_retain_status_information) {
 				temp_contact->retain_status_information = (atoi(value) > 0) ? TRUE : FALSE;
 				temp_contact->have_retain_status_information = TRUE;
 				}
-			else if(!strcmp(variable, "retain_nonstatus_information")) {
+			else if(directive == XODDIR_retain_nonstatus_information) {
 				temp_contact->retain_nonstatus_information = (atoi(value) > 0) ? TRUE : FALSE;
 				temp_contact->have_retain_nonstatus_information = TRUE;
 				}
-			else if(!strcmp(variable, "minimum_importance") ||
-					!strcmp(variable, "minimum_value")) {
-				if(!strcmp(variable, "minimum_value")) {
+			else if(directive == XODDIR_minimum_importance ||
+					directive == XODDIR_minimum_value) {
+				if(directive == XODDIR_minimum_value) {
 					logit(NSLOG_CONFIG_WARNING, TRUE, "WARNING: The minimum_value attribute is deprecated and will be removed in future versions. Please use minimum_importance instead.\n");
 					}
 				temp_contact->minimum_value = strtoul(value, NULL, 10);
 				temp_contact->have_minimum_value = TRUE;
 				}
-			else if(!strcmp(variable, "register"))
+			else if(directive == XODDIR_register)
 				temp_contact->register_object = (atoi(value) > 0) ? TRUE : FALSE;
 			else if(variable[0] == '_') {
 
@@ -2260,11 +2653,11 @@ int xodtemplate_add_object_property(char *input, int options) {
 
 			temp_host = (xodtemplate_host *)xodtemplate_current_object;
 
-			if(!strcmp(variable, "use")) {
+			if(directive == XODDIR_use) {
 				if((temp_host->template = (char *)strdup(value)) == NULL)
 					result = ERROR;
 				}
-			else if(!strcmp(variable, "name")) {
+			else if(directive == XODDIR_name) {
 
 				if((temp_host->name = (char *)strdup(value)) == NULL)
 					result = ERROR;
@@ -2286,7 +2679,7 @@ int xodtemplate_add_object_property(char *input, int options) {
 						}
 					}
 				}
-			else if(!strcmp(variable, "host_name")) {
+			else if(directive == XODDIR_host_name) {
 				if((temp_host->host_name = (char *)strdup(value)) == NULL)
 					result = ERROR;
 
@@ -2308,36 +2701,36 @@ int xodtemplate_add_object_property(char *input, int options) {
 					}
 				temp_host->id = xodcount.hosts++;
 				}
-			else if(!strcmp(variable, "display_name")) {
+			else if(directive == XODDIR_display_name) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_host->display_name = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_host->have_display_name = TRUE;
 				}
-			else if(!strcmp(variable, "alias")) {
+			else if(directive == XODDIR_alias) {
 				if((temp_host->alias = (char *)strdup(value)) == NULL)
 					result = ERROR;
 				}
-			else if(!strcmp(variable, "address")) {
+			else if(directive == XODDIR_address) {
 				if((temp_host->address = (char *)strdup(value)) == NULL)
 					result = ERROR;
 				}
-			else if(!strcmp(variable, "parents")) {
+			else if(directive == XODDIR_parents) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_host->parents = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_host->have_parents = TRUE;
 				}
-			else if(!strcmp(variable, "host_groups") || !strcmp(variable, "hostgroups")) {
+			else if(directive == XODDIR_host_groups || directive == XODDIR_hostgroups) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_host->host_groups = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_host->have_host_groups = TRUE;
 				}
-			else if(!strcmp(variable, "contact_groups")) {
+			else if(directive == XODDIR_contact_groups) {
 				if (*value == '\0') {
 					logit(NSLOG_CONFIG_WARNING, TRUE, "Error: Empty value for contact_groups (config file '%s', starting on line %d)\n", xodtemplate_config_file_name(temp_host->_config_file), temp_host->_start_line);
 					result = ERROR;
@@ -2349,7 +2742,7 @@ int xodtemplate_add_object_property(char *input, int options) {
 					}
 				temp_host->have_contact_groups = TRUE;
 				}
-			else if(!strcmp(variable, "contacts")) {
+			else if(directive == XODDIR_contacts) {
 				if (*value == '\0') {
 					logit(NSLOG_CONFIG_WARNING, TRUE, "Error: Empty value for contacts (config file '%s', starting on line %d)\n", xodtemplate_config_file_name(temp_host->_config_file), temp_host->_start_line);
 					result = ERROR;
@@ -2361,94 +2754,94 @@ int xodtemplate_add_object_property(char *input, int options) {
 					}
 				temp_host->have_contacts = TRUE;
 				}
-			else if(!strcmp(variable, "notification_period")) {
+			else if(directive == XODDIR_notification_period) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_host->notification_period = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_host->have_notification_period = TRUE;
 				}
-			else if(!strcmp(variable, "check_command")) {
+			else if(directive == XODDIR_check_command) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_host->check_command = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_host->have_check_command = TRUE;
 				}
-			else if(!strcmp(variable, "check_period")) {
+			else if(directive == XODDIR_check_period) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_host->check_period = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_host->have_check_period = TRUE;
 				}
-			else if(!strcmp(variable, "event_handler")) {
+			else if(directive == XODDIR_event_handler) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_host->event_handler = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_host->have_event_handler = TRUE;
 				}
-			else if(!strcmp(variable, "event_handler_period")) {
+			else if(directive == XODDIR_event_handler_period) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_host->event_handler_period = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_host->have_event_handler_period = TRUE;
 				}
-			else if(!strcmp(variable, "failure_prediction_options")) {
+			else if(directive == XODDIR_failure_prediction_options) {
 				xodtemplate_obsoleted(variable, temp_host->_start_line);
 				}
-			else if(!strcmp(variable, "notes")) {
+			else if(directive == XODDIR_notes) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_host->notes = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_host->have_notes = TRUE;
 				}
-			else if(!strcmp(variable, "notes_url")) {
+			else if(directive == XODDIR_notes_url) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_host->notes_url = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_host->have_notes_url = TRUE;
 				}
-			else if(!strcmp(variable, "action_url")) {
+			else if(directive == XODDIR_action_url) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_host->action_url = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_host->have_action_url = TRUE;
 				}
-			else if(!strcmp(variable, "icon_image")) {
+			else if(directive == XODDIR_icon_image) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_host->icon_image = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_host->have_icon_image = TRUE;
 				}
-			else if(!strcmp(variable, "icon_image_alt")) {
+			else if(directive == XODDIR_icon_image_alt) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_host->icon_image_alt = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_host->have_icon_image_alt = TRUE;
 				}
-			else if(!strcmp(variable, "vrml_image")) {
+			else if(directive == XODDIR_vrml_image) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_host->vrml_image = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_host->have_vrml_image = TRUE;
 				}
-			else if(!strcmp(variable, "gd2_image") || !strcmp(variable, "statusmap_image")) {
+			else if(directive == XODDIR_gd2_image || directive == XODDIR_statusmap_image) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_host->statusmap_image = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_host->have_statusmap_image = TRUE;
 				}
-			else if(!strcmp(variable, "initial_state")) {
+			else if(directive == XODDIR_initial_state) {
 				if(!strcmp(value, "o") || !strcmp(value, "up"))
 					temp_host->initial_state = 0; /* HOST_UP */
 				else if(!strcmp(value, "d") || !strcmp(value, "down"))
@@ -2461,63 +2854,63 @@ int xodtemplate_add_object_property(char *input, int options) {
 					}
 				temp_host->have_initial_state = TRUE;
 				}
-			else if(!strcmp(variable, "check_interval") || !strcmp(variable, "normal_check_interval")) {
-				if(!strcmp(variable, "normal_check_interval"))
+			else if(directive == XODDIR_check_interval || directive == XODDIR_normal_check_interval) {
+				if(directive == XODDIR_normal_check_interval)
 					logit(NSLOG_CONFIG_WARNING, TRUE, "WARNING: The normal_check_interval attribute is deprecated and will be removed in future versions. Please use check_interval instead.\n");
 				temp_host->check_interval = strtod(value, NULL);
 				temp_host->have_check_interval = TRUE;
 				}
-			else if(!strcmp(variable, "retry_interval") || !strcmp(variable, "retry_check_interval")) {
-				if(!strcmp(variable, "retry_check_interval"))
+			else if(directive == XODDIR_retry_interval || directive == XODDIR_retry_check_interval) {
+				if(directive == XODDIR_retry_check_interval)
 					logit(NSLOG_CONFIG_WARNING, TRUE, "WARNING: The retry_check_interval attribute is deprecated and will be removed in future versions. Please use retry_interval instead.\n");
 				temp_host->retry_interval = strtod(value, NULL);
 				temp_host->have_retry_interval = TRUE;
 				}
-			else if(!strcmp(variable, "importance") ||
-					!strcmp(variable, "hourly_value")) {
-				if(!strcmp(variable, "hourly_value")) {
+			else if(directive == XODDIR_importance ||
+					directive == XODDIR_hourly_value) {
+				if(directive == XODDIR_hourly_value) {
 					logit(NSLOG_CONFIG_WARNING, TRUE, "WARNING: The hourly_value attribute is deprecated and will be removed in future versions. Please use importance instead.\n");
 					}
 				temp_host->hourly_value = (unsigned int)strtoul(value, NULL, 10);
 				temp_host->have_hourly_value = 1;
 				}
-			else if(!strcmp(variable, "max_check_attempts")) {
+			else if(directive == XODDIR_max_check_attempts) {
 				temp_host->max_check_attempts = atoi(value);
 				temp_host->have_max_check_attempts = TRUE;
 				}
-			else if(!strcmp(variable, "checks_enabled") || !strcmp(variable, "active_checks_enabled")) {
+			else if(directive == XODDIR_checks_enabled || directive == XODDIR_active_checks_enabled) {
 				temp_host->active_checks_enabled = (atoi(value) > 0) ? TRUE : FALSE;
 				temp_host->have_active_checks_enabled = TRUE;
 				}
-			else if(!strcmp(variable, "passive_checks_enabled")) {
+			else if(directive == XODDIR_passive_checks_enabled) {
 				temp_host->passive_checks_enabled = (atoi(value) > 0) ? TRUE : FALSE;
 				temp_host->have_passive_checks_enabled = TRUE;
 				}
-			else if(!strcmp(variable, "event_handler_enabled")) {
+			else if(directive == XODDIR_event_handler_enabled) {
 				temp_host->event_handler_enabled = (atoi(value) > 0) ? TRUE : FALSE;
 				temp_host->have_event_handler_enabled = TRUE;
 				}
-			else if(!strcmp(variable, "check_freshness")) {
+			else if(directive == XODDIR_check_freshness) {
 				temp_host->check_freshness = (atoi(value) > 0) ? TRUE : FALSE;
 				temp_host->have_check_freshness = TRUE;
 				}
-			else if(!strcmp(variable, "freshness_threshold")) {
+			else if(directive == XODDIR_freshness_threshold) {
 				temp_host->freshness_threshold = atoi(value);
 				temp_host->have_freshness_threshold = TRUE;
 				}
-			else if(!strcmp(variable, "low_flap_threshold")) {
+			else if(directive == XODDIR_low_flap_threshold) {
 				temp_host->low_flap_threshold = strtod(value, NULL);
 				temp_host->have_low_flap_threshold = TRUE;
 				}
-			else if(!strcmp(variable, "high_flap_threshold")) {
+			else if(directive == XODDIR_high_flap_threshold) {
 				temp_host->high_flap_threshold = strtod(value, NULL);
 				temp_host->have_high_flap_threshold = TRUE;
 				}
-			else if(!strcmp(variable, "flap_detection_enabled")) {
+			else if(directive == XODDIR_flap_detection_enabled) {
 				temp_host->flap_detection_enabled = (atoi(value) > 0) ? TRUE : FALSE;
 				temp_host->have_flap_detection_enabled = TRUE;
 				}
-			else if(!strcmp(variable, "flap_detection_options")) {
+			else if(directive == XODDIR_flap_detection_options) {
 
 				/* user is specifying something, so discard defaults... */
 				temp_host->flap_detection_options = OPT_NOTHING;
@@ -2542,7 +2935,7 @@ int xodtemplate_add_object_property(char *input, int options) {
 					}
 				temp_host->have_flap_detection_options = TRUE;
 				}
-			else if(!strcmp(variable, "notification_options")) {
+			else if(directive == XODDIR_notification_options) {
 				for(temp_ptr = strtok(value, ", "); temp_ptr; temp_ptr = strtok(NULL, ", ")) {
 					if(!strcmp(temp_ptr, "d") || !strcmp(temp_ptr, "down"))
 						flag_set(temp_host->notification_options, OPT_DOWN);
@@ -2567,19 +2960,19 @@ int xodtemplate_add_object_property(char *input, int options) {
 					}
 				temp_host->have_notification_options = TRUE;
 				}
-			else if(!strcmp(variable, "notifications_enabled")) {
+			else if(directive == XODDIR_notifications_enabled) {
 				temp_host->notifications_enabled = (atoi(value) > 0) ? TRUE : FALSE;
 				temp_host->have_notifications_enabled = TRUE;
 				}
-			else if(!strcmp(variable, "notification_interval")) {
+			else if(directive == XODDIR_notification_interval) {
 				temp_host->notification_interval = strtod(value, NULL);
 				temp_host->have_notification_interval = TRUE;
 				}
-			else if(!strcmp(variable, "first_notification_delay")) {
+			else if(directive == XODDIR_first_notification_delay) {
 				temp_host->first_notification_delay = strtod(value, NULL);
 				temp_host->have_first_notification_delay = TRUE;
 				}
-			else if(!strcmp(variable, "stalking_options")) {
+			else if(directive == XODDIR_stalking_options) {
 				for(temp_ptr = strtok(value, ", "); temp_ptr; temp_ptr = strtok(NULL, ", ")) {
 					if(!strcmp(temp_ptr, "o") || !strcmp(temp_ptr, "up"))
 						flag_set(temp_host->stalking_options, OPT_UP);
@@ -2602,14 +2995,14 @@ int xodtemplate_add_object_property(char *input, int options) {
 					}
 				temp_host->have_stalking_options = TRUE;
 				}
-			else if(!strcmp(variable, "process_perf_data")) {
+			else if(directive == XODDIR_process_perf_data) {
 				temp_host->process_perf_data = (atoi(value) > 0) ? TRUE : FALSE;
 				temp_host->have_process_perf_data = TRUE;
 				}
-			else if(!strcmp(variable, "failure_prediction_enabled")) {
+			else if(directive == XODDIR_failure_prediction_enabled) {
 				xodtemplate_obsoleted(variable, temp_host->_start_line);
 				}
-			else if(!strcmp(variable, "2d_coords")) {
+			else if(directive == XODDIR_2d_coords) {
 				if((temp_ptr = strtok(value, ", ")) == NULL) {
 					logit(NSLOG_CONFIG_ERROR, TRUE, "Error: Invalid 2d_coords value in host definition.\n");
 					return ERROR;
@@ -2622,7 +3015,7 @@ int xodtemplate_add_object_property(char *input, int options) {
 				temp_host->y_2d = atoi(temp_ptr);
 				temp_host->have_2d_coords = TRUE;
 				}
-			else if(!strcmp(variable, "3d_coords")) {
+			else if(directive == XODDIR_3d_coords) {
 				if((temp_ptr = strtok(value, ", ")) == NULL) {
 					logit(NSLOG_CONFIG_ERROR, TRUE, "Error: Invalid 3d_coords value in host definition.\n");
 					return ERROR;
@@ -2640,19 +3033,19 @@ int xodtemplate_add_object_property(char *input, int options) {
 				temp_host->z_3d = strtod(temp_ptr, NULL);
 				temp_host->have_3d_coords = TRUE;
 				}
-			else if(!strcmp(variable, "obsess_over_host") || !strcmp(variable, "obsess")) {
+			else if(directive == XODDIR_obsess_over_host || directive == XODDIR_obsess) {
 				temp_host->obsess = (atoi(value) > 0) ? TRUE : FALSE;
 				temp_host->have_obsess = TRUE;
 				}
-			else if(!strcmp(variable, "retain_status_information")) {
+			else if(directive == XODDIR_retain_status_information) {
 				temp_host->retain_status_information = (atoi(value) > 0) ? TRUE : FALSE;
 				temp_host->have_retain_status_information = TRUE;
 				}
-			else if(!strcmp(variable, "retain_nonstatus_information")) {
+			else if(directive == XODDIR_retain_nonstatus_information) {
 				temp_host->retain_nonstatus_information = (atoi(value) > 0) ? TRUE : FALSE;
 				temp_host->have_retain_nonstatus_information = TRUE;
 				}
-			else if(!strcmp(variable, "register"))
+			else if(directive == XODDIR_register)
 				temp_host->register_object = (atoi(value) > 0) ? TRUE : FALSE;
 			else if(variable[0] == '_') {
 
@@ -2693,11 +3086,11 @@ int xodtemplate_add_object_property(char *input, int options) {
 
 			temp_service = (xodtemplate_service *)xodtemplate_current_object;
 
-			if(!strcmp(variable, "use")) {
+			if(directive == XODDIR_use) {
 				if((temp_service->template = (char *)strdup(value)) == NULL)
 					result = ERROR;
 				}
-			else if(!strcmp(variable, "name")) {
+			else if(directive == XODDIR_name) {
 
 				if((temp_service->name = (char *)strdup(value)) == NULL)
 					result = ERROR;
@@ -2719,7 +3112,7 @@ int xodtemplate_add_object_property(char *input, int options) {
 						}
 					}
 				}
-			else if(!strcmp(variable, "host") || !strcmp(variable, "hosts") || !strcmp(variable, "host_name")) {
+			else if(directive == XODDIR_host || directive == XODDIR_hosts || directive == XODDIR_host_name) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_service->host_name = (char *)strdup(value)) == NULL)
 						result = ERROR;
@@ -2745,7 +3138,7 @@ int xodtemplate_add_object_property(char *input, int options) {
 						}
 					}
 				}
-			else if(!strcmp(variable, "service_description") || !strcmp(variable, "description")) {
+			else if(directive == XODDIR_service_description || directive == XODDIR_description) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_service->service_description = (char *)strdup(value)) == NULL)
 						result = ERROR;
@@ -2771,35 +3164,35 @@ int xodtemplate_add_object_property(char *input, int options) {
 						}
 					}
 				}
-			else if(!strcmp(variable, "display_name")) {
+			else if(directive == XODDIR_display_name) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_service->display_name = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_service->have_display_name = TRUE;
 				}
-			else if(!strcmp(variable, "parents")) {
+			else if(directive == XODDIR_parents) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_service->parents = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_service->have_parents = TRUE;
 				}
-			else if(!strcmp(variable, "hostgroup") || !strcmp(variable, "hostgroups") || !strcmp(variable, "hostgroup_name")) {
+			else if(directive == XODDIR_hostgroup || directive == XODDIR_hostgroups || directive == XODDIR_hostgroup_name) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_service->hostgroup_name = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_service->have_hostgroup_name = TRUE;
 				}
-			else if(!strcmp(variable, "service_groups") || !strcmp(variable, "servicegroups")) {
+			else if(directive == XODDIR_service_groups || directive == XODDIR_servicegroups) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_service->service_groups = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_service->have_service_groups = TRUE;
 				}
-			else if(!strcmp(variable, "check_command")) {
+			else if(directive == XODDIR_check_command) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if(value[0] == '!') {
 						temp_service->have_important_check_command = TRUE;
@@ -2812,35 +3205,35 @@ int xodtemplate_add_object_property(char *input, int options) {
 					}
 				temp_service->have_check_command = TRUE;
 				}
-			else if(!strcmp(variable, "check_period")) {
+			else if(directive == XODDIR_check_period) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_service->check_period = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_service->have_check_period = TRUE;
 				}
-			else if(!strcmp(variable, "event_handler")) {
+			else if(directive == XODDIR_event_handler) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_service->event_handler = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_service->have_event_handler = TRUE;
 				}
-			else if(!strcmp(variable, "event_handler_period")) {
+			else if(directive == XODDIR_event_handler_period) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_service->event_handler_period = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_service->have_event_handler_period = TRUE;
 				}
-			else if(!strcmp(variable, "notification_period")) {
+			else if(directive == XODDIR_notification_period) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_service->notification_period = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_service->have_notification_period = TRUE;
 				}
-			else if(!strcmp(variable, "contact_groups")) {
+			else if(directive == XODDIR_contact_groups) {
 				if (*value == '\0') {
 					logit(NSLOG_CONFIG_WARNING, TRUE, "Error: Empty value for contact_groups (config file '%s', starting on line %d)\n", xodtemplate_config_file_name(temp_service->_config_file), temp_service->_start_line);
 					result = ERROR;
@@ -2852,7 +3245,7 @@ int xodtemplate_add_object_property(char *input, int options) {
 					}
 				temp_service->have_contact_groups = TRUE;
 				}
-			else if(!strcmp(variable, "contacts")) {
+			else if(directive == XODDIR_contacts) {
 				if (*value == '\0') {
 					logit(NSLOG_CONFIG_WARNING, TRUE, "Error: Empty value for contacts (config file '%s', starting on line %d)\n", xodtemplate_config_file_name(temp_service->_config_file), temp_service->_start_line);
 					result = ERROR;
@@ -2864,45 +3257,45 @@ int xodtemplate_add_object_property(char *input, int options) {
 					}
 				temp_service->have_contacts = TRUE;
 				}
-			else if(!strcmp(variable, "failure_prediction_options")) {
+			else if(directive == XODDIR_failure_prediction_options) {
 				xodtemplate_obsoleted(variable, temp_service->_start_line);
 				}
-			else if(!strcmp(variable, "notes")) {
+			else if(directive == XODDIR_notes) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_service->notes = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_service->have_notes = TRUE;
 				}
-			else if(!strcmp(variable, "notes_url")) {
+			else if(directive == XODDIR_notes_url) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_service->notes_url = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_service->have_notes_url = TRUE;
 				}
-			else if(!strcmp(variable, "action_url")) {
+			else if(directive == XODDIR_action_url) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_service->action_url = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_service->have_action_url = TRUE;
 				}
-			else if(!strcmp(variable, "icon_image")) {
+			else if(directive == XODDIR_icon_image) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_service->icon_image = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_service->have_icon_image = TRUE;
 				}
-			else if(!strcmp(variable, "icon_image_alt")) {
+			else if(directive == XODDIR_icon_image_alt) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_service->icon_image_alt = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_service->have_icon_image_alt = TRUE;
 				}
-			else if(!strcmp(variable, "initial_state")) {
+			else if(directive == XODDIR_initial_state) {
 				if(!strcmp(value, "o") || !strcmp(value, "ok"))
 					temp_service->initial_state = STATE_OK;
 				else if(!strcmp(value, "w") || !strcmp(value, "warning"))
@@ -2917,75 +3310,75 @@ int xodtemplate_add_object_property(char *input, int options) {
 					}
 				temp_service->have_initial_state = TRUE;
 				}
-			else if(!strcmp(variable, "importance") ||
-					!strcmp(variable, "hourly_value")) {
-				if(!strcmp(variable, "hourly_value")) {
+			else if(directive == XODDIR_importance ||
+					directive == XODDIR_hourly_value) {
+				if(directive == XODDIR_hourly_value) {
 					logit(NSLOG_CONFIG_WARNING, TRUE, "WARNING: The hourly_value attribute is deprecated and will be removed in future versions. Please use importance instead.\n");
 					}
 				temp_service->hourly_value = (unsigned int)strtoul(value, NULL, 10);
 				temp_service->have_hourly_value = 1;
 				}
-			else if(!strcmp(variable, "max_check_attempts")) {
+			else if(directive == XODDIR_max_check_attempts) {
 				temp_service->max_check_attempts = atoi(value);
 				temp_service->have_max_check_attempts = TRUE;
 				}
-			else if(!strcmp(variable, "check_interval") || !strcmp(variable, "normal_check_interval")) {
-				if(!strcmp(variable, "normal_check_interval"))
+			else if(directive == XODDIR_check_interval || directive == XODDIR_normal_check_interval) {
+				if(directive == XODDIR_normal_check_interval)
 					logit(NSLOG_CONFIG_WARNING, TRUE, "WARNING: The normal_check_interval attribute is deprecated and will be removed in future versions. Please use check_interval instead.\n");
 				temp_service->check_interval = strtod(value, NULL);
 				temp_service->have_check_interval = TRUE;
 				}
-			else if(!strcmp(variable, "retry_interval") || !strcmp(variable, "retry_check_interval")) {
-				if(!strcmp(variable, "retry_check_interval"))
+			else if(directive == XODDIR_retry_interval || directive == XODDIR_retry_check_interval) {
+				if(directive == XODDIR_retry_check_interval)
 					logit(NSLOG_CONFIG_WARNING, TRUE, "WARNING: The retry_check_interval attribute is deprecated and will be removed in future versions. Please use retry_interval instead.\n");
 				temp_service->retry_interval = strtod(value, NULL);
 				temp_service->have_retry_interval = TRUE;
 				}
-			else if(!strcmp(variable, "active_checks_enabled")) {
+			else if(directive == XODDIR_active_checks_enabled) {
 				temp_service->active_checks_enabled = (atoi(value) > 0) ? TRUE : FALSE;
 				temp_service->have_active_checks_enabled = TRUE;
 				}
-			else if(!strcmp(variable, "passive_checks_enabled")) {
+			else if(directive == XODDIR_passive_checks_enabled) {
 				temp_service->passive_checks_enabled = (atoi(value) > 0) ? TRUE : FALSE;
 				temp_service->have_passive_checks_enabled = TRUE;
 				}
-			else if(!strcmp(variable, "parallelize_check")) {
+			else if(directive == XODDIR_parallelize_check) {
 				temp_service->parallelize_check = atoi(value);
 				temp_service->have_parallelize_check = TRUE;
 				}
-			else if(!strcmp(variable, "is_volatile")) {
+			else if(directive == XODDIR_is_volatile) {
 				temp_service->is_volatile = (atoi(value) > 0) ? TRUE : FALSE;
 				temp_service->have_is_volatile = TRUE;
 				}
-			else if(!strcmp(variable, "obsess_over_service") || !strcmp(variable, "obsess")) {
+			else if(directive == XODDIR_obsess_over_service || directive == XODDIR_obsess) {
 				temp_service->obsess = (atoi(value) > 0) ? TRUE : FALSE;
 				temp_service->have_obsess = TRUE;
 				}
-			else if(!strcmp(variable, "event_handler_enabled")) {
+			else if(directive == XODDIR_event_handler_enabled) {
 				temp_service->event_handler_enabled = (atoi(value) > 0) ? TRUE : FALSE;
 				temp_service->have_event_handler_enabled = TRUE;
 				}
-			else if(!strcmp(variable, "check_freshness")) {
+			else if(directive == XODDIR_check_freshness) {
 				temp_service->check_freshness = (atoi(value) > 0) ? TRUE : FALSE;
 				temp_service->have_check_freshness = TRUE;
 				}
-			else if(!strcmp(variable, "freshness_threshold")) {
+			else if(directive == XODDIR_freshness_threshold) {
 				temp_service->freshness_threshold = atoi(value);
 				temp_service->have_freshness_threshold = TRUE;
 				}
-			else if(!strcmp(variable, "low_flap_threshold")) {
+			else if(directive == XODDIR_low_flap_threshold) {
 				temp_service->low_flap_threshold = strtod(value, NULL);
 				temp_service->have_low_flap_threshold = TRUE;
 				}
-			else if(!strcmp(variable, "high_flap_threshold")) {
+			else if(directive == XODDIR_high_flap_threshold) {
 				temp_service->high_flap_threshold = strtod(value, NULL);
 				temp_service->have_high_flap_threshold = TRUE;
 				}
-			else if(!strcmp(variable, "flap_detection_enabled")) {
+			else if(directive == XODDIR_flap_detection_enabled) {
 				temp_service->flap_detection_enabled = (atoi(value) > 0) ? TRUE : FALSE;
 				temp_service->have_flap_detection_enabled = TRUE;
 				}
-			else if(!strcmp(variable, "flap_detection_options")) {
+			else if(directive == XODDIR_flap_detection_options) {
 
 				/* user is specifying something, so discard defaults... */
 				temp_service->flap_detection_options = OPT_NOTHING;
@@ -3012,7 +3405,7 @@ int xodtemplate_add_object_property(char *input, int options) {
 					}
 				temp_service->have_flap_detection_options = TRUE;
 				}
-			else if(!strcmp(variable, "notification_options")) {
+			else if(directive == XODDIR_notification_options) {
 				for(temp_ptr = strtok(value, ", "); temp_ptr; temp_ptr = strtok(NULL, ", ")) {
 					if(!strcmp(temp_ptr, "u") || !strcmp(temp_ptr, "unknown"))
 						flag_set(temp_service->notification_options, OPT_UNKNOWN);
@@ -3039,19 +3432,19 @@ int xodtemplate_add_object_property(char *input, int options) {
 					}
 				temp_service->have_notification_options = TRUE;
 				}
-			else if(!strcmp(variable, "notifications_enabled")) {
+			else if(directive == XODDIR_notifications_enabled) {
 				temp_service->notifications_enabled = (atoi(value) > 0) ? TRUE : FALSE;
 				temp_service->have_notifications_enabled = TRUE;
 				}
-			else if(!strcmp(variable, "notification_interval")) {
+			else if(directive == XODDIR_notification_interval) {
 				temp_service->notification_interval = strtod(value, NULL);
 				temp_service->have_notification_interval = TRUE;
 				}
-			else if(!strcmp(variable, "first_notification_delay")) {
+			else if(directive == XODDIR_first_notification_delay) {
 				temp_service->first_notification_delay = strtod(value, NULL);
 				temp_service->have_first_notification_delay = TRUE;
 				}
-			else if(!strcmp(variable, "stalking_options")) {
+			else if(directive == XODDIR_stalking_options) {
 				for(temp_ptr = strtok(value, ", "); temp_ptr; temp_ptr = strtok(NULL, ", ")) {
 					if(!strcmp(temp_ptr, "o") || !strcmp(temp_ptr, "ok"))
 						flag_set(temp_service->stalking_options, OPT_OK);
@@ -3076,22 +3469,22 @@ int xodtemplate_add_object_property(char *input, int options) {
 					}
 				temp_service->have_stalking_options = TRUE;
 				}
-			else if(!strcmp(variable, "process_perf_data")) {
+			else if(directive == XODDIR_process_perf_data) {
 				temp_service->process_perf_data = (atoi(value) > 0) ? TRUE : FALSE;
 				temp_service->have_process_perf_data = TRUE;
 				}
-			else if(!strcmp(variable, "failure_prediction_enabled")) {
+			else if(directive == XODDIR_failure_prediction_enabled) {
 				xodtemplate_obsoleted(variable, temp_service->_start_line);
 				}
-			else if(!strcmp(variable, "retain_status_information")) {
+			else if(directive == XODDIR_retain_status_information) {
 				temp_service->retain_status_information = (atoi(value) > 0) ? TRUE : FALSE;
 				temp_service->have_retain_status_information = TRUE;
 				}
-			else if(!strcmp(variable, "retain_nonstatus_information")) {
+			else if(directive == XODDIR_retain_nonstatus_information) {
 				temp_service->retain_nonstatus_information = (atoi(value) > 0) ? TRUE : FALSE;
 				temp_service->have_retain_nonstatus_information = TRUE;
 				}
-			else if(!strcmp(variable, "register"))
+			else if(directive == XODDIR_register)
 				temp_service->register_object = (atoi(value) > 0) ? TRUE : FALSE;
 			else if(variable[0] == '_') {
 
@@ -3133,11 +3526,11 @@ int xodtemplate_add_object_property(char *input, int options) {
 
 			temp_hostdependency = (xodtemplate_hostdependency *)xodtemplate_current_object;
 
-			if(!strcmp(variable, "use")) {
+			if(directive == XODDIR_use) {
 				if((temp_hostdependency->template = (char *)strdup(value)) == NULL)
 					result = ERROR;
 				}
-			else if(!strcmp(variable, "name")) {
+			else if(directive == XODDIR_name) {
 
 				if((temp_hostdependency->name = (char *)strdup(value)) == NULL)
 					result = ERROR;
@@ -3159,46 +3552,46 @@ int xodtemplate_add_object_property(char *input, int options) {
 						}
 					}
 				}
-			else if(!strcmp(variable, "hostgroup") || !strcmp(variable, "hostgroups") || !strcmp(variable, "hostgroup_name")) {
+			else if(directive == XODDIR_hostgroup || directive == XODDIR_hostgroups || directive == XODDIR_hostgroup_name) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_hostdependency->hostgroup_name = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_hostdependency->have_hostgroup_name = TRUE;
 				}
-			else if(!strcmp(variable, "host") || !strcmp(variable, "host_name") || !strcmp(variable, "master_host") || !strcmp(variable, "master_host_name")) {
+			else if(directive == XODDIR_host || directive == XODDIR_host_name || directive == XODDIR_master_host || directive == XODDIR_master_host_name) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_hostdependency->host_name = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_hostdependency->have_host_name = TRUE;
 				}
-			else if(!strcmp(variable, "dependent_hostgroup") || !strcmp(variable, "dependent_hostgroups") || !strcmp(variable, "dependent_hostgroup_name")) {
+			else if(directive == XODDIR_dependent_hostgroup || directive == XODDIR_dependent_hostgroups || directive == XODDIR_dependent_hostgroup_name) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_hostdependency->dependent_hostgroup_name = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_hostdependency->have_dependent_hostgroup_name = TRUE;
 				}
-			else if(!strcmp(variable, "dependent_host") || !strcmp(variable, "dependent_host_name")) {
+			else if(directive == XODDIR_dependent_host || directive == XODDIR_dependent_host_name) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_hostdependency->dependent_host_name = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_hostdependency->have_dependent_host_name = TRUE;
 				}
-			else if(!strcmp(variable, "dependency_period")) {
+			else if(directive == XODDIR_dependency_period) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_hostdependency->dependency_period = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_hostdependency->have_dependency_period = TRUE;
 				}
-			else if(!strcmp(variable, "inherits_parent")) {
+			else if(directive == XODDIR_inherits_parent) {
 				temp_hostdependency->inherits_parent = (atoi(value) > 0) ? TRUE : FALSE;
 				temp_hostdependency->have_inherits_parent = TRUE;
 				}
-			else if(!strcmp(variable, "notification_failure_options") || !strcmp(variable, "notification_failure_criteria")) {
+			else if(directive == XODDIR_notification_failure_options || directive == XODDIR_notification_failure_criteria) {
 				temp_hostdependency->have_notification_failure_options = TRUE;
 				for(temp_ptr = strtok(value, ", "); temp_ptr; temp_ptr = strtok(NULL, ", ")) {
 					if(!strcmp(temp_ptr, "o") || !strcmp(temp_ptr, "up"))
@@ -3222,7 +3615,7 @@ int xodtemplate_add_object_property(char *input, int options) {
 						}
 					}
 				}
-			else if(!strcmp(variable, "execution_failure_options") || !strcmp(variable, "execution_failure_criteria")) {
+			else if(directive == XODDIR_execution_failure_options || directive == XODDIR_execution_failure_criteria) {
 				for(temp_ptr = strtok(value, ", "); temp_ptr; temp_ptr = strtok(NULL, ", ")) {
 					if(!strcmp(temp_ptr, "o") || !strcmp(temp_ptr, "up"))
 						flag_set(temp_hostdependency->execution_failure_options, OPT_UP);
@@ -3245,7 +3638,7 @@ int xodtemplate_add_object_property(char *input, int options) {
 					}
 				temp_hostdependency->have_execution_failure_options = TRUE;
 				}
-			else if(!strcmp(variable, "register"))
+			else if(directive == XODDIR_register)
 				temp_hostdependency->register_object = (atoi(value) > 0) ? TRUE : FALSE;
 			else {
 				logit(NSLOG_CONFIG_ERROR, TRUE, "Error: Invalid hostdependency object directive '%s'.\n", variable);
@@ -3259,11 +3652,11 @@ int xodtemplate_add_object_property(char *input, int options) {
 
 			temp_hostescalation = (xodtemplate_hostescalation *)xodtemplate_current_object;
 
-			if(!strcmp(variable, "use")) {
+			if(directive == XODDIR_use) {
 				if((temp_hostescalation->template = (char *)strdup(value)) == NULL)
 					result = ERROR;
 				}
-			else if(!strcmp(variable, "name")) {
+			else if(directive == XODDIR_name) {
 
 				if((temp_hostescalation->name = (char *)strdup(value)) == NULL)
 					result = ERROR;
@@ -3285,21 +3678,21 @@ int xodtemplate_add_object_property(char *input, int options) {
 						}
 					}
 				}
-			else if(!strcmp(variable, "hostgroup") || !strcmp(variable, "hostgroups") || !strcmp(variable, "hostgroup_name")) {
+			else if(directive == XODDIR_hostgroup || directive == XODDIR_hostgroups || directive == XODDIR_hostgroup_name) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_hostescalation->hostgroup_name = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_hostescalation->have_hostgroup_name = TRUE;
 				}
-			else if(!strcmp(variable, "host") || !strcmp(variable, "host_name")) {
+			else if(directive == XODDIR_host || directive == XODDIR_host_name) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_hostescalation->host_name = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_hostescalation->have_host_name = TRUE;
 				}
-			else if(!strcmp(variable, "contact_groups")) {
+			else if(directive == XODDIR_contact_groups) {
 				if (*value == '\0') {
 					logit(NSLOG_CONFIG_WARNING, TRUE, "Error: Empty value for contact_groups (config file '%s', starting on line %d)\n", xodtemplate_config_file_name(temp_hostescalation->_config_file), temp_hostescalation->_start_line);
 					result = ERROR;
@@ -3311,7 +3704,7 @@ int xodtemplate_add_object_property(char *input, int options) {
 					}
 				temp_hostescalation->have_contact_groups = TRUE;
 				}
-			else if(!strcmp(variable, "contacts")) {
+			else if(directive == XODDIR_contacts) {
 				if (*value == '\0') {
 					logit(NSLOG_CONFIG_WARNING, TRUE, "Error: Empty value for contacts (config file '%s', starting on line %d)\n", xodtemplate_config_file_name(temp_hostescalation->_config_file), temp_hostescalation->_start_line);
 					result = ERROR;
@@ -3323,26 +3716,26 @@ int xodtemplate_add_object_property(char *input, int options) {
 					}
 				temp_hostescalation->have_contacts = TRUE;
 				}
-			else if(!strcmp(variable, "escalation_period")) {
+			else if(directive == XODDIR_escalation_period) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_hostescalation->escalation_period = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_hostescalation->have_escalation_period = TRUE;
 				}
-			else if(!strcmp(variable, "first_notification")) {
+			else if(directive == XODDIR_first_notification) {
 				temp_hostescalation->first_notification = atoi(value);
 				temp_hostescalation->have_first_notification = TRUE;
 				}
-			else if(!strcmp(variable, "last_notification")) {
+			else if(directive == XODDIR_last_notification) {
 				temp_hostescalation->last_notification = atoi(value);
 				temp_hostescalation->have_last_notification = TRUE;
 				}
-			else if(!strcmp(variable, "notification_interval")) {
+			else if(directive == XODDIR_notification_interval) {
 				temp_hostescalation->notification_interval = strtod(value, NULL);
 				temp_hostescalation->have_notification_interval = TRUE;
 				}
-			else if(!strcmp(variable, "escalation_options")) {
+			else if(directive == XODDIR_escalation_options) {
 				for(temp_ptr = strtok(value, ", "); temp_ptr; temp_ptr = strtok(NULL, ", ")) {
 					if(!strcmp(temp_ptr, "d") || !strcmp(temp_ptr, "down"))
 						flag_set(temp_hostescalation->escalation_options, OPT_DOWN);
@@ -3363,7 +3756,7 @@ int xodtemplate_add_object_property(char *input, int options) {
 					}
 				temp_hostescalation->have_escalation_options = TRUE;
 				}
-			else if(!strcmp(variable, "register"))
+			else if(directive == XODDIR_register)
 				temp_hostescalation->register_object = (atoi(value) > 0) ? TRUE : FALSE;
 			else {
 				logit(NSLOG_CONFIG_ERROR, TRUE, "Error: Invalid hostescalation object directive '%s'.\n", variable);
@@ -3376,11 +3769,11 @@ int xodtemplate_add_object_property(char *input, int options) {
 
 			temp_hostextinfo = xodtemplate_hostextinfo_list;
 
-			if(!strcmp(variable, "use")) {
+			if(directive == XODDIR_use) {
 				if((temp_hostextinfo->template = (char *)strdup(value)) == NULL)
 					result = ERROR;
 				}
-			else if(!strcmp(variable, "name")) {
+			else if(directive == XODDIR_name) {
 
 				if((temp_hostextinfo->name = (char *)strdup(value)) == NULL)
 					result = ERROR;
@@ -3402,70 +3795,70 @@ int xodtemplate_add_object_property(char *input, int options) {
 						}
 					}
 				}
-			else if(!strcmp(variable, "host_name")) {
+			else if(directive == XODDIR_host_name) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_hostextinfo->host_name = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_hostextinfo->have_host_name = TRUE;
 				}
-			else if(!strcmp(variable, "hostgroup") || !strcmp(variable, "hostgroup_name")) {
+			else if(directive == XODDIR_hostgroup || directive == XODDIR_hostgroup_name) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_hostextinfo->hostgroup_name = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_hostextinfo->have_hostgroup_name = TRUE;
 				}
-			else if(!strcmp(variable, "notes")) {
+			else if(directive == XODDIR_notes) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_hostextinfo->notes = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_hostextinfo->have_notes = TRUE;
 				}
-			else if(!strcmp(variable, "notes_url")) {
+			else if(directive == XODDIR_notes_url) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_hostextinfo->notes_url = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_hostextinfo->have_notes_url = TRUE;
 				}
-			else if(!strcmp(variable, "action_url")) {
+			else if(directive == XODDIR_action_url) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_hostextinfo->action_url = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_hostextinfo->have_action_url = TRUE;
 				}
-			else if(!strcmp(variable, "icon_image")) {
+			else if(directive == XODDIR_icon_image) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_hostextinfo->icon_image = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_hostextinfo->have_icon_image = TRUE;
 				}
-			else if(!strcmp(variable, "icon_image_alt")) {
+			else if(directive == XODDIR_icon_image_alt) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_hostextinfo->icon_image_alt = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_hostextinfo->have_icon_image_alt = TRUE;
 				}
-			else if(!strcmp(variable, "vrml_image")) {
+			else if(directive == XODDIR_vrml_image) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_hostextinfo->vrml_image = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_hostextinfo->have_vrml_image = TRUE;
 				}
-			else if(!strcmp(variable, "gd2_image") || !strcmp(variable, "statusmap_image")) {
+			else if(directive == XODDIR_gd2_image || directive == XODDIR_statusmap_image) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_hostextinfo->statusmap_image = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_hostextinfo->have_statusmap_image = TRUE;
 				}
-			else if(!strcmp(variable, "2d_coords")) {
+			else if(directive == XODDIR_2d_coords) {
 				temp_ptr = strtok(value, ", ");
 				if(temp_ptr == NULL) {
 					logit(NSLOG_CONFIG_ERROR, TRUE, "Error: Invalid 2d_coords value in extended host info definition.\n");
@@ -3480,7 +3873,7 @@ int xodtemplate_add_object_property(char *input, int options) {
 				temp_hostextinfo->y_2d = atoi(temp_ptr);
 				temp_hostextinfo->have_2d_coords = TRUE;
 				}
-			else if(!strcmp(variable, "3d_coords")) {
+			else if(directive == XODDIR_3d_coords) {
 				temp_ptr = strtok(value, ", ");
 				if(temp_ptr == NULL) {
 					logit(NSLOG_CONFIG_ERROR, TRUE, "Error: Invalid 3d_coords value in extended host info definition.\n");
@@ -3501,7 +3894,7 @@ int xodtemplate_add_object_property(char *input, int options) {
 				temp_hostextinfo->z_3d = strtod(temp_ptr, NULL);
 				temp_hostextinfo->have_3d_coords = TRUE;
 				}
-			else if(!strcmp(variable, "register"))
+			else if(directive == XODDIR_register)
 				temp_hostextinfo->register_object = (atoi(value) > 0) ? TRUE : FALSE;
 			else {
 				logit(NSLOG_CONFIG_ERROR, TRUE, "Error: Invalid hostextinfo object directive '%s'.\n", variable);
@@ -3514,11 +3907,11 @@ int xodtemplate_add_object_property(char *input, int options) {
 
 			temp_serviceextinfo = xodtemplate_serviceextinfo_list;
 
-			if(!strcmp(variable, "use")) {
+			if(directive == XODDIR_use) {
 				if((temp_serviceextinfo->template = (char *)strdup(value)) == NULL)
 					result = ERROR;
 				}
-			else if(!strcmp(variable, "name")) {
+			else if(directive == XODDIR_name) {
 
 				if((temp_serviceextinfo->name = (char *)strdup(value)) == NULL)
 					result = ERROR;
@@ -3540,63 +3933,63 @@ int xodtemplate_add_object_property(char *input, int options) {
 						}
 					}
 				}
-			else if(!strcmp(variable, "host_name")) {
+			else if(directive == XODDIR_host_name) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_serviceextinfo->host_name = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_serviceextinfo->have_host_name = TRUE;
 				}
-			else if(!strcmp(variable, "hostgroup") || !strcmp(variable, "hostgroup_name")) {
+			else if(directive == XODDIR_hostgroup || directive == XODDIR_hostgroup_name) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_serviceextinfo->hostgroup_name = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_serviceextinfo->have_hostgroup_name = TRUE;
 				}
-			else if(!strcmp(variable, "service_description")) {
+			else if(directive == XODDIR_service_description) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_serviceextinfo->service_description = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_serviceextinfo->have_service_description = TRUE;
 				}
-			else if(!strcmp(variable, "notes")) {
+			else if(directive == XODDIR_notes) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_serviceextinfo->notes = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_serviceextinfo->have_notes = TRUE;
 				}
-			else if(!strcmp(variable, "notes_url")) {
+			else if(directive == XODDIR_notes_url) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_serviceextinfo->notes_url = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_serviceextinfo->have_notes_url = TRUE;
 				}
-			else if(!strcmp(variable, "action_url")) {
+			else if(directive == XODDIR_action_url) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_serviceextinfo->action_url = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_serviceextinfo->have_action_url = TRUE;
 				}
-			else if(!strcmp(variable, "icon_image")) {
+			else if(directive == XODDIR_icon_image) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_serviceextinfo->icon_image = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_serviceextinfo->have_icon_image = TRUE;
 				}
-			else if(!strcmp(variable, "icon_image_alt")) {
+			else if(directive == XODDIR_icon_image_alt) {
 				if(strcmp(value, XODTEMPLATE_NULL)) {
 					if((temp_serviceextinfo->icon_image_alt = (char *)strdup(value)) == NULL)
 						result = ERROR;
 					}
 				temp_serviceextinfo->have_icon_image_alt = TRUE;
 				}
-			else if(!strcmp(variable, "register"))
+			else if(directive == XODDIR_register)
 				temp_serviceextinfo->register_object = (atoi(value) > 0) ? TRUE : FALSE;
 			else {
 				logit(NSLOG_CONFIG_ERROR, TRUE, "Error: Invalid serviceextinfo object directive '%s'.\n", variable);
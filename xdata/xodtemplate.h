@@ -34,6 +34,8 @@
 
 #define MAX_XODTEMPLATE_CONTACT_ADDRESSES 6
 
+#define XODTEMPLATE_MAX_AUTO_THREADS      8     /* config tokenizer threads, unless told otherwise */
+
 #define XODTEMPLATE_NONE                  0
 #define XODTEMPLATE_TIMEPERIOD            1
 #define XODTEMPLATE_COMMAND               2
@@ -50,6 +52,26 @@
 #define XODTEMPLATE_SERVICEEXTINFO        13
 #define XODTEMPLATE_SERVICEGROUP          14
 
+/* staged config entries */
+#define XODTEMPLATE_STAGED_FILE           1
+#define XODTEMPLATE_STAGED_DIR            2
+#define XODTEMPLATE_STAGED_DIR_ERROR      3     /* directory couldn't be opened */
+#define XODTEMPLATE_STAGED_MEMBER_ERROR   4     /* directory member couldn't be stat()'ed */
+
+/* tokenized config file lines */
+#define XODTEMPLATE_LINE_BEGIN            1     /* start of a definition, text is the object type */
+#define XODTEMPLATE_LINE_PROPERTY         2
+#define XODTEMPLATE_LINE_END              3
+#define XODTEMPLATE_LINE_INCLUDE_FILE     4
+#define XODTEMPLATE_LINE_INCLUDE_DIR      5
+#define XODTEMPLATE_LINE_EXTINFO          6     /* deprecated object type */
+#define XODTEMPLATE_LINE_NO_FILE          7     /* errors from here on */
+#define XODTEMPLATE_LINE_NO_TYPE          8
+#define XODTEMPLATE_LINE_BAD_TYPE         9
+#define XODTEMPLATE_LINE_NESTED           10
+#define XODTEMPLATE_LINE_UNEXPECTED       11
+#define XODTEMPLATE_LINE_EOF              12
+
 
 
 /***************** SKIP LISTS ****************/
@@ -744,6 +766,36 @@ typedef struct xodtemplate_service_cursor_struct {
 } xodtemplate_service_cursor;
 
 
+/***** STAGED CONFIG FILE DATA STRUCTURES *****/
+
+/* one tokenized line of an object config file */
+typedef struct xodtemplate_staged_line_struct {
+    int type;
+    int line;
+    size_t text;                        /* offset of the text in the file's buffer */
+} xodtemplate_staged_line;
+
+/* a config file or directory, found and tokenized ahead of building objects from it */
+typedef struct xodtemplate_staged_file_struct {
+    int type;
+    char *filename;
+    int error;                          /* errno if the file couldn't be read or tokenized */
+    int ready;                          /* tokenized and ready to build */
+    char *buf;
+    size_t buf_len;
+    size_t buf_size;
+    xodtemplate_staged_line *lines;
+    unsigned int num_lines;
+    unsigned int max_lines;
+} xodtemplate_staged_file;
+
+typedef struct xodtemplate_staged_list_struct {
+    xodtemplate_staged_file *files;
+    unsigned int num_files;
+    unsigned int max_files;
+} xodtemplate_staged_list;
+
+
 
 /********* FUNCTION DEFINITIONS **********/
 
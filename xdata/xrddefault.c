@@ -35,6 +35,37 @@
 #include "xrddefault.h"
 
 
+/*
+ * The retention journal is appended to between full saves, so a crash
+ * loses what changed since the journal was last synced rather than
+ * everything since the last save. It's made of the same blocks as the
+ * retention file. Changes are grouped in batches, each starting with a
+ * "journal" block that carries a sequence number, and each full save
+ * records the last batch it covers, so replaying a journal that wasn't
+ * cut back after a save can't undo anything.
+ */
+static struct {
+	FILE *fp;
+	char *path;
+	unsigned long seq;          /* current or last batch */
+	unsigned long base_seq;     /* last batch covered by the retention file we read */
+	int in_batch;
+	time_t last_sync;
+	/* fingerprints of retained state, so unchanged objects aren't journaled */
+	uint64_t program_fp;
+	uint64_t *host_fp;
+	uint64_t *service_fp;
+	uint64_t *contact_fp;
+	unsigned int num_hosts;
+	unsigned int num_services;
+	unsigned int num_contacts;
+	unsigned long records;
+	unsigned long batches;
+	unsigned long syncs;
+	unsigned long compactions;
+	} journal;
+
+
 /******************************************************************/
 /********************* INIT/CLEANUP FUNCTIONS *********************/
 /******************************************************************/
@@ -69,6 +100,7 @@ int xrddefault_cleanup_retention_data(void) {
 
 	/* free memory */
 	my_free(retention_file);
+	my_free(journal.path);
 
 	return OK;
 	}
@@ -78,9 +110,260 @@ int xrddefault_cleanup_retention_data(void) {
 /**************** DEFAULT STATE OUTPUT FUNCTION *******************/
 /******************************************************************/
 
+/* the blocks below are shared by full saves and the journal */
+
+static void xrddefault_write_program(FILE *fp) {
+
+	fprintf(fp, "program {\n");
+	fprintf(fp, "modified_host_attributes=%lu\n", (modified_host_process_attributes & ~retained_process_host_attribute_mask));
+	fprintf(fp, "modified_service_attributes=%lu\n", (modified_service_process_attributes & ~retained_process_service_attribute_mask));
+	fprintf(fp, "enable_notifications=%d\n", enable_notifications);
+	fprintf(fp, "active_service_checks_enabled=%d\n", execute_service_checks);
+	fprintf(fp, "passive_service_checks_enabled=%d\n", accept_passive_service_checks);
+	fprintf(fp, "active_host_checks_enabled=%d\n", execute_host_checks);
+	fprintf(fp, "passive_host_checks_enabled=%d\n", accept_passive_host_checks);
+	fprintf(fp, "enable_event_handlers=%d\n", enable_event_handlers);
+	fprintf(fp, "obsess_over_services=%d\n", obsess_over_services);
+	fprintf(fp, "obsess_over_hosts=%d\n", obsess_over_hosts);
+	fprintf(fp, "check_service_freshness=%d\n", check_service_freshness);
+	fprintf(fp, "check_host_freshness=%d\n", check_host_freshness);
+	fprintf(fp, "enable_flap_detection=%d\n", enable_flap_detection);
+	fprintf(fp, "process_performance_data=%d\n", process_performance_data);
+	fprintf(fp, "global_host_event_handler=%s\n", (global_host_event_handler == NULL) ? "" : global_host_event_handler);
+	fprintf(fp, "global_service_event_handler=%s\n", (global_service_event_handler == NULL) ? "" : global_service_event_handler);
+	fprintf(fp, "next_comment_id=%lu\n", next_comment_id);
+	fprintf(fp, "next_downtime_id=%lu\n", next_downtime_id);
+	fprintf(fp, "next_event_id=%lu\n", next_event_id);
+	fprintf(fp, "next_problem_id=%lu\n", next_problem_id);
+	fprintf(fp, "next_notification_id=%lu\n", next_notification_id);
+	fprintf(fp, "}\n");
+	}
+
+
+static void xrddefault_write_host(FILE *fp, host *temp_host) {
+	customvariablesmember *temp_customvariablesmember = NULL;
+	int x = 0;
+
+	fprintf(fp, "host {\n");
+	fprintf(fp, "host_name=%s\n", temp_host->name);
+	fprintf(fp, "modified_attributes=%lu\n", (temp_host->modified_attributes & ~retained_host_attribute_mask));
+	fprintf(fp, "check_command=%s\n", (temp_host->check_command == NULL) ? "" : temp_host->check_command);
+	fprintf(fp, "check_period=%s\n", (temp_host->check_period == NULL) ? "" : temp_host->check_period);
+	fprintf(fp, "notification_period=%s\n", (temp_host->notification_period == NULL) ? "" : temp_host->notification_period);
+	fprintf(fp, "event_handler=%s\n", (temp_host->event_handler == NULL) ? "" : temp_host->event_handler);
+	fprintf(fp, "event_handler_period=%s\n", (temp_host->event_handler_period == NULL) ? "" : temp_host->event_handler_period);
+	fprintf(fp, "has_been_checked=%d\n", temp_host->has_been_checked);
+	fprintf(fp, "check_execution_time=%.3f\n", temp_host->execution_time);
+	fprintf(fp, "check_latency=%.3f\n", temp_host->latency);
+	fprintf(fp, "check_type=%d\n", temp_host->check_type);
+	fprintf(fp, "current_state=%d\n", temp_host->current_state);
+	fprintf(fp, "last_state=%d\n", temp_host->last_state);
+	fprintf(fp, "last_hard_state=%d\n", temp_host->last_hard_state);
+	fprintf(fp, "last_event_id=%lu\n", temp_host->last_event_id);
+	fprintf(fp, "current_event_id=%lu\n", temp_host->current_event_id);
+	fprintf(fp, "current_problem_id=%lu\n", temp_host->current_problem_id);
+	fprintf(fp, "last_problem_id=%lu\n", temp_host->last_problem_id);
+	fprintf(fp, "plugin_output=%s\n", (temp_host->plugin_output == NULL) ? "" : temp_host->plugin_output);
+	fprintf(fp, "long_plugin_output=%s\n", (temp_host->long_plugin_output == NULL) ? "" : temp_host->long_plugin_output);
+	fprintf(fp, "performance_data=%s\n", (temp_host->perf_data == NULL) ? "" : temp_host->perf_data);
+	fprintf(fp, "last_check=%llu\n", (unsigned long long)temp_host->last_check);
+	fprintf(fp, "next_check=%llu\n", (unsigned long long)temp_host->next_check);
+	fprintf(fp, "check_options=%d\n", temp_host->check_options);
+	fprintf(fp, "current_attempt=%d\n", temp_host->current_attempt);
+	fprintf(fp, "max_attempts=%d\n", temp_host->max_attempts);
+	fprintf(fp, "check_interval=%f\n", temp_host->check_interval);
+	fprintf(fp, "retry_interval=%f\n", temp_host->retry_interval);
+	fprintf(fp, "state_type=%d\n", temp_host->state_type);
+	fprintf(fp, "last_state_change=%llu\n", (unsigned long long)temp_host->last_state_change);
+	fprintf(fp, "last_hard_state_change=%llu\n", (unsigned long long)temp_host->last_hard_state_change);
+	fprintf(fp, "last_time_up=%llu\n", (unsigned long long)temp_host->last_time_up);
+	fprintf(fp, "last_time_down=%llu\n", (unsigned long long)temp_host->last_time_down);
+	fprintf(fp, "last_time_unreachable=%llu\n", (unsigned long long)temp_host->last_time_unreachable);
+	fprintf(fp, "notified_on_down=%d\n", flag_isset(temp_host->notified_on, OPT_DOWN));
+	fprintf(fp, "notified_on_unreachable=%d\n", flag_isset(temp_host->notified_on, OPT_UNREACHABLE));
+	fprintf(fp, "last_notification=%llu\n", (unsigned long long)temp_host->last_notification);
+	fprintf(fp, "current_notification_number=%d\n", temp_host->current_notification_number);
+	fprintf(fp, "current_notification_id=%lu\n", temp_host->current_notification_id);
+	fprintf(fp, "notifications_enabled=%d\n", temp_host->notifications_enabled);
+	fprintf(fp, "problem_has_been_acknowledged=%d\n", temp_host->problem_has_been_acknowledged);
+	fprintf(fp, "acknowledgement_type=%d\n", temp_host->acknowledgement_type);
+	fprintf(fp, "active_checks_enabled=%d\n", temp_host->checks_enabled);
+	fprintf(fp, "passive_checks_enabled=%d\n", temp_host->accept_passive_checks);
+	fprintf(fp, "event_handler_enabled=%d\n", temp_host->event_handler_enabled);
+	fprintf(fp, "flap_detection_enabled=%d\n", temp_host->flap_detection_enabled);
+	fprintf(fp, "process_performance_data=%d\n", temp_host->process_performance_data);
+	fprintf(fp, "obsess=%d\n", temp_host->obsess);
+	fprintf(fp, "is_flapping=%d\n", temp_host->is_flapping);
+	fprintf(fp, "percent_state_change=%.2f\n", temp_host->percent_state_change);
+	fprintf(fp, "check_flapping_recovery_notification=%d\n", temp_host->check_flapping_recovery_notification);
+	fprintf(fp, "flapping_comment_id=%lu\n", temp_host->flapping_comment_id);
+
+	fprintf(fp, "state_history=");
+	for(x = 0; x < MAX_STATE_HISTORY_ENTRIES; x++)
+		fprintf(fp, "%s%d", (x > 0) ? "," : "", temp_host->state_history[(x + temp_host->state_history_index) % MAX_STATE_HISTORY_ENTRIES]);
+	fprintf(fp, "\n");
+
+	/* custom variables */
+	for(temp_customvariablesmember = temp_host->custom_variables; temp_customvariablesmember != NULL; temp_customvariablesmember = temp_customvariablesmember->next) {
+		if(temp_customvariablesmember->variable_name)
+			fprintf(fp, "_%s=%d;%s\n", temp_customvariablesmember->variable_name, temp_customvariablesmember->has_been_modified, (temp_customvariablesmember->variable_value == NULL) ? "" : temp_customvariablesmember->variable_value);
+		}
+
+	fprintf(fp, "}\n");
+	}
+
+
+static void xrddefault_write_service(FILE *fp, service *temp_service) {
+	customvariablesmember *temp_customvariablesmember = NULL;
+	int x = 0;
+
+	fprintf(fp, "service {\n");
+	fprintf(fp, "host_name=%s\n", temp_service->host_name);
+	fprintf(fp, "service_description=%s\n", temp_service->description);
+	fprintf(fp, "modified_attributes=%lu\n", (temp_service->modified_attributes & ~retained_service_attribute_mask));
+	fprintf(fp, "check_command=%s\n", (temp_service->check_command == NULL) ? "" : temp_service->check_command);
+	fprintf(fp, "check_period=%s\n", (temp_service->check_period == NULL) ? "" : temp_service->check_period);
+	fprintf(fp, "notification_period=%s\n", (temp_service->notification_period == NULL) ? "" : temp_service->notification_period);
+	fprintf(fp, "event_handler=%s\n", (temp_service->event_handler == NULL) ? "" : temp_service->event_handler);
+	fprintf(fp, "event_handler_period=%s\n", (temp_service->event_handler_period == NULL) ? "" : temp_service->event_handler_period);
+	fprintf(fp, "has_been_checked=%d\n", temp_service->has_been_checked);
+	fprintf(fp, "check_execution_time=%.3f\n", temp_service->execution_time);
+	fprintf(fp, "check_latency=%.3f\n", temp_service->latency);
+	fprintf(fp, "check_type=%d\n", temp_service->check_type);
+	fprintf(fp, "current_state=%d\n", temp_service->current_state);
+	fprintf(fp, "last_state=%d\n", temp_service->last_state);
+	fprintf(fp, "last_hard_state=%d\n", temp_service->last_hard_state);
+	fprintf(fp, "last_event_id=%lu\n", temp_service->last_event_id);
+	fprintf(fp, "current_event_id=%lu\n", temp_service->current_event_id);
+	fprintf(fp, "current_problem_id=%lu\n", temp_service->current_problem_id);
+	fprintf(fp, "last_problem_id=%lu\n", temp_service->last_problem_id);
+	fprintf(fp, "current_attempt=%d\n", temp_service->current_attempt);
+	fprintf(fp, "max_attempts=%d\n", temp_service->max_attempts);
+	fprintf(fp, "check_interval=%f\n", temp_service->check_interval);
+	fprintf(fp, "retry_interval=%f\n", temp_service->retry_interval);
+	fprintf(fp, "state_type=%d\n", temp_service->state_type);
+	fprintf(fp, "last_state_change=%llu\n", (unsigned long long)temp_service->last_state_change);
+	fprintf(fp, "last_hard_state_change=%llu\n", (unsigned long long)temp_service->last_hard_state_change);
+	fprintf(fp, "last_time_ok=%llu\n", (unsigned long long)temp_service->last_time_ok);
+	fprintf(fp, "last_time_warning=%llu\n", (unsigned long long)temp_service->last_time_warning);
+	fprintf(fp, "last_time_unknown=%llu\n", (unsigned long long)temp_service->last_time_unknown);
+	fprintf(fp, "last_time_critical=%llu\n", (unsigned long long)temp_service->last_time_critical);
+	fprintf(fp, "plugin_output=%s\n", (temp_service->plugin_output == NULL) ? "" : temp_service->plugin_output);
+	fprintf(fp, "long_plugin_output=%s\n", (temp_service->long_plugin_output == NULL) ? "" : temp_service->long_plugin_output);
+	fprintf(fp, "performance_data=%s\n", (temp_service->perf_data == NULL) ? "" : temp_service->perf_data);
+	fprintf(fp, "last_check=%llu\n", (unsigned long long)temp_service->last_check);
+	fprintf(fp, "next_check=%llu\n", (unsigned long long)temp_service->next_check);
+	fprintf(fp, "check_options=%d\n", temp_service->check_options);
+	fprintf(fp, "notified_on_unknown=%d\n", flag_isset(temp_service->notified_on, OPT_UNKNOWN));
+	fprintf(fp, "notified_on_warning=%d\n", flag_isset(temp_service->notified_on, OPT_WARNING));
+	fprintf(fp, "notified_on_critical=%d\n", flag_isset(temp_service->notified_on, OPT_CRITICAL));
+	fprintf(fp, "current_notification_number=%d\n", temp_service->current_notification_number);
+	fprintf(fp, "current_notification_id=%lu\n", temp_service->current_notification_id);
+	fprintf(fp, "last_notification=%llu\n", (unsigned long long)temp_service->last_notification);
+	fprintf(fp, "notifications_enabled=%d\n", temp_service->notifications_enabled);
+	fprintf(fp, "active_checks_enabled=%d\n", temp_service->checks_enabled);
+	fprintf(fp, "passive_checks_enabled=%d\n", temp_service->accept_passive_checks);
+	fprintf(fp, "event_handler_enabled=%d\n", temp_service->event_handler_enabled);
+	fprintf(fp, "problem_has_been_acknowledged=%d\n", temp_service->problem_has_been_acknowledged);
+	fprintf(fp, "acknowledgement_type=%d\n", temp_service->acknowledgement_type);
+	fprintf(fp, "flap_detection_enabled=%d\n", temp_service->flap_detection_enabled);
+	fprintf(fp, "process_performance_data=%d\n", temp_service->process_performance_data);
+	fprintf(fp, "obsess=%d\n", temp_service->obsess);
+	fprintf(fp, "is_flapping=%d\n", temp_service->is_flapping);
+	fprintf(fp, "percent_state_change=%.2f\n", temp_service->percent_state_change);
+	fprintf(fp, "check_flapping_recovery_notification=%d\n", temp_service->check_flapping_recovery_notification);
+	fprintf(fp, "flapping_comment_id=%lu\n", temp_service->flapping_comment_id);
+
+	fprintf(fp, "state_history=");
+	for(x = 0; x < MAX_STATE_HISTORY_ENTRIES; x++)
+		fprintf(fp, "%s%d", (x > 0) ? "," : "", temp_service->state_history[(x + temp_service->state_history_index) % MAX_STATE_HISTORY_ENTRIES]);
+	fprintf(fp, "\n");
+
+	/* custom variables */
+	for(temp_customvariablesmember = temp_service->custom_variables; temp_customvariablesmember != NULL; temp_customvariablesmember = temp_customvariablesmember->next) {
+		if(temp_customvariablesmember->variable_name)
+			fprintf(fp, "_%s=%d;%s\n", temp_customvariablesmember->variable_name, temp_customvariablesmember->has_been_modified, (temp_customvariablesmember->variable_value == NULL) ? "" : temp_customvariablesmember->variable_value);
+		}
+
+	fprintf(fp, "}\n");
+	}
+
+
+static void xrddefault_write_contact(FILE *fp, contact *temp_contact) {
+	customvariablesmember *temp_customvariablesmember = NULL;
+
+	fprintf(fp, "contact {\n");
+	fprintf(fp, "contact_name=%s\n", temp_contact->name);
+	fprintf(fp, "modified_attributes=%lu\n", temp_contact->modified_attributes);
+	fprintf(fp, "modified_host_attributes=%lu\n", (temp_contact->modified_host_attributes & ~retained_contact_host_attribute_mask));
+	fprintf(fp, "modified_service_attributes=%lu\n", (temp_contact->modified_service_attributes & ~retained_contact_service_attribute_mask));
+	fprintf(fp, "host_notification_period=%s\n", (temp_contact->host_notification_period == NULL) ? "" : temp_contact->host_notification_period);
+	fprintf(fp, "service_notification_period=%s\n", (temp_contact->service_notification_period == NULL) ? "" : temp_contact->service_notification_period);
+	fprintf(fp, "last_host_notification=%llu\n", (unsigned long long)temp_contact->last_host_notification);
+	fprintf(fp, "last_service_notification=%llu\n", (unsigned long long)temp_contact->last_service_notification);
+	fprintf(fp, "host_notifications_enabled=%d\n", temp_contact->host_notifications_enabled);
+	fprintf(fp, "service_notifications_enabled=%d\n", temp_contact->service_notifications_enabled);
+
+	/* custom variables */
+	for(temp_customvariablesmember = temp_contact->custom_variables; temp_customvariablesmember != NULL; temp_customvariablesmember = temp_customvariablesmember->next) {
+		if(temp_customvariablesmember->variable_name)
+			fprintf(fp, "_%s=%d;%s\n", temp_customvariablesmember->variable_name, temp_customvariablesmember->has_been_modified, (temp_customvariablesmember->variable_value == NULL) ? "" : temp_customvariablesmember->variable_value);
+		}
+
+	fprintf(fp, "}\n");
+	}
+
+
+static void xrddefault_write_comment(FILE *fp, nagios_comment *temp_comment) {
+
+	if(temp_comment->comment_type == HOST_COMMENT)
+		fprintf(fp, "hostcomment {\n");
+	else
+		fprintf(fp, "servicecomment {\n");
+	fprintf(fp, "host_name=%s\n", temp_comment->host_name);
+	if(temp_comment->comment_type == SERVICE_COMMENT)
+		fprintf(fp, "service_description=%s\n", temp_comment->service_description);
+	fprintf(fp, "entry_type=%d\n", temp_comment->entry_type);
+	fprintf(fp, "comment_id=%lu\n", temp_comment->comment_id);
+	fprintf(fp, "source=%d\n", temp_comment->source);
+	fprintf(fp, "persistent=%d\n", temp_comment->persistent);
+	fprintf(fp, "entry_time=%llu\n", (unsigned long long)temp_comment->entry_time);
+	fprintf(fp, "expires=%d\n", temp_comment->expires);
+	fprintf(fp, "expire_time=%llu\n", (unsigned long long)temp_comment->expire_time);
+	fprintf(fp, "author=%s\n", temp_comment->author);
+	fprintf(fp, "comment_data=%s\n", temp_comment->comment_data);
+	fprintf(fp, "}\n");
+	}
+
+
+static void xrddefault_write_downtime(FILE *fp, scheduled_downtime *temp_downtime) {
+
+	if(temp_downtime->type == HOST_DOWNTIME)
+		fprintf(fp, "hostdowntime {\n");
+	else
+		fprintf(fp, "servicedowntime {\n");
+	fprintf(fp, "host_name=%s\n", temp_downtime->host_name);
+	if(temp_downtime->type == SERVICE_DOWNTIME)
+		fprintf(fp, "service_description=%s\n", temp_downtime->service_description);
+	fprintf(fp, "comment_id=%lu\n", temp_downtime->comment_id);
+	fprintf(fp, "downtime_id=%lu\n", temp_downtime->downtime_id);
+	fprintf(fp, "entry_time=%llu\n", (unsigned long long)temp_downtime->entry_time);
+	fprintf(fp, "start_time=%llu\n", (unsigned long long)temp_downtime->start_time);
+	fprintf(fp, "flex_downtime_start=%llu\n", (unsigned long long)temp_downtime->flex_downtime_start);
+	fprintf(fp, "end_time=%llu\n", (unsigned long long)temp_downtime->end_time);
+	fprintf(fp, "triggered_by=%lu\n", temp_downtime->triggered_by);
+	fprintf(fp, "fixed=%d\n", temp_downtime->fixed);
+	fprintf(fp, "duration=%lu\n", temp_downtime->duration);
+	fprintf(fp, "is_in_effect=%d\n", temp_downtime->is_in_effect);
+	fprintf(fp, "start_notification_sent=%d\n", temp_downtime->start_notification_sent);
+	fprintf(fp, "author=%s\n", temp_downtime->author);
+	fprintf(fp, "comment=%s\n", temp_downtime->comment);
+	fprintf(fp, "}\n");
+	}
+
+
 int xrddefault_save_state_information(void) {
 	char *tmp_file = NULL;
-	customvariablesmember *temp_customvariablesmember = NULL;
 	time_t current_time = 0L;
 	int result = OK;
 	FILE *fp = NULL;
@@ -89,15 +372,7 @@ int xrddefault_save_state_information(void) {
 	contact *temp_contact = NULL;
 	nagios_comment *temp_comment = NULL;
 	scheduled_downtime *temp_downtime = NULL;
-	int x = 0;
 	int fd = 0;
-	unsigned long host_attribute_mask = 0L;
-	unsigned long service_attribute_mask = 0L;
-	unsigned long contact_attribute_mask = 0L;
-	unsigned long contact_host_attribute_mask = 0L;
-	unsigned long contact_service_attribute_mask = 0L;
-	unsigned long process_host_attribute_mask = 0L;
-	unsigned long process_service_attribute_mask = 0L;
 
 
 	log_debug_info(DEBUGL_FUNCTIONS, 0, "xrddefault_save_state_information()\n");
@@ -130,15 +405,6 @@ int xrddefault_save_state_information(void) {
 		return ERROR;
 		}
 
-	/* what attributes should be masked out? */
-	/* NOTE: host/service/contact-specific values may be added in the future, but for now we only have global masks */
-	process_host_attribute_mask = retained_process_host_attribute_mask;
-	process_service_attribute_mask = retained_process_service_attribute_mask;
-	host_attribute_mask = retained_host_attribute_mask;
-	service_attribute_mask = retained_service_attribute_mask;
-	contact_host_attribute_mask = retained_contact_host_attribute_mask;
-	contact_service_attribute_mask = retained_contact_service_attribute_mask;
-
 	/* write version info to status file */
 	fprintf(fp, "########################################\n");
 	fprintf(fp, "#      NAGIOS STATE RETENTION FILE\n");
@@ -158,249 +424,31 @@ int xrddefault_save_state_information(void) {
 	fprintf(fp, "update_uid=%lu\n", update_uid);
 	fprintf(fp, "last_version=%s\n", (last_program_version == NULL) ? "" : last_program_version);
 	fprintf(fp, "new_version=%s\n", (new_program_version == NULL) ? "" : new_program_version);
+	fprintf(fp, "journal_seq=%lu\n", journal.seq);
 	fprintf(fp, "}\n");
 
 	/* save program state information */
-	fprintf(fp, "program {\n");
-	fprintf(fp, "modified_host_attributes=%lu\n", (modified_host_process_attributes & ~process_host_attribute_mask));
-	fprintf(fp, "modified_service_attributes=%lu\n", (modified_service_process_attributes & ~process_service_attribute_mask));
-	fprintf(fp, "enable_notifications=%d\n", enable_notifications);
-	fprintf(fp, "active_service_checks_enabled=%d\n", execute_service_checks);
-	fprintf(fp, "passive_service_checks_enabled=%d\n", accept_passive_service_checks);
-	fprintf(fp, "active_host_checks_enabled=%d\n", execute_host_checks);
-	fprintf(fp, "passive_host_checks_enabled=%d\n", accept_passive_host_checks);
-	fprintf(fp, "enable_event_handlers=%d\n", enable_event_handlers);
-	fprintf(fp, "obsess_over_services=%d\n", obsess_over_services);
-	fprintf(fp, "obsess_over_hosts=%d\n", obsess_over_hosts);
-	fprintf(fp, "check_service_freshness=%d\n", check_service_freshness);
-	fprintf(fp, "check_host_freshness=%d\n", check_host_freshness);
-	fprintf(fp, "enable_flap_detection=%d\n", enable_flap_detection);
-	fprintf(fp, "process_performance_data=%d\n", process_performance_data);
-	fprintf(fp, "global_host_event_handler=%s\n", (global_host_event_handler == NULL) ? "" : global_host_event_handler);
-	fprintf(fp, "global_service_event_handler=%s\n", (global_service_event_handler == NULL) ? "" : global_service_event_handler);
-	fprintf(fp, "next_comment_id=%lu\n", next_comment_id);
-	fprintf(fp, "next_downtime_id=%lu\n", next_downtime_id);
-	fprintf(fp, "next_event_id=%lu\n", next_event_id);
-	fprintf(fp, "next_problem_id=%lu\n", next_problem_id);
-	fprintf(fp, "next_notification_id=%lu\n", next_notification_id);
-	fprintf(fp, "}\n");
+	xrddefault_write_program(fp);
 
 	/* save host state information */
-	for(temp_host = host_list; temp_host != NULL; temp_host = temp_host->next) {
-
-		fprintf(fp, "host {\n");
-		fprintf(fp, "host_name=%s\n", temp_host->name);
-		fprintf(fp, "modified_attributes=%lu\n", (temp_host->modified_attributes & ~host_attribute_mask));
-		fprintf(fp, "check_command=%s\n", (temp_host->check_command == NULL) ? "" : temp_host->check_command);
-		fprintf(fp, "check_period=%s\n", (temp_host->check_period == NULL) ? "" : temp_host->check_period);
-		fprintf(fp, "notification_period=%s\n", (temp_host->notification_period == NULL) ? "" : temp_host->notification_period);
-		fprintf(fp, "event_handler=%s\n", (temp_host->event_handler == NULL) ? "" : temp_host->event_handler);
-		fprintf(fp, "event_handler_period=%s\n", (temp_host->event_handler_period == NULL) ? "" : temp_host->event_handler_period);
-		fprintf(fp, "has_been_checked=%d\n", temp_host->has_been_checked);
-		fprintf(fp, "check_execution_time=%.3f\n", temp_host->execution_time);
-		fprintf(fp, "check_latency=%.3f\n", temp_host->latency);
-		fprintf(fp, "check_type=%d\n", temp_host->check_type);
-		fprintf(fp, "current_state=%d\n", temp_host->current_state);
-		fprintf(fp, "last_state=%d\n", temp_host->last_state);
-		fprintf(fp, "last_hard_state=%d\n", temp_host->last_hard_state);
-		fprintf(fp, "last_event_id=%lu\n", temp_host->last_event_id);
-		fprintf(fp, "current_event_id=%lu\n", temp_host->current_event_id);
-		fprintf(fp, "current_problem_id=%lu\n", temp_host->current_problem_id);
-		fprintf(fp, "last_problem_id=%lu\n", temp_host->last_problem_id);
-		fprintf(fp, "plugin_output=%s\n", (temp_host->plugin_output == NULL) ? "" : temp_host->plugin_output);
-		fprintf(fp, "long_plugin_output=%s\n", (temp_host->long_plugin_output == NULL) ? "" : temp_host->long_plugin_output);
-		fprintf(fp, "performance_data=%s\n", (temp_host->perf_data == NULL) ? "" : temp_host->perf_data);
-		fprintf(fp, "last_check=%llu\n", (unsigned long long)temp_host->last_check);
-		fprintf(fp, "next_check=%llu\n", (unsigned long long)temp_host->next_check);
-		fprintf(fp, "check_options=%d\n", temp_host->check_options);
-		fprintf(fp, "current_attempt=%d\n", temp_host->current_attempt);
-		fprintf(fp, "max_attempts=%d\n", temp_host->max_attempts);
-		fprintf(fp, "check_interval=%f\n", temp_host->check_interval);
-		fprintf(fp, "retry_interval=%f\n", temp_host->retry_interval);
-		fprintf(fp, "state_type=%d\n", temp_host->state_type);
-		fprintf(fp, "last_state_change=%llu\n", (unsigned long long)temp_host->last_state_change);
-		fprintf(fp, "last_hard_state_change=%llu\n", (unsigned long long)temp_host->last_hard_state_change);
-		fprintf(fp, "last_time_up=%llu\n", (unsigned long long)temp_host->last_time_up);
-		fprintf(fp, "last_time_down=%llu\n", (unsigned long long)temp_host->last_time_down);
-		fprintf(fp, "last_time_unreachable=%llu\n", (unsigned long long)temp_host->last_time_unreachable);
-		fprintf(fp, "notified_on_down=%d\n", flag_isset(temp_host->notified_on, OPT_DOWN));
-		fprintf(fp, "notified_on_unreachable=%d\n", flag_isset(temp_host->notified_on, OPT_UNREACHABLE));
-		fprintf(fp, "last_notification=%llu\n", (unsigned long long)temp_host->last_notification);
-		fprintf(fp, "current_notification_number=%d\n", temp_host->current_notification_number);
-		fprintf(fp, "current_notification_id=%lu\n", temp_host->current_notification_id);
-		fprintf(fp, "notifications_enabled=%d\n", temp_host->notifications_enabled);
-		fprintf(fp, "problem_has_been_acknowledged=%d\n", temp_host->problem_has_been_acknowledged);
-		fprintf(fp, "acknowledgement_type=%d\n", temp_host->acknowledgement_type);
-		fprintf(fp, "active_checks_enabled=%d\n", temp_host->checks_enabled);
-		fprintf(fp, "passive_checks_enabled=%d\n", temp_host->accept_passive_checks);
-		fprintf(fp, "event_handler_enabled=%d\n", temp_host->event_handler_enabled);
-		fprintf(fp, "flap_detection_enabled=%d\n", temp_host->flap_detection_enabled);
-		fprintf(fp, "process_performance_data=%d\n", temp_host->process_performance_data);
-		fprintf(fp, "obsess=%d\n", temp_host->obsess);
-		fprintf(fp, "is_flapping=%d\n", temp_host->is_flapping);
-		fprintf(fp, "percent_state_change=%.2f\n", temp_host->percent_state_change);
-		fprintf(fp, "check_flapping_recovery_notification=%d\n", temp_host->check_flapping_recovery_notification);
-		fprintf(fp, "flapping_comment_id=%lu\n", temp_host->flapping_comment_id);
-
-		fprintf(fp, "state_history=");
-		for(x = 0; x < MAX_STATE_HISTORY_ENTRIES; x++)
-			fprintf(fp, "%s%d", (x > 0) ? "," : "", temp_host->state_history[(x + temp_host->state_history_index) % MAX_STATE_HISTORY_ENTRIES]);
-		fprintf(fp, "\n");
-
-		/* custom variables */
-		for(temp_customvariablesmember = temp_host->custom_variables; temp_customvariablesmember != NULL; temp_customvariablesmember = temp_customvariablesmember->next) {
-			if(temp_customvariablesmember->variable_name)
-				fprintf(fp, "_%s=%d;%s\n", temp_customvariablesmember->variable_name, temp_customvariablesmember->has_been_modified, (temp_customvariablesmember->variable_value == NULL) ? "" : temp_customvariablesmember->variable_value);
-			}
-
-		fprintf(fp, "}\n");
-		}
+	for(temp_host = host_list; temp_host != NULL; temp_host = temp_host->next)
+		xrddefault_write_host(fp, temp_host);
 
 	/* save service state information */
-	for(temp_service = service_list; temp_service != NULL; temp_service = temp_service->next) {
-
-		fprintf(fp, "service {\n");
-		fprintf(fp, "host_name=%s\n", temp_service->host_name);
-		fprintf(fp, "service_description=%s\n", temp_service->description);
-		fprintf(fp, "modified_attributes=%lu\n", (temp_service->modified_attributes & ~service_attribute_mask));
-		fprintf(fp, "check_command=%s\n", (temp_service->check_command == NULL) ? "" : temp_service->check_command);
-		fprintf(fp, "check_period=%s\n", (temp_service->check_period == NULL) ? "" : temp_service->check_period);
-		fprintf(fp, "notification_period=%s\n", (temp_service->notification_period == NULL) ? "" : temp_service->notification_period);
-		fprintf(fp, "event_handler=%s\n", (temp_service->event_handler == NULL) ? "" : temp_service->event_handler);
-		fprintf(fp, "event_handler_period=%s\n", (temp_service->event_handler_period == NULL) ? "" : temp_service->event_handler_period);
-		fprintf(fp, "has_been_checked=%d\n", temp_service->has_been_checked);
-		fprintf(fp, "check_execution_time=%.3f\n", temp_service->execution_time);
-		fprintf(fp, "check_latency=%.3f\n", temp_service->latency);
-		fprintf(fp, "check_type=%d\n", temp_service->check_type);
-		fprintf(fp, "current_state=%d\n", temp_service->current_state);
-		fprintf(fp, "last_state=%d\n", temp_service->last_state);
-		fprintf(fp, "last_hard_state=%d\n", temp_service->last_hard_state);
-		fprintf(fp, "last_event_id=%lu\n", temp_service->last_event_id);
-		fprintf(fp, "current_event_id=%lu\n", temp_service->current_event_id);
-		fprintf(fp, "current_problem_id=%lu\n", temp_service->current_problem_id);
-		fprintf(fp, "last_problem_id=%lu\n", temp_service->last_problem_id);
-		fprintf(fp, "current_attempt=%d\n", temp_service->current_attempt);
-		fprintf(fp, "max_attempts=%d\n", temp_service->max_attempts);
-		fprintf(fp, "check_interval=%f\n", temp_service->check_interval);
-		fprintf(fp, "retry_interval=%f\n", temp_service->retry_interval);
-		fprintf(fp, "state_type=%d\n", temp_service->state_type);
-		fprintf(fp, "last_state_change=%llu\n", (unsigned long long)temp_service->last_state_change);
-		fprintf(fp, "last_hard_state_change=%llu\n", (unsigned long long)temp_service->last_hard_state_change);
-		fprintf(fp, "last_time_ok=%llu\n", (unsigned long long)temp_service->last_time_ok);
-		fprintf(fp, "last_time_warning=%llu\n", (unsigned long long)temp_service->last_time_warning);
-		fprintf(fp, "last_time_unknown=%llu\n", (unsigned long long)temp_service->last_time_unknown);
-		fprintf(fp, "last_time_critical=%llu\n", (unsigned long long)temp_service->last_time_critical);
-		fprintf(fp, "plugin_output=%s\n", (temp_service->plugin_output == NULL) ? "" : temp_service->plugin_output);
-		fprintf(fp, "long_plugin_output=%s\n", (temp_service->long_plugin_output == NULL) ? "" : temp_service->long_plugin_output);
-		fprintf(fp, "performance_data=%s\n", (temp_service->perf_data == NULL) ? "" : temp_service->perf_data);
-		fprintf(fp, "last_check=%llu\n", (unsigned long long)temp_service->last_check);
-		fprintf(fp, "next_check=%llu\n", (unsigned long long)temp_service->next_check);
-		fprintf(fp, "check_options=%d\n", temp_service->check_options);
-		fprintf(fp, "notified_on_unknown=%d\n", flag_isset(temp_service->notified_on, OPT_UNKNOWN));
-		fprintf(fp, "notified_on_warning=%d\n", flag_isset(temp_service->notified_on, OPT_WARNING));
-		fprintf(fp, "notified_on_critical=%d\n", flag_isset(temp_service->notified_on, OPT_CRITICAL));
-		fprintf(fp, "current_notification_number=%d\n", temp_service->current_notification_number);
-		fprintf(fp, "current_notification_id=%lu\n", temp_service->current_notification_id);
-		fprintf(fp, "last_notification=%llu\n", (unsigned long long)temp_service->last_notification);
-		fprintf(fp, "notifications_enabled=%d\n", temp_service->notifications_enabled);
-		fprintf(fp, "active_checks_enabled=%d\n", temp_service->checks_enabled);
-		fprintf(fp, "passive_checks_enabled=%d\n", temp_service->accept_passive_checks);
-		fprintf(fp, "event_handler_enabled=%d\n", temp_service->event_handler_enabled);
-		fprintf(fp, "problem_has_been_acknowledged=%d\n", temp_service->problem_has_been_acknowledged);
-		fprintf(fp, "acknowledgement_type=%d\n", temp_service->acknowledgement_type);
-		fprintf(fp, "flap_detection_enabled=%d\n", temp_service->flap_detection_enabled);
-		fprintf(fp, "process_performance_data=%d\n", temp_service->process_performance_data);
-		fprintf(fp, "obsess=%d\n", temp_service->obsess);
-		fprintf(fp, "is_flapping=%d\n", temp_service->is_flapping);
-		fprintf(fp, "percent_state_change=%.2f\n", temp_service->percent_state_change);
-		fprintf(fp, "check_flapping_recovery_notification=%d\n", temp_service->check_flapping_recovery_notification);
-		fprintf(fp, "flapping_comment_id=%lu\n", temp_service->flapping_comment_id);
-
-		fprintf(fp, "state_history=");
-		for(x = 0; x < MAX_STATE_HISTORY_ENTRIES; x++)
-			fprintf(fp, "%s%d", (x > 0) ? "," : "", temp_service->state_history[(x + temp_service->state_history_index) % MAX_STATE_HISTORY_ENTRIES]);
-		fprintf(fp, "\n");
-
-		/* custom variables */
-		for(temp_customvariablesmember = temp_service->custom_variables; temp_customvariablesmember != NULL; temp_customvariablesmember = temp_customvariablesmember->next) {
-			if(temp_customvariablesmember->variable_name)
-				fprintf(fp, "_%s=%d;%s\n", temp_customvariablesmember->variable_name, temp_customvariablesmember->has_been_modified, (temp_customvariablesmember->variable_value == NULL) ? "" : temp_customvariablesmember->variable_value);
-			}
-
-		fprintf(fp, "}\n");
-		}
+	for(temp_service = service_list; temp_service != NULL; temp_service = temp_service->next)
+		xrddefault_write_service(fp, temp_service);
 
 	/* save contact state information */
-	for(temp_contact = contact_list; temp_contact != NULL; temp_contact = temp_contact->next) {
-
-		fprintf(fp, "contact {\n");
-		fprintf(fp, "contact_name=%s\n", temp_contact->name);
-		fprintf(fp, "modified_attributes=%lu\n", (temp_contact->modified_attributes & ~contact_attribute_mask));
-		fprintf(fp, "modified_host_attributes=%lu\n", (temp_contact->modified_host_attributes & ~contact_host_attribute_mask));
-		fprintf(fp, "modified_service_attributes=%lu\n", (temp_contact->modified_service_attributes & ~contact_service_attribute_mask));
-		fprintf(fp, "host_notification_period=%s\n", (temp_contact->host_notification_period == NULL) ? "" : temp_contact->host_notification_period);
-		fprintf(fp, "service_notification_period=%s\n", (temp_contact->service_notification_period == NULL) ? "" : temp_contact->service_notification_period);
-		fprintf(fp, "last_host_notification=%llu\n", (unsigned long long)temp_contact->last_host_notification);
-		fprintf(fp, "last_service_notification=%llu\n", (unsigned long long)temp_contact->last_service_notification);
-		fprintf(fp, "host_notifications_enabled=%d\n", temp_contact->host_notifications_enabled);
-		fprintf(fp, "service_notifications_enabled=%d\n", temp_contact->service_notifications_enabled);
-
-		/* custom variables */
-		for(temp_customvariablesmember = temp_contact->custom_variables; temp_customvariablesmember != NULL; temp_customvariablesmember = temp_customvariablesmember->next) {
-			if(temp_customvariablesmember->variable_name)
-				fprintf(fp, "_%s=%d;%s\n", temp_customvariablesmember->variable_name, temp_customvariablesmember->has_been_modified, (temp_customvariablesmember->variable_value == NULL) ? "" : temp_customvariablesmember->variable_value);
-			}
-
-		fprintf(fp, "}\n");
-		}
+	for(temp_contact = contact_list; temp_contact != NULL; temp_contact = temp_contact->next)
+		xrddefault_write_contact(fp, temp_contact);
 
 	/* save all comments */
-	for(temp_comment = comment_list; temp_comment != NULL; temp_comment = temp_comment->next) {
-
-		if(temp_comment->comment_type == HOST_COMMENT)
-			fprintf(fp, "hostcomment {\n");
-		else
-			fprintf(fp, "servicecomment {\n");
-		fprintf(fp, "host_name=%s\n", temp_comment->host_name);
-		if(temp_comment->comment_type == SERVICE_COMMENT)
-			fprintf(fp, "service_description=%s\n", temp_comment->service_description);
-		fprintf(fp, "entry_type=%d\n", temp_comment->entry_type);
-		fprintf(fp, "comment_id=%lu\n", temp_comment->comment_id);
-		fprintf(fp, "source=%d\n", temp_comment->source);
-		fprintf(fp, "persistent=%d\n", temp_comment->persistent);
-		fprintf(fp, "entry_time=%llu\n", (unsigned long long)temp_comment->entry_time);
-		fprintf(fp, "expires=%d\n", temp_comment->expires);
-		fprintf(fp, "expire_time=%llu\n", (unsigned long long)temp_comment->expire_time);
-		fprintf(fp, "author=%s\n", temp_comment->author);
-		fprintf(fp, "comment_data=%s\n", temp_comment->comment_data);
-		fprintf(fp, "}\n");
-		}
+	for(temp_comment = comment_list; temp_comment != NULL; temp_comment = temp_comment->next)
+		xrddefault_write_comment(fp, temp_comment);
 
 	/* save all downtime */
-	for(temp_downtime = scheduled_downtime_list; temp_downtime != NULL; temp_downtime = temp_downtime->next) {
-
-		if(temp_downtime->type == HOST_DOWNTIME)
-			fprintf(fp, "hostdowntime {\n");
-		else
-			fprintf(fp, "servicedowntime {\n");
-		fprintf(fp, "host_name=%s\n", temp_downtime->host_name);
-		if(temp_downtime->type == SERVICE_DOWNTIME)
-			fprintf(fp, "service_description=%s\n", temp_downtime->service_description);
-		fprintf(fp, "comment_id=%lu\n", temp_downtime->comment_id);
-		fprintf(fp, "downtime_id=%lu\n", temp_downtime->downtime_id);
-		fprintf(fp, "entry_time=%llu\n", (unsigned long long)temp_downtime->entry_time);
-		fprintf(fp, "start_time=%llu\n", (unsigned long long)temp_downtime->start_time);
-		fprintf(fp, "flex_downtime_start=%llu\n", (unsigned long long)temp_downtime->flex_downtime_start);
-		fprintf(fp, "end_time=%llu\n", (unsigned long long)temp_downtime->end_time);
-		fprintf(fp, "triggered_by=%lu\n", temp_downtime->triggered_by);
-		fprintf(fp, "fixed=%d\n", temp_downtime->fixed);
-		fprintf(fp, "duration=%lu\n", temp_downtime->duration);
-		fprintf(fp, "is_in_effect=%d\n", temp_downtime->is_in_effect);
-		fprintf(fp, "start_notification_sent=%d\n", temp_downtime->start_notification_sent);
-		fprintf(fp, "author=%s\n", temp_downtime->author);
-		fprintf(fp, "comment=%s\n", temp_downtime->comment);
-		fprintf(fp, "}\n");
-		}
+	for(temp_downtime = scheduled_downtime_list; temp_downtime != NULL; temp_downtime = temp_downtime->next)
+		xrddefault_write_downtime(fp, temp_downtime);
 
 	fflush(fp);
 	fsync(fd);
@@ -438,10 +486,617 @@ int xrddefault_save_state_information(void) {
 
 
 
+/******************************************************************/
+/******************** RETENTION JOURNAL FUNCTIONS *****************/
+/******************************************************************/
+
+static const char *xrddefault_journal_path(void) {
+
+	if(journal.path == NULL && retention_file != NULL)
+		asprintf(&journal.path, "%s.journal", retention_file);
+
+	return journal.path;
+	}
+
+
+/* FNV-1a over the bytes of a value */
+static inline uint64_t journal_mix(uint64_t h, uint64_t v) {
+	int i;
+
+	for(i = 0; i < 8; i++, v >>= 8) {
+		h ^= v & 0xff;
+		h *= 0x100000001b3ULL;
+		}
+
+	return h;
+	}
+
+#define JOURNAL_FP_INIT 0xcbf29ce484222325ULL
+#define journal_mix_double(h, d) journal_mix(h, (uint64_t)((d) * 1000))
+
+
+/*
+ * strings are mixed by content, since a freed value's memory is
+ * usually handed straight back to the strdup() that replaces it
+ */
+static uint64_t journal_mix_str(uint64_t h, const char *str) {
+	const unsigned char *p;
+
+	if(str == NULL)
+		return journal_mix(h, ~0ULL);
+
+	for(p = (const unsigned char *)str; *p; p++) {
+		h ^= *p;
+		h *= 0x100000001b3ULL;
+		}
+
+	/* keeps "ab","c" apart from "a","bc" */
+	return journal_mix(h, p - (const unsigned char *)str);
+	}
+
+
+static uint64_t journal_custom_variables_fingerprint(uint64_t h, customvariablesmember *cvlist) {
+	customvariablesmember *temp_customvariablesmember = NULL;
+
+	for(temp_customvariablesmember = cvlist; temp_customvariablesmember != NULL; temp_customvariablesmember = temp_customvariablesmember->next)
+		h = journal_mix_str(h, temp_customvariablesmember->variable_value);
+
+	return h;
+	}
+
+
+static uint64_t journal_program_fingerprint(void) {
+	uint64_t h = JOURNAL_FP_INIT;
+
+	h = journal_mix(h, modified_host_process_attributes);
+	h = journal_mix(h, modified_service_process_attributes);
+	h = journal_mix(h, enable_notifications | (execute_service_checks << 1) | (accept_passive_service_checks << 2) |
+	                (execute_host_checks << 3) | (accept_passive_host_checks << 4) | (enable_event_handlers << 5) |
+	                (obsess_over_services << 6) | (obsess_over_hosts << 7) | (check_service_freshness << 8) |
+	                (check_host_freshness << 9) | (enable_flap_detection << 10) | (process_performance_data << 11));
+	h = journal_mix_str(h, global_host_event_handler);
+	h = journal_mix_str(h, global_service_event_handler);
+
+	return h;
+	}
+
+
+static uint64_t journal_host_fingerprint(host *hst) {
+	uint64_t h = JOURNAL_FP_INIT;
+
+	h = journal_mix(h, hst->current_state | (hst->last_hard_state << 8) | (hst->state_type << 16));
+	h = journal_mix(h, hst->notified_on);
+	h = journal_mix(h, hst->current_notification_number);
+	h = journal_mix(h, hst->problem_has_been_acknowledged | (hst->acknowledgement_type << 1) | (hst->is_flapping << 3));
+	h = journal_mix(h, hst->notifications_enabled | (hst->checks_enabled << 1) | (hst->accept_passive_checks << 2) |
+	                (hst->event_handler_enabled << 3) | (hst->flap_detection_enabled << 4) |
+	                (hst->process_performance_data << 5) | (hst->obsess << 6));
+	h = journal_mix(h, hst->modified_attributes);
+	h = journal_mix(h, hst->max_attempts);
+	h = journal_mix_double(h, hst->check_interval);
+	h = journal_mix_double(h, hst->retry_interval);
+	h = journal_mix_str(h, hst->check_command);
+	h = journal_mix_str(h, hst->check_period);
+	h = journal_mix_str(h, hst->notification_period);
+	h = journal_mix_str(h, hst->event_handler);
+
+	return journal_custom_variables_fingerprint(h, hst->custom_variables);
+	}
+
+
+static uint64_t journal_service_fingerprint(service *svc) {
+	uint64_t h = JOURNAL_FP_INIT;
+
+	h = journal_mix(h, svc->current_state | (svc->last_hard_state << 8) | (svc->state_type << 16));
+	h = journal_mix(h, svc->notified_on);
+	h = journal_mix(h, svc->current_notification_number);
+	h = journal_mix(h, svc->problem_has_been_acknowledged | (svc->acknowledgement_type << 1) | (svc->is_flapping << 3));
+	h = journal_mix(h, svc->notifications_enabled | (svc->checks_enabled << 1) | (svc->accept_passive_checks << 2) |
+	                (svc->event_handler_enabled << 3) | (svc->flap_detection_enabled << 4) |
+	                (svc->process_performance_data << 5) | (svc->obsess << 6));
+	h = journal_mix(h, svc->modified_attributes);
+	h = journal_mix(h, svc->max_attempts);
+	h = journal_mix_double(h, svc->check_interval);
+	h = journal_mix_double(h, svc->retry_interval);
+	h = journal_mix_str(h, svc->check_command);
+	h = journal_mix_str(h, svc->check_period);
+	h = journal_mix_str(h, svc->notification_period);
+	h = journal_mix_str(h, svc->event_handler);
+
+	return journal_custom_variables_fingerprint(h, svc->custom_variables);
+	}
+
+
+static uint64_t journal_contact_fingerprint(contact *cntct) {
+	uint64_t h = JOURNAL_FP_INIT;
+
+	h = journal_mix(h, cntct->modified_attributes);
+	h = journal_mix(h, cntct->modified_host_attributes);
+	h = journal_mix(h, cntct->modified_service_attributes);
+	h = journal_mix(h, cntct->host_notifications_enabled | (cntct->service_notifications_enabled << 1));
+	h = journal_mix_str(h, cntct->host_notification_period);
+	h = journal_mix_str(h, cntct->service_notification_period);
+
+	return journal_custom_variables_fingerprint(h, cntct->custom_variables);
+	}
+
+
+/* starts a new batch, unless we're already in one */
+static void xrddefault_journal_begin(void) {
+
+	if(journal.in_batch == TRUE)
+		return;
+
+	journal.in_batch = TRUE;
+	journal.batches++;
+	fprintf(journal.fp, "journal {\n");
+	fprintf(journal.fp, "seq=%lu\n", ++journal.seq);
+	fprintf(journal.fp, "}\n");
+
+	/* the program block carries the next ids, so every batch gets one */
+	journal.program_fp = journal_program_fingerprint();
+	xrddefault_write_program(journal.fp);
+	journal.records++;
+	}
+
+
+int xrddefault_open_journal(void) {
+	host *temp_host = NULL;
+	service *temp_service = NULL;
+	contact *temp_contact = NULL;
+
+	if(retention_journal == FALSE || journal.fp != NULL)
+		return OK;
+
+	if(xrddefault_journal_path() == NULL)
+		return ERROR;
+
+	if((journal.fp = fopen(journal.path, "a")) == NULL) {
+		logit(NSLOG_RUNTIME_ERROR, TRUE, "Error: Unable to open retention journal '%s': %s\n", journal.path, strerror(errno));
+		return ERROR;
+		}
+	fcntl(fileno(journal.fp), F_SETFD, FD_CLOEXEC);
+
+	journal.num_hosts = num_objects.hosts;
+	journal.num_services = num_objects.services;
+	journal.num_contacts = num_objects.contacts;
+	journal.host_fp = calloc(journal.num_hosts + 1, sizeof(uint64_t));
+	journal.service_fp = calloc(journal.num_services + 1, sizeof(uint64_t));
+	journal.contact_fp = calloc(journal.num_contacts + 1, sizeof(uint64_t));
+	if(journal.host_fp == NULL || journal.service_fp == NULL || journal.contact_fp == NULL) {
+		xrddefault_close_journal();
+		return ERROR;
+		}
+
+	/* only what changes from here on needs journaling */
+	journal.program_fp = journal_program_fingerprint();
+	for(temp_host = host_list; temp_host != NULL; temp_host = temp_host->next)
+		journal.host_fp[temp_host->id] = journal_host_fingerprint(temp_host);
+	for(temp_service = service_list; temp_service != NULL; temp_service = temp_service->next)
+		journal.service_fp[temp_service->id] = journal_service_fingerprint(temp_service);
+	for(temp_contact = contact_list; temp_contact != NULL; temp_contact = temp_contact->next)
+		journal.contact_fp[temp_contact->id] = journal_contact_fingerprint(temp_contact);
+
+	journal.in_batch = FALSE;
+	journal.last_sync = time(NULL);
+
+	log_debug_info(DEBUGL_RETENTIONDATA, 1, "Opened retention journal '%s' at batch %lu\n", journal.path, journal.seq);
+
+	return OK;
+	}
+
+
+int xrddefault_close_journal(void) {
+
+	if(journal.fp != NULL) {
+		fflush(journal.fp);
+		fdatasync(fileno(journal.fp));
+		fclose(journal.fp);
+		journal.fp = NULL;
+		}
+
+	journal.in_batch = FALSE;
+	my_free(journal.host_fp);
+	my_free(journal.service_fp);
+	my_free(journal.contact_fp);
+
+	return OK;
+	}
+
+
+/* called once per pass through the event loop */
+int xrddefault_sync_journal(void) {
+	time_t current_time;
+
+	if(journal.fp == NULL || journal.in_batch == FALSE)
+		return OK;
+
+	/* a crash of our own loses nothing that made it to the kernel */
+	fflush(journal.fp);
+
+	current_time = time(NULL);
+	if(current_time - journal.last_sync < retention_journal_sync_interval)
+		return OK;
+
+	journal.in_batch = FALSE;
+	journal.last_sync = current_time;
+	journal.syncs++;
+	if(fdatasync(fileno(journal.fp)) < 0)
+		logit(NSLOG_RUNTIME_ERROR, TRUE, "Error: Unable to sync retention journal '%s': %s\n", journal.path, strerror(errno));
+
+	return OK;
+	}
+
+
+unsigned long xrddefault_journal_size(void) {
+
+	if(journal.fp == NULL)
+		return 0;
+
+	return (unsigned long)ftello(journal.fp);
+	}
+
+
+void xrddefault_journal_program(void) {
+	uint64_t fp;
+
+	if(journal.fp == NULL)
+		return;
+
+	if((fp = journal_program_fingerprint()) == journal.program_fp)
+		return;
+
+	if(journal.in_batch == TRUE) {
+		journal.program_fp = fp;
+		xrddefault_write_program(journal.fp);
+		journal.records++;
+		}
+	else
+		xrddefault_journal_begin();
+	}
+
+
+void xrddefault_journal_host(host *hst) {
+	uint64_t fp;
+
+	if(journal.fp == NULL || hst->id >= journal.num_hosts)
+		return;
+
+	if((fp = journal_host_fingerprint(hst)) == journal.host_fp[hst->id])
+		return;
+
+	journal.host_fp[hst->id] = fp;
+	xrddefault_journal_begin();
+	xrddefault_write_host(journal.fp, hst);
+	journal.records++;
+	}
+
+
+void xrddefault_journal_service(service *svc) {
+	uint64_t fp;
+
+	if(journal.fp == NULL || svc->id >= journal.num_services)
+		return;
+
+	if((fp = journal_service_fingerprint(svc)) == journal.service_fp[svc->id])
+		return;
+
+	journal.service_fp[svc->id] = fp;
+	xrddefault_journal_begin();
+	xrddefault_write_service(journal.fp, svc);
+	journal.records++;
+	}
+
+
+void xrddefault_journal_contact(contact *cntct) {
+	uint64_t fp;
+
+	if(journal.fp == NULL || cntct->id >= journal.num_contacts)
+		return;
+
+	if((fp = journal_contact_fingerprint(cntct)) == journal.contact_fp[cntct->id])
+		return;
+
+	journal.contact_fp[cntct->id] = fp;
+	xrddefault_journal_begin();
+	xrddefault_write_contact(journal.fp, cntct);
+	journal.records++;
+	}
+
+
+void xrddefault_journal_comment(nagios_comment *temp_comment, int deleted) {
+
+	if(journal.fp == NULL)
+		return;
+
+	xrddefault_journal_begin();
+	if(deleted == TRUE)
+		fprintf(journal.fp, "deletedcomment {\ncomment_id=%lu\n}\n", temp_comment->comment_id);
+	else
+		xrddefault_write_comment(journal.fp, temp_comment);
+	journal.records++;
+	}
+
+
+void xrddefault_journal_downtime(scheduled_downtime *temp_downtime, int deleted) {
+
+	if(journal.fp == NULL)
+		return;
+
+	xrddefault_journal_begin();
+	if(deleted == TRUE)
+		fprintf(journal.fp, "deleteddowntime {\ndowntime_id=%lu\n}\n", temp_downtime->downtime_id);
+	else
+		xrddefault_write_downtime(journal.fp, temp_downtime);
+	journal.records++;
+	}
+
+
+/*
+ * Ends the current batch ahead of a save. Everything in the journal
+ * up to the returned offset will be covered by the save.
+ */
+off_t xrddefault_checkpoint_journal(void) {
+
+	if(journal.fp == NULL)
+		return 0;
+
+	fflush(journal.fp);
+	journal.in_batch = FALSE;
+
+	return ftello(journal.fp);
+	}
+
+
+/* drops what a successful save covered, which is everything up to offset */
+int xrddefault_compact_journal(off_t offset) {
+	char *tmp_path = NULL;
+	char buf[65536];
+	off_t end;
+	ssize_t len;
+	int in_fd, out_fd, result = OK;
+
+	/* don't leave a journal we no longer keep for the next startup */
+	if(journal.fp == NULL) {
+		if(xrddefault_journal_path() != NULL)
+			unlink(journal.path);
+		return OK;
+		}
+
+	fflush(journal.fp);
+	end = ftello(journal.fp);
+
+	/* the usual case: nothing was journaled while we were saving */
+	if(end <= offset) {
+		if(ftruncate(fileno(journal.fp), 0) < 0) {
+			logit(NSLOG_RUNTIME_ERROR, TRUE, "Error: Unable to truncate retention journal '%s': %s\n", journal.path, strerror(errno));
+			return ERROR;
+			}
+		fseeko(journal.fp, 0, SEEK_END);
+		journal.compactions++;
+		return OK;
+		}
+
+	/* otherwise, keep the tail that came in during a background save */
+	asprintf(&tmp_path, "%s.new", journal.path);
+	if(tmp_path == NULL)
+		return ERROR;
+	if((in_fd = open(journal.path, O_RDONLY)) < 0) {
+		my_free(tmp_path);
+		return ERROR;
+		}
+	if((out_fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644)) < 0) {
+		logit(NSLOG_RUNTIME_ERROR, TRUE, "Error: Unable to compact retention journal into '%s': %s\n", tmp_path, strerror(errno));
+		close(in_fd);
+		my_free(tmp_path);
+		return ERROR;
+		}
+
+	lseek(in_fd, offset, SEEK_SET);
+	while((len = read(in_fd, buf, sizeof(buf))) > 0) {
+		if(write(out_fd, buf, len) != len) {
+			result = ERROR;
+			break;
+			}
+		}
+	if(len < 0 || fsync(out_fd) < 0)
+		result = ERROR;
+	close(in_fd);
+	close(out_fd);
+
+	if(result == OK && my_rename(tmp_path, journal.path) == 0) {
+		fclose(journal.fp);
+		if((journal.fp = fopen(journal.path, "a")) == NULL) {
+			logit(NSLOG_RUNTIME_ERROR, TRUE, "Error: Unable to reopen retention journal '%s': %s\n", journal.path, strerror(errno));
+			xrddefault_close_journal();
+			result = ERROR;
+			}
+		else {
+			fcntl(fileno(journal.fp), F_SETFD, FD_CLOEXEC);
+			journal.compactions++;
+			}
+		}
+	else {
+		unlink(tmp_path);
+		logit(NSLOG_RUNTIME_ERROR, TRUE, "Error: Unable to compact retention journal '%s': %s\n", journal.path, strerror(errno));
+		result = ERROR;
+		}
+
+	my_free(tmp_path);
+
+	return result;
+	}
+
+
+void xrddefault_get_journal_stats(struct xrddefault_journal_stats *st) {
+
+	st->enabled = journal.fp != NULL;
+	st->size = xrddefault_journal_size();
+	st->seq = journal.seq;
+	st->records = journal.records;
+	st->batches = journal.batches;
+	st->syncs = journal.syncs;
+	st->compactions = journal.compactions;
+	}
+
+
+
+
 /******************************************************************/
 /***************** DEFAULT STATE INPUT FUNCTION *******************/
 /******************************************************************/
 
+/*
+ * Comments and downtime are journaled whole every time they change, and
+ * when they're deleted. Only the last record of each one counts, so the
+ * journal is scanned for those before anything is read.
+ */
+struct journal_entry {
+	int kind;
+	unsigned long id;
+	unsigned long pos;          /* which comment or downtime block in the journal */
+	unsigned long seq;          /* batch the block is in */
+	};
+
+static struct journal_entry *journal_entries;
+static unsigned long num_journal_entries;
+static unsigned long journal_complete_lines;  /* a crash may have torn the last block */
+
+static int journal_id_compar(const void *p1, const void *p2) {
+	const struct journal_entry *a = p1, *b = p2;
+
+	if(a->kind != b->kind)
+		return a->kind - b->kind;
+	if(a->id != b->id)
+		return a->id < b->id ? -1 : 1;
+	return 0;
+	}
+
+
+static int journal_entry_compar(const void *p1, const void *p2) {
+	const struct journal_entry *a = p1, *b = p2;
+	int result;
+
+	if((result = journal_id_compar(p1, p2)))
+		return result;
+	if(a->pos != b->pos)
+		return a->pos < b->pos ? -1 : 1;
+	return 0;
+	}
+
+
+static struct journal_entry *journal_find_entry(int kind, unsigned long id) {
+	struct journal_entry key;
+
+	if(num_journal_entries == 0)
+		return NULL;
+
+	key.kind = kind;
+	key.id = id;
+	key.pos = 0;
+	key.seq = 0;
+
+	return bsearch(&key, journal_entries, num_journal_entries, sizeof(key), journal_id_compar);
+	}
+
+
+static int journal_block_kind(const char *input) {
+
+	if(!strcmp(input, "hostcomment {") || !strcmp(input, "servicecomment {") || !strcmp(input, "deletedcomment {"))
+		return XRDDEFAULT_HOSTCOMMENT_DATA;
+	if(!strcmp(input, "hostdowntime {") || !strcmp(input, "servicedowntime {") || !strcmp(input, "deleteddowntime {"))
+		return XRDDEFAULT_HOSTDOWNTIME_DATA;
+
+	return XRDDEFAULT_NO_DATA;
+	}
+
+
+static void xrddefault_scan_journal(mmapfile *thefile) {
+	struct journal_entry entry;
+	unsigned long alloc = 0, pos = 0, seq = 0, i, n;
+	char *input = NULL;
+	int in_journal_block = FALSE;
+	int kind;
+
+	memset(&entry, 0, sizeof(entry));
+	num_journal_entries = 0;
+	journal_complete_lines = 0;
+
+	while((input = mmap_fgets(thefile)) != NULL) {
+		strip(input);
+
+		if(!strcmp(input, "journal {"))
+			in_journal_block = TRUE;
+		else if(in_journal_block == TRUE && !strncmp(input, "seq=", 4)) {
+			seq = strtoul(input + 4, NULL, 10);
+			if(seq > journal.seq)
+				journal.seq = seq;
+			}
+		else if((kind = journal_block_kind(input)) != XRDDEFAULT_NO_DATA) {
+			entry.kind = kind;
+			entry.id = 0;
+			entry.pos = pos++;
+			entry.seq = seq;
+			}
+		else if(!strcmp(input, "}")) {
+			journal_complete_lines = thefile->current_line;
+			in_journal_block = FALSE;
+			if(entry.kind != XRDDEFAULT_NO_DATA && entry.id != 0) {
+				if(num_journal_entries == alloc) {
+					alloc = alloc ? alloc * 2 : 256;
+					journal_entries = realloc(journal_entries, alloc * sizeof(entry));
+					if(journal_entries == NULL) {
+						num_journal_entries = 0;
+						my_free(input);
+						return;
+						}
+					}
+				journal_entries[num_journal_entries++] = entry;
+				}
+			entry.kind = XRDDEFAULT_NO_DATA;
+			}
+		else if(entry.kind == XRDDEFAULT_HOSTCOMMENT_DATA && !strncmp(input, "comment_id=", 11))
+			entry.id = strtoul(input + 11, NULL, 10);
+		else if(entry.kind == XRDDEFAULT_HOSTDOWNTIME_DATA && !strncmp(input, "downtime_id=", 12))
+			entry.id = strtoul(input + 12, NULL, 10);
+
+		my_free(input);
+		}
+
+	if(num_journal_entries == 0)
+		return;
+
+	/* keep the last record of each comment and downtime */
+	qsort(journal_entries, num_journal_entries, sizeof(entry), journal_entry_compar);
+	for(i = 0, n = 0; i < num_journal_entries; i++) {
+		if(i + 1 < num_journal_entries && journal_entries[i].kind == journal_entries[i + 1].kind && journal_entries[i].id == journal_entries[i + 1].id)
+			continue;
+		journal_entries[n++] = journal_entries[i];
+		}
+	num_journal_entries = n;
+	}
+
+
+static unsigned long xrddefault_next_id(unsigned long cur, const char *val, int in_journal) {
+	unsigned long id = strtoul(val, NULL, 10);
+
+	return (in_journal == FALSE || id > cur) ? id : cur;
+	}
+
+
+/* whether a comment or downtime block being read has been superseded */
+static int journal_supersedes(int kind, unsigned long id, int in_journal, unsigned long pos) {
+	struct journal_entry *entry = journal_find_entry(kind, id);
+
+	/* only the last record in the journal counts... */
+	if(in_journal == TRUE)
+		return entry == NULL || entry->pos != pos;
+
+	/* ...and it beats the retention file unless the file covers it */
+	return entry != NULL && entry->seq > journal.base_seq;
+	}
+
+
 int xrddefault_read_state_information(void) {
 	char *input = NULL;
 	char *inputbuf = NULL;
@@ -498,6 +1153,12 @@ int xrddefault_read_state_information(void) {
 	int found_directive = FALSE;
 	int is_in_effect = FALSE;
 	int start_notification_sent = FALSE;
+	mmapfile *journal_file = NULL;
+	int in_journal = FALSE;
+	int skip_batch = FALSE;
+	unsigned long batch_seq = 0L;
+	unsigned long block_pos = 0L;
+	unsigned long journal_pos = 0L;
 
 
 	log_debug_info(DEBUGL_FUNCTIONS, 0, "xrddefault_read_state_information() start\n");
@@ -513,9 +1174,24 @@ int xrddefault_read_state_information(void) {
 	if(test_scheduling == TRUE)
 		gettimeofday(&tv[0], NULL);
 
+	/* see which comments and downtime the journal has the last word on */
+	journal.base_seq = 0;
+	if(xrddefault_journal_path() != NULL && (journal_file = mmap_fopen(journal.path)) != NULL) {
+		xrddefault_scan_journal(journal_file);
+		mmap_fclose(journal_file);
+		journal_file = mmap_fopen(journal.path);
+		}
+
 	/* open the retention file for reading */
-	if((thefile = mmap_fopen(retention_file)) == NULL)
-		return ERROR;
+	if((thefile = mmap_fopen(retention_file)) == NULL) {
+		if(journal_file == NULL)
+			return ERROR;
+
+		/* all we have is the journal */
+		thefile = journal_file;
+		journal_file = NULL;
+		in_journal = TRUE;
+		}
 
 	/* what attributes should be masked out? */
 	/* NOTE: host/service/contact-specific values may be added in the future, but for now we only have global masks */
@@ -536,9 +1212,17 @@ int xrddefault_read_state_information(void) {
 		/* free memory */
 		my_free(inputbuf);
 
-		/* read the next line */
-		if((inputbuf = mmap_fgets(thefile)) == NULL)
-			break;
+		/* read the next line, then replay the journal on top */
+		if((inputbuf = mmap_fgets(thefile)) == NULL) {
+			if(journal_file == NULL)
+				break;
+			mmap_fclose(thefile);
+			thefile = journal_file;
+			journal_file = NULL;
+			in_journal = TRUE;
+			data_type = XRDDEFAULT_NO_DATA;
+			continue;
+			}
 
 		input = inputbuf;
 
@@ -548,6 +1232,19 @@ int xrddefault_read_state_information(void) {
 
 		strip(input);
 
+		if(in_journal == TRUE) {
+			if(thefile->current_line > journal_complete_lines)
+				break;
+
+			/* journaled comments and downtime are told apart by position */
+			if(journal_block_kind(input) != XRDDEFAULT_NO_DATA)
+				block_pos = journal_pos++;
+
+			/* batches the retention file already covers are skipped */
+			if(skip_batch == TRUE && data_type != XRDDEFAULT_JOURNAL_DATA && strcmp(input, "journal {"))
+				continue;
+			}
+
 		if(!strcmp(input, "service {"))
 			data_type = XRDDEFAULT_SERVICESTATUS_DATA;
 		else if(!strcmp(input, "host {"))
@@ -566,6 +1263,12 @@ int xrddefault_read_state_information(void) {
 			data_type = XRDDEFAULT_INFO_DATA;
 		else if(!strcmp(input, "program {"))
 			data_type = XRDDEFAULT_PROGRAMSTATUS_DATA;
+		else if(!strcmp(input, "journal {"))
+			data_type = XRDDEFAULT_JOURNAL_DATA;
+		else if(!strcmp(input, "deletedcomment {"))
+			data_type = XRDDEFAULT_DELETEDCOMMENT_DATA;
+		else if(!strcmp(input, "deleteddowntime {"))
+			data_type = XRDDEFAULT_DELETEDDOWNTIME_DATA;
 
 		else if(!strcmp(input, "}")) {
 
@@ -574,6 +1277,10 @@ int xrddefault_read_state_information(void) {
 				case XRDDEFAULT_INFO_DATA:
 					break;
 
+				case XRDDEFAULT_JOURNAL_DATA:
+					skip_batch = (batch_seq <= journal.base_seq) ? TRUE : FALSE;
+					break;
+
 				case XRDDEFAULT_PROGRAMSTATUS_DATA:
 
 					/* adjust modified attributes if necessary */
@@ -751,34 +1458,38 @@ int xrddefault_read_state_information(void) {
 				case XRDDEFAULT_HOSTCOMMENT_DATA:
 				case XRDDEFAULT_SERVICECOMMENT_DATA:
 
-					/* add the comment */
-					add_comment((data_type == XRDDEFAULT_HOSTCOMMENT_DATA) ? HOST_COMMENT : SERVICE_COMMENT, entry_type, host_name, service_description, entry_time, author, comment_data, comment_id, persistent, expires, expire_time, source);
-
-					/* delete the comment if necessary */
-					/* it seems a bit backwards to add and then immediately delete the comment, but its necessary to track comment deletions in the event broker */
-					remove_comment = FALSE;
-					/* host no longer exists */
-					if((temp_host = find_host(host_name)) == NULL)
-						remove_comment = TRUE;
-					/* service no longer exists */
-					else if(data_type == XRDDEFAULT_SERVICECOMMENT_DATA && (temp_service = find_service(host_name, service_description)) == NULL)
-						remove_comment = TRUE;
-					/* acknowledgement comments get deleted if they're not persistent and the original problem is no longer acknowledged */
-					else if(entry_type == ACKNOWLEDGEMENT_COMMENT) {
-						ack = FALSE;
-						if(data_type == XRDDEFAULT_HOSTCOMMENT_DATA)
-							ack = temp_host->problem_has_been_acknowledged;
-						else
-							ack = temp_service->problem_has_been_acknowledged;
-						if(ack == FALSE && persistent == FALSE)
+					/* the journal may have a later copy, or have deleted it */
+					if(journal_supersedes(XRDDEFAULT_HOSTCOMMENT_DATA, comment_id, in_journal, block_pos) == FALSE) {
+
+						/* add the comment */
+						add_comment((data_type == XRDDEFAULT_HOSTCOMMENT_DATA) ? HOST_COMMENT : SERVICE_COMMENT, entry_type, host_name, service_description, entry_time, author, comment_data, comment_id, persistent, expires, expire_time, source);
+
+						/* delete the comment if necessary */
+						/* it seems a bit backwards to add and then immediately delete the comment, but its necessary to track comment deletions in the event broker */
+						remove_comment = FALSE;
+						/* host no longer exists */
+						if((temp_host = find_host(host_name)) == NULL)
+							remove_comment = TRUE;
+						/* service no longer exists */
+						else if(data_type == XRDDEFAULT_SERVICECOMMENT_DATA && (temp_service = find_service(host_name, service_description)) == NULL)
+							remove_comment = TRUE;
+						/* acknowledgement comments get deleted if they're not persistent and the original problem is no longer acknowledged */
+						else if(entry_type == ACKNOWLEDGEMENT_COMMENT) {
+							ack = FALSE;
+							if(data_type == XRDDEFAULT_HOSTCOMMENT_DATA)
+								ack = temp_host->problem_has_been_acknowledged;
+							else
+								ack = temp_service->problem_has_been_acknowledged;
+							if(ack == FALSE && persistent == FALSE)
+								remove_comment = TRUE;
+							}
+						/* non-persistent comments don't last past restarts UNLESS they're acks (see above) */
+						else if(persistent == FALSE && (sigrestart == FALSE || entry_type == DOWNTIME_COMMENT))
 							remove_comment = TRUE;
-						}
-					/* non-persistent comments don't last past restarts UNLESS they're acks (see above) */
-					else if(persistent == FALSE && (sigrestart == FALSE || entry_type == DOWNTIME_COMMENT))
-						remove_comment = TRUE;
 
-					if(remove_comment == TRUE)
-						delete_comment((data_type == XRDDEFAULT_HOSTCOMMENT_DATA) ? HOST_COMMENT : SERVICE_COMMENT, comment_id);
+						if(remove_comment == TRUE)
+							delete_comment((data_type == XRDDEFAULT_HOSTCOMMENT_DATA) ? HOST_COMMENT : SERVICE_COMMENT, comment_id);
+						}
 
 					/* free temp memory */
 					my_free(host_name);
@@ -786,6 +1497,10 @@ int xrddefault_read_state_information(void) {
 					my_free(author);
 					my_free(comment_data);
 
+					/* journaled host and service blocks may follow */
+					temp_host = NULL;
+					temp_service = NULL;
+
 					/* reset defaults */
 					entry_type = USER_COMMENT;
 					comment_id = 0;
@@ -800,14 +1515,18 @@ int xrddefault_read_state_information(void) {
 				case XRDDEFAULT_HOSTDOWNTIME_DATA:
 				case XRDDEFAULT_SERVICEDOWNTIME_DATA:
 
-					/* add the downtime */
-					if(data_type == XRDDEFAULT_HOSTDOWNTIME_DATA)
-						add_host_downtime(host_name, entry_time, author, comment_data, start_time, flex_downtime_start, end_time, fixed, triggered_by, duration, downtime_id, is_in_effect, start_notification_sent);
-					else
-						add_service_downtime(host_name, service_description, entry_time, author, comment_data, start_time, flex_downtime_start, end_time, fixed, triggered_by, duration, downtime_id, is_in_effect, start_notification_sent);
+					/* the journal may have a later copy, or have deleted it */
+					if(journal_supersedes(XRDDEFAULT_HOSTDOWNTIME_DATA, downtime_id, in_journal, block_pos) == FALSE) {
 
-					/* must register the downtime with Nagios so it can schedule it, add comments, etc. */
-					register_downtime((data_type == XRDDEFAULT_HOSTDOWNTIME_DATA) ? HOST_DOWNTIME : SERVICE_DOWNTIME, downtime_id);
+						/* add the downtime */
+						if(data_type == XRDDEFAULT_HOSTDOWNTIME_DATA)
+							add_host_downtime(host_name, entry_time, author, comment_data, start_time, flex_downtime_start, end_time, fixed, triggered_by, duration, downtime_id, is_in_effect, start_notification_sent);
+						else
+							add_service_downtime(host_name, service_description, entry_time, author, comment_data, start_time, flex_downtime_start, end_time, fixed, triggered_by, duration, downtime_id, is_in_effect, start_notification_sent);
+
+						/* must register the downtime with Nagios so it can schedule it, add comments, etc. */
+						register_downtime((data_type == XRDDEFAULT_HOSTDOWNTIME_DATA) ? HOST_DOWNTIME : SERVICE_DOWNTIME, downtime_id);
+						}
 
 					/* free temp memory */
 					my_free(host_name);
@@ -875,6 +1594,16 @@ int xrddefault_read_state_information(void) {
 						}
 					else if(!strcmp(var, "new_version"))
 						new_program_version = (char *)strdup(val);
+					else if(!strcmp(var, "journal_seq")) {
+						journal.base_seq = strtoul(val, NULL, 10);
+						if(journal.base_seq > journal.seq)
+							journal.seq = journal.base_seq;
+						}
+					break;
+
+				case XRDDEFAULT_JOURNAL_DATA:
+					if(!strcmp(var, "seq"))
+						batch_seq = strtoul(val, NULL, 10);
 					break;
 
 				case XRDDEFAULT_PROGRAMSTATUS_DATA:
@@ -973,16 +1702,17 @@ int xrddefault_read_state_information(void) {
 									}
 								}
 							}
+						/* journaled ids are from the start of a batch, so they never go backwards */
 						else if(!strcmp(var, "next_comment_id"))
-							next_comment_id = strtoul(val, NULL, 10);
+							next_comment_id = xrddefault_next_id(next_comment_id, val, in_journal);
 						else if(!strcmp(var, "next_downtime_id"))
-							next_downtime_id = strtoul(val, NULL, 10);
+							next_downtime_id = xrddefault_next_id(next_downtime_id, val, in_journal);
 						else if(!strcmp(var, "next_event_id"))
-							next_event_id = strtoul(val, NULL, 10);
+							next_event_id = xrddefault_next_id(next_event_id, val, in_journal);
 						else if(!strcmp(var, "next_problem_id"))
-							next_problem_id = strtoul(val, NULL, 10);
+							next_problem_id = xrddefault_next_id(next_problem_id, val, in_journal);
 						else if(!strcmp(var, "next_notification_id"))
-							next_notification_id = strtoul(val, NULL, 10);
+							next_notification_id = xrddefault_next_id(next_notification_id, val, in_journal);
 						}
 					break;
 
@@ -992,6 +1722,10 @@ int xrddefault_read_state_information(void) {
 						if(!strcmp(var, "host_name")) {
 							host_name = (char *)strdup(val);
 							temp_host = find_host(host_name);
+
+							/* the notified_on flags are or'ed in, and may be replayed */
+							if(temp_host != NULL)
+								temp_host->notified_on = 0;
 							}
 						}
 					else {
@@ -1142,6 +1876,7 @@ int xrddefault_read_state_information(void) {
 									my_free(tempval);
 
 									if(temp_command != NULL && temp_ptr != NULL) {
+										invalidate_host_check_template(temp_host);
 										my_free(temp_host->check_command);
 										temp_host->check_command = temp_ptr;
 										}
@@ -1277,6 +2012,10 @@ int xrddefault_read_state_information(void) {
 							service_description = (char *)strdup(val);
 							temp_service = find_service(host_name, service_description);
 
+							/* the notified_on flags are or'ed in, and may be replayed */
+							if(temp_service != NULL)
+								temp_service->notified_on = 0;
+
 							/* break out */
 							break;
 							}
@@ -1430,6 +2169,7 @@ int xrddefault_read_state_information(void) {
 									my_free(tempval);
 
 									if(temp_command != NULL && temp_ptr != NULL) {
+										invalidate_service_check_template(temp_service);
 										my_free(temp_service->check_command);
 										temp_service->check_command = temp_ptr;
 										}
@@ -1724,6 +2464,8 @@ int xrddefault_read_state_information(void) {
 	/* free memory and close the file */
 	my_free(inputbuf);
 	mmap_fclose(thefile);
+	my_free(journal_entries);
+	num_journal_entries = 0;
 
 	if(sort_downtime() != OK)
 		return ERROR;
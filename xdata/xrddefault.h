@@ -34,10 +34,37 @@
 #define XRDDEFAULT_SERVICECOMMENT_DATA   7
 #define XRDDEFAULT_HOSTDOWNTIME_DATA     8
 #define XRDDEFAULT_SERVICEDOWNTIME_DATA  9
+#define XRDDEFAULT_JOURNAL_DATA          10
+#define XRDDEFAULT_DELETEDCOMMENT_DATA   11
+#define XRDDEFAULT_DELETEDDOWNTIME_DATA  12
+
+struct xrddefault_journal_stats {
+	int enabled;
+	unsigned long size;
+	unsigned long seq;
+	unsigned long records;
+	unsigned long batches;
+	unsigned long syncs;
+	unsigned long compactions;
+	};
 
 int xrddefault_initialize_retention_data(const char *);
 int xrddefault_cleanup_retention_data(void);
 int xrddefault_save_state_information(void);        /* saves all host and service state information */
 int xrddefault_read_state_information(void);        /* reads in initial host and service state information */
 
+int xrddefault_open_journal(void);
+int xrddefault_close_journal(void);
+int xrddefault_sync_journal(void);                  /* ends the current batch and syncs it every so often */
+unsigned long xrddefault_journal_size(void);
+void xrddefault_journal_program(void);
+void xrddefault_journal_host(host *);
+void xrddefault_journal_service(service *);
+void xrddefault_journal_contact(contact *);
+void xrddefault_journal_comment(nagios_comment *, int);
+void xrddefault_journal_downtime(scheduled_downtime *, int);
+off_t xrddefault_checkpoint_journal(void);          /* ends the current batch before a save */
+int xrddefault_compact_journal(off_t);              /* drops what a save covered */
+void xrddefault_get_journal_stats(struct xrddefault_journal_stats *);
+
 #endif
@@ -60,6 +60,40 @@ int program_stats[MAX_CHECK_STATS_TYPES][3];
 
 #ifdef NSCORE
 
+static char *xsdbin_map = NULL;		/* shared mapping of status_binary_file */
+static int xsdbin_rebuild = FALSE;	/* string heap ran out of space */
+
+#define XSDBIN_ALIGN(x) (((x) + 7) & ~((uint64_t)7))
+#define xsdbin_header() ((struct xsdbin_header *)xsdbin_map)
+
+/* seqlock helpers: readers retry while seq is odd or has changed */
+#define xsdbin_write_begin(seqp) do { (*(volatile uint32_t *)(seqp))++; __sync_synchronize(); } while(0)
+#define xsdbin_write_end(seqp) do { __sync_synchronize(); (*(volatile uint32_t *)(seqp))++; } while(0)
+
+/* pre-rendered text of one host or service status block */
+struct xsdtext_block {
+	char *buf;
+	size_t len;
+	size_t split;			/* where last_update goes */
+	};
+
+static struct xsdtext_block *xsdtext_hosts = NULL;
+static struct xsdtext_block *xsdtext_services = NULL;
+static unsigned int xsdtext_num_hosts = 0;
+static unsigned int xsdtext_num_services = 0;
+
+static struct {
+	unsigned long dumps;
+	unsigned int dirty;		/* objects re-rendered in the last dump */
+	unsigned int clean;		/* objects reused in the last dump */
+	unsigned long long total_dirty;
+	unsigned long long total_clean;
+	} xsdtext_stats;
+
+static void xsdtext_free(void);
+
+
+
 /******************************************************************/
 /********************* INIT/CLEANUP FUNCTIONS *********************/
 /******************************************************************/
@@ -86,6 +120,8 @@ int xsddefault_initialize_status_data(const char *cfgfile) {
 	/* delete the old status log (it might not exist) */
 	if(status_file)
 		unlink(status_file);
+	if(status_binary_file)
+		unlink(status_binary_file);
 
 	return OK;
 	}
@@ -94,6 +130,15 @@ int xsddefault_initialize_status_data(const char *cfgfile) {
 /* cleanup status data before terminating */
 int xsddefault_cleanup_status_data(int delete_status_data) {
 
+	/* object ids may change before we write again */
+	if(xsdbin_map) {
+		munmap(xsdbin_map, xsdbin_header()->file_size);
+		xsdbin_map = NULL;
+		}
+	if(delete_status_data == TRUE && status_binary_file)
+		unlink(status_binary_file);
+	xsdtext_free();
+
 	/* delete the status log */
 	if(delete_status_data == TRUE && status_file) {
 		if(unlink(status_file))
@@ -107,6 +152,762 @@ int xsddefault_cleanup_status_data(int delete_status_data) {
 	}
 
 
+/******************************************************************/
+/*************** BINARY STATUS DATA OUTPUT FUNCTIONS **************/
+/******************************************************************/
+
+/* appends a string to the heap unless it's unchanged */
+static void xsdbin_set_string(struct xsdbin_string *s, const char *str) {
+	struct xsdbin_header *hdr = xsdbin_header();
+	char *heap = xsdbin_map + hdr->heap_offset;
+	size_t len = str ? strlen(str) : 0;
+
+	if(s->length == len && (len == 0 || !memcmp(heap + s->offset, str, len)))
+		return;
+
+	if(len == 0) {
+		s->offset = s->length = 0;
+		return;
+		}
+
+	/* keep the old string until the file is rebuilt */
+	if(hdr->heap_used + len + 1 > hdr->heap_size) {
+		xsdbin_rebuild = TRUE;
+		return;
+		}
+
+	memcpy(heap + hdr->heap_used, str, len + 1);
+	s->offset = (uint32_t)hdr->heap_used;
+	s->length = (uint32_t)len;
+	hdr->heap_used += len + 1;
+	}
+
+
+/* reserves room for an array in the heap, or returns NULL */
+static void *xsdbin_heap_alloc(uint64_t size, uint64_t *offset) {
+	struct xsdbin_header *hdr = xsdbin_header();
+	uint64_t start = XSDBIN_ALIGN(hdr->heap_used);
+
+	if(start + size > hdr->heap_size) {
+		xsdbin_rebuild = TRUE;
+		return NULL;
+		}
+
+	hdr->heap_used = start + size;
+	*offset = start;
+	return xsdbin_map + hdr->heap_offset + start;
+	}
+
+
+static void xsdbin_write_host(host *hst, time_t now) {
+	struct xsdbin_header *hdr = xsdbin_header();
+	struct xsdbin_host *rec = (struct xsdbin_host *)(xsdbin_map + hdr->hosts_offset) + hst->id;
+
+	xsdbin_write_begin(&rec->seq);
+	xsdbin_set_string(&rec->host_name, hst->name);
+	xsdbin_set_string(&rec->plugin_output, hst->plugin_output);
+	xsdbin_set_string(&rec->long_plugin_output, hst->long_plugin_output);
+	xsdbin_set_string(&rec->perf_data, hst->perf_data);
+	rec->last_update = now;
+	rec->last_check = hst->last_check;
+	rec->next_check = hst->next_check;
+	rec->last_state_change = hst->last_state_change;
+	rec->last_hard_state_change = hst->last_hard_state_change;
+	rec->last_time_up = hst->last_time_up;
+	rec->last_time_down = hst->last_time_down;
+	rec->last_time_unreachable = hst->last_time_unreachable;
+	rec->last_notification = hst->last_notification;
+	rec->next_notification = hst->next_notification;
+	rec->percent_state_change = hst->percent_state_change;
+	rec->latency = hst->latency;
+	rec->execution_time = hst->execution_time;
+	rec->status = hst->current_state;
+	rec->has_been_checked = hst->has_been_checked;
+	rec->should_be_scheduled = hst->should_be_scheduled;
+	rec->current_attempt = hst->current_attempt;
+	rec->max_attempts = hst->max_attempts;
+	rec->check_options = hst->check_options;
+	rec->check_type = hst->check_type;
+	rec->last_hard_state = hst->last_hard_state;
+	rec->state_type = hst->state_type;
+	rec->no_more_notifications = hst->no_more_notifications;
+	rec->notifications_enabled = hst->notifications_enabled;
+	rec->problem_has_been_acknowledged = hst->problem_has_been_acknowledged;
+	rec->acknowledgement_type = hst->acknowledgement_type;
+	rec->current_notification_number = hst->current_notification_number;
+	rec->accept_passive_checks = hst->accept_passive_checks;
+	rec->event_handler_enabled = hst->event_handler_enabled;
+	rec->checks_enabled = hst->checks_enabled;
+	rec->flap_detection_enabled = hst->flap_detection_enabled;
+	rec->is_flapping = hst->is_flapping;
+	rec->scheduled_downtime_depth = hst->scheduled_downtime_depth;
+	rec->process_performance_data = hst->process_performance_data;
+	rec->obsess = hst->obsess;
+	xsdbin_write_end(&rec->seq);
+	}
+
+
+static void xsdbin_write_service(service *svc, time_t now) {
+	struct xsdbin_header *hdr = xsdbin_header();
+	struct xsdbin_service *rec = (struct xsdbin_service *)(xsdbin_map + hdr->services_offset) + svc->id;
+
+	xsdbin_write_begin(&rec->seq);
+	xsdbin_set_string(&rec->host_name, svc->host_name);
+	xsdbin_set_string(&rec->description, svc->description);
+	xsdbin_set_string(&rec->plugin_output, svc->plugin_output);
+	xsdbin_set_string(&rec->long_plugin_output, svc->long_plugin_output);
+	xsdbin_set_string(&rec->perf_data, svc->perf_data);
+	rec->last_update = now;
+	rec->last_check = svc->last_check;
+	rec->next_check = svc->next_check;
+	rec->last_state_change = svc->last_state_change;
+	rec->last_hard_state_change = svc->last_hard_state_change;
+	rec->last_time_ok = svc->last_time_ok;
+	rec->last_time_warning = svc->last_time_warning;
+	rec->last_time_unknown = svc->last_time_unknown;
+	rec->last_time_critical = svc->last_time_critical;
+	rec->last_notification = svc->last_notification;
+	rec->next_notification = svc->next_notification;
+	rec->percent_state_change = svc->percent_state_change;
+	rec->latency = svc->latency;
+	rec->execution_time = svc->execution_time;
+	rec->status = svc->current_state;
+	rec->has_been_checked = svc->has_been_checked;
+	rec->should_be_scheduled = svc->should_be_scheduled;
+	rec->current_attempt = svc->current_attempt;
+	rec->max_attempts = svc->max_attempts;
+	rec->check_options = svc->check_options;
+	rec->check_type = svc->check_type;
+	rec->last_hard_state = svc->last_hard_state;
+	rec->state_type = svc->state_type;
+	rec->no_more_notifications = svc->no_more_notifications;
+	rec->notifications_enabled = svc->notifications_enabled;
+	rec->problem_has_been_acknowledged = svc->problem_has_been_acknowledged;
+	rec->acknowledgement_type = svc->acknowledgement_type;
+	rec->current_notification_number = svc->current_notification_number;
+	rec->accept_passive_checks = svc->accept_passive_checks;
+	rec->event_handler_enabled = svc->event_handler_enabled;
+	rec->checks_enabled = svc->checks_enabled;
+	rec->flap_detection_enabled = svc->flap_detection_enabled;
+	rec->is_flapping = svc->is_flapping;
+	rec->scheduled_downtime_depth = svc->scheduled_downtime_depth;
+	rec->process_performance_data = svc->process_performance_data;
+	rec->obsess = svc->obsess;
+	xsdbin_write_end(&rec->seq);
+	}
+
+
+/* have any comments been added, removed or changed since we last wrote them? */
+static int xsdbin_comments_changed(void) {
+	struct xsdbin_header *hdr = xsdbin_header();
+	struct xsdbin_comment *rec;
+	nagios_comment *temp_comment = NULL;
+	uint64_t x = 0;
+
+	rec = (struct xsdbin_comment *)(xsdbin_map + hdr->heap_offset + hdr->comments_offset);
+	for(temp_comment = comment_list; temp_comment != NULL; temp_comment = temp_comment->next, x++) {
+		if(x >= hdr->num_comments || rec[x].comment_id != temp_comment->comment_id)
+			return TRUE;
+		}
+
+	return x != hdr->num_comments;
+	}
+
+
+static int xsdbin_downtimes_changed(void) {
+	struct xsdbin_header *hdr = xsdbin_header();
+	struct xsdbin_downtime *rec;
+	scheduled_downtime *temp_downtime = NULL;
+	uint64_t x = 0;
+
+	rec = (struct xsdbin_downtime *)(xsdbin_map + hdr->heap_offset + hdr->downtimes_offset);
+	for(temp_downtime = scheduled_downtime_list; temp_downtime != NULL; temp_downtime = temp_downtime->next, x++) {
+		if(x >= hdr->num_downtimes
+		   || rec[x].downtime_id != temp_downtime->downtime_id
+		   || rec[x].comment_id != temp_downtime->comment_id
+		   || rec[x].flex_downtime_start != temp_downtime->flex_downtime_start
+		   || rec[x].is_in_effect != temp_downtime->is_in_effect
+		   || rec[x].start_notification_sent != temp_downtime->start_notification_sent)
+			return TRUE;
+		}
+
+	return x != hdr->num_downtimes;
+	}
+
+
+/* writes comments and downtime to the heap, if they've changed. Caller holds the header seq */
+static void xsdbin_write_comments_and_downtime(void) {
+	struct xsdbin_header *hdr = xsdbin_header();
+	struct xsdbin_comment *crec;
+	struct xsdbin_downtime *drec;
+	nagios_comment *temp_comment = NULL;
+	scheduled_downtime *temp_downtime = NULL;
+	uint64_t count, offset;
+
+	if(xsdbin_comments_changed()) {
+		for(count = 0, temp_comment = comment_list; temp_comment != NULL; temp_comment = temp_comment->next)
+			count++;
+
+		if((crec = xsdbin_heap_alloc(count * sizeof(*crec), &offset)) != NULL) {
+			memset(crec, 0, count * sizeof(*crec));
+			for(temp_comment = comment_list; temp_comment != NULL; temp_comment = temp_comment->next, crec++) {
+				xsdbin_set_string(&crec->host_name, temp_comment->host_name);
+				xsdbin_set_string(&crec->service_description, temp_comment->service_description);
+				xsdbin_set_string(&crec->author, temp_comment->author);
+				xsdbin_set_string(&crec->comment_data, temp_comment->comment_data);
+				crec->comment_id = temp_comment->comment_id;
+				crec->entry_time = temp_comment->entry_time;
+				crec->expire_time = temp_comment->expire_time;
+				crec->comment_type = temp_comment->comment_type;
+				crec->entry_type = temp_comment->entry_type;
+				crec->source = temp_comment->source;
+				crec->persistent = temp_comment->persistent;
+				crec->expires = temp_comment->expires;
+				}
+			hdr->comments_offset = offset;
+			hdr->num_comments = count;
+			}
+		}
+
+	if(xsdbin_downtimes_changed()) {
+		for(count = 0, temp_downtime = scheduled_downtime_list; temp_downtime != NULL; temp_downtime = temp_downtime->next)
+			count++;
+
+		if((drec = xsdbin_heap_alloc(count * sizeof(*drec), &offset)) != NULL) {
+			memset(drec, 0, count * sizeof(*drec));
+			for(temp_downtime = scheduled_downtime_list; temp_downtime != NULL; temp_downtime = temp_downtime->next, drec++) {
+				xsdbin_set_string(&drec->host_name, temp_downtime->host_name);
+				xsdbin_set_string(&drec->service_description, temp_downtime->service_description);
+				xsdbin_set_string(&drec->author, temp_downtime->author);
+				xsdbin_set_string(&drec->comment, temp_downtime->comment);
+				drec->downtime_id = temp_downtime->downtime_id;
+				drec->comment_id = temp_downtime->comment_id;
+				drec->triggered_by = temp_downtime->triggered_by;
+				drec->duration = temp_downtime->duration;
+				drec->entry_time = temp_downtime->entry_time;
+				drec->start_time = temp_downtime->start_time;
+				drec->flex_downtime_start = temp_downtime->flex_downtime_start;
+				drec->end_time = temp_downtime->end_time;
+				drec->type = temp_downtime->type;
+				drec->fixed = temp_downtime->fixed;
+				drec->is_in_effect = temp_downtime->is_in_effect;
+				drec->start_notification_sent = temp_downtime->start_notification_sent;
+				}
+			hdr->downtimes_offset = offset;
+			hdr->num_downtimes = count;
+			}
+		}
+	}
+
+
+static void xsdbin_write_program_status(time_t now) {
+	struct xsdbin_header *hdr = xsdbin_header();
+	int x;
+
+	xsdbin_write_begin(&hdr->seq);
+	xsdbin_write_comments_and_downtime();
+	hdr->last_update = now;
+	hdr->program_start = program_start;
+	hdr->last_log_rotation = last_log_rotation;
+	hdr->nagios_pid = nagios_pid;
+	hdr->daemon_mode = daemon_mode;
+	hdr->enable_notifications = enable_notifications;
+	hdr->execute_service_checks = execute_service_checks;
+	hdr->accept_passive_service_checks = accept_passive_service_checks;
+	hdr->execute_host_checks = execute_host_checks;
+	hdr->accept_passive_host_checks = accept_passive_host_checks;
+	hdr->enable_event_handlers = enable_event_handlers;
+	hdr->obsess_over_services = obsess_over_services;
+	hdr->obsess_over_hosts = obsess_over_hosts;
+	hdr->check_service_freshness = check_service_freshness;
+	hdr->check_host_freshness = check_host_freshness;
+	hdr->enable_flap_detection = enable_flap_detection;
+	hdr->process_performance_data = process_performance_data;
+	for(x = 0; x < MAX_CHECK_STATS_TYPES; x++) {
+		hdr->check_stats[x][0] = check_statistics[x].minute_stats[0];
+		hdr->check_stats[x][1] = check_statistics[x].minute_stats[1];
+		hdr->check_stats[x][2] = check_statistics[x].minute_stats[2];
+		}
+	xsdbin_write_end(&hdr->seq);
+	}
+
+
+/* writes a fresh binary status file and maps it */
+static int xsdbin_create(time_t now) {
+	struct xsdbin_header *hdr = NULL;
+	host *temp_host = NULL;
+	service *temp_service = NULL;
+	nagios_comment *temp_comment = NULL;
+	scheduled_downtime *temp_downtime = NULL;
+	char *tmp_file = NULL;
+	char *map = NULL;
+	uint64_t strings = 0, hosts_size, services_size, heap_size, file_size;
+	int fd = -1;
+
+#define xsdbin_strlen(s) ((s) ? strlen(s) + 1 : 0)
+	for(temp_host = host_list; temp_host != NULL; temp_host = temp_host->next)
+		strings += xsdbin_strlen(temp_host->name) + xsdbin_strlen(temp_host->plugin_output) + xsdbin_strlen(temp_host->long_plugin_output) + xsdbin_strlen(temp_host->perf_data);
+	for(temp_service = service_list; temp_service != NULL; temp_service = temp_service->next)
+		strings += xsdbin_strlen(temp_service->host_name) + xsdbin_strlen(temp_service->description) + xsdbin_strlen(temp_service->plugin_output) + xsdbin_strlen(temp_service->long_plugin_output) + xsdbin_strlen(temp_service->perf_data);
+	for(temp_comment = comment_list; temp_comment != NULL; temp_comment = temp_comment->next)
+		strings += sizeof(struct xsdbin_comment) + xsdbin_strlen(temp_comment->host_name) + xsdbin_strlen(temp_comment->service_description) + xsdbin_strlen(temp_comment->author) + xsdbin_strlen(temp_comment->comment_data);
+	for(temp_downtime = scheduled_downtime_list; temp_downtime != NULL; temp_downtime = temp_downtime->next)
+		strings += sizeof(struct xsdbin_downtime) + xsdbin_strlen(temp_downtime->host_name) + xsdbin_strlen(temp_downtime->service_description) + xsdbin_strlen(temp_downtime->author) + xsdbin_strlen(temp_downtime->comment);
+#undef xsdbin_strlen
+
+	/* leave plenty of room for output to change before we have to rebuild */
+	heap_size = XSDBIN_ALIGN(strings * 4 + 1024 * 1024);
+	if(heap_size > UINT32_MAX)
+		heap_size = UINT32_MAX & ~7;
+	hosts_size = XSDBIN_ALIGN((uint64_t)num_objects.hosts * sizeof(struct xsdbin_host));
+	services_size = XSDBIN_ALIGN((uint64_t)num_objects.services * sizeof(struct xsdbin_service));
+	file_size = XSDBIN_ALIGN(sizeof(struct xsdbin_header)) + hosts_size + services_size + heap_size;
+
+	asprintf(&tmp_file, "%sXXXXXX", temp_file);
+	if(tmp_file == NULL)
+		return ERROR;
+
+	if((fd = mkstemp(tmp_file)) == -1) {
+		logit(NSLOG_RUNTIME_ERROR, TRUE, "Error: Unable to create temp file '%s' for writing binary status data: %s\n", tmp_file, strerror(errno));
+		my_free(tmp_file);
+		return ERROR;
+		}
+
+	if(ftruncate(fd, file_size) < 0 || (map = mmap(NULL, file_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) == MAP_FAILED) {
+		logit(NSLOG_RUNTIME_ERROR, TRUE, "Error: Unable to map temp file '%s' for writing binary status data: %s\n", tmp_file, strerror(errno));
+		close(fd);
+		unlink(tmp_file);
+		my_free(tmp_file);
+		return ERROR;
+		}
+
+	fchmod(fd, S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH);
+	close(fd);
+
+	/* the new file is complete before anyone can see it, so no need for seq here */
+	hdr = (struct xsdbin_header *)map;
+	memcpy(hdr->magic, XSDBIN_MAGIC, sizeof(XSDBIN_MAGIC));
+	hdr->version = XSDBIN_VERSION;
+	hdr->header_size = sizeof(struct xsdbin_header);
+	hdr->host_size = sizeof(struct xsdbin_host);
+	hdr->service_size = sizeof(struct xsdbin_service);
+	hdr->comment_size = sizeof(struct xsdbin_comment);
+	hdr->downtime_size = sizeof(struct xsdbin_downtime);
+	hdr->num_hosts = num_objects.hosts;
+	hdr->num_services = num_objects.services;
+	hdr->hosts_offset = XSDBIN_ALIGN(sizeof(struct xsdbin_header));
+	hdr->services_offset = hdr->hosts_offset + hosts_size;
+	hdr->heap_offset = hdr->services_offset + services_size;
+	hdr->heap_size = heap_size;
+	hdr->heap_used = 0;
+	hdr->file_size = file_size;
+	hdr->created = now;
+
+	/* switch over to the new map and fill it in */
+	if(xsdbin_map)
+		munmap(xsdbin_map, xsdbin_header()->file_size);
+	xsdbin_map = map;
+	xsdbin_rebuild = FALSE;
+
+	xsdbin_write_program_status(now);
+	for(temp_host = host_list; temp_host != NULL; temp_host = temp_host->next)
+		xsdbin_write_host(temp_host, now);
+	for(temp_service = service_list; temp_service != NULL; temp_service = temp_service->next)
+		xsdbin_write_service(temp_service, now);
+
+	if(my_rename(tmp_file, status_binary_file)) {
+		logit(NSLOG_RUNTIME_ERROR, TRUE, "Error: Unable to update binary status data file '%s': %s", status_binary_file, strerror(errno));
+		unlink(tmp_file);
+		munmap(xsdbin_map, file_size);
+		xsdbin_map = NULL;
+		my_free(tmp_file);
+		return ERROR;
+		}
+
+	my_free(tmp_file);
+	return OK;
+	}
+
+
+/*
+ * brings the binary status file up to date, rebuilding it if needed.
+ * Host and service records are written in place as their status is
+ * updated, so all that's left here is program status, comments and
+ * downtime.
+ */
+static int xsdbin_save_status_data(void) {
+	struct xsdbin_header *hdr = xsdbin_header();
+	time_t now = time(NULL);
+
+	if(xsdbin_map == NULL || xsdbin_rebuild == TRUE || hdr->num_hosts != num_objects.hosts || hdr->num_services != num_objects.services)
+		return xsdbin_create(now);
+
+	xsdbin_write_program_status(now);
+
+	/* the heap filled up along the way */
+	if(xsdbin_rebuild == TRUE)
+		return xsdbin_create(now);
+
+	return OK;
+	}
+
+
+
+/******************************************************************/
+/***************** INCREMENTAL STATUS TEXT FUNCTIONS **************/
+/******************************************************************/
+
+/*
+ * Host and service status blocks are rendered once and kept around
+ * until update_host_status() or update_service_status() marks the
+ * object dirty, so a dump only re-renders what changed since the
+ * last one. last_update is the time of the dump rather than a
+ * property of the object, so it's left out of the cached text and
+ * written between the two halves of each block.
+ */
+
+/* writes the part of a host status block that precedes last_update */
+static void xsdtext_host_head(FILE *fp, host *hst) {
+
+	fprintf(fp, "hoststatus {\n");
+	fprintf(fp, "\thost_name=%s\n", hst->name);
+
+	fprintf(fp, "\tmodified_attributes=%lu\n", hst->modified_attributes);
+	fprintf(fp, "\tcheck_command=%s\n", (hst->check_command == NULL) ? "" : hst->check_command);
+	fprintf(fp, "\tcheck_period=%s\n", (hst->check_period == NULL) ? "" : hst->check_period);
+	fprintf(fp, "\tnotification_period=%s\n", (hst->notification_period == NULL) ? "" : hst->notification_period);
+	fprintf(fp, "\timportance=%u\n", hst->hourly_value);
+	fprintf(fp, "\tcheck_interval=%f\n", hst->check_interval);
+	fprintf(fp, "\tretry_interval=%f\n", hst->retry_interval);
+	fprintf(fp, "\tevent_handler=%s\n", (hst->event_handler == NULL) ? "" : hst->event_handler);
+	fprintf(fp, "\tevent_handler_period=%s\n", (hst->event_handler_period == NULL) ? "" : hst->event_handler_period);
+
+	fprintf(fp, "\thas_been_checked=%d\n", hst->has_been_checked);
+	fprintf(fp, "\tshould_be_scheduled=%d\n", hst->should_be_scheduled);
+	fprintf(fp, "\tcheck_execution_time=%.3f\n", hst->execution_time);
+	fprintf(fp, "\tcheck_latency=%.3f\n", hst->latency);
+	fprintf(fp, "\tcheck_type=%d\n", hst->check_type);
+	fprintf(fp, "\tcurrent_state=%d\n", hst->current_state);
+	fprintf(fp, "\tlast_hard_state=%d\n", hst->last_hard_state);
+	fprintf(fp, "\tlast_event_id=%lu\n", hst->last_event_id);
+	fprintf(fp, "\tcurrent_event_id=%lu\n", hst->current_event_id);
+	fprintf(fp, "\tcurrent_problem_id=%lu\n", hst->current_problem_id);
+	fprintf(fp, "\tlast_problem_id=%lu\n", hst->last_problem_id);
+	fprintf(fp, "\tplugin_output=%s\n", (hst->plugin_output == NULL) ? "" : hst->plugin_output);
+	fprintf(fp, "\tlong_plugin_output=%s\n", (hst->long_plugin_output == NULL) ? "" : hst->long_plugin_output);
+	fprintf(fp, "\tperformance_data=%s\n", (hst->perf_data == NULL) ? "" : hst->perf_data);
+	fprintf(fp, "\tlast_check=%llu\n", (unsigned long long)hst->last_check);
+	fprintf(fp, "\tnext_check=%llu\n", (unsigned long long)hst->next_check);
+	fprintf(fp, "\tcheck_options=%d\n", hst->check_options);
+	fprintf(fp, "\tcurrent_attempt=%d\n", hst->current_attempt);
+	fprintf(fp, "\tmax_attempts=%d\n", hst->max_attempts);
+	fprintf(fp, "\tstate_type=%d\n", hst->state_type);
+	fprintf(fp, "\tlast_state_change=%llu\n", (unsigned long long)hst->last_state_change);
+	fprintf(fp, "\tlast_hard_state_change=%llu\n", (unsigned long long)hst->last_hard_state_change);
+	fprintf(fp, "\tlast_time_up=%llu\n", (unsigned long long)hst->last_time_up);
+	fprintf(fp, "\tlast_time_down=%llu\n", (unsigned long long)hst->last_time_down);
+	fprintf(fp, "\tlast_time_unreachable=%llu\n", (unsigned long long)hst->last_time_unreachable);
+	fprintf(fp, "\tlast_notification=%llu\n", (unsigned long long)hst->last_notification);
+	fprintf(fp, "\tnext_notification=%llu\n", (unsigned long long)hst->next_notification);
+	fprintf(fp, "\tno_more_notifications=%d\n", hst->no_more_notifications);
+	fprintf(fp, "\tcurrent_notification_number=%d\n", hst->current_notification_number);
+	fprintf(fp, "\tcurrent_notification_id=%lu\n", hst->current_notification_id);
+	fprintf(fp, "\tnotifications_enabled=%d\n", hst->notifications_enabled);
+	fprintf(fp, "\tproblem_has_been_acknowledged=%d\n", hst->problem_has_been_acknowledged);
+	fprintf(fp, "\tacknowledgement_type=%d\n", hst->acknowledgement_type);
+	fprintf(fp, "\tactive_checks_enabled=%d\n", hst->checks_enabled);
+	fprintf(fp, "\tpassive_checks_enabled=%d\n", hst->accept_passive_checks);
+	fprintf(fp, "\tevent_handler_enabled=%d\n", hst->event_handler_enabled);
+	fprintf(fp, "\tflap_detection_enabled=%d\n", hst->flap_detection_enabled);
+	fprintf(fp, "\tprocess_performance_data=%d\n", hst->process_performance_data);
+	fprintf(fp, "\tobsess=%d\n", hst->obsess);
+	}
+
+
+/* writes the part of a host status block that follows last_update */
+static void xsdtext_host_tail(FILE *fp, host *hst) {
+	customvariablesmember *temp_customvariablesmember = NULL;
+
+	fprintf(fp, "\tis_flapping=%d\n", hst->is_flapping);
+	fprintf(fp, "\tpercent_state_change=%.2f\n", hst->percent_state_change);
+	fprintf(fp, "\tscheduled_downtime_depth=%d\n", hst->scheduled_downtime_depth);
+	/* custom variables */
+	for(temp_customvariablesmember = hst->custom_variables; temp_customvariablesmember != NULL; temp_customvariablesmember = temp_customvariablesmember->next) {
+		if(temp_customvariablesmember->variable_name)
+			fprintf(fp, "\t_%s=%d;%s\n", temp_customvariablesmember->variable_name, temp_customvariablesmember->has_been_modified, (temp_customvariablesmember->variable_value == NULL) ? "" : temp_customvariablesmember->variable_value);
+		}
+	fprintf(fp, "\t}\n\n");
+	}
+
+
+/* writes the part of a service status block that precedes last_update */
+static void xsdtext_service_head(FILE *fp, service *svc) {
+
+	fprintf(fp, "servicestatus {\n");
+	fprintf(fp, "\thost_name=%s\n", svc->host_name);
+
+	fprintf(fp, "\tservice_description=%s\n", svc->description);
+	fprintf(fp, "\tmodified_attributes=%lu\n", svc->modified_attributes);
+	fprintf(fp, "\tcheck_command=%s\n", (svc->check_command == NULL) ? "" : svc->check_command);
+	fprintf(fp, "\tcheck_period=%s\n", (svc->check_period == NULL) ? "" : svc->check_period);
+	fprintf(fp, "\tnotification_period=%s\n", (svc->notification_period == NULL) ? "" : svc->notification_period);
+	fprintf(fp, "\timportance=%u\n", svc->hourly_value);
+	fprintf(fp, "\tcheck_interval=%f\n", svc->check_interval);
+	fprintf(fp, "\tretry_interval=%f\n", svc->retry_interval);
+	fprintf(fp, "\tevent_handler=%s\n", (svc->event_handler == NULL) ? "" : svc->event_handler);
+	fprintf(fp, "\tevent_handler_period=%s\n", (svc->event_handler_period == NULL) ? "" : svc->event_handler_period);
+
+	fprintf(fp, "\thas_been_checked=%d\n", svc->has_been_checked);
+	fprintf(fp, "\tshould_be_scheduled=%d\n", svc->should_be_scheduled);
+	fprintf(fp, "\tcheck_execution_time=%.3f\n", svc->execution_time);
+	fprintf(fp, "\tcheck_latency=%.3f\n", svc->latency);
+	fprintf(fp, "\tcheck_type=%d\n", svc->check_type);
+	fprintf(fp, "\tcurrent_state=%d\n", svc->current_state);
+	fprintf(fp, "\tlast_hard_state=%d\n", svc->last_hard_state);
+	fprintf(fp, "\tlast_event_id=%lu\n", svc->last_event_id);
+	fprintf(fp, "\tcurrent_event_id=%lu\n", svc->current_event_id);
+	fprintf(fp, "\tcurrent_problem_id=%lu\n", svc->current_problem_id);
+	fprintf(fp, "\tlast_problem_id=%lu\n", svc->last_problem_id);
+	fprintf(fp, "\tcurrent_attempt=%d\n", svc->current_attempt);
+	fprintf(fp, "\tmax_attempts=%d\n", svc->max_attempts);
+	fprintf(fp, "\tstate_type=%d\n", svc->state_type);
+	fprintf(fp, "\tlast_state_change=%llu\n", (unsigned long long)svc->last_state_change);
+	fprintf(fp, "\tlast_hard_state_change=%llu\n", (unsigned long long)svc->last_hard_state_change);
+	fprintf(fp, "\tlast_time_ok=%llu\n", (unsigned long long)svc->last_time_ok);
+	fprintf(fp, "\tlast_time_warning=%llu\n", (unsigned long long)svc->last_time_warning);
+	fprintf(fp, "\tlast_time_unknown=%llu\n", (unsigned long long)svc->last_time_unknown);
+	fprintf(fp, "\tlast_time_critical=%llu\n", (unsigned long long)svc->last_time_critical);
+	fprintf(fp, "\tplugin_output=%s\n", (svc->plugin_output == NULL) ? "" : svc->plugin_output);
+	fprintf(fp, "\tlong_plugin_output=%s\n", (svc->long_plugin_output == NULL) ? "" : svc->long_plugin_output);
+	fprintf(fp, "\tperformance_data=%s\n", (svc->perf_data == NULL) ? "" : svc->perf_data);
+	fprintf(fp, "\tlast_check=%llu\n", (unsigned long long)svc->last_check);
+	fprintf(fp, "\tnext_check=%llu\n", (unsigned long long)svc->next_check);
+	fprintf(fp, "\tcheck_options=%d\n", svc->check_options);
+	fprintf(fp, "\tcurrent_notification_number=%d\n", svc->current_notification_number);
+	fprintf(fp, "\tcurrent_notification_id=%lu\n", svc->current_notification_id);
+	fprintf(fp, "\tlast_notification=%llu\n", (unsigned long long)svc->last_notification);
+	fprintf(fp, "\tnext_notification=%llu\n", (unsigned long long)svc->next_notification);
+	fprintf(fp, "\tno_more_notifications=%d\n", svc->no_more_notifications);
+	fprintf(fp, "\tnotifications_enabled=%d\n", svc->notifications_enabled);
+	fprintf(fp, "\tactive_checks_enabled=%d\n", svc->checks_enabled);
+	fprintf(fp, "\tpassive_checks_enabled=%d\n", svc->accept_passive_checks);
+	fprintf(fp, "\tevent_handler_enabled=%d\n", svc->event_handler_enabled);
+	fprintf(fp, "\tproblem_has_been_acknowledged=%d\n", svc->problem_has_been_acknowledged);
+	fprintf(fp, "\tacknowledgement_type=%d\n", svc->acknowledgement_type);
+	fprintf(fp, "\tflap_detection_enabled=%d\n", svc->flap_detection_enabled);
+	fprintf(fp, "\tprocess_performance_data=%d\n", svc->process_performance_data);
+	fprintf(fp, "\tobsess=%d\n", svc->obsess);
+	}
+
+
+/* writes the part of a service status block that follows last_update */
+static void xsdtext_service_tail(FILE *fp, service *svc) {
+	customvariablesmember *temp_customvariablesmember = NULL;
+
+	fprintf(fp, "\tis_flapping=%d\n", svc->is_flapping);
+	fprintf(fp, "\tpercent_state_change=%.2f\n", svc->percent_state_change);
+	fprintf(fp, "\tscheduled_downtime_depth=%d\n", svc->scheduled_downtime_depth);
+	/* custom variables */
+	for(temp_customvariablesmember = svc->custom_variables; temp_customvariablesmember != NULL; temp_customvariablesmember = temp_customvariablesmember->next) {
+		if(temp_customvariablesmember->variable_name)
+			fprintf(fp, "\t_%s=%d;%s\n", temp_customvariablesmember->variable_name, temp_customvariablesmember->has_been_modified, (temp_customvariablesmember->variable_value == NULL) ? "" : temp_customvariablesmember->variable_value);
+		}
+	fprintf(fp, "\t}\n\n");
+	}
+
+
+/* releases all pre-rendered status text */
+static void xsdtext_free(void) {
+	unsigned int i;
+
+	for(i = 0; xsdtext_hosts && i < xsdtext_num_hosts; i++)
+		my_free(xsdtext_hosts[i].buf);
+	for(i = 0; xsdtext_services && i < xsdtext_num_services; i++)
+		my_free(xsdtext_services[i].buf);
+	my_free(xsdtext_hosts);
+	my_free(xsdtext_services);
+	xsdtext_num_hosts = 0;
+	xsdtext_num_services = 0;
+	}
+
+
+/*
+ * (re)allocates the text caches for the current set of objects. Which
+ * objects have changed since the last dump is tracked by the core, in
+ * the object state arrays, so we can't cache anything without those.
+ */
+static int xsdtext_setup(void) {
+
+	if(host_state_ary.size != num_objects.hosts || service_state_ary.size != num_objects.services)
+		return ERROR;
+
+	if(xsdtext_hosts != NULL && xsdtext_num_hosts == num_objects.hosts && xsdtext_num_services == num_objects.services)
+		return OK;
+
+	xsdtext_free();
+
+	/* one extra entry so we never ask for zero bytes */
+	xsdtext_hosts = calloc(num_objects.hosts + 1, sizeof(struct xsdtext_block));
+	xsdtext_services = calloc(num_objects.services + 1, sizeof(struct xsdtext_block));
+	if(!xsdtext_hosts || !xsdtext_services) {
+		xsdtext_free();
+		return ERROR;
+		}
+
+	xsdtext_num_hosts = num_objects.hosts;
+	xsdtext_num_services = num_objects.services;
+
+	return OK;
+	}
+
+
+/*
+ * renders the block for either hst or svc into blk through a memory
+ * stream, leaving a gap for last_update at blk->split
+ */
+static int xsdtext_render(struct xsdtext_block *blk, host *hst, service *svc) {
+	FILE *mp;
+	char *buf = NULL;
+	size_t len = 0;
+	long split;
+
+	if((mp = open_memstream(&buf, &len)) == NULL)
+		return ERROR;
+	if(hst)
+		xsdtext_host_head(mp, hst);
+	else
+		xsdtext_service_head(mp, svc);
+	split = ftell(mp);
+	if(hst)
+		xsdtext_host_tail(mp, hst);
+	else
+		xsdtext_service_tail(mp, svc);
+	if(fclose(mp) || split < 0) {
+		free(buf);
+		return ERROR;
+		}
+
+	my_free(blk->buf);
+	blk->buf = buf;
+	blk->len = len;
+	blk->split = (size_t)split;
+
+	return OK;
+	}
+
+
+/*
+ * writes the block for either hst or svc, re-rendering it first if
+ * it's dirty. Without a cache (out of memory) it's written directly.
+ */
+static void xsdtext_write_object(FILE *fp, struct xsdtext_block *blk, unsigned char *flags, host *hst, service *svc, time_t now) {
+
+	if(blk != NULL && blk->buf != NULL && !(*flags & OBJSTATE_STATUS_DIRTY))
+		xsdtext_stats.clean++;
+	else {
+		xsdtext_stats.dirty++;
+		if(blk != NULL && xsdtext_render(blk, hst, svc) == OK)
+			*flags &= ~OBJSTATE_STATUS_DIRTY;
+		else
+			blk = NULL;
+		}
+
+	if(blk == NULL) {
+		if(hst)
+			xsdtext_host_head(fp, hst);
+		else
+			xsdtext_service_head(fp, svc);
+		fprintf(fp, "\tlast_update=%llu\n", (unsigned long long)now);
+		if(hst)
+			xsdtext_host_tail(fp, hst);
+		else
+			xsdtext_service_tail(fp, svc);
+		return;
+		}
+
+	fwrite(blk->buf, 1, blk->split, fp);
+	fprintf(fp, "\tlast_update=%llu\n", (unsigned long long)now);
+	fwrite(blk->buf + blk->split, 1, blk->len - blk->split, fp);
+	}
+
+
+/* writes all host and service blocks, re-rendering the dirty ones */
+static void xsdtext_write_hosts_and_services(FILE *fp, time_t now) {
+	unsigned int i;
+	int cached;
+
+	cached = (xsdtext_setup() == OK);
+
+	xsdtext_stats.dirty = 0;
+	xsdtext_stats.clean = 0;
+
+	/*
+	 * walk the object state arrays by id, so clean objects are written
+	 * straight from the id-indexed caches without touching the objects
+	 */
+	for(i = 0; i < num_objects.hosts; i++) {
+		if(cached == TRUE)
+			xsdtext_write_object(fp, &xsdtext_hosts[i], &host_state_ary.flags[i], host_ary[i], NULL, now);
+		else
+			xsdtext_write_object(fp, NULL, NULL, host_ary[i], NULL, now);
+		}
+
+	for(i = 0; i < num_objects.services; i++) {
+		if(cached == TRUE)
+			xsdtext_write_object(fp, &xsdtext_services[i], &service_state_ary.flags[i], NULL, service_ary[i], now);
+		else
+			xsdtext_write_object(fp, NULL, NULL, NULL, service_ary[i], now);
+		}
+
+	xsdtext_stats.dumps++;
+	xsdtext_stats.total_dirty += xsdtext_stats.dirty;
+	xsdtext_stats.total_clean += xsdtext_stats.clean;
+
+	log_debug_info(DEBUGL_STATUSDATA, 1, "Status dump %lu: %u dirty objects re-rendered, %u clean objects reused\n", xsdtext_stats.dumps, xsdtext_stats.dirty, xsdtext_stats.clean);
+	}
+
+
+/* prints incremental status dump statistics to a query handler socket */
+int xsddefault_dump_stats(int sd) {
+
+	nsock_printf_nul(sd, "dumps=%lu;dirty=%u;clean=%u;total_dirty=%llu;total_clean=%llu;",
+		xsdtext_stats.dumps, xsdtext_stats.dirty, xsdtext_stats.clean,
+		xsdtext_stats.total_dirty, xsdtext_stats.total_clean);
+
+	return 0;
+	}
+
+
+
+/******************************************************************/
+/*********************** STATUS UPDATE HOOKS **********************/
+/******************************************************************/
+
+/* updates a host's binary record in place */
+int xsddefault_update_host_status(host *hst) {
+
+	if(xsdbin_map == NULL || hst->id >= xsdbin_header()->num_hosts)
+		return OK;
+
+	xsdbin_write_host(hst, time(NULL));
+
+	return OK;
+	}
+
+
+/* updates a service's binary record in place */
+int xsddefault_update_service_status(service *svc) {
+
+	if(xsdbin_map == NULL || svc->id >= xsdbin_header()->num_services)
+		return OK;
+
+	xsdbin_write_service(svc, time(NULL));
+
+	return OK;
+	}
+
+
+
 /******************************************************************/
 /****************** STATUS DATA OUTPUT FUNCTIONS ******************/
 /******************************************************************/
@@ -115,8 +916,6 @@ int xsddefault_cleanup_status_data(int delete_status_data) {
 int xsddefault_save_status_data(void) {
 	char *tmp_log = NULL;
 	customvariablesmember *temp_customvariablesmember = NULL;
-	host *temp_host = NULL;
-	service *temp_service = NULL;
 	contact *temp_contact = NULL;
 	nagios_comment *temp_comment = NULL;
 	scheduled_downtime *temp_downtime = NULL;
@@ -127,6 +926,11 @@ int xsddefault_save_status_data(void) {
 
 	log_debug_info(DEBUGL_FUNCTIONS, 0, "save_status_data()\n");
 
+	if(status_binary_file) {
+		generate_check_stats();
+		xsdbin_save_status_data();
+		}
+
 	/* users may not want us to write status data */
 	if(!status_file || !strcmp(status_file, "/dev/null"))
 		return OK;
@@ -227,141 +1031,8 @@ int xsddefault_save_status_data(void) {
 	fprintf(fp, "\t}\n\n");
 
 
-	/* save host status data */
-	for(temp_host = host_list; temp_host != NULL; temp_host = temp_host->next) {
-
-		fprintf(fp, "hoststatus {\n");
-		fprintf(fp, "\thost_name=%s\n", temp_host->name);
-
-		fprintf(fp, "\tmodified_attributes=%lu\n", temp_host->modified_attributes);
-		fprintf(fp, "\tcheck_command=%s\n", (temp_host->check_command == NULL) ? "" : temp_host->check_command);
-		fprintf(fp, "\tcheck_period=%s\n", (temp_host->check_period == NULL) ? "" : temp_host->check_period);
-		fprintf(fp, "\tnotification_period=%s\n", (temp_host->notification_period == NULL) ? "" : temp_host->notification_period);
-		fprintf(fp, "\timportance=%u\n", temp_host->hourly_value);
-		fprintf(fp, "\tcheck_interval=%f\n", temp_host->check_interval);
-		fprintf(fp, "\tretry_interval=%f\n", temp_host->retry_interval);
-		fprintf(fp, "\tevent_handler=%s\n", (temp_host->event_handler == NULL) ? "" : temp_host->event_handler);
-		fprintf(fp, "\tevent_handler_period=%s\n", (temp_host->event_handler_period == NULL) ? "" : temp_host->event_handler_period);
-
-		fprintf(fp, "\thas_been_checked=%d\n", temp_host->has_been_checked);
-		fprintf(fp, "\tshould_be_scheduled=%d\n", temp_host->should_be_scheduled);
-		fprintf(fp, "\tcheck_execution_time=%.3f\n", temp_host->execution_time);
-		fprintf(fp, "\tcheck_latency=%.3f\n", temp_host->latency);
-		fprintf(fp, "\tcheck_type=%d\n", temp_host->check_type);
-		fprintf(fp, "\tcurrent_state=%d\n", temp_host->current_state);
-		fprintf(fp, "\tlast_hard_state=%d\n", temp_host->last_hard_state);
-		fprintf(fp, "\tlast_event_id=%lu\n", temp_host->last_event_id);
-		fprintf(fp, "\tcurrent_event_id=%lu\n", temp_host->current_event_id);
-		fprintf(fp, "\tcurrent_problem_id=%lu\n", temp_host->current_problem_id);
-		fprintf(fp, "\tlast_problem_id=%lu\n", temp_host->last_problem_id);
-		fprintf(fp, "\tplugin_output=%s\n", (temp_host->plugin_output == NULL) ? "" : temp_host->plugin_output);
-		fprintf(fp, "\tlong_plugin_output=%s\n", (temp_host->long_plugin_output == NULL) ? "" : temp_host->long_plugin_output);
-		fprintf(fp, "\tperformance_data=%s\n", (temp_host->perf_data == NULL) ? "" : temp_host->perf_data);
-		fprintf(fp, "\tlast_check=%llu\n", (unsigned long long)temp_host->last_check);
-		fprintf(fp, "\tnext_check=%llu\n", (unsigned long long)temp_host->next_check);
-		fprintf(fp, "\tcheck_options=%d\n", temp_host->check_options);
-		fprintf(fp, "\tcurrent_attempt=%d\n", temp_host->current_attempt);
-		fprintf(fp, "\tmax_attempts=%d\n", temp_host->max_attempts);
-		fprintf(fp, "\tstate_type=%d\n", temp_host->state_type);
-		fprintf(fp, "\tlast_state_change=%llu\n", (unsigned long long)temp_host->last_state_change);
-		fprintf(fp, "\tlast_hard_state_change=%llu\n", (unsigned long long)temp_host->last_hard_state_change);
-		fprintf(fp, "\tlast_time_up=%llu\n", (unsigned long long)temp_host->last_time_up);
-		fprintf(fp, "\tlast_time_down=%llu\n", (unsigned long long)temp_host->last_time_down);
-		fprintf(fp, "\tlast_time_unreachable=%llu\n", (unsigned long long)temp_host->last_time_unreachable);
-		fprintf(fp, "\tlast_notification=%llu\n", (unsigned long long)temp_host->last_notification);
-		fprintf(fp, "\tnext_notification=%llu\n", (unsigned long long)temp_host->next_notification);
-		fprintf(fp, "\tno_more_notifications=%d\n", temp_host->no_more_notifications);
-		fprintf(fp, "\tcurrent_notification_number=%d\n", temp_host->current_notification_number);
-		fprintf(fp, "\tcurrent_notification_id=%lu\n", temp_host->current_notification_id);
-		fprintf(fp, "\tnotifications_enabled=%d\n", temp_host->notifications_enabled);
-		fprintf(fp, "\tproblem_has_been_acknowledged=%d\n", temp_host->problem_has_been_acknowledged);
-		fprintf(fp, "\tacknowledgement_type=%d\n", temp_host->acknowledgement_type);
-		fprintf(fp, "\tactive_checks_enabled=%d\n", temp_host->checks_enabled);
-		fprintf(fp, "\tpassive_checks_enabled=%d\n", temp_host->accept_passive_checks);
-		fprintf(fp, "\tevent_handler_enabled=%d\n", temp_host->event_handler_enabled);
-		fprintf(fp, "\tflap_detection_enabled=%d\n", temp_host->flap_detection_enabled);
-		fprintf(fp, "\tprocess_performance_data=%d\n", temp_host->process_performance_data);
-		fprintf(fp, "\tobsess=%d\n", temp_host->obsess);
-		fprintf(fp, "\tlast_update=%llu\n", (unsigned long long)current_time);
-		fprintf(fp, "\tis_flapping=%d\n", temp_host->is_flapping);
-		fprintf(fp, "\tpercent_state_change=%.2f\n", temp_host->percent_state_change);
-		fprintf(fp, "\tscheduled_downtime_depth=%d\n", temp_host->scheduled_downtime_depth);
-		/* custom variables */
-		for(temp_customvariablesmember = temp_host->custom_variables; temp_customvariablesmember != NULL; temp_customvariablesmember = temp_customvariablesmember->next) {
-			if(temp_customvariablesmember->variable_name)
-				fprintf(fp, "\t_%s=%d;%s\n", temp_customvariablesmember->variable_name, temp_customvariablesmember->has_been_modified, (temp_customvariablesmember->variable_value == NULL) ? "" : temp_customvariablesmember->variable_value);
-			}
-		fprintf(fp, "\t}\n\n");
-		}
-
-	/* save service status data */
-	for(temp_service = service_list; temp_service != NULL; temp_service = temp_service->next) {
-
-		fprintf(fp, "servicestatus {\n");
-		fprintf(fp, "\thost_name=%s\n", temp_service->host_name);
-
-		fprintf(fp, "\tservice_description=%s\n", temp_service->description);
-		fprintf(fp, "\tmodified_attributes=%lu\n", temp_service->modified_attributes);
-		fprintf(fp, "\tcheck_command=%s\n", (temp_service->check_command == NULL) ? "" : temp_service->check_command);
-		fprintf(fp, "\tcheck_period=%s\n", (temp_service->check_period == NULL) ? "" : temp_service->check_period);
-		fprintf(fp, "\tnotification_period=%s\n", (temp_service->notification_period == NULL) ? "" : temp_service->notification_period);
-		fprintf(fp, "\timportance=%u\n", temp_service->hourly_value);
-		fprintf(fp, "\tcheck_interval=%f\n", temp_service->check_interval);
-		fprintf(fp, "\tretry_interval=%f\n", temp_service->retry_interval);
-		fprintf(fp, "\tevent_handler=%s\n", (temp_service->event_handler == NULL) ? "" : temp_service->event_handler);
-		fprintf(fp, "\tevent_handler_period=%s\n", (temp_service->event_handler_period == NULL) ? "" : temp_service->event_handler_period);
-
-		fprintf(fp, "\thas_been_checked=%d\n", temp_service->has_been_checked);
-		fprintf(fp, "\tshould_be_scheduled=%d\n", temp_service->should_be_scheduled);
-		fprintf(fp, "\tcheck_execution_time=%.3f\n", temp_service->execution_time);
-		fprintf(fp, "\tcheck_latency=%.3f\n", temp_service->latency);
-		fprintf(fp, "\tcheck_type=%d\n", temp_service->check_type);
-		fprintf(fp, "\tcurrent_state=%d\n", temp_service->current_state);
-		fprintf(fp, "\tlast_hard_state=%d\n", temp_service->last_hard_state);
-		fprintf(fp, "\tlast_event_id=%lu\n", temp_service->last_event_id);
-		fprintf(fp, "\tcurrent_event_id=%lu\n", temp_service->current_event_id);
-		fprintf(fp, "\tcurrent_problem_id=%lu\n", temp_service->current_problem_id);
-		fprintf(fp, "\tlast_problem_id=%lu\n", temp_service->last_problem_id);
-		fprintf(fp, "\tcurrent_attempt=%d\n", temp_service->current_attempt);
-		fprintf(fp, "\tmax_attempts=%d\n", temp_service->max_attempts);
-		fprintf(fp, "\tstate_type=%d\n", temp_service->state_type);
-		fprintf(fp, "\tlast_state_change=%llu\n", (unsigned long long)temp_service->last_state_change);
-		fprintf(fp, "\tlast_hard_state_change=%llu\n", (unsigned long long)temp_service->last_hard_state_change);
-		fprintf(fp, "\tlast_time_ok=%llu\n", (unsigned long long)temp_service->last_time_ok);
-		fprintf(fp, "\tlast_time_warning=%llu\n", (unsigned long long)temp_service->last_time_warning);
-		fprintf(fp, "\tlast_time_unknown=%llu\n", (unsigned long long)temp_service->last_time_unknown);
-		fprintf(fp, "\tlast_time_critical=%llu\n", (unsigned long long)temp_service->last_time_critical);
-		fprintf(fp, "\tplugin_output=%s\n", (temp_service->plugin_output == NULL) ? "" : temp_service->plugin_output);
-		fprintf(fp, "\tlong_plugin_output=%s\n", (temp_service->long_plugin_output == NULL) ? "" : temp_service->long_plugin_output);
-		fprintf(fp, "\tperformance_data=%s\n", (temp_service->perf_data == NULL) ? "" : temp_service->perf_data);
-		fprintf(fp, "\tlast_check=%llu\n", (unsigned long long)temp_service->last_check);
-		fprintf(fp, "\tnext_check=%llu\n", (unsigned long long)temp_service->next_check);
-		fprintf(fp, "\tcheck_options=%d\n", temp_service->check_options);
-		fprintf(fp, "\tcurrent_notification_number=%d\n", temp_service->current_notification_number);
-		fprintf(fp, "\tcurrent_notification_id=%lu\n", temp_service->current_notification_id);
-		fprintf(fp, "\tlast_notification=%llu\n", (unsigned long long)temp_service->last_notification);
-		fprintf(fp, "\tnext_notification=%llu\n", (unsigned long long)temp_service->next_notification);
-		fprintf(fp, "\tno_more_notifications=%d\n", temp_service->no_more_notifications);
-		fprintf(fp, "\tnotifications_enabled=%d\n", temp_service->notifications_enabled);
-		fprintf(fp, "\tactive_checks_enabled=%d\n", temp_service->checks_enabled);
-		fprintf(fp, "\tpassive_checks_enabled=%d\n", temp_service->accept_passive_checks);
-		fprintf(fp, "\tevent_handler_enabled=%d\n", temp_service->event_handler_enabled);
-		fprintf(fp, "\tproblem_has_been_acknowledged=%d\n", temp_service->problem_has_been_acknowledged);
-		fprintf(fp, "\tacknowledgement_type=%d\n", temp_service->acknowledgement_type);
-		fprintf(fp, "\tflap_detection_enabled=%d\n", temp_service->flap_detection_enabled);
-		fprintf(fp, "\tprocess_performance_data=%d\n", temp_service->process_performance_data);
-		fprintf(fp, "\tobsess=%d\n", temp_service->obsess);
-		fprintf(fp, "\tlast_update=%llu\n", (unsigned long long)current_time);
-		fprintf(fp, "\tis_flapping=%d\n", temp_service->is_flapping);
-		fprintf(fp, "\tpercent_state_change=%.2f\n", temp_service->percent_state_change);
-		fprintf(fp, "\tscheduled_downtime_depth=%d\n", temp_service->scheduled_downtime_depth);
-		/* custom variables */
-		for(temp_customvariablesmember = temp_service->custom_variables; temp_customvariablesmember != NULL; temp_customvariablesmember = temp_customvariablesmember->next) {
-			if(temp_customvariablesmember->variable_name)
-				fprintf(fp, "\t_%s=%d;%s\n", temp_customvariablesmember->variable_name, temp_customvariablesmember->has_been_modified, (temp_customvariablesmember->variable_value == NULL) ? "" : temp_customvariablesmember->variable_value);
-			}
-		fprintf(fp, "\t}\n\n");
-		}
+	/* save host and service status data, re-rendering only what changed */
+	xsdtext_write_hosts_and_services(fp, current_time);
 
 	/* save contact status data */
 	for(temp_contact = contact_list; temp_contact != NULL; temp_contact = temp_contact->next) {
@@ -483,6 +1154,408 @@ int xsddefault_save_status_data(void) {
 
 #ifdef NSCGI
 
+/******************************************************************/
+/*************** BINARY STATUS DATA INPUT FUNCTIONS ***************/
+/******************************************************************/
+
+/*
+ * copies a record that Nagios may be writing to, retrying on torn reads.
+ * Returns ERROR if every copy was torn, so the caller can skip it.
+ */
+static int xsdbin_read_record(void *dst, const void *src, size_t size) {
+	const volatile uint32_t *seqp = (const volatile uint32_t *)src;
+	uint32_t seq;
+	int tries = 0;
+
+	do {
+		seq = *seqp;
+		__sync_synchronize();
+		memcpy(dst, src, size);
+		__sync_synchronize();
+		} while(((seq & 1) || seq != *seqp) && ++tries < 1000);
+
+	return tries < 1000 ? OK : ERROR;
+	}
+
+
+/*
+ * The CGIs keep the binary status file mapped and only decode the host
+ * and service records a page actually looks at. Records are found by
+ * object id, strings point straight into the mapping, and the mapping
+ * is private so anything we change in it (unescaping newlines, for
+ * one) stays with us.
+ */
+static struct {
+	char *map;
+	size_t size;
+	struct xsdbin_header hdr;
+	char *heap;
+	hoststatus *hosts;		/* by object id, decoded once host_name is set */
+	servicestatus *services;	/* by object id, decoded once host_name is set */
+	} xsdbin_view;
+
+
+/* returns a heap string in the mapping, or NULL if it's unset or bogus */
+static char *xsdbin_string(struct xsdbin_string *s) {
+
+	if(s->length == 0 || (uint64_t)s->offset + s->length >= xsdbin_view.hdr.heap_size
+	   || xsdbin_view.heap[s->offset + s->length] != '\x0')
+		return NULL;
+
+	return xsdbin_view.heap + s->offset;
+	}
+
+
+/* frees a string unless it lives in the mapping */
+static void xsdbin_free_string(char *str) {
+
+	if(str < xsdbin_view.map || str >= xsdbin_view.map + xsdbin_view.size)
+		free(str);
+	}
+
+
+/* decodes a host record, unless that's already been done */
+static hoststatus *xsdbin_hoststatus(uint32_t id) {
+	hoststatus *temp_hoststatus;
+	struct xsdbin_host hrec;
+
+	if(id >= xsdbin_view.hdr.num_hosts)
+		return NULL;
+	temp_hoststatus = &xsdbin_view.hosts[id];
+	if(temp_hoststatus->host_name != NULL)
+		return temp_hoststatus;
+
+	if(xsdbin_read_record(&hrec, xsdbin_view.map + xsdbin_view.hdr.hosts_offset + id * sizeof(hrec), sizeof(hrec)) == ERROR)
+		return NULL;
+	if((temp_hoststatus->host_name = xsdbin_string(&hrec.host_name)) == NULL)
+		return NULL;
+	temp_hoststatus->has_been_checked = hrec.has_been_checked > 0 ? TRUE : FALSE;
+	/* unchecked objects get a made-up plugin_output below */
+	if(temp_hoststatus->has_been_checked == TRUE && (temp_hoststatus->plugin_output = xsdbin_string(&hrec.plugin_output)))
+		unescape_newlines(temp_hoststatus->plugin_output);
+	if((temp_hoststatus->long_plugin_output = xsdbin_string(&hrec.long_plugin_output)))
+		unescape_newlines(temp_hoststatus->long_plugin_output);
+	temp_hoststatus->perf_data = xsdbin_string(&hrec.perf_data);
+	temp_hoststatus->last_update = xsdbin_view.hdr.last_update;
+	temp_hoststatus->last_check = hrec.last_check;
+	temp_hoststatus->next_check = hrec.next_check;
+	temp_hoststatus->last_state_change = hrec.last_state_change;
+	temp_hoststatus->last_hard_state_change = hrec.last_hard_state_change;
+	temp_hoststatus->last_time_up = hrec.last_time_up;
+	temp_hoststatus->last_time_down = hrec.last_time_down;
+	temp_hoststatus->last_time_unreachable = hrec.last_time_unreachable;
+	temp_hoststatus->last_notification = hrec.last_notification;
+	temp_hoststatus->next_notification = hrec.next_notification;
+	temp_hoststatus->percent_state_change = hrec.percent_state_change;
+	temp_hoststatus->latency = hrec.latency;
+	temp_hoststatus->execution_time = hrec.execution_time;
+	temp_hoststatus->status = hrec.status;
+	temp_hoststatus->should_be_scheduled = hrec.should_be_scheduled > 0 ? TRUE : FALSE;
+	temp_hoststatus->current_attempt = hrec.current_attempt;
+	temp_hoststatus->max_attempts = hrec.max_attempts;
+	temp_hoststatus->check_options = hrec.check_options;
+	temp_hoststatus->check_type = hrec.check_type;
+	temp_hoststatus->last_hard_state = hrec.last_hard_state;
+	temp_hoststatus->state_type = hrec.state_type;
+	temp_hoststatus->no_more_notifications = hrec.no_more_notifications > 0 ? TRUE : FALSE;
+	temp_hoststatus->notifications_enabled = hrec.notifications_enabled > 0 ? TRUE : FALSE;
+	temp_hoststatus->problem_has_been_acknowledged = hrec.problem_has_been_acknowledged > 0 ? TRUE : FALSE;
+	temp_hoststatus->acknowledgement_type = hrec.acknowledgement_type;
+	temp_hoststatus->current_notification_number = hrec.current_notification_number;
+	temp_hoststatus->accept_passive_checks = hrec.accept_passive_checks > 0 ? TRUE : FALSE;
+	temp_hoststatus->event_handler_enabled = hrec.event_handler_enabled > 0 ? TRUE : FALSE;
+	temp_hoststatus->checks_enabled = hrec.checks_enabled > 0 ? TRUE : FALSE;
+	temp_hoststatus->flap_detection_enabled = hrec.flap_detection_enabled > 0 ? TRUE : FALSE;
+	temp_hoststatus->is_flapping = hrec.is_flapping > 0 ? TRUE : FALSE;
+	temp_hoststatus->scheduled_downtime_depth = hrec.scheduled_downtime_depth < 0 ? 0 : hrec.scheduled_downtime_depth;
+	temp_hoststatus->process_performance_data = hrec.process_performance_data > 0 ? TRUE : FALSE;
+	temp_hoststatus->obsess = hrec.obsess > 0 ? TRUE : FALSE;
+	adjust_host_status(temp_hoststatus);
+
+	return temp_hoststatus;
+	}
+
+
+/* decodes a service record, unless that's already been done */
+static servicestatus *xsdbin_servicestatus(uint32_t id) {
+	servicestatus *temp_servicestatus;
+	struct xsdbin_service srec;
+
+	if(id >= xsdbin_view.hdr.num_services)
+		return NULL;
+	temp_servicestatus = &xsdbin_view.services[id];
+	if(temp_servicestatus->host_name != NULL)
+		return temp_servicestatus;
+
+	if(xsdbin_read_record(&srec, xsdbin_view.map + xsdbin_view.hdr.services_offset + id * sizeof(srec), sizeof(srec)) == ERROR)
+		return NULL;
+	if((temp_servicestatus->description = xsdbin_string(&srec.description)) == NULL)
+		return NULL;
+	if((temp_servicestatus->host_name = xsdbin_string(&srec.host_name)) == NULL)
+		return NULL;
+	temp_servicestatus->has_been_checked = srec.has_been_checked > 0 ? TRUE : FALSE;
+	/* unchecked objects get a made-up plugin_output below */
+	if(temp_servicestatus->has_been_checked == TRUE && (temp_servicestatus->plugin_output = xsdbin_string(&srec.plugin_output)))
+		unescape_newlines(temp_servicestatus->plugin_output);
+	if((temp_servicestatus->long_plugin_output = xsdbin_string(&srec.long_plugin_output)))
+		unescape_newlines(temp_servicestatus->long_plugin_output);
+	temp_servicestatus->perf_data = xsdbin_string(&srec.perf_data);
+	temp_servicestatus->last_update = xsdbin_view.hdr.last_update;
+	temp_servicestatus->last_check = srec.last_check;
+	temp_servicestatus->next_check = srec.next_check;
+	temp_servicestatus->last_state_change = srec.last_state_change;
+	temp_servicestatus->last_hard_state_change = srec.last_hard_state_change;
+	temp_servicestatus->last_time_ok = srec.last_time_ok;
+	temp_servicestatus->last_time_warning = srec.last_time_warning;
+	temp_servicestatus->last_time_unknown = srec.last_time_unknown;
+	temp_servicestatus->last_time_critical = srec.last_time_critical;
+	temp_servicestatus->last_notification = srec.last_notification;
+	temp_servicestatus->next_notification = srec.next_notification;
+	temp_servicestatus->percent_state_change = srec.percent_state_change;
+	temp_servicestatus->latency = srec.latency;
+	temp_servicestatus->execution_time = srec.execution_time;
+	temp_servicestatus->status = srec.status;
+	temp_servicestatus->should_be_scheduled = srec.should_be_scheduled > 0 ? TRUE : FALSE;
+	temp_servicestatus->current_attempt = srec.current_attempt;
+	temp_servicestatus->max_attempts = srec.max_attempts;
+	temp_servicestatus->check_options = srec.check_options;
+	temp_servicestatus->check_type = srec.check_type;
+	temp_servicestatus->last_hard_state = srec.last_hard_state;
+	temp_servicestatus->state_type = srec.state_type;
+	temp_servicestatus->no_more_notifications = srec.no_more_notifications > 0 ? TRUE : FALSE;
+	temp_servicestatus->notifications_enabled = srec.notifications_enabled > 0 ? TRUE : FALSE;
+	temp_servicestatus->problem_has_been_acknowledged = srec.problem_has_been_acknowledged > 0 ? TRUE : FALSE;
+	temp_servicestatus->acknowledgement_type = srec.acknowledgement_type;
+	temp_servicestatus->current_notification_number = srec.current_notification_number;
+	temp_servicestatus->accept_passive_checks = srec.accept_passive_checks > 0 ? TRUE : FALSE;
+	temp_servicestatus->event_handler_enabled = srec.event_handler_enabled > 0 ? TRUE : FALSE;
+	temp_servicestatus->checks_enabled = srec.checks_enabled > 0 ? TRUE : FALSE;
+	temp_servicestatus->flap_detection_enabled = srec.flap_detection_enabled > 0 ? TRUE : FALSE;
+	temp_servicestatus->is_flapping = srec.is_flapping > 0 ? TRUE : FALSE;
+	temp_servicestatus->scheduled_downtime_depth = srec.scheduled_downtime_depth < 0 ? 0 : srec.scheduled_downtime_depth;
+	temp_servicestatus->process_performance_data = srec.process_performance_data > 0 ? TRUE : FALSE;
+	temp_servicestatus->obsess = srec.obsess > 0 ? TRUE : FALSE;
+	adjust_service_status(temp_servicestatus);
+
+	return temp_servicestatus;
+	}
+
+
+/*
+ * finds a host's record through its object id. Returns NULL if the
+ * object config doesn't match the status file, in which case the
+ * caller has to look the host up by name.
+ */
+hoststatus *xsddefault_binary_hoststatus(const char *host_name) {
+	hoststatus *temp_hoststatus;
+	host *temp_host;
+
+	if(xsdbin_view.map == NULL || (temp_host = find_host(host_name)) == NULL)
+		return NULL;
+	if((temp_hoststatus = xsdbin_hoststatus(temp_host->id)) == NULL || strcmp(temp_hoststatus->host_name, host_name))
+		return NULL;
+
+	return temp_hoststatus;
+	}
+
+
+/* finds a service's record through its object id, like the above */
+servicestatus *xsddefault_binary_servicestatus(const char *host_name, const char *svc_description) {
+	servicestatus *temp_servicestatus;
+	service *temp_service;
+
+	if(xsdbin_view.map == NULL || (temp_service = find_service(host_name, svc_description)) == NULL)
+		return NULL;
+	if((temp_servicestatus = xsdbin_servicestatus(temp_service->id)) == NULL
+	   || strcmp(temp_servicestatus->host_name, host_name) || strcmp(temp_servicestatus->description, svc_description))
+		return NULL;
+
+	return temp_servicestatus;
+	}
+
+
+/* decodes every host record and links them up in object id order */
+hoststatus *xsddefault_binary_hoststatus_list(void) {
+	hoststatus *first = NULL, *last = NULL, *temp_hoststatus;
+	uint32_t x;
+
+	for(x = 0; xsdbin_view.map && x < xsdbin_view.hdr.num_hosts; x++) {
+		if((temp_hoststatus = xsdbin_hoststatus(x)) == NULL)
+			continue;
+		temp_hoststatus->next = NULL;
+		if(last)
+			last->next = temp_hoststatus;
+		else
+			first = temp_hoststatus;
+		last = temp_hoststatus;
+		}
+
+	return first;
+	}
+
+
+/* decodes every service record and links them up in object id order */
+servicestatus *xsddefault_binary_servicestatus_list(void) {
+	servicestatus *first = NULL, *last = NULL, *temp_servicestatus;
+	uint32_t x;
+
+	for(x = 0; xsdbin_view.map && x < xsdbin_view.hdr.num_services; x++) {
+		if((temp_servicestatus = xsdbin_servicestatus(x)) == NULL)
+			continue;
+		temp_servicestatus->next = NULL;
+		if(last)
+			last->next = temp_servicestatus;
+		else
+			first = temp_servicestatus;
+		last = temp_servicestatus;
+		}
+
+	return first;
+	}
+
+
+/* frees whatever was decoded and unmaps the file */
+void xsddefault_free_binary_status_data(void) {
+	uint32_t x;
+
+	if(xsdbin_view.map == NULL)
+		return;
+
+	/* add_*_status() may have replaced the output with its own */
+	for(x = 0; x < xsdbin_view.hdr.num_hosts; x++) {
+		if(xsdbin_view.hosts[x].plugin_output)
+			xsdbin_free_string(xsdbin_view.hosts[x].plugin_output);
+		}
+	for(x = 0; x < xsdbin_view.hdr.num_services; x++) {
+		if(xsdbin_view.services[x].plugin_output)
+			xsdbin_free_string(xsdbin_view.services[x].plugin_output);
+		}
+
+	munmap(xsdbin_view.map, xsdbin_view.size);
+	free(xsdbin_view.hosts);
+	free(xsdbin_view.services);
+	memset(&xsdbin_view, 0, sizeof(xsdbin_view));
+	}
+
+
+/* maps the binary status file and reads program status, comments and downtime */
+int xsddefault_read_binary_status_data(const char *status_file_name, int options) {
+	struct xsdbin_header hdr;
+	const struct xsdbin_header *map_hdr;
+	struct xsdbin_comment *crec;
+	struct xsdbin_downtime *drec;
+	scheduled_downtime *temp_downtime = NULL;
+	struct stat st;
+	char *map, *heap;
+	uint64_t x;
+	int fd;
+
+	xsddefault_free_binary_status_data();
+
+	if((fd = open(status_file_name, O_RDONLY)) < 0)
+		return ERROR;
+	if(fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(hdr)) {
+		close(fd);
+		return ERROR;
+		}
+	map = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if(map == MAP_FAILED)
+		return ERROR;
+
+	/* make sure this is a file we understand before we add anything */
+	map_hdr = (const struct xsdbin_header *)map;
+	if(xsdbin_read_record(&hdr.seq, &map_hdr->seq, sizeof(hdr) - offsetof(struct xsdbin_header, seq)) == ERROR) {
+		munmap(map, st.st_size);
+		return ERROR;
+		}
+	memcpy(&hdr, map_hdr, offsetof(struct xsdbin_header, seq));
+	if(memcmp(hdr.magic, XSDBIN_MAGIC, sizeof(XSDBIN_MAGIC)) || hdr.version != XSDBIN_VERSION
+	   || hdr.header_size != sizeof(struct xsdbin_header)
+	   || hdr.host_size != sizeof(struct xsdbin_host)
+	   || hdr.service_size != sizeof(struct xsdbin_service)
+	   || hdr.comment_size != sizeof(struct xsdbin_comment)
+	   || hdr.downtime_size != sizeof(struct xsdbin_downtime)
+	   || hdr.file_size != (uint64_t)st.st_size
+	   || hdr.hosts_offset + (uint64_t)hdr.num_hosts * sizeof(struct xsdbin_host) > hdr.services_offset
+	   || hdr.services_offset + (uint64_t)hdr.num_services * sizeof(struct xsdbin_service) > hdr.heap_offset
+	   || hdr.heap_offset + hdr.heap_size > hdr.file_size
+	   || hdr.comments_offset + hdr.num_comments * sizeof(*crec) > hdr.heap_size
+	   || hdr.downtimes_offset + hdr.num_downtimes * sizeof(*drec) > hdr.heap_size) {
+		munmap(map, st.st_size);
+		return ERROR;
+		}
+	heap = map + hdr.heap_offset;
+
+	/* host and service records are decoded when they're looked up */
+	xsdbin_view.hosts = (hoststatus *)calloc(hdr.num_hosts + 1, sizeof(hoststatus));
+	xsdbin_view.services = (servicestatus *)calloc(hdr.num_services + 1, sizeof(servicestatus));
+	if(xsdbin_view.hosts == NULL || xsdbin_view.services == NULL) {
+		my_free(xsdbin_view.hosts);
+		my_free(xsdbin_view.services);
+		munmap(map, st.st_size);
+		return ERROR;
+		}
+	xsdbin_view.map = map;
+	xsdbin_view.size = st.st_size;
+	xsdbin_view.hdr = hdr;
+	xsdbin_view.heap = heap;
+
+	nagios_pid = hdr.nagios_pid;
+	daemon_mode = hdr.daemon_mode > 0 ? TRUE : FALSE;
+	program_start = hdr.program_start;
+	last_log_rotation = hdr.last_log_rotation;
+	enable_notifications = hdr.enable_notifications > 0 ? TRUE : FALSE;
+	execute_service_checks = hdr.execute_service_checks > 0 ? TRUE : FALSE;
+	accept_passive_service_checks = hdr.accept_passive_service_checks > 0 ? TRUE : FALSE;
+	execute_host_checks = hdr.execute_host_checks > 0 ? TRUE : FALSE;
+	accept_passive_host_checks = hdr.accept_passive_host_checks > 0 ? TRUE : FALSE;
+	enable_event_handlers = hdr.enable_event_handlers > 0 ? TRUE : FALSE;
+	obsess_over_services = hdr.obsess_over_services > 0 ? TRUE : FALSE;
+	obsess_over_hosts = hdr.obsess_over_hosts > 0 ? TRUE : FALSE;
+	check_service_freshness = hdr.check_service_freshness > 0 ? TRUE : FALSE;
+	check_host_freshness = hdr.check_host_freshness > 0 ? TRUE : FALSE;
+	enable_flap_detection = hdr.enable_flap_detection > 0 ? TRUE : FALSE;
+	process_performance_data = hdr.process_performance_data > 0 ? TRUE : FALSE;
+	for(x = 0; x < MAX_CHECK_STATS_TYPES; x++) {
+		program_stats[x][0] = hdr.check_stats[x][0];
+		program_stats[x][1] = hdr.check_stats[x][1];
+		program_stats[x][2] = hdr.check_stats[x][2];
+		}
+
+	/* Big speedup when reading status data in bulk */
+	defer_downtime_sorting = 1;
+	defer_comment_sorting = 1;
+
+	/* comment and downtime arrays are never changed once written */
+	crec = (struct xsdbin_comment *)(heap + hdr.comments_offset);
+	for(x = 0; x < hdr.num_comments; x++, crec++) {
+		add_comment(crec->comment_type, crec->entry_type, xsdbin_string(&crec->host_name), xsdbin_string(&crec->service_description), crec->entry_time, xsdbin_string(&crec->author), xsdbin_string(&crec->comment_data), crec->comment_id, crec->persistent, crec->expires, crec->expire_time, crec->source);
+		}
+
+	drec = (struct xsdbin_downtime *)(heap + hdr.downtimes_offset);
+	for(x = 0; x < hdr.num_downtimes; x++, drec++) {
+		if(drec->type == HOST_DOWNTIME) {
+			add_host_downtime(xsdbin_string(&drec->host_name), drec->entry_time, xsdbin_string(&drec->author), xsdbin_string(&drec->comment), drec->start_time, drec->flex_downtime_start, drec->end_time, drec->fixed, drec->triggered_by, drec->duration, drec->downtime_id, drec->is_in_effect, drec->start_notification_sent);
+			temp_downtime = find_downtime(HOST_DOWNTIME, drec->downtime_id);
+			}
+		else {
+			add_service_downtime(xsdbin_string(&drec->host_name), xsdbin_string(&drec->service_description), drec->entry_time, xsdbin_string(&drec->author), xsdbin_string(&drec->comment), drec->start_time, drec->flex_downtime_start, drec->end_time, drec->fixed, drec->triggered_by, drec->duration, drec->downtime_id, drec->is_in_effect, drec->start_notification_sent);
+			temp_downtime = find_downtime(SERVICE_DOWNTIME, drec->downtime_id);
+			}
+		if(temp_downtime)
+			temp_downtime->comment_id = drec->comment_id;
+		}
+
+	if(sort_downtime() != OK)
+		return ERROR;
+	if(sort_comments() != OK)
+		return ERROR;
+
+	return OK;
+	}
+
+
 /******************************************************************/
 /****************** DEFAULT DATA INPUT FUNCTIONS ******************/
 /******************************************************************/
@@ -23,10 +23,208 @@
 #ifndef NAGIOS_XSDDEFAULT_H_INCLUDED
 #define NAGIOS_XSDDEFAULT_H_INCLUDED
 
+#include <stdint.h>
+
+/*
+ * Binary status file layout (status_binary_file).
+ *
+ * The file is a header followed by one fixed-size record per host
+ * and per service, indexed by object id, and a string heap. Strings
+ * are appended to the heap when they change and never overwritten,
+ * so a record only ever points to complete strings. Comments and
+ * downtime are stored as arrays in the heap as well.
+ *
+ * Nagios updates records in place through a shared mapping. Each
+ * record (and the header) starts with a sequence number that is odd
+ * while the record is being written, so readers copy a record and
+ * retry if the sequence number was odd or changed meanwhile. When
+ * the heap fills up, the file is rewritten and renamed into place.
+ */
+#define XSDBIN_MAGIC    "NAGSTAT"
+#define XSDBIN_VERSION  1
+
+struct xsdbin_string {
+	uint32_t offset;	/* offset into the string heap */
+	uint32_t length;	/* 0 for empty or unset strings */
+	};
+
+struct xsdbin_host {
+	uint32_t seq;
+	uint32_t pad;
+	struct xsdbin_string host_name;
+	struct xsdbin_string plugin_output;
+	struct xsdbin_string long_plugin_output;
+	struct xsdbin_string perf_data;
+	int64_t last_update;
+	int64_t last_check;
+	int64_t next_check;
+	int64_t last_state_change;
+	int64_t last_hard_state_change;
+	int64_t last_time_up;
+	int64_t last_time_down;
+	int64_t last_time_unreachable;
+	int64_t last_notification;
+	int64_t next_notification;
+	double percent_state_change;
+	double latency;
+	double execution_time;
+	int32_t status;
+	int32_t has_been_checked;
+	int32_t should_be_scheduled;
+	int32_t current_attempt;
+	int32_t max_attempts;
+	int32_t check_options;
+	int32_t check_type;
+	int32_t last_hard_state;
+	int32_t state_type;
+	int32_t no_more_notifications;
+	int32_t notifications_enabled;
+	int32_t problem_has_been_acknowledged;
+	int32_t acknowledgement_type;
+	int32_t current_notification_number;
+	int32_t accept_passive_checks;
+	int32_t event_handler_enabled;
+	int32_t checks_enabled;
+	int32_t flap_detection_enabled;
+	int32_t is_flapping;
+	int32_t scheduled_downtime_depth;
+	int32_t process_performance_data;
+	int32_t obsess;
+	};
+
+struct xsdbin_service {
+	uint32_t seq;
+	uint32_t pad;
+	struct xsdbin_string host_name;
+	struct xsdbin_string description;
+	struct xsdbin_string plugin_output;
+	struct xsdbin_string long_plugin_output;
+	struct xsdbin_string perf_data;
+	int64_t last_update;
+	int64_t last_check;
+	int64_t next_check;
+	int64_t last_state_change;
+	int64_t last_hard_state_change;
+	int64_t last_time_ok;
+	int64_t last_time_warning;
+	int64_t last_time_unknown;
+	int64_t last_time_critical;
+	int64_t last_notification;
+	int64_t next_notification;
+	double percent_state_change;
+	double latency;
+	double execution_time;
+	int32_t status;
+	int32_t has_been_checked;
+	int32_t should_be_scheduled;
+	int32_t current_attempt;
+	int32_t max_attempts;
+	int32_t check_options;
+	int32_t check_type;
+	int32_t last_hard_state;
+	int32_t state_type;
+	int32_t no_more_notifications;
+	int32_t notifications_enabled;
+	int32_t problem_has_been_acknowledged;
+	int32_t acknowledgement_type;
+	int32_t current_notification_number;
+	int32_t accept_passive_checks;
+	int32_t event_handler_enabled;
+	int32_t checks_enabled;
+	int32_t flap_detection_enabled;
+	int32_t is_flapping;
+	int32_t scheduled_downtime_depth;
+	int32_t process_performance_data;
+	int32_t obsess;
+	};
+
+struct xsdbin_comment {
+	struct xsdbin_string host_name;
+	struct xsdbin_string service_description;
+	struct xsdbin_string author;
+	struct xsdbin_string comment_data;
+	uint64_t comment_id;
+	int64_t entry_time;
+	int64_t expire_time;
+	int32_t comment_type;
+	int32_t entry_type;
+	int32_t source;
+	int32_t persistent;
+	int32_t expires;
+	int32_t pad;
+	};
+
+struct xsdbin_downtime {
+	struct xsdbin_string host_name;
+	struct xsdbin_string service_description;
+	struct xsdbin_string author;
+	struct xsdbin_string comment;
+	uint64_t downtime_id;
+	uint64_t comment_id;
+	uint64_t triggered_by;
+	uint64_t duration;
+	int64_t entry_time;
+	int64_t start_time;
+	int64_t flex_downtime_start;
+	int64_t end_time;
+	int32_t type;
+	int32_t fixed;
+	int32_t is_in_effect;
+	int32_t start_notification_sent;
+	};
+
+struct xsdbin_header {
+	char magic[8];
+	uint32_t version;
+	uint32_t header_size;
+	uint32_t host_size;
+	uint32_t service_size;
+	uint32_t comment_size;
+	uint32_t downtime_size;
+	uint32_t num_hosts;
+	uint32_t num_services;
+	uint64_t hosts_offset;
+	uint64_t services_offset;
+	uint64_t heap_offset;
+	uint64_t heap_size;
+	uint64_t heap_used;
+	uint64_t file_size;
+
+	/* everything below is covered by seq */
+	uint32_t seq;
+	uint32_t pad;
+	uint64_t comments_offset;	/* offsets into the string heap */
+	uint64_t num_comments;
+	uint64_t downtimes_offset;
+	uint64_t num_downtimes;
+	int64_t created;
+	int64_t last_update;
+	int64_t program_start;
+	int64_t last_log_rotation;
+	int32_t nagios_pid;
+	int32_t daemon_mode;
+	int32_t enable_notifications;
+	int32_t execute_service_checks;
+	int32_t accept_passive_service_checks;
+	int32_t execute_host_checks;
+	int32_t accept_passive_host_checks;
+	int32_t enable_event_handlers;
+	int32_t obsess_over_services;
+	int32_t obsess_over_hosts;
+	int32_t check_service_freshness;
+	int32_t check_host_freshness;
+	int32_t enable_flap_detection;
+	int32_t process_performance_data;
+	int32_t check_stats[MAX_CHECK_STATS_TYPES][3];
+	};
+
 #ifdef NSCORE
 int xsddefault_initialize_status_data(const char *);
 int xsddefault_cleanup_status_data(int);
 int xsddefault_save_status_data(void);
+int xsddefault_update_host_status(host *);
+int xsddefault_update_service_status(service *);
+int xsddefault_dump_stats(int);
 #endif
 
 #ifdef NSCGI
@@ -43,6 +241,12 @@ int xsddefault_save_status_data(void);
 #define XSDDEFAULT_SERVICEDOWNTIME_DATA  9
 
 int xsddefault_read_status_data(const char *, int);
+int xsddefault_read_binary_status_data(const char *, int);
+hoststatus *xsddefault_binary_hoststatus(const char *);
+servicestatus *xsddefault_binary_servicestatus(const char *, const char *);
+hoststatus *xsddefault_binary_hoststatus_list(void);
+servicestatus *xsddefault_binary_servicestatus_list(void);
+void xsddefault_free_binary_status_data(void);
 #endif
 
 #endif